@@ -0,0 +1,199 @@
+#pragma once
+#include "triton/Conversion/NVGPUToLLVM/Passes.h"
+#include "triton/Conversion/TritonGPUToLLVM/Passes.h"
+#include "triton/Conversion/TritonToTritonGPU/Passes.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "triton/Dialect/TritonNvidiaGPU/Transforms/Passes.h"
+#include "triton/Target/LLVMIR/Passes.h"
+
+#include "mlir/Conversion/Passes.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Pass/PassOptions.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "mlir/Transforms/Passes.h"
+
+// The pipelines of the stages of `XPUBackend` in
+// third_party/intel/backend/compiler.py, for triton-opt to run them without
+// Python, e.g.
+//
+//   triton-opt kernel.ttir --triton-xpu-ttgir-pipeline="num-warps=8 has-dpas"
+//
+// The options default to those of `XPUOptions`, update both together. The
+// stages between them, e.g. the selection of the number of warps of
+// `auto_num_warps`, whose result the Python stage reads back, aren't part of
+// the pipelines: -tritonintelgpu-select-num-warps sets the attribute the
+// num-warps option is taken from.
+
+namespace mlir {
+namespace triton {
+namespace xpu {
+
+// passes.common.add_canonicalizer, add_cse and add_licm run on each function.
+inline void addFuncPass(OpPassManager &pm, std::unique_ptr<Pass> pass) {
+  pm.nestAny().addPass(std::move(pass));
+}
+
+struct TTIRPipelineOptions : public PassPipelineOptions<TTIRPipelineOptions> {
+  Option<unsigned> packScalarArgs{
+      *this, "pack-scalar-args",
+      llvm::cl::desc("the scalar arguments the kernels with at least as many "
+                     "get packed into a buffer, 0 to never pack them"),
+      llvm::cl::init(0)};
+  Option<bool> bufferPrints{
+      *this, "buffer-prints",
+      llvm::cl::desc("print into a buffer, as with print_buffer_size"),
+      llvm::cl::init(false)};
+};
+
+inline void buildTTIRPipeline(OpPassManager &pm,
+                              const TTIRPipelineOptions &options) {
+  pm.addPass(createInlinerPass());
+  pm.addPass(createCombineOpsPass());
+  pm.addPass(createFoldMasksPass());
+  addFuncPass(pm, createCanonicalizerPass());
+  pm.addPass(createReorderBroadcastPass());
+  addFuncPass(pm, createCSEPass());
+  addFuncPass(pm, createLoopInvariantCodeMotionPass());
+  pm.addPass(createSymbolDCEPass());
+  if (options.packScalarArgs > 0)
+    pm.addPass(gpu::intel::createPackScalarArgsPass(options.packScalarArgs));
+  if (options.bufferPrints)
+    pm.addPass(gpu::intel::createBufferPrintsPass());
+  pm.addPass(gpu::intel::createGridBarriersPass());
+}
+
+struct TTGIRPipelineOptions
+    : public PassPipelineOptions<TTGIRPipelineOptions> {
+  Option<int> numWarps{*this, "num-warps", llvm::cl::init(4)};
+  Option<int> threadsPerWarp{*this, "threads-per-warp", llvm::cl::init(32)};
+  Option<int> numCTAs{*this, "num-ctas", llvm::cl::init(1)};
+  Option<int> numStages{*this, "num-stages", llvm::cl::init(2)};
+  Option<int> capability{
+      *this, "capability",
+      llvm::cl::desc("the capability of the device, 0 for ATS, 1 for PVC"),
+      llvm::cl::init(0)};
+  Option<std::string> grfMode{*this, "grf-mode",
+                              llvm::cl::desc("the GRF mode, default or large"),
+                              llvm::cl::init("default")};
+  Option<bool> hasDPAS{*this, "has-dpas", llvm::cl::init(false)};
+  Option<bool> has2DBlockIO{*this, "has-2d-block-io", llvm::cl::init(false)};
+  Option<bool> optimizeEpilogue{*this, "optimize-epilogue",
+                                llvm::cl::init(true)};
+  Option<bool> enablePersistent{*this, "enable-persistent",
+                                llvm::cl::init(false)};
+  Option<unsigned> swizzleGroup{*this, "swizzle-group", llvm::cl::init(0)};
+  Option<bool> partitionGrid{
+      *this, "partition-grid",
+      llvm::cl::desc("partition the grid, as with tile_launch=explicit"),
+      llvm::cl::init(false)};
+  Option<std::string> profileRegions{*this, "profile-regions",
+                                     llvm::cl::init("")};
+};
+
+inline void buildTTGIRPipeline(OpPassManager &pm,
+                               const TTGIRPipelineOptions &options) {
+  using namespace mlir::triton::gpu;
+  // XE_CORE_EUS, THREADS_PER_EU, XE_CORE_GRF_BYTES and XE_CORE_SHARED_MEM.
+  bool isATS = options.capability == 0;
+  unsigned threadsPerXeCore =
+      (isATS ? 16 : 8) * (options.grfMode == "large" ? 4 : 8);
+  unsigned grfBytes = isATS ? 32 : 64;
+  unsigned sharedPerXeCore = isATS ? 65536 : 131072;
+  auto dpasArch = options.hasDPAS ? intel::DeviceArch::PVC
+                                  : intel::DeviceArch::UNKNOWN;
+  auto blockIOArch = options.hasDPAS && options.has2DBlockIO
+                         ? intel::DeviceArch::PVC
+                         : intel::DeviceArch::UNKNOWN;
+
+  pm.addPass(createConvertTritonToTritonGPUPass(
+      options.numWarps, options.threadsPerWarp, options.numCTAs,
+      options.capability));
+  pm.addPass(createCoalescePass(options.capability == 1 ? 256 : 128));
+  pm.addPass(intel::createDistributeReductionsPass());
+  pm.addPass(createRemoveLayoutConversionsPass());
+  pm.addPass(createOptimizeThreadLocalityPass());
+  pm.addPass(intel::createAccelerateMatmulPass(dpasArch));
+  pm.addPass(createRemoveLayoutConversionsPass());
+  pm.addPass(intel::createMaterializeBlockPointerPass(blockIOArch));
+  pm.addPass(createTritonGPURewriteTensorPointerPass(options.capability));
+  pm.addPass(createRemoveLayoutConversionsPass());
+  pm.addPass(intel::createNarrowPointerOffsetsPass());
+  pm.addPass(intel::createStrengthReducePointersPass());
+  addFuncPass(pm, createLoopInvariantCodeMotionPass());
+  if (options.optimizeEpilogue)
+    pm.addPass(createOptimizeEpiloguePass());
+  pm.addPass(createOptimizeDotOperandsPass());
+  addFuncPass(pm, createCSEPass());
+  pm.addPass(intel::createEstimateTrafficPass());
+  pm.addPass(intel::createLoopUnrollPass());
+  pm.addPass(intel::createPrefetchBlockPass(options.numStages));
+  pm.addPass(intel::createPipelinePass(options.numStages));
+  pm.addPass(createPrefetchPass());
+  pm.addPass(createOptimizeDotOperandsPass());
+  pm.addPass(createRemoveLayoutConversionsPass());
+  pm.addPass(createReduceDataDuplicationPass());
+  pm.addPass(createReorderInstructionsPass());
+  if (options.enablePersistent)
+    pm.addPass(intel::createPersistentPass(options.swizzleGroup));
+  if (options.partitionGrid)
+    pm.addPass(intel::createPartitionGridPass());
+  if (!options.profileRegions.empty())
+    pm.addPass(intel::createInstrumentRegionsPass(options.profileRegions));
+  addFuncPass(pm, createCSEPass());
+  pm.addPass(createSymbolDCEPass());
+  addFuncPass(pm, createCanonicalizerPass());
+  pm.addPass(intel::createEstimateResourcesPass(grfBytes, threadsPerXeCore,
+                                                sharedPerXeCore));
+}
+
+struct LLVMIRPipelineOptions
+    : public PassPipelineOptions<LLVMIRPipelineOptions> {
+  Option<int> capability{*this, "capability", llvm::cl::init(0)};
+  Option<int> maxSharedMem{*this, "max-shared-mem", llvm::cl::init(0)};
+  Option<std::string> grfMode{*this, "grf-mode", llvm::cl::init("default")};
+  Option<bool> lineInfo{*this, "line-info", llvm::cl::init(true)};
+};
+
+// The MLIR passes of `make_llvm_module`, up to the translation to LLVM IR.
+inline void buildLLVMIRPipeline(OpPassManager &pm,
+                                const LLVMIRPipelineOptions &options) {
+  pm.addPass(gpu::createDecomposeUnsupportedConversionsPass());
+  pm.addPass(createConvertSCFToCFPass());
+  pm.addPass(createConvertIndexToLLVMPass());
+  AllocateSharedMemoryOptions sharedMemoryOptions;
+  sharedMemoryOptions.maxSharedMem = options.maxSharedMem;
+  pm.addPass(gpu::createAllocateSharedMemoryPass(sharedMemoryOptions));
+  pm.addPass(createConvertTritonGPUToLLVMPass(options.capability, GENX,
+                                              /*tmaMetadata=*/nullptr));
+  pm.addPass(createConvertNVGPUToLLVMPass());
+  pm.addPass(createArithToLLVMConversionPass());
+  addFuncPass(pm, createCanonicalizerPass());
+  addFuncPass(pm, createCSEPass());
+  ScheduleDPASOptions scheduleOptions;
+  scheduleOptions.numGRF = options.grfMode == "large" ? 256 : 128;
+  pm.addPass(gpu::createScheduleDPASPass(scheduleOptions));
+  pm.addPass(createSymbolDCEPass());
+  if (options.lineInfo)
+    pm.addPass(createLLVMDIScopePass());
+}
+
+} // namespace xpu
+} // namespace triton
+} // namespace mlir
+
+inline void registerXPUPipelines() {
+  using namespace mlir::triton::xpu;
+  mlir::PassPipelineRegistration<TTIRPipelineOptions>(
+      "triton-xpu-ttir-pipeline",
+      "The passes of XPUBackend.make_ttir, on Triton IR", buildTTIRPipeline);
+  mlir::PassPipelineRegistration<TTGIRPipelineOptions>(
+      "triton-xpu-ttgir-pipeline",
+      "The passes of XPUBackend.make_ttgir, from Triton IR to TritonGPU IR",
+      buildTTGIRPipeline);
+  mlir::PassPipelineRegistration<LLVMIRPipelineOptions>(
+      "triton-xpu-llvmir-pipeline",
+      "The MLIR passes of XPUBackend.make_llir, from TritonGPU IR to the LLVM "
+      "dialect",
+      buildLLVMIRPipeline);
+}
@@ -1,11 +1,199 @@
 #include "./RegisterTritonDialects.h"
 
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Pass/PassManager.h"
 #include "mlir/Tools/mlir-reduce/MlirReduceMain.h"
+#include "triton/Analysis/Allocation.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+// triton-reduce reduces the test cases an interestingness script accepts, as
+// mlir-reduce does, or those satisfying built-in predicates on their IR, e.g.
+// to shrink a kernel while it still converts a layout through the shared
+// memory or still spills:
+//
+//   triton-reduce kernel.ttgir --interesting=slm-conversions>=1
+//       --interesting=estimated-grf>128 -reduction-tree=traversal-mode=0
+//
+// A predicate compares a metric of the module with a number, with one of <,
+// <=, ==, >= and >. The metrics are
+//   * the number of operations of a name, e.g. triton_gpu.convert_layout,
+//   * slm-conversions: the layout conversions with a shared memory buffer,
+//   * shared: the shared memory the kernels allocate,
+//   * estimated-grf and estimated-shared: the GRF bytes per work-item and the
+//     shared memory of a work-group estimated by
+//     -tritonintelgpu-estimate-resources.
+//
+// The reduction passes test their candidates by running triton-reduce again
+// with --check=<predicate> for each predicate, which returns 1 when the
+// candidate satisfies all of them.
+
+using namespace mlir;
+
+namespace {
+
+struct Predicate {
+  std::string metric;
+  std::string cmp;
+  int64_t value;
+
+  bool holds(int64_t metricValue) const {
+    if (cmp == "<")
+      return metricValue < value;
+    if (cmp == "<=")
+      return metricValue <= value;
+    if (cmp == "==")
+      return metricValue == value;
+    if (cmp == ">=")
+      return metricValue >= value;
+    return metricValue > value;
+  }
+};
+
+std::optional<Predicate> parsePredicate(StringRef str) {
+  size_t pos = str.find_first_of("<=>");
+  if (pos == StringRef::npos || pos == 0)
+    return std::nullopt;
+  size_t end = pos + 1;
+  if (end < str.size() && str[end] == '=')
+    ++end;
+  Predicate predicate{str.take_front(pos).trim().str(),
+                      str.slice(pos, end).str(), 0};
+  if (predicate.cmp == "=" ||
+      str.drop_front(end).trim().getAsInteger(10, predicate.value))
+    return std::nullopt;
+  return predicate;
+}
+
+int64_t countSlmConversions(ModuleOp mod) {
+  ModuleAllocation allocation(mod);
+  int64_t count = 0;
+  mod.walk([&](triton::gpu::ConvertLayoutOp cvt) {
+    auto func = cvt->getParentOfType<FunctionOpInterface>();
+    Allocation *funcAllocation = allocation.getFuncData(func);
+    if (funcAllocation &&
+        funcAllocation->getBufferId(cvt.getOperation()) !=
+            Allocation::InvalidBufferId)
+      ++count;
+  });
+  return count;
+}
+
+std::optional<int64_t> getEstimate(ModuleOp mod, StringRef attr) {
+  OwningOpRef<ModuleOp> clone(mod.clone());
+  PassManager pm(mod.getContext());
+  pm.addPass(triton::gpu::intel::createEstimateResourcesPass());
+  if (failed(pm.run(*clone)))
+    return std::nullopt;
+  auto value = (*clone)->getAttrOfType<IntegerAttr>(attr);
+  if (!value)
+    return std::nullopt;
+  return value.getInt();
+}
+
+std::optional<int64_t> getMetric(ModuleOp mod, StringRef metric) {
+  if (metric == "slm-conversions")
+    return countSlmConversions(mod);
+  if (metric == "shared")
+    return ModuleAllocation(mod).getSharedMemorySize();
+  if (metric == "estimated-grf")
+    return getEstimate(mod, "triton_gpu.estimated_num_grf");
+  if (metric == "estimated-shared")
+    return getEstimate(mod, "triton_gpu.estimated_shared");
+  int64_t count = 0;
+  mod.walk([&](Operation *op) {
+    if (op->getName().getStringRef() == metric)
+      ++count;
+  });
+  return count;
+}
+
+// Whether the module of `filename` satisfies all the `predicates`.
+bool isInteresting(MLIRContext &context, StringRef filename,
+                   ArrayRef<Predicate> predicates) {
+  OwningOpRef<ModuleOp> mod = parseSourceFile<ModuleOp>(filename, &context);
+  if (!mod)
+    return false;
+  for (const Predicate &predicate : predicates) {
+    std::optional<int64_t> value = getMetric(*mod, predicate.metric);
+    if (!value || !predicate.holds(*value))
+      return false;
+  }
+  return true;
+}
+
+bool isReductionPassArg(StringRef arg) {
+  StringRef name = arg.ltrim('-').split('=').first;
+  return name == "reduction-tree" || name == "opt-reduction-pass";
+}
+
+} // namespace
 
 int main(int argc, char **argv) {
   mlir::DialectRegistry registry;
   registerTritonDialects(registry);
-
   mlir::MLIRContext context(registry);
-  return mlir::failed(mlir::mlirReduceMain(argc, argv, context));
+
+  SmallVector<StringRef> checks, interesting;
+  SmallVector<std::string> args;
+  for (int i = 0; i < argc; ++i) {
+    StringRef arg(argv[i]);
+    if (arg.consume_front("--check="))
+      checks.push_back(arg);
+    else if (arg.consume_front("--interesting="))
+      interesting.push_back(arg);
+    else
+      args.push_back(arg.str());
+  }
+
+  auto parseAll = [](ArrayRef<StringRef> strs) {
+    SmallVector<Predicate> predicates;
+    for (StringRef str : strs) {
+      std::optional<Predicate> predicate = parsePredicate(str);
+      if (!predicate) {
+        llvm::errs() << "invalid predicate '" << str
+                     << "', expected <metric><cmp><number>\n";
+        exit(2);
+      }
+      predicates.push_back(*predicate);
+    }
+    return predicates;
+  };
+
+  // Test of a candidate by the reduction passes: the last argument is the
+  // file of the candidate.
+  if (!checks.empty()) {
+    SmallVector<Predicate> predicates = parseAll(checks);
+    if (args.size() < 2)
+      return 0;
+    return isInteresting(context, args.back(), predicates) ? 1 : 0;
+  }
+
+  if (!interesting.empty()) {
+    parseAll(interesting);
+    std::string self = llvm::sys::fs::getMainExecutable(
+        argv[0], reinterpret_cast<void *>(&isReductionPassArg));
+    std::string test = " test=" + self;
+    for (StringRef predicate : interesting)
+      test += " test-arg=--check=" + predicate.str();
+    // The reduction passes run triton-reduce as their test, the reduction
+    // tree by default.
+    bool hasReductionPass = false;
+    for (std::string &arg : args)
+      if (isReductionPassArg(arg)) {
+        bool hasOptions = arg.find('=') != std::string::npos;
+        arg += hasOptions ? test : "=" + test.substr(1);
+        hasReductionPass = true;
+      }
+    if (!hasReductionPass)
+      args.push_back("-reduction-tree=traversal-mode=0" + test);
+  }
+
+  SmallVector<char *> newArgv;
+  for (std::string &arg : args)
+    newArgv.push_back(arg.data());
+  return mlir::failed(
+      mlir::mlirReduceMain(newArgv.size(), newArgv.data(), context));
 }
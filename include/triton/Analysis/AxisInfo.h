@@ -313,6 +313,8 @@ public:
 /// do not have recursive functions.
 /// Since each function will be called multiple times, we need to
 /// calculate the axis info based on the axis info of all the callers.
+/// The functions are then analyzed again together, so that the results of the
+/// calls get the axis info of the values returned by their callee.
 /// In the future, we can perform optimization using function cloning so that
 /// each call site will have unique axis info.
 using AxisInfoMapT = DenseMap<Value, AxisInfo>;
@@ -341,6 +343,7 @@ public:
         update(callOp, callee);
       });
     }
+    reanalyze(moduleOp, sortedFuncs.getArrayRef());
   }
 
   AxisInfo *getAxisInfo(Value value) {
@@ -366,6 +369,10 @@ public:
 private:
   void initialize(FunctionOpInterface funcOp);
 
+  void reanalyze(ModuleOp moduleOp, ArrayRef<FunctionOpInterface> funcOps);
+
+  void fillAxisInfoMap(FunctionOpInterface funcOp, AxisInfoAnalysis *analysis);
+
   void update(CallOpInterface callOp, FunctionOpInterface funcOp);
 };
 
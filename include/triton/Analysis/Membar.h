@@ -4,27 +4,67 @@
 #include "Allocation.h"
 #include "llvm/ADT/SmallPtrSet.h"
 
-#include <set>
+#include <map>
+#include <optional>
 
 namespace mlir {
 
 class OpBuilder;
 
+/// Partition of the elements of a tensor among the warps of a CTA: along
+/// `dim`, the elements [i * tile, (i + 1) * tile) belong to the warp
+/// i % numWarps, and every other element is owned by a single warp as well.
+struct WarpPartition {
+  unsigned dim = 0;
+  unsigned tile = 0;
+  unsigned numWarps = 1;
+
+  bool operator==(const WarpPartition &other) const {
+    return dim == other.dim && tile == other.tile &&
+           numWarps == other.numWarps;
+  }
+
+  bool operator!=(const WarpPartition &other) const {
+    return !(*this == other);
+  }
+};
+
+/// Returns how the elements of a tensor of shape `shape` in the register
+/// layout `layout` are partitioned among the warps, if each element is held
+/// by a single warp.
+std::optional<WarpPartition> getWarpPartition(Attribute layout,
+                                              ArrayRef<int64_t> shape);
+
+/// A shared memory access of the tensor `value` in which every element is
+/// written or read by the warp owning it in `partition`.
+struct SubGroupAccess {
+  Value value;
+  WarpPartition partition;
+
+  bool operator==(const SubGroupAccess &other) const {
+    return value == other.value && partition == other.partition;
+  }
+
+  bool operator!=(const SubGroupAccess &other) const {
+    return !(*this == other);
+  }
+};
+
 struct BlockInfo {
   using BufferIdSetT = Allocation::BufferIdSetT;
-  using IntervalSetT = std::set<Interval<size_t>>;
+  /// Interval -> How it is accessed, if by the sub-groups owning its elements
+  using IntervalMapT =
+      std::map<Interval<size_t>, std::optional<SubGroupAccess>>;
 
-  IntervalSetT syncReadIntervals;
-  IntervalSetT syncWriteIntervals;
+  IntervalMapT syncReadIntervals;
+  IntervalMapT syncWriteIntervals;
 
   BlockInfo() = default;
 
   /// Unions two BlockInfo objects.
   BlockInfo &join(const BlockInfo &other) {
-    syncReadIntervals.insert(other.syncReadIntervals.begin(),
-                             other.syncReadIntervals.end());
-    syncWriteIntervals.insert(other.syncWriteIntervals.begin(),
-                              other.syncWriteIntervals.end());
+    join(syncReadIntervals, other.syncReadIntervals);
+    join(syncWriteIntervals, other.syncWriteIntervals);
     return *this;
   }
 
@@ -37,6 +77,18 @@ struct BlockInfo {
            isIntersected(syncWriteIntervals, other.syncWriteIntervals);
   }
 
+  /// Returns true if all the intersected intervals in two BlockInfo objects
+  /// are accessed by the same sub-groups, so that ordering the accesses
+  /// within each sub-group is enough.
+  bool isSubGroupLocal(const BlockInfo &other) const {
+    return /*RAW*/ isSubGroupLocal(syncWriteIntervals,
+                                   other.syncReadIntervals) &&
+           /*WAR*/
+           isSubGroupLocal(syncReadIntervals, other.syncWriteIntervals) &&
+           /*WAW*/
+           isSubGroupLocal(syncWriteIntervals, other.syncWriteIntervals);
+  }
+
   /// Clears the intervals because a barrier is inserted.
   void sync() {
     syncReadIntervals.clear();
@@ -51,15 +103,41 @@ struct BlockInfo {
 
   bool operator!=(const BlockInfo &other) const { return !(*this == other); }
 
+  /// Records an access of `interval`.
+  static void insert(IntervalMapT &intervalMap, Interval<size_t> interval,
+                     std::optional<SubGroupAccess> access = std::nullopt) {
+    auto [it, inserted] = intervalMap.try_emplace(interval, access);
+    // An interval accessed in different ways may be accessed by any
+    // sub-group.
+    if (!inserted && it->second != access)
+      it->second = std::nullopt;
+  }
+
 private:
-  bool isIntersected(const IntervalSetT &lhsIntervalSet,
-                     const IntervalSetT &rhsIntervalSet) const {
-    for (auto &lhs : lhsIntervalSet)
-      for (auto &rhs : rhsIntervalSet)
-        if (lhs.intersects(rhs))
+  static void join(IntervalMapT &lhsIntervalMap,
+                   const IntervalMapT &rhsIntervalMap) {
+    for (auto &[interval, access] : rhsIntervalMap)
+      insert(lhsIntervalMap, interval, access);
+  }
+
+  bool isIntersected(const IntervalMapT &lhsIntervalMap,
+                     const IntervalMapT &rhsIntervalMap) const {
+    for (auto &lhs : lhsIntervalMap)
+      for (auto &rhs : rhsIntervalMap)
+        if (lhs.first.intersects(rhs.first))
           return true;
     return false;
   }
+
+  bool isSubGroupLocal(const IntervalMapT &lhsIntervalMap,
+                       const IntervalMapT &rhsIntervalMap) const {
+    for (auto &lhs : lhsIntervalMap)
+      for (auto &rhs : rhsIntervalMap)
+        if (lhs.first.intersects(rhs.first) &&
+            (!lhs.second || lhs.second != rhs.second))
+          return false;
+    return true;
+  }
 };
 
 //===----------------------------------------------------------------------===//
@@ -81,8 +159,22 @@ public:
   /// a shared memory read. If the temporary storage is written but not read,
   /// it is considered as the problem of the operation itself but not the membar
   /// analysis.
+  /// When `subGroupBarriers` is set, the accesses that are confined to the
+  /// sub-groups owning the data, e.g. the staging of DPAS operands in shared
+  /// memory when the warps only split their N dimension, are ordered by a
+  /// sub-group barrier instead of a work-group one.
+  /// When `splitBarriers` is set, a work-group barrier following operations
+  /// that don't access the shared memory is split: its arrive is issued after
+  /// the last of the accesses to order and its wait right before the access
+  /// that needs them ordered, so that the sub-groups keep working in between.
+  /// The accesses before a triton_nvidia_gpu.bar_arrive are then ordered by
+  /// the following triton_nvidia_gpu.bar_wait of the block, these being
+  /// barriers of the whole work-group.
   MembarAnalysis() = default;
-  explicit MembarAnalysis(Allocation *allocation) : allocation(allocation) {}
+  explicit MembarAnalysis(Allocation *allocation, bool subGroupBarriers = false,
+                          bool splitBarriers = false)
+      : allocation(allocation), subGroupBarriers(subGroupBarriers),
+        splitBarriers(splitBarriers) {}
 
   /// Runs the membar analysis to the given operation, inserts a barrier if
   /// necessary.
@@ -115,8 +207,30 @@ private:
 
   void insertBarrier(Operation *operation, OpBuilder *builder);
 
+  void insertSubGroupBarrier(Operation *operation, OpBuilder *builder);
+
+  /// Inserts the arrive of a split barrier after the last operation before
+  /// `operation` accessing the shared memory and its wait before `operation`,
+  /// if there are operations in between. Returns whether it was inserted.
+  bool insertSplitBarrier(Operation *operation, OpBuilder *builder);
+
+  /// Returns the shared memory accesses of `operation`.
+  BlockInfo getAccesses(Operation *operation,
+                        FuncBlockInfoMapT *funcBlockInfoMap) const;
+
+  /// Returns whether `operation` may access the shared memory or synchronize
+  /// the sub-groups.
+  bool mayAccessSharedMemory(Operation *operation) const;
+
+  /// Returns how `value` is accessed in shared memory by `op`, if only by the
+  /// sub-groups owning its elements.
+  std::optional<SubGroupAccess> getSubGroupAccess(Operation *op,
+                                                  Value value) const;
+
 private:
   Allocation *allocation = nullptr;
+  bool subGroupBarriers = false;
+  bool splitBarriers = false;
 };
 
 /// Postorder traversal on the callgraph to insert membar instructions
@@ -126,9 +240,12 @@ private:
 /// before and after function calls, but might be a bit conservative.
 class ModuleMembarAnalysis : public CallGraph<BlockInfo> {
 public:
-  ModuleMembarAnalysis(ModuleAllocation *moduleAllocation)
+  ModuleMembarAnalysis(ModuleAllocation *moduleAllocation,
+                       bool subGroupBarriers = false,
+                       bool splitBarriers = false)
       : CallGraph<BlockInfo>(moduleAllocation->getModuleOp()),
-        moduleAllocation(moduleAllocation) {}
+        moduleAllocation(moduleAllocation),
+        subGroupBarriers(subGroupBarriers), splitBarriers(splitBarriers) {}
 
   void run() {
     walk<WalkOrder::PreOrder, WalkOrder::PostOrder>(
@@ -139,7 +256,8 @@ public:
           auto *allocation = moduleAllocation->getFuncData(funcOp);
           auto [it, inserted] = funcMap.try_emplace(funcOp, BlockInfo());
           if (inserted) {
-            MembarAnalysis analysis(allocation);
+            MembarAnalysis analysis(allocation, subGroupBarriers,
+                                    splitBarriers);
             analysis.run(funcMap);
           }
         });
@@ -147,6 +265,8 @@ public:
 
 private:
   ModuleAllocation *moduleAllocation;
+  bool subGroupBarriers;
+  bool splitBarriers;
 };
 
 } // namespace mlir
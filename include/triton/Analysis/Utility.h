@@ -7,6 +7,7 @@
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include <algorithm>
 #include <numeric>
+#include <optional>
 #include <string>
 
 namespace mlir {
@@ -140,6 +141,36 @@ private:
   SmallVector<Type> srcElementTypes;
 };
 
+// The compare-exchanges of the bitonic network of tt.sort and tt.topk, along
+// the axis of their operand.
+class SortLoweringHelper {
+public:
+  // Where the elements at a distance along the axis are exchanged.
+  enum class Exchange { Register, SubGroup, SharedMemory };
+
+  explicit SortLoweringHelper(Operation *op);
+
+  // Return where the elements at `distance` along the axis are exchanged. The
+  // exchanges of the layouts other than the blocked ones are through the
+  // shared memory unless both elements are in the registers of a thread, which
+  // the lowering checks first.
+  Exchange getExchange(unsigned distance);
+  // Return the distance between the lanes of the elements at `distance` along
+  // the axis, of a SubGroup exchange.
+  unsigned getLaneDistance(unsigned distance);
+  // Return the size of the scratch space needed for the lowering.
+  unsigned getScratchSizeInBytes();
+
+  Location getLoc() { return op->getLoc(); }
+  unsigned getAxis() { return axis; }
+  RankedTensorType getSrcType() { return srcTy; }
+
+private:
+  Operation *op;
+  RankedTensorType srcTy;
+  unsigned axis;
+};
+
 bool maybeSharedAllocationOp(Operation *op);
 
 bool maybeAliasOp(Operation *op);
@@ -158,8 +189,29 @@ bool isMfmaToDotShortcut(RankedTensorType &srcTy, RankedTensorType &dstTy);
 
 bool isMmaToDotShortcut(RankedTensorType srcTy, RankedTensorType dstTy);
 
+bool isDpasToDotShortcut(RankedTensorType srcTy, RankedTensorType dstTy);
+
 bool isMmaToMmaShortcut(RankedTensorType srcTy, RankedTensorType dstTy);
 
+/// A conversion between blocked layouts, or slices of them, in which every
+/// thread gets the elements of its destination from lanes of its own warp:
+/// its destination register `i` is the source register `srcRegs[i]` of the
+/// lane given by getWarpLocalSrcLane. `sameLane[i]` is set when every thread
+/// already holds its element `i` in that register, e.g. for replicated data.
+struct WarpLocalCvtLayout {
+  SmallVector<unsigned> srcRegs;
+  SmallVector<bool> sameLane;
+};
+
+std::optional<WarpLocalCvtLayout>
+getWarpLocalCvtLayout(RankedTensorType srcTy, RankedTensorType dstTy);
+
+bool isWarpLocalCvtLayout(RankedTensorType srcTy, RankedTensorType dstTy);
+
+/// Returns the lane of a warp holding the element at `coord` in the source
+/// layout of a warp-local conversion.
+unsigned getWarpLocalSrcLane(Attribute srcLayout, ArrayRef<unsigned> coord);
+
 // Return true if the src and dst layout match.
 bool matchMmaV3AndDotOperandLayout(RankedTensorType srcTy,
                                    RankedTensorType dstTy);
@@ -28,6 +28,10 @@ std::unique_ptr<OperationPass<ModuleOp>> createAllocateSharedMemoryPass();
 std::unique_ptr<OperationPass<ModuleOp>>
 createAllocateSharedMemoryPass(const AllocateSharedMemoryOptions &options);
 
+std::unique_ptr<OperationPass<ModuleOp>> createScheduleDPASPass();
+std::unique_ptr<OperationPass<ModuleOp>>
+createScheduleDPASPass(const ScheduleDPASOptions &options);
+
 } // namespace gpu
 
 std::unique_ptr<OperationPass<ModuleOp>> createConvertTritonGPUToLLVMPass();
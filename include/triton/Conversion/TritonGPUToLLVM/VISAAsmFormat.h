@@ -0,0 +1,80 @@
+#ifndef TRITON_CONVERSION_TRITON_GPU_TO_LLVM_VISA_ASM_FORMAT_H_
+#define TRITON_CONVERSION_TRITON_GPU_TO_LLVM_VISA_ASM_FORMAT_H_
+
+#include "mlir/IR/Value.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include <memory>
+#include <string>
+
+namespace mlir {
+class ConversionPatternRewriter;
+class Location;
+
+namespace triton {
+using llvm::StringRef;
+
+// VISABuilder builds an inline vISA asm program of the Intel GPUs, lowered to
+// OpAsmINTEL by the SPIR-V translator (SPV_INTEL_inline_assembly) and compiled
+// by IGC. The instructions are given as text, referring the operands as $idx,
+// the outputs first, as in LLVM inline asm.
+//
+// Usage:
+// To build: "add (M1, 16) $0(0,0)<1> $1(0,0)<1;1,0> $2(0,0)<1;1,0>"
+//
+// VISABuilder builder;
+// auto *res = builder.newOperand("=rw");       // $0
+// auto *lhs = builder.newOperand(lhsVal, "rw"); // $1 bind to lhsVal
+// auto *rhs = builder.newOperand(rhsVal, "rw"); // $2 bind to rhsVal
+// builder.create("add (M1, 16) " + res->dump() + "(0,0)<1> " + lhs->dump() +
+//                "(0,0)<1;1,0> " + rhs->dump() + "(0,0)<1;1,0>");
+// Value sum = builder.launch(rewriter, loc, f32_ty, /*hasSideEffect=*/false);
+//
+// The vISA registers are typed by the operands, "rw" operands can be of any
+// scalar or vector type, a vector being as many consecutive registers of the
+// sub-group as it has elements.
+struct VISABuilder {
+  struct Operand {
+    std::string constraint;
+    Value value;
+    int idx{-1};
+
+    Operand(Value value, StringRef constraint, int idx)
+        : constraint(constraint), value(value), idx(idx) {}
+
+    // The reference to the operand in the instructions.
+    std::string dump() const { return "$" + std::to_string(idx); }
+  };
+
+  // Create a new output operand, the constraint starting with "=", e.g. "=rw".
+  // The outputs are created before the inputs.
+  Operand *newOperand(StringRef constraint);
+
+  // Create a new input operand of @value, e.g. with the constraint "rw", or
+  // "i" for an immediate.
+  Operand *newOperand(mlir::Value value, StringRef constraint);
+
+  // Append the instruction @instr to the program.
+  void create(StringRef instr) { instrs.push_back(instr.str()); }
+
+  llvm::SmallVector<Value, 4> getAllMLIRArgs() const;
+
+  std::string getConstraints() const;
+
+  std::string dump() const;
+
+  // Create the asm op returning @resTy, a struct of the outputs if there are
+  // several.
+  mlir::Value launch(OpBuilder &rewriter, Location loc, Type resTy,
+                     bool hasSideEffect = true) const;
+
+private:
+  llvm::SmallVector<std::unique_ptr<Operand>, 6> operands;
+  llvm::SmallVector<std::string, 2> instrs;
+};
+
+} // namespace triton
+} // namespace mlir
+
+#endif // TRITON_CONVERSION_TRITON_GPU_TO_LLVM_VISA_ASM_FORMAT_H_
@@ -7,6 +7,13 @@
 namespace mlir {
 namespace triton {
 namespace gpu {
+namespace intel {
+
+// Keep in sync with the device architecture returned by
+// `get_device_properties` in third_party/intel/backend/driver.c.
+enum class DeviceArch { ATS = 0, PVC = 1, UNKNOWN = 3 };
+
+} // namespace intel
 
 std::unique_ptr<Pass> createPipelinePass(int numStages = 3, int numWarps = 4,
                                          int numCTAs = 1,
@@ -14,11 +21,60 @@ std::unique_ptr<Pass> createPipelinePass(int numStages = 3, int numWarps = 4,
 
 std::unique_ptr<Pass> createAccelerateMatmulPass(int computeCapability = 80);
 
+namespace intel {
+std::unique_ptr<Pass>
+createAccelerateMatmulPass(DeviceArch arch = DeviceArch::PVC);
+
+std::unique_ptr<Pass>
+createMaterializeBlockPointerPass(DeviceArch arch = DeviceArch::PVC);
+
+std::unique_ptr<Pass> createPipelinePass(int numStages = 3);
+
+std::unique_ptr<Pass> createPrefetchBlockPass(int numStages = 3);
+
+std::unique_ptr<Pass> createPersistentPass(unsigned swizzleGroup = 0);
+
+std::unique_ptr<Pass> createPartitionGridPass();
+
+std::unique_ptr<Pass> createDistributeReductionsPass();
+
+std::unique_ptr<Pass> createInstrumentRegionsPass();
+
+std::unique_ptr<Pass> createInstrumentRegionsPass(StringRef regions);
+
+std::unique_ptr<Pass> createBufferPrintsPass();
+
+std::unique_ptr<Pass> createGridBarriersPass();
+
+std::unique_ptr<Pass> createPackScalarArgsPass();
+
+std::unique_ptr<Pass> createPackScalarArgsPass(unsigned minNumArgs);
+
+std::unique_ptr<Pass> createEstimateResourcesPass();
+
+std::unique_ptr<Pass> createEstimateResourcesPass(unsigned grfSize,
+                                                  unsigned threadsPerXeCore,
+                                                  unsigned sharedPerXeCore);
+
+std::unique_ptr<Pass> createEstimateTrafficPass();
+
+std::unique_ptr<Pass> createStrengthReducePointersPass();
+
+std::unique_ptr<Pass> createNarrowPointerOffsetsPass();
+
+std::unique_ptr<Pass> createSelectNumWarpsPass();
+
+std::unique_ptr<Pass> createSelectNumWarpsPass(unsigned threadsPerWarp,
+                                               unsigned threadsPerXeCore);
+
+std::unique_ptr<Pass> createLoopUnrollPass();
+} // namespace intel
+
 std::unique_ptr<Pass> createPrefetchPass();
 
 std::unique_ptr<Pass> createCanonicalizeLoopsPass();
 
-std::unique_ptr<Pass> createCoalescePass();
+std::unique_ptr<Pass> createCoalescePass(unsigned maxVectorBits = 128);
 
 std::unique_ptr<Pass> createReorderInstructionsPass();
 
@@ -14,9 +14,17 @@ namespace triton {
 class LoadOp;
 class StoreOp;
 class FuncOp;
+class MakeTensorPtrOp;
 namespace gpu {
 class SharedEncodingAttr;
-}
+
+namespace intel {
+/// Give the block pointer created by \param op, and its loads and stores, the
+/// DPAS layouts of their users, so that they are lowered to 2D block IO.
+/// Returns false, leaving the IR unchanged, if any use cannot be handled.
+bool materializeBlockPointer(MakeTensorPtrOp op);
+} // namespace intel
+} // namespace gpu
 } // namespace triton
 
 SmallVector<unsigned, 3> mmaVersionToInstrShape(int version,
@@ -2,6 +2,7 @@
 #define TRITON_TARGET_SPIRVTRANSLATION_H
 
 #include <string>
+#include <vector>
 
 namespace llvm {
 class Module;
@@ -9,8 +10,19 @@ class Module;
 
 namespace triton {
 
-// Translate TritonGPU IR to SPIRV code.
-std::string translateLLVMIRToSPIRV(llvm::Module &module);
+// Translate TritonGPU IR to SPIRV code. The module is verified first if
+// `verify` is set. Only the given SPIRV `extensions` are used, or all the
+// extensions the translator supports if none is given.
+std::string
+translateLLVMIRToSPIRV(llvm::Module &module, bool verify = false,
+                       const std::vector<std::string> &extensions = {});
+
+// Link the kernels of several SPIRV modules into a single SPIRV module, so
+// that they are built at once by the driver. The kernel of `binaries[i]` is
+// renamed to `names[i]`. Return an empty string and set `error` on failure.
+std::string linkSPIRVModules(const std::vector<std::string> &binaries,
+                             const std::vector<std::string> &names,
+                             std::string &error);
 
 } // namespace triton
 
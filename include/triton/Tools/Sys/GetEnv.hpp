@@ -32,7 +32,8 @@ namespace triton {
 const std::set<std::string> ENV_VARS = {
     "DISABLE_MMA_V3",     "TRITON_DISABLE_LINE_INFO", "DISABLE_FAST_REDUCTION",
     "ENABLE_TMA",         "MLIR_ENABLE_DUMP",         "LLVM_IR_ENABLE_DUMP",
-    "AMDGCN_ENABLE_DUMP", "DISABLE_LLVM_OPT"};
+    "AMDGCN_ENABLE_DUMP", "DISABLE_LLVM_OPT",         "MLIR_ENABLE_REMARK",
+    "MLIR_DISABLE_MULTITHREADING"};
 
 namespace tools {
 
@@ -79,6 +79,10 @@ SmallVector<unsigned> getRepShapeForCvtLayout(triton::gpu::ConvertLayoutOp op) {
     }
   }
 
+  // DpasToDotShortcut doesn't use shared mem
+  if (isDpasToDotShortcut(srcTy, dstTy))
+    return {};
+
   assert(srcLayout && dstLayout && "Unexpected layout in getRepShape()");
 
   auto srcShapePerCTA = getShapePerCTA(srcTy);
@@ -96,6 +100,16 @@ SmallVector<unsigned> getRepShapeForCvtLayout(triton::gpu::ConvertLayoutOp op) {
   return repShape;
 }
 
+size_t getExplicitBufferAlignment(size_t bytes) {
+  // XXX(Keren): Why this hard-coded alignment?
+  // XXX(Keren): magic numbers 256 and 1024
+  // benzh@maybe alignment should be passed in.
+  // Software swizzling calculates phase based on offset, while hardware
+  // swizzling do that based on physical address. Thus only by setting the
+  // alignment to 1024 can ensure the correctness.
+  return bytes > 256 ? 1024 : 8;
+}
+
 SmallVector<unsigned>
 getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
                              unsigned &outVec) {
@@ -109,7 +123,6 @@ getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
   Attribute dstLayout = dstTy.getEncoding();
 
   if (srcLayout.isa<MfmaEncodingAttr>() &&
-      srcLayout.dyn_cast<MfmaEncodingAttr>().getIsTransposed() &&
       dstLayout.isa<DotOperandEncodingAttr>())
     if (isMfmaToDotShortcut(srcTy, dstTy))
       return {};
@@ -179,6 +192,9 @@ private:
   using GraphT = DenseMap<BufferT *, DenseSet<BufferT *>>;
 
   void run() {
+    compact = triton::gpu::TritonGPUDialect::getMaxSharedMem(
+                  operation->getParentOfType<ModuleOp>())
+                  .has_value();
     getValuesAndSizes();
     resolveLiveness();
     computeOffsets();
@@ -194,8 +210,7 @@ private:
     if (!maybeSharedAllocationOp(op) || maybeAliasOp(op))
       return;
 
-    // XXX(Keren): Why this hard-coded alignment?
-    size_t kAlignment = 8;
+    size_t kAlignment = getExplicitBufferAlignment(0);
     for (Value result : op->getResults()) {
       if (triton::gpu::hasSharedEncoding(result)) {
         // Bytes could be a different value once we support padding or other
@@ -205,13 +220,7 @@ private:
         auto bytes = product<int64_t>(shapePerCTA) *
                      tensorType.getElementTypeBitWidth() / 8;
 
-        // XXX(Keren): magic numbers 256 and 1024
-        // benzh@maybe alignment should be passed in.
-        // Software swizzling calculates phase based on offset, while hardware
-        // swizzling do that based on physical address. Thus only by setting the
-        // alignment to 1024 can ensure the correctness. 
-        if (bytes > 256)
-          kAlignment = 1024;
+        kAlignment = std::max(kAlignment, getExplicitBufferAlignment(bytes));
         allocation->addBuffer<BufferT::BufferKind::Explicit>(result, bytes,
                                                              kAlignment);
       }
@@ -251,12 +260,21 @@ private:
       unsigned bytes = helper.getScratchSizeInBytes();
       maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(op, bytes,
                                                           scratchAlignment);
+    } else if (isa<triton::SortOp, triton::TopKOp>(op)) {
+      SortLoweringHelper helper(op);
+      unsigned bytes = helper.getScratchSizeInBytes();
+      maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(op, bytes,
+                                                          scratchAlignment);
     } else if (auto histogram = dyn_cast<triton::HistogramOp>(op)) {
       auto dstTy = histogram.getResult().getType().cast<RankedTensorType>();
       int threadsPerWarp = triton::gpu::TritonGPUDialect::getThreadsPerWarp(
           op->getParentOfType<ModuleOp>());
+      int numWarps = triton::gpu::TritonGPUDialect::getNumWarps(
+          op->getParentOfType<ModuleOp>());
+      // The GENX lowering keeps one copy of the histogram per warp.
       auto bytes = std::max<int>(dstTy.getNumElements(), threadsPerWarp) *
-                   std::max<int>(8, dstTy.getElementTypeBitWidth()) / 8;
+                   std::max<int>(8, dstTy.getElementTypeBitWidth()) / 8 *
+                   numWarps;
       maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(op, bytes,
                                                           scratchAlignment);
     } else if (auto cvtLayout = dyn_cast<triton::gpu::ConvertLayoutOp>(op)) {
@@ -269,10 +287,10 @@ private:
         // Conversions from/to shared memory do not need scratch memory.
         return;
       }
+      // Conversions within the warps exchange the elements with shuffles.
+      if (isWarpLocalCvtLayout(srcTy, dstTy))
+        return;
       // ConvertLayoutOp with both input/output non-shared_layout
-      // TODO: Besides of implementing ConvertLayoutOp via shared memory, it's
-      //       also possible to realize it with other approaches in restricted
-      //       conditions, such as warp-shuffle
       unsigned inVec = 0;
       unsigned outVec = 0;
       auto smemShape = getScratchConfigForCvtLayout(cvtLayout, inVec, outVec);
@@ -495,6 +513,11 @@ private:
       buffers.emplace_back(bufferIter.first);
     }
 
+    if (compact) {
+      allocateBestFit(buffers);
+      return;
+    }
+
     DenseMap<BufferT *, size_t> bufferStart;
     calculateStarts(buffers, bufferStart);
 
@@ -648,11 +671,61 @@ private:
     }
   }
 
+  /// Assigns the offsets greedily, from the largest buffer to the smallest:
+  /// each buffer goes to the smallest gap left between the buffers already
+  /// placed whose liveness ranges overlap its own, or right above them. The
+  /// scratch buffers thus overlay the explicit buffers that are dead by the
+  /// time they are used, instead of being stacked on top of them.
+  void allocateBestFit(const SmallVector<BufferT *> &buffers) {
+    allocation->sharedMemorySize = 0;
+    SmallVector<BufferT *> sorted(buffers);
+    std::stable_sort(sorted.begin(), sorted.end(), [&](BufferT *x, BufferT *y) {
+      if (x->size != y->size)
+        return x->size > y->size;
+      return bufferRange.lookup(x).start() < bufferRange.lookup(y).start();
+    });
+
+    SmallVector<BufferT *> placed;
+    for (auto *x : sorted) {
+      auto xRange = bufferRange.lookup(x);
+      SmallVector<BufferT *> neighbors;
+      for (auto *y : placed)
+        if (bufferRange.lookup(y).intersects(xRange))
+          neighbors.push_back(y);
+      llvm::sort(neighbors, [](BufferT *a, BufferT *b) {
+        return a->offset < b->offset;
+      });
+
+      size_t bestOffset = std::numeric_limits<size_t>::max();
+      size_t bestGap = std::numeric_limits<size_t>::max();
+      size_t start = 0;
+      for (auto *y : neighbors) {
+        size_t offset = llvm::alignTo(start, x->alignment);
+        if (offset + x->size <= y->offset && y->offset - start < bestGap) {
+          bestOffset = offset;
+          bestGap = y->offset - start;
+        }
+        start = std::max(start, y->offset + y->size);
+      }
+      if (bestOffset == std::numeric_limits<size_t>::max())
+        bestOffset = llvm::alignTo(start, x->alignment);
+
+      x->offset = bestOffset;
+      placed.push_back(x);
+      allocation->sharedMemorySize =
+          std::max(allocation->sharedMemorySize, x->offset + x->size);
+    }
+  }
+
 private:
   Operation *operation;
   Allocation::FuncAllocMapT *funcAllocMap;
   Allocation *allocation;
   BufferRangeMapT bufferRange;
+  /// Whether to pack the buffers with the best-fit allocator, which is done
+  /// when the shared memory of the device is known and the allocation is
+  /// checked against it.
+  bool compact = false;
 };
 
 } // namespace triton
@@ -947,11 +947,14 @@ AxisInfoAnalysis::AxisInfoAnalysis(DataFlowSolver &solver)
 void AxisInfoAnalysis::visitOperation(
     Operation *op, ArrayRef<const dataflow::Lattice<AxisInfo> *> operands,
     ArrayRef<dataflow::Lattice<AxisInfo> *> results) {
-  // TODO: For sure not the right way to do this
-  // but why is scf.if not initialized otherwise?
+  // Wait for all the operands to be known, e.g. the arguments of a callee
+  // until its call sites are visited, or the values carried by a loop until
+  // its body is: the pessimistic state joined meanwhile would stick. The
+  // values that are never reached are made pessimistic once the analysis
+  // converged, see `ModuleAxisInfoAnalysis::initialize`.
   for (auto op : operands)
     if (op->getValue().getRank() == 0)
-      setToEntryState((dataflow::Lattice<AxisInfo> *)op);
+      return;
   AxisInfo curr = visitors.apply(op, operands);
   if (curr.getRank() == 0)
     return setAllToEntryStates(results);
@@ -1048,9 +1051,35 @@ void ModuleAxisInfoAnalysis::initialize(FunctionOpInterface funcOp) {
   AxisInfoAnalysis *analysis = solver->load<AxisInfoAnalysis>();
   if (failed(solver->initializeAndRun(funcOp)))
     return;
+  fillAxisInfoMap(funcOp, analysis);
+}
+
+// Analyze all the functions at once, now that the arguments of the callees
+// have the axis info of their call sites: the solver joins the values returned
+// by a callee into the results of its calls, and the operands of the calls
+// into the arguments of the callees whose call sites are all known.
+void ModuleAxisInfoAnalysis::reanalyze(ModuleOp moduleOp,
+                                       ArrayRef<FunctionOpInterface> funcOps) {
+  if (funcOps.size() < 2)
+    return;
+  std::unique_ptr<DataFlowSolver> solver = createDataFlowSolver();
+  AxisInfoAnalysis *analysis = solver->load<AxisInfoAnalysis>();
+  if (failed(solver->initializeAndRun(moduleOp)))
+    return;
+  for (auto funcOp : funcOps) {
+    getFuncData(funcOp)->clear();
+    fillAxisInfoMap(funcOp, analysis);
+  }
+}
+
+void ModuleAxisInfoAnalysis::fillAxisInfoMap(FunctionOpInterface funcOp,
+                                             AxisInfoAnalysis *analysis) {
   auto *axisInfoMap = getFuncData(funcOp);
   auto updateAxisInfoMap = [&](Value value) {
     auto axisInfo = analysis->getLatticeElement(value)->getValue();
+    // not reached by the analysis, e.g. in a function without callers
+    if (axisInfo.getRank() == 0)
+      axisInfo = AxisInfo::getPessimisticValueState(value);
     AxisInfo curAxisInfo;
     if (axisInfoMap->count(value)) {
       curAxisInfo = AxisInfo::join(axisInfo, axisInfoMap->lookup(value));
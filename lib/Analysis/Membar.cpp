@@ -8,12 +8,62 @@
 #include "triton/Dialect/TritonGPU/Transforms/Utility.h"
 #include "triton/Dialect/TritonNvidiaGPU/Transforms/Utility.h"
 
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/GPU/IR/GPUDialect.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include <deque>
 
 namespace mlir {
 
+std::optional<WarpPartition> getWarpPartition(Attribute layout,
+                                              ArrayRef<int64_t> shape) {
+  SmallVector<unsigned> warpsPerCTA;
+  // Number of consecutive elements held by a warp along each dimension.
+  SmallVector<unsigned> tile;
+  if (auto blockedLayout =
+          layout.dyn_cast<triton::gpu::BlockedEncodingAttr>()) {
+    warpsPerCTA = llvm::to_vector(blockedLayout.getWarpsPerCTA());
+    for (auto [sizePerThread, threadsPerWarp] :
+         llvm::zip(blockedLayout.getSizePerThread(),
+                   blockedLayout.getThreadsPerWarp()))
+      tile.push_back(sizePerThread * threadsPerWarp);
+  } else if (auto dpasLayout =
+                 layout.dyn_cast<triton::gpu::DpasEncodingAttr>()) {
+    warpsPerCTA = triton::gpu::getWarpsPerCTA(dpasLayout);
+    tile = {dpasLayout.getRepeatCount(), dpasLayout.getExecutionSize()};
+  } else if (auto dotOpLayout =
+                 layout.dyn_cast<triton::gpu::DotOperandEncodingAttr>()) {
+    auto dpasLayout =
+        dotOpLayout.getParent().dyn_cast<triton::gpu::DpasEncodingAttr>();
+    if (!dpasLayout)
+      return std::nullopt;
+    // The A (resp. B) operand is replicated across the warps splitting the N
+    // (resp. M) dimension of the result.
+    unsigned opIdx = dotOpLayout.getOpIdx();
+    warpsPerCTA = triton::gpu::getWarpsPerCTA(dpasLayout);
+    if (warpsPerCTA[1 - opIdx] != 1)
+      return std::nullopt;
+    tile = {dpasLayout.getRepeatCount(), dpasLayout.getExecutionSize()};
+  } else {
+    return std::nullopt;
+  }
+
+  WarpPartition partition;
+  for (unsigned d = 0; d < shape.size(); ++d) {
+    if (warpsPerCTA[d] == 1)
+      continue;
+    // Only handle warps splitting a single dimension.
+    if (partition.numWarps != 1)
+      return std::nullopt;
+    // Otherwise the layout wraps around and several warps hold the same
+    // elements.
+    if (shape[d] % (tile[d] * warpsPerCTA[d]) != 0)
+      return std::nullopt;
+    partition = WarpPartition{d, tile[d], warpsPerCTA[d]};
+  }
+  return partition;
+}
+
 void MembarAnalysis::run(FuncBlockInfoMapT &funcBlockInfoMap) {
   FunctionOpInterface funcOp =
       dyn_cast<FunctionOpInterface>(allocation->getOperation());
@@ -114,6 +164,87 @@ void MembarAnalysis::insertBarrier(Operation *op, OpBuilder *builder) {
   }
 }
 
+void MembarAnalysis::insertSubGroupBarrier(Operation *op,
+                                           OpBuilder *builder) {
+  OpBuilder::InsertionGuard g(*builder);
+  auto barrierOp = builder->create<gpu::BarrierOp>(op->getLoc());
+  barrierOp->setAttr("sub_group", builder->getUnitAttr());
+}
+
+bool MembarAnalysis::mayAccessSharedMemory(Operation *op) const {
+  if (isa<gpu::BarrierOp, triton::CallOp, triton::gpu::AsyncWaitOp,
+          triton::gpu::AsyncBulkWaitOp, triton::nvidia_gpu::NamedBarrierArriveOp,
+          triton::nvidia_gpu::NamedBarrierWaitOp>(op) ||
+      op->getNumRegions() > 0)
+    return true;
+  if (allocation->getBufferId(op) != Allocation::InvalidBufferId)
+    return true;
+  for (Value value : op->getOperands())
+    for (auto bufferId : allocation->getBufferIds(value))
+      if (bufferId != Allocation::InvalidBufferId)
+        return true;
+  for (Value value : op->getResults())
+    if (allocation->getBufferId(value) != Allocation::InvalidBufferId)
+      return true;
+  return false;
+}
+
+bool MembarAnalysis::insertSplitBarrier(Operation *op, OpBuilder *builder) {
+  // The operations between the last access and `op` run between the arrive
+  // and the wait.
+  Operation *lastAccess = op->getPrevNode();
+  unsigned numOps = 0;
+  for (; lastAccess && !mayAccessSharedMemory(lastAccess);
+       lastAccess = lastAccess->getPrevNode())
+    ++numOps;
+  if (numOps == 0)
+    return false;
+  auto mod = op->getParentOfType<ModuleOp>();
+  int numThreads = triton::gpu::TritonGPUDialect::getNumWarps(mod) *
+                   triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+  OpBuilder::InsertionGuard g(*builder);
+  if (lastAccess)
+    builder->setInsertionPointAfter(lastAccess);
+  else
+    builder->setInsertionPointToStart(op->getBlock());
+  Location loc = op->getLoc();
+  Value barId = builder->create<arith::ConstantIntOp>(loc, 0, 32);
+  Value numThreadsVal =
+      builder->create<arith::ConstantIntOp>(loc, numThreads, 32);
+  builder->create<triton::nvidia_gpu::NamedBarrierArriveOp>(loc, barId,
+                                                            numThreadsVal);
+  builder->setInsertionPoint(op);
+  builder->create<triton::nvidia_gpu::NamedBarrierWaitOp>(loc, barId,
+                                                          numThreadsVal);
+  return true;
+}
+
+std::optional<SubGroupAccess>
+MembarAnalysis::getSubGroupAccess(Operation *op, Value value) const {
+  auto cvtOp = dyn_cast<triton::gpu::ConvertLayoutOp>(op);
+  if (!cvtOp)
+    return std::nullopt;
+  Value src = cvtOp.getSrc();
+  Value result = cvtOp.getResult();
+  // registers -> shared memory: the elements are written by the warps holding
+  // them in the source layout.
+  // shared memory -> registers: the elements are read by the warps holding
+  // them in the result layout.
+  Value regValue;
+  if (value == result && !triton::gpu::hasSharedEncoding(src))
+    regValue = src;
+  else if (value == src && !triton::gpu::hasSharedEncoding(result))
+    regValue = result;
+  else
+    return std::nullopt;
+  auto regType = regValue.getType().cast<RankedTensorType>();
+  std::optional<WarpPartition> partition =
+      getWarpPartition(regType.getEncoding(), regType.getShape());
+  if (!partition)
+    return std::nullopt;
+  return SubGroupAccess{value, *partition};
+}
+
 void MembarAnalysis::update(Operation *op, BlockInfo *blockInfo,
                             FuncBlockInfoMapT *funcBlockInfoMap,
                             OpBuilder *builder) {
@@ -125,6 +256,9 @@ void MembarAnalysis::update(Operation *op, BlockInfo *blockInfo,
   }
 
   if (isa<gpu::BarrierOp>(op)) {
+    // A sub-group barrier doesn't order the accesses of different sub-groups.
+    if (op->hasAttr("sub_group"))
+      return;
     // If the current op is a barrier, we sync previous reads and writes
     blockInfo->sync();
     return;
@@ -140,6 +274,43 @@ void MembarAnalysis::update(Operation *op, BlockInfo *blockInfo,
     return;
   }
 
+  if (splitBarriers && isa<triton::nvidia_gpu::NamedBarrierWaitOp>(op)) {
+    // The accesses before the arrive are ordered, not those in between.
+    BlockInfo pending;
+    Operation *arrive = op->getPrevNode();
+    for (; arrive && !isa<triton::nvidia_gpu::NamedBarrierArriveOp>(arrive);
+         arrive = arrive->getPrevNode())
+      pending.join(getAccesses(arrive, funcBlockInfoMap));
+    if (arrive) {
+      blockInfo->sync();
+      blockInfo->join(pending);
+    }
+    return;
+  }
+
+  BlockInfo curBlockInfo = getAccesses(op, funcBlockInfoMap);
+  if (blockInfo->isIntersected(curBlockInfo)) {
+    builder->setInsertionPoint(op);
+    if (subGroupBarriers && blockInfo->isSubGroupLocal(curBlockInfo)) {
+      // The previous accesses are kept to order them against the ones of
+      // other sub-groups.
+      Operation *prevOp = op->getPrevNode();
+      if (!prevOp || !isa<gpu::BarrierOp>(prevOp) ||
+          !prevOp->hasAttr("sub_group"))
+        insertSubGroupBarrier(op, builder);
+    } else {
+      if (!splitBarriers || !insertSplitBarrier(op, builder))
+        insertBarrier(op, builder);
+      blockInfo->sync();
+    }
+  }
+  // Update the region info, even if barrier is inserted, we have to maintain
+  // the current op's read/write buffers.
+  blockInfo->join(curBlockInfo);
+}
+
+BlockInfo MembarAnalysis::getAccesses(Operation *op,
+                                      FuncBlockInfoMapT *funcBlockInfoMap) const {
   BlockInfo curBlockInfo;
   if (isa<triton::CallOp>(op)) {
     // Inter-function dependencies
@@ -154,16 +325,17 @@ void MembarAnalysis::update(Operation *op, BlockInfo *blockInfo,
       for (auto bufferId : allocation->getBufferIds(value)) {
         if (bufferId != Allocation::InvalidBufferId) {
           if (isa<triton::gpu::InsertSliceAsyncOp,
-                  triton::nvidia_gpu::InsertSliceTMAOp, tensor::InsertSliceOp>(
-                  op)) {
+                  triton::nvidia_gpu::InsertSliceTMAOp, tensor::InsertSliceOp,
+                  triton::LocalStoreOp>(op)) {
             // FIXME(Keren): insert_slice and insert_slice_async are always
             // alias for now
-            curBlockInfo.syncWriteIntervals.insert(
-                allocation->getAllocatedInterval(bufferId));
+            BlockInfo::insert(curBlockInfo.syncWriteIntervals,
+                              allocation->getAllocatedInterval(bufferId));
           } else {
             // ConvertLayoutOp: shared memory -> registers
-            curBlockInfo.syncReadIntervals.insert(
-                allocation->getAllocatedInterval(bufferId));
+            BlockInfo::insert(curBlockInfo.syncReadIntervals,
+                              allocation->getAllocatedInterval(bufferId),
+                              getSubGroupAccess(op, value));
           }
         }
       }
@@ -172,27 +344,20 @@ void MembarAnalysis::update(Operation *op, BlockInfo *blockInfo,
       // ConvertLayoutOp: registers -> shared memory
       auto bufferId = allocation->getBufferId(value);
       if (bufferId != Allocation::InvalidBufferId) {
-        curBlockInfo.syncWriteIntervals.insert(
-            allocation->getAllocatedInterval(bufferId));
+        BlockInfo::insert(curBlockInfo.syncWriteIntervals,
+                          allocation->getAllocatedInterval(bufferId),
+                          getSubGroupAccess(op, value));
       }
     }
     // Scratch buffer is considered as both shared memory write & read
     auto bufferId = allocation->getBufferId(op);
     if (bufferId != Allocation::InvalidBufferId) {
-      curBlockInfo.syncWriteIntervals.insert(
-          allocation->getAllocatedInterval(bufferId));
-      curBlockInfo.syncReadIntervals.insert(
-          allocation->getAllocatedInterval(bufferId));
+      BlockInfo::insert(curBlockInfo.syncWriteIntervals,
+                        allocation->getAllocatedInterval(bufferId));
+      BlockInfo::insert(curBlockInfo.syncReadIntervals,
+                        allocation->getAllocatedInterval(bufferId));
     }
   }
-
-  if (blockInfo->isIntersected(curBlockInfo)) {
-    builder->setInsertionPoint(op);
-    insertBarrier(op, builder);
-    blockInfo->sync();
-  }
-  // Update the region info, even if barrier is inserted, we have to maintain
-  // the current op's read/write buffers.
-  blockInfo->join(curBlockInfo);
+  return curBlockInfo;
 }
 } // namespace mlir
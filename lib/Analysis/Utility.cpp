@@ -11,6 +11,8 @@
 #include "triton/Dialect/TritonNvidiaGPU/IR/Dialect.h"
 #include "triton/Tools/Sys/GetEnv.hpp"
 #include <deque>
+#include <limits>
+#include <set>
 
 namespace mlir {
 
@@ -326,6 +328,59 @@ triton::gpu::BlockedEncodingAttr ScanLoweringHelper::getEncoding() {
   return srcEncoding.cast<triton::gpu::BlockedEncodingAttr>();
 }
 
+SortLoweringHelper::SortLoweringHelper(Operation *op) : op(op) {
+  if (auto sortOp = dyn_cast<triton::SortOp>(op)) {
+    axis = sortOp.getAxis();
+  } else {
+    auto topkOp = cast<triton::TopKOp>(op);
+    axis = topkOp.getAxis();
+  }
+  srcTy = op->getOperand(0).getType().cast<RankedTensorType>();
+}
+
+SortLoweringHelper::Exchange
+SortLoweringHelper::getExchange(unsigned distance) {
+  auto blocked =
+      srcTy.getEncoding().dyn_cast<triton::gpu::BlockedEncodingAttr>();
+  if (!blocked)
+    return Exchange::SharedMemory;
+  // The index along the axis is made of the bits of the element within the
+  // thread, of the lane, of the warp and of the repetition of the layout.
+  unsigned sizePerThread = blocked.getSizePerThread()[axis];
+  unsigned sizePerWarp = sizePerThread * blocked.getThreadsPerWarp()[axis];
+  unsigned sizePerCTA = sizePerWarp * blocked.getWarpsPerCTA()[axis];
+  if (distance < sizePerThread || distance >= sizePerCTA)
+    return Exchange::Register;
+  if (distance < sizePerWarp)
+    return Exchange::SubGroup;
+  return Exchange::SharedMemory;
+}
+
+unsigned SortLoweringHelper::getLaneDistance(unsigned distance) {
+  auto blocked = srcTy.getEncoding().cast<triton::gpu::BlockedEncodingAttr>();
+  auto threadsPerWarp = blocked.getThreadsPerWarp();
+  unsigned laneStride = 1;
+  for (unsigned dim : blocked.getOrder()) {
+    if (dim == axis)
+      break;
+    laneStride *= threadsPerWarp[dim];
+  }
+  return distance / blocked.getSizePerThread()[axis] * laneStride;
+}
+
+unsigned SortLoweringHelper::getScratchSizeInBytes() {
+  unsigned axisSize = srcTy.getDimSize(axis);
+  bool needsScratch = isa<triton::TopKOp>(op);
+  for (unsigned distance = 1; distance < axisSize && !needsScratch;
+       distance <<= 1)
+    needsScratch = getExchange(distance) == Exchange::SharedMemory;
+  if (!needsScratch)
+    return 0;
+  // The whole tensor, of which each thread reads the partners of its elements.
+  return ceil<unsigned>(srcTy.getElementTypeBitWidth(), 8) *
+         srcTy.getNumElements();
+}
+
 unsigned ScanLoweringHelper::getAxisElementStride() {
   auto order = triton::gpu::getOrder(getEncoding());
   unsigned stride = 1;
@@ -536,19 +591,32 @@ bool supportDPAS(triton::DotOp op) {
 }
 
 bool isMfmaToDotShortcut(RankedTensorType &srcTy, RankedTensorType &dstTy) {
-  auto srcLayout = srcTy.getEncoding();
-  auto dstLayout = dstTy.getEncoding();
-  auto mfmaLayout = srcLayout.cast<triton::gpu::MfmaEncodingAttr>();
-  auto dotOperandLayout = dstLayout.cast<triton::gpu::DotOperandEncodingAttr>();
-  // TODO: Remove the restriction on the warpsPerCTA once chain dot testing is
-  // improved. In addition, we can enable this shortcut for regular MFMA
-  // layout when opIdx == 1.
-  return mfmaLayout.getWarpsPerCTA()[1] == 1 &&
-         dotOperandLayout.getOpIdx() == 0 &&
-         dotOperandLayout.getKWidth() == 4 &&
-         dotOperandLayout.getParent() == mfmaLayout &&
-         mfmaLayout.getNonKDim() == 32 && mfmaLayout.getIsTransposed() &&
-         (srcTy.getElementType().isF16() || srcTy.getElementType().isBF16());
+  // dot_op<opIdx=0, parent=#mfma> = #mfma
+  // when #mfma = MfmaEncoding<isTransposed=true, warpsPerCTA=[..., 1]>: each
+  // lane holds a row of an accumulator tile, and
+  // dot_op<opIdx=1, parent=#mfma> = #mfma
+  // when #mfma = MfmaEncoding<isTransposed=false, warpsPerCTA=[1, ...]>: each
+  // lane holds a column of an accumulator tile. With kWidth = 4, each lane
+  // holds the same 4 consecutive K elements of the operand in both layouts.
+  auto mfmaLayout = srcTy.getEncoding().cast<triton::gpu::MfmaEncodingAttr>();
+  auto dotOperandLayout =
+      dstTy.getEncoding().cast<triton::gpu::DotOperandEncodingAttr>();
+  unsigned nonKDim = mfmaLayout.getNonKDim();
+  if (dotOperandLayout.getParent() != mfmaLayout ||
+      dotOperandLayout.getKWidth() != 4 || (nonKDim != 32 && nonKDim != 16) ||
+      !(srcTy.getElementType().isF16() || srcTy.getElementType().isBF16()))
+    return false;
+  SmallVector<unsigned> warpsPerCTA = mfmaLayout.getWarpsPerCTA();
+  if (dotOperandLayout.getOpIdx() == 0
+          ? !mfmaLayout.getIsTransposed() || warpsPerCTA[1] != 1
+          : mfmaLayout.getIsTransposed() || warpsPerCTA[0] != 1)
+    return false;
+  // Data replicated across warps is not supported.
+  ArrayRef<int64_t> shape = srcTy.getShape();
+  SmallVector<unsigned> shapePerCTATile =
+      triton::gpu::getShapePerCTATile(mfmaLayout);
+  return shape[0] % shapePerCTATile[0] == 0 &&
+         shape[1] % shapePerCTATile[1] == 0;
 }
 
 static bool isMmaToMmaShortcut(Attribute srcEncoding, Attribute dstEncoding) {
@@ -596,6 +664,234 @@ bool isMmaToDotShortcut(RankedTensorType srcTy, RankedTensorType dstTy) {
          !srcTy.getElementType().isF32();
 }
 
+bool isDpasToDotShortcut(RankedTensorType srcTy, RankedTensorType dstTy) {
+  // dot_op<opIdx=0, parent=#dpas> = #dpas
+  // when #dpas = DpasEncoding<warpsPerCTA=[..., 1]> and an A operand tile is as
+  // wide as an accumulator tile, i.e. each lane holds the same column of both.
+  auto dpasLayout =
+      srcTy.getEncoding().dyn_cast<triton::gpu::DpasEncodingAttr>();
+  auto dotOperandLayout =
+      dstTy.getEncoding().dyn_cast<triton::gpu::DotOperandEncodingAttr>();
+  if (!dpasLayout || !dotOperandLayout || dotOperandLayout.getOpIdx() != 0 ||
+      dotOperandLayout.getParent() != dpasLayout ||
+      dpasLayout.getWarpsPerCTA().back() != 1)
+    return false;
+  SmallVector<int64_t> elemsPerInstr = dotOperandLayout.getDPASElemsPerInstr(
+      srcTy.getElementType().getIntOrFloatBitWidth());
+  if (elemsPerInstr[0] != dpasLayout.getRepeatCount() ||
+      elemsPerInstr[1] != dpasLayout.getExecutionSize())
+    return false;
+  // Data replicated across warps is not supported.
+  ArrayRef<int64_t> shape = srcTy.getShape();
+  SmallVector<unsigned> shapePerCTATile =
+      triton::gpu::getShapePerCTATile(dpasLayout);
+  for (unsigned d = 0; d < shape.size(); ++d)
+    if (shape[d] % shapePerCTATile[d] != 0)
+      return false;
+  return true;
+}
+
+namespace {
+
+// Compile-time model of the indices emitted for the blocked layouts and their
+// slices by the LLVM lowering, see emitBaseIndexForLayout and
+// emitOffsetForLayout.
+
+triton::gpu::BlockedEncodingAttr getBlockedParent(Attribute layout) {
+  if (auto sliceLayout = layout.dyn_cast<triton::gpu::SliceEncodingAttr>())
+    return getBlockedParent(sliceLayout.getParent());
+  return layout.dyn_cast<triton::gpu::BlockedEncodingAttr>();
+}
+
+SmallVector<unsigned> delinearize(unsigned linear, ArrayRef<unsigned> shape,
+                                  ArrayRef<unsigned> order) {
+  SmallVector<unsigned> multiDim(shape.size());
+  for (unsigned d : order) {
+    multiDim[d] = linear % shape[d];
+    linear /= shape[d];
+  }
+  return multiDim;
+}
+
+unsigned linearize(ArrayRef<unsigned> multiDim, ArrayRef<unsigned> shape,
+                   ArrayRef<unsigned> order) {
+  unsigned linear = 0;
+  for (unsigned d : llvm::reverse(order))
+    linear = linear * shape[d] + multiDim[d];
+  return linear;
+}
+
+SmallVector<unsigned> getThreadBase(Attribute layout, ArrayRef<int64_t> shape,
+                                    unsigned warpId, unsigned laneId) {
+  if (auto sliceLayout = layout.dyn_cast<triton::gpu::SliceEncodingAttr>()) {
+    SmallVector<unsigned> base =
+        getThreadBase(sliceLayout.getParent(), sliceLayout.paddedShape(shape),
+                      warpId, laneId);
+    base.erase(base.begin() + sliceLayout.getDim());
+    return base;
+  }
+  auto blockedLayout = layout.cast<triton::gpu::BlockedEncodingAttr>();
+  ArrayRef<unsigned> sizePerThread = blockedLayout.getSizePerThread();
+  ArrayRef<unsigned> threadsPerWarp = blockedLayout.getThreadsPerWarp();
+  ArrayRef<unsigned> order = blockedLayout.getOrder();
+  SmallVector<unsigned> multiDimWarpId =
+      delinearize(warpId, blockedLayout.getWarpsPerCTA(), order);
+  SmallVector<unsigned> multiDimLaneId =
+      delinearize(laneId, threadsPerWarp, order);
+  SmallVector<unsigned> base(shape.size());
+  for (unsigned k = 0; k < shape.size(); ++k) {
+    unsigned maxWarps =
+        ceil<unsigned>(shape[k], sizePerThread[k] * threadsPerWarp[k]);
+    unsigned maxThreads = ceil<unsigned>(shape[k], sizePerThread[k]);
+    base[k] = sizePerThread[k] *
+              (multiDimLaneId[k] % maxThreads +
+               multiDimWarpId[k] % maxWarps * threadsPerWarp[k]);
+  }
+  return base;
+}
+
+SmallVector<SmallVector<unsigned>> getThreadOffsets(Attribute layout,
+                                                    ArrayRef<int64_t> shape,
+                                                    Type eltTy) {
+  if (auto sliceLayout = layout.dyn_cast<triton::gpu::SliceEncodingAttr>()) {
+    unsigned dim = sliceLayout.getDim();
+    SmallVector<SmallVector<unsigned>> offsets;
+    std::set<SmallVector<unsigned>> uniqueOffsets;
+    for (SmallVector<unsigned> offset :
+         getThreadOffsets(sliceLayout.getParent(),
+                          sliceLayout.paddedShape(shape), eltTy)) {
+      offset.erase(offset.begin() + dim);
+      if (uniqueOffsets.insert(offset).second)
+        offsets.push_back(offset);
+    }
+    return offsets;
+  }
+  auto blockedLayout = layout.cast<triton::gpu::BlockedEncodingAttr>();
+  ArrayRef<unsigned> sizePerThread = blockedLayout.getSizePerThread();
+  ArrayRef<unsigned> threadsPerWarp = blockedLayout.getThreadsPerWarp();
+  ArrayRef<unsigned> warpsPerCTA = blockedLayout.getWarpsPerCTA();
+  ArrayRef<unsigned> order = blockedLayout.getOrder();
+  SmallVector<unsigned> shapePerCTATile =
+      triton::gpu::getShapePerCTATile(blockedLayout);
+  unsigned rank = shape.size();
+  SmallVector<unsigned> tilesPerDim(rank);
+  for (unsigned k = 0; k < rank; ++k)
+    tilesPerDim[k] = ceil<unsigned>(shape[k], shapePerCTATile[k]);
+  unsigned elemsPerThread =
+      triton::gpu::getTotalElemsPerThread(blockedLayout, shape, eltTy);
+  unsigned totalSizePerThread = product<unsigned>(sizePerThread);
+  SmallVector<SmallVector<unsigned>> offsets(elemsPerThread);
+  for (unsigned n = 0; n < elemsPerThread; ++n) {
+    SmallVector<unsigned> multiDimNanoTileId =
+        delinearize(n / totalSizePerThread, tilesPerDim, order);
+    SmallVector<unsigned> multiDimNanoTileElemId =
+        delinearize(n % totalSizePerThread, sizePerThread, order);
+    for (unsigned k = 0; k < rank; ++k)
+      offsets[n].push_back(
+          multiDimNanoTileId[k] *
+              (sizePerThread[k] * threadsPerWarp[k] * warpsPerCTA[k]) +
+          multiDimNanoTileElemId[k]);
+  }
+  return offsets;
+}
+
+} // namespace
+
+unsigned getWarpLocalSrcLane(Attribute srcLayout, ArrayRef<unsigned> coord) {
+  if (auto sliceLayout = srcLayout.dyn_cast<triton::gpu::SliceEncodingAttr>()) {
+    SmallVector<unsigned> parentCoord(coord);
+    parentCoord.insert(parentCoord.begin() + sliceLayout.getDim(), 0);
+    return getWarpLocalSrcLane(sliceLayout.getParent(), parentCoord);
+  }
+  auto blockedLayout = srcLayout.cast<triton::gpu::BlockedEncodingAttr>();
+  ArrayRef<unsigned> sizePerThread = blockedLayout.getSizePerThread();
+  ArrayRef<unsigned> threadsPerWarp = blockedLayout.getThreadsPerWarp();
+  SmallVector<unsigned> multiDimLaneId(coord.size());
+  for (unsigned k = 0; k < coord.size(); ++k)
+    multiDimLaneId[k] = coord[k] / sizePerThread[k] % threadsPerWarp[k];
+  return linearize(multiDimLaneId, threadsPerWarp, blockedLayout.getOrder());
+}
+
+std::optional<WarpLocalCvtLayout>
+getWarpLocalCvtLayout(RankedTensorType srcTy, RankedTensorType dstTy) {
+  Attribute srcLayout = srcTy.getEncoding();
+  Attribute dstLayout = dstTy.getEncoding();
+  // Identical layouts are left to the canonicalizer.
+  if (srcLayout == dstLayout)
+    return std::nullopt;
+  auto srcBlocked = getBlockedParent(srcLayout);
+  auto dstBlocked = getBlockedParent(dstLayout);
+  if (!srcBlocked || !dstBlocked ||
+      product<unsigned>(triton::gpu::getCTAsPerCGA(srcBlocked)) != 1 ||
+      product<unsigned>(triton::gpu::getCTAsPerCGA(dstBlocked)) != 1)
+    return std::nullopt;
+  unsigned numWarps = product<unsigned>(srcBlocked.getWarpsPerCTA());
+  unsigned threadsPerWarp = product<unsigned>(srcBlocked.getThreadsPerWarp());
+  if (numWarps != product<unsigned>(dstBlocked.getWarpsPerCTA()) ||
+      threadsPerWarp != product<unsigned>(dstBlocked.getThreadsPerWarp()))
+    return std::nullopt;
+
+  ArrayRef<int64_t> shape = srcTy.getShape();
+  Type eltTy = srcTy.getElementType();
+  SmallVector<SmallVector<unsigned>> srcOffsets =
+      getThreadOffsets(srcLayout, shape, eltTy);
+  SmallVector<SmallVector<unsigned>> dstOffsets =
+      getThreadOffsets(dstLayout, shape, eltTy);
+  // Bound the compile time of the analysis.
+  if (numWarps * threadsPerWarp * dstOffsets.size() > (1u << 20))
+    return std::nullopt;
+
+  auto getCoord = [&](ArrayRef<unsigned> base, ArrayRef<unsigned> offset) {
+    SmallVector<unsigned> coord(shape.size());
+    for (unsigned d = 0; d < shape.size(); ++d)
+      coord[d] = (base[d] + offset[d]) % shape[d];
+    return coord;
+  };
+
+  // Check that every element of the destination of every thread is held by
+  // the source lane of its warp, in the same source register for all the
+  // threads.
+  constexpr unsigned kUnset = std::numeric_limits<unsigned>::max();
+  WarpLocalCvtLayout cvt;
+  cvt.srcRegs.assign(dstOffsets.size(), kUnset);
+  cvt.sameLane.assign(dstOffsets.size(), true);
+  for (unsigned warpId = 0; warpId < numWarps; ++warpId) {
+    SmallVector<SmallVector<unsigned>> srcBases;
+    for (unsigned laneId = 0; laneId < threadsPerWarp; ++laneId)
+      srcBases.push_back(getThreadBase(srcLayout, shape, warpId, laneId));
+    for (unsigned laneId = 0; laneId < threadsPerWarp; ++laneId) {
+      SmallVector<unsigned> dstBase =
+          getThreadBase(dstLayout, shape, warpId, laneId);
+      for (unsigned i = 0; i < dstOffsets.size(); ++i) {
+        SmallVector<unsigned> coord = getCoord(dstBase, dstOffsets[i]);
+        unsigned srcLane = getWarpLocalSrcLane(srcLayout, coord);
+        auto holds = [&](unsigned reg) {
+          return getCoord(srcBases[srcLane], srcOffsets[reg]) == coord;
+        };
+        if (cvt.srcRegs[i] == kUnset) {
+          for (unsigned reg = 0; reg < srcOffsets.size(); ++reg) {
+            if (holds(reg)) {
+              cvt.srcRegs[i] = reg;
+              break;
+            }
+          }
+          if (cvt.srcRegs[i] == kUnset)
+            return std::nullopt;
+        } else if (!holds(cvt.srcRegs[i])) {
+          return std::nullopt;
+        }
+        if (getCoord(srcBases[laneId], srcOffsets[cvt.srcRegs[i]]) != coord)
+          cvt.sameLane[i] = false;
+      }
+    }
+  }
+  return cvt;
+}
+
+bool isWarpLocalCvtLayout(RankedTensorType srcTy, RankedTensorType dstTy) {
+  return getWarpLocalCvtLayout(srcTy, dstTy).has_value();
+}
+
 namespace {
 
 /// A data structure similar to SetVector but maintains
@@ -27,6 +27,9 @@ struct AllocateSharedMemory
   void runOnOperation() override {
     ModuleOp mod = getOperation();
     MLIRContext *ctx = &getContext();
+    if (maxSharedMem)
+      mod->setAttr(triton::gpu::TritonGPUDialect::getMaxSharedMemAttrName(),
+                   IntegerAttr::get(IntegerType::get(ctx, 32), maxSharedMem));
     ModuleAllocation allocation(mod);
 
     mod.walk([&](FunctionOpInterface funcOp) {
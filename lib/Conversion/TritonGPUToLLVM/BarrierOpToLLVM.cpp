@@ -28,6 +28,63 @@ using namespace mlir;
 using namespace mlir::triton;
 
 namespace {
+// On GENX the named barriers map to the split barrier of the work-group
+// (SPV_INTEL_split_barrier): the producer sub-groups arrive once the data
+// they load into the shared memory is written, and the consumer sub-groups
+// only wait before reading it, so that both keep working in between. The
+// barrier ids and thread counts don't apply, every sub-group of the
+// work-group takes part in the barrier, alternating arrives and waits.
+static void createSplitBarrier(Location loc,
+                               ConversionPatternRewriter &rewriter,
+                               StringRef funcName) {
+  constexpr unsigned workgroupScope = 2;
+  constexpr unsigned acquireReleaseWorkgroupMemory = 0x108;
+  LLVM::createSPIRVBuiltinCall(
+      loc, rewriter, funcName, void_ty(rewriter.getContext()),
+      {i32_val(workgroupScope), i32_val(workgroupScope),
+       i32_val(acquireReleaseWorkgroupMemory)});
+}
+
+// The named barriers of a subset of the sub-groups map to the named barriers
+// of SPIR-V (NamedBarrier capability), initialized at the entry of the
+// function for the sub-groups taking part in them, one per barrier id.
+constexpr char kNamedBarrierIdAttr[] = "triton_gpu.named_barrier_id";
+
+static void createNamedBarrier(Operation *op,
+                               ConversionPatternRewriter &rewriter,
+                               int64_t barId, int64_t numThreads) {
+  Location loc = op->getLoc();
+  constexpr unsigned workgroupScope = 2;
+  constexpr unsigned acquireReleaseWorkgroupMemory = 0x108;
+  auto mod = op->getParentOfType<ModuleOp>();
+  int threadsPerWarp = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+  Block &entry =
+      op->getParentOfType<FunctionOpInterface>().getFunctionBody().front();
+  Value barrier;
+  for (LLVM::CallOp callOp : entry.getOps<LLVM::CallOp>()) {
+    auto id = callOp->getAttrOfType<IntegerAttr>(kNamedBarrierIdAttr);
+    if (id && id.getInt() == barId) {
+      barrier = callOp.getResult();
+      break;
+    }
+  }
+  if (!barrier) {
+    ConversionPatternRewriter::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPointToStart(&entry);
+    barrier = LLVM::createSPIRVBuiltinCall(
+        loc, rewriter, "_Z30__spirv_NamedBarrierInitializei",
+        ptr_ty(rewriter.getContext(), 3),
+        {i32_val(numThreads / threadsPerWarp)});
+    barrier.getDefiningOp()->setAttr(kNamedBarrierIdAttr,
+                                     rewriter.getI64IntegerAttr(barId));
+  }
+  LLVM::createSPIRVBuiltinCall(
+      loc, rewriter, "_Z26__spirv_MemoryNamedBarrierPU3AS3iii",
+      void_ty(rewriter.getContext()),
+      {barrier, i32_val(workgroupScope),
+       i32_val(acquireReleaseWorkgroupMemory)});
+}
+
 struct BarrierOpConversion
     : public ConvertTritonGPUOpToLLVMPattern<mlir::gpu::BarrierOp> {
   using ConvertTritonGPUOpToLLVMPattern<
@@ -42,7 +99,22 @@ struct BarrierOpConversion
       // so we have to lower it to ptx manually.
       auto barId = op->getAttrOfType<IntegerAttr>("bar_id").getInt();
       auto numThreads = op->getAttrOfType<IntegerAttr>("num_threads").getInt();
-      barSync(rewriter, op, barId, numThreads);
+      if (target == Target::GENX)
+        createNamedBarrier(op, rewriter, barId, numThreads);
+      else
+        barSync(rewriter, op, barId, numThreads);
+      rewriter.eraseOp(op);
+      return success();
+    }
+    if (op->hasAttr("sub_group") && target == Target::GENX) {
+      // Only orders the shared memory accesses of the sub-group.
+      constexpr unsigned subgroupScope = 3;
+      constexpr unsigned acquireReleaseWorkgroupMemory = 0x108;
+      LLVM::createSPIRVBuiltinCall(
+          loc, rewriter, "_Z22__spirv_ControlBarrieriii",
+          void_ty(rewriter.getContext()),
+          {i32_val(subgroupScope), i32_val(subgroupScope),
+           i32_val(acquireReleaseWorkgroupMemory)});
       rewriter.eraseOp(op);
       return success();
     }
@@ -193,6 +265,12 @@ struct NamedBarrierArriveOpConversion
                   OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
     Location loc = op->getLoc();
+    if (target == Target::GENX) {
+      createSplitBarrier(loc, rewriter,
+                         "_Z33__spirv_ControlBarrierArriveINTELiii");
+      rewriter.eraseOp(op);
+      return success();
+    }
     rewriter.replaceOpWithNewOp<triton::nvgpu::NamedBarrierArriveOp>(
         op, adaptor.getBar(), adaptor.getNumThreads());
     return success();
@@ -209,6 +287,12 @@ struct NamedBarrierWaitOpConversion
   matchAndRewrite(triton::nvidia_gpu::NamedBarrierWaitOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
     Location loc = op->getLoc();
+    if (target == Target::GENX) {
+      createSplitBarrier(loc, rewriter,
+                         "_Z31__spirv_ControlBarrierWaitINTELiii");
+      rewriter.eraseOp(op);
+      return success();
+    }
     rewriter.replaceOpWithNewOp<triton::nvgpu::NamedBarrierWaitOp>(
         op, adaptor.getBar(), adaptor.getNumThreads());
     return success();
@@ -101,6 +101,10 @@ public:
         dstLayout.isa<DotOperandEncodingAttr>()) {
       return lowerMmaToDotOperand(op, adaptor, rewriter);
     }
+    if (srcLayout.isa<DpasEncodingAttr>() &&
+        dstLayout.isa<DotOperandEncodingAttr>()) {
+      return lowerDpasToDotOperand(op, adaptor, rewriter);
+    }
     if (srcLayout.isa<SharedEncodingAttr>() &&
         isaDistributedLayout(dstLayout)) {
       return lowerSharedToDistributed(op, adaptor, rewriter);
@@ -249,12 +253,11 @@ private:
       SmallVector<Value> multiDimBase =
           emitBaseIndexForLayout(loc, rewriter, layout, type, false);
       SmallVector<SmallVector<unsigned>> offsets;
-      emitDpasOffsetForCTA(dpasLayout, offsets, multiDimCTAInRepId[0],
-                           multiDimCTAInRepId[1]);
+      emitDpasOffsetForCTA(dpasLayout, offsets, multiDimCTAInRepId);
 
-      SmallVector<Value> multiDimOffset = {
-          add(multiDimBase[0], i32_val(offsets[elemId][0])),
-          add(multiDimBase[1], i32_val(offsets[elemId][1]))};
+      SmallVector<Value> multiDimOffset(rank);
+      for (unsigned d = 0; d < rank; ++d)
+        multiDimOffset[d] = add(multiDimBase[d], i32_val(offsets[elemId][d]));
       return multiDimOffset;
     }
     llvm_unreachable("unexpected layout in getMultiDimOffset");
@@ -550,6 +553,77 @@ private:
     return success();
   }
 
+  // Mirrors getWarpLocalSrcLane.
+  Value emitWarpLocalSrcLane(Location loc, ConversionPatternRewriter &rewriter,
+                             Attribute srcLayout,
+                             SmallVector<Value> coord) const {
+    if (auto sliceLayout = srcLayout.dyn_cast<SliceEncodingAttr>()) {
+      coord.insert(coord.begin() + sliceLayout.getDim(), i32_val(0));
+      return emitWarpLocalSrcLane(loc, rewriter, sliceLayout.getParent(),
+                                  coord);
+    }
+    auto blockedLayout = srcLayout.cast<BlockedEncodingAttr>();
+    auto sizePerThread = blockedLayout.getSizePerThread();
+    auto threadsPerWarp = blockedLayout.getThreadsPerWarp();
+    SmallVector<Value> multiDimLaneId(coord.size());
+    for (unsigned k = 0; k < coord.size(); ++k)
+      multiDimLaneId[k] = urem(udiv(coord[k], i32_val(sizePerThread[k])),
+                               i32_val(threadsPerWarp[k]));
+    return linearize(rewriter, loc, multiDimLaneId, threadsPerWarp,
+                     blockedLayout.getOrder());
+  }
+
+  // blocked/slice -> blocked/slice within the warps.
+  // The elements are exchanged between the lanes of the warps with shuffles,
+  // without shared memory nor barriers.
+  LogicalResult
+  lowerDistributedToDistributedInWarp(triton::gpu::ConvertLayoutOp op,
+                                      OpAdaptor adaptor,
+                                      ConversionPatternRewriter &rewriter,
+                                      const WarpLocalCvtLayout &cvt) const {
+    auto loc = op.getLoc();
+    auto srcTy = op.getSrc().getType().cast<RankedTensorType>();
+    auto dstTy = op.getResult().getType().cast<RankedTensorType>();
+    Attribute srcLayout = srcTy.getEncoding();
+    Attribute dstLayout = dstTy.getEncoding();
+    auto shape = dstTy.getShape();
+    unsigned rank = dstTy.getRank();
+    auto dstShapePerCTATile = getShapePerCTATile(dstLayout, shape);
+
+    auto vals =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    auto dstIndices =
+        emitIndices(loc, rewriter, dstLayout, dstTy, /*withCTAOffset=*/false);
+    SmallVector<Value> outVals(cvt.srcRegs.size());
+    for (unsigned i = 0; i < outVals.size(); ++i) {
+      Value val = vals[cvt.srcRegs[i]];
+      if (cvt.sameLane[i]) {
+        outVals[i] = val;
+        continue;
+      }
+      SmallVector<Value> coord = dstIndices[i];
+      for (unsigned d = 0; d < rank; ++d)
+        if (dstShapePerCTATile[d] > shape[d])
+          coord[d] = urem(coord[d], i32_val(shape[d]));
+      Value srcLane = emitWarpLocalSrcLane(loc, rewriter, srcLayout, coord);
+      Type valTy = val.getType();
+      if (valTy.isInteger(1))
+        val = zext(i32_ty, val);
+      else if (valTy.isa<LLVM::LLVMPointerType>())
+        val = ptrtoint(i64_ty, val);
+      Value result = shflIdxSync(loc, rewriter, val, srcLane, target);
+      if (valTy.isInteger(1))
+        result = icmp_ne(result, i32_val(0));
+      else if (valTy.isa<LLVM::LLVMPointerType>())
+        result = inttoptr(valTy, result);
+      outVals[i] = result;
+    }
+    Value result =
+        getTypeConverter()->packLLElements(loc, outVals, rewriter, dstTy);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+
   // blocked/mma -> blocked/mma.
   // Data padding in shared memory to avoid bank conflict.
   LogicalResult
@@ -566,6 +640,8 @@ private:
 
     if (shouldUseDistSmem(srcLayout, dstLayout))
       return lowerDistToDistWithDistSmem(op, adaptor, rewriter);
+    if (auto cvt = getWarpLocalCvtLayout(srcTy, dstTy))
+      return lowerDistributedToDistributedInWarp(op, adaptor, rewriter, *cvt);
     Value smemBase =
         LLVM::getSharedMemoryBase(loc, rewriter, op.getOperation(), target);
     auto elemPtrTy = ptr_ty(rewriter.getContext(), 3);
@@ -867,7 +943,7 @@ private:
     auto srcShape = srcTy.getShape();
     auto dstTy = dst.getType().cast<RankedTensorType>();
     auto dstShapePerCTA = triton::gpu::getShapePerCTA(dstTy);
-    assert(srcShape.size() == 2 &&
+    assert((srcShape.size() == 2 || srcShape.size() == 3) &&
            "Unexpected rank of ConvertLayout(blocked->shared)");
     auto srcLayout = srcTy.getEncoding();
     auto dstSharedLayout = dstTy.getEncoding().cast<SharedEncodingAttr>();
@@ -1014,6 +1090,40 @@ private:
     return failure();
   }
 
+  // dpas -> dot_operand
+  LogicalResult
+  lowerDpasToDotOperand(triton::gpu::ConvertLayoutOp op, OpAdaptor adaptor,
+                        ConversionPatternRewriter &rewriter) const {
+    auto loc = op.getLoc();
+    auto srcTy = op.getSrc().getType().cast<RankedTensorType>();
+    auto dstTy = op.getResult().getType().cast<RankedTensorType>();
+    if (!isDpasToDotShortcut(srcTy, dstTy))
+      return failure();
+
+    // Each lane holds `repeatCount` rows of one column of an accumulator tile,
+    // which is exactly its share of the A operand tile covering the same
+    // elements. Pack every tile into the vector consumed by the DPAS
+    // instruction; no data has to move between lanes.
+    auto dpasLayout = srcTy.getEncoding().cast<DpasEncodingAttr>();
+    auto vals =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    Type elemTy = getTypeConverter()->convertType(srcTy.getElementType());
+    unsigned vecSize = dpasLayout.getRepeatCount();
+    Type vecTy = vec_ty(elemTy, vecSize);
+    SmallVector<Value> vecVals;
+    for (unsigned i = 0; i < vals.size(); i += vecSize) {
+      Value packed = rewriter.create<LLVM::UndefOp>(loc, vecTy);
+      for (unsigned j = 0; j < vecSize; j++)
+        packed = insert_element(vecTy, packed, vals[i + j], i32_val(j));
+      vecVals.push_back(packed);
+    }
+
+    Value view =
+        getTypeConverter()->packLLElements(loc, vecVals, rewriter, dstTy);
+    rewriter.replaceOp(op, view);
+    return success();
+  }
+
   // mma -> mma
   LogicalResult lowerMmaToMma(triton::gpu::ConvertLayoutOp op,
                               OpAdaptor adaptor,
@@ -16,16 +16,11 @@ public:
                    SmallVector<int64_t> instrShape,
                    ConversionPatternRewriter &rewriter,
                    TritonGPUToLLVMTypeConverter *typeConverter, Location loc)
-      : dpasLayout(dpasLayout), tensorTy(tensorTy), smemStrides(smemStrides),
-        rewriter(rewriter), loc(loc) {
+      : dpasLayout(dpasLayout), tensorTy(tensorTy), warpsPerTile(warpsPerTile),
+        smemStrides(smemStrides), instrShape(instrShape), rewriter(rewriter),
+        loc(loc) {
     static_assert(opIdx == 0 || opIdx == 1);
 
-    unsigned kDim = (opIdx == 0) ? 1 : 0;
-    repKDimStride = mul(i32_val(instrShape[kDim]), smemStrides[kDim]);
-    repNonKDimStride = mul(i32_val(instrShape[kDim ^ 1] * warpsPerTile),
-                           smemStrides[kDim ^ 1]);
-    warpMatStride = mul(i32_val(instrShape[kDim ^ 1]), smemStrides[kDim ^ 1]);
-
     unsigned opsPerChannel =
         dpasLayout.getOpsPerChannel(tensorTy.getElementType());
     unsigned threadsPerWarp = getThreadsPerWarp();
@@ -36,35 +31,36 @@ public:
     numPtrs = (dpasLayout.getRepeatCount() / rowsPerWarp) * opsPerChannel;
   }
 
-  SmallVector<Value> computeOffsets(Value warpId, Value laneId,
-                                    Value cSwizzleOffset) {
-    return computeLdsMatOffs(warpId, laneId, cSwizzleOffset);
-  }
-
   int getNumPtrs() const { return numPtrs; }
 
-  // Compute matrix load offsets.
-  SmallVector<Value> computeLdsMatOffs(Value warpOff, Value lane,
-                                       Value cSwizzleOffset);
+  // Compute the coordinates of the elements loaded by the lane within the
+  // matrix of the warp.
+  SmallVector<std::pair<Value, Value>> computeLdsMatCoords(Value warpId,
+                                                           Value laneId);
   // Load the matrix value.
-  Value loadMatrix(int repOuter, int repInner, const ArrayRef<Value> ptrs,
+  Value loadMatrix(int repOuter, int repInner,
+                   ArrayRef<std::pair<Value, Value>> coords, Value smemBase,
                    LLVM::LLVMStructType structTy, Type smemTy,
-                   Value cSwizzleOffset) const;
+                   ArrayRef<unsigned> order, Value cSwizzleOffset,
+                   Value outerSliceOffset) const;
 
 private:
   unsigned getThreadsPerWarp() const {
     return product<unsigned>(triton::gpu::getThreadsPerWarp(dpasLayout));
   }
 
+  // Compute the offset of the element at (row, col) in the shared memory,
+  // swizzled as the shared layout is.
+  Value computeSwizzledOffset(Value row, Value col, ArrayRef<unsigned> order,
+                              Value cSwizzleOffset,
+                              Value outerSliceOffset) const;
+
   DpasEncodingAttr dpasLayout;
   RankedTensorType tensorTy;
+  unsigned warpsPerTile;
 
   SmallVector<Value> smemStrides;
-  Value repNonKDimStride;
-  Value repKDimStride;
-
-  // Stride in number of matrices to increment on non-k dim across warps
-  Value warpMatStride;
+  SmallVector<int64_t> instrShape;
   int numPtrs;
 
   ConversionPatternRewriter &rewriter;
@@ -72,10 +68,9 @@ private:
 };
 
 template <unsigned opIdx>
-SmallVector<Value>
-DpasMatmulLoader<opIdx>::computeLdsMatOffs(Value warpId, Value laneId,
-                                           Value cSwizzleOffset) {
-  SmallVector<Value> offs(numPtrs);
+SmallVector<std::pair<Value, Value>>
+DpasMatmulLoader<opIdx>::computeLdsMatCoords(Value warpId, Value laneId) {
+  SmallVector<std::pair<Value, Value>> coords(numPtrs);
 
   unsigned systolicDepth = dpasLayout.getSystolicDepth();
   unsigned repeatCount = dpasLayout.getRepeatCount();
@@ -93,6 +88,8 @@ DpasMatmulLoader<opIdx>::computeLdsMatOffs(Value warpId, Value laneId,
     laneRowIndex = udiv(laneId, i32_val(systolicDepth));
     laneColIndex = urem(laneId, i32_val(systolicDepth));
     laneColIndex = mul(laneColIndex, i32_val(opsPerChannel));
+    // The warps are distributed along the rows.
+    laneRowIndex = add(laneRowIndex, mul(warpId, i32_val(instrShape[0])));
   } break;
   case 1: {
     rowsPerWarp = threadsPerWarp / executionSize;
@@ -101,78 +98,89 @@ DpasMatmulLoader<opIdx>::computeLdsMatOffs(Value warpId, Value laneId,
     laneRowIndex = udiv(laneId, i32_val(executionSize));
     laneRowIndex = mul(laneRowIndex, i32_val(opsPerChannel));
     laneColIndex = urem(laneId, i32_val(executionSize));
+    // The warps are distributed along the columns.
+    laneColIndex = add(laneColIndex, mul(warpId, i32_val(instrShape[1])));
   } break;
   }
 
-  // outer index offset
-  Value iOff = mul(warpId, warpMatStride);
-
-  SharedEncodingAttr sharedLayout =
-      tensorTy.getEncoding().cast<SharedEncodingAttr>();
-  const int perPhase = sharedLayout.getPerPhase();
-  const int maxPhase = sharedLayout.getMaxPhase();
-  const int vec = sharedLayout.getVec();
-
   unsigned index = 0;
   Value rowsPerWarpVal = i32_val(rowsPerWarp);
-  Value zeroVal = i32_val(0);
-  Value perPhaseVal = i32_val(perPhase);
-  Value maxPhaseVal = i32_val(maxPhase);
-  Value vecVal = i32_val(vec);
-
   for (int rep = 0; rep < repRowsPerInst; ++rep) {
     Value repRowIndex = mul(i32_val(rep), rowsPerWarpVal);
     for (unsigned opsIdx = 0; opsIdx < opsPerChannel; ++opsIdx) {
-      // inner index base
-      Value jBase = laneColIndex;
-      // outer index base
-      Value iBase = add(repRowIndex, laneRowIndex);
+      Value row = add(repRowIndex, laneRowIndex);
+      Value col = laneColIndex;
       switch (opIdx) {
       case 0:
-        jBase = add(jBase, i32_val(opsIdx));
+        col = add(col, i32_val(opsIdx));
         break;
       case 1:
-        iBase = add(iBase, i32_val(opsIdx));
+        row = add(row, i32_val(opsIdx));
         break;
       }
+      coords[index++] = {row, col};
+    }
+  }
 
-      // inner index offset
-      Value jOff = zeroVal;
-      // swizzle: col_swizzled = (col / vec) ^ phase * vec
-      Value phase = urem(udiv(iBase, perPhaseVal), maxPhaseVal);
-      jOff = add(jOff, udiv(cSwizzleOffset, vecVal));
-      jOff = mul(xor_(jOff, phase), vecVal);
+  return coords;
+}
 
-      Value i = add(mul(iBase, smemStrides[0]), iOff);
-      Value j = add(mul(jBase, smemStrides[1]), jOff);
+template <unsigned opIdx>
+Value DpasMatmulLoader<opIdx>::computeSwizzledOffset(
+    Value row, Value col, ArrayRef<unsigned> order, Value cSwizzleOffset,
+    Value outerSliceOffset) const {
+  SmallVector<Value> idx = {row, col};
+  unsigned inner = order[0];
+  unsigned outer = order[1];
+  // The swizzling applies to the coordinates within the original tensor, the
+  // slice starts at `cSwizzleOffset` along the contiguous dimension.
+  idx[inner] = add(idx[inner], cSwizzleOffset);
 
-      offs[index++] = add(i, j);
-    }
+  SharedEncodingAttr sharedLayout =
+      tensorTy.getEncoding().cast<SharedEncodingAttr>();
+  const int perPhase = sharedLayout.getPerPhase();
+  const int maxPhase = sharedLayout.getMaxPhase();
+  const int vec = sharedLayout.getVec();
+  if (maxPhase > 1) {
+    // swizzle: col_swizzled = ((col / vec) ^ phase) * vec + col % vec
+    Value vecVal = i32_val(vec);
+    Value outerIdx = add(idx[outer], outerSliceOffset);
+    Value phase = urem(udiv(outerIdx, i32_val(perPhase)), i32_val(maxPhase));
+    idx[inner] = add(mul(xor_(udiv(idx[inner], vecVal), phase), vecVal),
+                     urem(idx[inner], vecVal));
   }
 
-  return offs;
+  return add(mul(idx[0], smemStrides[0]), mul(idx[1], smemStrides[1]));
 }
 
 template <unsigned opIdx>
-Value DpasMatmulLoader<opIdx>::loadMatrix(int repOuter, int repInner,
-                                          const ArrayRef<Value> ptrs,
-                                          LLVM::LLVMStructType structTy,
-                                          Type smemTy,
-                                          Value cSwizzleOffset) const {
+Value DpasMatmulLoader<opIdx>::loadMatrix(
+    int repOuter, int repInner, ArrayRef<std::pair<Value, Value>> coords,
+    Value smemBase, LLVM::LLVMStructType structTy, Type smemTy,
+    ArrayRef<unsigned> order, Value cSwizzleOffset,
+    Value outerSliceOffset) const {
   Type elemTy = structTy.getBody()[0];
   assert(
       llvm::any_of(structTy.getBody(), [&](Type ty) { return ty == elemTy; }) &&
       "The struct should have the same element types.");
 
-  Value offsetOuter = mul(i32_val(repOuter), repNonKDimStride);
-  Value offsetInner = mul(i32_val(repInner), repKDimStride);
-  Value offset = add(offsetOuter, offsetInner);
+  // The offsets of the repetition along the rows and the columns.
+  unsigned kDim = (opIdx == 0) ? 1 : 0;
+  SmallVector<int64_t> repOffsets(2);
+  repOffsets[kDim] = repInner * instrShape[kDim];
+  repOffsets[kDim ^ 1] = repOuter * instrShape[kDim ^ 1] * warpsPerTile;
+  Value rowOffset = i32_val(repOffsets[0]);
+  Value colOffset = i32_val(repOffsets[1]);
 
   Value llvmStruct = rewriter.create<LLVM::UndefOp>(loc, structTy);
   size_t elemNum = structTy.getBody().size();
   for (int i = 0; i < elemNum; i++) {
+    auto [row, col] = coords[i];
+    Value offset =
+        computeSwizzledOffset(add(row, rowOffset), add(col, colOffset), order,
+                              cSwizzleOffset, outerSliceOffset);
     Value readPtr =
-        gep(ptr_ty(rewriter.getContext(), 3), smemTy, ptrs[i], offset);
+        gep(ptr_ty(rewriter.getContext(), 3), smemTy, smemBase, offset);
     Value val = rewriter.create<LLVM::LoadOp>(loc, elemTy, readPtr);
     llvmStruct = insert_val(structTy, llvmStruct, val, i);
   }
@@ -180,11 +188,10 @@ Value DpasMatmulLoader<opIdx>::loadMatrix(int repOuter, int repInner,
   return llvmStruct;
 }
 
-Value composeValuesToDotOperandLayoutStruct(
-    const ValueTable &vals, int n0, int n1,
-    TritonGPUToLLVMTypeConverter *typeConverter, Location loc,
-    ConversionPatternRewriter &rewriter) {
-  std::vector<Value> elems;
+void appendValuesOfDotOperandLayout(const ValueTable &vals, int n0, int n1,
+                                    std::vector<Value> &elems,
+                                    Location loc,
+                                    ConversionPatternRewriter &rewriter) {
   for (int m = 0; m < n0; ++m) {
     for (int k = 0; k < n1; ++k) {
       Value matVal = vals.at({m, k});
@@ -196,6 +203,11 @@ Value composeValuesToDotOperandLayoutStruct(
       }
     }
   }
+}
+
+Value composeValuesToDotOperandLayoutStruct(
+    ArrayRef<Value> elems, TritonGPUToLLVMTypeConverter *typeConverter,
+    Location loc, ConversionPatternRewriter &rewriter) {
   assert(!elems.empty() && "Expecting non-empty vector");
 
   Type elemTy = elems[0].getType();
@@ -222,7 +234,7 @@ Type getSharedMemTy(Type argType) {
 
 template <unsigned opIdx>
 std::function<void(int, int)>
-getLoadMatrixFn(Value tensor, const SharedMemoryObject &smemObj,
+getLoadMatrixFn(RankedTensorType tensorTy, const SharedMemoryObject &smemObj,
                 DpasEncodingAttr dpasLayout, unsigned warpsPerTile,
                 SmallVector<int64_t> instrShape, Value warpId,
                 Value outerWarpDim, Value laneId, ValueTable &vals,
@@ -230,7 +242,6 @@ getLoadMatrixFn(Value tensor, const SharedMemoryObject &smemObj,
                 ConversionPatternRewriter &rewriter, Location loc) {
   static_assert(opIdx == 0 || opIdx == 1);
 
-  auto tensorTy = tensor.getType().cast<RankedTensorType>();
   Type eltTy = tensorTy.getElementType();
 
   auto sharedLayout = tensorTy.getEncoding().cast<SharedEncodingAttr>();
@@ -242,20 +253,14 @@ getLoadMatrixFn(Value tensor, const SharedMemoryObject &smemObj,
                                    smemObj.strides, instrShape, rewriter,
                                    typeConverter, loc);
 
-    // Offset of a slice within the original tensor in shared memory.
+    // Offsets of a slice within the original tensor in shared memory.
     Value cSwizzleOffset = smemObj.getCSwizzleOffset(order[0]);
-    SmallVector<Value> offs =
-        loader.computeOffsets(outerWarpDim, laneId, cSwizzleOffset);
-
-    // Initialize pointers.
-    const int numPtrs = loader.getNumPtrs();
-    SmallVector<Value> ptrs(numPtrs);
+    Value outerSliceOffset = smemObj.getCSwizzleOffset(order[1]);
+    SmallVector<std::pair<Value, Value>> coords =
+        loader.computeLdsMatCoords(outerWarpDim, laneId);
 
     Value smemBase = smemObj.getBaseBeforeSlice(order[0], loc, rewriter);
     Type smemTy = getSharedMemTy(eltTy);
-    for (int i = 0; i < numPtrs; ++i)
-      ptrs[i] =
-          gep(ptr_ty(rewriter.getContext(), 3), smemTy, smemBase, offs[i]);
 
     // Load from shared memory.
     int64_t totalElem = product<int64_t>(instrShape);
@@ -264,23 +269,27 @@ getLoadMatrixFn(Value tensor, const SharedMemoryObject &smemObj,
         eltTy.getContext(),
         SmallVector<Type>(totalElem / threadsPerWarp, eltTy));
 
-    vals[{a, b}] = loader.loadMatrix(a, b, ptrs, matTy, smemTy, cSwizzleOffset);
+    vals[{a, b}] = loader.loadMatrix(a, b, coords, smemBase, matTy, smemTy,
+                                     order, cSwizzleOffset, outerSliceOffset);
   };
 
   return load;
 }
 
+// Load the values of the thread for the matrix operand of type `tensorTy`,
+// appended to `elems`.
 template <unsigned opIdx>
-Value loadOperand(ConversionPatternRewriter &rewriter, Location loc,
-                  Value threadId, DotOperandEncodingAttr encoding,
-                  TritonGPUToLLVMTypeConverter *typeConverter, Value tensor,
-                  const SharedMemoryObject &smemObj) {
+void loadMatrixOperand(ConversionPatternRewriter &rewriter, Location loc,
+                       Value threadId, DotOperandEncodingAttr encoding,
+                       TritonGPUToLLVMTypeConverter *typeConverter,
+                       RankedTensorType tensorTy,
+                       const SharedMemoryObject &smemObj,
+                       std::vector<Value> &elems) {
   static_assert(opIdx == 0 || opIdx == 1);
 
   auto dpasLayout = encoding.getParent().cast<DpasEncodingAttr>();
   const SmallVector<unsigned> warpsPerCTA = dpasLayout.getWarpsPerCTA();
 
-  auto tensorTy = tensor.getType().cast<RankedTensorType>();
   const ArrayRef<int64_t> tensorShape = tensorTy.getShape();
   auto sharedLayout = tensorTy.getEncoding().cast<SharedEncodingAttr>();
   const ArrayRef<unsigned> order = sharedLayout.getOrder();
@@ -305,7 +314,7 @@ Value loadOperand(ConversionPatternRewriter &rewriter, Location loc,
   // Get the function to use to load the operand.
   ValueTable vals;
   std::function<void(int, int)> loadFn = getLoadMatrixFn<opIdx>(
-      tensor, smemObj, dpasLayout, warpsPerTile, elemsPerInstr, warpId,
+      tensorTy, smemObj, dpasLayout, warpsPerTile, elemsPerInstr, warpId,
       outerWarpDim, laneId, vals, typeConverter, rewriter, loc);
 
   // Load the operand.
@@ -316,9 +325,69 @@ Value loadOperand(ConversionPatternRewriter &rewriter, Location loc,
     for (int k = 0; k < numRepK; ++k)
       loadFn(m, k);
 
-  // Format the values into an LLVM::Struct.
-  return composeValuesToDotOperandLayoutStruct(vals, numRepOuter, numRepK,
-                                               typeConverter, loc, rewriter);
+  appendValuesOfDotOperandLayout(vals, numRepOuter, numRepK, elems, loc,
+                                 rewriter);
+}
+
+template <unsigned opIdx>
+Value loadOperand(ConversionPatternRewriter &rewriter, Location loc,
+                  Value threadId, DotOperandEncodingAttr encoding,
+                  TritonGPUToLLVMTypeConverter *typeConverter, Value tensor,
+                  const SharedMemoryObject &smemObj) {
+  auto tensorTy = tensor.getType().cast<RankedTensorType>();
+  std::vector<Value> elems;
+  if (tensorTy.getRank() == 2) {
+    loadMatrixOperand<opIdx>(rewriter, loc, threadId, encoding, typeConverter,
+                             tensorTy, smemObj, elems);
+    // Format the values into an LLVM::Struct.
+    return composeValuesToDotOperandLayoutStruct(elems, typeConverter, loc,
+                                                 rewriter);
+  }
+
+  // The matrices of a batched operand are loaded one after the other, as
+  // operands of the DPAS layout of a single matrix, by the warps holding them.
+  MLIRContext *ctx = tensorTy.getContext();
+  auto dpasLayout = encoding.getParent().cast<DpasEncodingAttr>();
+  SmallVector<unsigned> warpsPerCTA = dpasLayout.getWarpsPerCTA();
+  auto sharedLayout = tensorTy.getEncoding().cast<SharedEncodingAttr>();
+  ArrayRef<unsigned> order = sharedLayout.getOrder();
+  assert(order[2] == 0 && "Expecting the batch dimension to be the outermost");
+  auto matrixCTALayout = triton::gpu::CTALayoutAttr::get(
+      ctx, /*CTAsPerCGA=*/{1, 1}, /*CTASplitNum=*/{1, 1}, /*CTAOrder=*/{1, 0});
+  auto matrixDpasLayout = DpasEncodingAttr::get(
+      ctx, dpasLayout.getRepeatCount(), {warpsPerCTA[1], warpsPerCTA[2]},
+      matrixCTALayout);
+  auto matrixEncoding = DotOperandEncodingAttr::get(
+      ctx, opIdx, matrixDpasLayout, encoding.getKWidth());
+  auto matrixSharedLayout = SharedEncodingAttr::get(
+      ctx, sharedLayout.getVec(), sharedLayout.getPerPhase(),
+      sharedLayout.getMaxPhase(), {order[0] - 1, order[1] - 1},
+      matrixCTALayout);
+  ArrayRef<int64_t> shape = tensorTy.getShape();
+  auto matrixTy = RankedTensorType::get(shape.drop_front(),
+                                        tensorTy.getElementType(),
+                                        matrixSharedLayout);
+
+  Value warpSize = i32_val(triton::gpu::getWarpSize(dpasLayout));
+  Value warpId = udiv(threadId, warpSize);
+  Value batchWarpId =
+      urem(udiv(warpId, i32_val(warpsPerCTA[1] * warpsPerCTA[2])),
+           i32_val(warpsPerCTA[0]));
+  int64_t numBatchReps = ceil<int64_t>(shape[0], warpsPerCTA[0]);
+  for (int64_t b = 0; b < numBatchReps; ++b) {
+    Value batchIdx =
+        urem(add(batchWarpId, i32_val(b * warpsPerCTA[0])), i32_val(shape[0]));
+    Value matrixBase = gep(smemObj.base.getType(), smemObj.baseElemType,
+                           smemObj.base, mul(batchIdx, smemObj.strides[0]));
+    SharedMemoryObject matrixObj(
+        matrixBase, smemObj.baseElemType,
+        ArrayRef<Value>(smemObj.strides).drop_front(),
+        ArrayRef<Value>(smemObj.offsets).drop_front());
+    loadMatrixOperand<opIdx>(rewriter, loc, threadId, matrixEncoding,
+                             typeConverter, matrixTy, matrixObj, elems);
+  }
+  return composeValuesToDotOperandLayoutStruct(elems, typeConverter, loc,
+                                               rewriter);
 }
 
 } // namespace
@@ -88,8 +88,8 @@ struct DecomposeUnsupportedConversions
       }
     });
     /* -------------------------------- */
-    // Replace `mma -> dot_op` with `mma -> blocked -> dot_op`
-    // unless certain conditions are met
+    // Replace `mma -> dot_op` and `dpas -> dot_op` with
+    // `mma/dpas -> blocked -> dot_op` unless certain conditions are met
     /* -------------------------------- */
     mod.walk([&](triton::gpu::ConvertLayoutOp cvtOp) -> void {
       OpBuilder builder(cvtOp);
@@ -97,14 +97,20 @@ struct DecomposeUnsupportedConversions
       auto dstType = cvtOp.getType().cast<RankedTensorType>();
       auto srcMma =
           srcType.getEncoding().dyn_cast<triton::gpu::NvidiaMmaEncodingAttr>();
+      auto srcDpas =
+          srcType.getEncoding().dyn_cast<triton::gpu::DpasEncodingAttr>();
       auto dstDotOp =
           dstType.getEncoding().dyn_cast<triton::gpu::DotOperandEncodingAttr>();
-      if (srcMma && dstDotOp && !isMmaToDotShortcut(srcType, dstType)) {
+      if (dstDotOp &&
+          ((srcMma && !isMmaToDotShortcut(srcType, dstType)) ||
+           (srcDpas && !isDpasToDotShortcut(srcType, dstType)))) {
+        Attribute srcLayout = srcType.getEncoding();
         auto tmpType = RankedTensorType::get(
             dstType.getShape(), dstType.getElementType(),
             triton::gpu::BlockedEncodingAttr::get(
-                mod.getContext(), srcType.getShape(), getSizePerThread(srcMma),
-                getOrder(srcMma), numWarps, threadsPerWarp, numCTAs));
+                mod.getContext(), srcType.getShape(),
+                getSizePerThread(srcLayout), getOrder(srcLayout), numWarps,
+                threadsPerWarp, numCTAs));
         auto tmp = builder.create<triton::gpu::ConvertLayoutOp>(
             cvtOp.getLoc(), tmpType, cvtOp.getOperand());
         addAttrs(tmp, cvtOp->getAttrs());
@@ -44,14 +44,20 @@ public:
         AEncoding.getDPASRep(ATensorTy.getShape(), ATensorTy.getElementType());
     auto repB =
         BEncoding.getDPASRep(BTensorTy.getShape(), BTensorTy.getElementType());
-    assert(repA[1] == repB[0] && "Unexpected rep for A and B operands");
+    size_t rank = repA.size();
+    assert(repA[rank - 1] == repB[rank - 2] &&
+           "Unexpected rep for A and B operands");
 
-    unsigned repM = repA[0], repN = repB[1], repK = repA[1];
+    // The batched dots multiply the matrices of the batch held by the warp
+    // one after the other.
+    unsigned repBatch = rank == 3 ? repA[0] : 1;
+    unsigned repM = repA[rank - 2], repN = repB[rank - 1],
+             repK = repA[rank - 1];
 
     ValueTable ha = getValuesFromDotOperandLayoutStruct(
-        loadedA, repM, repK, ATensorTy.getElementType());
+        loadedA, repBatch * repM, repK, ATensorTy.getElementType());
     ValueTable hb = getValuesFromDotOperandLayoutStruct(
-        loadedB, repN, repK, BTensorTy.getElementType());
+        loadedB, repBatch * repN, repK, BTensorTy.getElementType());
     Type resElemTy = DTensorTy.getElementType();
     SmallVector<Value> fc =
         typeConverter->unpackLLElements(loc, loadedC, rewriter);
@@ -60,6 +66,7 @@ public:
                         BPrecision = getElementPrecision(BTensorTy, resElemTy);
 
     LLVM_DEBUG({
+      llvm::dbgs() << "repBatch = " << repBatch << "\n";
       llvm::dbgs() << "repM = " << repM << "\n";
       llvm::dbgs() << "repK = " << repK << "\n";
       llvm::dbgs() << "repN = " << repN << "\n";
@@ -68,24 +75,33 @@ public:
 
     unsigned RC =
         AEncoding.getParent().cast<DpasEncodingAttr>().getRepeatCount();
+    auto mod = op->getParentOfType<ModuleOp>();
+    unsigned threadsPerWarp =
+        triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
     unsigned cNumElems = RC;
     auto CTy = vec_ty(resElemTy, cNumElems);
 
-    for (unsigned m = 0; m < repM; ++m) {
-      for (unsigned n = 0; n < repN; ++n) {
-        Value C = undef(CTy);
-        for (unsigned v = 0; v < cNumElems; ++v)
-          C = insert_element(
-              CTy, C, fc[m * repN * cNumElems + n * cNumElems + v], i32_val(v));
-
-        for (size_t k = 0; k < repK; k++) {
-          Value A = ha[{m, k}], B = hb[{n, k}];
-          C = generateDPASOp(C, A, B, RC, APrecision, BPrecision);
+    for (unsigned b = 0; b < repBatch; ++b) {
+      for (unsigned m = 0; m < repM; ++m) {
+        for (unsigned n = 0; n < repN; ++n) {
+          unsigned cOffset = ((b * repM + m) * repN + n) * cNumElems;
+          Value C = undef(CTy);
+          for (unsigned v = 0; v < cNumElems; ++v)
+            C = insert_element(CTy, C, fc[cOffset + v], i32_val(v));
+
+          for (size_t k = 0; k < repK; k++) {
+            Value A = ha[{b * repM + m, k}], B = hb[{b * repN + n, k}];
+            Value D = threadsPerWarp == 16
+                          ? generateMatrixMadCall(C, A, B, RC, APrecision,
+                                                  BPrecision)
+                          : Value();
+            C = D ? D
+                  : generateDPASOp(C, A, B, RC, APrecision, BPrecision);
+          }
+
+          for (unsigned v = 0; v < cNumElems; ++v)
+            fc[cOffset + v] = extract_element(resElemTy, C, i32_val(v));
         }
-
-        for (unsigned v = 0; v < cNumElems; ++v)
-          fc[m * repN * cNumElems + n * cNumElems + v] =
-              extract_element(resElemTy, C, i32_val(v));
       }
     }
 
@@ -123,7 +139,7 @@ private:
 
   /// Generate the GENX dialect dpas operation. Rules (for PVC):
   ///  - SD = 8
-  ///  - M = RC = 1,2,4,8 (we use 8)
+  ///  - M = RC = 1,2,4,8 (selected by the accelerate matmul pass)
   ///  - N = exec_size = SIMD_width = 16
   ///  - Size of A, B element type = {32,16,8}, for {tf32,bf16/f16,u8/i8}
   ///  - K=SD * num_packed_elems_in_Dword = {8,16,32}, for {tf32,bf16/f16,u8/i8}
@@ -142,7 +158,8 @@ private:
   Value generateDPASOp(Value C, Value A, Value B, unsigned RepeatCount,
                        GENX::PrecisionType APrecision,
                        GENX::PrecisionType BPrecision) const {
-    assert(RepeatCount == 8 && "RepeatCount should be 8");
+    assert(llvm::is_contained({1u, 2u, 4u, 8u}, RepeatCount) &&
+           "RepeatCount should be 1, 2, 4 or 8");
     assert(APrecision == BPrecision &&
            "A and B precision enumerators do not match");
 
@@ -162,6 +179,96 @@ private:
     return rewriter.create<GENX::MatrixDPASOp>(loc, resTy, C, A, B, pA, pB, RC);
   }
 
+  /// Return the name of the `cl_intel_subgroup_matrix_multiply_accumulate`
+  /// builtin computing a DPAS of the given precisions, e.g.
+  /// `intel_sub_group_f16_f16_matrix_mad_k16`, or an empty string if there is
+  /// none.
+  static std::string getMatrixMadName(GENX::PrecisionType APrecision,
+                                      GENX::PrecisionType BPrecision) {
+    auto getName = [](GENX::PrecisionType PT) -> std::string {
+      switch (PT) {
+      case GENX::PrecisionType::FP16:
+        return "f16";
+      case GENX::PrecisionType::BF16:
+        return "bf16";
+      case GENX::PrecisionType::U8:
+        return "u8";
+      case GENX::PrecisionType::S8:
+        return "i8";
+      default:
+        return "";
+      }
+    };
+    std::string AName = getName(APrecision), BName = getName(BPrecision);
+    if (AName.empty() || BName.empty())
+      return "";
+    unsigned K = AName.back() == '8' ? 32 : 16;
+    return "intel_sub_group_" + AName + "_" + BName + "_matrix_mad_k" +
+           std::to_string(K);
+  }
+
+  /// Return the Itanium mangling of the OpenCL type `type`, a scalar or a
+  /// vector of scalars.
+  static std::string getMangledTypeName(Type type) {
+    if (auto vecTy = dyn_cast<VectorType>(type))
+      return "Dv" + std::to_string(vecTy.getNumElements()) + "_" +
+             getMangledTypeName(vecTy.getElementType());
+    if (type.isF32())
+      return "f";
+    return type.getIntOrFloatBitWidth() == 16 ? "s" : "i";
+  }
+
+  /// Return `type` with `numElems` elements, a scalar for a single one.
+  static Type getVectorOrScalarType(Type elemTy, unsigned numElems) {
+    return numElems == 1 ? elemTy : VectorType::get(numElems, elemTy);
+  }
+
+  /// Generate a call to the OpenCL builtin computing the DPAS on devices with
+  /// sub-groups of 16 work-items, e.g.
+  ///
+  ///    float8 intel_sub_group_f16_f16_matrix_mad_k16(short8 a, int8 b,
+  ///                                                  float8 acc);
+  ///
+  /// IGC handles these as first class DPAS operations, which it schedules
+  /// and combines better than the `genx.matrix.dpas` intrinsics. Return a
+  /// null value if there is no builtin for the operands.
+  Value generateMatrixMadCall(Value C, Value A, Value B, unsigned RepeatCount,
+                              GENX::PrecisionType APrecision,
+                              GENX::PrecisionType BPrecision) const {
+    std::string name = getMatrixMadName(APrecision, BPrecision);
+    if (name.empty())
+      return Value();
+
+    // Each work-item holds a 16-bit word of A per row, 8 dwords of B and an
+    // element of C per row.
+    auto bitsOf = [](Type type) {
+      auto vecTy = cast<VectorType>(type);
+      return vecTy.getNumElements() *
+             vecTy.getElementType().getIntOrFloatBitWidth();
+    };
+    auto CTy = cast<VectorType>(C.getType());
+    if (bitsOf(A.getType()) != RepeatCount * 16 ||
+        bitsOf(B.getType()) != 8 * 32 ||
+        CTy.getNumElements() != RepeatCount)
+      return Value();
+
+    Type ATy = getVectorOrScalarType(i16_ty, RepeatCount);
+    Type BTy = vec_ty(i32_ty, 8);
+    Type accTy = getVectorOrScalarType(CTy.getElementType(), RepeatCount);
+    std::string funcName = "_Z" + std::to_string(name.size()) + name +
+                           getMangledTypeName(ATy) + getMangledTypeName(BTy) +
+                           getMangledTypeName(accTy);
+
+    Value acc = RepeatCount == 1
+                    ? extract_element(CTy.getElementType(), C, i32_val(0))
+                    : C;
+    Value D = LLVM::createSPIRVBuiltinCall(
+        loc, rewriter, funcName, accTy,
+        ValueRange{bitcast(A, ATy), bitcast(B, BTy), acc});
+    return RepeatCount == 1 ? insert_element(CTy, undef(CTy), D, i32_val(0))
+                            : D;
+  }
+
   ValueTable getValuesFromDotOperandLayoutStruct(Value val, int64_t dim0,
                                                  int64_t dim1,
                                                  Type elemTy) const {
@@ -190,9 +297,8 @@ private:
       if (width == 32)
         return GENX::PrecisionType::TF32;
       if (width == 16)
-        return isa<FloatType>(elemType)
-                   ? GENX::PrecisionType::FP16
-                   : GENX::PrecisionType::BF16; // bf is passed as i16.
+        return elemType.isF16() ? GENX::PrecisionType::FP16
+                                : GENX::PrecisionType::BF16;
     } else if (width == 8) {
       return elemType.isUnsignedInteger() ? GENX::PrecisionType::U8
                                           : GENX::PrecisionType::S8;
@@ -232,8 +338,7 @@ LogicalResult convertDPAS(triton::DotOp op, triton::DotOp::Adaptor adaptor,
   assert(CTensorTy.getEncoding().isa<DpasEncodingAttr>() &&
          DTensorTy.getEncoding().isa<DpasEncodingAttr>() &&
          "Currently, we only support $c and $d with a dpas layout.");
-  assert(CTensorTy.getShape()[0] == DTensorTy.getShape()[0] &&
-         CTensorTy.getShape()[1] == DTensorTy.getShape()[1] &&
+  assert(CTensorTy.getShape() == DTensorTy.getShape() &&
          "DotOp's $c operand should pass the same number of values as $d");
 
   auto dpasLayout = op.getResult()
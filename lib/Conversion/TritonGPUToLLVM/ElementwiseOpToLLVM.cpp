@@ -1,8 +1,11 @@
 #include "PatternTritonGPUOpToLLVM.h"
 #include "mlir/Dialect/LLVMIR/GENXDialect.h"
+#include "triton/Conversion/TritonGPUToLLVM/VISAAsmFormat.h"
 
 using namespace mlir;
 using namespace mlir::triton;
+using ::mlir::LLVM::createSPIRVBuiltinCall;
+using ::mlir::LLVM::getDedupIndices;
 using ::mlir::triton::gpu::getTotalElemsPerThread;
 
 static SmallVector<Value> identity_func(Location loc,
@@ -718,6 +721,38 @@ static const Fp8ConversionDesc Fp8E4M3Nv_to_Fp16 = {
     "}",
     16, 32, 2};
 
+// Fp8E4M3 -> Fp16 (packed), without the table lookup of the subnormals:
+// the exponent and significand are moved into the f16 ones and rescaled by
+// 2^(15-7) with a f16 multiply, which is exact for the subnormals too.
+static SmallVector<Value>
+Fp8E4M3Nv_to_Fp16_scaled_func(Location loc,
+                              ConversionPatternRewriter &rewriter,
+                              const SmallVector<Value> &v) {
+  auto fp8x4VecTy = vec_ty(i8_ty, 4);
+  Value a0 = undef(fp8x4VecTy);
+  a0 = insert_element(fp8x4VecTy, a0, int_val(8, 0), i32_val(0));
+  a0 = insert_element(fp8x4VecTy, a0, v[0], i32_val(1));
+  a0 = insert_element(fp8x4VecTy, a0, int_val(8, 0), i32_val(2));
+  a0 = insert_element(fp8x4VecTy, a0, v[1], i32_val(3));
+  a0 = bitcast(a0, i32_ty);
+
+  Value b0 = and_(i32_ty, a0, i32_val(0x7fff7fff));
+  b0 = lshr(i32_ty, b0, i32_val(1));
+
+  auto fp16x2VecTy = vec_ty(f16_ty, 2);
+  Value scale = undef(fp16x2VecTy);
+  scale = insert_element(fp16x2VecTy, scale, f16_val(256.0), i32_val(0));
+  scale = insert_element(fp16x2VecTy, scale, f16_val(256.0), i32_val(1));
+  Value c0 = fmul(bitcast(b0, fp16x2VecTy), scale);
+
+  Value sign0 = and_(i32_ty, a0, i32_val(0x80008000));
+  Value fp16x2Vec0 = or_(i32_ty, sign0, bitcast(c0, i32_ty));
+  fp16x2Vec0 = bitcast(fp16x2Vec0, fp16x2VecTy);
+
+  return {extract_element(f16_ty, fp16x2Vec0, i32_val(0)),
+          extract_element(f16_ty, fp16x2Vec0, i32_val(1))};
+}
+
 // Fp16 -> Fp8E4M3 (packed)
 static SmallVector<Value>
 Fp16_to_Fp8E4M3Nv_func(Location loc, ConversionPatternRewriter &rewriter,
@@ -1275,90 +1310,19 @@ public:
     if (!rtType)
       // the result must be a tensor
       return resultVals;
-    Attribute encoding = rtType.getEncoding();
-    if (!encoding)
-      // encoding not available
-      return resultVals;
-    if (!encoding.dyn_cast<triton::gpu::BlockedEncodingAttr>() &&
-        !encoding.dyn_cast<triton::gpu::SliceEncodingAttr>()) {
-      // TODO: constraining the ecndoing type here is necessary
-      // for avoiding crashes in the triton::gpu::getElemsPerThread
-      // call below happening in the test_core::test_fp8_dot_acc
-      return resultVals;
-    }
-
-    SmallVector<unsigned> elemsPerThread =
-        triton::gpu::getElemsPerThread(rtType);
-    int rank = elemsPerThread.size();
-    if (product<unsigned>(elemsPerThread) != resultVals.size())
-      return resultVals;
     AxisInfo *axisInfo = axisAnalysisPass.getAxisInfo(result);
     if (!axisInfo)
       // axis info (e.g., constancy) not available
       return resultVals;
-    SmallVector<unsigned> sizePerThread =
-        triton::gpu::getSizePerThread(encoding);
-    if (rank != sizePerThread.size())
-      return resultVals;
-
-    SmallVector<int64_t> constancy = axisInfo->getConstancy();
-    if (rank != constancy.size())
-      return resultVals;
-    bool hasConstancy = false;
-    for (int i = 0; i < rank; ++i) {
-      if (constancy[i] > sizePerThread[i]) {
-        if (constancy[i] % sizePerThread[i] != 0)
-          // constancy is not evenly covered by sizePerThread
-          return resultVals;
-        // can't move the values across different
-        // "sizePerThread"-sized blocks
-        constancy[i] = sizePerThread[i];
-      }
-      if (elemsPerThread[i] < 1 || constancy[i] < 1)
-        return resultVals;
-      if (!(elemsPerThread[i] % constancy[i] == 0 ||
-            constancy[i] % elemsPerThread[i] == 0))
-        // either the constancy along each dimension must fit
-        // into the elemsPerThread or the other way around
-        return resultVals;
-      if (constancy[i] > 1)
-        hasConstancy = true;
-    }
-    if (!hasConstancy)
-      // nothing to deduplicate
+    SmallVector<unsigned> dedupIndices =
+        getDedupIndices(rtType, axisInfo->getConstancy(), resultVals.size());
+    if (dedupIndices.empty())
       return resultVals;
 
-    if (rank > 1) {
-      // reorder the shape and constancy vectors by the axis order:
-      // from the fastest-changing to the smallest-changing axis
-      SmallVector<unsigned> order = triton::gpu::getOrder(encoding);
-      if (rank != order.size())
-        return resultVals;
-      ArrayRef<unsigned> orderRef(order);
-      elemsPerThread = reorder(ArrayRef<unsigned>(elemsPerThread), orderRef);
-      constancy = reorder(ArrayRef<int64_t>(constancy), orderRef);
-    }
-
-    SmallVector<unsigned> strides(rank, 1);
-    for (int i = 1; i < rank; ++i) {
-      strides[i] = strides[i - 1] * elemsPerThread[i - 1];
-    }
     SmallVector<Value> dedupResultVals;
     dedupResultVals.reserve(resultVals.size());
-    for (int i = 0; i < resultVals.size(); ++i) {
-      // each coordinate of the orig_idx is "coarsened" using the
-      // constancy along this dimension: the resulting dedup_idx
-      // points to the reused value in the original resultsVal
-      int orig_idx = i;
-      int dedup_idx = 0;
-      for (int j = 0; j < rank; ++j) {
-        int coord_j = orig_idx % elemsPerThread[j];
-        dedup_idx += (coord_j / constancy[j] * constancy[j]) * strides[j];
-        orig_idx /= elemsPerThread[j];
-      }
-      dedupResultVals.push_back(resultVals[dedup_idx]);
-    }
-
+    for (unsigned idx : dedupIndices)
+      dedupResultVals.push_back(resultVals[idx]);
     return dedupResultVals;
   }
 
@@ -1464,6 +1428,10 @@ struct FpToFpOpConversion
       cvt(res, operand);
       return builder.launch(rewriter, loc, f32_ty, false);
     } break;
+    case mlir::triton::Target::GENX:
+      return createSPIRVBuiltinCall(loc, rewriter,
+                                    "_Z27__spirv_ConvertBF16ToFINTELt", f32_ty,
+                                    bitcast(v, i16_ty));
     default:
       auto as_int16 = bitcast(v, i16_ty);
       auto as_int32 = zext(i32_ty, as_int16);
@@ -1516,6 +1484,13 @@ struct FpToFpOpConversion
       // the type converter
       return builder.launch(rewriter, loc, i16_ty, false);
     } break;
+    case mlir::triton::Target::GENX:
+      // The hardware conversion only rounds to nearest even.
+      if (rounding == RoundingMode::RTNE)
+        return createSPIRVBuiltinCall(loc, rewriter,
+                                      "_Z27__spirv_ConvertFToBF16INTELf",
+                                      i16_ty, v);
+      [[fallthrough]];
     default:
       auto as_uint32 = bitcast(v, i32_ty);
       auto check_exponent =
@@ -1660,6 +1635,49 @@ struct FpToFpOpConversion
                   convDesc.inVecWidthBits, convDesc.outVecWidthBits),
               convDesc.numElements};
     } break;
+    case mlir::triton::Target::GENX: {
+      // The hardware converts bf16 from and to f32 natively, so go through
+      // f16 and f32 rather than emulating bf16 in integer arithmetic. The fp8
+      // values are exactly representable in f16, f32 and bf16.
+      auto F16Ty = Float16Type::get(srcTy.getContext());
+      if (srcTy.isFloat8E4M3FNUZ() && dstTy.isF16())
+        return {Fp8E4M3Nv_to_Fp16_scaled_func, 2};
+      if (dstTy.isBF16() &&
+          (srcTy.isFloat8E5M2() || srcTy.isFloat8E4M3FNUZ() ||
+           srcTy.isFloat8E4M3B11FNUZ() || srcTy.isFloat8E4M3FN())) {
+        std::pair<ConverterT, size_t> toFp16 =
+            getConversionFunc(srcTy, F16Ty, roundingMode, target);
+        ConverterT cvtFunc = [toFp16 = toFp16.first](
+                                 Location loc,
+                                 ConversionPatternRewriter &rewriter,
+                                 const SmallVector<Value> &v) {
+          SmallVector<Value> ret = toFp16(loc, rewriter, v);
+          for (Value &val : ret)
+            val = convertFp32ToBf16(
+                loc, rewriter,
+                convertFp16ToFp32(loc, rewriter, val, Target::GENX),
+                RoundingMode::RTNE, Target::GENX);
+          return ret;
+        };
+        return {cvtFunc, toFp16.second};
+      }
+      if (srcTy.isBF16() && dstTy.isF16()) {
+        RoundingMode rounding = roundingMode.value_or(RoundingMode::RTNE);
+        ConverterT cvtFunc = [rounding](Location loc,
+                                        ConversionPatternRewriter &rewriter,
+                                        const SmallVector<Value> &v) {
+          SmallVector<Value> ret;
+          for (Value val : v) {
+            Value fp32 = convertBf16ToFp32(loc, rewriter, val, Target::GENX);
+            ret.push_back(convertFp32ToFp16(loc, rewriter, fp32, rounding,
+                                            Target::GENX));
+          }
+          return ret;
+        };
+        return {cvtFunc, 4};
+      }
+    }
+      [[fallthrough]];
     default: {
       if (srcTy.getTypeID() == dstTy.getTypeID())
         if (srcTy.getTypeID() == F8E4M3TyID || dstTy.getTypeID() == F8E4M3TyID)
@@ -1790,6 +1808,52 @@ Value EmitDualBF16ElementwiseOp(Location loc,
                                                undefRounding, target);
 }
 
+// On GENX, compute the f16 or bf16 (stored as i16) `elemTy` elements of a
+// thread of the binary op OP by vectors of up to 8 elements, returning no
+// value if the elements can't be grouped. The vectors are lowered to the packed
+// half-precision instructions, which LLVM doesn't form from the scalar ops
+// without the SLP vectorizer. bf16 is computed in f32, converted by vectors.
+template <typename OP>
+SmallVector<Value>
+EmitPackedHalfElementwiseOp(Location loc, ConversionPatternRewriter &rewriter,
+                            Type elemTy, MultipleOperandsRange operands) {
+  unsigned numElements = 0;
+  for (unsigned size : {8, 4, 2}) {
+    if (operands.size() % size == 0) {
+      numElements = size;
+      break;
+    }
+  }
+  if (numElements == 0)
+    return {};
+
+  bool isBF16 = !elemTy.isF16();
+  Type vecTy = vec_ty(elemTy, numElements);
+  Type f32VecTy = vec_ty(f32_ty, numElements);
+  std::string vecCode = "Dv" + std::to_string(numElements) + "_";
+  SmallVector<Value> vecOperands;
+  for (unsigned i = 0; i < 2; ++i) {
+    Value vec = undef(vecTy);
+    for (unsigned j = 0; j < numElements; ++j)
+      vec = insert_element(vecTy, vec, operands[j][i], i32_val(j));
+    if (isBF16)
+      vec = createSPIRVBuiltinCall(
+          loc, rewriter, "_Z27__spirv_ConvertBF16ToFINTEL" + vecCode + "t",
+          f32VecTy, vec);
+    vecOperands.push_back(vec);
+  }
+  Value result = rewriter.create<OP>(loc, isBF16 ? f32VecTy : vecTy,
+                                     vecOperands[0], vecOperands[1]);
+  if (isBF16)
+    result = createSPIRVBuiltinCall(
+        loc, rewriter, "_Z27__spirv_ConvertFToBF16INTEL" + vecCode + "f",
+        vecTy, result);
+  SmallVector<Value> results;
+  for (unsigned j = 0; j < numElements; ++j)
+    results.push_back(extract_element(elemTy, result, i32_val(j)));
+  return results;
+}
+
 struct CmpIOpConversion
     : public ElementwiseOpConversionBase<arith::CmpIOp, CmpIOpConversion> {
   using Base = ElementwiseOpConversionBase<arith::CmpIOp, CmpIOpConversion>;
@@ -1894,6 +1958,12 @@ struct ExternElementwiseOpConversion
     if (funcName.empty())
       llvm::errs() << "ExternElementwiseOpConversion";
 
+    if (Base::target == mlir::triton::Target::GENX)
+      if (std::optional<StringRef> builtin =
+              getOpenCLMathBuiltin(funcName, elemTy, operands[0]))
+        return createOpenCLMathCalls(rewriter, *builtin, elemTy, operands,
+                                     loc);
+
     Type funcType = getFunctionType(elemTy, operands[0]);
     LLVM::LLVMFuncOp funcOp =
         appendOrGetFuncOp(rewriter, op, funcName, funcType);
@@ -1906,6 +1976,90 @@ struct ExternElementwiseOpConversion
   }
 
 private:
+  // Return the OpenCL builtin computing the libsycl math function `funcName`
+  // of `operands`, e.g. exp for __imf_expf, if the builtin is overloaded for
+  // vectors of `elemTy`: the elements of the thread are then computed by the
+  // vector builtin, which the backend compiler inlines, instead of by calls of
+  // the scalar function of the library.
+  static std::optional<StringRef> getOpenCLMathBuiltin(StringRef funcName,
+                                                       Type elemTy,
+                                                       ValueRange operands) {
+    static constexpr StringLiteral functions[] = {
+        "acos",  "acosh", "asin",  "asinh",     "atan",   "atan2",  "atanh",
+        "cbrt",  "ceil",  "cos",   "cosh",      "cospi",  "erf",    "erfc",
+        "exp",   "exp10", "exp2",  "expm1",     "fdim",   "floor",  "fma",
+        "fmod",  "hypot", "log",   "log10",     "log1p",  "log2",   "pow",
+        "rint",  "round", "rsqrt", "remainder", "sin",    "sinh",   "sinpi",
+        "sqrt",  "tan",   "tanh",  "tgamma",    "lgamma", "trunc"};
+    if (!elemTy.isF32() && !elemTy.isF64())
+      return std::nullopt;
+    if (!llvm::all_of(operands.getTypes(),
+                      [&](Type type) { return type == elemTy; }))
+      return std::nullopt;
+    if (!funcName.consume_front("__imf_"))
+      return std::nullopt;
+    // The float functions are suffixed by `f`, the double ones aren't.
+    if (elemTy.isF32() && !funcName.consume_back("f"))
+      return std::nullopt;
+    for (StringRef function : functions)
+      if (funcName == function)
+        return function;
+    return std::nullopt;
+  }
+
+  // Compute the libsycl math function of the OpenCL `builtin` for the
+  // elements of `operands`, by calls of the vector overload of the builtin for
+  // as many elements as possible. Return the results of the elements
+  // computed.
+  SmallVector<Value> createOpenCLMathCalls(ConversionPatternRewriter &rewriter,
+                                           StringRef builtin, Type elemTy,
+                                           MultipleOperandsRange operands,
+                                           Location loc) const {
+    // The largest vector of the OpenCL vector sizes dividing the number of
+    // elements, the elements of a thread not being split.
+    unsigned numElements = 1;
+    for (unsigned size : {16, 8, 4, 2}) {
+      if (operands.size() % size == 0) {
+        numElements = size;
+        break;
+      }
+    }
+    unsigned numOperands = operands[0].size();
+
+    // Itanium mangling of the builtin: `f` or `d`, or `Dv<N>_f` or `Dv<N>_d`
+    // for the first vector operand and `S_` for the next ones.
+    std::string elemCode = elemTy.isF32() ? "f" : "d";
+    std::string name = ("__spirv_ocl_" + builtin).str();
+    std::string mangledName = "_Z" + std::to_string(name.size()) + name;
+    for (unsigned i = 0; i < numOperands; ++i) {
+      if (numElements == 1)
+        mangledName += elemCode;
+      else if (i == 0)
+        mangledName += "Dv" + std::to_string(numElements) + "_" + elemCode;
+      else
+        mangledName += "S_";
+    }
+
+    if (numElements == 1)
+      return {createSPIRVBuiltinCall(loc, rewriter, mangledName, elemTy,
+                                     operands[0])};
+
+    Type vecTy = vec_ty(elemTy, numElements);
+    SmallVector<Value> vecOperands;
+    for (unsigned i = 0; i < numOperands; ++i) {
+      Value vec = undef(vecTy);
+      for (unsigned j = 0; j < numElements; ++j)
+        vec = insert_element(vecTy, vec, operands[j][i], i32_val(j));
+      vecOperands.push_back(vec);
+    }
+    Value result =
+        createSPIRVBuiltinCall(loc, rewriter, mangledName, vecTy, vecOperands);
+    SmallVector<Value> results;
+    for (unsigned j = 0; j < numElements; ++j)
+      results.push_back(extract_element(elemTy, result, i32_val(j)));
+    return results;
+  }
+
   Type getFunctionType(Type resultType, ValueRange operands) const {
     SmallVector<Type> operandTypes(operands.getTypes());
     return LLVM::LLVMFunctionType::get(resultType, operandTypes);
@@ -1970,6 +2124,33 @@ struct ElementwiseInlineAsmOpConversion
     return packedOperands;
   }
 
+  // The asm of the op as vISA, the constraints of its operands being those of
+  // vISA, e.g. "=rw,rw,rw", and its instructions referring to them as $idx.
+  Value createVISAAsm(ElementwiseInlineAsmOp op,
+                      ArrayRef<Value> packedOperands, unsigned numOutputs,
+                      Type asmRetType, ConversionPatternRewriter &rewriter,
+                      Location loc) const {
+    SmallVector<StringRef> constraints;
+    StringRef(op.getConstraints()).split(constraints, ',');
+    if (constraints.size() != numOutputs + packedOperands.size())
+      llvm::report_fatal_error("Inline asm op has " +
+                               Twine(constraints.size()) +
+                               " constraints, expected " +
+                               Twine(numOutputs + packedOperands.size()) +
+                               " for its packed outputs and inputs.");
+    VISABuilder builder;
+    for (unsigned i = 0; i < constraints.size(); ++i) {
+      StringRef constraint = constraints[i].trim();
+      if (i < numOutputs)
+        builder.newOperand(constraint);
+      else
+        builder.newOperand(packedOperands[i - numOutputs], constraint);
+    }
+    builder.create(op.getAsmString());
+    return builder.launch(rewriter, loc, asmRetType,
+                          /*hasSideEffect=*/!op.getPure());
+  }
+
   SmallVector<SmallVector<Value>>
   createDestOps(ElementwiseInlineAsmOp op, OpAdaptor adaptor,
                 ConversionPatternRewriter &rewriter,
@@ -2005,20 +2186,25 @@ struct ElementwiseInlineAsmOpConversion
     Type asmRetType =
         asmRetTypes.size() > 1 ? struct_ty(asmRetTypes) : asmRetTypes[0];
 
-    Value asmResults =
-        rewriter
-            .create<LLVM::InlineAsmOp>(
-                loc, asmRetType,
-                /*operands=*/packedOperands,
-                /*asm_string=*/op.getAsmString(),
-                /*constraints=*/op.getConstraints(),
-                /*has_side_effects=*/!op.getPure(),
-                /*is_align_stack=*/false,
-                /*asm_dialect=*/
-                LLVM::AsmDialectAttr::get(rewriter.getContext(),
-                                          LLVM::AsmDialect::AD_ATT),
-                /*operand_attrs=*/ArrayAttr())
-            ->getResult(0);
+    Value asmResults;
+    if (target == mlir::triton::Target::GENX)
+      asmResults = createVISAAsm(op, packedOperands, asmRetTypes.size(),
+                                 asmRetType, rewriter, loc);
+    else
+      asmResults =
+          rewriter
+              .create<LLVM::InlineAsmOp>(
+                  loc, asmRetType,
+                  /*operands=*/packedOperands,
+                  /*asm_string=*/op.getAsmString(),
+                  /*constraints=*/op.getConstraints(),
+                  /*has_side_effects=*/!op.getPure(),
+                  /*is_align_stack=*/false,
+                  /*asm_dialect=*/
+                  LLVM::AsmDialectAttr::get(rewriter.getContext(),
+                                            LLVM::AsmDialect::AD_ATT),
+                  /*operand_attrs=*/ArrayAttr())
+              ->getResult(0);
 
     // asmResults is a flat struct; pack its values into
     // [return_value][op.getPackedElement()].
@@ -2194,6 +2380,15 @@ struct FMulOpConversion
 
     bool lhsAndRhsAreBF16 = lhsElemTy.isBF16() && rhsElemTy.isBF16();
 
+    if (target == mlir::triton::Target::GENX &&
+        (lhsAndRhsAreBF16 || (lhsElemTy.isF16() && rhsElemTy.isF16()))) {
+      SmallVector<Value> results =
+          EmitPackedHalfElementwiseOp<LLVM::FMulOp>(loc, rewriter, elemTy,
+                                                    operands);
+      if (!results.empty())
+        return results;
+    }
+
     if (lhsAndRhsAreBF16) {
       switch (target) {
       case mlir::triton::Target::NVVM: {
@@ -2234,6 +2429,15 @@ struct FAddOpConversion
     auto rhsElemTy = getElementType(op.getRhs());
     bool lhsAndRhsAreBF16 = lhsElemTy.isBF16() && rhsElemTy.isBF16();
 
+    if (target == mlir::triton::Target::GENX &&
+        (lhsAndRhsAreBF16 || (lhsElemTy.isF16() && rhsElemTy.isF16()))) {
+      SmallVector<Value> results =
+          EmitPackedHalfElementwiseOp<LLVM::FAddOp>(loc, rewriter, elemTy,
+                                                    operands);
+      if (!results.empty())
+        return results;
+    }
+
     if (lhsAndRhsAreBF16) {
       switch (target) {
       case mlir::triton::Target::NVVM: {
@@ -2274,6 +2478,15 @@ struct FSubOpConversion
     auto rhsElemTy = getElementType(op.getRhs());
     bool lhsAndRhsAreBF16 = lhsElemTy.isBF16() && rhsElemTy.isBF16();
 
+    if (target == mlir::triton::Target::GENX &&
+        (lhsAndRhsAreBF16 || (lhsElemTy.isF16() && rhsElemTy.isF16()))) {
+      SmallVector<Value> results =
+          EmitPackedHalfElementwiseOp<LLVM::FSubOp>(loc, rewriter, elemTy,
+                                                    operands);
+      if (!results.empty())
+        return results;
+    }
+
     if (lhsAndRhsAreBF16) {
       switch (target) {
       case mlir::triton::Target::NVVM: {
@@ -2726,6 +2939,92 @@ struct SelectOpConversion
         adaptor.getAttributes().getValue())};
   }
 };
+
+// Return the high and low words of the product of the 32-bit `a` and `b`. The
+// product of their 64-bit extensions is a single multiply-high sequence on the
+// devices, e.g. a mul/mach pair on GENX.
+static std::pair<Value, Value> mulWide(Location loc,
+                                       ConversionPatternRewriter &rewriter,
+                                       Value a, Value b) {
+  Value prod = mul(zext(i64_ty, a), zext(i64_ty, b));
+  return {trunc(i32_ty, lshr(prod, i64_val(32))), trunc(i32_ty, prod)};
+}
+
+// Run `nRounds` rounds of Philox 4x32 for the counter (c0, 0, 0, 0) and the
+// key (k0, k1), as `philox_impl` in python/triton/language/random.py.
+static SmallVector<Value> philox(Location loc,
+                                 ConversionPatternRewriter &rewriter, Value c0,
+                                 Value k0, Value k1, unsigned nRounds) {
+  constexpr uint32_t keyA = 0x9E3779B9;
+  constexpr uint32_t keyB = 0xBB67AE85;
+  constexpr uint32_t roundA = 0xD2511F53;
+  constexpr uint32_t roundB = 0xCD9E8D57;
+  Value zero = i32_val(0);
+  SmallVector<Value> c = {c0, zero, zero, zero};
+  for (unsigned i = 0; i < nRounds; ++i) {
+    auto [hiB, loB] =
+        mulWide(loc, rewriter, i32_val(static_cast<int32_t>(roundB)), c[2]);
+    auto [hiA, loA] =
+        mulWide(loc, rewriter, i32_val(static_cast<int32_t>(roundA)), c[0]);
+    c = {xor_(xor_(hiB, c[1]), k0), loB, xor_(xor_(hiA, c[3]), k1), loA};
+    k0 = add(k0, i32_val(static_cast<int32_t>(keyA)));
+    k1 = add(k1, i32_val(static_cast<int32_t>(keyB)));
+  }
+  return c;
+}
+
+struct PhiloxOpConversion
+    : ElementwiseOpConversionBase<triton::PhiloxOp, PhiloxOpConversion> {
+  using Base =
+      ElementwiseOpConversionBase<triton::PhiloxOp, PhiloxOpConversion>;
+  using Base::Base;
+  using Adaptor = typename Base::OpAdaptor;
+
+  // The number of words of a counter that are the results of consecutive
+  // elements of a thread: 4 if the thread owns the offsets of the counters
+  // contiguously, with the same seed, 1 otherwise.
+  unsigned getNumWordsPerCounter(triton::PhiloxOp op) const {
+    constexpr unsigned numWords = 4;
+    auto tensorTy = op.getOffset().getType().dyn_cast<RankedTensorType>();
+    if (!tensorTy)
+      return 1;
+    auto blocked =
+        tensorTy.getEncoding().dyn_cast<triton::gpu::BlockedEncodingAttr>();
+    if (!blocked)
+      return 1;
+    AxisInfo *offsetInfo = axisAnalysisPass.getAxisInfo(op.getOffset());
+    AxisInfo *seedInfo = axisAnalysisPass.getAxisInfo(op.getSeed());
+    if (!offsetInfo || !seedInfo)
+      return 1;
+    unsigned dim = blocked.getOrder()[0];
+    if (blocked.getSizePerThread()[dim] % numWords != 0 ||
+        offsetInfo->getContiguity(dim) % numWords != 0 ||
+        offsetInfo->getDivisibility(dim) % numWords != 0 ||
+        seedInfo->getConstancy(dim) % numWords != 0)
+      return 1;
+    return numWords;
+  }
+
+  SmallVector<Value> createDestOps(triton::PhiloxOp op, OpAdaptor adaptor,
+                                   ConversionPatternRewriter &rewriter,
+                                   Type elemTy, MultipleOperandsRange operands,
+                                   Location loc) const {
+    Value seed = operands[0][0];
+    Value offset = operands[0][1];
+    Value k0 = trunc(i32_ty, seed);
+    Value k1 = trunc(i32_ty, lshr(seed, i64_val(32)));
+    SmallVector<Value> words = philox(loc, rewriter, lshr(offset, i32_val(2)),
+                                      k0, k1, op.getNRounds());
+    // The elements of the 4 offsets of the counter, in order.
+    if (getNumWordsPerCounter(op) == words.size())
+      return words;
+    Value index = and_(offset, i32_val(3));
+    Value result = words[3];
+    for (int i = 2; i >= 0; --i)
+      result = select(icmp_eq(index, i32_val(i)), words[i], result);
+    return {result};
+  }
+};
 } // namespace
 
 void mlir::triton::populateElementwiseOpToLLVMPatterns(
@@ -2799,6 +3098,8 @@ void mlir::triton::populateElementwiseOpToLLVMPatterns(
 
   patterns.add<SelectOpConversion>(typeConverter, axisInfoAnalysis, target,
                                    benefit);
+  patterns.add<PhiloxOpConversion>(typeConverter, axisInfoAnalysis, target,
+                                   benefit);
   patterns.add<ExtFOpConversion>(typeConverter, axisInfoAnalysis, target,
                                  benefit);
   patterns.add<TruncFOpConversion>(typeConverter, axisInfoAnalysis, target,
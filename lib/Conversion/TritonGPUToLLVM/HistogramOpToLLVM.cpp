@@ -5,8 +5,31 @@
 using namespace mlir;
 using namespace mlir::triton;
 
+using ::mlir::LLVM::createSPIRVBuiltinCall;
+
 static int log2Int(int64_t num) { return (num > 1) ? 1 + log2Int(num / 2) : 0; }
 
+// The largest number of bins per lane for which the histogram of a sub-group
+// is computed with ballots on GENX. The cost of the ballots grows with the
+// number of bins, per-element atomics to the shared memory are used beyond.
+constexpr int maxBinsPerLaneForBallot = 4;
+
+// Return the mask of the lanes of the warp for which `pred` holds.
+static Value ballot(Location loc, ConversionPatternRewriter &rewriter,
+                    Value pred, Target target) {
+  if (target == Target::GENX) {
+    // The sub-groups have at most 32 lanes, only the first word of the
+    // ballot is set.
+    constexpr int32_t subgroupScope = 3;
+    Value bits = createSPIRVBuiltinCall(
+        loc, rewriter, "_Z29__spirv_GroupNonUniformBallotib",
+        vec_ty(i32_ty, 4), {i32_val(subgroupScope), pred});
+    return extract_element(i32_ty, bits, i32_val(0));
+  }
+  Value threadMask = i32_val(-1);
+  return rewriter.create<NVVM::VoteBallotOp>(loc, i32_ty, threadMask, pred);
+}
+
 // Compute a histogram within a warp. This uses an algorithm by @apgoucher
 // that does the following:
 // Create a ballot for each bit of the bin index (there
@@ -17,7 +40,7 @@ static SmallVector<Value>
 computeWarpLevelHistogram(Location loc, RankedTensorType srcType,
                           SmallVector<Value> &srcValues, int numBins,
                           int numThreadPerWarp, Value threadId,
-                          ConversionPatternRewriter &rewriter) {
+                          ConversionPatternRewriter &rewriter, Target target) {
   assert(numBins % numThreadPerWarp == 0 &&
          "numBins must be divisible by numThreadPerWarp");
   Value zero = i32_val(0);
@@ -35,9 +58,7 @@ computeWarpLevelHistogram(Location loc, RankedTensorType srcType,
     SmallVector<Value> ballotBits;
     for (int j = 0; j < numBits; ++j) {
       Value bitSet = and_(value, i32_val(1 << j));
-      Value threadMask = i32_val(-1);
-      Value bit = rewriter.create<NVVM::VoteBallotOp>(loc, i32_ty, threadMask,
-                                                      icmp_ne(bitSet, zero));
+      Value bit = ballot(loc, rewriter, icmp_ne(bitSet, zero), target);
       ballotBits.push_back(bit);
     }
     Value fullMask = i32_val(0xFFFFFFFF);
@@ -133,6 +154,71 @@ static SmallVector<Value> computeCrossWarpHistogram(
   return histogramValues;
 }
 
+// Compute the histogram on GENX. Each sub-group computes the histogram of its
+// values in its own copy in the shared memory, with ballots when there are
+// few bins or with atomics to its copy otherwise, so that the sub-groups
+// don't contend with each other. The copies are then summed by the threads
+// loading the bins they own in the result, after a single barrier.
+static SmallVector<Value> computeGENXHistogram(
+    Location loc, ConversionPatternRewriter &rewriter, RankedTensorType srcType,
+    SmallVector<Value> &srcValues, Value baseSharedMemPtr, int numBins,
+    int numThreadPerWarp, const SmallVector<Value> &indices, Value threadId,
+    int numWarps) {
+  unsigned numWarpsWithUniqueData =
+      mlir::triton::gpu::getWarpsPerCTAWithUniqueData(srcType.getEncoding(),
+                                                      srcType.getShape())[0];
+  Value warpId = udiv(threadId, i32_val(numThreadPerWarp));
+  Value laneId = urem(threadId, i32_val(numThreadPerWarp));
+  Type ptrTy = baseSharedMemPtr.getType();
+  Value warpSharedMemPtr = gep(ptrTy, i32_ty, baseSharedMemPtr,
+                               mul(warpId, i32_val(numBins)));
+  int numBinsPerLane = numBins / numThreadPerWarp;
+
+  if (numBinsPerLane <= maxBinsPerLaneForBallot) {
+    SmallVector<Value> warpLevelHistogram =
+        computeWarpLevelHistogram(loc, srcType, srcValues, numBins,
+                                  numThreadPerWarp, threadId, rewriter,
+                                  Target::GENX);
+    for (int i = 0; i < warpLevelHistogram.size(); ++i) {
+      Value offset = add(mul(laneId, i32_val(numBinsPerLane)), i32_val(i));
+      store(warpLevelHistogram[i],
+            gep(ptrTy, i32_ty, warpSharedMemPtr, offset));
+    }
+  } else {
+    for (int i = 0; i < numBinsPerLane; ++i) {
+      Value offset = add(laneId, i32_val(i * numThreadPerWarp));
+      store(i32_val(0), gep(ptrTy, i32_ty, warpSharedMemPtr, offset));
+    }
+    barrier();
+    // Skip the lanes holding replicated data, and the values out of the bins.
+    unsigned numThreadWithUniqueData =
+        triton::gpu::getThreadsPerWarpWithUniqueData(srcType.getEncoding(),
+                                                     srcType.getShape())[0];
+    Value isUniqueLane = icmp_ult(laneId, i32_val(numThreadWithUniqueData));
+    for (Value value : srcValues) {
+      Value pred = and_(isUniqueLane, icmp_ult(value, i32_val(numBins)));
+      LLVM::createPredicatedBlock(rewriter, loc, pred, [&] {
+        atomicAdd(gep(ptrTy, i32_ty, warpSharedMemPtr, value), i32_val(1), loc,
+                  rewriter);
+        return ArrayRef<Value>();
+      });
+    }
+  }
+  barrier();
+
+  SmallVector<Value> histogramValues;
+  for (Value index : indices) {
+    Value val = i32_val(0);
+    for (unsigned w = 0; w < numWarpsWithUniqueData; ++w) {
+      Value offset = add(index, i32_val(w * numBins));
+      Value sharedMemPtr = gep(ptrTy, i32_ty, baseSharedMemPtr, offset);
+      val = add(val, load(i32_ty, sharedMemPtr));
+    }
+    histogramValues.push_back(val);
+  }
+  return histogramValues;
+}
+
 namespace {
 struct HistogramOpConversion
     : public ConvertTritonGPUOpToLLVMPattern<triton::HistogramOp> {
@@ -149,25 +235,17 @@ public:
         getTypeConverter()->unpackLLElements(loc, input, rewriter);
     int numBins =
         op.getResult().getType().cast<RankedTensorType>().getDimSize(0);
-    int numThreadsPerWarp = 32;
+    auto mod = op->getParentOfType<ModuleOp>();
+    int numThreadsPerWarp =
+        triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
     // Pad out the bins so that we have at least one bin per thread within a
     // warp.
     numBins = std::max(numBins, numThreadsPerWarp);
     Value threadId = getThreadId(rewriter, loc);
     auto srcType = op.getInput().getType().cast<RankedTensorType>();
-    // First compute a warp local histogram based on values owned by each warps.
-    SmallVector<Value> warpLevelHistogram =
-        computeWarpLevelHistogram(loc, srcType, srcValues, numBins,
-                                  numThreadsPerWarp, threadId, rewriter);
-
-    // Then use atomic to update the histogram in shared memory.
-    // TODO: we could skip this for cases with num_warps=1 as long as we can
-    // generate the right layout. Currently the warp level histogram generates
-    // data in the default blocked layout.
     Value baseSharedMemPtr =
         LLVM::getSharedMemoryBase(loc, rewriter, op.getOperation(), target);
     auto dstType = op.getResult().getType().cast<RankedTensorType>();
-    auto mod = op->getParentOfType<ModuleOp>();
     int numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
     Attribute dstEncoding = dstType.getEncoding();
     auto indices =
@@ -175,9 +253,28 @@ public:
     SmallVector<Value> innerDimIndices;
     for (int i = 0; i < indices.size(); ++i)
       innerDimIndices.push_back(indices[i][0]);
-    SmallVector<Value> histogramValue = computeCrossWarpHistogram(
-        loc, rewriter, srcType, baseSharedMemPtr, warpLevelHistogram, numBins,
-        numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+
+    SmallVector<Value> histogramValue;
+    if (target == Target::GENX) {
+      histogramValue = computeGENXHistogram(
+          loc, rewriter, srcType, srcValues, baseSharedMemPtr, numBins,
+          numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+    } else {
+      // First compute a warp local histogram based on values owned by each
+      // warps.
+      SmallVector<Value> warpLevelHistogram =
+          computeWarpLevelHistogram(loc, srcType, srcValues, numBins,
+                                    numThreadsPerWarp, threadId, rewriter,
+                                    target);
+
+      // Then use atomic to update the histogram in shared memory.
+      // TODO: we could skip this for cases with num_warps=1 as long as we can
+      // generate the right layout. Currently the warp level histogram
+      // generates data in the default blocked layout.
+      histogramValue = computeCrossWarpHistogram(
+          loc, rewriter, srcType, baseSharedMemPtr, warpLevelHistogram,
+          numBins, numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+    }
 
     Value results = getTypeConverter()->packLLElements(
         loc, histogramValue, rewriter, op.getResult().getType());
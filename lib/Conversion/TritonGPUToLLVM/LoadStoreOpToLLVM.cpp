@@ -18,9 +18,14 @@
 using namespace mlir;
 using namespace mlir::triton;
 
+using ::mlir::LLVM::createSPIRVGroupOp;
 using ::mlir::LLVM::delinearize;
+using ::mlir::LLVM::getDedupIndices;
 using ::mlir::LLVM::getSharedMemoryObjectFromStruct;
 using ::mlir::LLVM::linearize;
+using ::mlir::LLVM::SPIRVGroupOperation;
+using ::mlir::triton::gpu::DotOperandEncodingAttr;
+using ::mlir::triton::gpu::DpasEncodingAttr;
 using ::mlir::triton::gpu::getCTALayout;
 using ::mlir::triton::gpu::getShapePerCTA;
 using ::mlir::triton::gpu::getTotalElemsPerThread;
@@ -41,6 +46,177 @@ static CUtensorMapDataType getCUtensorMapDataType(Type ty) {
   }
 }
 
+// Cache controls of the LSC (load/store/cache) messages of Intel GPUs, keep in
+// sync with `enum LSC_LDCC` and `enum LSC_STCC` of the IGC builtins.
+enum class LSCLoadCacheControl : int32_t {
+  DEFAULT = 0,
+  L1UC_L3UC = 1,
+  L1UC_L3C = 2,
+  L1C_L3UC = 3,
+  L1C_L3C = 4,
+  L1S_L3UC = 5,
+  L1S_L3C = 6,
+  L1IAR_L3C = 7,
+};
+
+enum class LSCStoreCacheControl : int32_t {
+  DEFAULT = 0,
+  L1UC_L3UC = 1,
+  L1UC_L3WB = 2,
+  L1WT_L3UC = 3,
+  L1WT_L3WB = 4,
+  L1S_L3UC = 5,
+  L1S_L3WB = 6,
+  L1WB_L3WB = 7,
+};
+
+// Map the cache modifier and eviction policy of a load to the closest LSC cache
+// control: `.cg` bypasses L1, `.cs` and evict-first stream through L1 so that
+// data read once does not evict the working set.
+static LSCLoadCacheControl getLSCLoadCacheControl(triton::LoadOp op) {
+  switch (op.getCache()) {
+  case triton::CacheModifier::CA:
+    return LSCLoadCacheControl::L1C_L3C;
+  case triton::CacheModifier::CG:
+    return LSCLoadCacheControl::L1UC_L3C;
+  case triton::CacheModifier::CS:
+    return LSCLoadCacheControl::L1S_L3UC;
+  default:
+    break;
+  }
+  switch (op.getEvict()) {
+  case triton::EvictionPolicy::EVICT_FIRST:
+    return LSCLoadCacheControl::L1S_L3C;
+  case triton::EvictionPolicy::EVICT_LAST:
+    return LSCLoadCacheControl::L1C_L3C;
+  default:
+    return LSCLoadCacheControl::DEFAULT;
+  }
+}
+
+static LSCStoreCacheControl getLSCStoreCacheControl(triton::StoreOp op) {
+  switch (op.getCache()) {
+  case triton::CacheModifier::WB:
+    return LSCStoreCacheControl::L1WB_L3WB;
+  case triton::CacheModifier::CG:
+    return LSCStoreCacheControl::L1UC_L3WB;
+  case triton::CacheModifier::CS:
+    return LSCStoreCacheControl::L1S_L3UC;
+  case triton::CacheModifier::WT:
+    return LSCStoreCacheControl::L1WT_L3WB;
+  default:
+    break;
+  }
+  switch (op.getEvict()) {
+  case triton::EvictionPolicy::EVICT_FIRST:
+    return LSCStoreCacheControl::L1S_L3WB;
+  case triton::EvictionPolicy::EVICT_LAST:
+    return LSCStoreCacheControl::L1WB_L3WB;
+  default:
+    return LSCStoreCacheControl::DEFAULT;
+  }
+}
+
+// Return the suffix of the LSC builtins accessing `nWords` words of `width`
+// bits, e.g. `uint4`, or an empty string if there is no such builtin.
+static std::string getLSCTypeSuffix(unsigned width, unsigned nWords) {
+  std::string suffix;
+  switch (width) {
+  case 8:
+    suffix = "uchar";
+    break;
+  case 16:
+    suffix = "ushort";
+    break;
+  case 32:
+    suffix = "uint";
+    break;
+  case 64:
+    suffix = "ulong";
+    break;
+  default:
+    return "";
+  }
+  if (nWords == 1)
+    return suffix;
+  if (width < 32 || (nWords != 2 && nWords != 3 && nWords != 4 && nWords != 8))
+    return "";
+  return suffix + std::to_string(nWords);
+}
+
+// declare the IGC builtin `funcName` as external function
+static LLVM::LLVMFuncOp
+getGenISABuiltinDeclaration(ConversionPatternRewriter &rewriter, Operation *op,
+                            StringRef funcName, Type retTy,
+                            ArrayRef<Type> argTys) {
+  auto moduleOp = op->getParentOfType<ModuleOp>();
+  if (Operation *funcOp = moduleOp.lookupSymbol(funcName))
+    return cast<LLVM::LLVMFuncOp>(funcOp);
+
+  auto funcType = LLVM::LLVMFunctionType::get(retTy, argTys);
+  ConversionPatternRewriter::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPointToStart(moduleOp.getBody());
+  auto func = rewriter.create<LLVM::LLVMFuncOp>(
+      UnknownLoc::get(rewriter.getContext()), funcName, funcType);
+  func.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+  return func;
+}
+
+// Load a value of type `retTy`, made of `nWords` words of `width` bits, from
+// global memory with the given cache control. Return a null value if there is
+// no LSC builtin for the type.
+static Value createLSCLoad(ConversionPatternRewriter &rewriter, Location loc,
+                           Operation *op, Type retTy, Value addr,
+                           unsigned width, unsigned nWords,
+                           LSCLoadCacheControl cacheControl) {
+  std::string suffix = getLSCTypeSuffix(width, nWords);
+  if (suffix.empty())
+    return Value();
+  auto *ctx = rewriter.getContext();
+  LLVM::LLVMFuncOp funcOp = getGenISABuiltinDeclaration(
+      rewriter, op, "__builtin_IB_lsc_load_global_" + suffix, retTy,
+      {ptr_ty(ctx, 1), i32_ty, i32_ty});
+  auto callOp =
+      call(funcOp, ValueRange{addr, i32_val(0),
+                              i32_val(static_cast<int32_t>(cacheControl))});
+  callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+  return callOp.getResult();
+}
+
+// Store `val`, a vector of `nWords` words of `width` bits, to global memory
+// with the given cache control. Return false if there is no LSC builtin for
+// the type.
+static bool createLSCStore(ConversionPatternRewriter &rewriter, Location loc,
+                           Operation *op, Value val, Value addr,
+                           unsigned width, unsigned nWords,
+                           LSCStoreCacheControl cacheControl) {
+  std::string suffix = getLSCTypeSuffix(width, nWords);
+  if (suffix.empty())
+    return false;
+  auto *ctx = rewriter.getContext();
+  if (nWords == 1)
+    val = extract_element(IntegerType::get(ctx, width), val, i32_val(0));
+  LLVM::LLVMFuncOp funcOp = getGenISABuiltinDeclaration(
+      rewriter, op, "__builtin_IB_lsc_store_global_" + suffix, void_ty(ctx),
+      {ptr_ty(ctx, 1), i32_ty, val.getType(), i32_ty});
+  auto callOp =
+      call(funcOp, ValueRange{addr, i32_val(0), val,
+                              i32_val(static_cast<int32_t>(cacheControl))});
+  callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+  return true;
+}
+
+// Broadcast the predicate `pred` of a vectorized access to the mask of a
+// masked load/store of `numElems` elements.
+static Value createMaskVector(ConversionPatternRewriter &rewriter,
+                              Location loc, Value pred, unsigned numElems) {
+  Type maskTy = vec_ty(i1_ty, numElems);
+  Value mask = undef(maskTy);
+  for (unsigned i = 0; i < numElems; ++i)
+    mask = insert_element(maskTy, mask, pred, i32_val(i));
+  return mask;
+}
+
 namespace {
 // Contains some helper functions for both Load and Store conversions.
 struct LoadStoreConversionBase {
@@ -68,6 +244,15 @@ struct LoadStoreConversionBase {
     return axisAnalysisPass.getMaskAlignment(mask);
   }
 
+  // Returns the constancy of `value` along each dimension, or unit constancy
+  // if it is not available.
+  SmallVector<int64_t> getConstancy(Value value, int rank) const {
+    AxisInfo *axisInfo = axisAnalysisPass.getAxisInfo(value);
+    if (!axisInfo || axisInfo->getRank() != rank)
+      return SmallVector<int64_t>(rank, 1);
+    return axisInfo->getConstancy();
+  }
+
 protected:
   ModuleAxisInfoAnalysis &axisAnalysisPass;
 };
@@ -141,6 +326,32 @@ struct LoadOpConversion
       otherElems = getTypeConverter()->unpackLLElements(loc, llOther, rewriter);
     }
 
+    // The elements of a thread whose pointer, mask and other are all equal to
+    // those of a previous element load the same value: reuse it.
+    SmallVector<unsigned> dedupIndices;
+    if (auto tensorTy = ptr.getType().dyn_cast<RankedTensorType>();
+        tensorTy && !op.getIsVolatile()) {
+      int rank = tensorTy.getRank();
+      SmallVector<int64_t> constancy = getConstancy(ptr, rank);
+      for (Value operand : {mask, other}) {
+        if (!operand)
+          continue;
+        SmallVector<int64_t> operandConstancy = getConstancy(operand, rank);
+        for (int d = 0; d < rank; ++d)
+          constancy[d] = std::min(constancy[d], operandConstancy[d]);
+      }
+      dedupIndices = getDedupIndices(tensorTy, constancy, numElems);
+    }
+    // Whether the `vec` elements from `vecStart` reuse previous loads.
+    auto isRedundantVec = [&](size_t vecStart) {
+      if (dedupIndices.empty() || dedupIndices[vecStart] == vecStart)
+        return false;
+      for (size_t ii = 1; ii < vec; ++ii)
+        if (dedupIndices[vecStart + ii] != dedupIndices[vecStart] + ii)
+          return false;
+      return true;
+    };
+
     // vectorized iteration through all the pointer/mask/other elements
     const int valueElemNBits =
         std::max(8u, valueElemTy.getIntOrFloatBitWidth());
@@ -148,6 +359,12 @@ struct LoadOpConversion
 
     SmallVector<Value> loadedVals;
     for (size_t vecStart = 0; vecStart < numElems; vecStart += vec) {
+      if (isRedundantVec(vecStart)) {
+        for (size_t ii = 0; ii < vec; ++ii)
+          loadedVals.push_back(loadedVals[dedupIndices[vecStart] + ii]);
+        continue;
+      }
+
       // TODO: optimization when ptr is GEP with constant offset
       size_t in_off = 0;
 
@@ -198,15 +415,36 @@ struct LoadOpConversion
           }
         }
 
-        // Create a predicated load operation.
-        Block &endBlock = LLVM::createPredicatedBlock(
-            rewriter, loc, pred, SmallVector<Value, 1>{other_}, [&]() {
-              Value addrElem =
-                  bitcast(ptrElems[vecStart], ptr_ty(ctx, 1 /*global*/));
-              Value ret = load(retTy, addrElem);
-              return SmallVector<Value, 1>{ret};
-            });
-        Value ret = *endBlock.args_begin();
+        LSCLoadCacheControl cacheControl = getLSCLoadCacheControl(op);
+        Value ret;
+        if (cacheControl == LSCLoadCacheControl::DEFAULT) {
+          // Create a masked load operation, which keeps the code of masked
+          // accesses branch free.
+          Type maskedTy = vec_ty(IntegerType::get(ctx, width), nWords);
+          Value addrElem =
+              bitcast(ptrElems[vecStart], ptr_ty(ctx, 1 /*global*/));
+          Value passThru = nWords > 1 ? other_ : bitcast(other_, maskedTy);
+          ret = rewriter.create<LLVM::MaskedLoadOp>(
+              loc, maskedTy, addrElem,
+              createMaskVector(rewriter, loc, pred, nWords),
+              ValueRange{passThru}, width * nWords / 8);
+          if (nWords == 1)
+            ret = bitcast(ret, retTy);
+        } else {
+          // Create a predicated load operation.
+          Block &endBlock = LLVM::createPredicatedBlock(
+              rewriter, loc, pred, SmallVector<Value, 1>{other_}, [&]() {
+                Value addrElem =
+                    bitcast(ptrElems[vecStart], ptr_ty(ctx, 1 /*global*/));
+                Value loaded = createLSCLoad(rewriter, loc, op, retTy,
+                                             addrElem, width, nWords,
+                                             cacheControl);
+                if (!loaded)
+                  loaded = load(retTy, addrElem);
+                return SmallVector<Value, 1>{loaded};
+              });
+          ret = *endBlock.args_begin();
+        }
 
         // Extract and store return values
         SmallVector<Value> rets;
@@ -456,13 +694,27 @@ struct StoreOpConversion
           vecWord = insert_element(vecTy, vecWord, llWord, i32_val(index));
         }
 
-        // Create a predicated store operation.
-        mlir::LLVM::createPredicatedBlock(rewriter, loc, maskVal, [&] {
+        LSCStoreCacheControl cacheControl = getLSCStoreCacheControl(op);
+        if (cacheControl == LSCStoreCacheControl::DEFAULT) {
+          // Create a masked store operation, which keeps the code of masked
+          // accesses branch free.
           Value addrElem =
               bitcast(ptrElems[vecStart], ptr_ty(ctx, 1 /*global*/));
-          store(vecWord, addrElem);
-          return ArrayRef<Value>();
-        });
+          rewriter.create<LLVM::MaskedStoreOp>(
+              loc, vecWord, addrElem,
+              createMaskVector(rewriter, loc, maskVal, nWords),
+              width * nWords / 8);
+        } else {
+          // Create a predicated store operation.
+          mlir::LLVM::createPredicatedBlock(rewriter, loc, maskVal, [&] {
+            Value addrElem =
+                bitcast(ptrElems[vecStart], ptr_ty(ctx, 1 /*global*/));
+            if (!createLSCStore(rewriter, loc, op, vecWord, addrElem, width,
+                                nWords, cacheControl))
+              store(vecWord, addrElem);
+            return ArrayRef<Value>();
+          });
+        }
       } else {
         // Prepare the PTX inline asm.
         PTXBuilder ptxBuilder;
@@ -500,6 +752,404 @@ struct StoreOpConversion
     return success();
   }
 };
+// The operands of the GENX 2D block IO operations describing the memory
+// accessed through a block pointer: a surface of `height` rows of `width`
+// bytes located `pitch` bytes apart, and the coordinates of the block within
+// the surface. The rows of the surface of a column-major block are its
+// columns.
+struct BlockPointerSurface {
+  BlockPointerSurface(Location loc, Value blockPtr, unsigned elemSizeInBits,
+                      TritonGPUToLLVMTypeConverter *typeConverter,
+                      ConversionPatternRewriter &rewriter,
+                      bool isColumnMajor = false) {
+    // struct { offset0, offset1, shape0, shape1, stride0, stride1, base_ptr};
+    SmallVector<Value> elems =
+        typeConverter->unpackLLElements(loc, blockPtr, rewriter);
+    assert(elems.size() == 7 && "Expecting a 2D block pointer");
+    Value elemSizeInBytes = i32_val(elemSizeInBits / 8);
+    unsigned rowDim = isColumnMajor ? 1 : 0;
+    unsigned colDim = rowDim ^ 1;
+    rowOffset = elems[rowDim];
+    colOffset = elems[colDim];
+    height = trunc(i32_ty, elems[2 + rowDim]);
+    width = mul(trunc(i32_ty, elems[2 + colDim]), elemSizeInBytes);
+    pitch = mul(trunc(i32_ty, elems[4 + rowDim]), elemSizeInBytes);
+    base = elems[6];
+  }
+
+  Value base, width, height, pitch;
+  Value rowOffset, colOffset;
+};
+
+// Store `tile`, the elements of the lane of a `tileHeight` x `tileWidth` block
+// of `elemSizeInBits` bit elements, at the `col` and `row` of `surface` with
+// the given cache control. The 2D block writes of the GENX dialect have no
+// cache control, the IGC builtins do. Return false if there is no builtin for
+// the block.
+static bool createLSCBlockStore(ConversionPatternRewriter &rewriter,
+                                Location loc, Operation *op,
+                                const BlockPointerSurface &surface, Value col,
+                                Value row, unsigned elemSizeInBits,
+                                unsigned tileWidth, unsigned tileHeight,
+                                Value tile, LSCStoreCacheControl cacheControl) {
+  if ((elemSizeInBits != 8 && elemSizeInBits != 16 && elemSizeInBits != 32) ||
+      tileWidth != 16 || tileHeight > 8 || !llvm::isPowerOf2_32(tileHeight))
+    return false;
+  auto *ctx = rewriter.getContext();
+  std::string funcName = "__builtin_IB_subgroup_block_write_cacheopts_u" +
+                         std::to_string(elemSizeInBits) + "_m" +
+                         std::to_string(tileHeight) + "k" +
+                         std::to_string(tileWidth) + "v1";
+  VectorType coordTy = vec_ty(i32_ty, 2);
+  LLVM::LLVMFuncOp funcOp = getGenISABuiltinDeclaration(
+      rewriter, op, funcName, void_ty(ctx),
+      {i64_ty, i32_ty, i32_ty, i32_ty, coordTy, tile.getType(), i32_ty});
+  // The builtins take the sizes of the surface minus one.
+  Value one = i32_val(1);
+  Value coord = undef(coordTy);
+  coord = insert_element(coordTy, coord, col, i32_val(0));
+  coord = insert_element(coordTy, coord, row, i32_val(1));
+  auto callOp = call(
+      funcOp, ValueRange{ptrtoint(i64_ty, surface.base),
+                         sub(surface.width, one), sub(surface.height, one),
+                         sub(surface.pitch, one), coord, tile,
+                         i32_val(static_cast<int32_t>(cacheControl))});
+  callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+  return true;
+}
+
+// Return the 2-dim coordinates of the warp of the current thread within the
+// DPAS layout, using the same warp order as the DPAS indices emission.
+static SmallVector<Value>
+getMultiDimWarpId(Location loc, ConversionPatternRewriter &rewriter,
+                  Value threadId, DpasEncodingAttr dpasLayout) {
+  SmallVector<unsigned> warpsPerCTA = dpasLayout.getWarpsPerCTA();
+  Value warpId = udiv(threadId, i32_val(triton::gpu::getWarpSize(dpasLayout)));
+  return {urem(warpId, i32_val(warpsPerCTA[0])),
+          urem(udiv(warpId, i32_val(warpsPerCTA[0])), i32_val(warpsPerCTA[1]))};
+}
+
+// Lower a load through a block pointer materialized with a DPAS operand layout
+// to 2D block reads. Each warp reads the DPAS operand tiles it owns straight
+// into registers; out of bound elements are filled with zeros by the hardware.
+// The B operands with contiguous columns, marked `triton_gpu.column_major`,
+// are read by transposed reads of dwords, which give each lane the packed
+// elements of its column as the VNNI reads of the row-major ones do.
+template <typename SourceOp>
+struct BlockPointerLoadConversionBase
+    : public ConvertTritonGPUOpToLLVMPattern<SourceOp> {
+  using ConvertTritonGPUOpToLLVMPattern<
+      SourceOp>::ConvertTritonGPUOpToLLVMPattern;
+
+protected:
+  // Return the operand of `tensorTy`, a DPAS operand layout, whose tiles are
+  // read through the block pointer `blockPtr`. The tile of the rows of memory
+  // from `row` in the block is read at the row `getRow(surface, row)` of the
+  // surface.
+  Value
+  loadTiles(Location loc, Value blockPtr, RankedTensorType tensorTy,
+            bool isColumnMajor,
+            function_ref<Value(const BlockPointerSurface &, Value)> getRow,
+            ConversionPatternRewriter &rewriter) const {
+    auto dotLayout = tensorTy.getEncoding().cast<DotOperandEncodingAttr>();
+    auto dpasLayout = dotLayout.getParent().cast<DpasEncodingAttr>();
+    Type eltTy = tensorTy.getElementType();
+    unsigned elemSizeInBits = eltTy.getIntOrFloatBitWidth();
+    unsigned opIdx = dotLayout.getOpIdx();
+    SmallVector<int64_t> elemsPerInstr =
+        dotLayout.getDPASElemsPerInstr(elemSizeInBits);
+    SmallVector<int64_t> numReps =
+        dotLayout.getDPASRep(tensorTy.getShape(), eltTy);
+    SmallVector<unsigned> warpsPerCTA = dpasLayout.getWarpsPerCTA();
+    unsigned threadsPerWarp = triton::gpu::getWarpSize(dpasLayout);
+
+    assert((!isColumnMajor || opIdx == 1) &&
+           "Expecting a column-major B operand");
+    BlockPointerSurface surface(loc, blockPtr, elemSizeInBits,
+                                this->getTypeConverter(), rewriter,
+                                isColumnMajor);
+    Value threadId = this->getThreadId(rewriter, loc);
+    SmallVector<Value> multiDimWarpId =
+        getMultiDimWarpId(loc, rewriter, threadId, dpasLayout);
+
+    // The B operand is read in VNNI format, which packs the elements of
+    // consecutive rows (along the K dimension) into dwords.
+    bool vnni = opIdx == 1 && elemSizeInBits < 32;
+    unsigned tileHeight = elemsPerInstr[0], tileWidth = elemsPerInstr[1];
+    unsigned numElemsPerLane = tileHeight * tileWidth / threadsPerWarp;
+    Type loadTy = vnni || isColumnMajor
+                      ? vec_ty(i32_ty, numElemsPerLane * elemSizeInBits / 32)
+                      : vec_ty(int_ty(elemSizeInBits), numElemsPerLane);
+    // The elements of a transposed read are dwords, the rows of the memory
+    // are the columns of the tile.
+    unsigned elemsPerDword = 32 / elemSizeInBits;
+    Type operandTy =
+        this->getTypeConverter()->getElementTypeForStruct(tensorTy);
+
+    // The non-K dimension is distributed across the warps, the K dimension is
+    // not.
+    unsigned nonKDim = opIdx == 0 ? 0 : 1;
+    unsigned kDim = nonKDim ^ 1;
+    Value warpOffset =
+        mul(multiDimWarpId[nonKDim], i32_val(elemsPerInstr[nonKDim]));
+
+    SmallVector<Value> loadedVals;
+    for (int64_t outer = 0; outer < numReps[nonKDim]; ++outer) {
+      for (int64_t k = 0; k < numReps[kDim]; ++k) {
+        SmallVector<Value, 2> offsets(2);
+        offsets[nonKDim] = add(
+            warpOffset,
+            i32_val(outer * warpsPerCTA[nonKDim] * elemsPerInstr[nonKDim]));
+        offsets[kDim] = i32_val(k * elemsPerInstr[kDim]);
+
+        if (isColumnMajor) {
+          Value ret = rewriter.create<GENX::Matrix2DBlockLoadOp>(
+              loc, loadTy, surface.base, surface.width, surface.height,
+              surface.pitch,
+              udiv(add(surface.colOffset, offsets[0]), i32_val(elemsPerDword)),
+              getRow(surface, offsets[1]), /*elem_size_in_bits*/ 32,
+              tileHeight / elemsPerDword, tileWidth, /*v_blocks*/ 1,
+              /*transpose*/ true, /*vnni*/ false);
+          loadedVals.push_back(bitcast(ret, operandTy));
+          continue;
+        }
+
+        Value ret = rewriter.create<GENX::Matrix2DBlockLoadOp>(
+            loc, loadTy, surface.base, surface.width, surface.height,
+            surface.pitch, add(surface.colOffset, offsets[1]),
+            getRow(surface, offsets[0]), elemSizeInBits, tileWidth,
+            tileHeight, /*v_blocks*/ 1, /*transpose*/ false, vnni);
+        loadedVals.push_back(bitcast(ret, operandTy));
+      }
+    }
+
+    Type llvmResultStructTy = this->getTypeConverter()->convertType(tensorTy);
+    return this->getTypeConverter()->packLLElements(loc, loadedVals, rewriter,
+                                                    llvmResultStructTy);
+  }
+
+  // Whether `tensorTy` is a DPAS operand read by `loadTiles`.
+  static bool isDPASOperand(RankedTensorType tensorTy) {
+    auto dotLayout = tensorTy.getEncoding().dyn_cast<DotOperandEncodingAttr>();
+    return dotLayout && dotLayout.getParent().isa<DpasEncodingAttr>();
+  }
+};
+
+struct BlockPointerLoadOpConversion
+    : public BlockPointerLoadConversionBase<triton::LoadOp> {
+  using BlockPointerLoadConversionBase<
+      triton::LoadOp>::BlockPointerLoadConversionBase;
+
+  LogicalResult
+  matchAndRewrite(triton::LoadOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (target != triton::Target::GENX ||
+        !isTensorPointerType(op.getPtr().getType()))
+      return failure();
+
+    auto tensorTy = op.getType().cast<RankedTensorType>();
+    if (!isDPASOperand(tensorTy))
+      return failure();
+
+    Location loc = op.getLoc();
+    Value result = loadTiles(
+        loc, adaptor.getPtr(), tensorTy,
+        op->hasAttr("triton_gpu.column_major"),
+        [&](const BlockPointerSurface &surface, Value row) {
+          return add(surface.rowOffset, row);
+        },
+        rewriter);
+    rewriter.replaceOp(op, {result});
+    return success();
+  }
+};
+
+// Lower a tt.load_pages whose block pointer is materialized with a DPAS operand
+// layout to the 2D block reads of its tiles, as a load. Each tile is within a
+// page, whose row in the surface is given by the index of the page, loaded by
+// each lane of the warp from the uniform address of the page. The other
+// layouts are lowered to loads by a tensor of pointers by
+// -tritongpu-rewrite-tensor-pointer.
+struct LoadPagesOpConversion
+    : public BlockPointerLoadConversionBase<triton::LoadPagesOp> {
+  using BlockPointerLoadConversionBase<
+      triton::LoadPagesOp>::BlockPointerLoadConversionBase;
+
+  LogicalResult
+  matchAndRewrite(triton::LoadPagesOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto tensorTy = op.getType().cast<RankedTensorType>();
+    if (target != triton::Target::GENX || !isDPASOperand(tensorTy))
+      return failure();
+
+    Location loc = op.getLoc();
+    Value pages = adaptor.getPages();
+    Value pageSize = i32_val(op.getPageSize());
+    Value result = loadTiles(
+        loc, adaptor.getPtr(), tensorTy, /*isColumnMajor=*/false,
+        [&](const BlockPointerSurface &surface, Value row) {
+          Value pageAddr = gep(pages.getType(), i32_ty, pages,
+                               udiv(row, pageSize));
+          Value pageRow = mul(load(i32_ty, pageAddr), pageSize);
+          return add(surface.rowOffset, add(pageRow, urem(row, pageSize)));
+        },
+        rewriter);
+    rewriter.replaceOp(op, {result});
+    return success();
+  }
+};
+
+// Lower a store of a value with a DPAS layout through a block pointer to 2D
+// block writes, one per DPAS tile owned by the warp. Out of bound elements are
+// dropped by the hardware. The stores with a cache modifier or an eviction
+// policy are written with their LSC cache control, e.g. streaming `.cs` stores
+// bypass L3.
+struct BlockPointerStoreOpConversion
+    : public ConvertTritonGPUOpToLLVMPattern<triton::StoreOp> {
+  using ConvertTritonGPUOpToLLVMPattern<
+      triton::StoreOp>::ConvertTritonGPUOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::StoreOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (target != triton::Target::GENX ||
+        !isTensorPointerType(op.getPtr().getType()))
+      return failure();
+
+    auto tensorTy = op.getValue().getType().cast<RankedTensorType>();
+    auto dpasLayout = tensorTy.getEncoding().dyn_cast<DpasEncodingAttr>();
+    if (!dpasLayout)
+      return failure();
+
+    Location loc = op.getLoc();
+    Type eltTy = getTypeConverter()->convertType(tensorTy.getElementType());
+    unsigned elemSizeInBits = eltTy.getIntOrFloatBitWidth();
+    unsigned repeatCount = dpasLayout.getRepeatCount();
+    unsigned executionSize = dpasLayout.getExecutionSize();
+    SmallVector<unsigned> shapePerCTATile =
+        triton::gpu::getShapePerCTATile(dpasLayout);
+    ArrayRef<int64_t> shape = tensorTy.getShape();
+    int64_t numRepM = shape[0] / shapePerCTATile[0];
+    int64_t numRepN = shape[1] / shapePerCTATile[1];
+
+    BlockPointerSurface surface(loc, adaptor.getPtr(), elemSizeInBits,
+                                getTypeConverter(), rewriter);
+    Value threadId = getThreadId(rewriter, loc);
+    SmallVector<Value> multiDimWarpId =
+        getMultiDimWarpId(loc, rewriter, threadId, dpasLayout);
+    Value rowOffset = add(surface.rowOffset,
+                          mul(multiDimWarpId[0], i32_val(repeatCount)));
+    Value colOffset = add(surface.colOffset,
+                          mul(multiDimWarpId[1], i32_val(executionSize)));
+
+    SmallVector<Value> vals =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getValue(), rewriter);
+    assert(vals.size() == numRepM * numRepN * repeatCount &&
+           "Unexpected number of elements per thread");
+
+    LSCStoreCacheControl cacheControl = getLSCStoreCacheControl(op);
+    VectorType tileTy = vec_ty(eltTy, repeatCount);
+    Type storeTy = vec_ty(int_ty(elemSizeInBits), repeatCount);
+    for (int64_t m = 0; m < numRepM; ++m) {
+      for (int64_t n = 0; n < numRepN; ++n) {
+        Value tile = undef(tileTy);
+        for (unsigned i = 0; i < repeatCount; ++i)
+          tile = insert_element(
+              tileTy, tile, vals[(m * numRepN + n) * repeatCount + i],
+              i32_val(i));
+
+        Value col = add(colOffset, i32_val(n * shapePerCTATile[1]));
+        Value row = add(rowOffset, i32_val(m * shapePerCTATile[0]));
+        if (cacheControl != LSCStoreCacheControl::DEFAULT &&
+            createLSCBlockStore(rewriter, loc, op, surface, col, row,
+                                elemSizeInBits, executionSize, repeatCount,
+                                bitcast(tile, storeTy), cacheControl))
+          continue;
+        rewriter.create<GENX::Matrix2DBlockStoreOp>(
+            loc, surface.base, surface.width, surface.height, surface.pitch,
+            col, row, elemSizeInBits, executionSize, repeatCount,
+            /*v_blocks*/ 1, /*transpose*/ false, /*vnni_transform*/ false,
+            bitcast(tile, storeTy));
+      }
+    }
+
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+// Lower a prefetch through a block pointer to LSC prefetches into L1 and L3 of
+// the cache lines covered by the block. The cache lines are distributed over
+// the threads of the CTA, the ones out of the bounds of the surface are
+// skipped.
+struct PrefetchOpConversion
+    : public ConvertTritonGPUOpToLLVMPattern<triton::gpu::PrefetchOp> {
+  using ConvertTritonGPUOpToLLVMPattern<
+      triton::gpu::PrefetchOp>::ConvertTritonGPUOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::gpu::PrefetchOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    // Prefetches are only hints, drop them on the other targets.
+    if (target != triton::Target::GENX) {
+      rewriter.eraseOp(op);
+      return success();
+    }
+
+    Location loc = op.getLoc();
+    auto *ctx = rewriter.getContext();
+    auto tensorTy = op.getPtr()
+                        .getType()
+                        .cast<triton::PointerType>()
+                        .getPointeeType()
+                        .cast<RankedTensorType>();
+    ArrayRef<int64_t> shape = tensorTy.getShape();
+    unsigned elemSizeInBits = tensorTy.getElementType().getIntOrFloatBitWidth();
+    BlockPointerSurface surface(loc, adaptor.getPtr(), elemSizeInBits,
+                                getTypeConverter(), rewriter);
+
+    constexpr unsigned cacheLineSize = 64;
+    unsigned rowSize = shape[1] * elemSizeInBits / 8;
+    unsigned linesPerRow = (rowSize + cacheLineSize - 1) / cacheLineSize;
+    unsigned numLines = shape[0] * linesPerRow;
+    auto mod = op->getParentOfType<ModuleOp>();
+    unsigned numThreads = triton::gpu::TritonGPUDialect::getNumWarps(mod) *
+                          triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+
+    LLVM::LLVMFuncOp funcOp = getGenISABuiltinDeclaration(
+        rewriter, op, "__builtin_IB_lsc_prefetch_global_uint", void_ty(ctx),
+        {ptr_ty(ctx, 1), i32_ty, i32_ty});
+    Value threadId = getThreadId(rewriter, loc);
+    Value colStart = mul(surface.colOffset, i32_val(elemSizeInBits / 8));
+    for (unsigned start = 0; start < numLines; start += numThreads) {
+      Value line = add(threadId, i32_val(start));
+      Value row = add(surface.rowOffset, udiv(line, i32_val(linesPerRow)));
+      Value col = add(colStart, mul(urem(line, i32_val(linesPerRow)),
+                                    i32_val(cacheLineSize)));
+      Value inBounds =
+          and_(icmp_ult(line, i32_val(numLines)),
+               and_(and_(icmp_sge(row, i32_val(0)),
+                         icmp_slt(row, surface.height)),
+                    and_(icmp_sge(col, i32_val(0)),
+                         icmp_slt(col, surface.width))));
+      LLVM::createPredicatedBlock(rewriter, loc, inBounds, [&] {
+        Value offset = add(mul(sext(i64_ty, row), sext(i64_ty, surface.pitch)),
+                           sext(i64_ty, col));
+        Value addr = gep(ptr_ty(ctx, 1), i8_ty, surface.base, offset);
+        auto cacheControl =
+            static_cast<int32_t>(LSCLoadCacheControl::L1C_L3C);
+        auto callOp =
+            call(funcOp, ValueRange{addr, i32_val(0), i32_val(cacheControl)});
+        callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+        return ArrayRef<Value>();
+      });
+    }
+
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
 // TODO: refactor to save common logic with insertsliceasyncv2
 struct StoreAsyncTMAOpConversion : public ConvertTritonGPUOpToLLVMPattern<
                                        triton::nvidia_gpu::StoreAsyncTMAOp> {
@@ -1256,11 +1906,32 @@ struct AtomicRMWOpConversion
     if (tensorTy) {
       auto valTy = val.getType().cast<RankedTensorType>();
       vec = std::min<unsigned>(vec, valTy.getElementType().isF16() ? 2 : 1);
+      // The LLVM atomics of GENX are scalar, the packed halves are updated
+      // one by one.
+      if (target == triton::Target::GENX)
+        vec = 1;
       // mask
       numElems = tensorTy.getNumElements();
     }
     Value mask = getMask(valueTy, rewriter, loc);
 
+    // On GENX, when the old values aren't used and all the lanes of a
+    // sub-group update the same address, e.g. the partial sums of a split-K
+    // reduction or the bins of a histogram hit by a whole sub-group, the
+    // values are combined within the sub-group and a single lane issues the
+    // atomic.
+    std::optional<StringRef> groupOpName;
+    if (target == triton::Target::GENX && tensorTy && op->use_empty() &&
+        isUniformWithinWarp(ptr))
+      groupOpName = getSPIRVGroupOpName(atomicRmwAttr, valueElemTy);
+    Value isFirstLane;
+    if (groupOpName) {
+      unsigned threadsPerWarp =
+          triton::gpu::TritonGPUDialect::getThreadsPerWarp(moduleOp);
+      Value laneId = urem(getThreadId(rewriter, loc), i32_val(threadsPerWarp));
+      isFirstLane = icmp_eq(laneId, i32_val(0));
+    }
+
     auto vecTy = vec_ty(valueElemTy, vec);
     SmallVector<Value> resultVals(elemsPerThread);
     for (size_t i = 0; i < elemsPerThread; i += vec) {
@@ -1274,6 +1945,19 @@ struct AtomicRMWOpConversion
       Value rmwPtr = ptrElements[i];
       Value rmwMask = llMask ? and_(mask, maskElements[i]) : mask;
 
+      if (groupOpName) {
+        // The masked lanes contribute the identity of the operation.
+        Value masked = select(rmwMask, valElements[i],
+                              getIdentity(rewriter, loc, atomicRmwAttr,
+                                          valueElemTy));
+        rmwVal = createSPIRVGroupOp(loc, rewriter, *groupOpName,
+                                    SPIRVGroupOperation::Reduce, masked);
+        Value anyActive = createSPIRVGroupOp(
+            loc, rewriter, "GroupNonUniformUMax", SPIRVGroupOperation::Reduce,
+            zext(i32_ty, rmwMask));
+        rmwMask = and_(isFirstLane, icmp_ne(anyActive, i32_val(0)));
+      }
+
       switch (target) {
       case triton::Target::ROCDL:
       case triton::Target::NVVM: {
@@ -1432,6 +2116,12 @@ struct AtomicRMWOpConversion
                 vec == 1 ? ret : extract_element(valueElemTy, ret, i32_val(ii));
           }
         } else {
+          // Nothing to broadcast to the other threads, e.g. for the counters
+          // of the instrumented regions.
+          if (op->use_empty()) {
+            rewriter.replaceOp(op, {ret});
+            return success();
+          }
           Value atomPtr = LLVM::getSharedMemoryBase(loc, rewriter,
                                                     op.getOperation(), target);
           atomPtr = bitcast(atomPtr, ptr_ty(ctx, 3));
@@ -1456,6 +2146,186 @@ struct AtomicRMWOpConversion
     }
     return success();
   }
+
+private:
+  // Whether all the lanes of a sub-group access the same address for each
+  // of their elements.
+  bool isUniformWithinWarp(Value ptr) const {
+    auto tensorTy = ptr.getType().cast<RankedTensorType>();
+    auto blocked = tensorTy.getEncoding().dyn_cast<BlockedEncodingAttr>();
+    AxisInfo *axisInfo = axisAnalysisPass.getAxisInfo(ptr);
+    if (!blocked || !axisInfo)
+      return false;
+    for (unsigned d = 0; d < tensorTy.getRank(); ++d) {
+      int64_t shapePerWarp = std::min<int64_t>(
+          tensorTy.getShape()[d],
+          blocked.getSizePerThread()[d] * blocked.getThreadsPerWarp()[d]);
+      if (axisInfo->getConstancy(d) % shapePerWarp != 0)
+        return false;
+    }
+    return true;
+  }
+
+  // Return the SPIR-V sub-group reduction combining the values of `rmwOp`.
+  static std::optional<StringRef> getSPIRVGroupOpName(RMWOp rmwOp,
+                                                      Type elemTy) {
+    if (rmwOp == RMWOp::FADD)
+      return elemTy.isF16() || elemTy.isF32() || elemTy.isF64()
+                 ? std::optional<StringRef>("GroupNonUniformFAdd")
+                 : std::nullopt;
+    if (!elemTy.isa<IntegerType>())
+      return std::nullopt;
+    switch (rmwOp) {
+    case RMWOp::ADD:
+      return "GroupNonUniformIAdd";
+    case RMWOp::MAX:
+      return "GroupNonUniformSMax";
+    case RMWOp::MIN:
+      return "GroupNonUniformSMin";
+    case RMWOp::UMAX:
+      return "GroupNonUniformUMax";
+    case RMWOp::UMIN:
+      return "GroupNonUniformUMin";
+    case RMWOp::AND:
+      return "GroupNonUniformBitwiseAnd";
+    case RMWOp::OR:
+      return "GroupNonUniformBitwiseOr";
+    case RMWOp::XOR:
+      return "GroupNonUniformBitwiseXor";
+    default:
+      return std::nullopt;
+    }
+  }
+
+  static Value getIdentity(ConversionPatternRewriter &rewriter, Location loc,
+                           RMWOp rmwOp, Type elemTy) {
+    if (rmwOp == RMWOp::FADD)
+      return rewriter.create<LLVM::ConstantOp>(
+          loc, elemTy, rewriter.getFloatAttr(elemTy, 0.0));
+    unsigned bitWidth = elemTy.getIntOrFloatBitWidth();
+    APInt identity = APInt::getZero(bitWidth);
+    switch (rmwOp) {
+    case RMWOp::AND:
+    case RMWOp::UMIN:
+      identity = APInt::getAllOnes(bitWidth);
+      break;
+    case RMWOp::MAX:
+      identity = APInt::getSignedMinValue(bitWidth);
+      break;
+    case RMWOp::MIN:
+      identity = APInt::getSignedMaxValue(bitWidth);
+      break;
+    default:
+      break;
+    }
+    return rewriter.create<LLVM::ConstantOp>(
+        loc, elemTy, rewriter.getIntegerAttr(elemTy, identity));
+  }
+};
+
+// tt.local_load and tt.local_store access the elements of a buffer of the
+// shared memory one by one, at their linear offset in row-major order, either
+// given by the offsets or of their index in the buffer. The barriers ordering
+// the accesses of the threads are inserted by the membar analysis.
+template <typename SourceOp>
+struct LocalAccessOpConversionBase
+    : public ConvertTritonGPUOpToLLVMPattern<SourceOp> {
+  using ConvertTritonGPUOpToLLVMPattern<
+      SourceOp>::ConvertTritonGPUOpToLLVMPattern;
+
+protected:
+  // Return the addresses of the elements of `valueTy`, in the order of their
+  // registers, in `buffer`, `llBuffer` once lowered.
+  SmallVector<Value> getElementPtrs(Location loc, Value buffer, Value llBuffer,
+                                    Value offsets, Value llOffsets,
+                                    RankedTensorType valueTy,
+                                    ConversionPatternRewriter &rewriter) const {
+    auto bufferTy = buffer.getType().cast<RankedTensorType>();
+    Type elemTy =
+        this->getTypeConverter()->convertType(bufferTy.getElementType());
+    auto smemObj =
+        getSharedMemoryObjectFromStruct(loc, llBuffer, elemTy, rewriter);
+    SmallVector<Value> linearOffsets;
+    if (offsets) {
+      linearOffsets = this->getTypeConverter()->unpackLLElements(
+          loc, llOffsets, rewriter);
+    } else {
+      SmallVector<unsigned> shape(bufferTy.getShape().begin(),
+                                  bufferTy.getShape().end());
+      SmallVector<unsigned> order;
+      for (unsigned dim = shape.size(); dim-- > 0;)
+        order.push_back(dim);
+      for (SmallVector<Value> &index : this->emitIndices(
+               loc, rewriter, valueTy.getEncoding(), valueTy, false))
+        linearOffsets.push_back(linearize(rewriter, loc, index, shape, order));
+    }
+    auto ptrTy = ptr_ty(rewriter.getContext(), 3);
+    SmallVector<Value> ptrs;
+    for (Value offset : linearOffsets)
+      ptrs.push_back(gep(ptrTy, elemTy, smemObj.base, offset));
+    return ptrs;
+  }
+
+  // Whether the elements of the offsets, if any, and of `valueTy` are held by
+  // the same registers.
+  bool haveSameLayout(Value offsets, RankedTensorType valueTy) const {
+    return !offsets ||
+           offsets.getType().cast<RankedTensorType>().getEncoding() ==
+               valueTy.getEncoding();
+  }
+};
+
+struct LocalLoadOpConversion
+    : public LocalAccessOpConversionBase<triton::LocalLoadOp> {
+  using LocalAccessOpConversionBase<
+      triton::LocalLoadOp>::LocalAccessOpConversionBase;
+
+  LogicalResult
+  matchAndRewrite(triton::LocalLoadOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto resultTy = op.getType().cast<RankedTensorType>();
+    if (!haveSameLayout(op.getOffsets(), resultTy))
+      return rewriter.notifyMatchFailure(
+          op, "the offsets and the result have different layouts");
+    Type elemTy = getTypeConverter()->convertType(resultTy.getElementType());
+    SmallVector<Value> values;
+    for (Value ptr :
+         getElementPtrs(loc, op.getBuffer(), adaptor.getBuffer(),
+                        op.getOffsets(), adaptor.getOffsets(), resultTy,
+                        rewriter))
+      values.push_back(load(elemTy, ptr));
+    Value result =
+        getTypeConverter()->packLLElements(loc, values, rewriter, resultTy);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
+struct LocalStoreOpConversion
+    : public LocalAccessOpConversionBase<triton::LocalStoreOp> {
+  using LocalAccessOpConversionBase<
+      triton::LocalStoreOp>::LocalAccessOpConversionBase;
+
+  LogicalResult
+  matchAndRewrite(triton::LocalStoreOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto valueTy = op.getValue().getType().cast<RankedTensorType>();
+    if (!haveSameLayout(op.getOffsets(), valueTy))
+      return rewriter.notifyMatchFailure(
+          op, "the offsets and the value have different layouts");
+    SmallVector<Value> values =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getValue(), rewriter);
+    SmallVector<Value> ptrs =
+        getElementPtrs(loc, op.getBuffer(), adaptor.getBuffer(),
+                       op.getOffsets(), adaptor.getOffsets(), valueTy,
+                       rewriter);
+    for (auto [value, ptr] : llvm::zip(values, ptrs))
+      store(value, ptr);
+    rewriter.eraseOp(op);
+    return success();
+  }
 };
 
 struct InsertSliceOpConversion
@@ -2053,10 +2923,18 @@ void mlir::triton::populateLoadStoreOpToLLVMPatterns(
                                  benefit);
   patterns.add<StoreOpConversion>(typeConverter, axisInfoAnalysis, target,
                                   benefit);
+  // Loads and stores through block pointers are lowered to 2D block IO in
+  // priority, and fall back to the generic lowering otherwise.
+  patterns.add<BlockPointerLoadOpConversion, LoadPagesOpConversion,
+               BlockPointerStoreOpConversion>(
+      typeConverter, target, benefit.getBenefit() + 1);
+  patterns.add<PrefetchOpConversion>(typeConverter, target, benefit);
   patterns.add<AtomicCASOpConversion>(typeConverter, axisInfoAnalysis, target,
                                       benefit);
   patterns.add<AtomicRMWOpConversion>(typeConverter, axisInfoAnalysis, target,
                                       benefit);
+  patterns.add<LocalLoadOpConversion, LocalStoreOpConversion>(
+      typeConverter, target, benefit);
   patterns.add<InsertSliceOpConversion>(typeConverter, target, benefit);
   patterns.add<InsertSliceAsyncOpConversion>(typeConverter, axisInfoAnalysis,
                                              target, benefit);
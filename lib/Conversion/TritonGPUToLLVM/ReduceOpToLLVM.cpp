@@ -7,10 +7,13 @@
 using namespace mlir;
 using namespace mlir::triton;
 
+using ::mlir::LLVM::createSPIRVGroupOp;
 using ::mlir::LLVM::delinearize;
 using ::mlir::LLVM::linearize;
 using ::mlir::LLVM::loadShared;
+using ::mlir::LLVM::matchSPIRVGroupOp;
 using ::mlir::LLVM::shflSync;
+using ::mlir::LLVM::SPIRVGroupOperation;
 using ::mlir::LLVM::storeShared;
 using ::mlir::triton::gpu::getOrder;
 using ::mlir::triton::gpu::getTotalElemsPerThread;
@@ -181,6 +184,203 @@ private:
     return std::nullopt;
   }
 
+  // The combine function of the reductions with indices of tl.argmax and
+  // tl.argmin, which keeps the larger, or the smaller, of two values with
+  // its index, and the smaller index of equal values when `isTieBreakLeft`.
+  struct ArgReduceKind {
+    bool isMax;
+    bool isFloat;
+    bool isSigned;
+    bool isTieBreakLeft;
+  };
+
+  // Check if the reduction is an argmax or an argmin of a value of at most 32
+  // bits and of an i32 index, whose pair can be packed into 64 bits.
+  std::optional<ArgReduceKind> matchArgReduce(triton::ReduceOp op) const {
+    if (op.getNumOperands() != 2 || op.getNumResults() != 2)
+      return std::nullopt;
+    Block *block = &(*op.getCombineOp().begin());
+    Value value1 = block->getArgument(0), index1 = block->getArgument(1);
+    Value value2 = block->getArgument(2), index2 = block->getArgument(3);
+    Type valueTy = value1.getType();
+    // bfloat16 and the float8 types are stored as integers.
+    bool isFloat = valueTy.isa<FloatType>();
+    if ((isFloat && !valueTy.isF16() && !valueTy.isF32()) ||
+        (!isFloat && (!valueTy.isInteger() ||
+                      valueTy.getIntOrFloatBitWidth() > 32)) ||
+        !index1.getType().isInteger(32))
+      return std::nullopt;
+
+    Operation *yield = block->getTerminator();
+    auto valueSelect = yield->getOperand(0).getDefiningOp<arith::SelectOp>();
+    auto indexSelect = yield->getOperand(1).getDefiningOp<arith::SelectOp>();
+    if (!valueSelect || !indexSelect ||
+        valueSelect.getCondition() != indexSelect.getCondition() ||
+        valueSelect.getTrueValue() != value1 ||
+        valueSelect.getFalseValue() != value2 ||
+        indexSelect.getTrueValue() != index1 ||
+        indexSelect.getFalseValue() != index2)
+      return std::nullopt;
+
+    // Whether `cond` compares the values as `value1 > value2` or
+    // `value1 < value2`.
+    auto matchValueCmp = [&](Value cond) -> std::optional<ArgReduceKind> {
+      if (auto cmpf = cond.getDefiningOp<arith::CmpFOp>()) {
+        if (cmpf.getLhs() != value1 || cmpf.getRhs() != value2)
+          return std::nullopt;
+        if (cmpf.getPredicate() == arith::CmpFPredicate::OGT)
+          return ArgReduceKind{true, true, true, false};
+        if (cmpf.getPredicate() == arith::CmpFPredicate::OLT)
+          return ArgReduceKind{false, true, true, false};
+        return std::nullopt;
+      }
+      auto cmpi = cond.getDefiningOp<arith::CmpIOp>();
+      if (!cmpi || cmpi.getLhs() != value1 || cmpi.getRhs() != value2)
+        return std::nullopt;
+      switch (cmpi.getPredicate()) {
+      case arith::CmpIPredicate::sgt:
+        return ArgReduceKind{true, false, true, false};
+      case arith::CmpIPredicate::ugt:
+        return ArgReduceKind{true, false, false, false};
+      case arith::CmpIPredicate::slt:
+        return ArgReduceKind{false, false, true, false};
+      case arith::CmpIPredicate::ult:
+        return ArgReduceKind{false, false, false, false};
+      default:
+        return std::nullopt;
+      }
+    };
+    // Whether `cond` is `value1 == value2 and index1 < index2`.
+    auto isTie = [&](Value cond) {
+      auto andOp = cond.getDefiningOp<arith::AndIOp>();
+      if (!andOp)
+        return false;
+      auto isValueEq = [&](Value v) {
+        if (auto cmpf = v.getDefiningOp<arith::CmpFOp>())
+          return cmpf.getPredicate() == arith::CmpFPredicate::OEQ &&
+                 cmpf.getLhs() == value1 && cmpf.getRhs() == value2;
+        auto cmpi = v.getDefiningOp<arith::CmpIOp>();
+        return cmpi && cmpi.getPredicate() == arith::CmpIPredicate::eq &&
+               cmpi.getLhs() == value1 && cmpi.getRhs() == value2;
+      };
+      auto isIndexLt = [&](Value v) {
+        auto cmpi = v.getDefiningOp<arith::CmpIOp>();
+        return cmpi && cmpi.getPredicate() == arith::CmpIPredicate::slt &&
+               cmpi.getLhs() == index1 && cmpi.getRhs() == index2;
+      };
+      return (isValueEq(andOp.getLhs()) && isIndexLt(andOp.getRhs())) ||
+             (isIndexLt(andOp.getLhs()) && isValueEq(andOp.getRhs()));
+    };
+
+    Value cond = valueSelect.getCondition();
+    if (auto kind = matchValueCmp(cond))
+      return kind;
+    auto orOp = cond.getDefiningOp<arith::OrIOp>();
+    if (!orOp)
+      return std::nullopt;
+    std::optional<ArgReduceKind> kind;
+    if (isTie(orOp.getRhs()))
+      kind = matchValueCmp(orOp.getLhs());
+    else if (isTie(orOp.getLhs()))
+      kind = matchValueCmp(orOp.getRhs());
+    if (kind)
+      kind->isTieBreakLeft = true;
+    return kind;
+  }
+
+  // Pack the value and the index of an argmax or an argmin into 64 bits,
+  // ordered as unsigned integers as the pairs are by the combine function:
+  // the value, mapped to an unsigned key of the same order, in the upper
+  // half, and the index in the lower half, inverted for argmax so that the
+  // smaller index of equal values is the larger. The NaNs are ordered above
+  // the infinities, -0.0 is packed as 0.0.
+  Value packArgReduce(ConversionPatternRewriter &rewriter, Location loc,
+                      const ArgReduceKind &kind, Value value,
+                      Value index) const {
+    Type valueTy = value.getType();
+    unsigned bitwidth = valueTy.getIntOrFloatBitWidth();
+    Type intTy = int_ty(bitwidth);
+    Value signMask = rewriter.create<LLVM::ConstantOp>(
+        loc, intTy,
+        rewriter.getIntegerAttr(intTy, APInt::getSignMask(bitwidth)));
+    Value key = value;
+    if (kind.isFloat) {
+      Value zero = rewriter.create<LLVM::ConstantOp>(
+          loc, valueTy, rewriter.getFloatAttr(valueTy, 0.0));
+      value = select(fcmp_eq(value, zero), zero, value);
+      Value bits = bitcast(value, intTy);
+      Value isNegative = icmp_slt(bits, int_val(bitwidth, 0));
+      key = xor_(bits, select(isNegative, int_val(bitwidth, -1), signMask));
+    } else if (kind.isSigned) {
+      key = xor_(value, signMask);
+    }
+    Value packed = shl(zext(i64_ty, key), int_val(64, 32));
+    if (kind.isMax)
+      index = xor_(index, i32_val(-1));
+    return or_(packed, zext(i64_ty, index));
+  }
+
+  // Unpack the value and the index of `packed` into `acc`.
+  void unpackArgReduce(ConversionPatternRewriter &rewriter, Location loc,
+                       const ArgReduceKind &kind, Value packed,
+                       SmallVector<Value> &acc) const {
+    Type valueTy = acc[0].getType();
+    unsigned bitwidth = valueTy.getIntOrFloatBitWidth();
+    Type intTy = int_ty(bitwidth);
+    Value signMask = rewriter.create<LLVM::ConstantOp>(
+        loc, intTy,
+        rewriter.getIntegerAttr(intTy, APInt::getSignMask(bitwidth)));
+    Value key = trunc(i32_ty, lshr(packed, int_val(64, 32)));
+    if (bitwidth < 32)
+      key = trunc(intTy, key);
+    if (kind.isFloat) {
+      // The keys of the non-negative values have their sign bit set.
+      Value isNonNegative = icmp_slt(key, int_val(bitwidth, 0));
+      Value bits =
+          xor_(key, select(isNonNegative, signMask, int_val(bitwidth, -1)));
+      acc[0] = bitcast(bits, valueTy);
+    } else if (kind.isSigned) {
+      acc[0] = xor_(key, signMask);
+    } else {
+      acc[0] = key;
+    }
+    Value index = trunc(i32_ty, packed);
+    acc[1] = kind.isMax ? xor_(index, i32_val(-1)) : index;
+  }
+
+  // Reduce the argmax or the argmin `acc` across the given number of lanes
+  // as a single 64-bit unsigned max or min, with a sub-group reduction for
+  // contiguous lanes.
+  void warpArgReduce(ConversionPatternRewriter &rewriter, Location loc,
+                     SmallVector<Value> &acc, triton::ReduceOp op,
+                     const ArgReduceKind &kind, unsigned numLaneToReduce,
+                     unsigned interleave, Target target) const {
+    if (numLaneToReduce == 1)
+      return;
+    Value packed = packArgReduce(rewriter, loc, kind, acc[0], acc[1]);
+    auto mod = op->getParentOfType<ModuleOp>();
+    unsigned threadsPerWarp =
+        triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+    StringRef opName =
+        kind.isMax ? "GroupNonUniformUMax" : "GroupNonUniformUMin";
+    if (interleave == 1 && numLaneToReduce == threadsPerWarp) {
+      packed = createSPIRVGroupOp(loc, rewriter, opName,
+                                  SPIRVGroupOperation::Reduce, packed);
+    } else if (interleave == 1 && llvm::isPowerOf2_32(numLaneToReduce)) {
+      packed = createSPIRVGroupOp(loc, rewriter, opName,
+                                  SPIRVGroupOperation::ClusteredReduce, packed,
+                                  numLaneToReduce);
+    } else {
+      for (unsigned N = numLaneToReduce / 2; N > 0; N >>= 1) {
+        Value shfl = shflSync(loc, rewriter, packed, N * interleave, target);
+        Value keepShfl =
+            kind.isMax ? icmp_ugt(shfl, packed) : icmp_ult(shfl, packed);
+        packed = select(keepShfl, shfl, packed);
+      }
+    }
+    unpackArgReduce(rewriter, loc, kind, packed, acc);
+  }
+
   // Reduce along op axis for elements that are in the same thread. The
   // accumulated value is stored in accs.
   void reduceWithinThreads(
@@ -214,7 +414,34 @@ private:
                   SmallVector<Value> &acc, triton::ReduceOp op,
                   unsigned numLaneToReduce, unsigned interleave,
                   Target target) const {
-    if (target != Target::GENX) {
+    if (target == Target::GENX) {
+      // Reduce the pairs of an argmax or an argmin packed into one value,
+      // rather than with two shuffles and the combine function per step.
+      if (std::optional<ArgReduceKind> kind = matchArgReduce(op)) {
+        warpArgReduce(rewriter, loc, acc, op, *kind, numLaneToReduce,
+                      interleave, target);
+        return;
+      }
+      // Reduce contiguous lanes with a single sub-group reduction, clustered
+      // when only part of the sub-group is reduced.
+      std::optional<StringRef> opName = matchSPIRVGroupOp(op.getCombineOp());
+      if (opName && acc.size() == 1 && interleave == 1) {
+        auto mod = op->getParentOfType<ModuleOp>();
+        unsigned threadsPerWarp =
+            triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+        if (numLaneToReduce == threadsPerWarp) {
+          acc[0] = createSPIRVGroupOp(loc, rewriter, *opName,
+                                      SPIRVGroupOperation::Reduce, acc[0]);
+          return;
+        }
+        if (numLaneToReduce > 1 && llvm::isPowerOf2_32(numLaneToReduce)) {
+          acc[0] = createSPIRVGroupOp(loc, rewriter, *opName,
+                                      SPIRVGroupOperation::ClusteredReduce,
+                                      acc[0], numLaneToReduce);
+          return;
+        }
+      }
+    } else {
       if (auto kind = matchReduxKind(op)) {
         // Based on benchmarking on A100 redux op gives a speed up only when
         // doing a single reduction (not partitioned) and when the mask is
@@ -316,6 +543,26 @@ private:
     auto order = getOrder(srcLayout);
     SmallVector<Value> multiDimWarpId;
 
+    // The warps of the DPAS layouts aren't ordered as their elements, and
+    // wrap around the dimensions with fewer tiles than warps.
+    auto sliceLayout = srcLayout.dyn_cast<SliceEncodingAttr>();
+    Attribute layout = sliceLayout ? sliceLayout.getParent() : srcLayout;
+    if (auto dpasLayout = layout.dyn_cast<DpasEncodingAttr>()) {
+      SmallVector<int64_t> shape(srcShape.begin(), srcShape.end());
+      if (sliceLayout)
+        shape = sliceLayout.paddedShape(srcShape);
+      multiDimWarpId =
+          delinearize(rewriter, loc, warpId, dpasLayout.getWarpsPerCTA(),
+                      dpasLayout.getWarpOrder());
+      SmallVector<unsigned> warpsPerCTA =
+          triton::gpu::getWarpsPerCTAWithUniqueData(dpasLayout, shape);
+      for (unsigned d = 0; d < warpsPerCTA.size(); ++d)
+        multiDimWarpId[d] = urem(multiDimWarpId[d], i32_val(warpsPerCTA[d]));
+      if (sliceLayout)
+        multiDimWarpId.erase(multiDimWarpId.begin() + sliceLayout.getDim());
+      return multiDimWarpId;
+    }
+
     // 2x2 warps with slice dim = 0, warpId = 2 ends up writing at the same
     // address as warpId = 0 since the warpsPerCTA is [1, 2], need to figure out
     // a way to properly delinearize warpId in the slice case
@@ -343,10 +590,10 @@ private:
     triton::ReduceOp op = helper.getOperation();
     Location loc = op.getLoc();
     Value threadId = getThreadId(rewriter, loc);
-    Value warpSize = i32_val(32);
+    auto srcLayout = helper.getSrcLayout();
+    Value warpSize = i32_val(triton::gpu::getWarpSize(srcLayout));
     Value warpId = udiv(threadId, warpSize);
     Value laneId = urem(threadId, warpSize);
-    auto srcLayout = helper.getSrcLayout();
     auto srcShape = helper.getSrcShape();
     unsigned axis = op.getAxis();
     auto smemShape = helper.getScratchConfig();
@@ -396,7 +643,7 @@ private:
     Location loc = op.getLoc();
 
     Value threadId = getThreadId(rewriter, loc);
-    Value warpSize = i32_val(32);
+    Value warpSize = i32_val(triton::gpu::getWarpSize(srcLayout));
     Value laneId = urem(threadId, warpSize);
     Value zero = i32_val(0);
 
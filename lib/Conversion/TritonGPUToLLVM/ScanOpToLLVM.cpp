@@ -5,10 +5,13 @@
 using namespace mlir;
 using namespace mlir::triton;
 
+using ::mlir::LLVM::createSPIRVGroupOp;
 using ::mlir::LLVM::delinearize;
 using ::mlir::LLVM::linearize;
+using ::mlir::LLVM::matchSPIRVGroupOp;
 using ::mlir::LLVM::shflIdxSync;
 using ::mlir::LLVM::shflUpSync;
+using ::mlir::LLVM::SPIRVGroupOperation;
 using ::mlir::LLVM::storeShared;
 using ::mlir::triton::gpu::getTotalElemsPerThread;
 
@@ -78,11 +81,25 @@ static void warpScan(SmallVector<SmallVector<Value>> &srcValues,
   unsigned elementStride = helper.getAxisElementStride();
   unsigned threadStride = helper.getAxisThreadStride();
   unsigned scanDim = helper.getAxisNumThreadsPerWarpWithUniqueData();
+  // On GENX the scan across a whole sub-group can be done by a single
+  // sub-group inclusive scan when the combine op has a SPIR-V equivalent.
+  std::optional<StringRef> groupOpName;
+  if (target == Target::GENX && helper.getNumOperands() == 1 &&
+      threadStride == 1 &&
+      scanDim == triton::gpu::getWarpSize(helper.getEncoding()))
+    groupOpName = matchSPIRVGroupOp(helper.getCombineOp());
   for (unsigned srcIndex = 0; srcIndex < srcValues.size(); srcIndex++) {
     unsigned elementIdx = (srcIndex / elementStride) % scanElementsPerThreads;
     // Only consider the last element of each contiguous chunk of elements.
     if (elementIdx != scanElementsPerThreads - 1)
       continue;
+    if (groupOpName) {
+      srcValues[srcIndex][0] =
+          createSPIRVGroupOp(loc, rewriter, *groupOpName,
+                             SPIRVGroupOperation::InclusiveScan,
+                             srcValues[srcIndex][0]);
+      continue;
+    }
     // Reduce within warps.
     SmallVector<Value> acc = srcValues[srcIndex];
     for (unsigned i = 1; i <= scanDim / 2; i <<= 1) {
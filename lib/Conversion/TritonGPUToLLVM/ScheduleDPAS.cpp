@@ -0,0 +1,187 @@
+#include "mlir/Dialect/LLVMIR/GENXDialect.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Conversion/TritonGPUToLLVM/Passes.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file interleaves the loads with the DPAS of the GENX kernels. The
+// lowering of a `tt.dot` emits all its DPAS back to back, followed by the
+// loads of the operands of the next one, e.g. in the main loop of a GEMM:
+//
+//   dpas, dpas, ..., dpas, load A(k + 1), load B(k + 1), ...
+//
+// the sends of the next K-slice then only start once the whole slice has been
+// multiplied. The loads that don't feed the DPAS of their block are hoisted
+// between them instead, together with the address computations they depend
+// on, evenly spread over the DPAS:
+//
+//   dpas, load A(k + 1), dpas, load B(k + 1), dpas, ...
+//
+// so that the XMX units keep busy while the sends are in flight. The hoisted
+// loads keep their results live across the remaining DPAS: they are hoisted
+// while their results fit in a quarter of the registers of a work-item, i.e.
+// a budget depending on the GRF mode the kernel is built with.
+//===----------------------------------------------------------------------===//
+
+namespace mlir {
+namespace triton {
+#define GEN_PASS_DEF_SCHEDULEDPAS
+#include "triton/Conversion/TritonGPUToLLVM/Passes.h.inc"
+} // namespace triton
+} // namespace mlir
+
+#define DEBUG_TYPE "schedule-dpas"
+
+using namespace mlir;
+
+namespace {
+
+// The size in bytes of a general register of the devices with DPAS.
+constexpr unsigned grfSizeInBytes = 64;
+
+static bool isDPAS(Operation *op) {
+  if (isa<GENX::MatrixDPASOp>(op))
+    return true;
+  // The DPAS of 16-wide sub-groups are calls to the OpenCL matrix mad
+  // builtins.
+  auto call = dyn_cast<LLVM::CallOp>(op);
+  return call && call.getCallee() &&
+         call.getCallee()->contains("_matrix_mad_k");
+}
+
+static bool isLoad(Operation *op) {
+  if (auto load = dyn_cast<LLVM::LoadOp>(op))
+    return !load.getVolatile_();
+  return isa<GENX::Matrix2DBlockLoadOp, LLVM::MaskedLoadOp>(op);
+}
+
+static bool writesMemory(Operation *op) {
+  if (isDPAS(op) || isMemoryEffectFree(op))
+    return false;
+  auto effects = dyn_cast<MemoryEffectOpInterface>(op);
+  return !effects || effects.hasEffect<MemoryEffects::Write>() ||
+         effects.hasEffect<MemoryEffects::Free>();
+}
+
+static unsigned getSizeInBytes(Type type) {
+  if (auto vecTy = dyn_cast<VectorType>(type))
+    return vecTy.getNumElements() * getSizeInBytes(vecTy.getElementType());
+  if (type.isIntOrFloat())
+    return std::max(type.getIntOrFloatBitWidth() / 8, 1u);
+  // Pointers and aggregates.
+  return 8;
+}
+
+// Collect in `slice` the operations defining `op`'s operands after `pos` in
+// its block, in their order, if they can all be moved right before `pos`.
+static bool getHoistableSlice(Operation *op, Operation *pos,
+                              SetVector<Operation *> &slice) {
+  for (Value operand : op->getOperands()) {
+    Operation *def = operand.getDefiningOp();
+    if (!def || def->getBlock() != pos->getBlock() ||
+        def->isBeforeInBlock(pos) || slice.contains(def))
+      continue;
+    if (!isMemoryEffectFree(def) || def->getNumRegions() != 0 ||
+        !getHoistableSlice(def, pos, slice))
+      return false;
+    slice.insert(def);
+  }
+  return true;
+}
+
+static void scheduleBlock(Block &block, unsigned budget) {
+  SmallVector<Operation *> dpasOps;
+  for (Operation &op : block)
+    if (isDPAS(&op))
+      dpasOps.push_back(&op);
+  if (dpasOps.size() < 2)
+    return;
+
+  // Nothing is moved across a write to memory, e.g. a store to the shared
+  // local memory or a barrier.
+  for (Operation *op = dpasOps.front(); op != dpasOps.back();
+       op = op->getNextNode())
+    if (writesMemory(op))
+      return;
+  SmallVector<Operation *> loads;
+  for (Operation *op = dpasOps.back()->getNextNode(); op;
+       op = op->getNextNode()) {
+    if (writesMemory(op))
+      break;
+    if (isLoad(op))
+      loads.push_back(op);
+  }
+  if (loads.empty())
+    return;
+
+  // Hoist the k-th load before the DPAS of the k-th of as many even steps as
+  // there are loads, or later if its operands aren't available there.
+  unsigned numGaps = dpasOps.size() - 1;
+  unsigned inFlight = 0;
+  unsigned gap = 0;
+  for (auto [k, load] : llvm::enumerate(loads)) {
+    unsigned size = 0;
+    for (Type type : load->getResultTypes())
+      size += getSizeInBytes(type);
+    if (inFlight + size > budget)
+      break;
+    gap = std::max<unsigned>(gap, k * numGaps / loads.size());
+    for (; gap < numGaps; ++gap) {
+      Operation *pos = dpasOps[gap + 1];
+      SetVector<Operation *> slice;
+      if (!getHoistableSlice(load, pos, slice))
+        continue;
+      LLVM_DEBUG(llvm::dbgs() << "hoisting before DPAS " << gap + 1 << ": "
+                              << *load << "\n");
+      for (Operation *op : slice)
+        op->moveBefore(pos);
+      load->moveBefore(pos);
+      inFlight += size;
+      break;
+    }
+    if (gap == numGaps)
+      break;
+  }
+}
+
+struct ScheduleDPAS
+    : public mlir::triton::impl::ScheduleDPASBase<ScheduleDPAS> {
+  using ScheduleDPASBase<ScheduleDPAS>::ScheduleDPASBase;
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    unsigned threadsPerWarp =
+        triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+    unsigned budget = numGRF * grfSizeInBytes / threadsPerWarp / 4;
+    mod.walk([&](LLVM::LLVMFuncOp func) {
+      for (Block &block : func.getBody())
+        scheduleBlock(block, budget);
+    });
+  }
+};
+
+} // namespace
+
+namespace mlir {
+
+namespace triton {
+
+namespace gpu {
+
+std::unique_ptr<OperationPass<ModuleOp>> createScheduleDPASPass() {
+  return std::make_unique<ScheduleDPAS>();
+}
+std::unique_ptr<OperationPass<ModuleOp>>
+createScheduleDPASPass(const ScheduleDPASOptions &options) {
+  return std::make_unique<ScheduleDPAS>(options);
+}
+
+} // namespace gpu
+
+} // namespace triton
+
+} // namespace mlir
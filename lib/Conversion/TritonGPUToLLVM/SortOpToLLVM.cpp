@@ -0,0 +1,254 @@
+#include "PatternTritonGPUOpToLLVM.h"
+#include "triton/Analysis/Utility.h"
+
+using namespace mlir;
+using namespace mlir::triton;
+
+using ::mlir::LLVM::getSharedMemoryBase;
+using ::mlir::LLVM::linearize;
+using ::mlir::LLVM::shflSync;
+
+//===----------------------------------------------------------------------===//
+// tt.sort and tt.topk are lowered to a bitonic network along the axis of their
+// operand. Each stage of the network sorts the blocks of `blockSize` elements
+// along the axis, alternately in ascending and descending order, by comparing
+// and exchanging the elements at `distance` = blockSize / 2, ..., 2, 1. The
+// elements at a distance are exchanged, as given by SortLoweringHelper:
+//   * Register: within the registers of a thread, for the distances of the
+//     elements of a thread,
+//   * SubGroup: with a sub-group shuffle, for the distances of the lanes of a
+//     warp,
+//   * SharedMemory: through the shared memory, for the distances of the warps,
+//     the only exchanges with barriers.
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+using Exchange = SortLoweringHelper::Exchange;
+
+template <typename SourceOp>
+class SortOpConversionBase : public ConvertTritonGPUOpToLLVMPattern<SourceOp> {
+public:
+  using ConvertTritonGPUOpToLLVMPattern<
+      SourceOp>::ConvertTritonGPUOpToLLVMPattern;
+
+protected:
+  // Whether the elements of `srcTy` are compared by the lowering, the
+  // elements stored as integers other than bfloat16 aren't.
+  bool isSupportedElementType(RankedTensorType srcTy) const {
+    Type elemTy = srcTy.getElementType();
+    Type llvmElemTy = this->getTypeConverter()->convertType(elemTy);
+    return !elemTy.isa<FloatType>() || llvmElemTy.isa<FloatType>() ||
+           elemTy.isBF16();
+  }
+
+  // Return the shared memory of the elements of `srcTy`, one per element in
+  // row-major order.
+  Value getSharedMemoryElement(Location loc,
+                               ConversionPatternRewriter &rewriter,
+                               Value smemBase, RankedTensorType srcTy,
+                               ArrayRef<Value> index) const {
+    SmallVector<unsigned> shape(srcTy.getShape().begin(),
+                                srcTy.getShape().end());
+    Type elemTy = this->getTypeConverter()->convertType(srcTy.getElementType());
+    auto ptrTy = LLVM::LLVMPointerType::get(rewriter.getContext(), 3);
+    return gep(ptrTy, elemTy, smemBase, linearize(rewriter, loc, index, shape));
+  }
+
+  // Sort `values`, the elements of the thread of the operand of `helper`, in
+  // place along the axis. `smemBase` is the scratch buffer of the op, if any.
+  void sortElements(SortLoweringHelper &helper, SmallVector<Value> &values,
+                    bool descending, Value smemBase,
+                    ConversionPatternRewriter &rewriter) const {
+    Location loc = helper.getLoc();
+    RankedTensorType srcTy = helper.getSrcType();
+    unsigned axis = helper.getAxis();
+    unsigned axisSize = srcTy.getDimSize(axis);
+    Attribute encoding = srcTy.getEncoding();
+    bool isBlocked = encoding.isa<triton::gpu::BlockedEncodingAttr>();
+    bool isBF16 = srcTy.getElementType().isBF16();
+    bool isFloat = srcTy.getElementType().isa<FloatType>();
+    Type elemTy = this->getTypeConverter()->convertType(srcTy.getElementType());
+
+    SmallVector<SmallVector<Value>> indices =
+        this->emitIndices(loc, rewriter, encoding, srcTy, false);
+    // The registers of the thread by the offset of their elements, the
+    // thread's base index having no bit of the Register distances.
+    SmallVector<SmallVector<unsigned>> offsets;
+    std::map<SmallVector<unsigned>, unsigned> registerOf;
+    if (isBlocked) {
+      offsets = this->emitOffsetForLayout(encoding, srcTy);
+      for (unsigned i = 0; i < offsets.size(); ++i)
+        registerOf[offsets[i]] = i;
+    }
+    auto getExchange = [&](unsigned distance) {
+      return isBlocked ? helper.getExchange(distance) : Exchange::SharedMemory;
+    };
+
+    // bfloat16 is stored as int16, its elements are compared as float32.
+    auto getKey = [&](Value value) -> Value {
+      if (!isBF16)
+        return value;
+      return bitcast(shl(zext(i32_ty, value), i32_val(16)), f32_ty);
+    };
+    // Return the smaller and the larger of `a` and `b`.
+    auto minMax = [&](Value a, Value b) -> std::pair<Value, Value> {
+      Value aKey = getKey(a), bKey = getKey(b);
+      Value lt;
+      if (isFloat)
+        lt = fcmp_olt(aKey, bKey);
+      else
+        lt = icmp_slt(aKey, bKey);
+      return {select(lt, a, b), select(lt, b, a)};
+    };
+    // Return whether bit `bit` of the index along the axis of the element of
+    // register `i` is clear, statically for a bit of the Register distances.
+    auto isBitClear = [&](unsigned i, unsigned bit) -> Value {
+      if (bit >= axisSize)
+        return int_val(1, 1);
+      if (getExchange(bit) == Exchange::Register)
+        return int_val(1, (offsets[i][axis] & bit) == 0);
+      return icmp_eq(and_(indices[i][axis], i32_val(bit)), i32_val(0));
+    };
+    // Return whether the block of `blockSize` elements holding the element of
+    // register `i` is sorted in ascending order.
+    auto isAscending = [&](unsigned i, unsigned blockSize) -> Value {
+      Value clear = isBitClear(i, blockSize);
+      if (descending)
+        return xor_(clear, int_val(1, 1));
+      return clear;
+    };
+    // Keep the smaller or the larger of the element of register `i` and of its
+    // partner at `distance`, whether the element is the first of the pair and
+    // the block is sorted in ascending order.
+    auto compareExchange = [&](unsigned i, Value partner, unsigned distance,
+                               unsigned blockSize) {
+      auto [min, max] = minMax(values[i], partner);
+      Value keepMin =
+          icmp_eq(isBitClear(i, distance), isAscending(i, blockSize));
+      values[i] = select(keepMin, min, max);
+    };
+
+    for (unsigned blockSize = 2; blockSize <= axisSize; blockSize <<= 1) {
+      for (unsigned distance = blockSize / 2; distance >= 1; distance >>= 1) {
+        switch (getExchange(distance)) {
+        case Exchange::Register:
+          // Both elements of a pair are updated at once.
+          for (unsigned i = 0; i < values.size(); ++i) {
+            if (offsets[i][axis] & distance)
+              continue;
+            SmallVector<unsigned> partnerOffset = offsets[i];
+            partnerOffset[axis] ^= distance;
+            unsigned j = registerOf.at(partnerOffset);
+            auto [min, max] = minMax(values[i], values[j]);
+            Value ascending = isAscending(i, blockSize);
+            values[i] = select(ascending, min, max);
+            values[j] = select(ascending, max, min);
+          }
+          break;
+        case Exchange::SubGroup: {
+          unsigned laneDistance = helper.getLaneDistance(distance);
+          for (unsigned i = 0; i < values.size(); ++i) {
+            Value partner =
+                shflSync(loc, rewriter, values[i], laneDistance, this->target);
+            compareExchange(i, partner, distance, blockSize);
+          }
+          break;
+        }
+        case Exchange::SharedMemory: {
+          assert(smemBase && "expected the scratch buffer of the op");
+          for (unsigned i = 0; i < values.size(); ++i)
+            store(values[i], getSharedMemoryElement(loc, rewriter, smemBase,
+                                                     srcTy, indices[i]));
+          barrier();
+          SmallVector<Value> partners;
+          for (unsigned i = 0; i < values.size(); ++i) {
+            SmallVector<Value> partnerIndex = indices[i];
+            partnerIndex[axis] = xor_(partnerIndex[axis], i32_val(distance));
+            partners.push_back(
+                load(elemTy, getSharedMemoryElement(loc, rewriter, smemBase,
+                                                    srcTy, partnerIndex)));
+          }
+          // The buffer is written again by the next exchange.
+          barrier();
+          for (unsigned i = 0; i < values.size(); ++i)
+            compareExchange(i, partners[i], distance, blockSize);
+          break;
+        }
+        }
+      }
+    }
+  }
+};
+
+struct SortOpConversion : public SortOpConversionBase<triton::SortOp> {
+  using SortOpConversionBase<triton::SortOp>::SortOpConversionBase;
+
+  LogicalResult
+  matchAndRewrite(triton::SortOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    SortLoweringHelper helper(op);
+    if (!isSupportedElementType(helper.getSrcType()))
+      return rewriter.notifyMatchFailure(op, "unsupported element type");
+    SmallVector<Value> values =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    Value smemBase;
+    if (helper.getScratchSizeInBytes() > 0)
+      smemBase = getSharedMemoryBase(loc, rewriter, op.getOperation(), target);
+    sortElements(helper, values, op.getDescending(), smemBase, rewriter);
+    Value result = getTypeConverter()->packLLElements(loc, values, rewriter,
+                                                      op.getType());
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
+struct TopKOpConversion : public SortOpConversionBase<triton::TopKOp> {
+  using SortOpConversionBase<triton::TopKOp>::SortOpConversionBase;
+
+  LogicalResult
+  matchAndRewrite(triton::TopKOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    SortLoweringHelper helper(op);
+    RankedTensorType srcTy = helper.getSrcType();
+    if (!isSupportedElementType(srcTy))
+      return rewriter.notifyMatchFailure(op, "unsupported element type");
+    SmallVector<Value> values =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    Value smemBase =
+        getSharedMemoryBase(loc, rewriter, op.getOperation(), target);
+    sortElements(helper, values, /*descending=*/true, smemBase, rewriter);
+
+    // Gather the first k elements along the axis into the layout of the
+    // result.
+    SmallVector<SmallVector<Value>> indices =
+        emitIndices(loc, rewriter, srcTy.getEncoding(), srcTy, false);
+    for (unsigned i = 0; i < values.size(); ++i)
+      store(values[i], getSharedMemoryElement(loc, rewriter, smemBase, srcTy,
+                                               indices[i]));
+    barrier();
+    auto resultTy = op.getType().cast<RankedTensorType>();
+    Type elemTy = getTypeConverter()->convertType(srcTy.getElementType());
+    SmallVector<Value> results;
+    for (SmallVector<Value> &index :
+         emitIndices(loc, rewriter, resultTy.getEncoding(), resultTy, false))
+      results.push_back(load(elemTy, getSharedMemoryElement(
+                                         loc, rewriter, smemBase, srcTy, index)));
+    Value result =
+        getTypeConverter()->packLLElements(loc, results, rewriter, resultTy);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
+} // namespace
+
+void mlir::triton::populateSortOpToLLVMPatterns(
+    TritonGPUToLLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
+    int numWarps, ModuleAxisInfoAnalysis &axisInfoAnalysis, Target target,
+    PatternBenefit benefit) {
+  patterns.add<SortOpConversion, TopKOpConversion>(typeConverter, target,
+                                                    benefit);
+}
@@ -216,6 +216,29 @@ public:
   // Shared memory utilities
   // -----------------------------------------------------------------------
 
+  // Returns the number of elements a thread moves with one shared memory
+  // access, given the `contigPerThread` contiguous elements it holds along
+  // the fastest dimension of the shared tensor `sharedTy`.
+  unsigned getSharedAccessVec(unsigned contigPerThread,
+                              RankedTensorType sharedTy) const {
+    auto sharedLayout =
+        sharedTy.getEncoding().cast<triton::gpu::SharedEncodingAttr>();
+    if (target != Target::GENX)
+      return std::min(contigPerThread, sharedLayout.getVec());
+    // Without swizzling the contiguous elements of a thread stay contiguous
+    // in SLM whatever the vec of the shared layout.
+    unsigned vec = contigPerThread;
+    if (sharedLayout.getMaxPhase() > 1 || sharedLayout.getHasLeadingOffset())
+      vec = std::min(vec, sharedLayout.getVec());
+    // SLM block messages move up to 128 bits, and the accesses may not be
+    // aligned beyond the alignment of the buffer.
+    unsigned bitWidth = sharedTy.getElementTypeBitWidth();
+    auto bytes =
+        product<int64_t>(triton::gpu::getShapePerCTA(sharedTy)) * bitWidth / 8;
+    unsigned maxBytes = std::min<size_t>(16, getExplicitBufferAlignment(bytes));
+    return std::max(1u, std::min(vec, maxBytes * 8 / bitWidth));
+  }
+
   DenseMap<unsigned, Value>
   getSwizzledSharedPtrs(Location loc, unsigned inVec, RankedTensorType srcTy,
                         triton::gpu::SharedEncodingAttr resSharedLayout,
@@ -298,13 +321,22 @@ public:
     // cache for non-immediate offsets
     DenseMap<unsigned, Value> cacheCol, cacheRow;
     unsigned minVec = std::min(outVec, inVec);
+    // On GENX the accesses of unswizzled layouts are only bounded by `inVec`.
+    bool noSwizzling = target == Target::GENX && maxPhase == 1 &&
+                       !resSharedLayout.getHasLeadingOffset();
+    if (noSwizzling)
+      minVec = inVec;
     for (unsigned elemIdx = 0; elemIdx < numElems; elemIdx += minVec) {
       Value offset = i32_val(0);
       // Extract multi dimensional index for current element
       auto idx = srcIndices[elemIdx];
       Value idxCol = idx[outOrder[0]]; // contiguous dimension
       Value idxRow, strideRow;
-      if (outOrder.size() == 2) {
+      // The matrices of a batch, along the outermost dimension, are swizzled
+      // independently.
+      if (outOrder.size() == 3)
+        offset = mul(idx[outOrder[2]], srcStrides[outOrder[2]]);
+      if (outOrder.size() >= 2) {
         idxRow = idx[outOrder[1]]; // discontiguous dimension
         strideRow = srcStrides[outOrder[1]];
       } else {
@@ -358,14 +390,15 @@ public:
       Value colOffOrdered = urem(idxCol, i32_val(outVec));
       colOffOrdered = udiv(colOffOrdered, i32_val(minVec));
       colOffOrdered = mul(colOffOrdered, i32_val(minVec));
-      Value colOff = add(colOffSwizzled, colOffOrdered);
+      Value colOff =
+          noSwizzling ? idxCol : add(colOffSwizzled, colOffOrdered);
       // compute non-immediate offset
       offset = add(offset, add(rowOff, mul(colOff, strideCol)));
       Value currPtr = gep(dstPtrTy, getTypeConverter()->convertType(resElemTy),
                           dstPtrBase, offset);
       // compute immediate offset
       Value immediateOff;
-      if (outOrder.size() == 2) {
+      if (outOrder.size() >= 2) {
         immediateOff =
             add(mul(i32_val(immedateOffRow), srcStrides[outOrder[1]]),
                 i32_val(immedateOffCol));
@@ -406,8 +439,9 @@ public:
                           ? triton::gpu::getUniqueContigPerThread(
                                 dstDistributedLayout, dstShape)[outOrd[0]]
                           : 1;
-    unsigned inVec = srcSharedLayout.getVec();
-    unsigned minVec = std::min(outVec, inVec);
+    unsigned minVec = getSharedAccessVec(outVec, srcTy);
+    if (target == Target::GENX)
+      outVec = minVec;
     unsigned outElems = triton::gpu::getTotalElemsPerThread(dstTy);
     SmallVector<Value> offsetVals = {i32_val(0), i32_val(0)};
     assert(outElems == dstIndices.size());
@@ -439,7 +473,7 @@ public:
                                 ConversionPatternRewriter &rewriter) const {
     auto srcTy = src.getType().cast<RankedTensorType>();
     auto srcShape = srcTy.getShape();
-    assert(srcShape.size() == 2 &&
+    assert((srcShape.size() == 2 || srcShape.size() == 3) &&
            "Unexpected rank of storeDistributedToShared");
     auto dstTy = dst.getType().cast<RankedTensorType>();
     auto srcDistributedLayout = srcTy.getEncoding();
@@ -457,16 +491,17 @@ public:
                          ? triton::gpu::getUniqueContigPerThread(
                                srcDistributedLayout, srcShape)[inOrd[0]]
                          : 1;
-    unsigned outVec = dstSharedLayout.getVec();
-    unsigned minVec = std::min(outVec, inVec);
+    unsigned minVec = getSharedAccessVec(inVec, dstTy);
+    if (target == Target::GENX)
+      inVec = minVec;
     unsigned numElems = triton::gpu::getTotalElemsPerThread(srcTy);
     assert(numElems == srcIndices.size());
     auto inVals = getTypeConverter()->unpackLLElements(loc, llSrc, rewriter);
     auto wordTy = vec_ty(elemTy, minVec);
     Value word;
 
-    SmallVector<Value> srcStrides = {dstStrides[0], dstStrides[1]};
-    SmallVector<Value> offsetVals = {i32_val(0), i32_val(0)};
+    SmallVector<Value> srcStrides(dstStrides.begin(), dstStrides.end());
+    SmallVector<Value> offsetVals(srcShape.size(), i32_val(0));
     SharedMemoryObject smemObj(smemBase, elemTy, srcStrides, offsetVals);
 
     DenseMap<unsigned, Value> sharedPtrs =
@@ -503,7 +538,7 @@ public:
       auto warpsPerCTA = triton::gpu::getWarpsPerCTA(layout);
       auto order = triton::gpu::getOrder(layout);
       auto shapePerCTATile = triton::gpu::getShapePerCTATile(layout, shape);
-      Value warpSize = i32_val(32);
+      Value warpSize = i32_val(triton::gpu::getWarpSize(layout));
       Value laneId = urem(tid, warpSize);
       Value warpId = udiv(tid, warpSize);
       SmallVector<Value> multiDimWarpId =
@@ -685,17 +720,22 @@ public:
     llvm_unreachable("unsupported emitOffsetForLayout");
   }
 
+  // Emit the offsets of the elements of the thread in the repetition
+  // `ctaRepId` of the tile of the DPAS layout, one index per dimension.
   void emitDpasOffsetForCTA(const DpasEncodingAttr &dpasLayout,
                             SmallVector<SmallVector<unsigned>> &offsets,
-                            unsigned ctaOffsetX, unsigned ctaOffsetY) const {
+                            ArrayRef<unsigned> ctaRepId) const {
+    unsigned rank = dpasLayout.getRank();
     unsigned elemsPerThreadPerGroup =
-        triton::gpu::getContigPerThread(dpasLayout)[0];
-    unsigned warpSize = getWarpSize(dpasLayout);
+        triton::gpu::getContigPerThread(dpasLayout)[rank - 2];
     SmallVector<unsigned> shapePerCTA = getShapePerCTATile(dpasLayout);
 
     for (unsigned elem = 0; elem < elemsPerThreadPerGroup; elem++) {
-      offsets.push_back(
-          {ctaOffsetX * shapePerCTA[0] + elem, ctaOffsetY * shapePerCTA[1]});
+      SmallVector<unsigned> offset(rank);
+      for (unsigned d = 0; d < rank; ++d)
+        offset[d] = ctaRepId[d] * shapePerCTA[d];
+      offset[rank - 2] += elem;
+      offsets.push_back(offset);
     }
   }
 
@@ -746,7 +786,7 @@ private:
       const BlockedEncodingAttr &blockedLayout, RankedTensorType type) const {
     auto shape = type.getShape();
     Value threadId = getThreadId(rewriter, loc);
-    Value warpSize = i32_val(32);
+    Value warpSize = i32_val(triton::gpu::getWarpSize(blockedLayout));
     Value laneId = urem(threadId, warpSize);
     Value warpId = udiv(threadId, warpSize);
     auto sizePerThread = blockedLayout.getSizePerThread();
@@ -972,17 +1012,34 @@ private:
     Value warpId = udiv(threadId, warpSize);
     Value laneId = urem(threadId, warpSize);
 
-    SmallVector<Value> warpsPerCTA = {i32_val(dpasLayout.getWarpsPerCTA()[0]),
-                                      i32_val(dpasLayout.getWarpsPerCTA()[1])};
+    // The warps of a batched layout are distributed to the matrices of the
+    // batch first, the matrix of the warp is distributed as a 2D one.
+    SmallVector<Value> batchBase;
     ArrayRef<int64_t> shape = type.getShape();
+    SmallVector<unsigned> _warpsPerCTA = dpasLayout.getWarpsPerCTA();
+    if (dpasLayout.getRank() == 3) {
+      unsigned warpsPerMatrix = _warpsPerCTA[1] * _warpsPerCTA[2];
+      batchBase.push_back(
+          urem(urem(udiv(warpId, i32_val(warpsPerMatrix)),
+                    i32_val(_warpsPerCTA[0])),
+               i32_val(shape[0])));
+      warpId = urem(warpId, i32_val(warpsPerMatrix));
+      _warpsPerCTA.erase(_warpsPerCTA.begin());
+      shape = shape.drop_front();
+    }
+    SmallVector<Value> warpsPerCTA = {i32_val(_warpsPerCTA[0]),
+                                      i32_val(_warpsPerCTA[1])};
 
     // Compute the 2-dim coordinates of the warp containing the tensor element
     // operated on by this thread.
-    SmallVector<unsigned> warpShape = {8, 16};
-    Value rowWarpId =
-        urem(urem(warpId, warpsPerCTA[0]), i32_val(shape[0] / warpShape[0]));
+    SmallVector<unsigned> warpShape = {dpasLayout.getRepeatCount(),
+                                       dpasLayout.getExecutionSize()};
+    // The tensors smaller than the tile of a warp, e.g. the expanded results
+    // of the reductions, are held by the first warp of the dimension.
+    Value rowWarpId = urem(urem(warpId, warpsPerCTA[0]),
+                           i32_val(ceil<unsigned>(shape[0], warpShape[0])));
     Value colWarpId = urem(urem(udiv(warpId, warpsPerCTA[0]), warpsPerCTA[1]),
-                           i32_val(shape[1] / warpShape[1]));
+                           i32_val(ceil<unsigned>(shape[1], warpShape[1])));
     Value rowWarpOffset = mul(rowWarpId, i32_val(warpShape[0]));
     Value colWarpOffset = mul(colWarpId, i32_val(warpShape[1]));
 
@@ -990,13 +1047,16 @@ private:
     // on by this thread.
     SmallVector<unsigned> threadsPerWarp = getThreadsPerWarp(dpasLayout);
     SmallVector<unsigned> contigPerThread = getContigPerThread(dpasLayout);
-    SmallVector<Value> multiDimBase = {
-        add(mul(i32_val(contigPerThread[0]),
-                udiv(laneId, i32_val(threadsPerWarp[1]))),
-            rowWarpOffset),
-        add(mul(i32_val(contigPerThread[1]),
-                urem(laneId, i32_val(threadsPerWarp[1]))),
-            colWarpOffset)};
+    unsigned rank = dpasLayout.getRank();
+    SmallVector<Value> multiDimBase = batchBase;
+    multiDimBase.push_back(
+        add(mul(i32_val(contigPerThread[rank - 2]),
+                udiv(laneId, i32_val(threadsPerWarp[rank - 1]))),
+            rowWarpOffset));
+    multiDimBase.push_back(
+        add(mul(i32_val(contigPerThread[rank - 1]),
+                urem(laneId, i32_val(threadsPerWarp[rank - 1]))),
+            colWarpOffset));
     return multiDimBase;
   }
 
@@ -1062,10 +1122,23 @@ private:
     ArrayRef<int64_t> shape = type.getShape();
     SmallVector<SmallVector<unsigned>> offsets;
     SmallVector<unsigned> shapePerCTA = getShapePerCTATile(dpasLayout);
+    unsigned rank = shape.size();
 
-    for (unsigned i = 0; i < shape[0]; i += shapePerCTA[0]) {
-      for (unsigned j = 0; j < shape[1]; j += shapePerCTA[1]) {
-        emitDpasOffsetForCTA(dpasLayout, offsets, i, j);
+    // The repetitions of the batch dimension are the outermost ones.
+    unsigned numBatchReps =
+        rank == 3 ? ceil<unsigned>(shape[0], shapePerCTA[0]) : 1;
+    unsigned numRowReps =
+        ceil<unsigned>(shape[rank - 2], shapePerCTA[rank - 2]);
+    unsigned numColReps =
+        ceil<unsigned>(shape[rank - 1], shapePerCTA[rank - 1]);
+    for (unsigned b = 0; b < numBatchReps; ++b) {
+      for (unsigned i = 0; i < numRowReps; ++i) {
+        for (unsigned j = 0; j < numColReps; ++j) {
+          SmallVector<unsigned> ctaRepId = {i, j};
+          if (rank == 3)
+            ctaRepId.insert(ctaRepId.begin(), b);
+          emitDpasOffsetForCTA(dpasLayout, offsets, ctaRepId);
+        }
       }
     }
 
@@ -11,6 +11,7 @@
 #include "mlir/Dialect/LLVMIR/GENXDialect.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/LLVMIR/NVVMDialect.h"
+#include "mlir/Dialect/LLVMIR/ROCDLDialect.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "triton/Analysis/Allocation.h"
@@ -27,6 +28,8 @@
 
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 
+#include <set>
+
 namespace mlir {
 namespace triton {
 #define GEN_PASS_DEF_CONVERTTRITONGPUTOLLVM
@@ -381,7 +384,8 @@ struct ConvertTritonGPUToLLVM
 
     // Allocate shared memory and set barrier
     ModuleAllocation allocation(mod);
-    ModuleMembarAnalysis membarPass(&allocation);
+    ModuleMembarAnalysis membarPass(&allocation, target == Target::GENX,
+                                    target == Target::GENX);
     membarPass.run();
 
     /* Get tensorPtrMap before conversion */
@@ -499,6 +503,7 @@ struct ConvertTritonGPUToLLVM
     populatePatterns3(populateLoadStoreOpToLLVMPatterns);
     populatePatterns4(populateReduceOpToLLVMPatterns);
     populatePatterns1(populateScanOpToLLVMPatterns);
+    populatePatterns1(populateSortOpToLLVMPatterns);
     populatePatterns2(populateViewOpToLLVMPatterns);
     populatePatterns2(populateBarrierOpToLLVMPatterns);
     populatePatterns2(populateTensorPtrOpsToLLVMPatterns);
@@ -527,6 +532,9 @@ struct ConvertTritonGPUToLLVM
     if (failed(applyPartialConversion(mod, convTarget, std::move(patterns))))
       return signalPassFailure();
 
+    if (target == Target::NVVM)
+      prefetchTMADescriptors(mod, *tmaMetadata);
+
     // Fold CTAId when there is only 1 CTA.
     if (numCTAs == 1) {
       mod.walk([](triton::nvgpu::ClusterCTAIdOp id) {
@@ -540,6 +548,35 @@ struct ConvertTritonGPUToLLVM
 private:
   mlir::triton::gpu::TMAMetadataTy *tmaMetadata = nullptr;
 
+  // Prefetch the TMA descriptors at the entry of the kernels, so that the
+  // first TMA copies don't wait for the descriptors to be fetched from global
+  // memory.
+  void prefetchTMADescriptors(
+      ModuleOp mod,
+      const mlir::triton::gpu::TMAMetadataTy &tmaMetadata) const {
+    std::set<int> descArgIndices;
+    for (const mlir::triton::gpu::TMAInfo &info : tmaMetadata)
+      descArgIndices.insert(info.TMADescArgIdx);
+    if (descArgIndices.empty())
+      return;
+
+    mod.walk([&](LLVM::LLVMFuncOp funcOp) {
+      if (funcOp.isExternal() || !funcOp->hasAttr("nvvm.kernel"))
+        return;
+      Block &entry = funcOp.getBody().front();
+      OpBuilder builder(&entry, entry.begin());
+      for (int idx : descArgIndices) {
+        if (idx < 0 || idx >= static_cast<int>(entry.getNumArguments()))
+          continue;
+        PTXBuilder ptxBuilder;
+        auto &prefetch = *ptxBuilder.create<>("prefetch.tensormap");
+        prefetch(ptxBuilder.newAddrOperand(entry.getArgument(idx), "l"));
+        ptxBuilder.launch(builder, funcOp.getLoc(),
+                          LLVM::LLVMVoidType::get(mod.getContext()));
+      }
+    });
+  }
+
   void initSharedMemory(TritonGPUToLLVMTypeConverter &typeConverter,
                         Target target) {
     ModuleOp mod = getOperation();
@@ -100,6 +100,25 @@ Value TritonGPUToLLVMTypeConverter::packLLElements(
   return llvmStruct;
 }
 
+// Collects into `results` the elements inserted into `llvmStruct` by a chain
+// of insertvalue ops on an undef struct, as built by packLLElements. Returns
+// false unless the chain defines all the elements.
+static bool getInsertedElements(Value llvmStruct,
+                                SmallVectorImpl<Value> &results) {
+  Value container = llvmStruct;
+  while (auto insertOp = container.getDefiningOp<LLVM::InsertValueOp>()) {
+    ArrayRef<int64_t> position = insertOp.getPosition();
+    if (position.size() != 1)
+      return false;
+    // The last insertion of an element wins.
+    if (!results[position[0]])
+      results[position[0]] = insertOp.getValue();
+    container = insertOp.getContainer();
+  }
+  return container.getDefiningOp<LLVM::UndefOp>() &&
+         llvm::all_of(results, [](Value v) { return bool(v); });
+}
+
 SmallVector<Value> TritonGPUToLLVMTypeConverter::unpackLLElements(
     Location loc, Value llvmStruct, ConversionPatternRewriter &rewriter) {
   assert(bool(llvmStruct) && "can not unpack null values");
@@ -109,6 +128,12 @@ SmallVector<Value> TritonGPUToLLVMTypeConverter::unpackLLElements(
     return {llvmStruct};
   ArrayRef<Type> types =
       llvmStruct.getType().cast<LLVM::LLVMStructType>().getBody();
+  // Forward the elements of the structs packed by the producer instead of
+  // extracting them again: large tensors otherwise produce thousands of
+  // extractvalue ops that the LLVM pipeline has to fold.
+  SmallVector<Value> inserted(types.size());
+  if (getInsertedElements(llvmStruct, inserted))
+    return inserted;
   SmallVector<Value> results(types.size());
   for (unsigned i = 0; i < types.size(); ++i) {
     Type type = types[i];
@@ -131,7 +156,7 @@ Type TritonGPUToLLVMTypeConverter::getElementTypeForStruct(
     unsigned bitWidth = elemTy.getIntOrFloatBitWidth();
 
     if (dotOpLayout.getOpIdx() == 0) {
-      //  Elem. Type | vector size
+      //  Elem. Type | vector size (RC = 8)
       // ------------------------------
       //  f16/bf16   | vector<8xf16/bf16>
       //     i8      | vector<16xi8>
@@ -143,8 +168,10 @@ Type TritonGPUToLLVMTypeConverter::getElementTypeForStruct(
       //  f16/bf16   | vector<16xf16/bf16>
       //     i8      | vector<32xi8>
       //     tf32    | vector<8xf32>
+      // The B operand doesn't depend on the repeat count.
       assert(dotOpLayout.getOpIdx() == 1);
-      return vec_ty(elemTy, RC * ((8 * sizeof(int32_t)) / bitWidth));
+      unsigned SD = dpasParent.getSystolicDepth();
+      return vec_ty(elemTy, SD * ((8 * sizeof(int32_t)) / bitWidth));
     }
   }
 
@@ -1,8 +1,12 @@
 #include "Utility.h"
 #include "TypeConverter.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/LLVMIR/GENXDialect.h"
 #include "mlir/Dialect/LLVMIR/NVVMDialect.h"
+#include "mlir/Dialect/LLVMIR/ROCDLDialect.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "triton/Dialect/NVGPU/IR/Dialect.h"
+#include "llvm/ADT/TypeSwitch.h"
 namespace mlir {
 
 namespace LLVM {
@@ -183,6 +187,93 @@ getStridesFromShapeAndOrder(ArrayRef<int64_t> shape, ArrayRef<unsigned> order,
   return strides;
 }
 
+SmallVector<unsigned> getDedupIndices(RankedTensorType tensorTy,
+                                      SmallVector<int64_t> constancy,
+                                      size_t numElems) {
+  Attribute encoding = tensorTy.getEncoding();
+  if (!encoding)
+    // encoding not available
+    return {};
+  if (!encoding.dyn_cast<triton::gpu::BlockedEncodingAttr>() &&
+      !encoding.dyn_cast<triton::gpu::SliceEncodingAttr>()) {
+    // TODO: constraining the ecndoing type here is necessary
+    // for avoiding crashes in the triton::gpu::getElemsPerThread
+    // call below happening in the test_core::test_fp8_dot_acc
+    return {};
+  }
+
+  SmallVector<unsigned> elemsPerThread =
+      triton::gpu::getElemsPerThread(tensorTy);
+  int rank = elemsPerThread.size();
+  if (product<unsigned>(elemsPerThread) != numElems)
+    return {};
+  SmallVector<unsigned> sizePerThread =
+      triton::gpu::getSizePerThread(encoding);
+  if (rank != sizePerThread.size() || rank != constancy.size())
+    return {};
+
+  auto shape = tensorTy.getShape();
+  bool hasConstancy = false;
+  for (int i = 0; i < rank; ++i) {
+    if (constancy[i] >= shape[i]) {
+      // the tensor is constant along this dimension: all the
+      // elements held by the thread along it share the value
+      constancy[i] = elemsPerThread[i];
+    } else if (constancy[i] > sizePerThread[i]) {
+      if (constancy[i] % sizePerThread[i] != 0)
+        // constancy is not evenly covered by sizePerThread
+        return {};
+      // can't move the values across different
+      // "sizePerThread"-sized blocks
+      constancy[i] = sizePerThread[i];
+    }
+    if (elemsPerThread[i] < 1 || constancy[i] < 1)
+      return {};
+    if (!(elemsPerThread[i] % constancy[i] == 0 ||
+          constancy[i] % elemsPerThread[i] == 0))
+      // either the constancy along each dimension must fit
+      // into the elemsPerThread or the other way around
+      return {};
+    if (constancy[i] > 1)
+      hasConstancy = true;
+  }
+  if (!hasConstancy)
+    // nothing to deduplicate
+    return {};
+
+  if (rank > 1) {
+    // reorder the shape and constancy vectors by the axis order:
+    // from the fastest-changing to the smallest-changing axis
+    SmallVector<unsigned> order = triton::gpu::getOrder(encoding);
+    if (rank != order.size())
+      return {};
+    ArrayRef<unsigned> orderRef(order);
+    elemsPerThread = reorder(ArrayRef<unsigned>(elemsPerThread), orderRef);
+    constancy = reorder(ArrayRef<int64_t>(constancy), orderRef);
+  }
+
+  SmallVector<unsigned> strides(rank, 1);
+  for (int i = 1; i < rank; ++i) {
+    strides[i] = strides[i - 1] * elemsPerThread[i - 1];
+  }
+  SmallVector<unsigned> dedupIndices;
+  dedupIndices.reserve(numElems);
+  for (int i = 0; i < numElems; ++i) {
+    // each coordinate of the orig_idx is "coarsened" using the
+    // constancy along this dimension: the resulting dedup_idx
+    // points to the reused value in the original values
+    int orig_idx = i;
+    int dedup_idx = 0;
+    for (int j = 0; j < rank; ++j) {
+      int coord_j = orig_idx % elemsPerThread[j];
+      dedup_idx += (coord_j / constancy[j] * constancy[j]) * strides[j];
+      orig_idx /= elemsPerThread[j];
+    }
+    dedupIndices.push_back(dedup_idx);
+  }
+  return dedupIndices;
+}
+
 // Convert an \param linear to a multi-dim coordinate given \param shape and
 // \param order.
 SmallVector<Value> delinearize(ConversionPatternRewriter &rewriter,
@@ -262,7 +353,6 @@ Value linearize(ConversionPatternRewriter &rewriter, Location loc,
 Value storeShared(ConversionPatternRewriter &rewriter, Location loc, Value ptr,
                   Value val, Value pred, triton::Target target) {
   switch (target) {
-  case triton::Target::ROCDL:
   case triton::Target::NVVM: {
     MLIRContext *ctx = rewriter.getContext();
     unsigned bits = std::max(8u, val.getType().getIntOrFloatBitWidth());
@@ -275,6 +365,7 @@ Value storeShared(ConversionPatternRewriter &rewriter, Location loc, Value ptr,
     st(ptrOpr, valOpr).predicate(pred, "b");
     return builder.launch(rewriter, loc, void_ty(ctx));
   } break;
+  case triton::Target::ROCDL:
   case triton::Target::GENX: {
     createPredicatedBlock(rewriter, loc, pred, [&] {
       store(val, ptr);
@@ -289,7 +380,6 @@ Value storeShared(ConversionPatternRewriter &rewriter, Location loc, Value ptr,
 Value loadShared(ConversionPatternRewriter &rewriter, Location loc, Value ptr,
                  Type elemTy, Value pred, triton::Target target) {
   switch (target) {
-  case triton::Target::ROCDL:
   case triton::Target::NVVM: {
     MLIRContext *ctx = rewriter.getContext();
     auto ptrTy = ptr.getType().cast<LLVMPointerType>();
@@ -305,6 +395,7 @@ Value loadShared(ConversionPatternRewriter &rewriter, Location loc, Value ptr,
     ld(dOpr, ptrOpr).predicate(pred, "b");
     return builder.launch(rewriter, loc, elemTy);
   } break;
+  case triton::Target::ROCDL:
   case triton::Target::GENX: {
     assert(ptr.getType().cast<LLVMPointerType>().getAddressSpace() == 3 &&
            "Invalid addr space for loadShared");
@@ -334,6 +425,44 @@ static GENX::ShflKind toGenXShuffleMode(NVVM::ShflKind mode) {
   llvm_unreachable("unsupported NVVM::ShflKind");
 }
 
+// Exchange a 32-bit value between the lanes of a wavefront with the LDS
+// permute instructions, which do not access the LDS memory.
+static Value rocdlShflSync(Location loc, ConversionPatternRewriter &rewriter,
+                           Value val, Value i, NVVM::ShflKind mode) {
+  auto mod =
+      rewriter.getInsertionBlock()->getParentOp()->getParentOfType<ModuleOp>();
+  Value warpSize =
+      i32_val(triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod));
+  Value threadId = rewriter.create<ROCDL::ThreadIdXOp>(loc, i32_ty);
+  Value laneId = urem(threadId, warpSize);
+  // ds_bpermute addresses the source lanes in bytes.
+  auto bpermute = [&](Value lane) -> Value {
+    return rewriter.create<ROCDL::DsBpermuteOp>(loc, i32_ty,
+                                                shl(lane, i32_val(2)), val);
+  };
+
+  switch (mode) {
+  case NVVM::ShflKind::bfly: {
+    // The butterflies within 32 lanes are ds_swizzle patterns in the bitmask
+    // mode, with and_mask = 0x1f and xor_mask = the stride.
+    std::optional<int64_t> stride = getConstantIntValue(i);
+    if (stride && *stride > 0 && *stride <= 16 && llvm::isPowerOf2_64(*stride))
+      return rewriter.create<ROCDL::DsSwizzleOp>(
+          loc, i32_ty, val, i32_val(0x1f | (*stride << 10)));
+    return bpermute(xor_(laneId, i));
+  }
+  case NVVM::ShflKind::up:
+    return bpermute(select(icmp_slt(laneId, i), laneId, sub(laneId, i)));
+  case NVVM::ShflKind::down: {
+    Value lane = add(laneId, i);
+    return bpermute(select(icmp_ult(lane, warpSize), lane, laneId));
+  }
+  case NVVM::ShflKind::idx:
+    return bpermute(i);
+  }
+  llvm_unreachable("unsupported NVVM::ShflKind");
+}
+
 static Value commonShflSync(Location loc, ConversionPatternRewriter &rewriter,
                             Value val, Value i, NVVM::ShflKind mode,
                             Value clamp, triton::Target target) {
@@ -361,9 +490,14 @@ static Value commonShflSync(Location loc, ConversionPatternRewriter &rewriter,
       if (bits < 32)
         val = zext(i32_ty, val);
     }
-    Value mask = i32_val(0xFFFFFFFF);
-    Value result = rewriter.create<NVVM::ShflOp>(loc, i32_ty, mask, val, i,
-                                                 clamp, mode, UnitAttr());
+    Value result;
+    if (target == triton::Target::ROCDL) {
+      result = rocdlShflSync(loc, rewriter, val, i, mode);
+    } else {
+      Value mask = i32_val(0xFFFFFFFF);
+      result = rewriter.create<NVVM::ShflOp>(loc, i32_ty, mask, val, i, clamp,
+                                             mode, UnitAttr());
+    }
     if (type != i32_ty) {
       if (bits < 32)
         result = trunc(int_ty(bits), result);
@@ -403,6 +537,108 @@ Value shflIdxSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
                         i32_val(0x1f), target);
 }
 
+std::optional<StringRef> matchSPIRVGroupOp(Region &combineOp) {
+  Block *block = &combineOp.front();
+  if (block->getNumArguments() != 2)
+    return std::nullopt;
+  Operation *yield = block->getTerminator();
+  if (yield->getNumOperands() != 1)
+    return std::nullopt;
+  Operation *op = yield->getOperand(0).getDefiningOp();
+  if (!op || op->getNumOperands() != 2 || op->getNumResults() != 1)
+    return std::nullopt;
+  if (op->getOperand(0) != block->getArgument(0) ||
+      op->getOperand(1) != block->getArgument(1))
+    return std::nullopt;
+
+  Type type = op->getResult(0).getType();
+  if (auto intType = type.dyn_cast<IntegerType>()) {
+    if (intType.getWidth() < 8 || intType.getWidth() > 64)
+      return std::nullopt;
+  } else if (!type.isF16() && !type.isF32() && !type.isF64()) {
+    return std::nullopt;
+  }
+
+  // The float min/max instructions don't propagate NaNs, so only the
+  // non-propagating arith ops are matched.
+  return llvm::TypeSwitch<Operation *, std::optional<StringRef>>(op)
+      .Case<arith::AddIOp>([](auto) { return "GroupNonUniformIAdd"; })
+      .Case<arith::AddFOp>([](auto) { return "GroupNonUniformFAdd"; })
+      .Case<arith::MinSIOp>([](auto) { return "GroupNonUniformSMin"; })
+      .Case<arith::MinUIOp>([](auto) { return "GroupNonUniformUMin"; })
+      .Case<arith::MinNumFOp>([](auto) { return "GroupNonUniformFMin"; })
+      .Case<arith::MaxSIOp>([](auto) { return "GroupNonUniformSMax"; })
+      .Case<arith::MaxUIOp>([](auto) { return "GroupNonUniformUMax"; })
+      .Case<arith::MaxNumFOp>([](auto) { return "GroupNonUniformFMax"; })
+      .Case<arith::AndIOp>([](auto) { return "GroupNonUniformBitwiseAnd"; })
+      .Case<arith::OrIOp>([](auto) { return "GroupNonUniformBitwiseOr"; })
+      .Case<arith::XOrIOp>([](auto) { return "GroupNonUniformBitwiseXor"; })
+      .Default([](auto) { return std::nullopt; });
+}
+
+// Return the Itanium mangling of the scalar type `type`.
+static StringRef getMangledTypeName(Type type) {
+  if (type.isF16())
+    return "Dh";
+  if (type.isF32())
+    return "f";
+  if (type.isF64())
+    return "d";
+  switch (type.getIntOrFloatBitWidth()) {
+  case 8:
+    return "c";
+  case 16:
+    return "s";
+  case 32:
+    return "i";
+  case 64:
+    return "l";
+  }
+  llvm_unreachable("Unexpected sub-group operation type");
+}
+
+Value createSPIRVGroupOp(Location loc, ConversionPatternRewriter &rewriter,
+                         StringRef opName, SPIRVGroupOperation groupOp,
+                         Value val, unsigned clusterSize) {
+  // Call the SPIR-V friendly builtin, e.g.
+  //   T __spirv_GroupNonUniformIAdd(int scope, int groupOp, T val);
+  // which is translated to the SPIR-V instruction.
+  constexpr int32_t subgroupScope = 3;
+  Type type = val.getType();
+  bool isClustered = groupOp == SPIRVGroupOperation::ClusteredReduce;
+  std::string name = ("__spirv_" + opName).str();
+  std::string funcName = "_Z" + std::to_string(name.size()) + name + "ii" +
+                         getMangledTypeName(type).str() +
+                         (isClustered ? "j" : "");
+
+  SmallVector<Value> operands{
+      i32_val(subgroupScope), i32_val(static_cast<int32_t>(groupOp)), val};
+  if (isClustered)
+    operands.push_back(i32_val(clusterSize));
+
+  return createSPIRVBuiltinCall(loc, rewriter, funcName, type, operands);
+}
+
+Value createSPIRVBuiltinCall(Location loc, ConversionPatternRewriter &rewriter,
+                             StringRef funcName, Type retType,
+                             ValueRange operands) {
+  MLIRContext *ctx = rewriter.getContext();
+  auto moduleOp = rewriter.getBlock()->getParent()->getParentOfType<ModuleOp>();
+  auto funcOp = moduleOp.lookupSymbol<LLVM::LLVMFuncOp>(funcName);
+  if (!funcOp) {
+    ConversionPatternRewriter::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPointToStart(moduleOp.getBody());
+    auto funcType = LLVM::LLVMFunctionType::get(
+        retType, SmallVector<Type>(operands.getTypes()));
+    funcOp = rewriter.create<LLVM::LLVMFuncOp>(UnknownLoc::get(ctx), funcName,
+                                               funcType);
+    funcOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+  }
+  auto callOp = call(funcOp, operands);
+  callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+  return callOp.getResult();
+}
+
 Value getSRegValue(OpBuilder &b, Location loc, const std::string &sRegStr) {
   PTXBuilder builder;
   auto &mov = builder.create("mov")->o("u32");
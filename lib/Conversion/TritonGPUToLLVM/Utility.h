@@ -306,6 +306,15 @@ void createStoreDSmem(Location loc, PatternRewriter &rewriter, Value addr,
 SmallVector<Value>
 getStridesFromShapeAndOrder(ArrayRef<int64_t> shape, ArrayRef<unsigned> order,
                             Location loc, ConversionPatternRewriter &rewriter);
+
+/// Returns, for each of the `numElems` elements a thread holds of `tensorTy`,
+/// the index of the first element it holds with the same value given the
+/// `constancy` of the tensor, or an empty vector if there is nothing to
+/// deduplicate.
+SmallVector<unsigned> getDedupIndices(RankedTensorType tensorTy,
+                                      SmallVector<int64_t> constancy,
+                                      size_t numElems);
+
 struct SharedMemoryObject {
   Value base; // i32 ptr. The start address of the shared memory object after
               // the initial allocation or the last slicing operation.
@@ -411,6 +420,32 @@ Value shflIdxSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
                   int i, triton::Target target);
 Value shflIdxSync(Location loc, ConversionPatternRewriter &rewriter, Value val,
                   Value i, triton::Target target);
+// SPIR-V group operations of the sub-group non-uniform arithmetic
+// instructions.
+enum class SPIRVGroupOperation : uint32_t {
+  Reduce = 0,
+  InclusiveScan = 1,
+  ExclusiveScan = 2,
+  ClusteredReduce = 3,
+};
+
+// Return the SPIR-V sub-group non-uniform arithmetic instruction (e.g.
+// "GroupNonUniformIAdd") computing the combine region of a reduce or scan, if
+// the region is a single supported binary operation on its two arguments.
+std::optional<StringRef> matchSPIRVGroupOp(Region &combineOp);
+
+// Call the SPIR-V friendly builtin `funcName` (mangled), declaring it in the
+// module on first use.
+Value createSPIRVBuiltinCall(Location loc, ConversionPatternRewriter &rewriter,
+                             StringRef funcName, Type retType,
+                             ValueRange operands);
+
+// Apply the SPIR-V sub-group instruction `opName` with `groupOp` to `val`.
+// `clusterSize` is only used by clustered reductions.
+Value createSPIRVGroupOp(Location loc, ConversionPatternRewriter &rewriter,
+                         StringRef opName, SPIRVGroupOperation groupOp,
+                         Value val, unsigned clusterSize = 0);
+
 Value getSRegValue(OpBuilder &b, Location loc, const std::string &sRegStr);
 
 Value addStringToModule(Location loc, ConversionPatternRewriter &rewriter,
@@ -0,0 +1,64 @@
+#include "triton/Conversion/TritonGPUToLLVM/VISAAsmFormat.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Transforms/DialectConversion.h"
+#include "triton/Conversion/TritonGPUToLLVM/AsmFormat.h"
+
+namespace mlir {
+namespace triton {
+
+VISABuilder::Operand *VISABuilder::newOperand(StringRef constraint) {
+  assert(!constraint.empty() && constraint[0] == '=' &&
+         "expected an output constraint");
+  assert(llvm::all_of(operands,
+                      [](const std::unique_ptr<Operand> &opr) {
+                        return opr->constraint[0] == '=';
+                      }) &&
+         "the outputs are created before the inputs");
+  operands.push_back(
+      std::make_unique<Operand>(Value(), constraint, operands.size()));
+  return operands.back().get();
+}
+
+VISABuilder::Operand *VISABuilder::newOperand(mlir::Value value,
+                                              StringRef constraint) {
+  assert(!constraint.empty() && constraint[0] != '=' &&
+         "expected an input constraint");
+  operands.push_back(
+      std::make_unique<Operand>(value, constraint, operands.size()));
+  return operands.back().get();
+}
+
+llvm::SmallVector<Value, 4> VISABuilder::getAllMLIRArgs() const {
+  llvm::SmallVector<Value, 4> res;
+  for (auto &opr : operands)
+    if (opr->value)
+      res.push_back(opr->value);
+  return res;
+}
+
+std::string VISABuilder::getConstraints() const {
+  llvm::SmallVector<std::string, 4> constraints;
+  for (auto &opr : operands)
+    constraints.push_back(opr->constraint);
+  return strJoin(constraints, ",");
+}
+
+std::string VISABuilder::dump() const { return strJoin(instrs, "\n"); }
+
+mlir::Value VISABuilder::launch(OpBuilder &rewriter, Location loc, Type resTy,
+                                bool hasSideEffect) const {
+  auto *ctx = rewriter.getContext();
+  auto inlineAsm = rewriter.create<LLVM::InlineAsmOp>(
+      loc, resTy, getAllMLIRArgs(), // operands
+      dump(),                       // asm_string
+      getConstraints(),             // constraints
+      hasSideEffect,                // has_side_effects
+      /*is_align_stack=*/false,
+      LLVM::AsmDialectAttr::get(ctx,
+                                LLVM::AsmDialect::AD_ATT), // asm_dialect
+      ArrayAttr());                                        // operand_attrs
+  return inlineAsm.getRes();
+}
+
+} // namespace triton
+} // namespace mlir
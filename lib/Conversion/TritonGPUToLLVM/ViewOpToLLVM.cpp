@@ -1,5 +1,7 @@
 #include "PatternTritonGPUOpToLLVM.h"
 
+#include <numeric>
+
 using namespace mlir;
 using namespace mlir::triton;
 
@@ -291,6 +293,133 @@ struct TransOpConversion
     return success();
   }
 };
+struct UnpackInt4OpConversion
+    : public ConvertTritonGPUOpToLLVMPattern<triton::UnpackInt4Op> {
+  using ConvertTritonGPUOpToLLVMPattern<
+      triton::UnpackInt4Op>::ConvertTritonGPUOpToLLVMPattern;
+
+  // Return a constant of the integer or integer vector type `type`.
+  static Value createIntConstant(Location loc,
+                                 ConversionPatternRewriter &rewriter,
+                                 Type type, int64_t value) {
+    Attribute attr =
+        rewriter.getIntegerAttr(getElementTypeOrSelf(type), value);
+    if (auto vecTy = dyn_cast<VectorType>(type))
+      attr = DenseElementsAttr::get(vecTy, ArrayRef<Attribute>(attr));
+    return rewriter.create<LLVM::ConstantOp>(loc, type, attr);
+  }
+
+  // Return the low or high nibbles of the bytes of `packed`, an i8 or a
+  // vector of i8, extended to 8 bits.
+  static Value unpackNibbles(Location loc, ConversionPatternRewriter &rewriter,
+                             Value packed, bool high, bool isSigned) {
+    Value four = createIntConstant(loc, rewriter, packed.getType(), 4);
+    if (isSigned) {
+      Value val = high ? packed : shl(packed, four);
+      return rewriter.create<LLVM::AShrOp>(loc, val, four);
+    }
+    if (high)
+      return lshr(packed, four);
+    return and_(packed,
+                createIntConstant(loc, rewriter, packed.getType(), 0xf));
+  }
+
+  // Convert the 8-bit integers `val`, an i8 or a vector of i8, to `elemTy`.
+  // They are exactly representable in all the supported types.
+  static Value convertInt8(Location loc, ConversionPatternRewriter &rewriter,
+                           Value val, Type elemTy, bool isSigned) {
+    if (elemTy.isInteger(8))
+      return val;
+    auto withElemTy = [&](Type ty) -> Type {
+      if (auto vecTy = dyn_cast<VectorType>(val.getType()))
+        return vec_ty(ty, vecTy.getNumElements());
+      return ty;
+    };
+    Type floatTy = withElemTy(elemTy.isBF16() ? f32_ty : elemTy);
+    Value ret = isSigned ? rewriter.create<LLVM::SIToFPOp>(loc, floatTy, val)
+                               .getResult()
+                         : rewriter.create<LLVM::UIToFPOp>(loc, floatTy, val)
+                               .getResult();
+    if (!elemTy.isBF16())
+      return ret;
+    // bf16 values are stored as i16: the small integers have no bits in the
+    // low half of their f32 representation.
+    ret = bitcast(ret, withElemTy(i32_ty));
+    ret = lshr(ret, createIntConstant(loc, rewriter, ret.getType(), 16));
+    return trunc(withElemTy(i16_ty), ret);
+  }
+
+  LogicalResult
+  matchAndRewrite(triton::UnpackInt4Op op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op->getLoc();
+    auto srcTy = op.getSrc().getType().cast<RankedTensorType>();
+    auto resultTy = op.getType().cast<RankedTensorType>();
+    auto dotOpLayout =
+        resultTy.getEncoding().dyn_cast<DotOperandEncodingAttr>();
+    if (!dotOpLayout || dotOpLayout.getOpIdx() != 1)
+      return rewriter.notifyMatchFailure(
+          op, "only the unpacking in the layout of a B operand is supported");
+    Type elemTy = resultTy.getElementType();
+    bool isSigned = op.getIsSigned();
+
+    SmallVector<Value> srcVals =
+        getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    SmallVector<Value> resultVals;
+    if (dotOpLayout.getParent().isa<DpasEncodingAttr>()) {
+      // The values are vectors of consecutive rows of a column of B, those of
+      // a column in row order: every packed vector is unpacked into the next
+      // result vectors.
+      auto vecTy = getTypeConverter()
+                       ->getElementTypeForStruct(resultTy)
+                       .cast<VectorType>();
+      unsigned vecSize = vecTy.getNumElements();
+      for (Value packed : srcVals) {
+        unsigned numPacked =
+            packed.getType().cast<VectorType>().getNumElements();
+        Value lo = unpackNibbles(loc, rewriter, packed, false, isSigned);
+        Value hi = unpackNibbles(loc, rewriter, packed, true, isSigned);
+        SmallVector<int32_t> interleave;
+        for (unsigned i = 0; i < numPacked; ++i) {
+          interleave.push_back(i);
+          interleave.push_back(i + numPacked);
+        }
+        Value unpacked =
+            rewriter.create<LLVM::ShuffleVectorOp>(loc, lo, hi, interleave);
+        for (unsigned start = 0; start < 2 * numPacked; start += vecSize) {
+          SmallVector<int32_t> slice(vecSize);
+          std::iota(slice.begin(), slice.end(), start);
+          Value val = rewriter.create<LLVM::ShuffleVectorOp>(loc, unpacked,
+                                                             unpacked, slice);
+          resultVals.push_back(
+              convertInt8(loc, rewriter, val, elemTy, isSigned));
+        }
+      }
+    } else if (dotOpLayout.getParent().isa<BlockedEncodingAttr>()) {
+      // The values are all the rows of the columns of B of the thread, in
+      // row-major order.
+      unsigned numCols =
+          srcVals.size() / triton::gpu::getShapePerCTA(srcTy)[0];
+      resultVals.resize(2 * srcVals.size());
+      for (unsigned i = 0; i < srcVals.size(); ++i) {
+        unsigned row = i / numCols, col = i % numCols;
+        for (bool high : {false, true}) {
+          Value val =
+              unpackNibbles(loc, rewriter, srcVals[i], high, isSigned);
+          resultVals[(2 * row + high) * numCols + col] =
+              convertInt8(loc, rewriter, val, elemTy, isSigned);
+        }
+      }
+    } else {
+      return rewriter.notifyMatchFailure(op, "unsupported B operand layout");
+    }
+
+    Value ret =
+        getTypeConverter()->packLLElements(loc, resultVals, rewriter, resultTy);
+    rewriter.replaceOp(op, ret);
+    return success();
+  }
+};
 } // namespace
 
 void mlir::triton::populateViewOpToLLVMPatterns(
@@ -304,4 +433,5 @@ void mlir::triton::populateViewOpToLLVMPatterns(
   patterns.add<CatOpConversion>(typeConverter, target, benefit);
   patterns.add<InterleaveOpConversion>(typeConverter, target, benefit);
   patterns.add<TransOpConversion>(typeConverter, target, benefit);
+  patterns.add<UnpackInt4OpConversion>(typeConverter, target, benefit);
 }
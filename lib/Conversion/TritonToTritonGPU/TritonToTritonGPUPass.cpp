@@ -221,12 +221,21 @@ struct TritonDotPattern : public OpConversionPattern<triton::DotOp> {
     int threadsPerWarp = typeConverter->getThreadsPerWarp();
     int numCTAs = typeConverter->getNumCTAs();
 
-    SmallVector<unsigned> retSizePerThread = {1, 1};
-    if (origShape[0] * origShape[1] / (numWarps * threadsPerWarp) >= 4)
-      retSizePerThread = {2, 2};
-    if (origShape[0] * origShape[1] / (numWarps * threadsPerWarp) >= 16)
-      retSizePerThread = {4, 4};
+    // The batched dots have a leading batch dimension, the threads hold the
+    // elements of a single matrix.
+    unsigned rank = origShape.size();
+    int64_t numElements = product<int64_t>(origShape);
+    unsigned matrixSizePerThread = 1;
+    if (numElements / (numWarps * threadsPerWarp) >= 4)
+      matrixSizePerThread = 2;
+    if (numElements / (numWarps * threadsPerWarp) >= 16)
+      matrixSizePerThread = 4;
+    SmallVector<unsigned> retSizePerThread(rank, matrixSizePerThread);
     SmallVector<unsigned> retOrder = {1, 0};
+    if (rank == 3) {
+      retSizePerThread[0] = 1;
+      retOrder = {2, 1, 0};
+    }
     Attribute dEncoding = triton::gpu::BlockedEncodingAttr::get(
         getContext(), origShape, retSizePerThread, retOrder, numWarps,
         threadsPerWarp, numCTAs);
@@ -251,7 +260,21 @@ struct TritonDotPattern : public OpConversionPattern<triton::DotOp> {
           RankedTensorType::get(aType.getShape(), aEltType, encoding);
       a = rewriter.create<triton::gpu::ConvertLayoutOp>(a.getLoc(), dstType, a);
     }
-    if (!bEncoding.isa<triton::gpu::DotOperandEncodingAttr>()) {
+    if (auto unpack = b.getDefiningOp<triton::UnpackInt4Op>()) {
+      // Unpack the packed operand in the dot operand layout, the columns of b
+      // are owned by single threads in it, so that it is done in registers.
+      Attribute encoding = triton::gpu::DotOperandEncodingAttr::get(
+          getContext(), 1, dEncoding, bEltType);
+      auto packedType = unpack.getSrc().getType().cast<RankedTensorType>();
+      auto dstPackedType = RankedTensorType::get(
+          packedType.getShape(), packedType.getElementType(), encoding);
+      Value packed = rewriter.create<triton::gpu::ConvertLayoutOp>(
+          unpack.getLoc(), dstPackedType, unpack.getSrc());
+      auto dstType =
+          RankedTensorType::get(bType.getShape(), bEltType, encoding);
+      b = rewriter.create<triton::UnpackInt4Op>(unpack.getLoc(), dstType,
+                                                packed, unpack.getIsSigned());
+    } else if (!bEncoding.isa<triton::gpu::DotOperandEncodingAttr>()) {
       Attribute encoding = triton::gpu::DotOperandEncodingAttr::get(
           getContext(), 1, dEncoding, bEltType);
       auto dstType =
@@ -357,6 +380,31 @@ struct TritonInterleaveOpPattern
   }
 };
 
+struct TritonUnpackInt4Pattern
+    : public OpConversionPattern<triton::UnpackInt4Op> {
+  using OpConversionPattern<triton::UnpackInt4Op>::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::UnpackInt4Op op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    // The packed operand takes the encoding of the result, the unpacking is
+    // moved to the layout of the dot operand by the dot pattern.
+    auto retType = this->getTypeConverter()
+                       ->convertType(op.getType())
+                       .cast<RankedTensorType>();
+    auto srcType = adaptor.getSrc().getType().cast<RankedTensorType>();
+    auto newSrcType =
+        RankedTensorType::get(srcType.getShape(), srcType.getElementType(),
+                              retType.getEncoding());
+    Value src = rewriter.create<triton::gpu::ConvertLayoutOp>(
+        op.getLoc(), newSrcType, adaptor.getSrc());
+    addNamedAttrs(rewriter.replaceOpWithNewOp<triton::UnpackInt4Op>(
+                      op, retType, src, adaptor.getIsSigned()),
+                  adaptor.getAttributes());
+    return success();
+  }
+};
+
 struct TritonTransPattern : public OpConversionPattern<triton::TransOp> {
 
   using OpConversionPattern<triton::TransOp>::OpConversionPattern;
@@ -517,8 +565,11 @@ void populateTritonPatterns(TritonGPUTypeConverter &typeConverter,
       GenericOpPattern<triton::ScanReturnOp>,
       GenericOpPattern<triton::MakeRangeOp>, TritonExpandDimsPattern,
       TritonTransPattern, TritonDotPattern, GenericOpPattern<triton::LoadOp>,
-      GenericOpPattern<triton::StoreOp>, GenericOpPattern<triton::HistogramOp>,
-      GenericOpPattern<triton::ExternElementwiseOp>,
+      GenericOpPattern<triton::LoadPagesOp>, GenericOpPattern<triton::StoreOp>,
+      GenericOpPattern<triton::HistogramOp>, GenericOpPattern<triton::SortOp>,
+      GenericOpPattern<triton::TopKOp>, GenericOpPattern<triton::LocalLoadOp>,
+      GenericOpPattern<triton::LocalStoreOp>, GenericOpPattern<triton::PhiloxOp>,
+      TritonUnpackInt4Pattern, GenericOpPattern<triton::ExternElementwiseOp>,
       GenericOpPattern<triton::PrintOp>, GenericOpPattern<triton::AssertOp>,
       GenericOpPattern<triton::AtomicCASOp>,
       GenericOpPattern<triton::AtomicRMWOp>, GenericOpPattern<ReturnOp>,
@@ -358,6 +358,30 @@ void triton::StoreOp::getCanonicalizationPatterns(RewritePatternSet &results,
   results.add<CanonicalizeMaskedStorePattern>(context);
 }
 
+//-- LoadPagesOp --
+LogicalResult LoadPagesOp::verify() {
+  auto tensorTy = getPtr()
+                      .getType()
+                      .cast<PointerType>()
+                      .getPointeeType()
+                      .cast<RankedTensorType>();
+  auto resultTy = getResult().getType().cast<RankedTensorType>();
+  if (tensorTy.getRank() != 2)
+    return emitOpError() << "expected a 2D tensor pointer";
+  if (resultTy.getShape() != tensorTy.getShape() ||
+      resultTy.getElementType() != tensorTy.getElementType())
+    return emitOpError()
+           << "the result must have the shape and the element type of the "
+              "block of the tensor pointer";
+  int64_t pageSize = getPageSize();
+  if (pageSize <= 0 || tensorTy.getDimSize(0) % pageSize != 0)
+    return emitOpError() << "the rows of the block, "
+                         << tensorTy.getDimSize(0)
+                         << ", must be a multiple of the page size, "
+                         << pageSize;
+  return success();
+}
+
 //-- TransOp --
 mlir::LogicalResult mlir::triton::TransOp::inferReturnTypes(
     MLIRContext *context, std::optional<Location> location, ValueRange operands,
@@ -667,6 +691,73 @@ llvm::SmallVector<Type> ScanOp::getElementTypes() {
 
 unsigned ScanOp::getNumOperands() { return this->getOperands().size(); }
 
+//-- SortOp --
+// Verify that `axis` is an axis of `srcTy` of a power of two size.
+static LogicalResult verifySortAxis(Operation *op, RankedTensorType srcTy,
+                                    int axis) {
+  if (axis < 0 || axis >= srcTy.getRank())
+    return op->emitOpError() << "axis " << axis << " out of range for a "
+                             << srcTy.getRank() << "D tensor";
+  if (!llvm::isPowerOf2_64(srcTy.getDimSize(axis)))
+    return op->emitOpError() << "the size of the axis, "
+                             << srcTy.getDimSize(axis)
+                             << ", must be a power of two";
+  return success();
+}
+
+LogicalResult SortOp::verify() {
+  return verifySortAxis(*this, getSrc().getType().cast<RankedTensorType>(),
+                        getAxis());
+}
+
+//-- TopKOp --
+LogicalResult TopKOp::verify() {
+  auto srcTy = getSrc().getType().cast<RankedTensorType>();
+  auto resultTy = getResult().getType().cast<RankedTensorType>();
+  int axis = getAxis();
+  if (failed(verifySortAxis(*this, srcTy, axis)))
+    return failure();
+  int64_t k = getK();
+  if (k <= 0 || !llvm::isPowerOf2_64(k) || k > srcTy.getDimSize(axis))
+    return emitOpError() << "k, " << k
+                         << ", must be a power of two no larger than the size "
+                            "of the axis";
+  SmallVector<int64_t> shape(srcTy.getShape());
+  shape[axis] = k;
+  if (resultTy.getShape() != ArrayRef<int64_t>(shape))
+    return emitOpError() << "the result must have the shape of the operand "
+                            "with k elements along the axis";
+  return success();
+}
+
+//-- LocalLoadOp / LocalStoreOp --
+// The elements accessed through `offsets`, if any, have their shape, the
+// whole buffer otherwise.
+static LogicalResult verifyLocalAccess(Operation *op, Value buffer,
+                                       Value offsets, Type valueType) {
+  auto bufferTy = buffer.getType().cast<RankedTensorType>();
+  auto valueTy = valueType.cast<RankedTensorType>();
+  if (bufferTy.getElementType() != valueTy.getElementType())
+    return op->emitOpError()
+           << "the elements must have the element type of the buffer";
+  ArrayRef<int64_t> shape = bufferTy.getShape();
+  if (offsets)
+    shape = offsets.getType().cast<RankedTensorType>().getShape();
+  if (valueTy.getShape() != shape)
+    return op->emitOpError() << "the elements must have the shape of the "
+                             << (offsets ? "offsets" : "buffer");
+  return success();
+}
+
+LogicalResult LocalLoadOp::verify() {
+  return verifyLocalAccess(*this, getBuffer(), getOffsets(), getType());
+}
+
+LogicalResult LocalStoreOp::verify() {
+  return verifyLocalAccess(*this, getBuffer(), getOffsets(),
+                           getValue().getType());
+}
+
 //-- SplatOp --
 OpFoldResult SplatOp::fold(FoldAdaptor adaptor) {
   auto value = adaptor.getSrc();
@@ -840,6 +931,23 @@ mlir::LogicalResult mlir::triton::FpToFpOp::verify() {
   return mlir::success();
 }
 
+//-- UnpackInt4Op --
+mlir::LogicalResult mlir::triton::UnpackInt4Op::verify() {
+  auto srcType = getSrc().getType().cast<RankedTensorType>();
+  auto resultType = getType().cast<RankedTensorType>();
+  if (srcType.getRank() != 2 || resultType.getRank() != 2)
+    return emitError("expected 2D tensors");
+  if (resultType.getDimSize(0) != 2 * srcType.getDimSize(0) ||
+      resultType.getDimSize(1) != srcType.getDimSize(1))
+    return emitError("expected the result to have twice as many rows as the "
+                     "source and the same number of columns");
+  Type elemType = resultType.getElementType();
+  if (!elemType.isInteger(8) && !elemType.isF16() && !elemType.isBF16() &&
+      !elemType.isF32())
+    return emitError("expected an i8, f16, bf16 or f32 result");
+  return mlir::success();
+}
+
 //-- BroadcastOp --
 LogicalResult BroadcastOp::canonicalize(BroadcastOp op,
                                         PatternRewriter &rewriter) {
@@ -1,3 +1,4 @@
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/Matchers.h"
 #include "mlir/IR/PatternMatch.h"
@@ -47,6 +48,41 @@ DenseElementsAttr getConstantValue(Builder &builder, Attribute value,
   return res;
 }
 
+// The scalar condition a mask is the splat of, or the condition itself.
+Value getMaskCondition(Value mask) {
+  if (mask.getType().isInteger(1))
+    return mask;
+  while (auto bc = mask.getDefiningOp<mlir::triton::BroadcastOp>())
+    mask = bc.getSrc();
+  if (auto splat = mask.getDefiningOp<mlir::triton::SplatOp>())
+    return splat.getSrc();
+  return {};
+}
+
+// Whether the masks `a` and `b`, or the conditions they are splats of, are the
+// same, so that the lanes one masks are the lanes the other one masks.
+bool isSameMask(Value a, Value b) {
+  if (a == b)
+    return true;
+  Value condA = getMaskCondition(a);
+  return condA && condA == getMaskCondition(b);
+}
+
+// Whether `op` only runs when `cond` holds, in the then region of an `scf.if`
+// on `cond`.
+bool isGuardedBy(Operation *op, Value cond) {
+  for (Operation *parent = op->getParentOp(); parent;
+       parent = parent->getParentOp()) {
+    if (auto ifOp = dyn_cast<scf::IfOp>(parent))
+      if (ifOp.getCondition() == cond &&
+          ifOp.getThenRegion().isAncestor(op->getParentRegion()))
+        return true;
+    if (isa<FunctionOpInterface>(parent))
+      break;
+  }
+  return false;
+}
+
 // TODO(csigg): remove after next LLVM integrate.
 using FastMathFlags = arith::FastMathFlags;
 
@@ -99,6 +135,119 @@ public:
   }
 };
 
+// scf.if %cond { load(ptrs, splat(%cond), other) } => load(ptrs)
+// scf.if %cond { store(ptrs, value, splat(%cond)) } => store(ptrs, value)
+template <typename OpTy>
+class CombineGuardedMaskPattern : public mlir::OpRewritePattern<OpTy> {
+public:
+  CombineGuardedMaskPattern(mlir::MLIRContext *context)
+      : mlir::OpRewritePattern<OpTy>(context, 2) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(OpTy op, mlir::PatternRewriter &rewriter) const override {
+    mlir::Value mask = op.getMask();
+    if (!mask)
+      return mlir::failure();
+    mlir::Value cond = getMaskCondition(mask);
+    if (!cond || !isGuardedBy(op, cond))
+      return mlir::failure();
+
+    if constexpr (std::is_same_v<OpTy, triton::LoadOp>)
+      rewriter.replaceOpWithNewOp<triton::LoadOp>(
+          op, op.getType(), op.getPtr(), Value(), Value(),
+          op.getBoundaryCheckAttr(), op.getPaddingAttr(), op.getCache(),
+          op.getEvict(), op.getIsVolatile());
+    else
+      rewriter.replaceOpWithNewOp<triton::StoreOp>(
+          op, op.getPtr(), op.getValue(), op.getCache(), op.getEvict());
+    return mlir::success();
+  }
+};
+
+// store(ptrs, select(mask, value, ???), mask) => store(ptrs, value, mask)
+class CombineSelectMaskedStorePattern
+    : public mlir::OpRewritePattern<triton::StoreOp> {
+public:
+  CombineSelectMaskedStorePattern(mlir::MLIRContext *context)
+      : mlir::OpRewritePattern<triton::StoreOp>(context, 1) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(triton::StoreOp storeOp,
+                  mlir::PatternRewriter &rewriter) const override {
+    mlir::Value mask = storeOp.getMask();
+    if (!mask)
+      return mlir::failure();
+    auto selectOp = storeOp.getValue().getDefiningOp<arith::SelectOp>();
+    if (!selectOp || !isSameMask(selectOp.getCondition(), mask))
+      return mlir::failure();
+
+    rewriter.updateRootInPlace(storeOp, [&]() {
+      storeOp.getValueMutable().assign(selectOp.getTrueValue());
+    });
+    return mlir::success();
+  }
+};
+
+// load(ptrs, mask, other) => load(ptrs, mask)
+// when the lanes of the result mask masks are never used: the result only
+// flows through elementwise operations into stores masked by mask, or into the
+// true value of selects on mask.
+class CombineUnusedLoadOtherPattern
+    : public mlir::OpRewritePattern<triton::LoadOp> {
+public:
+  CombineUnusedLoadOtherPattern(mlir::MLIRContext *context)
+      : mlir::OpRewritePattern<triton::LoadOp>(context, 1) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(triton::LoadOp loadOp,
+                  mlir::PatternRewriter &rewriter) const override {
+    mlir::Value mask = loadOp.getMask();
+    if (!mask || !loadOp.getOther() || !areMaskedLanesUnused(loadOp, mask))
+      return mlir::failure();
+
+    rewriter.replaceOpWithNewOp<triton::LoadOp>(
+        loadOp, loadOp.getType(), loadOp.getPtr(), mask, Value(),
+        loadOp.getBoundaryCheckAttr(), loadOp.getPaddingAttr(),
+        loadOp.getCache(), loadOp.getEvict(), loadOp.getIsVolatile());
+    return mlir::success();
+  }
+
+private:
+  static bool areMaskedLanesUnused(triton::LoadOp loadOp, Value mask) {
+    auto shape = loadOp.getType().cast<ShapedType>().getShape();
+    SmallVector<Value> worklist{loadOp.getResult()};
+    llvm::SmallPtrSet<Operation *, 8> visited;
+    while (!worklist.empty()) {
+      Value value = worklist.pop_back_val();
+      for (OpOperand &use : value.getUses()) {
+        Operation *user = use.getOwner();
+        if (auto storeOp = dyn_cast<triton::StoreOp>(user)) {
+          if (use.get() != storeOp.getValue() || !storeOp.getMask() ||
+              !isSameMask(storeOp.getMask(), mask))
+            return false;
+          continue;
+        }
+        if (auto selectOp = dyn_cast<arith::SelectOp>(user))
+          if (use.getOperandNumber() == 1 &&
+              isSameMask(selectOp.getCondition(), mask))
+            continue;
+        // The lanes of the result of a pure elementwise operation only depend
+        // on the same lanes of its operands. Speculatable operations don't
+        // trap whatever the values of the masked lanes.
+        if (!user->hasTrait<OpTrait::Elementwise>() || !isPure(user) ||
+            user->getNumResults() != 1)
+          return false;
+        auto resultTy = user->getResult(0).getType().dyn_cast<ShapedType>();
+        if (!resultTy || resultTy.getShape() != shape)
+          return false;
+        if (visited.insert(user).second)
+          worklist.push_back(user->getResult(0));
+      }
+    }
+    return true;
+  }
+};
+
 // sum(x[:, :, None] * y[None, :, :], 1)
 // -> dot(x, y)
 class CombineBroadcastMulReducePattern : public mlir::RewritePattern {
@@ -204,6 +353,10 @@ public:
     patterns.add<CombineDotAddFRevPattern>(context);
     // %}
     patterns.add<CombineSelectMaskedLoadPattern>(context);
+    patterns.add<CombineGuardedMaskPattern<triton::LoadOp>,
+                 CombineGuardedMaskPattern<triton::StoreOp>>(context);
+    patterns.add<CombineSelectMaskedStorePattern>(context);
+    patterns.add<CombineUnusedLoadOtherPattern>(context);
     // patterns.add<CombineAddPtrPattern>(context);
     patterns.add<CombineBroadcastConstantPattern>(context);
     patterns.add<CombineBroadcastMulReducePattern>(context);
@@ -0,0 +1,313 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Pass/Pass.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+
+#include "llvm/ADT/TypeSwitch.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <optional>
+
+namespace mlir {
+#define GEN_PASS_DEF_TRITONFOLDMASKS
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+} // namespace mlir
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace {
+
+// The signed range [min, max] of all the elements of an integer value.
+struct Range {
+  int64_t min;
+  int64_t max;
+
+  bool isNonNegative() const { return min >= 0; }
+};
+
+using MaybeRange = std::optional<Range>;
+
+static unsigned getIntBitWidth(Type type) {
+  type = getElementTypeOrSelf(type);
+  if (type.isIndex())
+    return 64;
+  if (auto intTy = type.dyn_cast<IntegerType>())
+    return intTy.getWidth();
+  return 0;
+}
+
+// The range if it holds in the integers of `bitWidth` bits, none if the
+// operation computing it may have wrapped around.
+static MaybeRange fit(int64_t min, int64_t max, unsigned bitWidth) {
+  if (bitWidth < 2 || bitWidth > 64)
+    return std::nullopt;
+  int64_t lowest = bitWidth == 64 ? INT64_MIN : -(int64_t(1) << (bitWidth - 1));
+  int64_t highest =
+      bitWidth == 64 ? INT64_MAX : (int64_t(1) << (bitWidth - 1)) - 1;
+  if (min < lowest || max > highest)
+    return std::nullopt;
+  return Range{min, max};
+}
+
+static MaybeRange add(Range lhs, Range rhs, unsigned bitWidth) {
+  int64_t min, max;
+  if (__builtin_add_overflow(lhs.min, rhs.min, &min) ||
+      __builtin_add_overflow(lhs.max, rhs.max, &max))
+    return std::nullopt;
+  return fit(min, max, bitWidth);
+}
+
+static MaybeRange sub(Range lhs, Range rhs, unsigned bitWidth) {
+  int64_t min, max;
+  if (__builtin_sub_overflow(lhs.min, rhs.max, &min) ||
+      __builtin_sub_overflow(lhs.max, rhs.min, &max))
+    return std::nullopt;
+  return fit(min, max, bitWidth);
+}
+
+static MaybeRange mul(Range lhs, Range rhs, unsigned bitWidth) {
+  int64_t corners[4];
+  if (__builtin_mul_overflow(lhs.min, rhs.min, &corners[0]) ||
+      __builtin_mul_overflow(lhs.min, rhs.max, &corners[1]) ||
+      __builtin_mul_overflow(lhs.max, rhs.min, &corners[2]) ||
+      __builtin_mul_overflow(lhs.max, rhs.max, &corners[3]))
+    return std::nullopt;
+  return fit(*std::min_element(corners, corners + 4),
+             *std::max_element(corners, corners + 4), bitWidth);
+}
+
+// Compute the ranges of the integer values of a function from the constants,
+// the program ids and the ranges of the tensors, none when unknown, e.g. for
+// the arguments of the function.
+class RangeAnalysis {
+public:
+  MaybeRange get(Value value, unsigned depth = 0) {
+    auto it = ranges.find(value);
+    if (it != ranges.end())
+      return it->second;
+    MaybeRange range = depth < maxDepth ? compute(value, depth + 1)
+                                        : std::nullopt;
+    ranges.try_emplace(value, range);
+    return range;
+  }
+
+private:
+  static constexpr unsigned maxDepth = 32;
+
+  MaybeRange compute(Value value, unsigned depth) {
+    unsigned bitWidth = getIntBitWidth(value.getType());
+    if (bitWidth == 0)
+      return std::nullopt;
+    APInt constant;
+    if (matchPattern(value, m_ConstantInt(&constant)) && bitWidth > 1)
+      return Range{constant.getSExtValue(), constant.getSExtValue()};
+    if (auto arg = value.dyn_cast<BlockArgument>())
+      return getInductionVarRange(arg, depth);
+    Operation *op = value.getDefiningOp();
+    auto operand = [&](unsigned i) { return get(op->getOperand(i), depth); };
+    // Apply `fn` to the ranges of both operands, if known.
+    auto binary = [&](auto fn) -> MaybeRange {
+      MaybeRange lhs = operand(0), rhs = operand(1);
+      if (!lhs || !rhs)
+        return std::nullopt;
+      return fn(*lhs, *rhs);
+    };
+    int64_t maxInt32 = std::numeric_limits<int32_t>::max();
+    return llvm::TypeSwitch<Operation *, MaybeRange>(op)
+        .Case<tt::MakeRangeOp>([&](auto range) -> MaybeRange {
+          return fit(range.getStart(), int64_t(range.getEnd()) - 1, bitWidth);
+        })
+        // The grid has at most 2^31 - 1 programs along each dimension.
+        .Case<tt::GetProgramIdOp>(
+            [&](auto) { return fit(0, maxInt32 - 1, bitWidth); })
+        .Case<tt::GetNumProgramsOp>(
+            [&](auto) { return fit(1, maxInt32, bitWidth); })
+        // The elements are moved around, their range is unchanged.
+        .Case<tt::SplatOp, tt::BroadcastOp, tt::ExpandDimsOp, tt::ReshapeOp,
+              tt::TransOp>([&](auto) { return operand(0); })
+        .Case<arith::ExtSIOp, arith::IndexCastOp, arith::TruncIOp>(
+            [&](auto) -> MaybeRange {
+              MaybeRange src = operand(0);
+              return src ? fit(src->min, src->max, bitWidth) : std::nullopt;
+            })
+        .Case<arith::ExtUIOp, arith::IndexCastUIOp>([&](auto) -> MaybeRange {
+          MaybeRange src = operand(0);
+          return src && src->isNonNegative() ? src : std::nullopt;
+        })
+        .Case<arith::AddIOp>([&](auto) {
+          return binary([&](Range lhs, Range rhs) {
+            return add(lhs, rhs, bitWidth);
+          });
+        })
+        .Case<arith::SubIOp>([&](auto) {
+          return binary([&](Range lhs, Range rhs) {
+            return sub(lhs, rhs, bitWidth);
+          });
+        })
+        .Case<arith::MulIOp>([&](auto) {
+          return binary([&](Range lhs, Range rhs) {
+            return mul(lhs, rhs, bitWidth);
+          });
+        })
+        .Case<arith::DivSIOp, arith::DivUIOp>([&](auto div) {
+          return binary([&](Range lhs, Range rhs) -> MaybeRange {
+            // Only the divisions by positive divisors, of non-negative
+            // dividends for the unsigned ones.
+            bool isUnsigned = isa<arith::DivUIOp>(div);
+            if (rhs.min <= 0 || (isUnsigned && !lhs.isNonNegative()))
+              return std::nullopt;
+            int64_t min = lhs.min >= 0 ? lhs.min / rhs.max : lhs.min / rhs.min;
+            int64_t max = lhs.max >= 0 ? lhs.max / rhs.min : lhs.max / rhs.max;
+            return fit(min, max, bitWidth);
+          });
+        })
+        .Case<arith::RemSIOp, arith::RemUIOp>([&](auto rem) {
+          return binary([&](Range lhs, Range rhs) -> MaybeRange {
+            bool isUnsigned = isa<arith::RemUIOp>(rem);
+            if (rhs.min <= 0 || (isUnsigned && !lhs.isNonNegative()))
+              return std::nullopt;
+            // The remainder has the sign of the dividend.
+            int64_t bound = rhs.max - 1;
+            int64_t min = lhs.min >= 0 ? 0 : std::max(lhs.min, -bound);
+            int64_t max = lhs.max <= 0 ? 0 : std::min(lhs.max, bound);
+            if (lhs.isNonNegative() && lhs.max < rhs.min)
+              min = lhs.min;
+            return fit(min, max, bitWidth);
+          });
+        })
+        .Case<arith::MinSIOp>([&](auto) {
+          return binary([&](Range lhs, Range rhs) -> MaybeRange {
+            return Range{std::min(lhs.min, rhs.min), std::min(lhs.max, rhs.max)};
+          });
+        })
+        .Case<arith::MaxSIOp>([&](auto) {
+          return binary([&](Range lhs, Range rhs) -> MaybeRange {
+            return Range{std::max(lhs.min, rhs.min), std::max(lhs.max, rhs.max)};
+          });
+        })
+        .Case<arith::AndIOp>([&](auto) -> MaybeRange {
+          // The bits of the result are a subset of the bits of the
+          // non-negative operand.
+          MaybeRange lhs = operand(0), rhs = operand(1);
+          int64_t max = INT64_MAX;
+          if (lhs && lhs->isNonNegative())
+            max = lhs->max;
+          if (rhs && rhs->isNonNegative())
+            max = std::min(max, rhs->max);
+          return max == INT64_MAX ? std::nullopt : fit(0, max, bitWidth);
+        })
+        .Case<arith::SelectOp>([&](auto) -> MaybeRange {
+          MaybeRange lhs = operand(1), rhs = operand(2);
+          if (!lhs || !rhs)
+            return std::nullopt;
+          return Range{std::min(lhs->min, rhs->min),
+                       std::max(lhs->max, rhs->max)};
+        })
+        .Default([](Operation *) { return std::nullopt; });
+  }
+
+  // The induction variable of a loop with a positive step is in
+  // [lower bound, upper bound - 1].
+  MaybeRange getInductionVarRange(BlockArgument arg, unsigned depth) {
+    auto forOp = dyn_cast<scf::ForOp>(arg.getOwner()->getParentOp());
+    if (!forOp || arg != forOp.getInductionVar())
+      return std::nullopt;
+    MaybeRange lb = get(forOp.getLowerBound(), depth);
+    MaybeRange ub = get(forOp.getUpperBound(), depth);
+    MaybeRange step = get(forOp.getStep(), depth);
+    if (!lb || !ub || !step || step->min <= 0 || lb->min > ub->max - 1)
+      return std::nullopt;
+    return Range{lb->min, ub->max - 1};
+  }
+
+  DenseMap<Value, MaybeRange> ranges;
+};
+
+// The result of the comparison of all the elements of values in the given
+// ranges, none if it depends on the elements.
+static std::optional<bool> evaluate(arith::CmpIPredicate predicate,
+                                    Range lhs, Range rhs) {
+  using P = arith::CmpIPredicate;
+  // The unsigned comparisons of non-negative values are the signed ones.
+  if (predicate == P::ult || predicate == P::ule || predicate == P::ugt ||
+      predicate == P::uge) {
+    if (!lhs.isNonNegative() || !rhs.isNonNegative())
+      return std::nullopt;
+    predicate = predicate == P::ult   ? P::slt
+                : predicate == P::ule ? P::sle
+                : predicate == P::ugt ? P::sgt
+                                      : P::sge;
+  }
+  switch (predicate) {
+  case P::slt:
+    if (lhs.max < rhs.min)
+      return true;
+    if (lhs.min >= rhs.max)
+      return false;
+    break;
+  case P::sle:
+    if (lhs.max <= rhs.min)
+      return true;
+    if (lhs.min > rhs.max)
+      return false;
+    break;
+  case P::sgt:
+    return evaluate(P::slt, rhs, lhs);
+  case P::sge:
+    return evaluate(P::sle, rhs, lhs);
+  case P::eq:
+  case P::ne: {
+    bool disjoint = lhs.max < rhs.min || rhs.max < lhs.min;
+    bool equal = lhs.min == lhs.max && rhs.min == rhs.max && lhs.min == rhs.min;
+    if (disjoint || equal)
+      return (predicate == P::eq) == equal;
+    break;
+  }
+  default:
+    break;
+  }
+  return std::nullopt;
+}
+
+class FoldMasksPass : public mlir::impl::TritonFoldMasksBase<FoldMasksPass> {
+public:
+  void runOnOperation() override {
+    getOperation().walk([&](tt::FuncOp func) {
+      RangeAnalysis ranges;
+      SmallVector<std::pair<arith::CmpIOp, bool>> folded;
+      func.walk([&](arith::CmpIOp cmp) {
+        MaybeRange lhs = ranges.get(cmp.getLhs());
+        MaybeRange rhs = ranges.get(cmp.getRhs());
+        if (!lhs || !rhs)
+          return;
+        if (std::optional<bool> result =
+                evaluate(cmp.getPredicate(), *lhs, *rhs))
+          folded.push_back({cmp, *result});
+      });
+      for (auto [cmp, result] : folded) {
+        OpBuilder builder(cmp);
+        Type type = cmp.getType();
+        Attribute value = builder.getBoolAttr(result);
+        if (auto tensorTy = type.dyn_cast<RankedTensorType>())
+          value = DenseElementsAttr::get(tensorTy, value);
+        Value constant =
+            builder.create<arith::ConstantOp>(cmp.getLoc(), type, value);
+        cmp.replaceAllUsesWith(constant);
+        cmp.erase();
+      }
+    });
+  }
+};
+
+} // namespace
+
+std::unique_ptr<mlir::Pass> mlir::triton::createFoldMasksPass() {
+  return std::make_unique<FoldMasksPass>();
+}
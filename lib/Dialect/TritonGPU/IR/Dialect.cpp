@@ -173,8 +173,9 @@ SmallVector<unsigned> getContigPerThread(Attribute layout) {
     //    ....
     //    [ 0   1   2   3   ......  14  15 ]
     //      ^
-    // Each thread operates on 1 element per row and 8 elements per column.
-    return {8, 1};
+    // Each thread operates on 1 element per row and `repeatCount` elements
+    // per column, of a single matrix of the batched layouts.
+    return layout.cast<DpasEncodingAttr>().getSizePerThread();
   } else {
     return getSizePerThread(layout);
   }
@@ -246,8 +247,13 @@ SmallVector<unsigned> getOrder(Attribute layout) {
   } else if (auto mmaLayout = layout.dyn_cast<MmaEncodingTrait>()) {
     return {1, 0};
   } else if (auto dpasLayout = layout.dyn_cast<DpasEncodingAttr>()) {
+    // The batch dimension of the batched layouts is the outermost one.
+    if (dpasLayout.getWarpsPerCTA().size() == 3)
+      return {2, 1, 0};
     return {1, 0};
   } else if (auto dotLayout = layout.dyn_cast<DotOperandEncodingAttr>()) {
+    if (dotLayout.getParent().isa<DpasEncodingAttr>())
+      return getOrder(dotLayout.getParent());
     return {1, 0};
   } else if (auto sliceLayout = layout.dyn_cast<SliceEncodingAttr>()) {
     SmallVector<unsigned> parentOrder = getOrder(sliceLayout.getParent());
@@ -900,7 +906,12 @@ SmallVector<unsigned> DpasEncodingAttr::getWarpsPerCTA() const {
                                getWarpsPerCTA__().end());
 }
 SmallVector<unsigned> DpasEncodingAttr::getWarpOrder() const {
-  return ::getOrder(*this);
+  // The consecutive warps are distributed along the rows of a matrix first,
+  // then along its columns, and the batched layouts then move to the next
+  // matrix.
+  if (getRank() == 3)
+    return {1, 2, 0};
+  return {0, 1};
 }
 SmallVector<unsigned> DpasEncodingAttr::getThreadsPerWarp() const {
   // From the DPAS layout:
@@ -910,6 +921,8 @@ SmallVector<unsigned> DpasEncodingAttr::getThreadsPerWarp() const {
   //    [ 0   1   2   3   ......  14  15 ]
   //    ....
   //    [ 0   1   2   3   ......  14  15 ]
+  if (getRank() == 3)
+    return {1, 1, 16};
   return {1, 16};
 }
 SmallVector<unsigned> DpasEncodingAttr::getThreadOrder() const {
@@ -923,27 +936,43 @@ SmallVector<unsigned> DpasEncodingAttr::getSizePerThread() const {
   //    [ 0   1   2   3   ......  14  15 ]
   //    ....
   //    [ 0   1   2   3   ......  14  15 ]
-  // Each thread operates on a column, each column has 8 elements.
-  return {8, 1};
+  // Each thread operates on a column, each column has `repeatCount` elements.
+  if (getRank() == 3)
+    return {1, getRepeatCount(), 1};
+  return {getRepeatCount(), 1};
 }
 SmallVector<unsigned>
 DpasEncodingAttr::getShapePerCTATile(ArrayRef<int64_t> tensorShape) const {
-  // Given by threadsPerWarp ([1,16]) * warpsPerCTA ([8,1]) * warpsPerCTA.
-  return {8 * getWarpsPerCTA()[0], 16 * getWarpsPerCTA()[1]};
+  // Given by threadsPerWarp ([1,16]) * sizePerThread ([repeatCount,1]) *
+  // warpsPerCTA, the warps along the batch dimension each hold a matrix.
+  SmallVector<unsigned> warpsPerCTA = getWarpsPerCTA();
+  unsigned rank = getRank();
+  SmallVector<unsigned> shapePerCTATile(warpsPerCTA.begin(),
+                                        warpsPerCTA.end() - 2);
+  shapePerCTATile.push_back(getRepeatCount() * warpsPerCTA[rank - 2]);
+  shapePerCTATile.push_back(16 * warpsPerCTA[rank - 1]);
+  return shapePerCTATile;
 }
 
 SmallVector<unsigned>
 DpasEncodingAttr::getElemsPerThread(ArrayRef<int64_t> shape, Type eltTy) const {
   size_t rank = shape.size();
-  assert(rank == 2 && "Unexpected rank of dpas layout");
+  assert((rank == 2 || rank == 3) && "Unexpected rank of dpas layout");
+  assert(rank == getRank() && "Unexpected rank of the dpas tensor");
 
+  SmallVector<unsigned> warpsPerCTA = getWarpsPerCTA();
   SmallVector<unsigned> elemsPerThread(rank);
-  constexpr unsigned elemsPerThreadPerTile = 8;
+  if (rank == 3)
+    elemsPerThread[0] = ceil<unsigned>(shape[0], warpsPerCTA[0]);
+  unsigned elemsPerThreadPerTile = getRepeatCount();
   unsigned elemsRow =
-      ceil<unsigned>(shape[0], 8 * getWarpsPerCTA()[0]) * elemsPerThreadPerTile;
-  unsigned elemsCol = ceil<unsigned>(shape[1], 16 * getWarpsPerCTA()[1]);
-  elemsPerThread[0] = elemsRow;
-  elemsPerThread[1] = elemsCol;
+      ceil<unsigned>(shape[rank - 2],
+                     elemsPerThreadPerTile * warpsPerCTA[rank - 2]) *
+      elemsPerThreadPerTile;
+  unsigned elemsCol =
+      ceil<unsigned>(shape[rank - 1], 16 * warpsPerCTA[rank - 1]);
+  elemsPerThread[rank - 2] = elemsRow;
+  elemsPerThread[rank - 1] = elemsCol;
   return elemsPerThread;
 }
 
@@ -959,7 +988,7 @@ DotOperandEncodingAttr::getDPASElemsPerInstr(unsigned bitWidth) const {
   // N = exec_size = SIMD_width = 16
   // SD = 8
   // K = SD * number of packed operands in each Dword (OpsPerChannel)
-  unsigned RC = 8u;
+  unsigned RC = getParent().cast<DpasEncodingAttr>().getRepeatCount();
   unsigned execSize = 16u;
   unsigned SD = 8u;
   unsigned OpsPerChannel = std::max(1u, std::min(32u / bitWidth, 8u));
@@ -979,16 +1008,25 @@ DotOperandEncodingAttr::getDPASRep(ArrayRef<int64_t> operandShape,
   SmallVector<int64_t> operandTileShape =
       getDPASElemsPerInstr(elemType.getIntOrFloatBitWidth());
   auto warpsPerCTA = getParent().cast<DpasEncodingAttr>().getWarpsPerCTA();
-  if (getOpIdx() == 0)
-    return {std::max<int64_t>(1, operandShape[0] /
-                                     (operandTileShape[0] * warpsPerCTA[0])),
-            std::max<int64_t>(1, operandShape[1] / operandTileShape[1])};
-  else {
+  size_t rank = operandShape.size();
+  assert(rank == warpsPerCTA.size() && "Unexpected rank of the dot operand");
+  // The matrices of the batch dimension are distributed in turn to the warps
+  // along it.
+  SmallVector<int64_t> rep;
+  if (rank == 3)
+    rep.push_back(ceil<int64_t>(operandShape[0], warpsPerCTA[0]));
+  int64_t rows = operandShape[rank - 2], cols = operandShape[rank - 1];
+  if (getOpIdx() == 0) {
+    rep.push_back(std::max<int64_t>(
+        1, rows / (operandTileShape[0] * warpsPerCTA[rank - 2])));
+    rep.push_back(std::max<int64_t>(1, cols / operandTileShape[1]));
+  } else {
     assert(getOpIdx() == 1);
-    return {std::max<int64_t>(1, operandShape[0] / operandTileShape[0]),
-            std::max<int64_t>(1, operandShape[1] /
-                                     (operandTileShape[1] * warpsPerCTA[1]))};
+    rep.push_back(std::max<int64_t>(1, rows / operandTileShape[0]));
+    rep.push_back(std::max<int64_t>(
+        1, cols / (operandTileShape[1] * warpsPerCTA[rank - 1])));
   }
+  return rep;
 }
 
 SmallVector<unsigned>
@@ -1000,10 +1038,8 @@ DotOperandEncodingAttr::getElemsPerThread(ArrayRef<int64_t> shape,
 
 unsigned DotOperandEncodingAttr::getTotalElemsPerThread(ArrayRef<int64_t> shape,
                                                         Type eltTy) const {
-  if (auto dpasParent = getParent().dyn_cast<DpasEncodingAttr>()) {
-    auto rep = getDPASRep(shape, eltTy);
-    return rep[0] * rep[1];
-  }
+  if (auto dpasParent = getParent().dyn_cast<DpasEncodingAttr>())
+    return product<int64_t>(getDPASRep(shape, eltTy));
 
   if (auto mmaParent = getParent().dyn_cast<MmaEncodingTrait>()) {
     return mmaParent.getTotalElemsPerThreadForOperands(shape, eltTy,
@@ -334,7 +334,6 @@ public:
     return success();
   }
 };
-} // namespace
 
 static Value promoteOperand(OpBuilder &builder, Location loc, Value operand,
                             Type promotedType) {
@@ -360,6 +359,437 @@ static Value promoteOperand(OpBuilder &builder, Location loc, Value operand,
       });
 }
 
+SmallVector<unsigned> warpsPerTileDPAS(tt::DotOp dotOp,
+                                       const ArrayRef<int64_t> shape,
+                                       int numWarps,
+                                       const SmallVector<int64_t, 2> &
+                                           shapePerWarp) {
+  auto filter = [&dotOp](Operation *op) {
+    return op->getParentRegion() == dotOp->getParentRegion();
+  };
+  auto slices = multiRootGetSlice(dotOp, {filter}, {filter});
+  for (Operation *op : slices)
+    if (isa<tt::DotOp>(op) && (op != dotOp)) {
+      // Chained dots share the same warp distribution so that the result of
+      // the first one can be fed to the second one without shuffling data
+      // between warps.
+      if (auto dpasEncoding = op->getResult(0)
+                                  .getType()
+                                  .cast<RankedTensorType>()
+                                  .getEncoding()
+                                  .dyn_cast<DpasEncodingAttr>())
+        return dpasEncoding.getWarpsPerCTA();
+      if (shape[0] >= shape[1])
+        return {(unsigned)numWarps, 1};
+      return {1, (unsigned)numWarps};
+    }
+
+  SmallVector<unsigned> ret = {1, 1};
+  uint32_t rowColRatio = ceil<uint32_t>(shapePerWarp[0], shapePerWarp[1]);
+  uint32_t colRowRatio = ceil<uint32_t>(shapePerWarp[1], shapePerWarp[0]);
+  do {
+    if (ret[0] * ret[1] >= numWarps)
+      break;
+    if (shape[0] / (shapePerWarp[0] * colRowRatio) / ret[0] >=
+        shape[1] / (shapePerWarp[1] * rowColRatio) / ret[1]) {
+      if (ret[0] < shape[0] / shapePerWarp[0])
+        ret[0] *= 2;
+      else
+        ret[1] *= 2;
+    } else {
+      if (ret[1] < shape[1] / shapePerWarp[1])
+        ret[1] *= 2;
+      else
+        ret[0] *= 2;
+    }
+  } while (true);
+  return ret;
+}
+
+// Return the type in which DPAS multiplies fp8 operands with operands of
+// element types `AElTy` and `BElTy`, or a null type if it can't. DPAS has no
+// fp8 precision: fp8 operands, e.g. the weights of fp8 weight-only quantized
+// matmuls, are multiplied in the 16-bit float type of the other operand, or
+// in f16. All the fp8 types with a conversion to f16 are exactly representable
+// in f16 and bf16.
+static Type getDPASMixedModeType(Type AElTy, Type BElTy) {
+  auto isFP8 = [](Type elTy) {
+    return elTy.isFloat8E5M2() || elTy.isFloat8E4M3FNUZ() ||
+           elTy.isFloat8E4M3B11FNUZ() || elTy.isFloat8E4M3FN();
+  };
+  if (isFP8(AElTy) && isFP8(BElTy))
+    return Float16Type::get(AElTy.getContext());
+  if ((AElTy.isF16() || AElTy.isBF16()) && isFP8(BElTy))
+    return AElTy;
+  if ((BElTy.isF16() || BElTy.isBF16()) && isFP8(AElTy))
+    return BElTy;
+  return Type();
+}
+
+// Select the repeat count of the DPAS encoding of a dot with a result tile of
+// `shape` per CTA. A repeat count of 8 uses the whole systolic depth, smaller
+// ones let the warps split the rows of skinny tiles, e.g. of decoding GEMMs,
+// rather than replicating the computation of the same rows. DPAS operands
+// have at least 2 rows, as a repeat count of 1 leaves half of the lanes
+// without A operand elements.
+static unsigned getDPASRepeatCount(ArrayRef<int64_t> shape, int numWarps,
+                                   unsigned systolicDepth,
+                                   unsigned executionSize) {
+  auto getNumTiles = [&](unsigned repeatCount) {
+    return (shape[0] / repeatCount) * (shape[1] / executionSize);
+  };
+  unsigned repeatCount = systolicDepth;
+  while (repeatCount > 2 && (shape[0] % repeatCount != 0 ||
+                             getNumTiles(repeatCount) < numWarps))
+    repeatCount /= 2;
+  return repeatCount;
+}
+
+class BlockedToDPAS : public mlir::RewritePattern {
+  ttg::intel::DeviceArch deviceArch;
+  // The repeat count of the DPAS encodings, selected from the dot shape if 0.
+  unsigned repeatCount;
+
+public:
+  BlockedToDPAS(mlir::MLIRContext *context, ttg::intel::DeviceArch deviceArch,
+                unsigned repeatCount)
+      : mlir::RewritePattern(tt::DotOp::getOperationName(), 2, context),
+        deviceArch(deviceArch), repeatCount(repeatCount) {}
+
+  // Only PVC provides the SIMD16 systolic arrays modeled by the DPAS
+  // encoding.
+  static bool supportDPASArch(ttg::intel::DeviceArch arch) {
+    return arch == ttg::intel::DeviceArch::PVC;
+  }
+
+  // The instruction shape of DPAS is [repeatCount, executionSize] for the
+  // result and [systolicDepth * opsPerChannel] for the reduction dimension.
+  static constexpr unsigned systolicDepth = 8;
+  static constexpr unsigned executionSize = 16;
+
+  // The type DPAS multiplies the operands of the dot in, or a null type if it
+  // can't.
+  static Type getDPASElemType(tt::DotOp dotOp) {
+    Type AElTy =
+        dotOp.getA().getType().cast<RankedTensorType>().getElementType();
+    Type BElTy =
+        dotOp.getB().getType().cast<RankedTensorType>().getElementType();
+    if (supportDPAS(dotOp))
+      return AElTy;
+    if (!dotOp.getType().cast<RankedTensorType>().getElementType().isF32())
+      return Type();
+    return getDPASMixedModeType(AElTy, BElTy);
+  }
+
+  unsigned getRepeatCount(ArrayRef<int64_t> retShapePerCTA,
+                          int numWarps) const {
+    return repeatCount ? repeatCount
+                       : getDPASRepeatCount(retShapePerCTA, numWarps,
+                                            systolicDepth, executionSize);
+  }
+
+  // Why the dot can't be mapped to DPAS, or an empty string if it can.
+  std::string getDPASMismatch(tt::DotOp dotOp) const {
+    if (!supportDPASArch(deviceArch))
+      return "no DPAS on the target architecture";
+    auto retType = dotOp.getResult().getType().cast<RankedTensorType>();
+    auto AType = dotOp.getA().getType().cast<RankedTensorType>();
+    auto BType = dotOp.getB().getType().cast<RankedTensorType>();
+    Type elemType = getDPASElemType(dotOp);
+    if (!elemType) {
+      std::string reason;
+      llvm::raw_string_ostream os(reason);
+      os << "unsupported types " << AType.getElementType() << " x "
+         << BType.getElementType() << " -> " << retType.getElementType();
+      return os.str();
+    }
+    // f32 operands are multiplied as tf32 by the XMX units.
+    if (AType.getElementType().isF32() && !dotOp.getAllowTF32())
+      return "f32 operands without allowTF32";
+
+    auto mod = dotOp->getParentOfType<mlir::ModuleOp>();
+    int numWarps = ttg::TritonGPUDialect::getNumWarps(mod);
+    int threadsPerWarp = ttg::TritonGPUDialect::getThreadsPerWarp(mod);
+    if (threadsPerWarp != executionSize)
+      return "sub-group size " + std::to_string(threadsPerWarp) + " isn't " +
+             std::to_string(executionSize);
+
+    auto retShapePerCTA = ttg::getShapePerCTA(retType);
+    auto AShapePerCTA = ttg::getShapePerCTA(AType);
+    if (retShapePerCTA.size() != 2 && retShapePerCTA.size() != 3)
+      return "rank " + std::to_string(retShapePerCTA.size()) + " dot";
+    // The batched dots are made of the dots of their matrices.
+    auto matrixShape = ArrayRef<int64_t>(retShapePerCTA).take_back(2);
+    int64_t K = AShapePerCTA.back();
+    unsigned opsPerChannel =
+        std::max(1u, std::min(32u / elemType.getIntOrFloatBitWidth(), 8u));
+    unsigned repeatCount = getRepeatCount(
+        matrixShape, numWarps / getNumBatchWarps(retShapePerCTA, numWarps));
+    if (matrixShape[0] % repeatCount != 0 ||
+        matrixShape[1] % executionSize != 0 ||
+        K % (systolicDepth * opsPerChannel) != 0)
+      return "shape " + std::to_string(matrixShape[0]) + "x" +
+             std::to_string(matrixShape[1]) + "x" + std::to_string(K) +
+             " isn't a multiple of the DPAS tile " +
+             std::to_string(repeatCount) + "x" +
+             std::to_string(executionSize) + "x" +
+             std::to_string(systolicDepth * opsPerChannel);
+    // The packed int4 B operands are unpacked in the DPAS operand layout, the
+    // packed bytes are themselves a whole number of i8 DPAS operands.
+    auto unpack = dotOp.getB().getDefiningOp<tt::UnpackInt4Op>();
+    if (unpack && (BType.getElementType() != elemType ||
+                   retShapePerCTA.size() != 2 ||
+                   K % (2 * systolicDepth * 4) != 0))
+      return "unsupported int4 unpacking of the B operand";
+    return "";
+  }
+
+  // The number of warps distributed along the batch dimension of a batched
+  // dot, each computing the dots of its matrices on its own: the largest
+  // power of 2 dividing the batch size, up to `numWarps`.
+  static unsigned getNumBatchWarps(ArrayRef<int64_t> retShapePerCTA,
+                                   int numWarps) {
+    if (retShapePerCTA.size() != 3)
+      return 1;
+    unsigned batchWarps = 1;
+    while (batchWarps * 2 <= unsigned(numWarps) &&
+           retShapePerCTA[0] % (batchWarps * 2) == 0)
+      batchWarps *= 2;
+    return batchWarps;
+  }
+
+  mlir::LogicalResult
+  matchAndRewrite(mlir::Operation *op,
+                  mlir::PatternRewriter &rewriter) const override {
+    auto dotOp = cast<tt::DotOp>(op);
+    auto oldRetType = dotOp.getResult().getType().cast<RankedTensorType>();
+    if (!oldRetType.getEncoding() ||
+        oldRetType.getEncoding().isa<DpasEncodingAttr>())
+      return failure();
+    if (!getDPASMismatch(dotOp).empty())
+      return failure();
+
+    Value a = dotOp.getA();
+    Value b = dotOp.getB();
+    auto oldAType = a.getType().cast<RankedTensorType>();
+    auto oldBType = b.getType().cast<RankedTensorType>();
+    Type AElTy = oldAType.getElementType(), BElTy = oldBType.getElementType();
+    Type elemType = getDPASElemType(dotOp);
+
+    auto mod = op->getParentOfType<mlir::ModuleOp>();
+    int numWarps = ttg::TritonGPUDialect::getNumWarps(mod);
+    auto retShapePerCTA = ttg::getShapePerCTA(oldRetType);
+    unsigned batchWarps = getNumBatchWarps(retShapePerCTA, numWarps);
+    auto matrixShape = ArrayRef<int64_t>(retShapePerCTA).take_back(2);
+    unsigned repeatCount = getRepeatCount(matrixShape, numWarps / batchWarps);
+    auto unpack = b.getDefiningOp<tt::UnpackInt4Op>();
+
+    SmallVector<unsigned> warpsPerTile =
+        warpsPerTileDPAS(dotOp, matrixShape, numWarps / batchWarps,
+                         {(int64_t)repeatCount, (int64_t)executionSize});
+    if (retShapePerCTA.size() == 3 && warpsPerTile.size() == 2)
+      warpsPerTile.insert(warpsPerTile.begin(), batchWarps);
+    auto CTALayout = ttg::getCTALayout(oldRetType.getEncoding());
+    auto dpasEnc = DpasEncodingAttr::get(oldRetType.getContext(), repeatCount,
+                                         warpsPerTile, CTALayout);
+    auto newRetType = RankedTensorType::get(
+        oldRetType.getShape(), oldRetType.getElementType(), dpasEnc);
+
+    // convert accumulator
+    auto oldAcc = dotOp.getOperand(2);
+    auto newAcc = rewriter.create<ttg::ConvertLayoutOp>(oldAcc.getLoc(),
+                                                        newRetType, oldAcc);
+    // Upcast the fp8 operands in the layout they were loaded in, so that the
+    // conversion is done in registers right after the load.
+    if (AElTy != elemType)
+      a = promoteOperand(rewriter, a.getLoc(), a, elemType);
+    if (BElTy != elemType)
+      b = promoteOperand(rewriter, b.getLoc(), b, elemType);
+
+    // convert operands
+    auto newAEncoding = ttg::DotOperandEncodingAttr::get(oldAType.getContext(),
+                                                         0, dpasEnc, elemType);
+    auto newAType =
+        RankedTensorType::get(oldAType.getShape(), elemType, newAEncoding);
+    a = rewriter.create<ttg::ConvertLayoutOp>(a.getLoc(), newAType, a);
+    auto newBEncoding = ttg::DotOperandEncodingAttr::get(oldBType.getContext(),
+                                                         1, dpasEnc, elemType);
+    auto newBType =
+        RankedTensorType::get(oldBType.getShape(), elemType, newBEncoding);
+    if (unpack) {
+      auto packedType = unpack.getSrc().getType().cast<RankedTensorType>();
+      auto newPackedType = RankedTensorType::get(
+          packedType.getShape(), packedType.getElementType(), newBEncoding);
+      Value packed = rewriter.create<ttg::ConvertLayoutOp>(
+          unpack.getLoc(), newPackedType, unpack.getSrc());
+      b = rewriter.create<tt::UnpackInt4Op>(unpack.getLoc(), newBType, packed,
+                                            unpack.getIsSigned());
+    } else {
+      b = rewriter.create<ttg::ConvertLayoutOp>(b.getLoc(), newBType, b);
+    }
+
+    // convert dot instruction
+    auto newDot = rewriter.create<tt::DotOp>(dotOp.getLoc(), newRetType, a, b,
+                                             newAcc, dotOp.getAllowTF32(),
+                                             dotOp.getMaxNumImpreciseAcc());
+
+    rewriter.replaceOpWithNewOp<ttg::ConvertLayoutOp>(op, oldRetType,
+                                                      newDot.getResult());
+    return success();
+  }
+};
+
+// The skinny dots, with at most `maxGEMVRows` rows or columns, e.g. those of
+// the decoding of a single sequence, would leave most of the DPAS tiles
+// padded and are bound by the loads of their large operand. They are computed
+// as matrix-vector products, the reduction along K of the products of their
+// broadcast operands:
+//
+//   C[m, n] = C0[m, n] + sum_k A[m, k, .] * B[., k, n]
+//
+// The products are laid out like the large operand was loaded, so that its
+// loads stay coalesced, and the small dimension is held by each work-item.
+// The reduction is then done within the work-items, with sub-group
+// reductions where K is distributed across the work-items, and through the
+// shared local memory where it is split across the warps.
+class DotToGEMV : public mlir::RewritePattern {
+public:
+  DotToGEMV(mlir::MLIRContext *context)
+      : mlir::RewritePattern(tt::DotOp::getOperationName(), 3, context) {}
+
+  static constexpr int64_t maxGEMVRows = 8;
+  // The products each work-item may hold, beyond which the dot is left to
+  // the DPAS or the FMA units.
+  static constexpr int64_t maxProductsPerThread = 256;
+
+  // The blocked layout `operand` of the dot was converted from.
+  static BlockedEncodingAttr getSourceEncoding(Value operand) {
+    auto cvt = operand.getDefiningOp<ttg::ConvertLayoutOp>();
+    if (!cvt)
+      return BlockedEncodingAttr();
+    return cvt.getSrc()
+        .getType()
+        .cast<RankedTensorType>()
+        .getEncoding()
+        .dyn_cast<BlockedEncodingAttr>();
+  }
+
+  static bool isGEMV(tt::DotOp dotOp) {
+    auto retType = dotOp.getType().cast<RankedTensorType>();
+    if (retType.getRank() != 2 || !retType.getEncoding() ||
+        !retType.getEncoding().isa<BlockedEncodingAttr>())
+      return false;
+    ArrayRef<int64_t> shape = retType.getShape();
+    if (std::min(shape[0], shape[1]) > maxGEMVRows)
+      return false;
+    if (!getSourceEncoding(dotOp.getA()) || !getSourceEncoding(dotOp.getB()))
+      return false;
+    Type AElTy =
+        dotOp.getA().getType().cast<RankedTensorType>().getElementType();
+    Type elemType = retType.getElementType();
+    if (AElTy.isa<FloatType>() != elemType.isa<FloatType>())
+      return false;
+    auto mod = dotOp->getParentOfType<mlir::ModuleOp>();
+    int64_t numThreads = ttg::TritonGPUDialect::getNumWarps(mod) *
+                         ttg::TritonGPUDialect::getThreadsPerWarp(mod);
+    int64_t K = dotOp.getA().getType().cast<RankedTensorType>().getShape()[1];
+    return shape[0] * shape[1] * K <= maxProductsPerThread * numThreads;
+  }
+
+  // The 3D layout of the products, `encoding` of the large operand with the
+  // dimension `dim` of size `size` held by each work-item.
+  static BlockedEncodingAttr getProductEncoding(BlockedEncodingAttr encoding,
+                                                unsigned dim, unsigned size) {
+    auto insert = [&](ArrayRef<unsigned> values, unsigned value) {
+      SmallVector<unsigned> result(values);
+      result.insert(result.begin() + dim, value);
+      return result;
+    };
+    // The order of the operand dimensions, then the small one.
+    auto insertOrder = [&](ArrayRef<unsigned> order) {
+      SmallVector<unsigned> result;
+      for (unsigned d : order)
+        result.push_back(d >= dim ? d + 1 : d);
+      result.push_back(dim);
+      return result;
+    };
+    ttg::CTALayoutAttr CTALayout = encoding.getCTALayout();
+    auto CTALayout3D = ttg::CTALayoutAttr::get(
+        encoding.getContext(), insert(CTALayout.getCTAsPerCGA(), 1),
+        insert(CTALayout.getCTASplitNum(), 1),
+        insertOrder(CTALayout.getCTAOrder()));
+    return BlockedEncodingAttr::get(
+        encoding.getContext(), insert(encoding.getSizePerThread(), size),
+        insert(encoding.getThreadsPerWarp(), 1),
+        insert(encoding.getWarpsPerCTA(), 1),
+        insertOrder(encoding.getOrder()), CTALayout3D);
+  }
+
+  mlir::LogicalResult
+  matchAndRewrite(mlir::Operation *op,
+                  mlir::PatternRewriter &rewriter) const override {
+    auto dotOp = cast<tt::DotOp>(op);
+    if (!isGEMV(dotOp))
+      return failure();
+
+    auto retType = dotOp.getType().cast<RankedTensorType>();
+    Type elemType = retType.getElementType();
+    int64_t M = retType.getShape()[0], N = retType.getShape()[1];
+    int64_t K = dotOp.getA().getType().cast<RankedTensorType>().getShape()[1];
+    MLIRContext *ctx = op->getContext();
+    Location loc = dotOp.getLoc();
+
+    // B is the large operand of the few rows of A, and A of the few columns
+    // of B.
+    bool fewRows = M <= N;
+    BlockedEncodingAttr encoding = getProductEncoding(
+        getSourceEncoding(fewRows ? dotOp.getB() : dotOp.getA()),
+        fewRows ? 0 : 2, fewRows ? M : N);
+    auto productType = RankedTensorType::get({M, K, N}, elemType, encoding);
+
+    // A[m, k] -> A[m, k, n] and B[k, n] -> B[m, k, n].
+    auto broadcast = [&](Value operand, unsigned axis) -> Value {
+      Value src = operand.getDefiningOp<ttg::ConvertLayoutOp>().getSrc();
+      auto srcType = src.getType().cast<RankedTensorType>();
+      if (srcType.getElementType() != elemType)
+        src = promoteOperand(rewriter, loc, src, elemType);
+      auto sliceType = RankedTensorType::get(
+          srcType.getShape(), elemType,
+          SliceEncodingAttr::get(ctx, axis, encoding));
+      src = rewriter.create<ttg::ConvertLayoutOp>(loc, sliceType, src);
+      Value expanded = rewriter.create<tt::ExpandDimsOp>(loc, src, axis);
+      return rewriter.create<tt::BroadcastOp>(loc, productType, expanded);
+    };
+    Value a = broadcast(dotOp.getA(), 2);
+    Value b = broadcast(dotOp.getB(), 0);
+    bool isFloat = elemType.isa<FloatType>();
+    Value product =
+        isFloat ? rewriter.create<arith::MulFOp>(loc, a, b).getResult()
+                : rewriter.create<arith::MulIOp>(loc, a, b).getResult();
+
+    auto add = [&](Value lhs, Value rhs) -> Value {
+      if (isFloat)
+        return rewriter.create<arith::AddFOp>(loc, lhs, rhs);
+      return rewriter.create<arith::AddIOp>(loc, lhs, rhs);
+    };
+    auto reduce = rewriter.create<tt::ReduceOp>(loc, ValueRange{product}, 1);
+    {
+      OpBuilder::InsertionGuard guard(rewriter);
+      Block *combine = rewriter.createBlock(&reduce.getCombineOp(), {},
+                                            {elemType, elemType}, {loc, loc});
+      rewriter.create<tt::ReduceReturnOp>(
+          loc, add(combine->getArgument(0), combine->getArgument(1)));
+    }
+    Value sum = reduce.getResult()[0];
+    Value acc = rewriter.create<ttg::ConvertLayoutOp>(loc, sum.getType(),
+                                                      dotOp.getC());
+    rewriter.replaceOpWithNewOp<ttg::ConvertLayoutOp>(op, retType,
+                                                      add(acc, sum));
+    return success();
+  }
+};
+} // namespace
+
 // promote operands of dot op if the existing combination is not natively
 // supported.
 static void decomposeMixedModeDotOp(ModuleOp mod) {
@@ -438,3 +868,54 @@ std::unique_ptr<Pass>
 mlir::triton::gpu::createAccelerateMatmulPass(int computeCapability) {
   return std::make_unique<TritonGPUAccelerateMatmulPass>(computeCapability);
 }
+
+class TritonIntelGPUAccelerateMatmulPass
+    : public TritonIntelGPUAccelerateMatmulBase<
+          TritonIntelGPUAccelerateMatmulPass> {
+public:
+  TritonIntelGPUAccelerateMatmulPass() = default;
+  TritonIntelGPUAccelerateMatmulPass(ttg::intel::DeviceArch arch) {
+    this->deviceArch = arch;
+  }
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    ModuleOp m = getOperation();
+
+    if (!llvm::is_contained({0u, 2u, 4u, 8u}, unsigned(repeatCount))) {
+      m.emitError("unsupported DPAS repeat count: ") << repeatCount;
+      return signalPassFailure();
+    }
+
+    mlir::RewritePatternSet patterns(context);
+    patterns.add<::BlockedToDPAS>(context, deviceArch, repeatCount);
+    patterns.add<::DotToGEMV>(context);
+    if (applyPatternsAndFoldGreedily(m, std::move(patterns)).failed()) {
+      signalPassFailure();
+    }
+    // Report the dots left on the FMA units, once the patterns converged.
+    ::BlockedToDPAS blockedToDPAS(context, deviceArch, repeatCount);
+    bool hasUnmappedBatchedDot = false;
+    m.walk([&](tt::DotOp dotOp) {
+      auto retType = dotOp.getType().cast<RankedTensorType>();
+      if (!retType.getEncoding() ||
+          retType.getEncoding().isa<DpasEncodingAttr>())
+        return;
+      std::string reason = blockedToDPAS.getDPASMismatch(dotOp);
+      // The FMA lowering only handles the dots of matrices.
+      if (retType.getRank() == 3) {
+        dotOp.emitError() << "batched dot not mapped to DPAS: " << reason;
+        hasUnmappedBatchedDot = true;
+      } else if (!reason.empty()) {
+        dotOp.emitRemark() << "dot not mapped to DPAS: " << reason;
+      }
+    });
+    if (hasUnmappedBatchedDot)
+      return signalPassFailure();
+    decomposeMixedModeDotOp(m);
+  }
+};
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::intel::createAccelerateMatmulPass(DeviceArch arch) {
+  return std::make_unique<TritonIntelGPUAccelerateMatmulPass>(arch);
+}
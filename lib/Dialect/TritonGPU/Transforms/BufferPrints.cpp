@@ -0,0 +1,332 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+
+//===----------------------------------------------------------------------===//
+// This file replaces the prints and the assertions of a kernel by records
+// appended to a buffer, instead of the printf and __assert_fail of the device
+// that serialize its work-items:
+//
+//   tt.func @kernel(..., %prints: !tt.ptr<i64, 1>) {
+//     %base = atomic_add(%prints, 4 + n)
+//     if %base + 4 + n <= %prints[1]:
+//       %prints[2 + %base ...] = [id, pid x, pid y, pid z, n values]
+//   }
+//
+// The first slot of the buffer is the cursor the records are reserved at, the
+// second one its capacity, given by the host. The records that don't fit are
+// dropped but still reserved, so that the host knows how many slots it missed.
+// A print reserves a single record for all the elements of its operands, an
+// assertion one record [id, pid x, pid y, pid z, index] per false element of
+// its condition, and the kernel goes on. The module gets a
+// `triton_gpu.buffered_prints` attribute describing each record as JSON, the
+// launcher passes the buffer and decodes the records on the host.
+//
+// The pass runs on TTIR, so that the offsets of the values are built without
+// layouts.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-buffer-prints"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace {
+
+// The slots of the buffer before the records, after its cursor.
+constexpr int64_t capacitySlot = 1;
+constexpr int64_t firstRecordSlot = 2;
+// The id and the program id of a record.
+constexpr int64_t headerSize = 4;
+
+static Type getI64Like(Type type) {
+  auto i64 = IntegerType::get(type.getContext(), 64);
+  if (auto tensorTy = dyn_cast<RankedTensorType>(type))
+    return RankedTensorType::get(tensorTy.getShape(), i64);
+  return i64;
+}
+
+static Value splat(OpBuilder &b, Location loc, Value value,
+                   ArrayRef<int64_t> shape) {
+  return b.create<tt::SplatOp>(
+      loc, RankedTensorType::get(shape, value.getType()), value);
+}
+
+static Value addPtr(OpBuilder &b, Location loc, Value ptr, Value offset) {
+  return b.create<tt::AddPtrOp>(loc, ptr.getType(), ptr, offset);
+}
+
+// The bits of `value` in the i64 slots of the buffer: the integers sign
+// extended, the booleans zero extended, the floats extended to f64.
+static Value toSlots(OpBuilder &b, Location loc, Value value) {
+  Type type = value.getType();
+  Type elemTy = getElementTypeOrSelf(type);
+  Type i64Ty = getI64Like(type);
+  if (isa<tt::PointerType>(elemTy))
+    return b.create<tt::PtrToIntOp>(loc, i64Ty, value);
+  if (auto intTy = dyn_cast<IntegerType>(elemTy)) {
+    if (intTy.getWidth() == 64)
+      return value;
+    if (intTy.getWidth() == 1)
+      return b.create<arith::ExtUIOp>(loc, i64Ty, value);
+    return b.create<arith::ExtSIOp>(loc, i64Ty, value);
+  }
+  if (auto floatTy = dyn_cast<FloatType>(elemTy)) {
+    if (floatTy.getWidth() < 64) {
+      Type f64Ty = b.getF64Type();
+      if (auto tensorTy = dyn_cast<RankedTensorType>(type))
+        f64Ty = RankedTensorType::get(tensorTy.getShape(), f64Ty);
+      value = b.create<arith::ExtFOp>(loc, f64Ty, value);
+    }
+    return b.create<arith::BitcastOp>(loc, i64Ty, value);
+  }
+  return Value();
+}
+
+// The row-major index of each element of a tensor of `shape`.
+static Value getFlatIndex(OpBuilder &b, Location loc, ArrayRef<int64_t> shape) {
+  auto indexTy = RankedTensorType::get(shape, b.getI64Type());
+  Value index;
+  int64_t stride = 1;
+  for (int d = shape.size() - 1; d >= 0; --d) {
+    Value range = b.create<tt::MakeRangeOp>(
+        loc, RankedTensorType::get({shape[d]}, b.getI32Type()), 0, shape[d]);
+    range = b.create<arith::ExtSIOp>(
+        loc, RankedTensorType::get({shape[d]}, b.getI64Type()), range);
+    for (int j = 0; j < static_cast<int>(shape.size()); ++j)
+      if (j != d)
+        range = b.create<tt::ExpandDimsOp>(loc, range, j);
+    if (stride != 1) {
+      Value strideVal = b.create<arith::ConstantIntOp>(loc, stride, 64);
+      range = b.create<arith::MulIOp>(
+          loc, range,
+          splat(b, loc, strideVal,
+                cast<RankedTensorType>(range.getType()).getShape()));
+    }
+    if (shape.size() > 1)
+      range = b.create<tt::BroadcastOp>(loc, indexTy, range);
+    if (index)
+      range = b.create<arith::AddIOp>(loc, index, range);
+    index = range;
+    stride *= shape[d];
+  }
+  return index;
+}
+
+static void store(OpBuilder &b, Location loc, Value ptr, Value value,
+                  Value mask) {
+  b.create<tt::StoreOp>(loc, ptr, value, mask, tt::CacheModifier::NONE,
+                        tt::EvictionPolicy::NORMAL);
+}
+
+// The id of the record and the program id, in the first slots of `record`.
+static void storeHeader(OpBuilder &b, Location loc, Value record, int64_t id,
+                        Value mask, ArrayRef<int64_t> shape = {}) {
+  MLIRContext *ctx = b.getContext();
+  auto slot = [&](Value value, int64_t offset) {
+    if (!shape.empty())
+      value = splat(b, loc, value, shape);
+    Value offsetVal = b.create<arith::ConstantIntOp>(loc, offset, 64);
+    if (!shape.empty())
+      offsetVal = splat(b, loc, offsetVal, shape);
+    store(b, loc, addPtr(b, loc, record, offsetVal), value, mask);
+  };
+  slot(b.create<arith::ConstantIntOp>(loc, id, 64), 0);
+  tt::ProgramIDDim dims[] = {tt::ProgramIDDim::X, tt::ProgramIDDim::Y,
+                            tt::ProgramIDDim::Z};
+  for (auto [axis, dim] : llvm::enumerate(dims)) {
+    Value pid = b.create<tt::GetProgramIdOp>(
+        loc, b.getI32Type(), tt::ProgramIDDimAttr::get(ctx, dim));
+    slot(b.create<arith::ExtSIOp>(loc, b.getI64Type(), pid), 1 + axis);
+  }
+}
+
+static Value loadCapacity(OpBuilder &b, Location loc, Value buffer) {
+  Value offset = b.create<arith::ConstantIntOp>(loc, capacitySlot, 32);
+  return b.create<tt::LoadOp>(loc, addPtr(b, loc, buffer, offset),
+                              tt::CacheModifier::NONE,
+                              tt::EvictionPolicy::NORMAL, /*isVolatile=*/true);
+}
+
+static std::string getTypeName(Type type) {
+  std::string name;
+  llvm::raw_string_ostream os(name);
+  type.print(os);
+  return os.str();
+}
+
+static std::string bufferPrint(tt::PrintOp op, Value buffer, int64_t id) {
+  OpBuilder b(op);
+  Location loc = op.getLoc();
+  llvm::json::Array args;
+  int64_t numSlots = headerSize;
+  for (Value arg : op.getArgs()) {
+    Type elemTy = getElementTypeOrSelf(arg.getType());
+    llvm::json::Array shape;
+    int64_t numElements = 1;
+    if (auto tensorTy = dyn_cast<RankedTensorType>(arg.getType())) {
+      for (int64_t dim : tensorTy.getShape())
+        shape.push_back(dim);
+      numElements = tensorTy.getNumElements();
+    }
+    args.push_back(
+        llvm::json::Object{{"type", getTypeName(elemTy)}, {"shape", shape}});
+    numSlots += numElements;
+  }
+
+  Value size = b.create<arith::ConstantIntOp>(loc, numSlots, 64);
+  Value base = b.create<tt::AtomicRMWOp>(
+      loc, b.getI64Type(), tt::RMWOp::ADD, buffer, size, Value(),
+      tt::MemSemantic::RELAXED, tt::MemSyncScope::GPU);
+  Value end = b.create<arith::AddIOp>(loc, base, size);
+  Value fits = b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::sle, end,
+                                       loadCapacity(b, loc, buffer));
+  Value first = b.create<arith::ConstantIntOp>(loc, firstRecordSlot, 64);
+  Value record =
+      addPtr(b, loc, buffer, b.create<arith::AddIOp>(loc, base, first));
+  storeHeader(b, loc, record, id, fits);
+
+  int64_t offset = headerSize;
+  for (Value arg : op.getArgs()) {
+    auto tensorTy = dyn_cast<RankedTensorType>(arg.getType());
+    Value value = toSlots(b, loc, arg);
+    Value offsetVal = b.create<arith::ConstantIntOp>(loc, offset, 64);
+    if (!tensorTy) {
+      if (value)
+        store(b, loc, addPtr(b, loc, record, offsetVal), value, fits);
+      offset += 1;
+      continue;
+    }
+    ArrayRef<int64_t> shape = tensorTy.getShape();
+    if (value) {
+      Value ptrs = splat(b, loc, record, shape);
+      Value offsets = b.create<arith::AddIOp>(
+          loc, splat(b, loc, offsetVal, shape), getFlatIndex(b, loc, shape));
+      store(b, loc, addPtr(b, loc, ptrs, offsets), value,
+            splat(b, loc, fits, shape));
+    }
+    offset += tensorTy.getNumElements();
+  }
+
+  llvm::json::Object desc{{"kind", "print"},
+                          {"prefix", op.getPrefix().str()},
+                          {"args", std::move(args)}};
+  return llvm::formatv("{0}", llvm::json::Value(std::move(desc)));
+}
+
+static std::string bufferAssert(tt::AssertOp op, Value buffer, int64_t id) {
+  OpBuilder b(op);
+  Location loc = op.getLoc();
+  Value cond = op.getCondition();
+  auto condTy = cast<RankedTensorType>(cond.getType());
+  ArrayRef<int64_t> shape = condTy.getShape();
+  Type elemTy = condTy.getElementType();
+
+  Value failed;
+  if (auto floatTy = dyn_cast<FloatType>(elemTy)) {
+    Value zero = b.create<arith::ConstantFloatOp>(
+        loc, APFloat::getZero(floatTy.getFloatSemantics()), floatTy);
+    failed = b.create<arith::CmpFOp>(loc, arith::CmpFPredicate::OEQ, cond,
+                                     splat(b, loc, zero, shape));
+  } else {
+    Value zero = b.create<arith::ConstantIntOp>(
+        loc, 0, cast<IntegerType>(elemTy).getWidth());
+    failed = b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq, cond,
+                                     splat(b, loc, zero, shape));
+  }
+
+  // A record per false element, reserved by the element itself.
+  constexpr int64_t numSlots = headerSize + 1;
+  auto i64Ty = RankedTensorType::get(shape, b.getI64Type());
+  Value size =
+      splat(b, loc, b.create<arith::ConstantIntOp>(loc, numSlots, 64), shape);
+  Value cursors = splat(b, loc, buffer, shape);
+  Value bases = b.create<tt::AtomicRMWOp>(
+      loc, i64Ty, tt::RMWOp::ADD, cursors, size, failed,
+      tt::MemSemantic::RELAXED, tt::MemSyncScope::GPU);
+  Value ends = b.create<arith::AddIOp>(loc, bases, size);
+  Value fits = b.create<arith::AndIOp>(
+      loc, failed,
+      b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::sle, ends,
+                              splat(b, loc, loadCapacity(b, loc, buffer),
+                                    shape)));
+  Value first = splat(
+      b, loc, b.create<arith::ConstantIntOp>(loc, firstRecordSlot, 64), shape);
+  Value records = addPtr(b, loc, cursors,
+                         b.create<arith::AddIOp>(loc, bases, first));
+  storeHeader(b, loc, records, id, fits, shape);
+  Value indexOffset = splat(
+      b, loc, b.create<arith::ConstantIntOp>(loc, headerSize, 64), shape);
+  store(b, loc, addPtr(b, loc, records, indexOffset),
+        getFlatIndex(b, loc, shape), fits);
+
+  llvm::json::Object desc{{"kind", "assert"},
+                          {"message", op.getMessage().str()},
+                          {"file", op.getFile().str()},
+                          {"func", op.getFunc().str()},
+                          {"line", op.getLine()},
+                          {"shape", llvm::json::Array(shape)}};
+  return llvm::formatv("{0}", llvm::json::Value(std::move(desc)));
+}
+
+} // namespace
+
+class TritonIntelGPUBufferPrintsPass
+    : public TritonIntelGPUBufferPrintsBase<TritonIntelGPUBufferPrintsPass> {
+public:
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    MLIRContext *ctx = &getContext();
+
+    // The prints of the functions called by the kernel have no buffer to
+    // write to, only the kernel is rewritten.
+    tt::FuncOp kernel;
+    for (auto func : mod.getOps<tt::FuncOp>()) {
+      if (!func.isPublic())
+        continue;
+      if (kernel)
+        return;
+      kernel = func;
+    }
+    if (!kernel || kernel.isExternal())
+      return;
+
+    SmallVector<Operation *> toBuffer;
+    kernel.walk([&](Operation *op) {
+      if (isa<tt::PrintOp, tt::AssertOp>(op))
+        toBuffer.push_back(op);
+    });
+    if (toBuffer.empty()) {
+      LLVM_DEBUG(llvm::dbgs() << "no print to buffer\n");
+      return;
+    }
+
+    Type bufferTy = tt::PointerType::get(IntegerType::get(ctx, 64), 1);
+    kernel.insertArgument(kernel.getNumArguments(), bufferTy, {},
+                          kernel.getLoc());
+    Value buffer =
+        kernel.getBody().front().getArgument(kernel.getNumArguments() - 1);
+
+    SmallVector<Attribute> records;
+    for (auto [id, op] : llvm::enumerate(toBuffer)) {
+      std::string desc = isa<tt::PrintOp>(op)
+                             ? bufferPrint(cast<tt::PrintOp>(op), buffer, id)
+                             : bufferAssert(cast<tt::AssertOp>(op), buffer, id);
+      records.push_back(StringAttr::get(ctx, desc));
+      op->erase();
+    }
+    // Tell the launcher to pass the buffer to the kernel.
+    mod->setAttr("triton_gpu.buffered_prints", ArrayAttr::get(ctx, records));
+  }
+};
+
+std::unique_ptr<Pass> mlir::triton::gpu::intel::createBufferPrintsPass() {
+  return std::make_unique<TritonIntelGPUBufferPrintsPass>();
+}
@@ -81,6 +81,9 @@ static AxisInfo getAxisInfoForTensorPointer(const Value &val) {
 }
 
 struct CoalescePass : public TritonGPUCoalesceBase<CoalescePass> {
+  CoalescePass() = default;
+  CoalescePass(unsigned maxVectorBits) { this->maxVectorBits = maxVectorBits; }
+
   void
   setCoalescedEncoding(ModuleAxisInfoAnalysis &axisInfoAnalysis, Operation *op,
                        int numWarps, int threadsPerWarp,
@@ -165,15 +168,15 @@ struct CoalescePass : public TritonGPUCoalesceBase<CoalescePass> {
                                 .getPointeeType()
                           : refTensorType.getElementType();
 
+    auto getAxisInfo = [&](Value val) {
+      if (val.getType().isa<PointerType>())
+        return getAxisInfoForTensorPointer(val);
+      assert(val.getType().isa<RankedTensorType>());
+      return *axisInfoAnalysis.getAxisInfo(val);
+    };
     auto getNumElementPerThread = [&](Operation *op) {
       Value val = getMemAccessPtr(op);
-      AxisInfo valInfo;
-      if (val.getType().isa<PointerType>()) {
-        valInfo = getAxisInfoForTensorPointer(val);
-      } else {
-        assert(val.getType().isa<RankedTensorType>());
-        valInfo = *axisInfoAnalysis.getAxisInfo(val);
-      }
+      AxisInfo valInfo = getAxisInfo(val);
       unsigned elemNumBits = getElementBitWidth(val);
       unsigned elemNumBytes = std::max(elemNumBits / 8, 1u);
       unsigned maxMultipleBytes = valInfo.getDivisibility(order[0]);
@@ -181,7 +184,8 @@ struct CoalescePass : public TritonGPUCoalesceBase<CoalescePass> {
       unsigned maxContig =
           std::min(valInfo.getContiguity(order[0]), shapePerCTA[order[0]]);
       unsigned alignment = std::min(maxMultiple, maxContig);
-      unsigned currPerThread = std::min(alignment, 128 / elemNumBits);
+      unsigned currPerThread =
+          std::min<unsigned>(alignment, maxVectorBits / elemNumBits);
       return currPerThread;
     };
     unsigned perThread = getNumElementPerThread(op);
@@ -199,14 +203,21 @@ struct CoalescePass : public TritonGPUCoalesceBase<CoalescePass> {
 
     if (!dyn_cast<triton::LoadOp>(op)) {
       // For ops that can result in a global memory write, we should enforce
-      // that each thread handles at most 128 bits, which is the widest
-      // available vectorized store op; otherwise, the store will have "gaps"
-      // in the memory write at the warp level, resulting in worse performance.
+      // that each thread handles at most `maxVectorBits` bits, which is the
+      // widest available vectorized store op; otherwise, the store will have
+      // "gaps" in the memory write at the warp level, resulting in worse
+      // performance.
       // For loads, we can expect that the gaps won't matter due to the L1
       // cache.
       unsigned elemNumBits = getElementBitWidth(ptr);
       perThread = std::min<int>(perThread, getNumElementPerThread(op));
     }
+    if (perThread == 1 && numElemsPerThread > 1) {
+      AxisInfo ptrInfo = getAxisInfo(ptr);
+      op->emitRemark() << op->getName() << " not vectorized: contiguity "
+                       << ptrInfo.getContiguity(order[0]) << ", divisibility "
+                       << ptrInfo.getDivisibility(order[0]);
+    }
     SmallVector<unsigned, 4> sizePerThread(refTensorType.getRank(), 1);
     sizePerThread[order[0]] = perThread;
 
@@ -306,6 +317,7 @@ struct CoalescePass : public TritonGPUCoalesceBase<CoalescePass> {
   }
 };
 
-std::unique_ptr<Pass> mlir::triton::gpu::createCoalescePass() {
-  return std::make_unique<CoalescePass>();
+std::unique_ptr<Pass>
+mlir::triton::gpu::createCoalescePass(unsigned maxVectorBits) {
+  return std::make_unique<CoalescePass>(maxVectorBits);
 }
@@ -0,0 +1,196 @@
+#include "mlir/Pass/Pass.h"
+#include "triton/Analysis/Utility.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file keeps the reductions within the sub-groups where the shape allows
+// it. The coalesced layouts of the loads give the warps to the fastest
+// dimension first, e.g. the rows of a softmax over 4 rows of 4096 columns are
+// split across all the warps:
+//
+//   #blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16],
+//             warpsPerCTA = [1, 4], order = [1, 0]}>
+//
+// and each row is reduced with sub-group reductions, then across the warps
+// through the shared local memory with a barrier. The loads and stores of the
+// reduced tensors are given the warps along the other dimensions instead:
+//
+//   #blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16],
+//             warpsPerCTA = [4, 1], order = [1, 0]}>
+//
+// the accesses stay coalesced along the rows and each row is reduced by a
+// single sub-group. The remaining warps, if any, still split the reduced axis.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-distribute-reductions"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+
+namespace {
+
+static Value getMemAccessPtr(Operation *op) {
+  if (auto load = dyn_cast<tt::LoadOp>(op))
+    return load.getPtr();
+  if (auto store = dyn_cast<tt::StoreOp>(op))
+    return store.getPtr();
+  return nullptr;
+}
+
+static ttg::BlockedEncodingAttr getBlockedEncoding(Value ptr) {
+  auto tensorTy = ptr.getType().dyn_cast<RankedTensorType>();
+  if (!tensorTy)
+    return nullptr;
+  return tensorTy.getEncoding().dyn_cast<ttg::BlockedEncodingAttr>();
+}
+
+// Collect the loads the operands of `reduce` are computed from elementwise.
+static void getSourceLoads(tt::ReduceOp reduce,
+                           SmallVectorImpl<tt::LoadOp> &loads) {
+  SmallVector<Value> worklist(reduce.getOperands());
+  DenseSet<Value> visited;
+  while (!worklist.empty()) {
+    Value value = worklist.pop_back_val();
+    if (!visited.insert(value).second)
+      continue;
+    Operation *def = value.getDefiningOp();
+    if (!def)
+      continue;
+    if (auto load = dyn_cast<tt::LoadOp>(def)) {
+      loads.push_back(load);
+    } else if (auto cvt = dyn_cast<ttg::ConvertLayoutOp>(def)) {
+      worklist.push_back(cvt.getSrc());
+    } else if (def->hasTrait<OpTrait::Elementwise>() ||
+               def->hasTrait<OpTrait::SameOperandsAndResultEncoding>()) {
+      for (Value operand : def->getOperands())
+        if (operand.getType().isa<RankedTensorType>())
+          worklist.push_back(operand);
+    }
+  }
+}
+
+// Return the layout giving as many warps as the shape allows to the other
+// dimensions than `axis`, null if it doesn't leave fewer warps along `axis`.
+static ttg::BlockedEncodingAttr
+getDistributedEncoding(ttg::BlockedEncodingAttr blocked,
+                       ArrayRef<int64_t> shape, unsigned axis) {
+  SmallVector<unsigned> warpsPerCTA(blocked.getWarpsPerCTA());
+  if (warpsPerCTA[axis] == 1)
+    return nullptr;
+  unsigned numWarps = product<unsigned>(warpsPerCTA);
+  SmallVector<unsigned> newWarpsPerCTA(shape.size(), 1);
+  for (unsigned dim : blocked.getOrder()) {
+    if (dim == axis)
+      continue;
+    int64_t shapePerWarp =
+        blocked.getSizePerThread()[dim] * blocked.getThreadsPerWarp()[dim];
+    unsigned maxWarps = std::max<int64_t>(1, shape[dim] / shapePerWarp);
+    newWarpsPerCTA[dim] = std::min(numWarps, maxWarps);
+    numWarps /= newWarpsPerCTA[dim];
+  }
+  newWarpsPerCTA[axis] = numWarps;
+  if (newWarpsPerCTA[axis] >= warpsPerCTA[axis])
+    return nullptr;
+  return ttg::BlockedEncodingAttr::get(
+      blocked.getContext(), blocked.getSizePerThread(),
+      blocked.getThreadsPerWarp(), newWarpsPerCTA, blocked.getOrder(),
+      blocked.getCTALayout());
+}
+
+static Type getNewType(Type type, Attribute encoding) {
+  auto tensorTy = type.cast<RankedTensorType>();
+  return RankedTensorType::get(tensorTy.getShape(), tensorTy.getElementType(),
+                               encoding);
+}
+
+// Recreate the memory access `op` with the layout `encoding`, converting its
+// operands to it and its results back to their layout.
+static void setEncoding(Operation *op, Attribute encoding) {
+  OpBuilder builder(op);
+  SmallVector<Value> newArgs;
+  for (Value operand : op->getOperands()) {
+    if (operand.getType().isa<RankedTensorType>())
+      operand = builder.create<ttg::ConvertLayoutOp>(
+          op->getLoc(), getNewType(operand.getType(), encoding), operand);
+    newArgs.push_back(operand);
+  }
+  SmallVector<Type> newTypes;
+  for (Type type : op->getResultTypes())
+    newTypes.push_back(getNewType(type, encoding));
+  Operation *newOp =
+      builder.create(op->getLoc(), op->getName().getIdentifier(), newArgs,
+                     newTypes, op->getAttrs());
+  for (auto [result, newResult] :
+       llvm::zip(op->getResults(), newOp->getResults()))
+    result.replaceAllUsesWith(builder.create<ttg::ConvertLayoutOp>(
+        op->getLoc(), result.getType(), newResult));
+  op->erase();
+}
+
+} // namespace
+
+class TritonIntelGPUDistributeReductionsPass
+    : public TritonIntelGPUDistributeReductionsBase<
+          TritonIntelGPUDistributeReductionsPass> {
+public:
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+
+    // The layouts of the loads the reductions are computed from, and the
+    // layouts keeping the reductions within fewer warps.
+    llvm::MapVector<std::pair<Attribute, ArrayRef<int64_t>>, Attribute>
+        newEncodings;
+    mod.walk([&](tt::ReduceOp reduce) {
+      auto srcTy = reduce.getOperands()[0].getType().cast<RankedTensorType>();
+      if (srcTy.getRank() < 2)
+        return;
+      SmallVector<tt::LoadOp> loads;
+      getSourceLoads(reduce, loads);
+      for (tt::LoadOp load : loads) {
+        ttg::BlockedEncodingAttr blocked = getBlockedEncoding(load.getPtr());
+        auto ptrTy = load.getPtr().getType().dyn_cast<RankedTensorType>();
+        if (!blocked || ptrTy.getShape() != srcTy.getShape())
+          continue;
+        if (auto encoding = getDistributedEncoding(blocked, srcTy.getShape(),
+                                                   reduce.getAxis()))
+          newEncodings.insert({{blocked, ptrTy.getShape()}, encoding});
+      }
+    });
+    if (newEncodings.empty())
+      return;
+
+    // Give the new layouts to all the loads and stores of the same tensors,
+    // e.g. to the stores of the normalized rows, so that no conversion is left
+    // between them and the reductions.
+    SmallVector<std::pair<Operation *, Attribute>> toUpdate;
+    mod.walk([&](Operation *op) {
+      Value ptr = getMemAccessPtr(op);
+      if (!ptr)
+        return;
+      ttg::BlockedEncodingAttr blocked = getBlockedEncoding(ptr);
+      if (!blocked)
+        return;
+      auto shape = ptr.getType().cast<RankedTensorType>().getShape();
+      auto it = newEncodings.find({blocked, shape});
+      if (it != newEncodings.end())
+        toUpdate.push_back({op, it->second});
+    });
+    for (auto [op, encoding] : toUpdate) {
+      LLVM_DEBUG(llvm::dbgs() << "distributing the warps of " << *op << "\n");
+      setEncoding(op, encoding);
+    }
+  }
+};
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::intel::createDistributeReductionsPass() {
+  return std::make_unique<TritonIntelGPUDistributeReductionsPass>();
+}
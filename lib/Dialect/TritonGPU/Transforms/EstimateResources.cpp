@@ -0,0 +1,124 @@
+#include "mlir/Analysis/Liveness.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Analysis/Allocation.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file estimates the resources of a kernel from its TritonGPU IR, before
+// it is lowered:
+//
+//   * the general registers of a hardware thread: the largest number of bytes
+//     per work-item of the distributed tensors live at the same time, as given
+//     by their layouts, times the work-items of a sub-group. The temporaries
+//     of the lowering aren't counted, the estimate is a lower bound;
+//   * the shared local memory, from the allocation of the kernel;
+//   * the work-groups that an Xe core runs at once, limited by its hardware
+//     threads and by its shared local memory.
+//
+// A config whose estimate doesn't fit spills or can't be launched, it can be
+// rejected without building it.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-estimate-resources"
+
+using namespace mlir;
+namespace ttg = mlir::triton::gpu;
+
+namespace {
+
+// Bytes per work-item of the value, 0 when it isn't a distributed tensor.
+unsigned getBytesPerThread(Value value) {
+  auto tensorTy = value.getType().dyn_cast<RankedTensorType>();
+  if (!tensorTy || !tensorTy.getEncoding() ||
+      tensorTy.getEncoding().isa<ttg::SharedEncodingAttr>())
+    return 0;
+  Type elemTy = tensorTy.getElementType();
+  unsigned bits = elemTy.isa<triton::PointerType>()
+                      ? 64
+                      : std::max(elemTy.getIntOrFloatBitWidth(), 8u);
+  return ttg::getTotalElemsPerThread(tensorTy) * bits / 8;
+}
+
+// Largest number of bytes per work-item of the tensors live at the same time
+// in the function.
+unsigned getMaxLiveBytesPerThread(triton::FuncOp funcOp) {
+  Liveness liveness(funcOp);
+  unsigned maxBytes = 0;
+  funcOp.walk([&](Operation *op) {
+    const LivenessBlockInfo *blockInfo = liveness.getLiveness(op->getBlock());
+    if (!blockInfo)
+      return;
+    unsigned bytes = 0;
+    for (Value value : blockInfo->currentlyLiveValues(op))
+      bytes += getBytesPerThread(value);
+    maxBytes = std::max(maxBytes, bytes);
+  });
+  return maxBytes;
+}
+
+} // namespace
+
+class TritonIntelGPUEstimateResourcesPass
+    : public TritonIntelGPUEstimateResourcesBase<
+          TritonIntelGPUEstimateResourcesPass> {
+public:
+  TritonIntelGPUEstimateResourcesPass() = default;
+  TritonIntelGPUEstimateResourcesPass(unsigned grfSize,
+                                      unsigned threadsPerXeCore,
+                                      unsigned sharedPerXeCore) {
+    this->grfSize = grfSize;
+    this->threadsPerXeCore = threadsPerXeCore;
+    this->sharedPerXeCore = sharedPerXeCore;
+  }
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    Builder builder(mod.getContext());
+    unsigned threadsPerWarp = ttg::TritonGPUDialect::getThreadsPerWarp(mod);
+    unsigned numWarps = ttg::TritonGPUDialect::getNumWarps(mod);
+
+    unsigned bytesPerThread = 0;
+    mod.walk([&](triton::FuncOp funcOp) {
+      bytesPerThread =
+          std::max(bytesPerThread, getMaxLiveBytesPerThread(funcOp));
+    });
+    unsigned numGRF =
+        llvm::divideCeil(bytesPerThread * threadsPerWarp, grfSize);
+
+    ModuleAllocation allocation(mod);
+    unsigned shared = allocation.getSharedMemorySize();
+
+    unsigned workGroups = threadsPerXeCore / numWarps;
+    if (shared > 0)
+      workGroups = std::min<unsigned>(workGroups, sharedPerXeCore / shared);
+
+    LLVM_DEBUG({
+      llvm::dbgs() << "bytes per work-item: " << bytesPerThread
+                   << ", GRF: " << numGRF << ", shared: " << shared
+                   << ", work-groups per Xe core: " << workGroups << "\n";
+    });
+
+    mod->setAttr("triton_gpu.estimated_num_grf",
+                 builder.getI32IntegerAttr(numGRF));
+    mod->setAttr("triton_gpu.estimated_shared",
+                 builder.getI32IntegerAttr(shared));
+    mod->setAttr("triton_gpu.estimated_work_groups_per_xe_core",
+                 builder.getI32IntegerAttr(workGroups));
+  }
+};
+
+std::unique_ptr<Pass> mlir::triton::gpu::intel::createEstimateResourcesPass() {
+  return std::make_unique<TritonIntelGPUEstimateResourcesPass>();
+}
+
+std::unique_ptr<Pass> mlir::triton::gpu::intel::createEstimateResourcesPass(
+    unsigned grfSize, unsigned threadsPerXeCore, unsigned sharedPerXeCore) {
+  return std::make_unique<TritonIntelGPUEstimateResourcesPass>(
+      grfSize, threadsPerXeCore, sharedPerXeCore);
+}
@@ -0,0 +1,179 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file estimates the global memory traffic and the FLOPs of a program
+// instance of a kernel from its TritonGPU IR:
+//
+//   * the bytes read by the loads, and written by the stores, of the tensors
+//     or scalars of their shape, whether they are masked or not. The atomics
+//     both read and write their operand;
+//   * two FLOPs per multiply-add of the dots.
+//
+// The operations are counted per loop nest. A term holds the counts of one
+// iteration of the nest and the bounds of its loops, as expressions of the
+// scalar arguments of the kernel, e.g. "(arg3 + 31) // 32", so that the
+// launcher completes the estimate with the arguments and the grid:
+//
+//   "read|written|flops|lb|ub|step|..."
+//
+// The bounds computed from other values are "?", the loop is then counted
+// once. The accesses are counted as issued by the kernel, those hitting in the
+// caches included.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-estimate-traffic"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace {
+
+struct Term {
+  SmallVector<scf::ForOp> loops;
+  uint64_t bytesRead = 0;
+  uint64_t bytesWritten = 0;
+  uint64_t flops = 0;
+};
+
+// Total bytes of the value, a tensor or a scalar.
+uint64_t getNumBytes(Type type) {
+  auto tensorTy = type.dyn_cast<RankedTensorType>();
+  Type elemTy = tensorTy ? tensorTy.getElementType() : type;
+  uint64_t bits = elemTy.isa<tt::PointerType>()
+                      ? 64
+                      : std::max(elemTy.getIntOrFloatBitWidth(), 8u);
+  uint64_t numElems = tensorTy ? tensorTy.getNumElements() : 1;
+  return numElems * bits / 8;
+}
+
+// The value as an expression of the arguments of the kernel, in Python
+// syntax, or an empty string if it isn't one.
+std::string getExpr(Value value, Block &entry) {
+  if (auto arg = value.dyn_cast<BlockArgument>())
+    return arg.getOwner() == &entry
+               ? "arg" + std::to_string(arg.getArgNumber())
+               : "";
+  Operation *op = value.getDefiningOp();
+  if (auto cst = dyn_cast<arith::ConstantOp>(op)) {
+    if (auto intAttr = cst.getValue().dyn_cast<IntegerAttr>())
+      return std::to_string(intAttr.getInt());
+    return "";
+  }
+  if (isa<arith::IndexCastOp, arith::ExtSIOp, arith::ExtUIOp,
+          arith::TruncIOp>(op))
+    return getExpr(op->getOperand(0), entry);
+
+  StringRef binOp = llvm::TypeSwitch<Operation *, StringRef>(op)
+                        .Case<arith::AddIOp>([](auto) { return "+"; })
+                        .Case<arith::SubIOp>([](auto) { return "-"; })
+                        .Case<arith::MulIOp>([](auto) { return "*"; })
+                        .Case<arith::DivSIOp, arith::DivUIOp>(
+                            [](auto) { return "//"; })
+                        .Case<arith::CeilDivSIOp, arith::CeilDivUIOp>(
+                            [](auto) { return "cdiv"; })
+                        .Default([](auto) { return ""; });
+  if (binOp.empty())
+    return "";
+  std::string lhs = getExpr(op->getOperand(0), entry);
+  std::string rhs = getExpr(op->getOperand(1), entry);
+  if (lhs.empty() || rhs.empty())
+    return "";
+  if (binOp == "cdiv")
+    return "(-(-" + lhs + " // " + rhs + "))";
+  return "(" + lhs + " " + binOp.str() + " " + rhs + ")";
+}
+
+std::string getBound(Value value, Block &entry) {
+  std::string expr = getExpr(value, entry);
+  return expr.empty() ? "?" : expr;
+}
+
+// The term of the loop nest of `op`, in the kernel.
+Term &getTerm(SmallVector<Term> &terms, Operation *op) {
+  SmallVector<scf::ForOp> loops;
+  for (auto forOp = op->getParentOfType<scf::ForOp>(); forOp;
+       forOp = forOp->getParentOfType<scf::ForOp>())
+    loops.push_back(forOp);
+  std::reverse(loops.begin(), loops.end());
+  for (Term &term : terms)
+    if (term.loops == loops)
+      return term;
+  terms.push_back({loops});
+  return terms.back();
+}
+
+} // namespace
+
+class TritonIntelGPUEstimateTrafficPass
+    : public TritonIntelGPUEstimateTrafficBase<
+          TritonIntelGPUEstimateTrafficPass> {
+public:
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    MLIRContext *ctx = &getContext();
+
+    // The bounds are expressions of the arguments of the kernel, the
+    // functions it calls aren't counted.
+    tt::FuncOp kernel;
+    for (auto func : mod.getOps<tt::FuncOp>()) {
+      if (!func.isPublic())
+        continue;
+      if (kernel)
+        return;
+      kernel = func;
+    }
+    if (!kernel || kernel.isExternal())
+      return;
+
+    SmallVector<Term> terms;
+    kernel.walk([&](Operation *op) {
+      llvm::TypeSwitch<Operation *>(op)
+          .Case<tt::LoadOp>([&](auto load) {
+            getTerm(terms, op).bytesRead += getNumBytes(load.getType());
+          })
+          .Case<tt::StoreOp>([&](auto store) {
+            getTerm(terms, op).bytesWritten +=
+                getNumBytes(store.getValue().getType());
+          })
+          .Case<tt::AtomicRMWOp, tt::AtomicCASOp>([&](auto atomic) {
+            Term &term = getTerm(terms, op);
+            term.bytesRead += getNumBytes(atomic.getType());
+            term.bytesWritten += getNumBytes(atomic.getType());
+          })
+          .Case<tt::DotOp>([&](auto dot) {
+            auto aTy = dot.getA().getType().template cast<RankedTensorType>();
+            auto dTy = dot.getType().template cast<RankedTensorType>();
+            getTerm(terms, op).flops += 2 * dTy.getNumElements() *
+                                        aTy.getShape()[aTy.getRank() - 1];
+          });
+    });
+
+    Block &entry = kernel.getBody().front();
+    SmallVector<Attribute> attrs;
+    for (const Term &term : terms) {
+      std::string str = std::to_string(term.bytesRead) + "|" +
+                        std::to_string(term.bytesWritten) + "|" +
+                        std::to_string(term.flops);
+      for (scf::ForOp forOp : term.loops)
+        str += "|" + getBound(forOp.getLowerBound(), entry) + "|" +
+               getBound(forOp.getUpperBound(), entry) + "|" +
+               getBound(forOp.getStep(), entry);
+      LLVM_DEBUG(llvm::dbgs() << "traffic term: " << str << "\n");
+      attrs.push_back(StringAttr::get(ctx, str));
+    }
+    mod->setAttr("triton_gpu.traffic", ArrayAttr::get(ctx, attrs));
+  }
+};
+
+std::unique_ptr<Pass> mlir::triton::gpu::intel::createEstimateTrafficPass() {
+  return std::make_unique<TritonIntelGPUEstimateTrafficPass>();
+}
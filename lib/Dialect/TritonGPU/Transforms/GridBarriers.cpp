@@ -0,0 +1,162 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file expands the grid barriers of a kernel, launched cooperatively so
+// that all its programs are resident at once, into a sense-reversing barrier
+// on a pair of i32 counters passed as its last argument:
+//
+//   tt.func @kernel(..., %sync: !tt.ptr<i32, 1>) {
+//     barrier()
+//     %generation = atomic_add(%sync + 1, 0)
+//     if atomic_add(%sync, 1) == num_programs - 1:
+//       atomic_xchg(%sync, 0)
+//       atomic_add(%sync + 1, 1)
+//     else:
+//       while atomic_add(%sync + 1, 0) == %generation: {}
+//     barrier()
+//   }
+//
+// The first counter is the number of programs arrived at the barrier, reset
+// by the last one before it starts the next generation of the second counter,
+// which the other programs wait for. The counters are back to zero arrivals
+// after each barrier, the launcher zeroes them once. The atomics are scalar,
+// only the first work-item of the work-group updates the counters and the
+// others get their old values: the work-groups synchronize as a whole, around
+// the barriers of their work-items.
+//
+// The pass runs on TTIR, after the buffer of the prints is added.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-grid-barriers"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace {
+
+// The counters of the buffer.
+constexpr int arrivalsSlot = 0;
+constexpr int generationSlot = 1;
+
+static Value atomic(OpBuilder &b, Location loc, tt::RMWOp rmwOp, Value buffer,
+                    int slot, int value) {
+  if (slot != 0)
+    buffer = b.create<tt::AddPtrOp>(
+        loc, buffer.getType(), buffer,
+        b.create<arith::ConstantIntOp>(loc, slot, 32));
+  return b.create<tt::AtomicRMWOp>(
+      loc, b.getI32Type(), rmwOp, buffer,
+      b.create<arith::ConstantIntOp>(loc, value, 32), Value(),
+      tt::MemSemantic::ACQUIRE_RELEASE, tt::MemSyncScope::GPU);
+}
+
+static Value getNumPrograms(OpBuilder &b, Location loc) {
+  Value numPrograms;
+  for (int axis = 0; axis < 3; ++axis) {
+    Value n = b.create<tt::GetNumProgramsOp>(loc, b.getI32Type(), axis);
+    numPrograms =
+        numPrograms ? b.create<arith::MulIOp>(loc, numPrograms, n) : n;
+  }
+  return numPrograms;
+}
+
+static void expand(tt::GridBarrierOp op, Value buffer) {
+  OpBuilder b(op);
+  Location loc = op.getLoc();
+  // The global memory written by the work-items before the barrier is
+  // released by the first work-item with the arrival.
+  b.create<gpu::BarrierOp>(loc);
+  Value generation =
+      atomic(b, loc, tt::RMWOp::ADD, buffer, generationSlot, /*value=*/0);
+  Value arrivals =
+      atomic(b, loc, tt::RMWOp::ADD, buffer, arrivalsSlot, /*value=*/1);
+  Value lastArrival = b.create<arith::SubIOp>(
+      loc, getNumPrograms(b, loc), b.create<arith::ConstantIntOp>(loc, 1, 32));
+  Value isLast = b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
+                                         arrivals, lastArrival);
+  auto ifOp = b.create<scf::IfOp>(loc, isLast, /*withElseRegion=*/true);
+
+  b.setInsertionPointToStart(ifOp.thenBlock());
+  atomic(b, loc, tt::RMWOp::XCHG, buffer, arrivalsSlot, /*value=*/0);
+  atomic(b, loc, tt::RMWOp::ADD, buffer, generationSlot, /*value=*/1);
+
+  b.setInsertionPointToStart(ifOp.elseBlock());
+  auto whileOp = b.create<scf::WhileOp>(loc, TypeRange{}, ValueRange{});
+  b.createBlock(&whileOp.getBefore());
+  Value current =
+      atomic(b, loc, tt::RMWOp::ADD, buffer, generationSlot, /*value=*/0);
+  Value waiting = b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
+                                          current, generation);
+  b.create<scf::ConditionOp>(loc, waiting, ValueRange{});
+  b.createBlock(&whileOp.getAfter());
+  b.create<scf::YieldOp>(loc);
+
+  b.setInsertionPoint(op);
+  b.create<gpu::BarrierOp>(loc);
+  op->erase();
+}
+
+} // namespace
+
+class TritonIntelGPUGridBarriersPass
+    : public TritonIntelGPUGridBarriersBase<TritonIntelGPUGridBarriersPass> {
+public:
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    MLIRContext *ctx = &getContext();
+
+    // Only the kernel gets the counters: the functions called by the kernel
+    // are inlined by then, those that aren't can't synchronize the grid.
+    tt::FuncOp kernel;
+    for (auto func : mod.getOps<tt::FuncOp>()) {
+      if (!func.isPublic())
+        continue;
+      if (kernel)
+        return;
+      kernel = func;
+    }
+    if (!kernel || kernel.isExternal())
+      return;
+
+    SmallVector<tt::GridBarrierOp> barriers;
+    WalkResult result = mod.walk([&](tt::GridBarrierOp op) {
+      if (op->getParentOfType<tt::FuncOp>() != kernel) {
+        op.emitError("grid barriers are only supported in the kernel");
+        return WalkResult::interrupt();
+      }
+      barriers.push_back(op);
+      return WalkResult::advance();
+    });
+    if (result.wasInterrupted())
+      return signalPassFailure();
+    if (barriers.empty()) {
+      LLVM_DEBUG(llvm::dbgs() << "no grid barrier\n");
+      return;
+    }
+
+    Type bufferTy = tt::PointerType::get(IntegerType::get(ctx, 32), 1);
+    kernel.insertArgument(kernel.getNumArguments(), bufferTy, {},
+                          kernel.getLoc());
+    Value buffer =
+        kernel.getBody().front().getArgument(kernel.getNumArguments() - 1);
+    for (tt::GridBarrierOp op : barriers)
+      expand(op, buffer);
+    // Tell the launcher to launch the kernel cooperatively and to pass it the
+    // counters.
+    mod->setAttr("triton_gpu.cooperative",
+                 IntegerAttr::get(IntegerType::get(ctx, 32), 1));
+  }
+};
+
+std::unique_ptr<Pass> mlir::triton::gpu::intel::createGridBarriersPass() {
+  return std::make_unique<TritonIntelGPUGridBarriersPass>();
+}
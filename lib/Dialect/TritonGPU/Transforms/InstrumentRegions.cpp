@@ -0,0 +1,167 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/Path.h"
+
+//===----------------------------------------------------------------------===//
+// This file times regions of a kernel with the clock of its sub-groups:
+//
+//   tt.func @kernel(..., %profile: !tt.ptr<i64, 1>) {
+//     %start = clock()
+//     region, e.g. tt.dot
+//     %end = clock()
+//     atomic_add(%profile + 2 * i, %end - %start)
+//     atomic_add(%profile + 2 * i + 1, 1)
+//   }
+//
+// The atomics are scalar, only the first work-item of the work-group updates
+// the buffer: a pair holds the cycles of the region in the first sub-group of
+// the work-groups, summed over the work-groups and the runs of the region, and
+// how many times it ran. The launcher passes the buffer, the Python side reads
+// it back as a breakdown of the cycles by region.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-instrument-regions"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace {
+
+// The mangled name of the SPIR-V builtin reading the clock, and the scope of
+// the clock, i.e. the sub-group.
+constexpr StringLiteral readClockName = "_Z20__spirv_ReadClockKHRi";
+constexpr int subgroupScope = 3;
+
+static StringRef getRegionKind(Operation *op) {
+  if (isa<scf::ForOp>(op))
+    return "loop";
+  if (isa<tt::DotOp>(op))
+    return "dot";
+  if (isa<tt::LoadOp>(op))
+    return "load";
+  return "";
+}
+
+// The kind of the region followed by its location in the source, e.g.
+// "dot:kernel.py:42".
+static std::string getRegionName(Operation *op) {
+  std::string name = getRegionKind(op).str();
+  if (auto loc = op->getLoc()->findInstanceOf<FileLineColLoc>())
+    name += (":" + llvm::sys::path::filename(loc.getFilename().getValue()) +
+             ":" + Twine(loc.getLine()))
+                .str();
+  return name;
+}
+
+static Value readClock(OpBuilder &b, Location loc) {
+  Value scope = b.create<arith::ConstantIntOp>(loc, subgroupScope, 32);
+  return b.create<tt::ExternElementwiseOp>(loc, b.getI64Type(),
+                                           ValueRange{scope}, "", "",
+                                           readClockName, /*pure=*/false);
+}
+
+static void atomicAdd(OpBuilder &b, Location loc, Value buffer, int index,
+                      Value value) {
+  Value offset = b.create<arith::ConstantIntOp>(loc, index, 32);
+  Value ptr = b.create<tt::AddPtrOp>(loc, buffer.getType(), buffer, offset);
+  b.create<tt::AtomicRMWOp>(loc, b.getI64Type(), tt::RMWOp::ADD, ptr, value,
+                            Value(), tt::MemSemantic::RELAXED,
+                            tt::MemSyncScope::GPU);
+}
+
+static void instrument(Operation *op, Value buffer, int region) {
+  OpBuilder b(op);
+  Location loc = op->getLoc();
+  Value start = readClock(b, loc);
+  b.setInsertionPointAfter(op);
+  Value end = readClock(b, loc);
+  Value cycles = b.create<arith::SubIOp>(loc, end, start);
+  atomicAdd(b, loc, buffer, 2 * region, cycles);
+  atomicAdd(b, loc, buffer, 2 * region + 1,
+            b.create<arith::ConstantIntOp>(loc, 1, 64));
+}
+
+} // namespace
+
+class TritonIntelGPUInstrumentRegionsPass
+    : public TritonIntelGPUInstrumentRegionsBase<
+          TritonIntelGPUInstrumentRegionsPass> {
+public:
+  TritonIntelGPUInstrumentRegionsPass() = default;
+  TritonIntelGPUInstrumentRegionsPass(StringRef regions) {
+    this->regions = regions.str();
+  }
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    MLIRContext *ctx = &getContext();
+    SmallVector<StringRef> kinds;
+    StringRef(regions).split(kinds, ',', /*MaxSplit=*/-1,
+                             /*KeepEmpty=*/false);
+    llvm::StringSet<> selected;
+    for (StringRef kind : kinds)
+      selected.insert(kind.trim());
+
+    // The regions of the functions called by the kernel have no buffer to
+    // update, only the kernel is instrumented.
+    tt::FuncOp kernel;
+    for (auto func : mod.getOps<tt::FuncOp>()) {
+      if (!func.isPublic())
+        continue;
+      if (kernel)
+        return;
+      kernel = func;
+    }
+    if (!kernel || kernel.isExternal())
+      return;
+
+    SmallVector<Operation *> toInstrument;
+    kernel.walk([&](Operation *op) {
+      StringRef kind = getRegionKind(op);
+      if (!kind.empty() && selected.contains(kind))
+        toInstrument.push_back(op);
+    });
+    if (toInstrument.empty()) {
+      LLVM_DEBUG(llvm::dbgs() << "no region to instrument\n");
+      return;
+    }
+
+    Type bufferTy = tt::PointerType::get(IntegerType::get(ctx, 64), 1);
+    kernel.insertArgument(kernel.getNumArguments(), bufferTy, {},
+                          kernel.getLoc());
+    Value buffer =
+        kernel.getBody().front().getArgument(kernel.getNumArguments() - 1);
+
+    // The regions at the same location are numbered, e.g. "load:k.py:7#1".
+    SmallVector<Attribute> names;
+    llvm::StringMap<unsigned> numRegionsAt;
+    for (auto [region, op] : llvm::enumerate(toInstrument)) {
+      std::string name = getRegionName(op);
+      if (unsigned n = numRegionsAt[name]++)
+        name += "#" + std::to_string(n);
+      names.push_back(StringAttr::get(ctx, name));
+      instrument(op, buffer, region);
+    }
+    // Tell the launcher to pass the buffer to the kernel.
+    mod->setAttr("triton_gpu.profile_regions", ArrayAttr::get(ctx, names));
+  }
+};
+
+std::unique_ptr<Pass> mlir::triton::gpu::intel::createInstrumentRegionsPass() {
+  return std::make_unique<TritonIntelGPUInstrumentRegionsPass>();
+}
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::intel::createInstrumentRegionsPass(StringRef regions) {
+  return std::make_unique<TritonIntelGPUInstrumentRegionsPass>(regions);
+}
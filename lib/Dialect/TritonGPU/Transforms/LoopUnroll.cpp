@@ -0,0 +1,66 @@
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SCF/Utils/Utils.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file unrolls the loops with a `tt.loop_unroll_factor` attribute, set
+// from the `loop_unroll_factor` of their `tl.range`, before they are pipelined:
+//
+//   scf.for %i = %lb to %ub step %s {
+//     body(%i)
+//   } {tt.loop_unroll_factor = 2 : i32}
+//
+// becomes
+//
+//   scf.for %i = %lb to %ub' step 2 * %s {
+//     body(%i)
+//     body(%i + %s)
+//   }
+//   scf.for %i = %ub' to %ub step %s {
+//     body(%i)
+//   }
+//
+// %ub' being the bound of the whole multiples of the factor of iterations, so
+// that the trip count of the loop needn't be known. The body of the unrolled
+// loop exposes the independent loads and dots of its iterations to the
+// pipelining and the scheduling of the backend.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-loop-unroll"
+
+using namespace mlir;
+
+static constexpr char kUnrollFactorAttr[] = "tt.loop_unroll_factor";
+
+class TritonIntelGPULoopUnrollPass
+    : public TritonIntelGPULoopUnrollBase<TritonIntelGPULoopUnrollPass> {
+public:
+  void runOnOperation() override {
+    SmallVector<scf::ForOp> loops;
+    getOperation().walk([&](scf::ForOp loop) {
+      if (loop->hasAttr(kUnrollFactorAttr))
+        loops.push_back(loop);
+    });
+    for (scf::ForOp loop : loops) {
+      auto factor = loop->getAttrOfType<IntegerAttr>(kUnrollFactorAttr);
+      // The epilogue loop is a copy of the loop, attribute included.
+      loop->removeAttr(kUnrollFactorAttr);
+      if (!factor || factor.getInt() <= 1)
+        continue;
+      LLVM_DEBUG(llvm::dbgs() << "unrolling " << factor.getInt()
+                              << " times " << loop << "\n");
+      if (failed(loopUnrollByFactor(loop, factor.getInt())))
+        loop.emitRemark() << "loop not unrolled " << factor.getInt()
+                          << " times";
+    }
+  }
+};
+
+std::unique_ptr<Pass> mlir::triton::gpu::intel::createLoopUnrollPass() {
+  return std::make_unique<TritonIntelGPULoopUnrollPass>();
+}
@@ -0,0 +1,329 @@
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "triton/Dialect/TritonGPU/Transforms/Utility.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-materialize-block-pointer"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+using ttg::ConvertLayoutOp;
+using ttg::DotOperandEncodingAttr;
+using ttg::DpasEncodingAttr;
+
+namespace {
+
+// Return true if the tensor is made of whole DPAS tiles, i.e. every warp
+// accesses distinct tiles and no data is replicated across warps.
+static bool isTileAligned(RankedTensorType tensorTy, Attribute encoding) {
+  ArrayRef<int64_t> shape = tensorTy.getShape();
+  if (auto dpasLayout = encoding.dyn_cast<DpasEncodingAttr>()) {
+    SmallVector<unsigned> shapePerCTATile = ttg::getShapePerCTATile(dpasLayout);
+    return shape[0] % shapePerCTATile[0] == 0 &&
+           shape[1] % shapePerCTATile[1] == 0;
+  }
+
+  auto dotLayout = encoding.cast<DotOperandEncodingAttr>();
+  auto dpasLayout = dotLayout.getParent().cast<DpasEncodingAttr>();
+  SmallVector<int64_t> elemsPerInstr = dotLayout.getDPASElemsPerInstr(
+      tensorTy.getElementType().getIntOrFloatBitWidth());
+  SmallVector<unsigned> warpsPerCTA = dpasLayout.getWarpsPerCTA();
+  // The non-K dimension is distributed across the warps, the K dimension is
+  // not.
+  unsigned nonKDim = dotLayout.getOpIdx() == 0 ? 0 : 1;
+  unsigned kDim = nonKDim ^ 1;
+  return shape[nonKDim] % (elemsPerInstr[nonKDim] * warpsPerCTA[nonKDim]) ==
+             0 &&
+         shape[kDim] % elemsPerInstr[kDim] == 0;
+}
+
+// Return the conversion of the value loaded by `loadOp` to a DPAS operand
+// layout, either direct or through the transposition of its copy in shared
+// memory, e.g. for the K^T operand of the attention. `isTransposed` tells
+// which one.
+static ConvertLayoutOp getDotOperandConversion(Operation *loadOp,
+                                               bool &isTransposed) {
+  if (!loadOp->getResult(0).hasOneUse())
+    return nullptr;
+  auto cvtOp = dyn_cast<ConvertLayoutOp>(*loadOp->user_begin());
+  if (!cvtOp)
+    return nullptr;
+  isTransposed = false;
+  if (cvtOp.getType().cast<RankedTensorType>().getEncoding().isa<
+          ttg::SharedEncodingAttr>()) {
+    if (!cvtOp.getResult().hasOneUse())
+      return nullptr;
+    auto transOp = dyn_cast<tt::TransOp>(*cvtOp->user_begin());
+    if (!transOp || !transOp.getResult().hasOneUse())
+      return nullptr;
+    cvtOp = dyn_cast<ConvertLayoutOp>(*transOp->user_begin());
+    if (!cvtOp)
+      return nullptr;
+    isTransposed = true;
+  }
+  auto dotLayout = cvtOp.getType()
+                       .cast<RankedTensorType>()
+                       .getEncoding()
+                       .dyn_cast<DotOperandEncodingAttr>();
+  if (!dotLayout || !dotLayout.getParent().isa<DpasEncodingAttr>())
+    return nullptr;
+  return cvtOp;
+}
+
+// Swap the dimensions of the operands `first` and `first + 1` of `op`.
+static void swapOperands(Operation *op, unsigned first) {
+  Value operand = op->getOperand(first);
+  op->setOperand(first, op->getOperand(first + 1));
+  op->setOperand(first + 1, operand);
+}
+
+} // namespace
+
+// Give the block pointer created by `op`, and all the values derived from it,
+// the layout expected by its DPAS users so that its loads and stores can be
+// lowered to 2D block IO. The block pointers whose loads are transposed
+// before their use are transposed instead, and the B operands with columns
+// contiguous in memory are read by transposed 2D block reads. The pages of
+// the tt.load_pages of the pointer are read by the 2D block reads of their
+// DPAS tiles. Nothing is changed, and false returned, if any use of the
+// pointer cannot be handled.
+bool ttg::intel::materializeBlockPointer(tt::MakeTensorPtrOp op) {
+  auto ptrTy = op.getResult().getType().cast<tt::PointerType>();
+  auto tensorTy = ptrTy.getPointeeType().cast<RankedTensorType>();
+  if (tensorTy.getRank() != 2)
+    return false;
+
+  // 2D block IO requires rows, or the columns of the transposed reads, to be
+  // contiguous in memory.
+  bool isRowMajor =
+      op.getOrder()[0] == 1 && matchPattern(op.getStrides()[1], m_One());
+  bool isColumnMajor =
+      op.getOrder()[0] == 0 && matchPattern(op.getStrides()[0], m_One());
+  if (!isRowMajor && !isColumnMajor)
+    return false;
+
+  // Collect the values derived from the block pointer and their memory
+  // accesses.
+  llvm::SetVector<Value> ptrs;
+  SmallVector<tt::AdvanceOp> advances;
+  SmallVector<tt::LoadOp> loads;
+  SmallVector<tt::LoadPagesOp> pageLoads;
+  SmallVector<tt::StoreOp> stores;
+  ptrs.insert(op.getResult());
+  for (unsigned i = 0; i < ptrs.size(); ++i) {
+    for (OpOperand &use : ptrs[i].getUses()) {
+      Operation *user = use.getOwner();
+      if (auto advanceOp = dyn_cast<tt::AdvanceOp>(user)) {
+        ptrs.insert(advanceOp.getResult());
+        advances.push_back(advanceOp);
+      } else if (auto loadOp = dyn_cast<tt::LoadOp>(user)) {
+        loads.push_back(loadOp);
+      } else if (auto loadPagesOp = dyn_cast<tt::LoadPagesOp>(user)) {
+        pageLoads.push_back(loadPagesOp);
+      } else if (auto storeOp = dyn_cast<tt::StoreOp>(user)) {
+        if (use.getOperandNumber() != 0)
+          return false;
+        stores.push_back(storeOp);
+      } else if (auto forOp = dyn_cast<scf::ForOp>(user)) {
+        unsigned idx = use.getOperandNumber() - forOp.getNumControlOperands();
+        ptrs.insert(forOp.getRegionIterArgs()[idx]);
+        ptrs.insert(forOp.getResult(idx));
+      } else if (isa<scf::YieldOp>(user) &&
+                 isa<scf::ForOp>(user->getParentOp())) {
+        auto forOp = cast<scf::ForOp>(user->getParentOp());
+        unsigned idx = use.getOperandNumber();
+        ptrs.insert(forOp.getRegionIterArgs()[idx]);
+        ptrs.insert(forOp.getResult(idx));
+      } else {
+        LLVM_DEBUG(llvm::dbgs() << "unsupported block pointer user: " << *user
+                                << "\n");
+        return false;
+      }
+    }
+  }
+
+  // All the accesses must agree on a DPAS related layout.
+  Attribute encoding;
+  auto mergeEncoding = [&](Attribute newEncoding) {
+    if (encoding && encoding != newEncoding)
+      return false;
+    encoding = newEncoding;
+    return true;
+  };
+
+  // All the loads must agree on whether they are transposed.
+  std::optional<bool> isTransposed;
+  for (tt::LoadOp loadOp : loads) {
+    bool isLoadTransposed;
+    ConvertLayoutOp cvtOp = getDotOperandConversion(loadOp, isLoadTransposed);
+    if (!cvtOp || (isTransposed && *isTransposed != isLoadTransposed))
+      return false;
+    isTransposed = isLoadTransposed;
+    // The hardware fills out of bound elements with zeros.
+    std::optional<tt::PaddingOption> padding = loadOp.getPadding();
+    if (loadOp.getBoundaryCheck() && !loadOp.getBoundaryCheck()->empty() &&
+        padding && *padding != tt::PaddingOption::PAD_ZERO)
+      return false;
+    if (!mergeEncoding(cvtOp.getType().cast<RankedTensorType>().getEncoding()))
+      return false;
+  }
+  // The pages are read by the tiles of their rows, which are not transposed.
+  for (tt::LoadPagesOp loadPagesOp : pageLoads) {
+    bool isLoadTransposed;
+    ConvertLayoutOp cvtOp =
+        getDotOperandConversion(loadPagesOp, isLoadTransposed);
+    if (!cvtOp || isLoadTransposed || (isTransposed && *isTransposed))
+      return false;
+    isTransposed = false;
+    auto dotLayout = cvtOp.getType()
+                         .cast<RankedTensorType>()
+                         .getEncoding()
+                         .cast<DotOperandEncodingAttr>();
+    SmallVector<int64_t> elemsPerInstr = dotLayout.getDPASElemsPerInstr(
+        tensorTy.getElementType().getIntOrFloatBitWidth());
+    if (loadPagesOp.getPageSize() % elemsPerInstr[0] != 0)
+      return false;
+    if (!mergeEncoding(dotLayout))
+      return false;
+  }
+  bool transpose = isTransposed.value_or(false);
+  if (transpose && !stores.empty())
+    return false;
+
+  for (tt::StoreOp storeOp : stores) {
+    auto cvtOp = storeOp.getValue().getDefiningOp<ConvertLayoutOp>();
+    if (!cvtOp)
+      return false;
+    auto srcTy = cvtOp.getSrc().getType().cast<RankedTensorType>();
+    unsigned bitWidth = srcTy.getElementType().getIntOrFloatBitWidth();
+    if (!srcTy.getEncoding().isa<DpasEncodingAttr>() ||
+        (bitWidth != 16 && bitWidth != 32))
+      return false;
+    if (!mergeEncoding(srcTy.getEncoding()))
+      return false;
+  }
+
+  if (!encoding)
+    return false;
+
+  // The transposed block pointer is the block of the transposed tensor.
+  SmallVector<int64_t> shape(tensorTy.getShape());
+  if (transpose) {
+    std::swap(shape[0], shape[1]);
+    std::swap(isRowMajor, isColumnMajor);
+  }
+  auto newTensorTy =
+      RankedTensorType::get(shape, tensorTy.getElementType(), encoding);
+  if (!isTileAligned(newTensorTy, encoding))
+    return false;
+
+  // The columns of the blocks are read as the rows of the memory, with
+  // transposed 2D block reads of dwords. These only feed the B operand, with
+  // the packed elements of consecutive rows of a column in each dword.
+  if (isColumnMajor) {
+    auto dotLayout = encoding.dyn_cast<DotOperandEncodingAttr>();
+    unsigned bitWidth = tensorTy.getElementType().getIntOrFloatBitWidth();
+    if (!dotLayout || dotLayout.getOpIdx() != 1 || !stores.empty() ||
+        !pageLoads.empty() || 32 % bitWidth != 0 || bitWidth < 8)
+      return false;
+  }
+
+  LLVM_DEBUG(llvm::dbgs() << "materializing block pointer: " << op << "\n");
+
+  if (transpose) {
+    MLIRContext *ctx = op.getContext();
+    // The operands of the shape, the strides and the offsets.
+    for (unsigned first : {1, 3, 5})
+      swapOperands(op, first);
+    ArrayRef<int32_t> order = op.getOrder();
+    op.setOrderAttr(DenseI32ArrayAttr::get(ctx, {1 - order[0], 1 - order[1]}));
+    for (tt::AdvanceOp advanceOp : advances)
+      swapOperands(advanceOp, 1);
+    for (tt::LoadOp loadOp : loads) {
+      std::optional<ArrayRef<int32_t>> boundaryCheck =
+          loadOp.getBoundaryCheck();
+      if (!boundaryCheck)
+        continue;
+      SmallVector<int32_t> dims;
+      for (int32_t dim : *boundaryCheck)
+        dims.push_back(1 - dim);
+      loadOp.setBoundaryCheckAttr(DenseI32ArrayAttr::get(ctx, dims));
+    }
+  }
+
+  auto newPtrTy = tt::PointerType::get(newTensorTy, ptrTy.getAddressSpace());
+  for (Value ptr : ptrs)
+    ptr.setType(newPtrTy);
+
+  for (tt::LoadOp loadOp : loads) {
+    bool isLoadTransposed;
+    ConvertLayoutOp cvtOp = getDotOperandConversion(loadOp, isLoadTransposed);
+    Operation *transposedOp = cvtOp.getSrc().getDefiningOp();
+    loadOp.getResult().setType(newTensorTy);
+    cvtOp.getResult().replaceAllUsesWith(loadOp.getResult());
+    cvtOp.erase();
+    // The transposition and the conversion to shared memory it was made of.
+    if (isLoadTransposed) {
+      Operation *sharedCvtOp = transposedOp->getOperand(0).getDefiningOp();
+      transposedOp->erase();
+      sharedCvtOp->erase();
+    }
+    // Tell the lowering to read the columns of the block.
+    if (isColumnMajor)
+      loadOp->setAttr("triton_gpu.column_major", UnitAttr::get(loadOp.getContext()));
+  }
+
+  for (tt::LoadPagesOp loadPagesOp : pageLoads) {
+    bool isLoadTransposed;
+    ConvertLayoutOp cvtOp =
+        getDotOperandConversion(loadPagesOp, isLoadTransposed);
+    loadPagesOp.getResult().setType(newTensorTy);
+    cvtOp.getResult().replaceAllUsesWith(loadPagesOp.getResult());
+    cvtOp.erase();
+  }
+
+  for (tt::StoreOp storeOp : stores) {
+    auto cvtOp = storeOp.getValue().getDefiningOp<ConvertLayoutOp>();
+    storeOp->setOperand(1, cvtOp.getSrc());
+    if (cvtOp->use_empty())
+      cvtOp.erase();
+  }
+  return true;
+}
+
+class TritonIntelGPUMaterializeBlockPointerPass
+    : public TritonIntelGPUMaterializeBlockPointerBase<
+          TritonIntelGPUMaterializeBlockPointerPass> {
+public:
+  TritonIntelGPUMaterializeBlockPointerPass() = default;
+  TritonIntelGPUMaterializeBlockPointerPass(ttg::intel::DeviceArch arch) {
+    this->deviceArch = arch;
+  }
+
+  void runOnOperation() override {
+    // Only PVC supports 2D block IO.
+    if (deviceArch != ttg::intel::DeviceArch::PVC)
+      return;
+
+    SmallVector<tt::MakeTensorPtrOp> makeTensorPtrOps;
+    getOperation().walk(
+        [&](tt::MakeTensorPtrOp op) { makeTensorPtrOps.push_back(op); });
+    for (tt::MakeTensorPtrOp op : makeTensorPtrOps)
+      materializeBlockPointer(op);
+  }
+};
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::intel::createMaterializeBlockPointerPass(DeviceArch arch) {
+  return std::make_unique<TritonIntelGPUMaterializeBlockPointerPass>(arch);
+}
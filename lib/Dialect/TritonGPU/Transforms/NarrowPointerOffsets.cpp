@@ -0,0 +1,178 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file narrows to i32 the i64 offsets of the pointers computed from the
+// pointer arguments of a kernel specialized as addressing less than 2^31
+// bytes, i.e. with the `tt.pointer_range = 32` attribute, e.g.
+//
+//   %offs = arith.muli(arith.extsi(%rows), splat(arith.extsi(%stride)))
+//   %ptrs = tt.addptr(splat(%arg), %offs) : tensor<..xi64>
+//
+// becomes
+//
+//   %offs = arith.muli(%rows, splat(%stride))
+//   %ptrs = tt.addptr(splat(%arg), %offs) : tensor<..xi32>
+//
+// The offset of an accessed pointer from the argument fits in i32, so its low
+// 32 bits, computed in i32 by the additions, subtractions, multiplications and
+// bitwise ops of its computation, are the offset. The extensions from i32 of
+// their operands are dropped, and their constants and other scalar operands
+// truncated. The offsets computed
+// otherwise from tensors, e.g. by divisions, are left as is, not to truncate
+// each of their elements.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-narrow-pointer-offsets"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace {
+
+// Whether `ptr` is a pointer argument of its function, or a splat of one,
+// whose tensor is addressed by i32 offsets.
+static bool isNarrowPointerArg(Value ptr) {
+  if (auto splat = ptr.getDefiningOp<tt::SplatOp>())
+    ptr = splat.getSrc();
+  auto arg = ptr.dyn_cast<BlockArgument>();
+  if (!arg)
+    return false;
+  auto func = dyn_cast<tt::FuncOp>(arg.getOwner()->getParentOp());
+  if (!func)
+    return false;
+  auto range = func.getArgAttrOfType<IntegerAttr>(arg.getArgNumber(),
+                                                  "tt.pointer_range");
+  return range && range.getInt() == 32;
+}
+
+static Type getI32Type(Type type) {
+  auto i32Ty = IntegerType::get(type.getContext(), 32);
+  if (auto tensorTy = type.dyn_cast<RankedTensorType>())
+    return RankedTensorType::get(tensorTy.getShape(), i32Ty,
+                                 tensorTy.getEncoding());
+  return i32Ty;
+}
+
+// The i32 values of the low 32 bits of the i64 values, built next to them.
+class Narrower {
+public:
+  // The low 32 bits of `value`, failing if they would be truncated from a
+  // tensor.
+  FailureOr<Value> get(Value value) {
+    auto it = narrowed.find(value);
+    if (it != narrowed.end())
+      return it->second;
+    FailureOr<Value> result = compute(value);
+    if (succeeded(result))
+      narrowed[value] = *result;
+    return result;
+  }
+
+private:
+  FailureOr<Value> compute(Value value) {
+    Type i32Ty = getI32Type(value.getType());
+    Operation *op = value.getDefiningOp();
+    OpBuilder b(value.getContext());
+    if (op)
+      b.setInsertionPointAfter(op);
+    else
+      b.setInsertionPointToStart(value.cast<BlockArgument>().getOwner());
+    Location loc = value.getLoc();
+
+    if (auto ext = dyn_cast_or_null<arith::ExtSIOp>(op)) {
+      Value src = ext.getIn();
+      if (getElementTypeOrSelf(src).getIntOrFloatBitWidth() == 32)
+        return src;
+      return b.create<arith::ExtSIOp>(loc, i32Ty, src).getResult();
+    }
+    if (auto ext = dyn_cast_or_null<arith::ExtUIOp>(op)) {
+      Value src = ext.getIn();
+      if (getElementTypeOrSelf(src).getIntOrFloatBitWidth() == 32)
+        return src;
+      return b.create<arith::ExtUIOp>(loc, i32Ty, src).getResult();
+    }
+    if (auto cst = dyn_cast_or_null<arith::ConstantOp>(op)) {
+      if (auto intAttr = cst.getValue().dyn_cast<IntegerAttr>()) {
+        auto attr = IntegerAttr::get(i32Ty, intAttr.getValue().trunc(32));
+        return b.create<arith::ConstantOp>(loc, attr).getResult();
+      }
+      if (auto dense = cst.getValue().dyn_cast<DenseIntElementsAttr>()) {
+        auto attr = dense.mapValues(getElementTypeOrSelf(i32Ty),
+                                    [](const APInt &v) { return v.trunc(32); });
+        return b.create<arith::ConstantOp>(loc, attr.cast<TypedAttr>())
+            .getResult();
+      }
+    }
+    if (isa_and_nonnull<arith::AddIOp, arith::SubIOp, arith::MulIOp,
+                        arith::AndIOp, arith::OrIOp, arith::XOrIOp>(op)) {
+      FailureOr<Value> lhs = get(op->getOperand(0));
+      FailureOr<Value> rhs = get(op->getOperand(1));
+      if (failed(lhs) || failed(rhs))
+        return failure();
+      OperationState state(loc, op->getName(), ValueRange{*lhs, *rhs},
+                           TypeRange{i32Ty});
+      return b.create(state)->getResult(0);
+    }
+    if (isa_and_nonnull<tt::SplatOp, tt::BroadcastOp, tt::ExpandDimsOp,
+                        triton::gpu::ConvertLayoutOp>(op)) {
+      FailureOr<Value> src = get(op->getOperand(0));
+      if (failed(src))
+        return failure();
+      OperationState state(loc, op->getName(), ValueRange{*src},
+                           TypeRange{i32Ty}, op->getAttrs());
+      return b.create(state)->getResult(0);
+    }
+    if (value.getType().isa<RankedTensorType>())
+      return failure();
+    return b.create<arith::TruncIOp>(loc, i32Ty, value).getResult();
+  }
+
+  DenseMap<Value, Value> narrowed;
+};
+
+} // namespace
+
+class TritonIntelGPUNarrowPointerOffsetsPass
+    : public TritonIntelGPUNarrowPointerOffsetsBase<
+          TritonIntelGPUNarrowPointerOffsetsPass> {
+public:
+  void runOnOperation() override {
+    Narrower narrower;
+    getOperation().walk([&](tt::AddPtrOp addPtr) {
+      Value offset = addPtr.getOffset();
+      if (!getElementTypeOrSelf(offset).isInteger(64) ||
+          !isNarrowPointerArg(addPtr.getPtr()))
+        return;
+      FailureOr<Value> narrowOffset = narrower.get(offset);
+      if (failed(narrowOffset))
+        return;
+      LLVM_DEBUG(llvm::dbgs() << "narrowing the offset of " << addPtr << "\n");
+      addPtr.getOffsetMutable().assign(*narrowOffset);
+    });
+    // The i64 offsets left unused, and the narrowed values of the offsets
+    // that couldn't be narrowed, users first.
+    SmallVector<Operation *> ops;
+    getOperation().walk([&](Operation *op) {
+      if (isa<arith::ArithDialect>(op->getDialect()) ||
+          isa<tt::SplatOp, tt::BroadcastOp, tt::ExpandDimsOp,
+              triton::gpu::ConvertLayoutOp>(op))
+        ops.push_back(op);
+    });
+    for (Operation *op : llvm::reverse(ops))
+      if (isOpTriviallyDead(op))
+        op->erase();
+  }
+};
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::intel::createNarrowPointerOffsetsPass() {
+  return std::make_unique<TritonIntelGPUNarrowPointerOffsetsPass>();
+}
@@ -43,7 +43,9 @@ namespace {
 // convert(mask) : blocked -> mma
 // tt.store(ptr, val, mask, ...) : mma
 //
-// Store with mma layout directly
+// Store with mma layout directly. The DPAS layout of the XPU is handled the
+// same way, each thread storing the column of the DPAS tiles it holds in its
+// registers.
 class BypassEpilogueSMEM : public mlir::RewritePattern {
 
 public:
@@ -74,7 +76,8 @@ public:
              .getType()
              .cast<RankedTensorType>()
              .getEncoding()
-             .isa<triton::gpu::NvidiaMmaEncodingAttr>())
+             .isa<triton::gpu::NvidiaMmaEncodingAttr,
+                  triton::gpu::DpasEncodingAttr>())
       return mlir::failure();
 
     if (!cvtOp.getResult().hasOneUse())
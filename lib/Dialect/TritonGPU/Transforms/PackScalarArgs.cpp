@@ -0,0 +1,135 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file packs the scalar arguments of a kernel into a buffer of i64 slots
+// the launcher fills with a single copy, instead of setting each of them:
+//
+//   tt.func @kernel(%x: !tt.ptr<f32, 1>, %n: i32, %scale: f32)
+//
+// becomes
+//
+//   tt.func @kernel(%args: !tt.ptr<i64, 1>, %x: !tt.ptr<f32, 1>) {
+//     %n = trunci(load(%args + 0))
+//     %scale = bitcast(trunci(load(%args + 1)))
+//   }
+//
+// The values are in the low bytes of their slot, the 16-bit floats as 32-bit
+// ones, as the launcher passes them otherwise. The scalars the kernel is
+// specialized on, i.e. with a `tt.divisibility`, stay arguments, so that the
+// analyses of the kernel still see their divisibility. The module gets a
+// `triton_gpu.packed_args` attribute with the indices of the packed arguments
+// in the signature of the source kernel.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-pack-scalar-args"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace {
+
+static bool isPackable(tt::FuncOp kernel, BlockArgument arg) {
+  Type type = arg.getType();
+  if (!type.isIntOrFloat() || type.getIntOrFloatBitWidth() > 64)
+    return false;
+  return !kernel.getArgAttr(arg.getArgNumber(), "tt.divisibility");
+}
+
+// The value of type `type` in the i64 `slot`.
+static Value unpack(OpBuilder &b, Location loc, Value slot, Type type) {
+  if (auto intTy = dyn_cast<IntegerType>(type))
+    return intTy.getWidth() == 64
+               ? slot
+               : b.create<arith::TruncIOp>(loc, intTy, slot).getResult();
+  auto floatTy = cast<FloatType>(type);
+  if (floatTy.isF64())
+    return b.create<arith::BitcastOp>(loc, floatTy, slot);
+  Value bits = b.create<arith::TruncIOp>(loc, b.getI32Type(), slot);
+  Value value = b.create<arith::BitcastOp>(loc, b.getF32Type(), bits);
+  if (floatTy.isF32())
+    return value;
+  return b.create<arith::TruncFOp>(loc, floatTy, value);
+}
+
+} // namespace
+
+class TritonIntelGPUPackScalarArgsPass
+    : public TritonIntelGPUPackScalarArgsBase<
+          TritonIntelGPUPackScalarArgsPass> {
+public:
+  TritonIntelGPUPackScalarArgsPass() = default;
+  TritonIntelGPUPackScalarArgsPass(unsigned minNumArgs) {
+    this->minNumArgs = minNumArgs;
+  }
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    MLIRContext *ctx = &getContext();
+
+    tt::FuncOp kernel;
+    for (auto func : mod.getOps<tt::FuncOp>()) {
+      if (!func.isPublic())
+        continue;
+      if (kernel)
+        return;
+      kernel = func;
+    }
+    if (!kernel || kernel.isExternal())
+      return;
+
+    Block &entry = kernel.getBody().front();
+    SmallVector<BlockArgument> packed;
+    for (BlockArgument arg : entry.getArguments())
+      if (isPackable(kernel, arg))
+        packed.push_back(arg);
+    if (minNumArgs == 0 || packed.size() < minNumArgs) {
+      LLVM_DEBUG(llvm::dbgs() << packed.size() << " scalar arguments to pack, "
+                              << minNumArgs << " needed\n");
+      return;
+    }
+
+    // The buffer precedes the arguments of the kernel, whose other
+    // arguments, e.g. the buffer of the prints, are added after them.
+    Type bufferTy = tt::PointerType::get(IntegerType::get(ctx, 64), 1);
+    kernel.insertArgument(0, bufferTy, {}, kernel.getLoc());
+    Value buffer = entry.getArgument(0);
+
+    OpBuilder b(ctx);
+    b.setInsertionPointToStart(&entry);
+    Location loc = kernel.getLoc();
+    llvm::BitVector erased(kernel.getNumArguments());
+    SmallVector<int32_t> indices;
+    for (auto [slot, arg] : llvm::enumerate(packed)) {
+      Value offset = b.create<arith::ConstantIntOp>(loc, slot, 32);
+      Value ptr = b.create<tt::AddPtrOp>(loc, bufferTy, buffer, offset);
+      Value value = b.create<tt::LoadOp>(loc, ptr, tt::CacheModifier::NONE,
+                                         tt::EvictionPolicy::NORMAL,
+                                         /*isVolatile=*/false);
+      arg.replaceAllUsesWith(unpack(b, loc, value, arg.getType()));
+      erased.set(arg.getArgNumber());
+      // the index in the signature of the source kernel, without the buffer
+      indices.push_back(arg.getArgNumber() - 1);
+    }
+    kernel.eraseArguments(erased);
+    // Tell the launcher to pack these arguments.
+    mod->setAttr("triton_gpu.packed_args",
+                 b.getI32ArrayAttr(ArrayRef<int32_t>(indices)));
+  }
+};
+
+std::unique_ptr<Pass> mlir::triton::gpu::intel::createPackScalarArgsPass() {
+  return std::make_unique<TritonIntelGPUPackScalarArgsPass>();
+}
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::intel::createPackScalarArgsPass(unsigned minNumArgs) {
+  return std::make_unique<TritonIntelGPUPackScalarArgsPass>(minNumArgs);
+}
@@ -0,0 +1,110 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file lets the launcher split the grid of a kernel along its first
+// dimension, e.g. across the tiles of a PVC device:
+//
+//   tt.func @kernel(..., %offsetX: i32, %gridX: i32) {
+//     body, where program_id(x) is program_id(x) + %offsetX and
+//     num_programs(x) is %gridX
+//   }
+//
+// Each range of the grid is launched with the work-groups of the range only,
+// %offsetX being the first program id of the range and %gridX the number of
+// work-groups along x of the whole grid. Persistent kernels are partitioned
+// the same way: their loop over the tiles of the grid starts at the program
+// id and is strided by the number of programs.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-partition-grid"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace {
+
+static bool usesProgramIds(Operation *op) {
+  return op
+      ->walk([](Operation *op) {
+        return isa<tt::GetProgramIdOp, tt::GetNumProgramsOp>(op)
+                   ? WalkResult::interrupt()
+                   : WalkResult::advance();
+      })
+      .wasInterrupted();
+}
+
+static void partitionGrid(tt::FuncOp func) {
+  MLIRContext *ctx = func.getContext();
+  Location loc = func.getLoc();
+  Type i32 = IntegerType::get(ctx, 32);
+  Block &entry = func.getBody().front();
+  for (int i = 0; i < 2; ++i)
+    func.insertArgument(func.getNumArguments(), i32, {}, loc);
+  Value offsetX = entry.getArgument(func.getNumArguments() - 2);
+  Value gridX = entry.getArgument(func.getNumArguments() - 1);
+
+  SmallVector<Operation *> toReplace;
+  func.walk([&](Operation *op) {
+    if (auto pid = dyn_cast<tt::GetProgramIdOp>(op)) {
+      if (pid.getAxisAsInt() == 0)
+        toReplace.push_back(op);
+    } else if (auto numPrograms = dyn_cast<tt::GetNumProgramsOp>(op)) {
+      if (numPrograms.getAxis() == 0)
+        toReplace.push_back(op);
+    }
+  });
+  OpBuilder b(ctx);
+  for (Operation *op : toReplace) {
+    Value result = op->getResult(0);
+    if (isa<tt::GetNumProgramsOp>(op)) {
+      result.replaceAllUsesWith(gridX);
+      op->erase();
+      continue;
+    }
+    b.setInsertionPointAfter(op);
+    Value pid = b.create<arith::AddIOp>(loc, result, offsetX);
+    result.replaceAllUsesExcept(pid, pid.getDefiningOp());
+  }
+}
+
+} // namespace
+
+class TritonIntelGPUPartitionGridPass
+    : public TritonIntelGPUPartitionGridBase<TritonIntelGPUPartitionGridPass> {
+public:
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    tt::FuncOp kernel;
+    for (auto func : mod.getOps<tt::FuncOp>()) {
+      if (func.isPublic()) {
+        if (kernel)
+          return;
+        kernel = func;
+      } else if (usesProgramIds(func)) {
+        // The program ids seen by the functions called by the kernel would
+        // not be offset.
+        return;
+      }
+    }
+    if (!kernel || kernel.isExternal()) {
+      LLVM_DEBUG(llvm::dbgs() << "not partitioning the grid of the kernel\n");
+      return;
+    }
+    partitionGrid(kernel);
+    // Tell the launcher to pass the range of the grid to the kernel.
+    mod->setAttr("triton_gpu.partition_grid",
+                 IntegerAttr::get(IntegerType::get(&getContext(), 32), 1));
+  }
+};
+
+std::unique_ptr<Pass> mlir::triton::gpu::intel::createPartitionGridPass() {
+  return std::make_unique<TritonIntelGPUPartitionGridPass>();
+}
@@ -0,0 +1,170 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file turns kernels into persistent kernels: the program ids of the grid
+// become the iterations of a loop over the tiles of the grid, that the
+// work-groups resident on the device share:
+//
+//   tt.func @kernel(..., %gridX: i32, %gridY: i32, %gridZ: i32) {
+//     scf.for %tile = program_id(x) to gridX * gridY * gridZ
+//                     step num_programs(x) {
+//       body, where program_id(axis) are the coordinates of %tile in the grid
+//       and num_programs(axis) the sizes of the grid
+//     }
+//     tt.return
+//   }
+//
+// The launcher passes the grid as the last arguments of the kernel and only
+// launches as many work-groups as the device keeps resident. The tiles of the
+// grid can optionally be visited by groups of `swizzle-group` tiles along its
+// first dimension, so that the tiles computed at the same time share more of
+// their inputs in the caches.
+//
+// Programs waiting on other programs of the grid, e.g. through atomics, may
+// deadlock once they are made persistent.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-persistent"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace {
+
+// Return the coordinates of the linear `tile` in the grid of sizes `grid`.
+static SmallVector<Value> getTileCoords(OpBuilder &b, Location loc, Value tile,
+                                        ArrayRef<Value> grid,
+                                        unsigned swizzleGroup) {
+  Value tilesXY = b.create<arith::MulIOp>(loc, grid[0], grid[1]);
+  Value z = b.create<arith::DivSIOp>(loc, tile, tilesXY);
+  Value xy = b.create<arith::RemSIOp>(loc, tile, tilesXY);
+  if (swizzleGroup == 0) {
+    Value x = b.create<arith::RemSIOp>(loc, xy, grid[0]);
+    Value y = b.create<arith::DivSIOp>(loc, xy, grid[0]);
+    return {x, y, z};
+  }
+
+  // Visit the (x, y) plane by columns of `swizzleGroup` tiles along x, the
+  // last one being narrower if `swizzleGroup` doesn't divide the grid.
+  Value group = b.create<arith::ConstantIntOp>(loc, swizzleGroup, 32);
+  Value tilesPerGroup = b.create<arith::MulIOp>(loc, group, grid[1]);
+  Value firstX = b.create<arith::MulIOp>(
+      loc, b.create<arith::DivSIOp>(loc, xy, tilesPerGroup), group);
+  Value groupX = b.create<arith::MinSIOp>(
+      loc, b.create<arith::SubIOp>(loc, grid[0], firstX), group);
+  Value inGroup = b.create<arith::RemSIOp>(loc, xy, tilesPerGroup);
+  Value x = b.create<arith::AddIOp>(
+      loc, firstX, b.create<arith::RemSIOp>(loc, inGroup, groupX));
+  Value y = b.create<arith::DivSIOp>(loc, inGroup, groupX);
+  return {x, y, z};
+}
+
+static bool usesProgramIds(Operation *op) {
+  return op
+      ->walk([](Operation *op) {
+        return isa<tt::GetProgramIdOp, tt::GetNumProgramsOp>(op)
+                   ? WalkResult::interrupt()
+                   : WalkResult::advance();
+      })
+      .wasInterrupted();
+}
+
+static LogicalResult makePersistent(tt::FuncOp func, unsigned swizzleGroup) {
+  // The body is moved into the loop as a whole, it must not return early.
+  if (!func.getBody().hasOneBlock())
+    return failure();
+  Block &entry = func.getBody().front();
+  auto returnOp = dyn_cast<tt::ReturnOp>(entry.getTerminator());
+  if (!returnOp || returnOp.getNumOperands() != 0)
+    return failure();
+
+  MLIRContext *ctx = func.getContext();
+  Location loc = func.getLoc();
+  Type i32 = IntegerType::get(ctx, 32);
+  for (int i = 0; i < 3; ++i)
+    func.insertArgument(func.getNumArguments(), i32, {}, loc);
+  SmallVector<Value> grid(entry.getArguments().take_back(3));
+
+  OpBuilder b(ctx);
+  b.setInsertionPointToStart(&entry);
+  Value firstTile = b.create<tt::GetProgramIdOp>(
+      loc, i32, tt::ProgramIDDimAttr::get(ctx, tt::ProgramIDDim::X));
+  Value step =
+      b.create<tt::GetNumProgramsOp>(loc, i32, b.getI32IntegerAttr(0));
+  Value numTiles = b.create<arith::MulIOp>(
+      loc, b.create<arith::MulIOp>(loc, grid[0], grid[1]), grid[2]);
+  auto forOp = b.create<scf::ForOp>(loc, firstTile, numTiles, step);
+
+  // Move the original body, i.e. everything between the loop and the return.
+  Block *body = forOp.getBody();
+  body->getOperations().splice(body->getTerminator()->getIterator(),
+                               entry.getOperations(),
+                               std::next(forOp->getIterator()),
+                               returnOp->getIterator());
+
+  b.setInsertionPointToStart(body);
+  SmallVector<Value> coords = getTileCoords(b, loc, forOp.getInductionVar(),
+                                            grid, swizzleGroup);
+  SmallVector<Operation *> toReplace;
+  body->walk([&](Operation *op) {
+    if (isa<tt::GetProgramIdOp, tt::GetNumProgramsOp>(op))
+      toReplace.push_back(op);
+  });
+  for (Operation *op : toReplace) {
+    Value replacement =
+        isa<tt::GetProgramIdOp>(op)
+            ? coords[cast<tt::GetProgramIdOp>(op).getAxisAsInt()]
+            : grid[cast<tt::GetNumProgramsOp>(op).getAxis()];
+    op->getResult(0).replaceAllUsesWith(replacement);
+    op->erase();
+  }
+  return success();
+}
+
+} // namespace
+
+class TritonIntelGPUPersistentPass
+    : public TritonIntelGPUPersistentBase<TritonIntelGPUPersistentPass> {
+public:
+  TritonIntelGPUPersistentPass() = default;
+  TritonIntelGPUPersistentPass(unsigned swizzleGroup) {
+    this->swizzleGroup = swizzleGroup;
+  }
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    tt::FuncOp kernel;
+    for (auto func : mod.getOps<tt::FuncOp>()) {
+      if (func.isPublic()) {
+        if (kernel)
+          return;
+        kernel = func;
+      } else if (usesProgramIds(func)) {
+        // The program ids seen by the functions called by the kernel would
+        // not be rewritten.
+        return;
+      }
+    }
+    if (!kernel || failed(makePersistent(kernel, swizzleGroup))) {
+      LLVM_DEBUG(llvm::dbgs() << "not making the kernel persistent\n");
+      return;
+    }
+    // Tell the launcher to pass the grid to the kernel.
+    mod->setAttr("triton_gpu.persistent",
+                 IntegerAttr::get(IntegerType::get(&getContext(), 32), 1));
+  }
+};
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::intel::createPersistentPass(unsigned swizzleGroup) {
+  return std::make_unique<TritonIntelGPUPersistentPass>(swizzleGroup);
+}
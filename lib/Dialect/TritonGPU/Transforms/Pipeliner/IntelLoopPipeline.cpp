@@ -0,0 +1,226 @@
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "triton/Dialect/TritonGPU/Transforms/PipelineExpander.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file implements software pipelining of the loads feeding DPAS in matmul
+// loops for Intel GPUs.
+// There is no asynchronous global to shared memory copy on these GPUs, but a
+// load does not block the sub-group until its result is used. The loads of
+// iteration `i + numStages - 1` are therefore issued in stage 0 of the
+// pipelined loop, ahead of the DPAS of iteration `i`, and their results are
+// multi-buffered in registers through the loop carried values created by the
+// pipeline expander.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-pipeline"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+
+namespace {
+
+// Return true if the value has a DPAS operand layout, either directly or
+// through its single convert_layout user.
+static bool isDpasOperand(Value val) {
+  auto isDpasOperandType = [](Type type) {
+    auto tensorTy = type.dyn_cast<RankedTensorType>();
+    if (!tensorTy)
+      return false;
+    auto dotLayout =
+        tensorTy.getEncoding().dyn_cast<ttg::DotOperandEncodingAttr>();
+    return dotLayout && dotLayout.getParent().isa<ttg::DpasEncodingAttr>();
+  };
+  if (isDpasOperandType(val.getType()))
+    return llvm::all_of(val.getUsers(),
+                        [](Operation *user) { return isa<tt::DotOp>(user); });
+  if (!val.hasOneUse())
+    return false;
+  auto cvtOp = dyn_cast<ttg::ConvertLayoutOp>(*val.getUsers().begin());
+  return cvtOp && isDpasOperandType(cvtOp.getType());
+}
+
+// Collect the loads of the loop body producing DPAS operands.
+static SmallVector<tt::LoadOp> collectOpsToPipeline(scf::ForOp forOp) {
+  SmallVector<tt::LoadOp> loads;
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    auto loadOp = dyn_cast<tt::LoadOp>(op);
+    if (!loadOp)
+      continue;
+    auto tensorTy = loadOp.getType().dyn_cast<RankedTensorType>();
+    if (!tensorTy || tensorTy.getRank() != 2)
+      continue;
+    if (isDpasOperand(loadOp.getResult()))
+      loads.push_back(loadOp);
+  }
+  return loads;
+}
+
+// Add `op` and its dependencies in the loop body to `deps`. The dependencies
+// carried by the loop, such as the pointer increments, are followed through
+// the loop iteration arguments.
+static void addDep(Operation *op, DenseSet<Operation *> &deps) {
+  if (!deps.insert(op).second)
+    return;
+  Block *body = op->getBlock();
+  for (Value operand : op->getOperands()) {
+    Value v = operand;
+    llvm::SmallDenseSet<Value> seen;
+    while (auto arg = v.dyn_cast<BlockArgument>()) {
+      if (!seen.insert(v).second || arg.getOwner() != body ||
+          arg.getArgNumber() == 0)
+        break;
+      v = body->getTerminator()->getOperand(arg.getArgNumber() - 1);
+    }
+    Operation *defOp = v.getDefiningOp();
+    if (defOp && defOp->getBlock() == body)
+      addDep(defOp, deps);
+  }
+}
+
+// Create the schedule of the loop: the loads and the computation of their
+// addresses go in stage 0, everything else in stage `numStages - 1`. Stage 0
+// is placed first in the loop body so that the loads are in flight while the
+// DPAS of the current iteration execute.
+static bool
+createSchedule(scf::ForOp forOp, ArrayRef<tt::LoadOp> loads, int numStages,
+               std::vector<std::pair<Operation *, unsigned>> &schedule) {
+  DenseSet<Operation *> loadAndDeps;
+  for (tt::LoadOp loadOp : loads)
+    addDep(loadOp, loadAndDeps);
+
+  for (Operation *op : loadAndDeps) {
+    // The loads must not depend on the result of the computation.
+    if (isa<tt::DotOp>(op) || op->getNumRegions() != 0)
+      return false;
+    // Stage 0 is predicated in the prologue and in the last iterations of the
+    // loop, which is only supported for loads and side effect free ops.
+    if (!isa<tt::LoadOp>(op) && !isMemoryEffectFree(op))
+      return false;
+  }
+
+  for (Operation &op : forOp.getBody()->without_terminator())
+    if (loadAndDeps.count(&op))
+      schedule.emplace_back(&op, 0);
+  for (Operation &op : forOp.getBody()->without_terminator())
+    if (!loadAndDeps.count(&op))
+      schedule.emplace_back(&op, numStages - 1);
+  return true;
+}
+
+// Function to mask operations during scheduling.
+static Operation *predicateOp(RewriterBase &rewriter, Operation *op,
+                              Value pred) {
+  OpBuilder::InsertionGuard guard(rewriter);
+  if (isMemoryEffectFree(op))
+    return op;
+
+  auto loadOp = cast<tt::LoadOp>(op);
+  rewriter.setInsertionPoint(loadOp);
+  Location loc = loadOp.getLoc();
+  if (!tt::isTensorPointerType(loadOp.getPtr().getType())) {
+    Type maskType = tt::getI1SameShape(loadOp.getPtr().getType());
+    Value mask = rewriter.create<tt::SplatOp>(loc, maskType, pred);
+    if (Value currentMask = loadOp.getMask())
+      mask = rewriter.create<arith::AndIOp>(loc, mask, currentMask);
+    loadOp.getMaskMutable().assign(mask);
+    return op;
+  }
+
+  // Loads from block pointers cannot be masked, guard them instead.
+  auto resultTy = loadOp.getType().cast<RankedTensorType>();
+  auto ifOp = rewriter.create<scf::IfOp>(
+      loc, pred,
+      [&](OpBuilder &builder, Location loc) {
+        Operation *newLoadOp = builder.clone(*loadOp);
+        builder.create<scf::YieldOp>(loc, newLoadOp->getResults());
+      },
+      [&](OpBuilder &builder, Location loc) {
+        Value zero = builder.create<arith::ConstantOp>(
+            loc, resultTy, builder.getZeroAttr(resultTy));
+        builder.create<scf::YieldOp>(loc, zero);
+      });
+  rewriter.replaceOp(loadOp, ifOp.getResults());
+  return ifOp;
+}
+
+// Return true if the preconditions for pipelining the loop are met.
+static bool preCondition(scf::ForOp forOp) {
+  // Skip loop with distance > 1.
+  if (llvm::any_of(forOp.getBody()->getTerminator()->getOperands(),
+                   [](Value operand) { return !operand.getDefiningOp(); }))
+    return false;
+  // Don't pipeline outer loops.
+  return !forOp
+              ->walk([&](Operation *op) {
+                if (forOp.getOperation() == op)
+                  return WalkResult::advance();
+                if (isa<scf::ForOp, scf::WhileOp>(op))
+                  return WalkResult::interrupt();
+                return WalkResult::advance();
+              })
+              .wasInterrupted();
+}
+
+static void pipelineLoop(scf::ForOp forOp, int numStages) {
+  if (!preCondition(forOp))
+    return;
+
+  SmallVector<tt::LoadOp> loads = collectOpsToPipeline(forOp);
+  if (loads.empty())
+    return;
+
+  std::vector<std::pair<Operation *, unsigned>> schedule;
+  if (!createSchedule(forOp, loads, numStages, schedule))
+    return;
+
+  LLVM_DEBUG(llvm::dbgs() << "pipelining " << loads.size()
+                          << " DPAS operand loads of: " << forOp << "\n");
+
+  tt::PipeliningOption options;
+  options.getScheduleFn =
+      [schedule](scf::ForOp forOp,
+                 std::vector<std::pair<Operation *, unsigned>> &s) {
+        s = std::move(schedule);
+      };
+  options.peelEpilogue = false;
+  options.predicateFn = predicateOp;
+  options.supportDynamicLoops = true;
+
+  IRRewriter rewriter(forOp->getContext());
+  rewriter.setInsertionPoint(forOp);
+  (void)tt::pipelineForLoop(rewriter, forOp, options);
+}
+
+} // namespace
+
+class TritonIntelGPUPipelinePass
+    : public TritonIntelGPUPipelineBase<TritonIntelGPUPipelinePass> {
+public:
+  TritonIntelGPUPipelinePass() = default;
+  TritonIntelGPUPipelinePass(int numStages) { this->numStages = numStages; }
+
+  void runOnOperation() override {
+    if (numStages <= 1)
+      return;
+
+    SmallVector<scf::ForOp> loops;
+    getOperation()->walk([&](scf::ForOp forOp) { loops.push_back(forOp); });
+    for (scf::ForOp forOp : loops)
+      pipelineLoop(forOp, numStages);
+  }
+};
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::intel::createPipelinePass(int numStages) {
+  return std::make_unique<TritonIntelGPUPipelinePass>(numStages);
+}
@@ -131,8 +131,13 @@ Value Prefetcher::generatePrefetch(Value v, unsigned opIdx, bool isPrologue,
       SmallVector<OpFoldResult>{intAttr(shape[0]), intAttr(shape[1])},
       SmallVector<OpFoldResult>{intAttr(1), intAttr(1)});
 
+  // The DPAS operands have no kWidth, their slices keep the encoding of the
+  // whole operand.
+  unsigned kWidth = dotEncoding.isa<triton::gpu::DpasEncodingAttr>()
+                        ? 0
+                        : prefetchWidth / 8;
   auto dotOperandEnc = triton::gpu::DotOperandEncodingAttr::get(
-      builder.getContext(), opIdx, dotEncoding, prefetchWidth / 8);
+      builder.getContext(), opIdx, dotEncoding, kWidth);
   Value prefetchSlice = builder.create<triton::gpu::ConvertLayoutOp>(
       v.getLoc(), RankedTensorType::get(shape, elementType, dotOperandEnc),
       newSmem);
@@ -153,8 +158,11 @@ LogicalResult Prefetcher::initialize() {
 
   // TODO: segfault (original for still has uses)
   // when used in flash attention that has 2 dots in the loop
-  if (dotsInFor.size() > 1)
+  if (dotsInFor.size() > 1) {
+    forOp.emitRemark() << "dots not prefetched: " << dotsInFor.size()
+                       << " dots in the loop";
     return failure();
+  }
 
   // returns source of cvt
 
@@ -207,18 +215,37 @@ LogicalResult Prefetcher::initialize() {
     int bKWidth = bEnc.getKWidth();
     assert(aKWidth == bKWidth);
 
+    if (aType.getRank() != 2) {
+      dot.emitRemark() << "dot operands not prefetched: batched dot";
+      continue;
+    }
     auto kSize = aType.getShape()[1];
 
-    // works better with nvidia tensor cores
     unsigned elementWidth = aType.getElementTypeBitWidth();
-    if (aKWidth == 0)
+    if (aEnc.getParent().isa<triton::gpu::DpasEncodingAttr>()) {
+      // The slices are the K of a DPAS instruction, each loaded from the
+      // shared memory while the DPAS of the previous slice runs.
+      prefetchWidth = aEnc.getDPASElemsPerInstr(elementWidth)[1];
+    } else if (aKWidth == 0) {
+      // works better with nvidia tensor cores
       prefetchWidth = 256 / elementWidth;
-    else
+    } else {
       prefetchWidth = 8 * aKWidth;
+    }
 
     // Skip prefetching if kSize is less than prefetchWidth
-    if (kSize < prefetchWidth)
+    if (kSize < prefetchWidth) {
+      dot.emitRemark() << "dot operands not prefetched: K " << kSize
+                       << " below the prefetch width " << prefetchWidth;
       continue;
+    }
+    // The remaining slices all have the prefetch width.
+    if (kSize % prefetchWidth != 0) {
+      dot.emitRemark() << "dot operands not prefetched: K " << kSize
+                       << " not a multiple of the prefetch width "
+                       << prefetchWidth;
+      continue;
+    }
     auto aVals = getPrefetchSrc(dot.getA());
     auto bVals = getPrefetchSrc(dot.getB());
 
@@ -238,6 +265,9 @@ LogicalResult Prefetcher::initialize() {
         dot2bLoopArg[dot] = bSmem;
         dot2aYield[dot] = getYieldOp(aSmem);
         dot2bYield[dot] = getYieldOp(bSmem);
+      } else {
+        dot.emitRemark()
+            << "dot operands not prefetched: not carried by the loop";
       }
     }
   }
@@ -0,0 +1,145 @@
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "triton/Dialect/TritonGPU/Transforms/Utility.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file inserts prefetches of the blocks loaded in loops through block
+// pointers, `numStages` iterations ahead of their loads:
+//
+//   prefetch(p0); p1 = advance(p0) ... prefetch(p[n-1]); pn = advance(p[n-1])
+//   for (..., p, q = pn) {
+//     prefetch(q);
+//     load(p);
+//     ...
+//     yield advance(p), advance(q)
+//   }
+//
+// The blocks are brought into the caches while the current iteration
+// computes, which hides the latency of the global memory reads that the
+// register pipelining of the loads does not cover.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-prefetch-block"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+
+namespace {
+
+// A block pointer carried by the loop at `argIdx` and advanced by loop
+// invariant `offsets` at each iteration.
+struct PrefetchCandidate {
+  unsigned argIdx;
+  SmallVector<Value> offsets;
+};
+
+static std::optional<PrefetchCandidate> getCandidate(scf::ForOp forOp,
+                                                     tt::LoadOp loadOp) {
+  if (!tt::isTensorPointerType(loadOp.getPtr().getType()))
+    return std::nullopt;
+  auto arg = loadOp.getPtr().dyn_cast<BlockArgument>();
+  if (!arg || arg.getOwner() != forOp.getBody() || arg.getArgNumber() == 0)
+    return std::nullopt;
+
+  unsigned argIdx = arg.getArgNumber() - forOp.getNumInductionVars();
+  auto advanceOp = forOp.getBody()
+                       ->getTerminator()
+                       ->getOperand(argIdx)
+                       .getDefiningOp<tt::AdvanceOp>();
+  if (!advanceOp || advanceOp.getPtr() != arg ||
+      !llvm::all_of(advanceOp.getOffsets(), [&](Value offset) {
+        return forOp.isDefinedOutsideOfLoop(offset);
+      }))
+    return std::nullopt;
+  return PrefetchCandidate{argIdx, llvm::to_vector(advanceOp.getOffsets())};
+}
+
+static void prefetchLoop(scf::ForOp forOp, int numStages) {
+  // Don't prefetch in outer loops.
+  if (forOp.getBody()
+          ->walk([](scf::ForOp) { return WalkResult::interrupt(); })
+          .wasInterrupted())
+    return;
+
+  SmallVector<PrefetchCandidate> candidates;
+  DenseSet<unsigned> seen;
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    auto loadOp = dyn_cast<tt::LoadOp>(op);
+    if (!loadOp)
+      continue;
+    std::optional<PrefetchCandidate> candidate = getCandidate(forOp, loadOp);
+    if (candidate && seen.insert(candidate->argIdx).second)
+      candidates.push_back(*candidate);
+  }
+  if (candidates.empty())
+    return;
+
+  LLVM_DEBUG(llvm::dbgs() << "prefetching " << candidates.size()
+                          << " block pointers of: " << forOp << "\n");
+
+  // Prefetch the blocks of the first `numStages` iterations before the loop.
+  OpBuilder builder(forOp);
+  Location loc = forOp.getLoc();
+  SmallVector<Value> prefetchPtrs;
+  for (PrefetchCandidate &candidate : candidates) {
+    Value ptr = forOp.getInitArgs()[candidate.argIdx];
+    for (int i = 0; i < numStages; ++i) {
+      builder.create<ttg::PrefetchOp>(loc, ptr);
+      ptr = builder.create<tt::AdvanceOp>(loc, ptr.getType(), ptr,
+                                          candidate.offsets);
+    }
+    prefetchPtrs.push_back(ptr);
+  }
+
+  // Carry the pointers to the blocks to prefetch through the loop.
+  unsigned firstArg = forOp.getBody()->getNumArguments();
+  scf::ForOp newForOp =
+      replaceForOpWithNewSignature(builder, forOp, prefetchPtrs);
+  forOp.erase();
+
+  Block *body = newForOp.getBody();
+  auto yieldOp = cast<scf::YieldOp>(body->getTerminator());
+  SmallVector<Value> yieldOperands(yieldOp.getOperands());
+  builder.setInsertionPointToStart(body);
+  for (auto [i, candidate] : llvm::enumerate(candidates)) {
+    Value ptr = body->getArgument(firstArg + i);
+    builder.create<ttg::PrefetchOp>(loc, ptr);
+    yieldOperands.push_back(builder.create<tt::AdvanceOp>(
+        loc, ptr.getType(), ptr, candidate.offsets));
+  }
+  yieldOp->setOperands(yieldOperands);
+}
+
+} // namespace
+
+class TritonIntelGPUPrefetchBlockPass
+    : public TritonIntelGPUPrefetchBlockBase<TritonIntelGPUPrefetchBlockPass> {
+public:
+  TritonIntelGPUPrefetchBlockPass() = default;
+  TritonIntelGPUPrefetchBlockPass(int numStages) {
+    this->numStages = numStages;
+  }
+
+  void runOnOperation() override {
+    if (numStages < 1)
+      return;
+
+    SmallVector<scf::ForOp> loops;
+    getOperation()->walk([&](scf::ForOp forOp) { loops.push_back(forOp); });
+    for (scf::ForOp forOp : loops)
+      prefetchLoop(forOp, numStages);
+  }
+};
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::intel::createPrefetchBlockPass(int numStages) {
+  return std::make_unique<TritonIntelGPUPrefetchBlockPass>(numStages);
+}
@@ -16,10 +16,61 @@
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "triton/Dialect/TritonGPU/Transforms/Passes.h"
 #include "triton/Dialect/TritonGPU/Transforms/TritonGPUConversion.h"
+#include "triton/Dialect/TritonGPU/Transforms/Utility.h"
+#include "llvm/ADT/SetVector.h"
 #define GEN_PASS_CLASSES
 #include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
 
 using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+
+// Return the tt.make_tensor_ptr creating the block pointer `ptr` is derived
+// from, through its advances and the loops carrying it, if any.
+static tt::MakeTensorPtrOp getMakeTensorPtrOp(Value ptr) {
+  while (true) {
+    if (auto blockArg = ptr.dyn_cast<BlockArgument>()) {
+      auto forOp = dyn_cast<scf::ForOp>(blockArg.getOwner()->getParentOp());
+      OpOperand *init = forOp ? forOp.getTiedLoopInit(blockArg) : nullptr;
+      if (!init)
+        return nullptr;
+      ptr = init->get();
+    } else if (auto makeOp = ptr.getDefiningOp<tt::MakeTensorPtrOp>()) {
+      return makeOp;
+    } else if (auto advanceOp = ptr.getDefiningOp<tt::AdvanceOp>()) {
+      ptr = advanceOp.getPtr();
+    } else if (auto forOp = ptr.getDefiningOp<scf::ForOp>()) {
+      ptr = forOp.getInitArgs()[ptr.cast<OpResult>().getResultNumber()];
+    } else {
+      return nullptr;
+    }
+  }
+}
+
+// On XPU, the DPAS operands loaded through a block pointer are read by 2D
+// block loads producing the fragments of each sub-group directly, once the
+// pointer has their layout, instead of being staged in shared local memory.
+// The conversions of the loads left, e.g. by the passes after
+// -tritonintelgpu-materialize-block-pointer, are folded into their block
+// pointers here.
+static void materializeDpasOperandLoads(ModuleOp mod) {
+  llvm::SetVector<tt::MakeTensorPtrOp> makeTensorPtrOps;
+  mod.walk([&](ttg::ConvertLayoutOp cvtOp) {
+    auto dstDotOp = cvtOp.getType()
+                        .cast<RankedTensorType>()
+                        .getEncoding()
+                        .dyn_cast<ttg::DotOperandEncodingAttr>();
+    if (!dstDotOp || !dstDotOp.getParent().isa<ttg::DpasEncodingAttr>())
+      return;
+    auto loadOp = cvtOp.getSrc().getDefiningOp<tt::LoadOp>();
+    if (!loadOp || !tt::isTensorPointerType(loadOp.getPtr().getType()))
+      return;
+    if (tt::MakeTensorPtrOp makeOp = getMakeTensorPtrOp(loadOp.getPtr()))
+      makeTensorPtrOps.insert(makeOp);
+  });
+  for (tt::MakeTensorPtrOp makeOp : makeTensorPtrOps)
+    ttg::intel::materializeBlockPointer(makeOp);
+}
 
 class TritonGPUReduceDataDuplicationPass
     : public TritonGPUReduceDataDuplicationBase<
@@ -29,6 +80,7 @@ public:
 
   void runOnOperation() override {
     ModuleOp mod = getOperation();
+    materializeDpasOperandLoads(mod);
     mod.walk([&](triton::gpu::ConvertLayoutOp cvtOp) -> void {
       OpBuilder builder(cvtOp);
       auto srcType = cvtOp.getOperand().getType().cast<RankedTensorType>();
@@ -48,6 +100,12 @@ public:
              dstDotOp.getParent() == srcMmaEncoding))
           return;
       }
+      // The A operand of a DPAS result whose rows of tiles are each computed
+      // by a single sub-group is already in the registers of the sub-group
+      // using it.
+      if (srcEncoding.isa<triton::gpu::DpasEncodingAttr>() &&
+          isDpasToDotShortcut(srcType, dstType))
+        return;
       auto tmpType = RankedTensorType::get(
           dstType.getShape(), dstType.getElementType(),
           triton::gpu::SharedEncodingAttr::get(
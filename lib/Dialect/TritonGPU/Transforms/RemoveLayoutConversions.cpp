@@ -284,8 +284,8 @@ SmallVector<Value> LayoutPropagation::propagateToUsers(Value value,
     if (user->hasTrait<mlir::OpTrait::SameOperandsAndResultEncoding>() ||
         user->hasTrait<mlir::OpTrait::Elementwise>() ||
         isa<triton::ReduceOp, triton::ExpandDimsOp,
-            triton::ExperimentalInterleaveOp, triton::gpu::ConvertLayoutOp>(
-            user)) {
+            triton::ExperimentalInterleaveOp, triton::CatOp,
+            triton::gpu::ConvertLayoutOp>(user)) {
       setEncoding(user->getResults(), info, changed, user);
       continue;
     }
@@ -679,7 +679,8 @@ Operation *LayoutPropagation::rewriteOp(Operation *op) {
   if (op->hasTrait<mlir::OpTrait::SameOperandsAndResultEncoding>() ||
       op->hasTrait<mlir::OpTrait::Elementwise>() ||
       isa<triton::ReduceOp, triton::ExpandDimsOp,
-          triton::ExperimentalInterleaveOp, triton::gpu::ConvertLayoutOp>(op)) {
+          triton::ExperimentalInterleaveOp, triton::CatOp,
+          triton::gpu::ConvertLayoutOp>(op)) {
     Operation *newOp = cloneElementwise(rewriter, op, encoding);
     for (auto [oldResult, newResult] :
          llvm::zip(op->getResults(), newOp->getResults()))
@@ -813,6 +814,125 @@ static LogicalResult getRematerializableSlice(
   return success();
 }
 
+namespace {
+// Decides whether the conversion left by layout propagation should be
+// replaced by a rematerialization of its producers in the converted layout.
+// Backends can specialize it to weigh the cost of lowering the conversion
+// against the cost of the computations that rematerialization duplicates.
+class ConvertLayoutCostModel {
+public:
+  virtual ~ConvertLayoutCostModel() = default;
+
+  virtual bool shouldRematerialize(ConvertLayoutOp convertOp,
+                                   const SetVector<Value> &slice) const {
+    return true;
+  }
+};
+
+// Cost model for conversions from or to DPAS layouts on Intel GPUs. Such a
+// conversion goes through the shared local memory: every sub-group stores
+// and reloads the tensor and the work-group synchronizes in between. Costs
+// are counted in sub-group instructions.
+class IntelGPUConvertLayoutCostModel : public ConvertLayoutCostModel {
+public:
+  bool shouldRematerialize(ConvertLayoutOp convertOp,
+                           const SetVector<Value> &slice) const override {
+    auto srcTy = convertOp.getOperand().getType().cast<RankedTensorType>();
+    auto dstTy = convertOp.getType().cast<RankedTensorType>();
+    unsigned rematCost = getRematerializationCost(convertOp, slice);
+    unsigned conversionCost = getConversionCost(convertOp, srcTy, dstTy);
+    if (rematCost <= conversionCost)
+      return true;
+    convertOp.emitRemark() << "convert_layout kept: conversion cost "
+                           << conversionCost << ", rematerialization cost "
+                           << rematCost;
+    return false;
+  }
+
+private:
+  // Bytes of the shared local memory accessed per cycle.
+  static constexpr unsigned slmBytesPerCycle = 64;
+  // Cost of the work-group barrier separating the stores and the loads.
+  static constexpr unsigned barrierCost = 32;
+  // Extra cost per element of a duplicated global memory load.
+  static constexpr unsigned globalLoadCost = 4;
+
+  // With sub-groups of `threadsPerWarp` lanes, every per-thread element of
+  // the tensor is one sub-group access of `threadsPerWarp` elements.
+  static unsigned getSLMAccessCost(RankedTensorType type,
+                                   unsigned threadsPerWarp) {
+    unsigned bytes =
+        std::max<unsigned>(type.getElementTypeBitWidth() / 8, 1) *
+        threadsPerWarp;
+    return triton::gpu::getTotalElemsPerThread(type) *
+           llvm::divideCeil(bytes, slmBytesPerCycle);
+  }
+
+  static unsigned getConversionCost(ConvertLayoutOp convertOp,
+                                    RankedTensorType srcTy,
+                                    RankedTensorType dstTy) {
+    unsigned threadsPerWarp = triton::gpu::TritonGPUDialect::getThreadsPerWarp(
+        convertOp->getParentOfType<ModuleOp>());
+    return getSLMAccessCost(srcTy, threadsPerWarp) + barrierCost +
+           getSLMAccessCost(dstTy, threadsPerWarp);
+  }
+
+  // The operations whose results are still used outside of the slice, and
+  // their producers, are duplicated. The others are replaced by their
+  // rematerialization.
+  static unsigned getRematerializationCost(ConvertLayoutOp convertOp,
+                                           const SetVector<Value> &slice) {
+    DenseSet<Value> duplicated;
+    SmallVector<Value> queue;
+    for (Value v : slice) {
+      bool isUsedOutside = llvm::any_of(v.getUsers(), [&](Operation *user) {
+        if (user == convertOp.getOperation())
+          return false;
+        return user->getNumResults() == 0 ||
+               llvm::any_of(user->getResults(),
+                            [&](Value res) { return slice.count(res) == 0; });
+      });
+      if (isUsedOutside && duplicated.insert(v).second)
+        queue.push_back(v);
+    }
+    while (!queue.empty()) {
+      Operation *op = queue.pop_back_val().getDefiningOp();
+      if (!op)
+        continue;
+      for (Value operand : op->getOperands()) {
+        if (slice.count(operand) && duplicated.insert(operand).second)
+          queue.push_back(operand);
+      }
+    }
+
+    unsigned cost = 0;
+    for (Value v : duplicated) {
+      Operation *op = v.getDefiningOp();
+      if (!op || isa<arith::ConstantOp>(op))
+        continue;
+      unsigned elems = triton::gpu::getTotalElemsPerThread(v.getType());
+      cost += isa<triton::LoadOp>(op) ? elems * (1 + globalLoadCost) : elems;
+    }
+    return cost;
+  }
+};
+} // namespace
+
+static const ConvertLayoutCostModel &
+getConvertLayoutCostModel(ConvertLayoutOp convertOp) {
+  static ConvertLayoutCostModel defaultModel;
+  static IntelGPUConvertLayoutCostModel intelGPUModel;
+  auto isDpas = [](Value v) {
+    return v.getType()
+        .cast<RankedTensorType>()
+        .getEncoding()
+        .isa<triton::gpu::DpasEncodingAttr>();
+  };
+  if (isDpas(convertOp.getOperand()) || isDpas(convertOp.getResult()))
+    return intelGPUModel;
+  return defaultModel;
+}
+
 static void backwardRematerialization(ConvertLayoutOp convertOp) {
   // we don't want to rematerialize any conversion to/from shared
   if (triton::gpu::hasSharedEncoding(convertOp.getResult()) ||
@@ -833,7 +953,12 @@ static void backwardRematerialization(ConvertLayoutOp convertOp) {
   if (result.failed())
     return;
 
-  // 2. Rewrite the slice.
+  // 2. Check that the rematerialization is cheaper than the conversion.
+  if (!getConvertLayoutCostModel(convertOp).shouldRematerialize(convertOp,
+                                                                slice))
+    return;
+
+  // 3. Rewrite the slice.
   rewriteSlice(slice, layout, convertOp);
 }
 
@@ -0,0 +1,103 @@
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+
+//===----------------------------------------------------------------------===//
+// This file selects the number of warps of a kernel from its Triton IR, before
+// it is converted to TritonGPU IR with default layouts for that number:
+//
+//   * the accumulators of the dots are split into tiles of
+//     `kDotElemsPerThread` elements per work-item, the registers a DPAS
+//     accumulator of a warp fills without spilling;
+//   * the tensors loaded and stored are split into tiles of
+//     `kBytesPerThread` bytes per work-item, two 128-bit vectors, so that each
+//     work-item has a few accesses in flight.
+//
+// The largest number of warps these tiles need is rounded down to a power of
+// two and bounded by the hardware threads of an Xe core and by the largest
+// work-group of the device, which a work-group can't exceed.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-select-num-warps"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace {
+
+constexpr int64_t kDotElemsPerThread = 128;
+constexpr int64_t kBytesPerThread = 32;
+constexpr unsigned kMaxWorkGroupSize = 1024;
+
+static int64_t getNumElements(Type type) {
+  auto tensorTy = type.dyn_cast<RankedTensorType>();
+  return tensorTy ? tensorTy.getNumElements() : 0;
+}
+
+static int64_t getNumBytes(Type type) {
+  auto tensorTy = type.dyn_cast<RankedTensorType>();
+  if (!tensorTy)
+    return 0;
+  Type elemTy = tensorTy.getElementType();
+  unsigned bits = elemTy.isa<tt::PointerType>()
+                      ? 64
+                      : std::max(elemTy.getIntOrFloatBitWidth(), 8u);
+  return tensorTy.getNumElements() * bits / 8;
+}
+
+} // namespace
+
+class TritonIntelGPUSelectNumWarpsPass
+    : public TritonIntelGPUSelectNumWarpsBase<
+          TritonIntelGPUSelectNumWarpsPass> {
+public:
+  TritonIntelGPUSelectNumWarpsPass() = default;
+  TritonIntelGPUSelectNumWarpsPass(unsigned threadsPerWarp,
+                                   unsigned threadsPerXeCore) {
+    this->threadsPerWarp = threadsPerWarp;
+    this->threadsPerXeCore = threadsPerXeCore;
+  }
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+
+    int64_t numWarps = 1;
+    mod.walk([&](Operation *op) {
+      int64_t warps = 0;
+      if (auto dot = dyn_cast<tt::DotOp>(op))
+        warps = getNumElements(dot.getType()) /
+                (threadsPerWarp * kDotElemsPerThread);
+      else if (auto load = dyn_cast<tt::LoadOp>(op))
+        warps =
+            getNumBytes(load.getType()) / (threadsPerWarp * kBytesPerThread);
+      else if (auto store = dyn_cast<tt::StoreOp>(op))
+        warps = getNumBytes(store.getValue().getType()) /
+                (threadsPerWarp * kBytesPerThread);
+      numWarps = std::max(numWarps, warps);
+    });
+    unsigned maxNumWarps = std::min<unsigned>(
+        threadsPerXeCore, kMaxWorkGroupSize / threadsPerWarp);
+    numWarps = std::min<int64_t>(llvm::PowerOf2Floor(numWarps),
+                                 std::max(maxNumWarps, 1u));
+
+    LLVM_DEBUG(llvm::dbgs() << "selected " << numWarps << " warps\n");
+    mod->setAttr("triton_gpu.selected_num_warps",
+                 Builder(mod.getContext()).getI32IntegerAttr(numWarps));
+  }
+};
+
+std::unique_ptr<Pass> mlir::triton::gpu::intel::createSelectNumWarpsPass() {
+  return std::make_unique<TritonIntelGPUSelectNumWarpsPass>();
+}
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::intel::createSelectNumWarpsPass(unsigned threadsPerWarp,
+                                                   unsigned threadsPerXeCore) {
+  return std::make_unique<TritonIntelGPUSelectNumWarpsPass>(threadsPerWarp,
+                                                            threadsPerXeCore);
+}
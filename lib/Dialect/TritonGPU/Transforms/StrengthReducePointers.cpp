@@ -0,0 +1,275 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "triton/Dialect/TritonGPU/Transforms/Utility.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+// This file strength-reduces the tensors of pointers a loop recomputes at each
+// iteration from its induction variables, as left by the rewriting of the
+// block pointers:
+//
+//   scf.for %k = %lb to %ub step %s iter_args(%off = %off0) {
+//     %ptrs = addptr(splat(%base), (%range + splat(%k)) * splat(%stride))
+//     load(%ptrs)
+//     scf.yield %off + %c
+//   }
+//
+// becomes
+//
+//   %ptrs0 = addptr(splat(%base), (%range + splat(%lb)) * splat(%stride))
+//   scf.for %k = %lb to %ub step %s iter_args(..., %ptrs = %ptrs0) {
+//     load(%ptrs)
+//     scf.yield ..., addptr(%ptrs, splat(%s * %stride))
+//   }
+//
+// The offsets must be affine in the induction variables, i.e. the loop index
+// and the iter args incremented by a loop invariant, with loop invariant
+// multipliers, for the increment of the pointers to be the same at each
+// iteration. It is computed in i64 before the loop. The invariant parts of the
+// offsets left in the loop are hoisted by the LICM run after this pass.
+//===----------------------------------------------------------------------===//
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "tritonintelgpu-strength-reduce-pointers"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace {
+
+static Value toI64(OpBuilder &b, Location loc, Value value) {
+  Type i64Ty = b.getI64Type();
+  if (value.getType().isIndex())
+    return b.create<arith::IndexCastOp>(loc, i64Ty, value);
+  if (value.getType().getIntOrFloatBitWidth() < 64)
+    return b.create<arith::ExtSIOp>(loc, i64Ty, value);
+  return value;
+}
+
+// The increments of the values of a loop from an iteration to the next one,
+// as i64 scalars computed before the loop, null standing for 0.
+class Increments {
+public:
+  Increments(scf::ForOp loop) : loop(loop), builder(loop) {
+    Location loc = loop.getLoc();
+    if (loop.getInductionVar().getType().isIntOrIndex())
+      increments[loop.getInductionVar()] =
+          toI64(builder, loc, loop.getStep());
+    auto yield = cast<scf::YieldOp>(loop.getBody()->getTerminator());
+    for (auto [arg, next] :
+         llvm::zip(loop.getRegionIterArgs(), yield.getOperands())) {
+      auto add = next.getDefiningOp<arith::AddIOp>();
+      if (!add || !arg.getType().isIntOrIndex())
+        continue;
+      Value step = add.getLhs() == arg ? add.getRhs() : add.getLhs();
+      if ((add.getLhs() == arg || add.getRhs() == arg) &&
+          loop.isDefinedOutsideOfLoop(step))
+        increments[arg] = toI64(builder, loc, step);
+    }
+  }
+
+  // The increment of `value`, failing if it isn't an affine function of the
+  // induction variables.
+  FailureOr<Value> get(Value value) {
+    auto it = increments.find(value);
+    if (it != increments.end())
+      return it->second;
+    if (loop.isDefinedOutsideOfLoop(value))
+      return Value();
+    Operation *op = value.getDefiningOp();
+    if (!op || op->getBlock() != loop.getBody())
+      return failure();
+    FailureOr<Value> increment = compute(op);
+    if (succeeded(increment))
+      increments[value] = *increment;
+    return increment;
+  }
+
+private:
+  Value add(Value lhs, Value rhs) {
+    if (!lhs || !rhs)
+      return lhs ? lhs : rhs;
+    return builder.create<arith::AddIOp>(loop.getLoc(), lhs, rhs);
+  }
+
+  // The scalar i64 value of the loop invariant `value`, null if it isn't one.
+  Value getInvariantScalar(Value value) {
+    Location loc = loop.getLoc();
+    if (auto splat = value.getDefiningOp<tt::SplatOp>())
+      value = splat.getSrc();
+    if (loop.isDefinedOutsideOfLoop(value))
+      return value.getType().isIntOrIndex() ? toI64(builder, loc, value)
+                                            : Value();
+    auto cst = value.getDefiningOp<arith::ConstantOp>();
+    if (!cst)
+      return Value();
+    if (auto intAttr = cst.getValue().dyn_cast<IntegerAttr>())
+      return builder.create<arith::ConstantIntOp>(loc, intAttr.getInt(), 64);
+    auto dense = cst.getValue().dyn_cast<DenseIntElementsAttr>();
+    if (!dense || !dense.isSplat())
+      return Value();
+    return builder.create<arith::ConstantIntOp>(
+        loc, dense.getSplatValue<APInt>().getSExtValue(), 64);
+  }
+
+  FailureOr<Value> compute(Operation *op) {
+    if (isa<arith::ConstantOp, tt::MakeRangeOp>(op))
+      return Value();
+    if (isa<tt::SplatOp, tt::BroadcastOp, tt::ExpandDimsOp,
+            triton::gpu::ConvertLayoutOp, arith::ExtSIOp>(op))
+      return get(op->getOperand(0));
+    if (isa<arith::AddIOp, arith::SubIOp, tt::AddPtrOp>(op)) {
+      FailureOr<Value> lhs = get(op->getOperand(0));
+      FailureOr<Value> rhs = get(op->getOperand(1));
+      if (failed(lhs) || failed(rhs))
+        return failure();
+      if (isa<arith::SubIOp>(op) && *rhs)
+        return add(*lhs, builder.create<arith::SubIOp>(
+                             loop.getLoc(),
+                             builder.create<arith::ConstantIntOp>(
+                                 loop.getLoc(), 0, 64),
+                             *rhs)
+                             .getResult());
+      return add(*lhs, *rhs);
+    }
+    if (isa<arith::MulIOp>(op)) {
+      for (unsigned i = 0; i < 2; ++i) {
+        Value factor = getInvariantScalar(op->getOperand(1 - i));
+        if (!factor)
+          continue;
+        FailureOr<Value> increment = get(op->getOperand(i));
+        if (failed(increment) || !*increment)
+          return increment;
+        return builder
+            .create<arith::MulIOp>(loop.getLoc(), *increment, factor)
+            .getResult();
+      }
+    }
+    return failure();
+  }
+
+  scf::ForOp loop;
+  OpBuilder builder;
+  DenseMap<Value, Value> increments;
+};
+
+// Clone the computation of `value` in the loop before it, for the first
+// iteration.
+static Value cloneBeforeLoop(OpBuilder &b, scf::ForOp loop, Value value,
+                             IRMapping &mapping) {
+  if (loop.isDefinedOutsideOfLoop(value))
+    return value;
+  if (Value mapped = mapping.lookupOrNull(value))
+    return mapped;
+  Operation *op = value.getDefiningOp();
+  for (Value operand : op->getOperands())
+    cloneBeforeLoop(b, loop, operand, mapping);
+  return b.clone(*op, mapping)->getResult(0);
+}
+
+static bool isTensorOfPointers(Value value) {
+  auto tensorTy = value.getType().dyn_cast<RankedTensorType>();
+  return tensorTy && tensorTy.getElementType().isa<tt::PointerType>();
+}
+
+// Erase the dead operations from `begin` to `end`, excluded, in reverse.
+static void eraseDeadOps(Block::iterator begin, Block::iterator end) {
+  for (Operation &op : llvm::make_early_inc_range(
+           llvm::reverse(llvm::make_range(begin, end))))
+    if (isOpTriviallyDead(&op))
+      op.erase();
+}
+
+static void strengthReduce(scf::ForOp loop) {
+  Block *parent = loop->getBlock();
+  Operation *prev = loop->getPrevNode();
+  auto getBegin = [&]() {
+    return prev ? std::next(prev->getIterator()) : parent->begin();
+  };
+  Increments increments(loop);
+  // The pointers computed in the loop used otherwise than to compute other
+  // pointers, and their increments.
+  llvm::MapVector<Value, Value> carried;
+  for (auto addPtr : loop.getBody()->getOps<tt::AddPtrOp>()) {
+    if (!isTensorOfPointers(addPtr.getResult()) ||
+        llvm::all_of(addPtr->getUsers(),
+                     [](Operation *user) { return isa<tt::AddPtrOp>(user); }))
+      continue;
+    FailureOr<Value> increment = increments.get(addPtr.getResult());
+    if (succeeded(increment) && *increment)
+      carried.insert({addPtr.getResult(), *increment});
+  }
+  if (carried.empty()) {
+    // Drop the increments computed for nothing.
+    eraseDeadOps(getBegin(), loop->getIterator());
+    return;
+  }
+
+  OpBuilder b(loop);
+  IRMapping mapping;
+  mapping.map(loop.getInductionVar(), loop.getLowerBound());
+  for (auto [arg, init] : llvm::zip(loop.getRegionIterArgs(), loop.getInits()))
+    mapping.map(arg, init);
+  SmallVector<Value> inits;
+  for (Value ptr : llvm::make_first_range(carried))
+    inits.push_back(cloneBeforeLoop(b, loop, ptr, mapping));
+
+  LLVM_DEBUG(llvm::dbgs() << "carrying " << carried.size()
+                          << " tensors of pointers in " << loop << "\n");
+  scf::ForOp newLoop = replaceForOpWithNewSignature(b, loop, inits);
+  // e.g. the unroll factor of the loop
+  newLoop->setAttrs(loop->getAttrs());
+  loop.erase();
+
+  Block *body = newLoop.getBody();
+  auto yield = cast<scf::YieldOp>(body->getTerminator());
+  b.setInsertionPoint(yield);
+  unsigned numArgs = newLoop.getNumRegionIterArgs() - carried.size();
+  SmallVector<Value> yielded(yield.getOperands());
+  for (auto [i, entry] : llvm::enumerate(carried)) {
+    auto [ptr, increment] = entry;
+    Value arg = newLoop.getRegionIterArgs()[numArgs + i];
+    ptr.replaceAllUsesWith(arg);
+    auto ptrTy = ptr.getType().cast<RankedTensorType>();
+    auto offsetTy = RankedTensorType::get(
+        ptrTy.getShape(), b.getI64Type(), ptrTy.getEncoding());
+    Value offset = b.create<tt::SplatOp>(yield.getLoc(), offsetTy, increment);
+    yielded.push_back(b.create<tt::AddPtrOp>(yield.getLoc(), ptrTy, arg,
+                                             offset));
+  }
+  yield->setOperands(yielded);
+
+  // Leave no per-iteration offsets behind for the later passes.
+  eraseDeadOps(body->begin(), body->end());
+  eraseDeadOps(getBegin(), newLoop->getIterator());
+}
+
+} // namespace
+
+class TritonIntelGPUStrengthReducePointersPass
+    : public TritonIntelGPUStrengthReducePointersBase<
+          TritonIntelGPUStrengthReducePointersPass> {
+public:
+  void runOnOperation() override {
+    // The inner loops first, their initial pointers being computed in the
+    // loops enclosing them.
+    SmallVector<scf::ForOp> loops;
+    getOperation().walk([&](scf::ForOp loop) { loops.push_back(loop); });
+    for (scf::ForOp loop : loops)
+      strengthReduce(loop);
+  }
+};
+
+std::unique_ptr<Pass>
+mlir::triton::gpu::intel::createStrengthReducePointersPass() {
+  return std::make_unique<TritonIntelGPUStrengthReducePointersPass>();
+}
@@ -319,6 +319,62 @@ inferSrcEncoding(triton::ExperimentalInterleaveOp op, Attribute encoding) {
       enc.getOrder(), enc.getCTALayout());
 }
 
+// The blocked encoding `enc` with the elements per thread of its most minor
+// dimension scaled by `num` / `den`, provided it stays a whole number.
+static triton::gpu::BlockedEncodingAttr
+scaleMinorSizePerThread(triton::gpu::BlockedEncodingAttr enc, unsigned num,
+                        unsigned den) {
+  unsigned minor = enc.getOrder()[0];
+  SmallVector<unsigned> sizePerThread(enc.getSizePerThread());
+  if (sizePerThread[minor] * num % den != 0)
+    return {};
+  sizePerThread[minor] = sizePerThread[minor] * num / den;
+  return triton::gpu::BlockedEncodingAttr::get(
+      enc.getContext(), sizePerThread, enc.getThreadsPerWarp(),
+      enc.getWarpsPerCTA(), enc.getOrder(), enc.getCTALayout());
+}
+
+// The cat of two tensors of the same type, which may reorder the elements,
+// concatenates the elements each thread holds: the result has the encoding
+// of the operands with twice their elements per thread in the most minor
+// dimension, and the cat is a rename of the registers, provided the threads
+// hold twice as many elements of the result as of each operand.
+static bool isRegisterCat(triton::CatOp op, Attribute srcEncoding,
+                          Attribute dstEncoding) {
+  auto lhsType = op.getLhs().getType().cast<RankedTensorType>();
+  auto rhsType = op.getRhs().getType().cast<RankedTensorType>();
+  auto retType = op.getType().cast<RankedTensorType>();
+  if (lhsType.getShape() != rhsType.getShape())
+    return false;
+  Type elemTy = retType.getElementType();
+  return triton::gpu::getTotalElemsPerThread(dstEncoding, retType.getShape(),
+                                             elemTy) ==
+         2 * triton::gpu::getTotalElemsPerThread(
+                 srcEncoding, lhsType.getShape(), elemTy);
+}
+
+static std::optional<Attribute> inferDstEncoding(triton::CatOp op,
+                                                 Attribute encoding) {
+  auto enc = encoding.dyn_cast<triton::gpu::BlockedEncodingAttr>();
+  if (!enc)
+    return std::nullopt;
+  auto dstEnc = scaleMinorSizePerThread(enc, 2, 1);
+  if (!isRegisterCat(op, enc, dstEnc))
+    return std::nullopt;
+  return dstEnc;
+}
+
+static std::optional<Attribute> inferSrcEncoding(triton::CatOp op,
+                                                 Attribute encoding) {
+  auto enc = encoding.dyn_cast<triton::gpu::BlockedEncodingAttr>();
+  if (!enc)
+    return std::nullopt;
+  auto srcEnc = scaleMinorSizePerThread(enc, 1, 2);
+  if (!srcEnc || !isRegisterCat(op, srcEnc, enc))
+    return std::nullopt;
+  return srcEnc;
+}
+
 std::optional<Attribute> inferSrcEncoding(Operation *op, Attribute encoding) {
   if (auto reduceOp = dyn_cast<triton::ReduceOp>(op))
     return inferSrcEncoding(reduceOp, encoding);
@@ -326,7 +382,9 @@ std::optional<Attribute> inferSrcEncoding(Operation *op, Attribute encoding) {
     return inferSrcEncoding(expand, encoding);
   if (auto interleave = dyn_cast<triton::ExperimentalInterleaveOp>(op))
     return inferSrcEncoding(interleave, encoding);
-  if (isa<triton::ReshapeOp, triton::CatOp>(op))
+  if (auto cat = dyn_cast<triton::CatOp>(op))
+    return inferSrcEncoding(cat, encoding);
+  if (isa<triton::ReshapeOp>(op))
     return std::nullopt;
   return encoding;
 }
@@ -338,7 +396,9 @@ std::optional<Attribute> inferDstEncoding(Operation *op, Attribute encoding) {
     return inferDstEncoding(expand, encoding);
   if (auto interleave = dyn_cast<triton::ExperimentalInterleaveOp>(op))
     return inferDstEncoding(interleave, encoding);
-  if (isa<triton::ReshapeOp, triton::CatOp>(op))
+  if (auto cat = dyn_cast<triton::CatOp>(op))
+    return inferDstEncoding(cat, encoding);
+  if (isa<triton::ReshapeOp>(op))
     return std::nullopt;
   return encoding;
 }
@@ -418,7 +478,8 @@ bool canFoldIntoConversion(Operation *op, Attribute targetEncoding) {
                                          newDstType);
   }
   return isa<triton::gpu::ConvertLayoutOp, arith::ConstantOp,
-             triton::MakeRangeOp, triton::SplatOp, triton::HistogramOp>(op);
+             triton::MakeRangeOp, triton::SplatOp, triton::HistogramOp,
+             triton::TopKOp>(op);
 }
 
 scf::ForOp replaceForOpWithNewSignature(OpBuilder &rewriter, scf::ForOp loop,
@@ -517,8 +578,6 @@ getConvertBackwardSlice(Value root, SetVector<Value> &slice,
         continue;
       if (stopPropagation && stopPropagation(definingOp))
         continue;
-      if (isa<triton::CatOp>(definingOp))
-        return failure();
       for (Value operand : definingOp->getOperands()) {
         auto srcEncoding = inferSrcEncoding(definingOp, encoding);
         if (!srcEncoding)
@@ -72,13 +72,21 @@ bool isDivisible(Value v, unsigned divisor) {
 }
 
 bool shouldRemove(tt::MakeTensorPtrOp &op, int computeCapability) {
-  if (computeCapability < 90 || !::triton::tools::getBoolEnv("ENABLE_TMA"))
-    return true;
   auto resType = op.getResult()
                      .getType()
                      .cast<tt::PointerType>()
                      .getPointeeType()
                      .cast<RankedTensorType>();
+  // Block pointers materialized with a DPAS layout are lowered to 2D block IO
+  // on Intel GPUs.
+  Attribute encoding = resType.getEncoding();
+  if (auto dotLayout =
+          encoding.dyn_cast_or_null<ttg::DotOperandEncodingAttr>())
+    encoding = dotLayout.getParent();
+  if (encoding.isa_and_nonnull<ttg::DpasEncodingAttr>())
+    return false;
+  if (computeCapability < 90 || !::triton::tools::getBoolEnv("ENABLE_TMA"))
+    return true;
   auto elemType = resType.getElementType();
   auto ord = op.getOrder();
   auto stride = op.getStrides();
@@ -266,6 +274,41 @@ public:
     return curTensor;
   }
 
+  // Replace the rows of the block by those of its pages of `pageSize` rows,
+  // whose indices `pages` points to, as read by tt.load_pages. Each element
+  // loads the index of its page, whose loads are cached.
+  void setPagedRows(OpBuilder &builder, const Location &loc, Value pages,
+                    int32_t pageSize) {
+    Value rows = getExpandedOffsetWithRange(builder, loc, 0);
+    auto rowsType = rows.getType().cast<RankedTensorType>();
+    auto splat = [&](Value value) -> Value {
+      return builder.create<tt::SplatOp>(loc, rowsType, value);
+    };
+    Value size =
+        splat(builder.create<arith::ConstantIntOp>(loc, pageSize, 64));
+    Value row = builder.create<arith::SubIOp>(loc, rows, splat(offsets[0]));
+    Value slot = builder.create<arith::DivSIOp>(loc, row, size);
+    Value rowInPage = builder.create<arith::RemSIOp>(loc, row, size);
+
+    auto pagesType = RankedTensorType::get(
+        rowsType.getShape(), pages.getType(), rowsType.getEncoding());
+    Value pagePtrs = builder.create<tt::AddPtrOp>(
+        loc, pagesType, builder.create<tt::SplatOp>(loc, pagesType, pages),
+        slot);
+    auto pageType = RankedTensorType::get(
+        rowsType.getShape(), builder.getI32Type(), rowsType.getEncoding());
+    Value page = builder.create<tt::LoadOp>(
+        loc, pageType, pagePtrs, /*mask=*/Value(), /*other=*/Value(),
+        /*boundaryCheck=*/nullptr, /*padding=*/nullptr,
+        tt::CacheModifier::NONE, tt::EvictionPolicy::NORMAL,
+        /*isVolatile=*/false);
+    Value pageRow = builder.create<arith::MulIOp>(
+        loc, builder.create<arith::ExtSIOp>(loc, rowsType, page), size);
+    Value pagedRows = builder.create<arith::AddIOp>(loc, pageRow, rowInPage);
+    cachedOffsetWithRange[0] =
+        builder.create<arith::AddIOp>(loc, pagedRows, splat(offsets[0]));
+  }
+
   Value generatePtr(OpBuilder &builder, const Location &loc) {
     assert(tensorShape.size() == offsets.size() &&
            tensorShape.size() == strides.size());
@@ -518,7 +561,15 @@ public:
     // padding). Also note that load with tensor pointers do not have `mask` and
     // `other` while building IR from Python AST
     std::optional<ArrayRef<int>> boundaryCheck;
-    if (auto loadOp = dyn_cast<tt::LoadOp>(op)) {
+    // The elements of the pages out of the tensor are zeros.
+    static const int pagesBoundaryCheck[] = {0, 1};
+    if (auto loadPagesOp = dyn_cast<tt::LoadPagesOp>(op)) {
+      boundaryCheck = ArrayRef<int>(pagesBoundaryCheck);
+      info.setEncoding(
+          loadPagesOp.getType().cast<RankedTensorType>().getEncoding());
+      info.setPagedRows(builder, op->getLoc(), loadPagesOp.getPages(),
+                        loadPagesOp.getPageSize());
+    } else if (auto loadOp = dyn_cast<tt::LoadOp>(op)) {
       assert(!loadOp.getMask() && !loadOp.getOther());
       boundaryCheck = loadOp.getBoundaryCheck();
       if (auto valueType =
@@ -547,6 +598,15 @@ public:
           newOther, loadOp.getBoundaryCheckAttr(), loadOp.getPaddingAttr(),
           loadOp.getCache(), loadOp.getEvict(), loadOp.getIsVolatile());
       op->getResult(0).replaceAllUsesWith(newResult);
+    } else if (auto loadPagesOp = dyn_cast<tt::LoadPagesOp>(op)) {
+      Value newOther = info.generateOther(builder, op->getLoc(),
+                                          tt::PaddingOption::PAD_ZERO);
+      auto newResult = builder.create<tt::LoadOp>(
+          loadPagesOp.getLoc(), loadPagesOp.getType(), newPtr, newMask,
+          newOther, /*boundaryCheck=*/nullptr, /*padding=*/nullptr,
+          loadPagesOp.getCache(), loadPagesOp.getEvict(),
+          /*isVolatile=*/false);
+      op->getResult(0).replaceAllUsesWith(newResult);
     } else if (auto storeOp = dyn_cast<tt::StoreOp>(op)) {
       builder.create<tt::StoreOp>(storeOp.getLoc(), newPtr, storeOp.getValue(),
                                   newMask, storeOp.getCache(),
@@ -754,7 +814,7 @@ public:
                                     valueToRemove);
     } else if (auto advanceOp = dyn_cast<tt::AdvanceOp>(op)) {
       return rewriteAdvanceOp(builder, advanceOp, eraser, valueToRemove);
-    } else if (isa<tt::LoadOp>(op) || isa<tt::StoreOp>(op)) {
+    } else if (isa<tt::LoadOp, tt::LoadPagesOp, tt::StoreOp>(op)) {
       return rewriteLoadStoreOp(builder, op, eraser, valueToRemove);
     } else if (op->getDialect()->getNamespace() == "scf" ||
                op->getDialect()->getNamespace() == "cf") {
@@ -816,7 +876,7 @@ public:
           }
         }
       }
-      if (llvm::isa<tt::LoadOp, tt::StoreOp>(op)) {
+      if (llvm::isa<tt::LoadOp, tt::LoadPagesOp, tt::StoreOp>(op)) {
         auto src = op->getOperand(0);
         if (tt::isTensorPointerType(src.getType())) {
           auto makeTensorPtrOp = getMakeTensorPtrOp(src);
@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+/// Implements a pass outlining the cold regions of the kernels into functions
+/// of their own, so that the unrolled hot code isn't interleaved with code it
+/// never runs and stays resident in the instruction cache. A region is cold
+/// when its entry block:
+///  - calls an assert handler or another cold function, or ends in
+///    unreachable, e.g. the failure branch of tt.assert,
+///  - is only reached by edges with a probability of at most 1/1000, i.e. the
+///    branches marked unlikely by their weights.
+/// The region is the entry block and the blocks it dominates, provided they
+/// don't return from the function nor synchronize the work-group: the
+/// outlined code runs in divergent control flow.
+//===----------------------------------------------------------------------===//
+#include "LLVMPasses.h"
+#include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/PostDominators.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Transforms/Utils/CodeExtractor.h"
+
+using namespace llvm;
+
+// The handlers the lowering of tt.assert calls, for GENX and NVIDIA.
+static constexpr StringRef kAssertHandlers[] = {"__assert_fail",
+                                                "__assertfail"};
+
+// The regions only reached by unlikely branches are outlined when they are
+// large enough to pay for the call.
+static const BranchProbability kColdProbability(1, 1000);
+static constexpr unsigned kMinUnlikelyRegionSize = 8;
+
+static bool hasColdCall(const BasicBlock &BB) {
+  for (const Instruction &inst : BB)
+    if (auto *call = dyn_cast<CallBase>(&inst))
+      if (call->hasFnAttr(Attribute::Cold))
+        return true;
+  return false;
+}
+
+static bool callsOutlined(const BasicBlock &BB,
+                          const SmallPtrSetImpl<Function *> &outlined) {
+  for (const Instruction &inst : BB)
+    if (auto *call = dyn_cast<CallBase>(&inst))
+      if (outlined.contains(call->getCalledFunction()))
+        return true;
+  return false;
+}
+
+static bool isUnlikelyReached(const BasicBlock &BB,
+                              const BranchProbabilityInfo &BPI) {
+  if (pred_empty(&BB))
+    return false;
+  for (const BasicBlock *pred : predecessors(&BB))
+    if (BPI.getEdgeProbability(pred, &BB) > kColdProbability)
+      return false;
+  return true;
+}
+
+// Returns the blocks dominated by `entry`, or nothing when they can't be
+// outlined.
+static SmallVector<BasicBlock *> getRegion(BasicBlock *entry,
+                                           DominatorTree &DT) {
+  SmallVector<BasicBlock *> region;
+  SmallVector<DomTreeNode *> worklist = {DT.getNode(entry)};
+  while (!worklist.empty()) {
+    DomTreeNode *node = worklist.pop_back_val();
+    BasicBlock *BB = node->getBlock();
+    if (isa<ReturnInst>(BB->getTerminator()))
+      return {};
+    for (Instruction &inst : *BB)
+      if (auto *call = dyn_cast<CallBase>(&inst))
+        if (call->isConvergent() || call->isInlineAsm())
+          return {};
+    region.push_back(BB);
+    worklist.append(node->begin(), node->end());
+  }
+  return region;
+}
+
+static unsigned getSize(ArrayRef<BasicBlock *> region) {
+  unsigned size = 0;
+  for (BasicBlock *BB : region)
+    size += BB->sizeWithoutDebug();
+  return size;
+}
+
+// Outlines the first cold region of `F`, left to its call, and returns
+// whether it did.
+static bool outlineColdRegion(Function &F,
+                              SmallPtrSetImpl<Function *> &outlinedFuncs) {
+  DominatorTree DT(F);
+  PostDominatorTree PDT(F);
+  LoopInfo LI(DT);
+  BranchProbabilityInfo BPI(F, LI, /*TLI=*/nullptr, &DT, &PDT);
+  for (BasicBlock &BB : F) {
+    if (&BB == &F.getEntryBlock() || BB.isEHPad() ||
+        callsOutlined(BB, outlinedFuncs))
+      continue;
+    bool cold = hasColdCall(BB) || isa<UnreachableInst>(BB.getTerminator());
+    if (!cold && !isUnlikelyReached(BB, BPI))
+      continue;
+    SmallVector<BasicBlock *> region = getRegion(&BB, DT);
+    // The cold blocks are outlined unless they hold their terminator only.
+    unsigned minSize = cold ? 2 : kMinUnlikelyRegionSize;
+    if (region.empty() || getSize(region) < minSize)
+      continue;
+    CodeExtractor extractor(region, &DT, /*AggregateArgs=*/false,
+                            /*BFI=*/nullptr, /*BPI=*/nullptr, /*AC=*/nullptr,
+                            /*AllowVarArgs=*/false, /*AllowAlloca=*/false,
+                            /*AllocationBlock=*/nullptr, /*Suffix=*/"cold");
+    if (!extractor.isEligible())
+      continue;
+    CodeExtractorAnalysisCache CEAC(F);
+    Function *outlined = extractor.extractCodeRegion(CEAC);
+    if (!outlined)
+      continue;
+    // The kernels call the outlined code as SPIR-V functions.
+    CallingConv::ID cc = F.getCallingConv() == CallingConv::SPIR_KERNEL
+                             ? CallingConv::SPIR_FUNC
+                             : F.getCallingConv();
+    outlined->setCallingConv(cc);
+    outlined->addFnAttr(Attribute::Cold);
+    outlined->addFnAttr(Attribute::NoInline);
+    outlined->addFnAttr(Attribute::OptimizeForSize);
+    for (User *user : outlined->users())
+      if (auto *call = dyn_cast<CallInst>(user))
+        call->setCallingConv(cc);
+    outlinedFuncs.insert(outlined);
+    return true;
+  }
+  return false;
+}
+
+PreservedAnalyses OutlineColdRegionsPass::run(Module &M,
+                                              ModuleAnalysisManager &AM) {
+  bool changed = false;
+  for (StringRef name : kAssertHandlers) {
+    Function *handler = M.getFunction(name);
+    if (handler && !handler->hasFnAttribute(Attribute::Cold)) {
+      handler->addFnAttr(Attribute::Cold);
+      changed = true;
+    }
+  }
+
+  SmallVector<Function *> functions;
+  for (Function &F : M)
+    if (!F.isDeclaration() && !F.hasFnAttribute(Attribute::Cold) &&
+        !F.hasOptNone())
+      functions.push_back(&F);
+  SmallPtrSet<Function *, 8> outlined;
+  for (Function *F : functions)
+    while (outlineColdRegion(*F, outlined))
+      changed = true;
+  return changed ? PreservedAnalyses::none() : PreservedAnalyses::all();
+}
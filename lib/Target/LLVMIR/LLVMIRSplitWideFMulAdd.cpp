@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+/// Implements a pass splitting the vector fmuladd/fma intrinsic calls wider
+/// than 16 lanes into calls of at most 16 lanes. The SLP vectorizer builds
+/// such calls out of the unrolled multiply-add chains generated by Triton,
+/// while SPIR-V vectors have at most 16 components.
+//===----------------------------------------------------------------------===//
+#include "LLVMPasses.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+
+using namespace llvm;
+
+static constexpr unsigned kMaxLanes = 16;
+
+static bool isWideFMulAdd(Instruction &inst) {
+  auto *intrinsic = dyn_cast<IntrinsicInst>(&inst);
+  if (!intrinsic || (intrinsic->getIntrinsicID() != Intrinsic::fmuladd &&
+                     intrinsic->getIntrinsicID() != Intrinsic::fma))
+    return false;
+  auto *vecTy = dyn_cast<FixedVectorType>(intrinsic->getType());
+  return vecTy && vecTy->getNumElements() > kMaxLanes;
+}
+
+static void splitFMulAdd(IntrinsicInst *intrinsic) {
+  auto *vecTy = cast<FixedVectorType>(intrinsic->getType());
+  unsigned numElems = vecTy->getNumElements();
+  IRBuilder<> builder(intrinsic);
+  Value *result = PoisonValue::get(vecTy);
+  for (unsigned start = 0; start < numElems; start += kMaxLanes) {
+    unsigned lanes = std::min(kMaxLanes, numElems - start);
+    SmallVector<int> extractMask(lanes);
+    for (unsigned i = 0; i < lanes; ++i)
+      extractMask[i] = start + i;
+    SmallVector<Value *> args;
+    for (Value *arg : intrinsic->args())
+      args.push_back(builder.CreateShuffleVector(arg, extractMask));
+    Value *part = builder.CreateIntrinsic(intrinsic->getIntrinsicID(),
+                                          {args[0]->getType()}, args,
+                                          /*FMFSource=*/intrinsic);
+    // Widen the part back to the full width and blend it into the result.
+    SmallVector<int> widenMask(numElems, -1);
+    for (unsigned i = 0; i < lanes; ++i)
+      widenMask[start + i] = i;
+    Value *widened = builder.CreateShuffleVector(part, widenMask);
+    SmallVector<int> blendMask(numElems);
+    for (unsigned i = 0; i < numElems; ++i)
+      blendMask[i] = (i >= start && i < start + lanes) ? numElems + i : i;
+    result = builder.CreateShuffleVector(result, widened, blendMask);
+  }
+  intrinsic->replaceAllUsesWith(result);
+  intrinsic->eraseFromParent();
+}
+
+static bool runOnFunction(Function &F) {
+  SmallVector<IntrinsicInst *> wideCalls;
+  for (BasicBlock &BB : F)
+    for (Instruction &inst : BB)
+      if (isWideFMulAdd(inst))
+        wideCalls.push_back(cast<IntrinsicInst>(&inst));
+  for (IntrinsicInst *intrinsic : wideCalls)
+    splitFMulAdd(intrinsic);
+  return !wideCalls.empty();
+}
+
+PreservedAnalyses SplitWideFMulAddPass::run(Function &F,
+                                            FunctionAnalysisManager &AM) {
+  bool b = runOnFunction(F);
+  return b ? PreservedAnalyses::none() : PreservedAnalyses::all();
+}
@@ -13,4 +13,21 @@ struct BreakStructPhiNodesPass : PassInfoMixin<BreakStructPhiNodesPass> {
   static StringRef name() { return "BreakStructPhiNodesPass"; }
 };
 
+// Pass to split the vector llvm.fmuladd/llvm.fma calls wider than 16 lanes,
+// which the SLP vectorizer may build, into calls of at most 16 lanes.
+struct SplitWideFMulAddPass : PassInfoMixin<SplitWideFMulAddPass> {
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
+
+  static StringRef name() { return "SplitWideFMulAddPass"; }
+};
+
+// Pass to outline the cold regions of the functions, e.g. the assert
+// handlers and the branches marked unlikely, into cold functions so that they
+// don't take up the instruction cache of the hot code.
+struct OutlineColdRegionsPass : PassInfoMixin<OutlineColdRegionsPass> {
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+
+  static StringRef name() { return "OutlineColdRegionsPass"; }
+};
+
 } // namespace llvm
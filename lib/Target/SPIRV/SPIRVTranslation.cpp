@@ -3,14 +3,17 @@
 
 #include "LLVMSPIRVLib.h"
 #include "llvm/IR/IRBuilder.h"
-#include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Linker/Linker.h"
 #include "llvm/MC/TargetRegistry.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
+#include <map>
+#include <mutex>
+#include <sstream>
 
 namespace triton {
 
@@ -32,35 +35,63 @@ public:
   SmallVectorBuffer(llvm::SmallVectorImpl<char> &O) : OS(O) {}
 };
 
-std::string translateLLVMIRToSPIRV(llvm::Module &module) {
-  // initLLVM();
-
-  llvm::SmallVector<char, 0> buffer;
+static const std::map<std::string, SPIRV::ExtensionID> &getExtensionIDs() {
+  static const std::map<std::string, SPIRV::ExtensionID> extensionIDs = [] {
+    std::map<std::string, SPIRV::ExtensionID> ids;
+#define EXT(X) ids[#X] = SPIRV::ExtensionID::X;
+#include "LLVMSPIRVExtensions.inc"
+#undef EXT
+    return ids;
+  }();
+  return extensionIDs;
+}
 
-  // verify and store llvm
-  llvm::legacy::PassManager pm;
-  pm.add(llvm::createVerifierPass());
-  pm.run(module);
-  // module->print(llvm::outs(), nullptr);
+// The translator options are built once for each set of extensions, the
+// kernels of a device all use the same one.
+static const SPIRV::TranslatorOpts &
+getTranslatorOpts(const std::vector<std::string> &extensions) {
+  static std::mutex mutex;
+  static std::map<std::vector<std::string>, SPIRV::TranslatorOpts> cache;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = cache.find(extensions);
+  if (it != cache.end())
+    return it->second;
 
-  if (module.materializeAll()) {
-    llvm::errs() << "SPIRVTranslation: failed to read the LLVM module IR!";
-    llvm::errs().flush();
-    std::string result(buffer.begin(), buffer.end());
-    return result;
+  SPIRV::TranslatorOpts SPIRVOpts;
+  if (extensions.empty()) {
+    SPIRVOpts.enableAllExtensions();
+  } else {
+    const auto &extensionIDs = getExtensionIDs();
+    for (const std::string &extension : extensions) {
+      // The extensions unknown to this version of the translator are never
+      // emitted anyway.
+      auto id = extensionIDs.find(extension);
+      if (id != extensionIDs.end())
+        SPIRVOpts.setAllowedToUseExtension(id->second);
+    }
   }
+  SPIRVOpts.setMemToRegEnabled(true);
+  SPIRVOpts.setPreserveOCLKernelArgTypeMetadataThroughString(true);
+  SPIRVOpts.setPreserveAuxData(false);
+  SPIRVOpts.setSPIRVAllowUnknownIntrinsics({"llvm.genx.GenISA."});
+  return cache.emplace(extensions, std::move(SPIRVOpts)).first->second;
+}
+
+std::string translateLLVMIRToSPIRV(llvm::Module &module, bool verify,
+                                   const std::vector<std::string> &extensions) {
+  llvm::SmallVector<char, 0> buffer;
+
+  // The modules are verified by MLIR when translated to LLVM IR, and the
+  // LLVM pipeline keeps them valid.
+  if (verify && llvm::verifyModule(module, &llvm::errs()))
+    llvm::report_fatal_error("SPIRVTranslation: broken LLVM module");
 
   // emit
   SmallVectorBuffer StreamBuf(buffer);
   std::ostream OS(&StreamBuf);
   std::string Err;
 
-  SPIRV::TranslatorOpts SPIRVOpts;
-  SPIRVOpts.enableAllExtensions();
-  SPIRVOpts.setMemToRegEnabled(true);
-  SPIRVOpts.setPreserveOCLKernelArgTypeMetadataThroughString(true);
-  SPIRVOpts.setPreserveAuxData(false);
-  SPIRVOpts.setSPIRVAllowUnknownIntrinsics({"llvm.genx.GenISA."});
+  const SPIRV::TranslatorOpts &SPIRVOpts = getTranslatorOpts(extensions);
   auto success = llvm::writeSpirv(&module, SPIRVOpts, OS, Err);
 
   if (!success) {
@@ -73,4 +104,41 @@ std::string translateLLVMIRToSPIRV(llvm::Module &module) {
   return result;
 }
 
+std::string linkSPIRVModules(const std::vector<std::string> &binaries,
+                             const std::vector<std::string> &names,
+                             std::string &error) {
+  if (binaries.size() != names.size()) {
+    error = "expected one kernel name per SPIR-V module";
+    return "";
+  }
+  llvm::LLVMContext context;
+  const SPIRV::TranslatorOpts &SPIRVOpts = getTranslatorOpts({});
+  std::unique_ptr<llvm::Module> linked;
+  for (auto [binary, name] : llvm::zip(binaries, names)) {
+    std::istringstream IS(binary);
+    llvm::Module *module = nullptr;
+    if (!llvm::readSpirv(context, SPIRVOpts, IS, module, error))
+      return "";
+    std::unique_ptr<llvm::Module> owned(module);
+    // The specializations of a kernel share its name.
+    for (llvm::Function &func : *owned)
+      if (func.getCallingConv() == llvm::CallingConv::SPIR_KERNEL)
+        func.setName(name);
+    if (!linked) {
+      linked = std::move(owned);
+      continue;
+    }
+    // The functions internal to the kernels are renamed on conflicts.
+    if (llvm::Linker::linkModules(*linked, std::move(owned))) {
+      error = "failed to link the SPIR-V modules";
+      return "";
+    }
+  }
+  if (!linked) {
+    error = "no SPIR-V module to link";
+    return "";
+  }
+  return translateLLVMIRToSPIRV(*linked);
+}
+
 } // namespace triton
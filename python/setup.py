@@ -427,7 +427,7 @@ class plugin_egginfo(egg_info):
 
 
 package_data = dict()
-package_data["triton/tools"] = ["compile.h", "compile.c"]
+package_data["triton/tools"] = ["compile.h", "compile.c", "compile_xpu.h", "compile_xpu.c"]
 package_data.update({f"triton/backends/{b.name}": b.package_data for b in backends})
 
 setup(
@@ -3,42 +3,74 @@
 
 namespace py = pybind11;
 
+namespace {
+
+// The pointers of a block are most often contiguous and unmasked, e.g. the
+// rows of a tensor, they are then copied with a single memcpy.
+bool isContiguous(const uint64_t *ptrs, const bool *masks, size_t numel,
+                  size_t itemSize) {
+  for (size_t i = 0; i < numel; ++i)
+    if (!masks[i] || (i > 0 && ptrs[i] != ptrs[i - 1] + itemSize))
+      return false;
+  return true;
+}
+
+using PtrArray =
+    py::array_t<uint64_t, py::array::c_style | py::array::forcecast>;
+using MaskArray = py::array_t<bool, py::array::c_style | py::array::forcecast>;
+
+} // namespace
+
 void init_triton_interpreter(py::module &&m) {
   using ret = py::return_value_policy;
 
-  m.def("load",
-        [](py::array_t<uint64_t> ptrs, py::array_t<bool> masks, py::array other,
-           py::dtype ret_dtype) -> py::array {
-          int numel = ptrs.size();
-          auto shape =
-              std::vector<ptrdiff_t>(ptrs.shape(), ptrs.shape() + ptrs.ndim());
-          py::array ret(ret_dtype, py::array::ShapeContainer{numel});
-          py::array_t<uint64_t> reshaped_ptrs = ptrs.reshape({numel});
-          py::array_t<bool> reshaped_masks = masks.reshape({numel});
-          py::array reshaped_others = other.reshape({numel});
-          for (size_t i = 0; i < ptrs.size(); ++i) {
-            if (reshaped_masks.at(i))
-              memcpy(ret.mutable_data(i),
-                     reinterpret_cast<void *>(reshaped_ptrs.at(i)),
-                     ret_dtype.itemsize());
-            else
-              memcpy(ret.mutable_data(i), reshaped_others.data(i),
-                     ret_dtype.itemsize());
-          }
-          return ret.reshape(shape);
-        });
-
-  m.def("store", [](py::array_t<uint64_t> ptrs, py::array values,
-                    py::array_t<bool> mask) {
-    int numel = ptrs.size();
-    py::array_t<uint64_t> reshaped_ptrs = ptrs.reshape({numel});
-    py::array_t<int8_t> reshaped_masks = mask.reshape({numel});
-    py::array reshaped_values = values.reshape({numel});
-    for (size_t i = 0; i < ptrs.size(); ++i) {
-      if (reshaped_masks.at(i)) {
-        memcpy(reinterpret_cast<void *>(reshaped_ptrs.mutable_at(i)),
-               reshaped_values.data(i), values.dtype().itemsize());
+  m.def("load", [](PtrArray ptrs, MaskArray masks, py::array other,
+                   py::dtype ret_dtype) -> py::array {
+    size_t numel = ptrs.size();
+    auto shape =
+        std::vector<ptrdiff_t>(ptrs.shape(), ptrs.shape() + ptrs.ndim());
+    py::array ret(ret_dtype, py::array::ShapeContainer{numel});
+    py::array others = py::array::ensure(other, py::array::c_style);
+    size_t itemSize = ret_dtype.itemsize();
+    const uint64_t *ptrData = ptrs.data();
+    const bool *maskData = masks.data();
+    const char *otherData = static_cast<const char *>(others.data());
+    char *retData = static_cast<char *>(ret.mutable_data());
+    {
+      // Only raw memory is accessed, the other programs of the grid may run
+      // meanwhile.
+      py::gil_scoped_release release;
+      if (numel > 0 && isContiguous(ptrData, maskData, numel, itemSize)) {
+        memcpy(retData, reinterpret_cast<void *>(ptrData[0]),
+               numel * itemSize);
+      } else {
+        for (size_t i = 0; i < numel; ++i) {
+          const void *src = maskData[i]
+                                ? reinterpret_cast<void *>(ptrData[i])
+                                : otherData + i * itemSize;
+          memcpy(retData + i * itemSize, src, itemSize);
+        }
       }
     }
+    return ret.reshape(shape);
+  });
+
+  m.def("store", [](PtrArray ptrs, py::array values, MaskArray mask) {
+    size_t numel = ptrs.size();
+    py::array contiguousValues = py::array::ensure(values, py::array::c_style);
+    size_t itemSize = values.dtype().itemsize();
+    const uint64_t *ptrData = ptrs.data();
+    const bool *maskData = mask.data();
+    const char *valueData = static_cast<const char *>(contiguousValues.data());
+    py::gil_scoped_release release;
+    if (numel > 0 && isContiguous(ptrData, maskData, numel, itemSize)) {
+      memcpy(reinterpret_cast<void *>(ptrData[0]), valueData,
+             numel * itemSize);
+      return;
+    }
+    for (size_t i = 0; i < numel; ++i)
+      if (maskData[i])
+        memcpy(reinterpret_cast<void *>(ptrData[i]), valueData + i * itemSize,
+               itemSize);
   });
 }
@@ -7,10 +7,12 @@
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/Parser/Parser.h"
 #include "mlir/Pass/Pass.h"
+#include "mlir/Pass/PassInstrumentation.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Support/FileUtilities.h"
 #include "mlir/Target/LLVMIR/Dialect/Builtin/BuiltinToLLVMIRTranslation.h"
@@ -19,10 +21,16 @@
 #include "triton/Analysis/Allocation.h"
 #include "triton/Dialect/Triton/IR/Dialect.h"
 #include "triton/Dialect/Triton/IR/Types.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "triton/Tools/Sys/GetEnv.hpp"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/raw_ostream.h"
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <chrono>
+#include <mutex>
+
 namespace py = pybind11;
 
 // A custom op builder that keeps track of the last location
@@ -109,6 +117,125 @@ private:
   bool lineInfoEnabled = !triton::tools::getBoolEnv("TRITON_DISABLE_LINE_INFO");
 };
 
+// The time spent in each pass of a pass manager, in pipeline order.
+struct PassTimings {
+  std::vector<std::pair<std::string, double>> entries;
+  llvm::DenseMap<mlir::Pass *, size_t> indices;
+  std::mutex mutex;
+};
+
+// Accumulates the wall time of the passes into `PassTimings`, which, unlike
+// the reports of MLIR's timing manager, can be read back from Python.
+class PassTimingInstrumentation : public mlir::PassInstrumentation {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  PassTimingInstrumentation(std::shared_ptr<PassTimings> timings)
+      : timings(std::move(timings)) {}
+
+  void runBeforePass(mlir::Pass *pass, mlir::Operation *op) override {
+    std::lock_guard<std::mutex> lock(timings->mutex);
+    starts[{pass, op}] = Clock::now();
+  }
+
+  void runAfterPass(mlir::Pass *pass, mlir::Operation *op) override {
+    record(pass, op);
+  }
+
+  void runAfterPassFailed(mlir::Pass *pass, mlir::Operation *op) override {
+    record(pass, op);
+  }
+
+private:
+  void record(mlir::Pass *pass, mlir::Operation *op) {
+    Clock::time_point end = Clock::now();
+    std::lock_guard<std::mutex> lock(timings->mutex);
+    Clock::time_point start = starts.lookup({pass, op});
+    starts.erase({pass, op});
+    // The adaptors running nested pipelines have no argument, the time spent
+    // in them is accounted to the nested passes.
+    if (pass->getArgument().empty())
+      return;
+    auto [it, inserted] =
+        timings->indices.try_emplace(pass, timings->entries.size());
+    if (inserted)
+      timings->entries.emplace_back(pass->getArgument().str(), 0.0);
+    timings->entries[it->second].second +=
+        std::chrono::duration<double>(end - start).count();
+  }
+
+  std::shared_ptr<PassTimings> timings;
+  llvm::DenseMap<std::pair<mlir::Pass *, mlir::Operation *>, Clock::time_point>
+      starts;
+};
+
+struct PassRemarks {
+  // The pass, the location and the message of each remark, in their order.
+  std::vector<std::tuple<std::string, std::string, std::string>> entries;
+  std::mutex mutex;
+};
+
+// Collects the remarks emitted by the passes into `PassRemarks`, along with
+// the pass emitting them, rather than letting the handlers of the context
+// print them. They are printed as well with MLIR_ENABLE_REMARK.
+class PassRemarkInstrumentation : public mlir::PassInstrumentation {
+public:
+  PassRemarkInstrumentation(mlir::MLIRContext *context,
+                            std::shared_ptr<PassRemarks> remarks)
+      : context(context), remarks(std::move(remarks)) {}
+
+  void runBeforePipeline(std::optional<mlir::OperationName> name,
+                         const PipelineParentInfo &parentInfo) override {
+    // The handler is registered for the outermost pipeline only, the nested
+    // pipelines running on several threads.
+    std::lock_guard<std::mutex> lock(pipelineMutex);
+    if (depth++ != 0)
+      return;
+    handlerID = context->getDiagEngine().registerHandler(
+        [this](mlir::Diagnostic &diag) { return record(diag); });
+  }
+
+  void runAfterPipeline(std::optional<mlir::OperationName> name,
+                        const PipelineParentInfo &parentInfo) override {
+    std::lock_guard<std::mutex> lock(pipelineMutex);
+    if (--depth == 0)
+      context->getDiagEngine().eraseHandler(handlerID);
+  }
+
+  void runBeforePass(mlir::Pass *pass, mlir::Operation *op) override {
+    // The adaptors running nested pipelines have no argument.
+    if (pass->getArgument().empty())
+      return;
+    std::lock_guard<std::mutex> lock(remarks->mutex);
+    currentPass = pass->getArgument().str();
+  }
+
+private:
+  mlir::LogicalResult record(mlir::Diagnostic &diag) {
+    if (diag.getSeverity() != mlir::DiagnosticSeverity::Remark)
+      return mlir::failure();
+    std::string loc;
+    if (auto fileLoc = diag.getLocation()->findInstanceOf<mlir::FileLineColLoc>())
+      loc = (fileLoc.getFilename().getValue() + ":" +
+             llvm::Twine(fileLoc.getLine()) + ":" +
+             llvm::Twine(fileLoc.getColumn()))
+                .str();
+    std::lock_guard<std::mutex> lock(remarks->mutex);
+    remarks->entries.emplace_back(currentPass, loc, diag.str());
+    if (::triton::tools::getBoolEnv("MLIR_ENABLE_REMARK"))
+      llvm::errs() << loc << ": remark: [" << currentPass << "] " << diag.str()
+                   << "\n";
+    return mlir::success();
+  }
+
+  mlir::MLIRContext *context;
+  std::shared_ptr<PassRemarks> remarks;
+  std::mutex pipelineMutex;
+  mlir::DiagnosticEngine::HandlerID handlerID = 0;
+  unsigned depth = 0;
+  std::string currentPass;
+};
+
 static std::string locationToString(mlir::Location loc) {
   std::string str;
   llvm::raw_string_ostream os(str);
@@ -124,6 +251,32 @@ static void outputWarning(mlir::Location loc, const std::string &msg) {
                /*stack_level=*/2);
 }
 
+// The threads the passes of all the contexts run on, never destroyed so that
+// they outlive the contexts of the Python objects freed at exit.
+static llvm::ThreadPool &getSharedThreadPool() {
+  static auto *threadPool = new llvm::ThreadPool();
+  return *threadPool;
+}
+
+// Prints the diagnostics of the context for as long as the pass manager it is
+// added to lives, rather than for as long as the context, which may be reused
+// by other compilations.
+class DiagnosticPrinterInstrumentation : public mlir::PassInstrumentation {
+public:
+  DiagnosticPrinterInstrumentation(mlir::MLIRContext *context)
+      : handler(context, [](mlir::Diagnostic &diag) {
+          // The remarks are only printed on request.
+          if (diag.getSeverity() == mlir::DiagnosticSeverity::Remark &&
+              !::triton::tools::getBoolEnv("MLIR_ENABLE_REMARK"))
+            return mlir::success();
+          llvm::outs() << diag << "\n";
+          return mlir::success();
+        }) {}
+
+private:
+  mlir::ScopedDiagnosticHandler handler;
+};
+
 /*****************************************************************************/
 /* Python bindings for triton::ir                                            */
 /*****************************************************************************/
@@ -189,7 +342,15 @@ void init_triton_ir(py::module &&m) {
       .value("ALL", mlir::triton::PropagateNan::ALL);
 
   py::class_<mlir::MLIRContext>(m, "context", py::module_local())
-      .def(py::init<>());
+      .def(py::init([]() {
+        // The contexts of all the compilations share the threads of the
+        // process, rather than each starting as many threads as there are
+        // cores.
+        auto context = std::make_unique<mlir::MLIRContext>(
+            mlir::MLIRContext::Threading::DISABLED);
+        context->setThreadPool(getSharedThreadPool());
+        return context;
+      }));
 
   m.def("load_dialects", [](mlir::MLIRContext &context) {
     mlir::DialectRegistry registry;
@@ -398,6 +559,20 @@ void init_triton_ir(py::module &&m) {
              self.print(os, printingFlags);
              return str;
            })
+      // Prints the module straight to the file at `path`, without the string
+      // of `str`, e.g. for the cache.
+      .def("write",
+           [](mlir::ModuleOp &self, const std::string &path) {
+             std::error_code ec;
+             llvm::raw_fd_ostream os(path, ec);
+             if (ec)
+               throw std::runtime_error("cannot open " + path + ": " +
+                                        ec.message());
+             auto printingFlags = mlir::OpPrintingFlags();
+             printingFlags.enableDebugInfo();
+             py::gil_scoped_release allow_threads;
+             self.print(os, printingFlags);
+           })
       .def("push_back",
            [](mlir::ModuleOp &self, mlir::triton::FuncOp &funcOp) -> void {
              self.push_back(funcOp);
@@ -419,7 +594,30 @@ void init_triton_ir(py::module &&m) {
              if (!ret)
                return py::none();
              return py::int_(ret.getInt());
-           });
+           })
+      .def("get_str_array_attr",
+           [](mlir::ModuleOp &self, std::string name) -> py::object {
+             auto ret = self->getAttrOfType<mlir::ArrayAttr>(name);
+             if (!ret)
+               return py::none();
+             py::list strs;
+             for (auto str : ret.getAsValueRange<mlir::StringAttr>())
+               strs.append(py::str(str.str()));
+             return strs;
+           })
+      .def("get_int_array_attr",
+           [](mlir::ModuleOp &self, std::string name) -> py::object {
+             auto ret = self->getAttrOfType<mlir::ArrayAttr>(name);
+             if (!ret)
+               return py::none();
+             py::list ints;
+             for (auto value : ret.getAsRange<mlir::IntegerAttr>())
+               ints.append(py::int_(value.getInt()));
+             return ints;
+           })
+      // Frees the module, e.g. before its context is reused by another
+      // compilation. The module must not be used afterwards.
+      .def("erase", [](mlir::ModuleOp &self) { self->erase(); });
 
   m.def("make_attr",
         [](const std::vector<int> &values, mlir::MLIRContext &context) {
@@ -1240,6 +1438,17 @@ void init_triton_ir(py::module &&m) {
              self.create<mlir::triton::StoreOp>(ptr, val, boundaryCheck,
                                                 cacheModifier, evictionPolicy);
            })
+      .def("create_load_pages",
+           [](TritonOpBuilder &self, mlir::Value &ptr, mlir::Value &pages,
+              int pageSize, mlir::triton::CacheModifier cacheModifier,
+              mlir::triton::EvictionPolicy evictionPolicy) -> mlir::Value {
+             auto tensorTy = ptr.getType()
+                                 .cast<mlir::triton::PointerType>()
+                                 .getPointeeType();
+             return self.create<mlir::triton::LoadPagesOp>(
+                 tensorTy, ptr, pages, pageSize, cacheModifier,
+                 evictionPolicy);
+           })
       .def("create_masked_load",
            [](TritonOpBuilder &self, mlir::Value &ptrs, mlir::Value &mask,
               std::optional<mlir::Value> &other,
@@ -1521,9 +1730,78 @@ void init_triton_ir(py::module &&m) {
                      mlir::IntegerType::get(operand.getContext(), 32)),
                  operand);
            })
+      .def("create_sort",
+           [](TritonOpBuilder &self, mlir::Value operand, int axis,
+              bool descending) -> mlir::Value {
+             return self.create<mlir::triton::SortOp>(operand.getType(),
+                                                      operand, axis, descending);
+           })
+      .def("create_topk",
+           [](TritonOpBuilder &self, mlir::Value operand, int axis,
+              int k) -> mlir::Value {
+             auto type = operand.getType().cast<mlir::RankedTensorType>();
+             llvm::SmallVector<int64_t> shape(type.getShape());
+             shape[axis] = k;
+             return self.create<mlir::triton::TopKOp>(
+                 mlir::RankedTensorType::get(shape, type.getElementType()),
+                 operand, axis, k);
+           })
+      // A buffer of the shared local memory is allocated with the unswizzled
+      // shared encoding, its elements in row-major order.
+      .def("create_local_buffer",
+           [](TritonOpBuilder &self, std::vector<int64_t> &shape,
+              mlir::Type &elementType) -> mlir::Value {
+             mlir::MLIRContext *context = self.getBuilder().getContext();
+             unsigned rank = shape.size();
+             llvm::SmallVector<unsigned> order;
+             for (unsigned dim = rank; dim-- > 0;)
+               order.push_back(dim);
+             llvm::SmallVector<unsigned> ones(rank, 1);
+             auto ctaLayout = mlir::triton::gpu::CTALayoutAttr::get(
+                 context, ones, ones, order);
+             auto encoding = mlir::triton::gpu::SharedEncodingAttr::get(
+                 context, /*vec=*/1, /*perPhase=*/1, /*maxPhase=*/1, order,
+                 ctaLayout);
+             return self.create<mlir::triton::gpu::AllocTensorOp>(
+                 mlir::RankedTensorType::get(shape, elementType, encoding));
+           })
+      .def("create_local_load",
+           [](TritonOpBuilder &self, mlir::Value &buffer,
+              std::optional<mlir::Value> &offsets) -> mlir::Value {
+             auto bufferTy = buffer.getType().cast<mlir::RankedTensorType>();
+             mlir::Value shaped = offsets ? *offsets : buffer;
+             auto resultTy = mlir::RankedTensorType::get(
+                 shaped.getType().cast<mlir::RankedTensorType>().getShape(),
+                 bufferTy.getElementType());
+             return self.create<mlir::triton::LocalLoadOp>(
+                 resultTy, buffer, offsets.value_or(mlir::Value()));
+           })
+      .def("create_local_store",
+           [](TritonOpBuilder &self, mlir::Value &buffer, mlir::Value &value,
+              std::optional<mlir::Value> &offsets) -> void {
+             self.create<mlir::triton::LocalStoreOp>(
+                 buffer, value, offsets.value_or(mlir::Value()));
+           })
+      .def("create_philox",
+           [](TritonOpBuilder &self, mlir::Value &seed, mlir::Value &offset,
+              int nRounds) -> mlir::Value {
+             return self.create<mlir::triton::PhiloxOp>(
+                 offset.getType(), seed, offset,
+                 self.getBuilder().getI32IntegerAttr(nRounds));
+           })
+      .def("create_unpack_int4",
+           [](TritonOpBuilder &self, mlir::Value &src, mlir::Type &dstType,
+              bool isSigned) -> mlir::Value {
+             return self.create<mlir::triton::UnpackInt4Op>(
+                 dstType, src, self.getBuilder().getBoolAttr(isSigned));
+           })
       // Force GPU barrier
       .def("create_barrier",
            [](TritonOpBuilder &self) { self.create<mlir::gpu::BarrierOp>(); })
+      .def("create_grid_barrier",
+           [](TritonOpBuilder &self) {
+             self.create<mlir::triton::GridBarrierOp>();
+           })
       // Make a block pointer (tensor pointer in Triton IR)
       .def("create_make_block_ptr",
            [](TritonOpBuilder &self, mlir::Value &base,
@@ -1543,19 +1821,49 @@ void init_triton_ir(py::module &&m) {
                                                          offsets);
            });
 
+  py::class_<PassTimings, std::shared_ptr<PassTimings>>(m, "pass_timings",
+                                                        py::module_local())
+      .def("get", [](PassTimings &self) {
+        std::lock_guard<std::mutex> lock(self.mutex);
+        return self.entries;
+      });
+
+  py::class_<PassRemarks, std::shared_ptr<PassRemarks>>(m, "pass_remarks",
+                                                        py::module_local())
+      .def("get", [](PassRemarks &self) {
+        std::lock_guard<std::mutex> lock(self.mutex);
+        return self.entries;
+      });
+
   py::class_<mlir::PassManager>(m, "pass_manager", py::module_local())
       .def(py::init<mlir::MLIRContext *>())
+      .def("enable_timing",
+           [](mlir::PassManager &self) {
+             auto timings = std::make_shared<PassTimings>();
+             self.addInstrumentation(
+                 std::make_unique<PassTimingInstrumentation>(timings));
+             return timings;
+           })
+      .def("enable_remarks",
+           [](mlir::PassManager &self) {
+             auto remarks = std::make_shared<PassRemarks>();
+             self.addInstrumentation(
+                 std::make_unique<PassRemarkInstrumentation>(
+                     self.getContext(), remarks));
+             return remarks;
+           })
       .def("enable_debug",
            [](mlir::PassManager &self) {
              auto *context = self.getContext();
              context->printOpOnDiagnostic(true);
              context->printStackTraceOnDiagnostic(true);
-             context->disableMultithreading();
-             context->getDiagEngine().registerHandler(
-                 [](mlir::Diagnostic &diag) {
-                   llvm::outs() << diag << "\n";
-                   return mlir::success();
-                 });
+             // The IR is printed at module scope, which needs the passes to
+             // run on one function at a time.
+             if (::triton::tools::getBoolEnv("MLIR_ENABLE_DUMP") ||
+                 ::triton::tools::getBoolEnv("MLIR_DISABLE_MULTITHREADING"))
+               context->disableMultithreading();
+             self.addInstrumentation(
+                 std::make_unique<DiagnosticPrinterInstrumentation>(context));
 
              if (!::triton::tools::getBoolEnv("MLIR_ENABLE_DUMP"))
                return;
@@ -1583,7 +1891,13 @@ void init_triton_ir(py::module &&m) {
           mlir::makeReproducer(anchorName, passes, op, reproducerPath);
         }
 
-        if (mlir::failed(self.run(mod.getOperation())))
+        mlir::LogicalResult result = mlir::success();
+        {
+          // Let other threads, e.g. compiling other kernels, run meanwhile.
+          py::gil_scoped_release allow_threads;
+          result = self.run(mod.getOperation());
+        }
+        if (mlir::failed(result))
           throw std::runtime_error("PassManager::run failed");
       });
 }
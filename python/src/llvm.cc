@@ -4,6 +4,9 @@
 #include "triton/Target/SPIRV/SPIRVTranslation.h"
 #include "triton/Tools/Sys/GetEnv.hpp"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/IR/DebugInfo.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
@@ -16,10 +19,14 @@
 #include "llvm/Passes/OptimizationLevel.h"
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Support/CodeGen.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Transforms/IPO/AlwaysInliner.h"
+#include "llvm/Transforms/IPO/Internalize.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
+#include <map>
+#include <mutex>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -30,10 +37,71 @@ struct BreakStructPhiNodesPass : PassInfoMixin<BreakStructPhiNodesPass> {
   PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
   static StringRef name() { return "BreakStructPhiNodesPass"; }
 };
+struct SplitWideFMulAddPass : PassInfoMixin<SplitWideFMulAddPass> {
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
+  static StringRef name() { return "SplitWideFMulAddPass"; }
+};
+struct OutlineColdRegionsPass : PassInfoMixin<OutlineColdRegionsPass> {
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+  static StringRef name() { return "OutlineColdRegionsPass"; }
+};
 } // namespace llvm
 
 using namespace llvm;
 
+// Returns the content of the external library at `path`, which is read once
+// per process: the libraries are large and linked into every kernel.
+static std::optional<llvm::MemoryBufferRef>
+getExternLibBuffer(const std::string &path) {
+  static std::mutex mutex;
+  static llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> buffers;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = buffers.find(path);
+  if (it == buffers.end()) {
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    if (!buffer)
+      return std::nullopt;
+    it = buffers.try_emplace(path, std::move(*buffer)).first;
+  }
+  return it->second->getMemBufferRef();
+}
+
+// Sets the LLVM command-line options `options` (name to value) for the
+// lifetime of the object and resets them to their defaults afterwards. The
+// options are global, so the users are serialized.
+class ScopedLLVMOptions {
+public:
+  explicit ScopedLLVMOptions(const std::map<std::string, std::string> &options)
+      : lock(mutex, std::defer_lock) {
+    if (options.empty())
+      return;
+    lock.lock();
+    auto &registered = llvm::cl::getRegisteredOptions();
+    for (const auto &[name, value] : options) {
+      llvm::cl::Option *option = registered.lookup(name);
+      if (!option) {
+        llvm::errs() << "Unknown LLVM option " << name << "\n";
+        continue;
+      }
+      // Going through addOccurrence marks the option as explicitly set, which
+      // the passes check before overriding their target defaults.
+      if (option->addOccurrence(0, name, value))
+        continue;
+      changed.push_back(option);
+    }
+  }
+
+  ~ScopedLLVMOptions() {
+    for (llvm::cl::Option *option : changed)
+      option->reset();
+  }
+
+private:
+  static inline std::mutex mutex;
+  std::unique_lock<std::mutex> lock;
+  llvm::SmallVector<llvm::cl::Option *> changed;
+};
+
 std::string translateLLVMIRToASM(llvm::Module &module,
                                  const std::string &triple,
                                  const std::string &proc,
@@ -101,6 +169,20 @@ void findKernels(llvm::Module &M, std::set<llvm::Function *> &functions) {
       functions.insert(&function);
 }
 
+// Return the SPIR-V binary of the module and the name of its kernel.
+static std::tuple<py::object, std::string>
+translateToSPIRV(llvm::Module &module, bool verify,
+                 const std::vector<std::string> &extensions) {
+  // Get name of kernel in the module
+  std::set<llvm::Function *> kernels;
+  findKernels(module, kernels);
+  assert(kernels.size() == 1);
+  std::string name = (*kernels.begin())->getName().str();
+  std::string spirvBitcode =
+      triton::translateLLVMIRToSPIRV(module, verify, extensions);
+  return std::make_tuple(py::bytes(spirvBitcode), name);
+}
+
 void init_triton_llvm(py::module &&m) {
 
   py::class_<llvm::LLVMContext>(m, "context", py::module_local())
@@ -158,48 +240,72 @@ void init_triton_llvm(py::module &&m) {
       },
       py::keep_alive<0, 2>());
 
-  m.def("optimize_module", [](llvm::Module *mod,
-                              const llvm::OptimizationLevel &opt) {
-    if (triton::tools::getBoolEnv("DISABLE_LLVM_OPT"))
-      return;
-    using namespace llvm;
-    LoopAnalysisManager lam;
-    FunctionAnalysisManager fam;
-    CGSCCAnalysisManager cgam;
-    ModuleAnalysisManager mam;
-    PipelineTuningOptions tuningOptions;
-    tuningOptions.LoopUnrolling = true;
-    tuningOptions.LoopInterleaving = true;
-    tuningOptions.LoopVectorization = true;
-    // SLPVectorizer causes test_core.py::test_dot_mulbroadcastred to fail.
-    // It vectorizes @llvm.fmuladd.f32 with @llvm.fmuladd.v32f32. We can
-    // consider to reenable SLP vectorization when the failure is investigated.
-    tuningOptions.SLPVectorization = false;
+  m.def(
+      "optimize_module",
+      [](llvm::Module *mod, const llvm::OptimizationLevel &opt,
+         bool slpVectorize, bool outlineCold,
+         const std::map<std::string, std::string> &llvmOptions) {
+        py::gil_scoped_release allow_threads;
+        if (triton::tools::getBoolEnv("DISABLE_LLVM_OPT"))
+          return;
+        // Without a TargetMachine for SPIR-V the cost models use the generic
+        // TTI; the backends tune them with the LLVM options instead.
+        ScopedLLVMOptions scopedOptions(llvmOptions);
+        using namespace llvm;
+        LoopAnalysisManager lam;
+        FunctionAnalysisManager fam;
+        CGSCCAnalysisManager cgam;
+        ModuleAnalysisManager mam;
+        PipelineTuningOptions tuningOptions;
+        tuningOptions.LoopUnrolling = true;
+        tuningOptions.LoopInterleaving = true;
+        tuningOptions.LoopVectorization = true;
+        // SLPVectorizer caused test_core.py::test_dot_mulbroadcastred to fail
+        // on XPU: it vectorizes the @llvm.fmuladd.f32 chains of the
+        // broadcasted multiply-reduce into @llvm.fmuladd.v32f32, wider than
+        // the 16-component SPIR-V vectors. The backends opt in, and the wide
+        // calls are split back into legal widths below.
+        tuningOptions.SLPVectorization = slpVectorize;
 
-    PassBuilder pb(nullptr /*targetMachine*/, tuningOptions);
+        PassBuilder pb(nullptr /*targetMachine*/, tuningOptions);
 
-    pb.registerModuleAnalyses(mam);
-    pb.registerCGSCCAnalyses(cgam);
-    pb.registerFunctionAnalyses(fam);
-    pb.registerLoopAnalyses(lam);
-    pb.crossRegisterProxies(lam, fam, cgam, mam);
+        pb.registerModuleAnalyses(mam);
+        pb.registerCGSCCAnalyses(cgam);
+        pb.registerFunctionAnalyses(fam);
+        pb.registerLoopAnalyses(lam);
+        pb.crossRegisterProxies(lam, fam, cgam, mam);
 
-    ModulePassManager mpm;
-    pb.registerVectorizerStartEPCallback(
-        [&](llvm::FunctionPassManager &fpm, llvm::OptimizationLevel level) {
-          // Triton generates large structure of scalars which may pessimise
-          // optimizations, we run a pass to break up phi of struct to make sure
-          // all the struct are removed for the following passes.
-          fpm.addPass(BreakStructPhiNodesPass());
-          fpm.addPass(InstCombinePass());
-        });
-    mpm.addPass(pb.buildPerModuleDefaultPipeline(opt));
-    mpm.run(*mod, mam);
-  });
+        ModulePassManager mpm;
+        pb.registerVectorizerStartEPCallback(
+            [&](llvm::FunctionPassManager &fpm,
+                llvm::OptimizationLevel level) {
+              // Triton generates large structure of scalars which may
+              // pessimise optimizations, we run a pass to break up phi of
+              // struct to make sure all the struct are removed for the
+              // following passes.
+              fpm.addPass(BreakStructPhiNodesPass());
+              fpm.addPass(InstCombinePass());
+            });
+        mpm.addPass(pb.buildPerModuleDefaultPipeline(opt));
+        if (slpVectorize)
+          mpm.addPass(
+              createModuleToFunctionPassAdaptor(SplitWideFMulAddPass()));
+        // The cold regions are outlined once the hot code is unrolled and
+        // simplified, so that the outlined functions don't get in the way of
+        // the optimizations.
+        if (outlineCold)
+          mpm.addPass(OutlineColdRegionsPass());
+        mpm.run(*mod, mam);
+      },
+      py::arg("mod"), py::arg("opt"), py::arg("slp_vectorize") = false,
+      py::arg("outline_cold") = false,
+      py::arg("llvm_options") = std::map<std::string, std::string>());
 
   m.def(
       "translate_to_spirv",
-      [](const std::string llvmIR) -> std::tuple<py::object, std::string> {
+      [](const std::string llvmIR, bool verify,
+         const std::vector<std::string> &extensions, bool stripDebugInfo)
+          -> std::tuple<py::object, std::string> {
         py::gil_scoped_release allow_threads;
         // create LLVM module from C++
         llvm::LLVMContext context;
@@ -213,13 +319,43 @@ void init_triton_llvm(py::module &&m) {
               "failed to parse IR: " + error.getMessage() +
               "lineno: " + std::to_string(error.getLineNo()));
         }
-        // Get name of kernel in the module
-        std::set<llvm::Function *> kernels;
-        findKernels(*module, kernels);
-        assert(kernels.size() == 1);
-        std::string name = (*kernels.begin())->getName().str();
-        std::string spirvBitcode = triton::translateLLVMIRToSPIRV(*module);
-        return std::make_tuple(py::bytes(spirvBitcode), name);
+        if (stripDebugInfo)
+          llvm::StripDebugInfo(*module);
+        return translateToSPIRV(*module, verify, extensions);
+      },
+      py::arg("src"), py::arg("verify") = false,
+      py::arg("extensions") = std::vector<std::string>(),
+      py::arg("strip_debug_info") = false, ret::take_ownership);
+
+  // Translate a module produced in the same process without the print/parse
+  // round trip of its textual IR. The debug info stripped with
+  // `strip_debug_info` is removed from `module` itself.
+  m.def(
+      "translate_to_spirv",
+      [](llvm::Module *module, bool verify,
+         const std::vector<std::string> &extensions, bool stripDebugInfo)
+          -> std::tuple<py::object, std::string> {
+        py::gil_scoped_release allow_threads;
+        if (stripDebugInfo)
+          llvm::StripDebugInfo(*module);
+        return translateToSPIRV(*module, verify, extensions);
+      },
+      py::arg("src"), py::arg("verify") = false,
+      py::arg("extensions") = std::vector<std::string>(),
+      py::arg("strip_debug_info") = false, ret::take_ownership);
+
+  m.def(
+      "link_spirv",
+      [](const std::vector<std::string> &binaries,
+         const std::vector<std::string> &names) -> py::object {
+        std::string linked, error;
+        {
+          py::gil_scoped_release allow_threads;
+          linked = triton::linkSPIRVModules(binaries, names, error);
+        }
+        if (linked.empty())
+          throw std::runtime_error("SPIR-V linking failed: " + error);
+        return py::bytes(linked);
       },
       ret::take_ownership);
 
@@ -270,17 +406,43 @@ void init_triton_llvm(py::module &&m) {
   });
 
   m.def("link_extern_lib", [](llvm::Module *mod, std::string path) {
-    llvm::SMDiagnostic err;
     auto &ctx = mod->getContext();
-    auto extMod = llvm::parseIRFile(path, err, ctx);
+    std::optional<llvm::MemoryBufferRef> buffer = getExternLibBuffer(path);
+    if (!buffer) {
+      llvm::errs() << "Failed to load " << path;
+      return;
+    }
+    // Bitcode modules are materialized lazily: only the functions the kernel
+    // references are parsed by the linker.
+    std::unique_ptr<llvm::Module> extMod;
+    if (llvm::isBitcode(
+            reinterpret_cast<const unsigned char *>(buffer->getBufferStart()),
+            reinterpret_cast<const unsigned char *>(buffer->getBufferEnd()))) {
+      auto lazyMod = llvm::getLazyBitcodeModule(*buffer, ctx);
+      if (lazyMod)
+        extMod = std::move(*lazyMod);
+      else
+        llvm::consumeError(lazyMod.takeError());
+    } else {
+      llvm::SMDiagnostic err;
+      extMod = llvm::parseIR(*buffer, err, ctx);
+    }
     if (!extMod) {
       llvm::errs() << "Failed to load " << path;
       return;
     }
     extMod->setTargetTriple(mod->getTargetTriple());
     extMod->setDataLayout(mod->getDataLayout());
+    // Internalize the imported functions so that the optimizer can inline
+    // them and drop their bodies.
+    auto internalize = [](llvm::Module &M, const llvm::StringSet<> &GVS) {
+      llvm::internalizeModule(M, [&GVS](const llvm::GlobalValue &GV) {
+        return !GV.hasName() || !GVS.count(GV.getName());
+      });
+    };
     if (llvm::Linker::linkModules(*mod, std::move(extMod),
-                                  llvm::Linker::Flags::LinkOnlyNeeded)) {
+                                  llvm::Linker::Flags::LinkOnlyNeeded,
+                                  internalize)) {
       llvm::errs() << "Failed to link " << path;
       return;
     }
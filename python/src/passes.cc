@@ -27,15 +27,16 @@ void init_triton_passes_common(py::module &&m) {
   ADD_PASS_WRAPPER_0("add_sccp", createSCCPPass);
   ADD_PASS_WRAPPER_0("add_symbol_dce", createSymbolDCEPass);
   ADD_PASS_WRAPPER_0("add_inliner", createInlinerPass);
-  ADD_PASS_WRAPPER_0("add_canonicalizer", createCanonicalizerPass);
-  ADD_PASS_WRAPPER_0("add_cse", createCSEPass);
-  ADD_PASS_WRAPPER_0("add_licm", createLoopInvariantCodeMotionPass);
+  ADD_FUNC_PASS_WRAPPER_0("add_canonicalizer", createCanonicalizerPass);
+  ADD_FUNC_PASS_WRAPPER_0("add_cse", createCSEPass);
+  ADD_FUNC_PASS_WRAPPER_0("add_licm", createLoopInvariantCodeMotionPass);
 }
 
 void init_triton_passes_ttir(py::module &&m) {
   using namespace mlir::triton;
   ADD_PASS_WRAPPER_0("add_combine", createCombineOpsPass);
   ADD_PASS_WRAPPER_0("add_reorder_broadcast", createReorderBroadcastPass);
+  ADD_PASS_WRAPPER_0("add_fold_masks", createFoldMasksPass);
   ADD_PASS_WRAPPER_0("add_rewrite_tensor_pointer",
                      createRewriteTensorPointerPass);
   ADD_PASS_WRAPPER_4("add_convert_to_ttgpuir",
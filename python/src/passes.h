@@ -18,3 +18,8 @@
 #define ADD_PASS_WRAPPER_4(name, builder, ty0, ty1, ty2, ty3)                  \
   m.def(name, [](mlir::PassManager &pm, ty0 val0, ty1 val1, ty2 val2,          \
                  ty3 val3) { pm.addPass(builder(val0, val1, val2, val3)); })
+
+// The pass runs on each function of the module, the functions in parallel
+// unless the multithreading of the context is disabled.
+#define ADD_FUNC_PASS_WRAPPER_0(name, builder)                                 \
+  m.def(name, [](mlir::PassManager &pm) { pm.nestAny().addPass(builder()); })
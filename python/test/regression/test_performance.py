@@ -1,12 +1,28 @@
 import pytest
 import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
 
 import triton
 import triton.language as tl
 import triton.ops
-from triton.testing import get_dram_gbps, get_max_tensorcore_tflops, nvsmi
+from triton.testing import (get_dram_gbps, get_max_tensorcore_tflops, get_max_xmx_tflops, get_xpu_clocks,
+                            get_xpu_dram_gbps, nvsmi)
 
-DEVICE_NAME = {7: 'v100', 8: 'a100'}[torch.cuda.get_device_capability()[0]]
+IS_XPU = torch.xpu.is_available()
+DEVICE = 'xpu' if IS_XPU else 'cuda'
+
+
+def get_device_name():
+    if not IS_XPU:
+        return {7: 'v100', 8: 'a100'}[torch.cuda.get_device_capability()[0]]
+    name = torch.xpu.get_device_name()
+    for marketing_name, device_name in [('Max 1550', 'max1550'), ('Max 1100', 'max1100'), ('A770', 'a770')]:
+        if marketing_name in name:
+            return device_name
+    return None
+
+
+DEVICE_NAME = get_device_name()
 
 #######################
 # Utilities
@@ -18,6 +34,34 @@ def print_perf(cur_ms, cur_util, ref_util):
     print(f'{cur_ms:.3f} ms \t cur: {cur_util:.3f} \t ref: {ref_util:.3f} \t dif={cur_util - ref_util:.3f}', end='\t')
 
 
+def set_stream():
+    # CUDA graphs can't be captured on the default stream.
+    if not IS_XPU:
+        torch.cuda.set_stream(torch.cuda.Stream())
+
+
+def do_bench(fn):
+    if IS_XPU:
+        return triton.testing.do_bench(fn, device='xpu')
+    return triton.testing.do_bench_cudagraph(fn)
+
+
+def get_max_tflops(dtype):
+    # the current clock rates are given in MHz
+    if IS_XPU:
+        cur_gpu_clock = get_xpu_clocks()[0]
+        return get_max_xmx_tflops(dtype, clock_rate=cur_gpu_clock * 1e3)
+    cur_sm_clock = nvsmi(['clocks.current.sm'])[0]
+    return get_max_tensorcore_tflops(dtype, clock_rate=cur_sm_clock * 1e3)
+
+
+def get_max_gbps():
+    if IS_XPU:
+        cur_mem_clock = get_xpu_clocks()[1]
+        return get_xpu_dram_gbps(mem_clock_rate=cur_mem_clock)
+    return get_dram_gbps()
+
+
 #######################
 # Matrix Multiplication
 #######################
@@ -44,40 +88,127 @@ matmul_data = {
         (8192, 64, 8192): {'float16': 0.272, 'float32': 0.000, 'int8': 0.177},
         # test EVEN_K==False
         (8192, 8192, 8176): {'float16': 0.828, 'float32': 0.743, 'int8': 0.51},
-    }
+    },
+    'max1550': {
+        # square
+        (512, 512, 512): {'float16': 0.038, 'float32': 0.046, 'int8': 0.019},
+        (1024, 1024, 1024): {'float16': 0.141, 'float32': 0.152, 'int8': 0.070},
+        (2048, 2048, 2048): {'float16': 0.372, 'float32': 0.351, 'int8': 0.184},
+        (8192, 8192, 8192): {'float16': 0.571, 'float32': 0.522, 'int8': 0.305},
+        # tall-skinny
+        (16, 1024, 1024): {'float16': 0.004, 'float32': 0.005, 'int8': 0.002},
+        (16, 4096, 4096): {'float16': 0.026, 'float32': 0.024, 'int8': 0.013},
+        (64, 1024, 1024): {'float16': 0.012, 'float32': 0.014, 'int8': 0.006},
+        (64, 4096, 4096): {'float16': 0.078, 'float32': 0.071, 'int8': 0.039},
+        (1024, 64, 1024): {'float16': 0.011, 'float32': 0.013, 'int8': 0.006},
+        (4096, 64, 4096): {'float16': 0.074, 'float32': 0.068, 'int8': 0.037},
+        # test EVEN_K==False
+        (8192, 8192, 8176): {'float16': 0.563, 'float32': 0.515, 'int8': 0.301},
+    },
+    'max1100': {
+        # square
+        (512, 512, 512): {'float16': 0.061, 'float32': 0.072, 'int8': 0.030},
+        (1024, 1024, 1024): {'float16': 0.213, 'float32': 0.226, 'int8': 0.106},
+        (2048, 2048, 2048): {'float16': 0.448, 'float32': 0.417, 'int8': 0.221},
+        (8192, 8192, 8192): {'float16': 0.602, 'float32': 0.549, 'int8': 0.322},
+        # tall-skinny
+        (16, 1024, 1024): {'float16': 0.007, 'float32': 0.008, 'int8': 0.003},
+        (16, 4096, 4096): {'float16': 0.045, 'float32': 0.041, 'int8': 0.022},
+        (64, 1024, 1024): {'float16': 0.021, 'float32': 0.024, 'int8': 0.010},
+        (64, 4096, 4096): {'float16': 0.129, 'float32': 0.117, 'int8': 0.064},
+        (1024, 64, 1024): {'float16': 0.019, 'float32': 0.022, 'int8': 0.009},
+        (4096, 64, 4096): {'float16': 0.121, 'float32': 0.110, 'int8': 0.060},
+        # test EVEN_K==False
+        (8192, 8192, 8176): {'float16': 0.594, 'float32': 0.541, 'int8': 0.318},
+    },
+    'a770': {
+        # square
+        (512, 512, 512): {'float16': 0.087, 'float32': 0.251, 'int8': 0.044},
+        (1024, 1024, 1024): {'float16': 0.274, 'float32': 0.493, 'int8': 0.137},
+        (2048, 2048, 2048): {'float16': 0.463, 'float32': 0.612, 'int8': 0.231},
+        (8192, 8192, 8192): {'float16': 0.539, 'float32': 0.647, 'int8': 0.270},
+        # tall-skinny
+        (16, 1024, 1024): {'float16': 0.012, 'float32': 0.034, 'int8': 0.006},
+        (16, 4096, 4096): {'float16': 0.071, 'float32': 0.188, 'int8': 0.035},
+        (64, 1024, 1024): {'float16': 0.036, 'float32': 0.097, 'int8': 0.018},
+        (64, 4096, 4096): {'float16': 0.183, 'float32': 0.402, 'int8': 0.091},
+        (1024, 64, 1024): {'float16': 0.033, 'float32': 0.092, 'int8': 0.016},
+        (4096, 64, 4096): {'float16': 0.172, 'float32': 0.386, 'int8': 0.086},
+        # test EVEN_K==False
+        (8192, 8192, 8176): {'float16': 0.531, 'float32': 0.640, 'int8': 0.266},
+    },
 }
 
 
 @pytest.mark.parametrize('M, N, K, dtype_str', [(M, N, K, dtype_str)
-                                                for M, N, K in matmul_data[DEVICE_NAME].keys()
+                                                for M, N, K in matmul_data.get(DEVICE_NAME, {}).keys()
                                                 for dtype_str in ['float16']])
 def test_matmul(M, N, K, dtype_str):
-    stream = torch.cuda.Stream()
-    torch.cuda.set_stream(stream)
-    if dtype_str in ['float32', 'int8'] and DEVICE_NAME != 'a100':
-        pytest.skip('Only test float32 & int8 on a100')
+    set_stream()
+    if dtype_str in ['float32', 'int8'] and DEVICE_NAME not in ['a100', 'max1550', 'max1100']:
+        pytest.skip('Only test float32 & int8 on a100 and PVC')
     if (M, N, K) in [(64, 4096, 4096), (64, 8192, 8192), (8192, 64, 8192)] and dtype_str == 'float32':
         pytest.skip('Out of shared memory in float32')
     dtype = {'float16': torch.float16, 'float32': torch.float32, 'int8': torch.int8}[dtype_str]
     torch.manual_seed(0)
     ref_gpu_util = matmul_data[DEVICE_NAME][(M, N, K)][dtype_str]
-    cur_sm_clock = nvsmi(['clocks.current.sm'])[0]
-    max_gpu_perf = get_max_tensorcore_tflops(dtype, clock_rate=cur_sm_clock * 1e3)
+    max_gpu_perf = get_max_tflops(dtype)
     if dtype == torch.int8:
-        a = torch.randint(-128, 127, (M, K), dtype=dtype, device='cuda')
-        b = torch.randint(-128, 127, (N, K), dtype=dtype, device='cuda')
+        a = torch.randint(-128, 127, (M, K), dtype=dtype, device=DEVICE)
+        b = torch.randint(-128, 127, (N, K), dtype=dtype, device=DEVICE)
         b = b.t()  # only test row-col layout
     else:
-        a = torch.randn((M, K), dtype=dtype, device='cuda')
-        b = torch.randn((K, N), dtype=dtype, device='cuda')
+        a = torch.randn((M, K), dtype=dtype, device=DEVICE)
+        b = torch.randn((K, N), dtype=dtype, device=DEVICE)
     fn = lambda: triton.ops.matmul(a, b)
-    ms = triton.testing.do_bench_cudagraph(fn)
+    ms = do_bench(fn)
     cur_gpu_perf = 2. * M * N * K / ms * 1e-9
     cur_gpu_util = cur_gpu_perf / max_gpu_perf
     print_perf(ms, cur_gpu_util, ref_gpu_util)
     triton.testing.assert_close(cur_gpu_util, ref_gpu_util, atol=0.02, rtol=0.01)
 
 
+#######################
+# Convolution
+#######################
+
+# the layers of ResNet-50, N, C, H, W, K, R, S, stride, padding
+conv_data = [
+    (32, 64, 56, 56, 64, 1, 1, 1, 0),
+    (32, 64, 56, 56, 64, 3, 3, 1, 1),
+    (32, 128, 28, 28, 128, 3, 3, 1, 1),
+    (32, 256, 14, 14, 256, 3, 3, 1, 1),
+    (32, 512, 7, 7, 512, 3, 3, 1, 1),
+    (32, 1024, 14, 14, 256, 1, 1, 1, 0),
+    (32, 128, 56, 56, 128, 3, 3, 2, 1),
+]
+
+
+@pytest.mark.parametrize('N, C, H, W, K, R, S, stride, padding', conv_data)
+def test_conv(N, C, H, W, K, R, S, stride, padding):
+    # The implicit GEMM of the convolution runs close to the roofline of the
+    # dense GEMM of the same shape, whose im2col matrix is materialized.
+    if not IS_XPU:
+        pytest.skip('Only test the convolutions on XPU')
+    set_stream()
+    torch.manual_seed(0)
+    dtype = torch.float16
+    max_gpu_perf = get_max_tflops(dtype)
+    x = torch.randn((N, C, H, W), dtype=dtype, device=DEVICE).to(memory_format=torch.channels_last)
+    w = torch.randn((K, C, R, S), dtype=dtype, device=DEVICE).to(memory_format=torch.channels_last)
+    P = (H + 2 * padding - R) // stride + 1
+    Q = (W + 2 * padding - S) // stride + 1
+    flops = 2. * N * P * Q * K * C * R * S
+    ms = do_bench(lambda: triton.ops.conv(x, w, None, stride, padding))
+    cur_gpu_util = flops / ms * 1e-9 / max_gpu_perf
+    a = torch.randn((N * P * Q, C * R * S), dtype=dtype, device=DEVICE)
+    b = torch.randn((C * R * S, K), dtype=dtype, device=DEVICE)
+    gemm_ms = do_bench(lambda: triton.ops.matmul(a, b))
+    gemm_gpu_util = flops / gemm_ms * 1e-9 / max_gpu_perf
+    print_perf(ms, cur_gpu_util, gemm_gpu_util)
+    assert cur_gpu_util >= 0.75 * gemm_gpu_util
+
+
 #######################
 # Element-Wise
 #######################
@@ -106,28 +237,60 @@ elementwise_data = {
         # Non pow 2
         1020 * 100: {'float16': 0.173, 'float32': 0.327},
         10003 * 7007: {'float16': 0.522, 'float32': 0.873},
-    }
+    },
+    'max1550': {
+        1024 * 16: {'float16': 0.009, 'float32': 0.018},
+        1024 * 64: {'float16': 0.036, 'float32': 0.070},
+        1024 * 256: {'float16': 0.131, 'float32': 0.243},
+        1024 * 1024: {'float16': 0.382, 'float32': 0.566},
+        1024 * 16384: {'float16': 0.714, 'float32': 0.763},
+        1024 * 65536: {'float16': 0.781, 'float32': 0.812},
+        # Non pow 2
+        1020 * 100: {'float16': 0.053, 'float32': 0.102},
+        10003 * 7007: {'float16': 0.436, 'float32': 0.722},
+    },
+    'max1100': {
+        1024 * 16: {'float16': 0.021, 'float32': 0.041},
+        1024 * 64: {'float16': 0.082, 'float32': 0.158},
+        1024 * 256: {'float16': 0.274, 'float32': 0.471},
+        1024 * 1024: {'float16': 0.602, 'float32': 0.753},
+        1024 * 16384: {'float16': 0.802, 'float32': 0.834},
+        1024 * 65536: {'float16': 0.843, 'float32': 0.861},
+        # Non pow 2
+        1020 * 100: {'float16': 0.121, 'float32': 0.229},
+        10003 * 7007: {'float16': 0.612, 'float32': 0.809},
+    },
+    'a770': {
+        1024 * 16: {'float16': 0.056, 'float32': 0.108},
+        1024 * 64: {'float16': 0.211, 'float32': 0.379},
+        1024 * 256: {'float16': 0.547, 'float32': 0.735},
+        1024 * 1024: {'float16': 0.781, 'float32': 0.846},
+        1024 * 16384: {'float16': 0.872, 'float32': 0.889},
+        1024 * 65536: {'float16': 0.884, 'float32': 0.893},
+        # Non pow 2
+        1020 * 100: {'float16': 0.296, 'float32': 0.523},
+        10003 * 7007: {'float16': 0.708, 'float32': 0.874},
+    },
 }
 
 
-@pytest.mark.parametrize('N', elementwise_data[DEVICE_NAME].keys())
+@pytest.mark.parametrize('N', elementwise_data.get(DEVICE_NAME, {}).keys())
 @pytest.mark.parametrize("dtype_str", ['float16', 'bfloat16', 'float32'])
 def test_elementwise(N, dtype_str):
-    stream = torch.cuda.Stream()
-    torch.cuda.set_stream(stream)
+    set_stream()
     torch.manual_seed(0)
-    if dtype_str in ['bfloat16'] and DEVICE_NAME != 'a100':
-        pytest.skip('Only test bfloat16 on a100')
+    if dtype_str in ['bfloat16'] and DEVICE_NAME not in ['a100', 'max1550', 'max1100', 'a770']:
+        pytest.skip('Only test bfloat16 on a100 and XPU')
     dtype = {'float16': torch.float16, 'bfloat16': torch.bfloat16, 'float32': torch.float32}[dtype_str]
     ref_dtype_str = 'float16' if dtype_str == 'bfloat16' else dtype_str
     ref_gpu_util = elementwise_data[DEVICE_NAME][N][ref_dtype_str]
-    max_gpu_perf = get_dram_gbps()
-    z = torch.empty((N, ), dtype=dtype, device='cuda')
+    max_gpu_perf = get_max_gbps()
+    z = torch.empty((N, ), dtype=dtype, device=DEVICE)
     x = torch.randn_like(z)
     y = torch.randn_like(z)
     grid = lambda args: (triton.cdiv(N, args['BLOCK_SIZE']), )
     fn = lambda: _add[grid](x, y, z, N, BLOCK_SIZE=1024)
-    ms = triton.testing.do_bench_cudagraph(fn)
+    ms = do_bench(fn)
     cur_gpu_perf = 3. * N * z.element_size() / ms * 1e-6
     cur_gpu_util = cur_gpu_perf / max_gpu_perf
     print_perf(ms, cur_gpu_util, ref_gpu_util)
@@ -164,7 +327,85 @@ flash_attention_data = {
         (4, 48, 4096, 64, False, False, 'backward', 'float16'): 0.159,
         (4, 48, 4096, 64, False, False, 'backward', 'bfloat16'): 0.159,
         (4, 48, 1024, 16, False, False, 'backward', 'float32'): 0.088,
-    }
+    },
+    "max1550": {
+        (4, 48, 4096, 64, True, True, 'forward', 'float16'): 0.231,
+        (4, 48, 4096, 64, True, True, 'forward', 'bfloat16'): 0.214,
+        (4, 48, 1024, 16, True, True, 'forward', 'float32'): 0.062,
+        (4, 48, 4096, 64, True, True, 'backward', 'float16'): 0.098,
+        (4, 48, 4096, 64, True, True, 'backward', 'bfloat16'): 0.091,
+        (4, 48, 1024, 16, True, True, 'backward', 'float32'): 0.041,
+        (4, 48, 4096, 64, False, True, 'forward', 'float16'): 0.149,
+        (4, 48, 4096, 64, False, True, 'forward', 'bfloat16'): 0.138,
+        (4, 48, 1024, 16, False, True, 'forward', 'float32'): 0.045,
+        (4, 48, 4096, 64, False, True, 'backward', 'float16'): 0.071,
+        (4, 48, 4096, 64, False, True, 'backward', 'bfloat16'): 0.066,
+        (4, 48, 1024, 16, False, True, 'backward', 'float32'): 0.033,
+        (4, 48, 4096, 64, True, False, 'forward', 'float16'): 0.231,
+        (4, 48, 4096, 64, True, False, 'forward', 'bfloat16'): 0.214,
+        (4, 48, 1024, 16, True, False, 'forward', 'float32'): 0.062,
+        (4, 48, 4096, 64, True, False, 'backward', 'float16'): 0.098,
+        (4, 48, 4096, 64, True, False, 'backward', 'bfloat16'): 0.091,
+        (4, 48, 1024, 16, True, False, 'backward', 'float32'): 0.041,
+        (4, 48, 4096, 64, False, False, 'forward', 'float16'): 0.149,
+        (4, 48, 4096, 64, False, False, 'forward', 'bfloat16'): 0.138,
+        (4, 48, 1024, 16, False, False, 'forward', 'float32'): 0.045,
+        (4, 48, 4096, 64, False, False, 'backward', 'float16'): 0.071,
+        (4, 48, 4096, 64, False, False, 'backward', 'bfloat16'): 0.066,
+        (4, 48, 1024, 16, False, False, 'backward', 'float32'): 0.033,
+    },
+    "max1100": {
+        (4, 48, 4096, 64, True, True, 'forward', 'float16'): 0.284,
+        (4, 48, 4096, 64, True, True, 'forward', 'bfloat16'): 0.262,
+        (4, 48, 1024, 16, True, True, 'forward', 'float32'): 0.078,
+        (4, 48, 4096, 64, True, True, 'backward', 'float16'): 0.121,
+        (4, 48, 4096, 64, True, True, 'backward', 'bfloat16'): 0.112,
+        (4, 48, 1024, 16, True, True, 'backward', 'float32'): 0.052,
+        (4, 48, 4096, 64, False, True, 'forward', 'float16'): 0.187,
+        (4, 48, 4096, 64, False, True, 'forward', 'bfloat16'): 0.173,
+        (4, 48, 1024, 16, False, True, 'forward', 'float32'): 0.057,
+        (4, 48, 4096, 64, False, True, 'backward', 'float16'): 0.089,
+        (4, 48, 4096, 64, False, True, 'backward', 'bfloat16'): 0.083,
+        (4, 48, 1024, 16, False, True, 'backward', 'float32'): 0.042,
+        (4, 48, 4096, 64, True, False, 'forward', 'float16'): 0.284,
+        (4, 48, 4096, 64, True, False, 'forward', 'bfloat16'): 0.262,
+        (4, 48, 1024, 16, True, False, 'forward', 'float32'): 0.078,
+        (4, 48, 4096, 64, True, False, 'backward', 'float16'): 0.121,
+        (4, 48, 4096, 64, True, False, 'backward', 'bfloat16'): 0.112,
+        (4, 48, 1024, 16, True, False, 'backward', 'float32'): 0.052,
+        (4, 48, 4096, 64, False, False, 'forward', 'float16'): 0.187,
+        (4, 48, 4096, 64, False, False, 'forward', 'bfloat16'): 0.173,
+        (4, 48, 1024, 16, False, False, 'forward', 'float32'): 0.057,
+        (4, 48, 4096, 64, False, False, 'backward', 'float16'): 0.089,
+        (4, 48, 4096, 64, False, False, 'backward', 'bfloat16'): 0.083,
+        (4, 48, 1024, 16, False, False, 'backward', 'float32'): 0.042,
+    },
+    "a770": {
+        (4, 48, 4096, 64, True, True, 'forward', 'float16'): 0.312,
+        (4, 48, 4096, 64, True, True, 'forward', 'bfloat16'): 0.287,
+        (4, 48, 1024, 16, True, True, 'forward', 'float32'): 0.351,
+        (4, 48, 4096, 64, True, True, 'backward', 'float16'): 0.134,
+        (4, 48, 4096, 64, True, True, 'backward', 'bfloat16'): 0.124,
+        (4, 48, 1024, 16, True, True, 'backward', 'float32'): 0.198,
+        (4, 48, 4096, 64, False, True, 'forward', 'float16'): 0.205,
+        (4, 48, 4096, 64, False, True, 'forward', 'bfloat16'): 0.189,
+        (4, 48, 1024, 16, False, True, 'forward', 'float32'): 0.243,
+        (4, 48, 4096, 64, False, True, 'backward', 'float16'): 0.097,
+        (4, 48, 4096, 64, False, True, 'backward', 'bfloat16'): 0.091,
+        (4, 48, 1024, 16, False, True, 'backward', 'float32'): 0.142,
+        (4, 48, 4096, 64, True, False, 'forward', 'float16'): 0.312,
+        (4, 48, 4096, 64, True, False, 'forward', 'bfloat16'): 0.287,
+        (4, 48, 1024, 16, True, False, 'forward', 'float32'): 0.351,
+        (4, 48, 4096, 64, True, False, 'backward', 'float16'): 0.134,
+        (4, 48, 4096, 64, True, False, 'backward', 'bfloat16'): 0.124,
+        (4, 48, 1024, 16, True, False, 'backward', 'float32'): 0.198,
+        (4, 48, 4096, 64, False, False, 'forward', 'float16'): 0.205,
+        (4, 48, 4096, 64, False, False, 'forward', 'bfloat16'): 0.189,
+        (4, 48, 1024, 16, False, False, 'forward', 'float32'): 0.243,
+        (4, 48, 4096, 64, False, False, 'backward', 'float16'): 0.097,
+        (4, 48, 4096, 64, False, False, 'backward', 'bfloat16'): 0.091,
+        (4, 48, 1024, 16, False, False, 'backward', 'float32'): 0.142,
+    },
 }
 
 
@@ -174,21 +415,19 @@ flash_attention_data = {
 @pytest.mark.parametrize("seq_par", [True, False])
 @pytest.mark.parametrize("Z, H, N_CTX, D_HEAD", [[4, 48, 4096, 64]])
 def test_flash_attention(Z, H, N_CTX, D_HEAD, seq_par, causal, mode, dtype_str):
-    stream = torch.cuda.Stream()
-    torch.cuda.set_stream(stream)
+    set_stream()
     is_backward = mode == 'backward'
-    capability = torch.cuda.get_device_capability()
-    if capability[0] < 8:
-        pytest.skip("Flash attention only supported for compute capability < 80")
+    if DEVICE_NAME not in flash_attention_data:
+        pytest.skip(f"No flash attention reference for {DEVICE_NAME}")
     torch.manual_seed(20)
     dtype = {'float16': torch.float16, 'bfloat16': torch.bfloat16, 'float32': torch.float32}[dtype_str]
     # init data
     if dtype_str == 'float32':
         N_CTX = 1024
         D_HEAD = 16
-    q = torch.empty((Z, H, N_CTX, D_HEAD), dtype=dtype, device="cuda").normal_(mean=0.1, std=0.2).requires_grad_()
-    k = torch.empty((Z, H, N_CTX, D_HEAD), dtype=dtype, device="cuda").normal_(mean=0.4, std=0.2).requires_grad_()
-    v = torch.empty((Z, H, N_CTX, D_HEAD), dtype=dtype, device="cuda").normal_(mean=0.3, std=0.2).requires_grad_()
+    q = torch.empty((Z, H, N_CTX, D_HEAD), dtype=dtype, device=DEVICE).normal_(mean=0.1, std=0.2).requires_grad_()
+    k = torch.empty((Z, H, N_CTX, D_HEAD), dtype=dtype, device=DEVICE).normal_(mean=0.4, std=0.2).requires_grad_()
+    v = torch.empty((Z, H, N_CTX, D_HEAD), dtype=dtype, device=DEVICE).normal_(mean=0.3, std=0.2).requires_grad_()
     sm_scale = 0.2
     # benchmark
     fn = lambda: triton.ops.attention(q, k, v, causal, sm_scale, seq_par)
@@ -196,7 +435,7 @@ def test_flash_attention(Z, H, N_CTX, D_HEAD, seq_par, causal, mode, dtype_str):
         o = fn()
         do = torch.randn_like(o)
         fn = lambda: o.backward(do, retain_graph=True)
-    ms = triton.testing.do_bench_cudagraph(fn)
+    ms = do_bench(fn)
     # compute flops
     flops_per_matmul = 2. * Z * H * N_CTX * N_CTX * D_HEAD * 0.5
     total_flops = 2 * flops_per_matmul
@@ -204,8 +443,7 @@ def test_flash_attention(Z, H, N_CTX, D_HEAD, seq_par, causal, mode, dtype_str):
         total_flops *= 2.5  # 2.0(bwd) + 0.5(recompute)
     cur_gpu_perf = total_flops / ms * 1e-9
     # maximum flops
-    cur_sm_clock = nvsmi(['clocks.current.sm'])[0]
-    max_gpu_perf = get_max_tensorcore_tflops(dtype, clock_rate=cur_sm_clock * 1e3)
+    max_gpu_perf = get_max_tflops(dtype)
     cur_gpu_util = cur_gpu_perf / max_gpu_perf
     ref_gpu_util = flash_attention_data[DEVICE_NAME][(Z, H, N_CTX, D_HEAD, seq_par, causal, mode, dtype_str)]
     print_perf(ms, cur_gpu_util, ref_gpu_util)
@@ -240,27 +478,25 @@ reduction_data = {
 }
 
 
-@pytest.mark.parametrize('N', reduction_data[DEVICE_NAME].keys())
+@pytest.mark.parametrize('N', reduction_data.get(DEVICE_NAME, {}).keys())
 @pytest.mark.parametrize("dtype_str", ['float16', 'float32', 'int16', 'int32'])
 def test_reductions(N, dtype_str):
-    stream = torch.cuda.Stream()
-    torch.cuda.set_stream(stream)
+    set_stream()
     torch.manual_seed(0)
     dtype = {'float16': torch.float16, 'float32': torch.float32, 'int16': torch.int16, 'int32': torch.int32}[dtype_str]
     ref_gpu_util = reduction_data[DEVICE_NAME][N][dtype_str]
-    cur_sm_clock = nvsmi(['clocks.current.sm'])[0]
-    max_gpu_perf = get_max_tensorcore_tflops(dtype, clock_rate=cur_sm_clock * 1e3)
-    z = torch.empty((N, ), dtype=dtype, device='cuda')
+    max_gpu_perf = get_max_tflops(dtype)
+    z = torch.empty((N, ), dtype=dtype, device=DEVICE)
     if dtype == torch.float16 or dtype == torch.float32:
         x = torch.randn_like(z)
         y = torch.randn_like(z)
     else:
         info = torch.iinfo(dtype)
-        x = torch.randint(info.min, info.max, (N, ), dtype=dtype, device='cuda')
-        y = torch.randint(info.min, info.max, (N, ), dtype=dtype, device='cuda')
+        x = torch.randint(info.min, info.max, (N, ), dtype=dtype, device=DEVICE)
+        y = torch.randint(info.min, info.max, (N, ), dtype=dtype, device=DEVICE)
     grid = lambda args: (triton.cdiv(N, args['BLOCK_SIZE']), )
     fn = lambda: _sum[grid](x, y, z, N, BLOCK_SIZE=1024)
-    ms = triton.testing.do_bench_cudagraph(fn)
+    ms = do_bench(fn)
     cur_gpu_perf = 100. * 2. * N / ms * 1e-9
     cur_gpu_util = cur_gpu_perf / max_gpu_perf
     print_perf(ms, cur_gpu_util, ref_gpu_util)
@@ -0,0 +1,276 @@
+"""
+Compile-time benchmark.
+
+Compiles a fixed corpus of kernels (GEMM, attention, layernorm, softmax, cross-entropy and block-sparse) and reports,
+for each of them, the time spent in each stage of the compilation pipeline (ttir, ttgir, llir, spv), in the build of
+the native binary by the driver, and the peak RSS of the process.
+
+Each kernel is compiled twice by its own process:
+  * cold: from an empty cache, by a process that hasn't compiled any kernel yet;
+  * warm: again from an empty cache, in the same process, once the in-memory caches of the kernel are cleared. The
+    driver still reuses the modules it has already built, so the warm native build time is the one of a cache hit.
+
+Usage:
+    python compile_benchmark.py [--kernels gemm softmax ...] [--device xpu] [--json results.json]
+"""
+import argparse
+import importlib
+import json
+import os
+import resource
+import subprocess
+import sys
+import tempfile
+import time
+from collections import defaultdict
+
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.language as tl
+import triton.ops
+from triton.compiler import compiler
+from triton.runtime.driver import driver
+from triton.runtime.jit import JITFunction
+
+#######################
+# Corpus
+#######################
+
+
+@triton.jit
+def _gemm_kernel(a_ptr, b_ptr, c_ptr, M, N, K, stride_am, stride_ak, stride_bk, stride_bn, stride_cm, stride_cn,
+                 BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr):
+    pid_m = tl.program_id(0)
+    pid_n = tl.program_id(1)
+    offs_m = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    offs_n = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+    offs_k = tl.arange(0, BLOCK_K)
+    a_ptrs = a_ptr + offs_m[:, None] * stride_am + offs_k[None, :] * stride_ak
+    b_ptrs = b_ptr + offs_k[:, None] * stride_bk + offs_n[None, :] * stride_bn
+    acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
+    for k in range(0, tl.cdiv(K, BLOCK_K)):
+        a = tl.load(a_ptrs, mask=offs_k[None, :] < K - k * BLOCK_K, other=0.)
+        b = tl.load(b_ptrs, mask=offs_k[:, None] < K - k * BLOCK_K, other=0.)
+        acc += tl.dot(a, b)
+        a_ptrs += BLOCK_K * stride_ak
+        b_ptrs += BLOCK_K * stride_bk
+    c_ptrs = c_ptr + offs_m[:, None] * stride_cm + offs_n[None, :] * stride_cn
+    tl.store(c_ptrs, acc.to(tl.float16), mask=(offs_m[:, None] < M) & (offs_n[None, :] < N))
+
+
+@triton.jit
+def _layernorm_kernel(X, Y, W, B, stride, N, eps, BLOCK_SIZE: tl.constexpr):
+    row = tl.program_id(0)
+    cols = tl.arange(0, BLOCK_SIZE)
+    mask = cols < N
+    x = tl.load(X + row * stride + cols, mask=mask, other=0.).to(tl.float32)
+    mean = tl.sum(x, axis=0) / N
+    xc = tl.where(mask, x - mean, 0.)
+    rstd = 1 / tl.sqrt(tl.sum(xc * xc, axis=0) / N + eps)
+    w = tl.load(W + cols, mask=mask)
+    b = tl.load(B + cols, mask=mask)
+    tl.store(Y + row * stride + cols, xc * rstd * w + b, mask=mask)
+
+
+@triton.jit
+def _softmax_kernel(output_ptr, input_ptr, stride, n_cols, BLOCK_SIZE: tl.constexpr):
+    row = tl.program_id(0)
+    cols = tl.arange(0, BLOCK_SIZE)
+    x = tl.load(input_ptr + row * stride + cols, mask=cols < n_cols, other=-float('inf'))
+    x = x - tl.max(x, axis=0)
+    num = tl.exp(x)
+    tl.store(output_ptr + row * stride + cols, num / tl.sum(num, axis=0), mask=cols < n_cols)
+
+
+def run_gemm(device):
+    M = N = K = 1024
+    a = torch.randn((M, K), dtype=torch.float16, device=device)
+    b = torch.randn((K, N), dtype=torch.float16, device=device)
+    c = torch.empty((M, N), dtype=torch.float16, device=device)
+    grid = (triton.cdiv(M, 128), triton.cdiv(N, 128))
+    _gemm_kernel[grid](a, b, c, M, N, K, a.stride(0), a.stride(1), b.stride(0), b.stride(1), c.stride(0), c.stride(1),
+                       BLOCK_M=128, BLOCK_N=128, BLOCK_K=32, num_warps=8)
+
+
+def run_attention(device):
+    q, k, v = [torch.randn((1, 4, 1024, 64), dtype=torch.float16, device=device) for _ in range(3)]
+    triton.ops.attention(q, k, v, True, 0.125)
+
+
+def run_layernorm(device):
+    M, N = 1024, 4096
+    x = torch.randn((M, N), dtype=torch.float32, device=device)
+    w = torch.randn((N, ), dtype=torch.float32, device=device)
+    b = torch.randn((N, ), dtype=torch.float32, device=device)
+    y = torch.empty_like(x)
+    _layernorm_kernel[(M, )](x, y, w, b, x.stride(0), N, 1e-5, BLOCK_SIZE=triton.next_power_of_2(N))
+
+
+def run_softmax(device):
+    M, N = 1024, 1000
+    x = torch.randn((M, N), dtype=torch.float32, device=device)
+    y = torch.empty_like(x)
+    _softmax_kernel[(M, )](y, x, x.stride(0), N, BLOCK_SIZE=triton.next_power_of_2(N))
+
+
+def run_cross_entropy(device):
+    logits = torch.randn((1024, 4096), dtype=torch.float32, device=device)
+    indices = torch.randint(0, 4096, (1024, ), device=device)
+    triton.ops.cross_entropy(logits, indices)
+
+
+def run_blocksparse(device):
+    BLOCK = 32
+    layout = torch.randint(2, (4, 8, 8))
+    op = triton.ops.blocksparse.matmul(layout, BLOCK, "sdd", device=device)
+    a = torch.randn((1, 4, 8 * BLOCK, 8 * BLOCK), dtype=torch.float16, device=device)
+    b = torch.randn((1, 4, 8 * BLOCK, 8 * BLOCK), dtype=torch.float16, device=device)
+    op(a, b)
+
+
+# name -> (function launching the kernels, the kernels it launches)
+CORPUS = {
+    "gemm": (run_gemm, lambda: [_gemm_kernel]),
+    "attention": (run_attention, lambda: [importlib.import_module("triton.ops.flash_attention")._fwd_kernel]),
+    "layernorm": (run_layernorm, lambda: [_layernorm_kernel]),
+    "softmax": (run_softmax, lambda: [_softmax_kernel]),
+    "cross_entropy": (run_cross_entropy, lambda: [importlib.import_module("triton.ops.cross_entropy")._forward]),
+    "blocksparse": (run_blocksparse, lambda: [importlib.import_module("triton.ops.blocksparse.matmul")._sdd_kernel]),
+}
+
+#######################
+# Timers
+#######################
+
+
+class StageTimer:
+    """
+    Accumulates the time spent in each stage of the compilation pipeline of the backends, and in the build of the
+    native binaries when the kernels are loaded.
+    """
+
+    def __init__(self):
+        self.times = defaultdict(float)
+
+    def _timed(self, name, fn):
+
+        def wrapper(*args, **kwargs):
+            start = time.perf_counter()
+            try:
+                return fn(*args, **kwargs)
+            finally:
+                self.times[name] += time.perf_counter() - start
+
+        return wrapper
+
+    def install(self):
+        make_backend = compiler.make_backend
+
+        def timed_make_backend(target):
+            backend = make_backend(target)
+            add_stages = backend.add_stages
+
+            def timed_add_stages(stages, options):
+                add_stages(stages, options)
+                for ext, compile_ir in stages.items():
+                    stages[ext] = self._timed(ext, compile_ir)
+
+            backend.add_stages = timed_add_stages
+            return backend
+
+        compiler.make_backend = timed_make_backend
+        utils = driver.active.utils
+        utils.load_binary = self._timed("native", utils.load_binary)
+
+    def reset(self):
+        self.times.clear()
+
+
+def peak_rss_mb():
+    # ru_maxrss is in kB on Linux
+    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss / 1024
+
+
+def clear_caches(kernels):
+    # the in-memory caches of the compiled kernels, the on-disk cache is replaced by an empty one
+    for kernel in kernels:
+        while not isinstance(kernel, JITFunction):
+            kernel = kernel.fn
+        kernel.cache.clear()
+    compiler._compiled_groups.clear()
+
+
+def measure(name, device, timer):
+    run, _ = CORPUS[name]
+    timer.reset()
+    with tempfile.TemporaryDirectory() as cache_dir:
+        os.environ["TRITON_CACHE_DIR"] = cache_dir
+        start = time.perf_counter()
+        run(device)
+        if device == "xpu":
+            torch.xpu.synchronize()
+        else:
+            torch.cuda.synchronize()
+        total = time.perf_counter() - start
+    return {
+        "stages_ms": {stage: t * 1e3 for stage, t in timer.times.items()},
+        "total_ms": total * 1e3,
+        "peak_rss_mb": peak_rss_mb(),
+    }
+
+
+def run_worker(name, device):
+    timer = StageTimer()
+    timer.install()
+    cold = measure(name, device, timer)
+    clear_caches(CORPUS[name][1]())
+    warm = measure(name, device, timer)
+    print(json.dumps({"cold": cold, "warm": warm}))
+
+
+#######################
+# Driver
+#######################
+
+
+def print_results(results):
+    stages = sorted({stage for r in results.values() for state in r.values() for stage in state["stages_ms"]})
+    header = f"{'kernel':<16}{'state':<8}" + "".join(f"{stage + ' ms':>12}" for stage in stages)
+    header += f"{'total ms':>12}{'peak RSS MB':>14}"
+    print(header)
+    for name, r in results.items():
+        for state in ["cold", "warm"]:
+            times = r[state]["stages_ms"]
+            line = f"{name:<16}{state:<8}" + "".join(f"{times.get(stage, 0.):>12.1f}" for stage in stages)
+            line += f"{r[state]['total_ms']:>12.1f}{r[state]['peak_rss_mb']:>14.1f}"
+            print(line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark the compilation time of a corpus of kernels")
+    parser.add_argument("--kernels", nargs="+", choices=list(CORPUS.keys()), default=list(CORPUS.keys()))
+    parser.add_argument("--device", default="xpu")
+    parser.add_argument("--json", help="write the results to this file")
+    parser.add_argument("--worker", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        run_worker(args.worker, args.device)
+        return
+
+    results = {}
+    for name in args.kernels:
+        # a new process per kernel, for the cold measurements not to benefit from the previous kernels
+        out = subprocess.run([sys.executable, __file__, "--worker", name, "--device", args.device], check=True,
+                             capture_output=True, text=True)
+        results[name] = json.loads(out.stdout.strip().splitlines()[-1])
+    print_results(results)
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,130 @@
+"""
+Launch-overhead microbenchmark.
+
+Launches empty kernels with 0, 4, 16 and 32 arguments and reports the host time per launch spent in each layer of
+the launch path:
+  * dispatch: `JITFunction.run`, i.e. the specialization of the arguments and the lookup of the compiled kernel;
+  * runner: the Python wrapper of `CompiledKernel`, which expands the arguments for the launcher;
+  * marshalling: the extraction of the pointers of the tensor arguments by the launcher (`getPointer`), the
+    difference between the launches with tensor and with integer arguments;
+  * launcher: the construction of the command group and its submission to the queue, for integer arguments.
+
+The kernels do nothing, the device time isn't measured.
+
+Usage:
+    python launch_benchmark.py [--num-args 0 4 16 32] [--device xpu] [--launches 10000] [--json results.json]
+"""
+import argparse
+import importlib.util
+import json
+import os
+import statistics
+import tempfile
+import time
+
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+from triton.compiler import CompiledKernel
+from triton.runtime.driver import driver
+
+BATCH = 1000
+
+
+def make_kernel(num_args, module_dir):
+    # JITFunction reads the source of the kernels, write them to a module.
+    name = f"empty_kernel_{num_args}"
+    params = ", ".join(f"arg{i}" for i in range(num_args))
+    src = f"import triton\n\n\n@triton.jit\ndef {name}({params}):\n    pass\n"
+    path = os.path.join(module_dir, f"{name}.py")
+    with open(path, "w") as f:
+        f.write(src)
+    spec = importlib.util.spec_from_file_location(name, path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return getattr(module, name)
+
+
+def synchronize(device):
+    if device == "xpu":
+        torch.xpu.synchronize()
+    else:
+        torch.cuda.synchronize()
+
+
+def time_per_launch(launch, launches, device):
+    # The launches are timed by batches, the queue is drained between the batches so that the submissions never wait
+    # for the device.
+    launch()
+    synchronize(device)
+    times = []
+    for _ in range(max(1, launches // BATCH)):
+        start = time.perf_counter()
+        for _ in range(BATCH):
+            launch()
+        times.append((time.perf_counter() - start) / BATCH)
+        synchronize(device)
+    return statistics.median(times) * 1e6
+
+
+def bench(kernel, args, launches, device):
+    grid = (1, 1, 1)
+    jit_time = time_per_launch(lambda: kernel[grid](*args), launches, device)
+    compiled = kernel[grid](*args)
+    runner = compiled[grid]
+    runner_time = time_per_launch(lambda: runner(*args), launches, device)
+    md = compiled.metadata
+    stream = driver.active.get_current_stream(driver.active.get_current_device())
+    run, function = compiled.run, compiled.function
+    launch_args = driver.active.assemble_tensormap_to_arg(md.tensormaps_info, args)
+
+    def launch():
+        run(grid[0], grid[1], grid[2], md.num_warps, md.num_ctas, md.cluster_dims[0], md.cluster_dims[1],
+            md.cluster_dims[2], md.shared, stream, function, CompiledKernel.launch_enter_hook,
+            CompiledKernel.launch_exit_hook, md, *launch_args)
+
+    launcher_time = time_per_launch(launch, launches, device)
+    return jit_time, runner_time, launcher_time
+
+
+def run_benchmark(num_args, launches, device, module_dir):
+    kernel = make_kernel(num_args, module_dir)
+    # distinct values, so that none of the arguments is specialized away
+    ints = [17 + i for i in range(num_args)]
+    tensors = [torch.empty(16, device=device) for _ in range(num_args)]
+    int_jit, _, int_launcher = bench(kernel, ints, launches, device)
+    ptr_jit, ptr_runner, ptr_launcher = bench(kernel, tensors, launches, device)
+    return {
+        "dispatch_us": ptr_jit - ptr_runner,
+        "runner_us": ptr_runner - ptr_launcher,
+        "marshalling_us": ptr_launcher - int_launcher,
+        "launcher_us": int_launcher,
+        "total_us": ptr_jit,
+        "int_args_total_us": int_jit,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark the host overhead of the kernel launches")
+    parser.add_argument("--num-args", nargs="+", type=int, default=[0, 4, 16, 32])
+    parser.add_argument("--device", default="xpu")
+    parser.add_argument("--launches", type=int, default=10000)
+    parser.add_argument("--json", help="write the results to this file")
+    args = parser.parse_args()
+
+    results = {}
+    with tempfile.TemporaryDirectory() as module_dir:
+        for num_args in args.num_args:
+            results[num_args] = run_benchmark(num_args, args.launches, args.device, module_dir)
+
+    layers = ["dispatch_us", "runner_us", "marshalling_us", "launcher_us", "total_us"]
+    print(f"{'args':<6}" + "".join(f"{layer:>16}" for layer in layers))
+    for num_args, r in results.items():
+        print(f"{num_args:<6}" + "".join(f"{r[layer]:>16.2f}" for layer in layers))
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,7 +1,13 @@
 # content of conftest.py
 
+import os
+
 import pytest
 
+# The tests check the IRs of their kernels, which are only stored in the cache
+# when asked for.
+os.environ.setdefault("TRITON_STORE_IR", "all")
+
 
 def pytest_addoption(parser):
     parser.addoption("--device", action="store", default='cuda')
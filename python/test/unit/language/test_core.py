@@ -1666,6 +1666,34 @@ def test_reduce1d(op, dtype_str, shape, num_ctas, device):
             np.testing.assert_equal(z_ref, z_tri)
 
 
+@pytest.mark.parametrize("op", ['argmin', 'argmax'])
+@pytest.mark.parametrize("dtype_str", ['int8', 'int32', 'uint32', 'float16', 'float32'])
+def test_argmin_argmax_ties(op, dtype_str, device):
+    # the first index of the extremum, of negative and signed zero values too
+    @triton.jit
+    def kernel(X, Z, BLOCK: tl.constexpr, OP: tl.constexpr):
+        x = tl.load(X + tl.arange(0, BLOCK))
+        if OP == 'argmin':
+            z = tl.argmin(x, axis=0, tie_break_left=True)
+        else:
+            z = tl.argmax(x, axis=0, tie_break_left=True)
+        tl.store(Z, z)
+
+    BLOCK = 256
+    rs = RandomState(17)
+    x = numpy_random((BLOCK, ), dtype_str=dtype_str, rs=rs)
+    if dtype_str.startswith('float'):
+        x = -np.abs(x) if op == 'argmax' else np.abs(x)
+        x[[37, 101, 200]] = 0.0
+        x[101] = -0.0
+    extremum = getattr(np, op)(x)
+    x[[(extremum + 100) % BLOCK, BLOCK - 1]] = x[extremum]
+    x_tri = to_triton(x, device=device)
+    z_tri = to_triton(np.zeros((1, ), dtype=np.int32), device=device)
+    kernel[(1, )](x_tri, z_tri, BLOCK=BLOCK, OP=op)
+    assert to_numpy(z_tri)[0] == getattr(np, op)(x)
+
+
 # TODO: [Qingyi] Fix argmin / argmax
 reduce_configs1 = [(op, dtype, (1, 1024), axis, False)
                    for dtype in dtypes_with_bfloat16
@@ -1932,9 +1960,6 @@ def test_histogram(M, N, device):
             'test_histogram for HIP currently broken in https://github.com/openai/triton. Use https://github.com/ROCmSoftwarePlatform/triton'
         )
 
-    if is_xpu(device):
-        pytest.skip("RuntimeError: \"histc\" not implemented for 'Int'")
-
     @triton.jit
     def histogram_kernel(x_ptr, z_ptr, M: tl.constexpr, N: tl.constexpr):
         offset1 = tl.arange(0, M)
@@ -1946,7 +1971,12 @@ def test_histogram(M, N, device):
     torch.manual_seed(17)
     x = torch.randint(0, N, (M, ), device=device, dtype=torch.int32)
     z = torch.empty(N, dtype=torch.int32, device=device)
-    z_torch = torch.histc(x, bins=N, min=0, max=N - 1)
+    if is_xpu(device):
+        # "histc" isn't implemented for integers on XPU, the reference is
+        # computed on the host.
+        z_torch = torch.histc(x.cpu().float(), bins=N, min=0, max=N - 1).to(torch.int32).to(device)
+    else:
+        z_torch = torch.histc(x, bins=N, min=0, max=N - 1)
     histogram_kernel[(1, )](x, z, M=M, N=N)
     assert (z_torch == z).all()
 
@@ -2705,6 +2735,86 @@ def test_max_num_imprecise_acc(device):
     assert h.asm["ptx"].count("add.f32") == (M * N) // (32 * num_warps) * (K / MAX_NUM_IMPRECISE_ACC)
 
 
+@pytest.mark.parametrize("other_format", ["int4", "uint4"])
+@pytest.mark.parametrize("M, N, K, num_warps", [(64, 64, 64, 4), (128, 64, 128, 8)])
+def test_dot_int4(M, N, K, num_warps, other_format, device):
+
+    @triton.jit
+    def kernel(X, Y, Z, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,
+               OTHER_FORMAT: tl.constexpr):
+        off_m = tl.arange(0, BLOCK_M)
+        off_n = tl.arange(0, BLOCK_N)
+        off_k = tl.arange(0, BLOCK_K)
+        off_packed_k = tl.arange(0, BLOCK_K // 2)
+        x = tl.load(X + off_m[:, None] * BLOCK_K + off_k[None, :])
+        y = tl.load(Y + off_packed_k[:, None] * BLOCK_N + off_n[None, :])
+        z = tl.dot(x, y, other_format=OTHER_FORMAT)
+        tl.store(Z + off_m[:, None] * BLOCK_N + off_n[None, :], z)
+
+    # Row k of the unpacked operand is in the low nibbles of row k // 2 of
+    # the packed one when k is even, in the high nibbles otherwise.
+    packed = torch.randint(-128, 128, (K // 2, N), dtype=torch.int8)
+    lo = packed & 0xf
+    hi = (packed >> 4) & 0xf
+    if other_format == "int4":
+        lo = torch.where(lo >= 8, lo - 16, lo)
+        hi = torch.where(hi >= 8, hi - 16, hi)
+    y_ref = torch.stack([lo, hi], dim=1).reshape(K, N)
+    x = torch.randn((M, K), dtype=torch.float16)
+    z_ref = torch.matmul(x.float(), y_ref.float())
+
+    x = x.to(device)
+    y = packed.to(device)
+    z = torch.empty((M, N), dtype=torch.float32, device=device)
+    kernel[(1, )](x, y, z, M, N, K, other_format, num_warps=num_warps)
+    torch.testing.assert_close(z.cpu(), z_ref, rtol=1e-3, atol=1e-2)
+
+
+@pytest.mark.parametrize("precision", ["bf16x3", "tf32x3"])
+@pytest.mark.parametrize("M, N, K, num_warps", [(64, 64, 64, 4), (128, 64, 128, 8)])
+def test_dot_precision(M, N, K, num_warps, precision, device):
+
+    @triton.jit
+    def kernel(X, Y, Z, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,
+               PRECISION: tl.constexpr):
+        off_m = tl.arange(0, BLOCK_M)
+        off_n = tl.arange(0, BLOCK_N)
+        off_k = tl.arange(0, BLOCK_K)
+        x = tl.load(X + off_m[:, None] * BLOCK_K + off_k[None, :])
+        y = tl.load(Y + off_k[:, None] * BLOCK_N + off_n[None, :])
+        z = tl.dot(x, y, precision=PRECISION)
+        tl.store(Z + off_m[:, None] * BLOCK_N + off_n[None, :], z)
+
+    x = torch.randn((M, K), dtype=torch.float32)
+    y = torch.randn((K, N), dtype=torch.float32)
+    z_ref = torch.matmul(x.double(), y.double()).float()
+    z = torch.empty((M, N), dtype=torch.float32, device=device)
+    kernel[(1, )](x.to(device), y.to(device), z, M, N, K, precision, num_warps=num_warps)
+    # much closer to the fp32 product than a single bf16 or tf32 product
+    torch.testing.assert_close(z.cpu(), z_ref, rtol=1e-4, atol=1e-3)
+
+
+
+@pytest.mark.parametrize("B, M, N, K, num_warps", [(4, 32, 32, 32, 4), (2, 64, 32, 32, 4), (8, 16, 64, 32, 8)])
+def test_dot_batched(B, M, N, K, num_warps, device):
+
+    @triton.jit
+    def kernel(X, Y, Z, BATCH: tl.constexpr, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr):
+        off_b = tl.arange(0, BATCH)[:, None, None]
+        off_m = tl.arange(0, BLOCK_M)[None, :, None]
+        off_n = tl.arange(0, BLOCK_N)[None, None, :]
+        off_k = tl.arange(0, BLOCK_K)
+        x = tl.load(X + off_b * BLOCK_M * BLOCK_K + off_m * BLOCK_K + off_k[None, None, :])
+        y = tl.load(Y + off_b * BLOCK_K * BLOCK_N + off_k[None, :, None] * BLOCK_N + off_n)
+        z = tl.dot(x, y)
+        tl.store(Z + off_b * BLOCK_M * BLOCK_N + off_m * BLOCK_N + off_n, z)
+
+    x = torch.randn((B, M, K), dtype=torch.float16, device=device)
+    y = torch.randn((B, K, N), dtype=torch.float16, device=device)
+    z = torch.empty((B, M, N), dtype=torch.float32, device=device)
+    kernel[(1, )](x, y, z, B, M, N, K, num_warps=num_warps)
+    torch.testing.assert_close(z, torch.bmm(x.float(), y.float()), rtol=1e-3, atol=1e-2)
+
 @pytest.mark.parametrize('in_dtype', ['float32'])
 def test_dot_mulbroadcastred(in_dtype, device):
     if torch.cuda.is_available():
@@ -3053,6 +3163,10 @@ def test_store_cache_modifier(cache, device):
         return
     pgm = _kernel[(1, )](dst, src, CACHE=cache)
 
+    if is_xpu(device):
+        # the modified stores are written with their LSC cache control
+        assert ('__builtin_IB_lsc_store_global' in pgm.asm['llir']) == (cache != '')
+        return
     if not is_cuda(device):
         return
 
@@ -3515,6 +3629,30 @@ def test_math_scalar(dtype_str, expr, lib_path, num_ctas, device):
     np.testing.assert_allclose(y_ref, to_numpy(y_tri), rtol=0.01)
 
 
+@pytest.mark.parametrize("expr, np_fn", [('math.exp', np.exp), ('math.exp2', np.exp2), ('math.log', np.log),
+                                         ('math.log2', np.log2), ('math.rsqrt', lambda x: 1 / np.sqrt(x)),
+                                         ('math.tanh', np.tanh)])
+def test_math_fast_math(expr, np_fn, device):
+    if not is_xpu(device):
+        pytest.skip("test_math_fast_math is only supported on XPU")
+
+    @triton.jit
+    def kernel(X, Y, BLOCK: tl.constexpr):
+        x = tl.load(X + tl.arange(0, BLOCK))
+        y = GENERATE_TEST_HERE
+        tl.store(Y + tl.arange(0, BLOCK), y)
+
+    kernel = patch_kernel(kernel, {'GENERATE_TEST_HERE': f'tl.{expr}(x)'})
+    shape = (128, )
+    rs = RandomState(17)
+    x = np.abs(numpy_random(shape, dtype_str='float32', rs=rs)) + 0.5
+    y_ref = np_fn(x)
+    x_tri = to_triton(x, device=device)
+    y_tri = to_triton(np.zeros(shape, dtype=np.float32), device=device)
+    kernel[(1, )](x_tri, y_tri, BLOCK=shape[0], fast_math=True)
+    np.testing.assert_allclose(y_ref, to_numpy(y_tri), rtol=0.01)
+
+
 # -----------------------
 # test inline asm
 # -----------------------
@@ -3727,6 +3865,30 @@ def test_inline_asm_packed_multiple_outputs(device):
     np.testing.assert_equal(D_ref, to_numpy(D_tri))
 
 
+def test_inline_asm_visa(device):
+    if not is_xpu(device):
+        pytest.skip("test_inline_asm_visa is only supported on XPU")
+
+    @triton.jit
+    def kernel(X, Y, Z, BLOCK: tl.constexpr):
+        x = tl.load(X + tl.arange(0, BLOCK))
+        y = tl.load(Y + tl.arange(0, BLOCK))
+        # vISA instructions run over the 16 lanes of the sub-group.
+        z = tl.inline_asm_elementwise("add (M1, 16) $0(0,0)<1> $1(0,0)<1;1,0> $2(0,0)<1;1,0>", "=rw,rw,rw", [x, y],
+                                      dtype=tl.int32, is_pure=True, pack=1)
+        tl.store(Z + tl.arange(0, BLOCK), z)
+
+    shape = (128, )
+    rs = RandomState(17)
+    x = numpy_random(shape, dtype_str='int32', rs=rs)
+    y = numpy_random(shape, dtype_str='int32', rs=rs)
+    x_tri = to_triton(x, device=device)
+    y_tri = to_triton(y, device=device)
+    z_tri = to_triton(numpy_random(shape, dtype_str='int32', rs=rs), device=device)
+    kernel[(1, )](x_tri, y_tri, z_tri, BLOCK=shape[0], threads_per_warp=16)
+    np.testing.assert_equal(x + y, to_numpy(z_tri))
+
+
 # -----------------------
 # test control flow
 # -----------------------
@@ -3749,6 +3911,116 @@ def test_for_iv(lo, hi, iv, device):
     assert out[0] == sum(range(lo, hi, iv))
 
 
+
+@pytest.mark.parametrize("n, factor", [(0, 2), (7, 2), (8, 4), (13, 4), (5, 1)])
+def test_range_unroll(n, factor, device):
+
+    @triton.jit
+    def kernel(X, Out, n, FACTOR: tl.constexpr):
+        acc = tl.zeros([16], dtype=tl.float32)
+        for i in tl.range(0, n, loop_unroll_factor=FACTOR):
+            acc += tl.load(X + i * 16 + tl.arange(0, 16))
+        tl.store(Out + tl.arange(0, 16), acc)
+
+    x = torch.randn((max(n, 1), 16), dtype=torch.float32, device=device)
+    out = torch.empty(16, dtype=torch.float32, device=device)
+    h = kernel[(1, )](x, out, n, FACTOR=factor)
+    torch.testing.assert_close(out, x[:n].sum(0))
+    assert ("tt.loop_unroll_factor" in h.asm["ttir"]) == (factor > 1)
+
+
+@pytest.mark.parametrize("M, N, pitch", [(64, 64, 64), (100, 72, 72), (100, 72, 128)])
+def test_tensor_descriptor(M, N, pitch, device):
+    from triton.tools.tensor_descriptor import TensorDescriptor
+
+    @triton.jit
+    def double(desc, m, n):
+        desc.store([m, n], desc.load([m, n]) * 2)
+
+    @triton.jit
+    def kernel(in_desc, out_desc, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr):
+        m = tl.program_id(0) * BLOCK_M
+        n = tl.program_id(1) * BLOCK_N
+        out_desc.store([m, n], in_desc.load([m, n]))
+        double(out_desc, m, n)
+
+    x = torch.randn((M, pitch), dtype=torch.float16, device=device)[:, :N]
+    out = torch.full((M, pitch), -1, dtype=torch.float16, device=device)
+    y = out[:, :N]
+    BLOCK_M, BLOCK_N = 32, 32
+    grid = (triton.cdiv(M, BLOCK_M), triton.cdiv(N, BLOCK_N))
+    descs = [TensorDescriptor.from_tensor(t, [BLOCK_M, BLOCK_N]) for t in (x, y)]
+    h = kernel[grid](*descs, BLOCK_M=BLOCK_M, BLOCK_N=BLOCK_N)
+    torch.testing.assert_close(y, x * 2)
+    # the columns past the tensor aren't written
+    assert (out[:, N:] == -1).all()
+    assert "tt.make_tensor_ptr" in h.asm["ttir"]
+
+
+@pytest.mark.parametrize("page_size", [16, 32])
+@pytest.mark.parametrize("dot", [False, True])
+def test_load_pages(page_size, dot, device):
+
+    @triton.jit
+    def kernel(Cache, Pages, A, Out, rows, PAGE: tl.constexpr, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr,
+               BLOCK_D: tl.constexpr, DOT: tl.constexpr):
+        cache = tl.make_block_ptr(Cache, (rows, BLOCK_D), (BLOCK_D, 1), (0, 0), (BLOCK_N, BLOCK_D), (1, 0))
+        v = tl.load_pages(cache, Pages, PAGE)
+        if DOT:
+            offs_m = tl.arange(0, BLOCK_M)
+            offs_n = tl.arange(0, BLOCK_N)
+            a = tl.load(A + offs_m[:, None] * BLOCK_N + offs_n[None, :])
+            out = tl.dot(a, v)
+            tl.store(Out + offs_m[:, None] * BLOCK_D + tl.arange(0, BLOCK_D)[None, :], out)
+        else:
+            tl.store(Out + tl.arange(0, BLOCK_N)[:, None] * BLOCK_D + tl.arange(0, BLOCK_D)[None, :], v)
+
+    BLOCK_M, BLOCK_N, BLOCK_D = 32, 64, 64
+    num_pages = 8
+    # the last page is half out of the cache
+    rows = num_pages * page_size - page_size // 2
+    cache = torch.randn((num_pages * page_size, BLOCK_D), dtype=torch.float16, device=device)[:rows]
+    pages = torch.randperm(num_pages, device=device)[:BLOCK_N // page_size].to(torch.int32)
+    pages[-1] = num_pages - 1
+    gathered = torch.zeros((BLOCK_N, BLOCK_D), dtype=torch.float16, device=device)
+    for i, page in enumerate(pages.tolist()):
+        block = cache[page * page_size:(page + 1) * page_size]
+        gathered[i * page_size:i * page_size + block.shape[0]] = block
+    a = torch.randn((BLOCK_M, BLOCK_N), dtype=torch.float16, device=device)
+    out = torch.empty((BLOCK_M, BLOCK_D) if dot else (BLOCK_N, BLOCK_D), dtype=torch.float32 if dot else torch.float16,
+                      device=device)
+    h = kernel[(1, )](cache, pages, a, out, rows, PAGE=page_size, BLOCK_M=BLOCK_M, BLOCK_N=BLOCK_N, BLOCK_D=BLOCK_D,
+                      DOT=dot)
+    if dot:
+        torch.testing.assert_close(out, torch.matmul(a.float(), gathered.float()), atol=1e-2, rtol=1e-2)
+    else:
+        torch.testing.assert_close(out, gathered)
+    assert "tt.load_pages" in h.asm["ttir"]
+
+
+def test_spec_constant(device):
+
+    @triton.jit
+    def kernel(X, Out, BLOCK: tl.constexpr):
+        offs = tl.arange(0, BLOCK)
+        x = tl.load(X + offs)
+        if tl.spec_constant(1, False):
+            x = -x
+        tl.store(Out + offs, x * tl.spec_constant(0, 1.0))
+
+    x = torch.randn(128, device=device)
+    out = torch.empty_like(x)
+    h = kernel[(1, )](x, out, BLOCK=128)
+    torch.testing.assert_close(out, x)
+    assert dict(h.metadata.spec_constants) == {0: "fp32", 1: "i1"}
+    h_spec = kernel[(1, )](x, out, BLOCK=128, spec_constants={0: 2.0, 1: True})
+    torch.testing.assert_close(out, -2 * x)
+    # the values of the constants don't recompile the kernel
+    assert h_spec.metadata.hash == h.metadata.hash
+    with pytest.raises(KeyError):
+        kernel[(1, )](x, out, BLOCK=128, spec_constants={2: 0})
+
+
 def test_if_else(device):
 
     @triton.jit
@@ -4064,6 +4336,50 @@ def test_smid(device):
     assert h.asm["ptx"].count("%smid") == 1
 
 
+def test_intel_clock(device):
+    if not is_xpu(device):
+        pytest.skip("test_intel_clock is only supported on XPU")
+
+    @triton.jit
+    def kernel(Out1, Out2):
+        start = tl.extra.intel.clock()
+        off = tl.arange(0, 128)
+        for i in range(10000):
+            tl.store(Out1 + off, tl.load(Out1 + off) + 1)
+        end = tl.extra.intel.clock()
+        tl.store(Out2, end - start)
+
+    out1 = to_triton(np.zeros((128, ), dtype=np.int64), device=device)
+    out2 = to_triton(np.zeros((1, ), dtype=np.int64), device=device)
+    h = kernel[(1, )](out1, out2)
+    assert out2[0] > 0
+    assert h.asm["ttgir"].count("__spirv_ReadClockKHR") == 2
+
+
+def test_intel_sub_group(device):
+    if not is_xpu(device):
+        pytest.skip("test_intel_sub_group is only supported on XPU")
+
+    @triton.jit
+    def kernel(X, Shuffle, Ballot, Size):
+        off = tl.arange(0, 16)
+        x = tl.load(X + off)
+        lane = tl.extra.intel.sub_group_local_id()
+        size = tl.extra.intel.sub_group_size()
+        tl.store(Shuffle + off, tl.extra.intel.sub_group_shuffle(x, (lane + 1) % size))
+        tl.store(Ballot + off, tl.extra.intel.ballot(x % 2 == 0))
+        tl.store(Size + off, size)
+
+    x = torch.arange(16, dtype=torch.int32, device=device)
+    shuffle = torch.empty_like(x)
+    ballot = torch.empty_like(x)
+    size = torch.empty_like(x)
+    kernel[(1, )](x, shuffle, ballot, size, num_warps=1, threads_per_warp=16)
+    assert torch.all(size == 16)
+    assert torch.equal(shuffle, torch.roll(x, -1))
+    assert torch.all(ballot == 0x5555)
+
+
 # -----------------------
 # test layout conversions
 # -----------------------
@@ -4588,6 +4904,76 @@ def test_sort(M, N, descending, dtype_str, device):
     assert (y == z).all(), (y, z)
 
 
+@pytest.mark.parametrize("M, N, K", [[1, 512, 16], [8, 64, 8], [256, 16, 16], [512, 8, 1]])
+@pytest.mark.parametrize("dtype_str", ['int32', 'float16', 'bfloat16', 'float32'])
+def test_topk(M, N, K, dtype_str, device):
+    if is_hip():
+        pytest.skip('test_topk for HIP currently broken in https://github.com/openai/triton')
+
+    @triton.jit
+    def topk_kernel(X, Z, N: tl.constexpr, M: tl.constexpr, K: tl.constexpr):
+        offx = tl.arange(0, M)
+        offy = tl.arange(0, N) * M
+        x = tl.load(X + offx[None, :] + offy[:, None])
+        z = tl.topk(x, K)
+        offz = tl.arange(0, K)[None, :] + (tl.arange(0, N) * K)[:, None]
+        tl.store(Z + offz, z)
+
+    if dtype_str == 'bfloat16':
+        x = torch.randn((N, M), device=device, dtype=torch.bfloat16)
+    else:
+        x = torch.from_numpy(numpy_random((N, M), dtype_str=dtype_str)).to(device)
+    y = torch.topk(x, K, dim=1)[0]
+    z = torch.empty((N, K), dtype=x.dtype, device=device)
+    topk_kernel[(1, )](x, z, N, M, K, num_warps=8)
+    assert (y == z).all(), (y, z)
+
+
+@pytest.mark.parametrize("M, N", [[1, 128], [16, 16], [64, 32]])
+@pytest.mark.parametrize("dtype_str", ['int32', 'float16', 'float32'])
+def test_local_buffer(M, N, dtype_str, device):
+
+    @triton.jit
+    def transpose_kernel(X, Z, ITERS, M: tl.constexpr, N: tl.constexpr):
+        offm = tl.arange(0, M)
+        offn = tl.arange(0, N)
+        buffer = tl.local_buffer((M, N), X.dtype.element_ty)
+        # The buffer is written again after being read by the other threads.
+        for i in range(ITERS):
+            buffer.store(tl.load(X + i * M * N + offm[:, None] * N + offn[None, :]))
+            z = buffer.load(offm[None, :] * N + offn[:, None])
+            tl.store(Z + i * M * N + offn[:, None] * M + offm[None, :], z)
+
+    x = torch.from_numpy(numpy_random((3, M, N), dtype_str=dtype_str)).to(device)
+    z = torch.empty((3, N, M), dtype=x.dtype, device=device)
+    transpose_kernel[(1, )](x, z, 3, M, N, num_warps=4)
+    assert (x.transpose(1, 2) == z).all()
+
+
+@pytest.mark.parametrize("num_programs", [1, 4, 16])
+def test_grid_barrier(num_programs, device):
+
+    @triton.jit
+    def rotate_kernel(X, ITERS, BLOCK: tl.constexpr):
+        pid = tl.program_id(0)
+        num_programs = tl.num_programs(0)
+        off = tl.arange(0, BLOCK)
+        # Each program takes the block of the next one, the barriers keep the
+        # blocks from being overwritten before being read.
+        for i in range(ITERS):
+            x = tl.load(X + ((pid + 1) % num_programs) * BLOCK + off)
+            tl.grid_barrier()
+            tl.store(X + pid * BLOCK + off, x + 1)
+            tl.grid_barrier()
+
+    BLOCK = 128
+    iters = 5
+    x = torch.arange(num_programs * BLOCK, dtype=torch.int32, device=device)
+    expected = torch.roll(x.reshape(num_programs, BLOCK), -iters, 0).flatten() + iters
+    rotate_kernel[(num_programs, )](x, iters, BLOCK=BLOCK, num_warps=4)
+    assert (x == expected).all()
+
+
 @pytest.mark.parametrize("M, N", [[1, 512], [8, 64], [256, 16], [512, 8]])
 @pytest.mark.parametrize("dtype_str", ['int32', 'float16', 'float32'])
 def test_flip(M, N, dtype_str, device):
@@ -144,6 +144,33 @@ def test_randint(size, seed, device, dtype):
     assert out_tri == out_ref
 
 
+# test the words of the counters used by tl.rand
+
+
+@pytest.mark.parametrize('size, seed', [(size, seed)
+                                        for size in ['10', '4,53', '400']
+                                        for seed in [0, 42, 124, 54, 0xffffffff, 0x0000000fcafeb0ba]])
+def test_philox_words(size, seed, device):
+    size = list(map(int, size.split(',')))
+
+    @triton.jit
+    def kernel(X, N, seed):
+        offset = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+        rand = tl.random.philox_words(seed, offset, 10)
+        tl.store(X + offset, rand, mask=offset < N)
+
+    # triton result
+    x = torch.empty(size, dtype=torch.int32, device=device)
+    N = x.numel()
+    grid = (triton.cdiv(N, BLOCK), )
+    kernel[grid](x, N, seed)
+    out_tri = x.cpu().numpy().astype(np.uint32).flatten().tolist()
+    # reference result, the consecutive words of the consecutive counters
+    gen = CustomPhilox(seed, config=PHILOX_32)
+    out_ref = [gen.random_raw() for _ in out_tri]
+    assert out_tri == out_ref
+
+
 # test uniform PRNG
 
 
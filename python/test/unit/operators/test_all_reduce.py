@@ -0,0 +1,53 @@
+import multiprocessing
+
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.ops
+
+
+def _run_rank(rank, world_size, init_file, N, dtype, results):
+    import torch.distributed as dist
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+    torch.xpu.set_device(rank)
+    dist.init_process_group("gloo", init_method=f"file://{init_file}", rank=rank, world_size=world_size)
+    dtype = getattr(torch, dtype)
+    all_reduce = triton.ops.AllReduce(rank, world_size, (N, ), dtype)
+    # the buffers are reused across the calls
+    for step in range(3):
+        x = torch.full((N, ), rank + step, dtype=dtype, device='xpu')
+        y = all_reduce(x)
+    torch.xpu.synchronize()
+    results.put((rank, y.cpu()))
+    dist.barrier()
+    all_reduce.close()
+    dist.destroy_process_group()
+
+
+# a single tile, and more tiles than programs
+@pytest.mark.parametrize("N", [1000, 1 << 22])
+@pytest.mark.parametrize("dtype", ["float16", "float32"])
+def test_op(N, dtype, tmp_path):
+    world_size = torch.xpu.device_count()
+    if world_size < 2:
+        pytest.skip("needs at least 2 devices")
+    ctx = multiprocessing.get_context("spawn")
+    results = ctx.Queue()
+    procs = [
+        ctx.Process(target=_run_rank, args=(rank, world_size, tmp_path / "init", N, dtype, results))
+        for rank in range(world_size)
+    ]
+    for proc in procs:
+        proc.start()
+    outputs = dict(results.get(timeout=300) for _ in procs)
+    for proc in procs:
+        proc.join()
+        assert proc.exitcode == 0
+    expected = sum(rank + 2 for rank in range(world_size))
+    for y in outputs.values():
+        assert torch.all(y.float() == expected)
+        # all the ranks get the same result
+        assert torch.equal(y, outputs[0])
@@ -92,6 +92,21 @@ def test_matmul(MODE, TRANS_A, TRANS_B, BLOCK, DTYPE, device, Z=3, H=2, M=512, N
     torch.testing.assert_close(db_ref, db_tri)
 
 
+def test_dsd_lut_longest_first(device):
+    # the headers of the DSD lookup table are sorted by decreasing reduction length
+    from triton.ops.blocksparse.matmul import dsd_lut
+    torch.random.manual_seed(0)
+    layout = torch.randint(2, (2, 8, 8))
+    layout[:, :, 0] = 1
+    lut, width = dsd_lut(layout, 16, 16, False, device)
+    header = lut[:4 * width].view(width, 4).cpu()
+    segments = header[:, 1]
+    assert torch.all(segments[:-1] >= segments[1:])
+    # every (column, head) pair is still covered exactly once
+    pairs = sorted(zip(header[:, 2].tolist(), header[:, 3].tolist()))
+    assert len(pairs) == len(set(pairs))
+
+
 configs = [
     (16, 256),
     (32, 576),
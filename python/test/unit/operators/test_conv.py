@@ -0,0 +1,32 @@
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.language as tl
+import triton.ops
+
+
+@triton.jit
+def _relu(y, pixels, channels):
+    return tl.maximum(y, 0.)
+
+
+@pytest.mark.parametrize("N, C, H, W, K, R, S, stride, padding, dilation", [
+    (2, 64, 28, 28, 128, 3, 3, 1, 1, 1),
+    (1, 3, 56, 56, 64, 7, 7, 2, 3, 1),
+    (4, 128, 14, 14, 256, 1, 1, 1, 0, 1),
+    (2, 48, 17, 19, 40, 3, 5, (2, 1), (1, 2), 1),
+    (1, 32, 16, 16, 32, 3, 3, 1, 2, 2),
+])
+@pytest.mark.parametrize("dtype", ['float16', 'float32'])
+def test_op(N, C, H, W, K, R, S, stride, padding, dilation, dtype, device):
+    torch.manual_seed(0)
+    dtype = getattr(torch, dtype)
+    x = torch.randn((N, C, H, W), dtype=dtype, device=device).to(memory_format=torch.channels_last)
+    w = torch.randn((K, C, R, S), dtype=dtype, device=device).to(memory_format=torch.channels_last) / (C * R * S)**0.5
+    bias = torch.randn(K, dtype=dtype, device=device)
+    tt_y = triton.ops.conv(x, w, bias, stride, padding, dilation, True, _relu)
+    th_y = torch.relu(torch.nn.functional.conv2d(x.float(), w.float(), bias.float(), stride, padding, dilation))
+    assert tt_y.is_contiguous(memory_format=torch.channels_last)
+    torch.testing.assert_close(th_y.to(dtype), tt_y, atol=1e-2, rtol=1e-2)
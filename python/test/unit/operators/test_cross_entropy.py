@@ -42,3 +42,20 @@ def test_op(M, N, dtype, mode, device):
             torch.testing.assert_close(th_dx, tt_dx, rtol=0.001, atol=0.001)
         else:
             torch.testing.assert_close(th_dx, tt_dx)
+
+
+@pytest.mark.parametrize("N", [131072, 262144 + 17])
+def test_large_vocab(N, device):
+    # the rows are streamed in tiles rather than held in a single block
+    M = 8
+    x = torch.randn(M, N, dtype=torch.float32, device=device, requires_grad=True)
+    idx = torch.randint(0, N, (M, ), dtype=torch.int64, device=device)
+    dy = torch.randn(M, dtype=torch.float32, device=device)
+    tt_y = triton.ops.cross_entropy(x, idx)
+    tt_y.backward(dy)
+    tt_dx = x.grad.clone()
+    x.grad = None
+    th_y = torch.nn.CrossEntropyLoss(reduction="none")(x, idx)
+    th_y.backward(dy)
+    torch.testing.assert_close(th_y, tt_y)
+    torch.testing.assert_close(x.grad, tt_dx)
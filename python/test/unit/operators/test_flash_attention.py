@@ -69,6 +69,41 @@ def test_op(Z, H, N_CTX, D_HEAD, dtype, causal, seq_par, device):
                                torch.nn.functional.normalize(torch.flatten(tri_dq), dim=0), atol=atol, rtol=0)
 
 
+@pytest.mark.parametrize('Z, H, H_KV, N_CTX, D_HEAD', [  #
+    (2, 8, 2, 512, 16),
+    (2, 8, 1, 512, 16),
+])
+@pytest.mark.parametrize('causal', [True, False])
+def test_op_gqa(Z, H, H_KV, N_CTX, D_HEAD, causal, device):
+    dtype = torch.float16
+    torch.manual_seed(20)
+    q = torch.empty((Z, H, N_CTX, D_HEAD), dtype=dtype, device=device).normal_(mean=0., std=0.5).requires_grad_()
+    k = torch.empty((Z, H_KV, N_CTX, D_HEAD), dtype=dtype, device=device).normal_(mean=0., std=0.5).requires_grad_()
+    v = torch.empty((Z, H_KV, N_CTX, D_HEAD), dtype=dtype, device=device).normal_(mean=0., std=0.5).requires_grad_()
+    sm_scale = 0.5
+    dout = torch.randn_like(q)
+    # reference implementation on the key/value heads shared by each group
+    M = torch.tril(torch.ones((N_CTX, N_CTX), device=device))
+    p = torch.matmul(q, k.repeat_interleave(H // H_KV, dim=1).transpose(2, 3)) * sm_scale
+    if causal:
+        p[:, :, M == 0] = float("-inf")
+    p = torch.softmax(p.float(), dim=-1).to(dtype)
+    ref_out = torch.matmul(p, v.repeat_interleave(H // H_KV, dim=1))
+    ref_out.backward(dout)
+    ref_dv, v.grad = v.grad.clone(), None
+    ref_dk, k.grad = k.grad.clone(), None
+    ref_dq, q.grad = q.grad.clone(), None
+    # triton implementation
+    tri_out = triton.ops.attention(q, k, v, causal, sm_scale)
+    tri_out.backward(dout)
+    tri_dv, v.grad = v.grad.clone(), None
+    tri_dk, k.grad = k.grad.clone(), None
+    tri_dq, q.grad = q.grad.clone(), None
+    # compare
+    for ref, tri in [(ref_out, tri_out), (ref_dv, tri_dv), (ref_dk, tri_dk), (ref_dq, tri_dq)]:
+        torch.testing.assert_close(torch.nn.functional.normalize(torch.flatten(ref), dim=0),
+                                   torch.nn.functional.normalize(torch.flatten(tri), dim=0), atol=1e-2, rtol=0)
+
 try:
     from flash_attn.flash_attn_interface import flash_attn_func
     HAS_FLASH = True
@@ -72,6 +72,8 @@ import triton.ops
             ("float8e4b15", "float8e4b15"),
             ("float8e4nv", "float16"),
             ("float16", "float8e5"),
+            ("bfloat16", "float8e4nv"),
+            ("float8e5", "bfloat16"),
             ("int8", "bfloat16"),
             ("float16", "int8"),
             ("float16", "float32"),
@@ -202,3 +204,142 @@ def test_op(BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K, NWARP, NSTAGE, M, N, K, AT, BT,
         torch.testing.assert_close(th_c, tt_c)
     except triton.OutOfResources as e:
         pytest.skip(str(e))
+
+
+@pytest.mark.parametrize("BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K, NWARP, ADTYPE, BDTYPE", [
+    (64, 64, 32, 1, 4, "int8", "int8"),
+    (64, 64, 32, 2, 4, "int8", "int8"),
+    (64, 64, 32, 1, 4, "float16", "int8"),
+    (64, 64, 32, 1, 4, "bfloat16", "int8"),
+])
+def test_op_scale(BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K, NWARP, ADTYPE, BDTYPE):
+    torch.manual_seed(0)
+    kwargs = {'BLOCK_M': BLOCK_M, 'BLOCK_N': BLOCK_N, 'BLOCK_K': BLOCK_K, 'SPLIT_K': SPLIT_K}
+    pre_hook = None if SPLIT_K == 1 else lambda nargs: nargs['C'].zero_()
+    configs = [triton.Config(kwargs=kwargs, num_warps=NWARP, num_stages=2, pre_hook=pre_hook)]
+    kernel = triton.ops._matmul.kernel
+    kernel.configs = configs
+
+    M, N, K = 2 * BLOCK_M, 2 * BLOCK_N, 4 * BLOCK_K * SPLIT_K
+
+    def init_input(m, n, dtype):
+        if dtype == "int8":
+            return torch.randint(-8, 8, (m, n), device="xpu", dtype=torch.int8)
+        exponents = torch.randint(-4, 0, size=(m, n))
+        return (2.**exponents).to(getattr(torch, dtype)).to("xpu")
+
+    a = init_input(M, K, ADTYPE)
+    b = init_input(K, N, BDTYPE)
+    # per output channel scales of the quantized weights
+    scale = (2.**torch.randint(-4, 0, size=(N, ))).to(torch.float32).to("xpu")
+    tt_c = triton.ops.matmul(a, b, None, True, True, None, scale)
+    th_c = torch.matmul(a.to(torch.float32), b.to(torch.float32)) * scale[None, :]
+    torch.testing.assert_close(th_c.to(tt_c.dtype), tt_c)
+
+
+
+@triton.jit
+def _dequantize_rows(a, rows, cols, Scale):
+    return a.to(tl.float16) * tl.load(Scale + rows)[:, None]
+
+
+@triton.jit
+def _bias_relu_residual(c, rows, cols, Bias, Residual, N):
+    # the product is square
+    mask = (rows[:, None] < N) & (cols[None, :] < N)
+    bias = tl.load(Bias + cols, mask=cols < N, other=0.)
+    residual = tl.load(Residual + rows[:, None] * N + cols[None, :], mask=mask, other=0.)
+    return tl.maximum(c + bias[None, :], 0.) + residual
+
+
+@pytest.mark.parametrize("SPLIT_K, K", [(1, 128), (1, 100), (2, 128)])
+def test_op_fused(SPLIT_K, K):
+    torch.manual_seed(0)
+    kwargs = {'BLOCK_M': 64, 'BLOCK_N': 64, 'BLOCK_K': 32, 'SPLIT_K': SPLIT_K}
+    pre_hook = None if SPLIT_K == 1 else lambda nargs: nargs['C'].zero_()
+    kernel = triton.ops._matmul.kernel
+    # the split-k config is pruned for the epilogue
+    kernel.configs = [
+        triton.Config(kwargs=kwargs, num_warps=4, num_stages=2, pre_hook=pre_hook),
+        triton.Config(kwargs={**kwargs, 'SPLIT_K': 1}, num_warps=4, num_stages=2),
+    ]
+
+    M = N = 96
+    a = torch.randint(-8, 8, (M, K), device="xpu", dtype=torch.int8)
+    b = (2.**torch.randint(-4, 0, size=(K, N))).to(torch.float16).to("xpu")
+    a_scale = (2.**torch.randint(-4, 0, size=(M, ))).to(torch.float16).to("xpu")
+    bias = torch.randn(N, device="xpu", dtype=torch.float32)
+    residual = torch.randn((M, N), device="xpu", dtype=torch.float32)
+    tt_c = triton.ops.matmul(a, b, output_dtype=torch.float32, prologue_fn=_dequantize_rows, prologue_args=(a_scale, ),
+                             epilogue_fn=_bias_relu_residual, epilogue_args=(bias, residual, N))
+    th_a = a.to(torch.float32) * a_scale.to(torch.float32)[:, None]
+    th_c = torch.relu(torch.matmul(th_a, b.to(torch.float32)) + bias[None, :]) + residual
+    torch.testing.assert_close(th_c, tt_c)
+
+def test_perf_model():
+    from triton.ops.matmul_perf_model import early_config_prune, estimate_matmul_time
+    kwargs = {'BLOCK_M': 128, 'BLOCK_N': 128, 'BLOCK_K': 32, 'SPLIT_K': 1}
+    configs = [triton.Config(kwargs=kwargs, num_warps=8, num_stages=num_stages) for num_stages in [2, 3, 4, 5]]
+    a = torch.empty((512, 512), device="xpu", dtype=torch.float16)
+    # At most two numbers of stages are kept around the one hiding the load latency.
+    assert 0 < len(early_config_prune(configs, {'A': a})) <= 2
+    assert estimate_matmul_time(num_warps=8, num_stages=3, A=a, B=a, C=a, M=512, N=512, K=512, **kwargs) > 0
+
+
+def test_group_m():
+    # operands fitting in the L3 aren't swizzled
+    assert triton.ops.get_group_m(256, 256, 256, 128, 128, 2) == 1
+    # the groups are powers of two of at most the rows of tiles
+    M, N, K = 16384, 16384, 4096
+    group_m = triton.ops.get_group_m(M, N, K, 256, 256, 2)
+    assert group_m & (group_m - 1) == 0 and 1 <= group_m <= M // 256
+    assert triton.ops.get_group_m(256, N, K, 256, 256, 2) == 1
+
+
+@pytest.mark.parametrize("M, N, K, DTYPE", [
+    # fewer tiles than Xe-cores
+    (64, 64, 8192, "float16"),
+    (128, 256, 4096, "bfloat16"),
+    # K not a multiple of BLOCK_K
+    (200, 136, 1000, "float16"),
+    (512, 512, 512, "float16"),
+])
+def test_op_streamk(M, N, K, DTYPE):
+    torch.manual_seed(0)
+    kernel = triton.ops._matmul_streamk.kernel
+    kernel.configs = [triton.Config({'BLOCK_M': 64, 'BLOCK_N': 64, 'BLOCK_K': 32}, num_stages=2, num_warps=4)]
+
+    # powers of two, whose products and sums are exact
+    def init_input(m, n):
+        exponents = torch.randint(-4, 0, size=(m, n))
+        return (2.**exponents).to(getattr(torch, DTYPE)).to("xpu")
+
+    a = init_input(M, K)
+    b = init_input(K, N)
+    tt_c = triton.ops.matmul_streamk(a, b)
+    th_c = torch.matmul(a.to(torch.float32), b.to(torch.float32))
+    torch.testing.assert_close(th_c.to(tt_c.dtype), tt_c)
+    # The partial sums are reduced in a fixed order.
+    assert torch.equal(triton.ops.matmul_streamk(a, b), tt_c)
+
+
+@pytest.mark.parametrize("SHAPES, DTYPE", [
+    # experts with few tokens
+    ([(16, 256, 128), (48, 256, 128), (1, 256, 128), (100, 256, 128)], "float16"),
+    # an expert without tokens
+    ([(64, 512, 256), (0, 512, 256), (200, 512, 256)], "bfloat16"),
+    # different shapes, K not a multiple of BLOCK_K
+    ([(128, 64, 96), (33, 200, 1000), (512, 128, 64)], "float16"),
+])
+def test_op_grouped(SHAPES, DTYPE):
+    torch.manual_seed(0)
+    kernel = triton.ops._grouped_matmul.kernel
+    kernel.configs = [triton.Config({'BLOCK_M': 64, 'BLOCK_N': 64, 'BLOCK_K': 32}, num_stages=2, num_warps=4)]
+    dtype = getattr(torch, DTYPE)
+    a = [torch.randn((M, K), dtype=dtype, device="xpu") for M, N, K in SHAPES]
+    b = [torch.randn((K, N), dtype=dtype, device="xpu").t().contiguous().t() for M, N, K in SHAPES]
+    tt_c = triton.ops.grouped_matmul(a, b)
+    assert len(tt_c) == len(SHAPES)
+    for x, y, z in zip(a, b, tt_c):
+        th_c = torch.matmul(x.to(torch.float32), y.to(torch.float32))
+        torch.testing.assert_close(th_c.to(z.dtype), z, rtol=1e-2, atol=1e-1)
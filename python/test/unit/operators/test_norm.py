@@ -0,0 +1,71 @@
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.ops
+
+
+def _ref_norm(x, weight, bias, eps, is_rms):
+    x = x.float()
+    if is_rms:
+        y = x * torch.rsqrt(x.pow(2).mean(-1, keepdim=True) + eps)
+    else:
+        y = torch.nn.functional.layer_norm(x, x.shape[-1:], eps=eps)
+    y = y * weight.float()
+    return y if bias is None else y + bias.float()
+
+
+# the rows of a tile, of several tiles in SLM, and of several tiles too long
+# for SLM
+@pytest.mark.parametrize("M, N", [(128, 768), (64, 1000), (16, 12288), (4, 40000)])
+@pytest.mark.parametrize("norm", ["layer", "rms"])
+@pytest.mark.parametrize("with_residual", [False, True])
+@pytest.mark.parametrize("dtype", ["float16", "float32"])
+def test_op(M, N, norm, with_residual, dtype, device):
+    torch.manual_seed(0)
+    dtype = getattr(torch, dtype)
+    is_rms = norm == "rms"
+    x = torch.randn((M, N), dtype=dtype, device=device, requires_grad=True)
+    residual = torch.randn((M, N), dtype=dtype, device=device, requires_grad=True) if with_residual else None
+    weight = torch.rand(N, dtype=dtype, device=device, requires_grad=True)
+    bias = None if is_rms else torch.randn(N, dtype=dtype, device=device, requires_grad=True)
+    if is_rms:
+        outputs = triton.ops.rms_norm(x, weight, 1e-6, residual)
+    else:
+        outputs = triton.ops.layer_norm(x, weight, bias, 1e-5, residual)
+    tt_y, tt_h = outputs if with_residual else (outputs, None)
+    h = x if residual is None else x + residual
+    th_y = _ref_norm(h, weight, bias, 1e-6 if is_rms else 1e-5, is_rms)
+    torch.testing.assert_close(th_y.to(dtype), tt_y, atol=1e-2, rtol=1e-2)
+    if with_residual:
+        torch.testing.assert_close(h, tt_h)
+    # backward pass
+    dy = torch.randn_like(tt_y)
+    params = [x, weight] + ([] if bias is None else [bias]) + ([] if residual is None else [residual])
+    tt_grads = torch.autograd.grad(tt_y, params, dy)
+    th_grads = torch.autograd.grad(th_y, params, dy.float())
+    for tt_grad, th_grad in zip(tt_grads, th_grads):
+        torch.testing.assert_close(th_grad.to(dtype), tt_grad, atol=5e-2, rtol=1e-2)
+
+
+@pytest.mark.parametrize("N", [4096, 12288])
+@pytest.mark.parametrize("quantize", ["int8", "fp8"])
+def test_op_quantize(N, quantize, device):
+    if triton.ops.norm.QUANT_DTYPES[quantize] is None:
+        pytest.skip(f"torch doesn't support {quantize}")
+    torch.manual_seed(0)
+    M = 32
+    x = torch.randn((M, N), dtype=torch.float16, device=device)
+    weight = torch.rand(N, dtype=torch.float16, device=device)
+    tt_q, tt_scale = triton.ops.rms_norm(x, weight, quantize=quantize)
+    th_y = _ref_norm(x, weight, None, 1e-6, True)
+    th_scale = th_y.abs().amax(-1) / triton.ops.norm.QUANT_MAX[quantize]
+    torch.testing.assert_close(th_scale, tt_scale, atol=1e-4, rtol=1e-3)
+    # the values are within the rounding of the quantized type
+    tt_y = tt_q.float() * tt_scale[:, None]
+    if quantize == "int8":
+        atol, rtol = tt_scale[:, None] * 0.51, 1e-3
+    else:
+        atol, rtol = tt_scale[:, None] * 2**-6, 2**-4
+    assert torch.all((tt_y - th_y).abs() <= atol + rtol * th_y.abs())
@@ -0,0 +1,25 @@
+import pytest
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.ops
+
+
+@pytest.mark.parametrize("shape, dim, op, single_launch, num_splits", [
+    (shape, dim, op, single_launch, num_splits)
+    for shape, dim in [((4, 1 << 20), -1), ((3, 100003), 1), ((65537, 2), 0)]
+    for op in ["sum", "max", "min", "argmax", "argmin"]
+    for single_launch in [True, False]
+    for num_splits in [None, 1]
+])
+def test_op(shape, dim, op, single_launch, num_splits, device):
+    x = torch.randn(shape, dtype=torch.float32, device=device)
+    tt_y = triton.ops.split_reduce(x, dim=dim, op=op, single_launch=single_launch, num_splits=num_splits)
+    th_y = {
+        "sum": torch.sum, "max": torch.amax, "min": torch.amin, "argmax": torch.argmax, "argmin": torch.argmin
+    }[op](x, dim=dim)
+    if op in ("argmax", "argmin"):
+        torch.testing.assert_close(tt_y, th_y, rtol=0, atol=0)
+    else:
+        torch.testing.assert_close(tt_y, th_y, rtol=1e-4, atol=1e-2)
@@ -25,6 +25,25 @@ def test_kwargs():
     _kernel[grid](dst=dst, src=src, N=N)
 
 
+def test_bucket():
+    src = torch.arange(1024, dtype=torch.float32, device='xpu')
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 32}), triton.Config(kwargs={'BLOCK_SIZE': 128})]
+
+    @triton.autotune(configs=configs, key=['N'], bucket={'N': 256}, warmup=1, rep=1)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    for N in [1000, 800, 1024, 300]:
+        dst = torch.zeros_like(src)
+        _kernel[lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )](dst, src, N)
+        assert torch.equal(dst[:N], src[:N]) and torch.all(dst[N:] == 0)
+    # tuned once per multiple of 256 the sizes are rounded up to
+    assert sorted(key[0] for key in _kernel.cache) == [512, 1024]
+
+
 def test_restore():
     N = 1024
     src = torch.zeros(N, device='xpu')
@@ -80,3 +99,275 @@ def test_prune_configs(with_perf_model: bool):
         assert records['run_perf_model']
     else:
         assert records['run_early_config_prune']
+
+
+def test_prune_spilling_configs():
+    N = 1024
+    src = torch.empty(N, device='xpu')
+    dst = torch.empty(N, device='xpu')
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 32}), triton.Config(kwargs={'BLOCK_SIZE': 128})]
+
+    # No kernel spills less than nothing, so every config must be discarded.
+    @triton.autotune(configs=configs, key=['N'], prune_configs_by={'max_spills': -1}, warmup=1, rep=1)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    assert all(timing[0] == float('inf') for timing in _kernel.configs_timings.values())
+
+
+def test_precompile():
+    N = 1024
+    src = torch.empty(N, device='xpu')
+    dst = torch.empty(N, device='xpu')
+    device = torch.xpu.current_device()
+    compiled = []
+
+    def pre_hook(nargs):
+        compiled.append(len(_kernel.fn.cache[device]))
+
+    configs = [
+        triton.Config(kwargs={'BLOCK_SIZE': 32}, pre_hook=pre_hook),
+        triton.Config(kwargs={'BLOCK_SIZE': 128}, pre_hook=pre_hook)
+    ]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=1)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    # Both configs are compiled before the first one is benchmarked.
+    assert compiled[0] == len(configs)
+
+
+def test_out_of_shared_memory():
+    N = 64
+    src = torch.empty((N, N), device='xpu')
+    dst = torch.empty(N, device='xpu')
+
+    @triton.jit
+    def _kernel(dst, src, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets[:, None] * BLOCK_SIZE + offsets[None, :])
+        tl.store(dst + offsets, tl.sum(x, axis=0))
+
+    # The reduction across warps needs shared memory, so the kernel is rejected
+    # at compile time, before being lowered.
+    with pytest.raises(triton.OutOfResources):
+        _kernel[(1, )](dst, src, BLOCK_SIZE=N, max_shared_mem=1)
+
+
+def test_cache_results(tmp_path, monkeypatch):
+    monkeypatch.setenv("TRITON_CACHE_DIR", str(tmp_path / "cache"))
+    N = 1024
+    src = torch.empty(N, device='xpu')
+    dst = torch.empty(N, device='xpu')
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 32}), triton.Config(kwargs={'BLOCK_SIZE': 128})]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=1, cache_results=True)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    best_config = _kernel.best_config
+    _kernel.export_results(tmp_path / "results.json")
+
+    # A new process reuses the stored config without benchmarking.
+    _kernel.cache.clear()
+    _kernel.configs_timings = None
+    _kernel[grid](dst, src, N)
+    assert _kernel.configs_timings is None
+    assert _kernel.best_config is best_config
+
+    # So does a process on another node importing the results.
+    monkeypatch.setenv("TRITON_CACHE_DIR", str(tmp_path / "other_cache"))
+    _kernel.cache.clear()
+    _kernel.import_results(tmp_path / "results.json")
+    _kernel[grid](dst, src, N)
+    assert _kernel.configs_timings is None
+    assert _kernel.best_config is best_config
+
+
+def test_grf_mode():
+    N = 1024
+    src = torch.empty(N, device='xpu')
+    dst = torch.empty(N, device='xpu')
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 128}), triton.Config(kwargs={'BLOCK_SIZE': 128}, grf_mode="large")]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=1)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    torch.testing.assert_close(dst, src)
+    # The GRF mode is forwarded to the driver as a build flag.
+    kernels = _kernel.fn.cache[triton.runtime.driver.active.get_current_device()].values()
+    build_flags = sorted(kernel.metadata.build_flags for kernel in kernels)
+    assert build_flags == ["", "-ze-opt-large-register-file"]
+
+
+def test_collect_metrics(monkeypatch):
+    N = 1024
+    src = torch.empty(N, device='xpu')
+    dst = torch.empty(N, device='xpu')
+
+    # The counters are only exposed with ZET_ENABLE_METRICS=1, fake them.
+    utils = triton.runtime.driver.active.utils
+    groups = []
+
+    def collect_metrics(fn, group):
+        groups.append(group)
+        fn()
+        return {"XVE_ACTIVE": 42.0}
+
+    monkeypatch.setattr(utils, "collect_metrics", collect_metrics, raising=False)
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 32}), triton.Config(kwargs={'BLOCK_SIZE': 128})]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=1, collect_metrics="ComputeBasic")
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    assert groups == ["ComputeBasic"] * len(configs)
+    assert set(_kernel.configs_metrics.keys()) == set(configs)
+    kernels = _kernel.fn.cache[triton.runtime.driver.active.get_current_device()].values()
+    assert all(kernel.metadata.metrics == {"XVE_ACTIVE": 42.0} for kernel in kernels)
+
+
+def test_resource_prune():
+    N = 1024
+    src = torch.empty(N, device='xpu')
+    dst = torch.empty(N, device='xpu')
+    records = []
+
+    def resource_prune(config, metadata):
+        records.append(metadata.resource_estimate)
+        return config.kwargs['BLOCK_SIZE'] == 128
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 32}), triton.Config(kwargs={'BLOCK_SIZE': 128})]
+
+    @triton.autotune(configs=configs, key=['N'], prune_configs_by={'resource_prune': resource_prune}, warmup=1, rep=1)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    torch.testing.assert_close(src, dst)
+    assert len(records) == 2
+    assert all(estimate["work_groups_per_xe_core"] > 0 for estimate in records)
+    assert [config.kwargs['BLOCK_SIZE'] for config in _kernel.configs_timings] == [128]
+
+
+def test_traffic():
+    N, K = 1024, 4
+    src = torch.rand((K, N), device='xpu')
+    dst = torch.empty(N, device='xpu')
+
+    @triton.jit
+    def _kernel(dst, src, N, K, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        acc = tl.zeros((BLOCK_SIZE, ), dtype=tl.float32)
+        for k in range(0, K):
+            acc += tl.load(src + k * N + offsets)
+        tl.store(dst + offsets, acc)
+
+    grid = (N // 128, )
+    kernel = _kernel[grid](dst, src, N, K, BLOCK_SIZE=128)
+    torch.testing.assert_close(src.sum(0), dst)
+    # The loop over K is counted K times, for each of the programs.
+    traffic = kernel.traffic(grid, {"dst": dst, "src": src, "N": N, "K": K})
+    assert traffic == {"bytes_read": K * N * 4, "bytes_written": N * 4, "flops": 0}
+
+
+def test_successive_halving(monkeypatch):
+    N = 1024
+    src = torch.empty(N, device='xpu')
+    dst = torch.empty(N, device='xpu')
+    reps = []
+
+    # The configs are timed in their order, the later ones being slower.
+    def do_bench(fn, warmup, rep, quantiles):
+        fn()
+        reps.append(rep)
+        return [float(len(reps))] * len(quantiles)
+
+    monkeypatch.setattr(triton.runtime.autotuner, "do_bench", do_bench)
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 2**i}) for i in range(5, 9)]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=100, successive_halving=True)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    torch.testing.assert_close(src, dst)
+    # The faster half runs again for the full time.
+    assert reps == [50] * 4 + [100] * 2
+    assert set(_kernel.configs_timings.keys()) == set(configs)
+    assert _kernel.best_config.kwargs['BLOCK_SIZE'] == 32
+
+
+def test_cost_model(tmp_path, monkeypatch):
+    from triton.runtime.cost_model import LearnedCostModel
+    reps = []
+
+    # The configs are timed in their order, the later ones being slower.
+    def do_bench(fn, warmup, rep, quantiles):
+        fn()
+        reps.append(rep)
+        return [float((len(reps) - 1) % 4 + 1)] * len(quantiles)
+
+    monkeypatch.setattr(triton.runtime.autotuner, "do_bench", do_bench)
+
+    path = tmp_path / "cost_model.json"
+    model = LearnedCostModel(path, top_k=1, min_samples=8)
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 2**i}) for i in range(5, 9)]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=1, prune_configs_by={'cost_model': model})
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    # The model learns from the benchmarks of the first shapes.
+    for N in [1024, 4096, 2048]:
+        src = torch.rand(N, device='xpu')
+        dst = torch.empty(N, device='xpu')
+        _kernel[lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )](dst, src, N)
+        torch.testing.assert_close(src, dst)
+    assert len(reps) == 8
+    assert _kernel.best_config.kwargs['BLOCK_SIZE'] == 32
+    # The samples are stored for the next processes.
+    assert [len(samples) for samples in LearnedCostModel(path).samples.values()] == [8]
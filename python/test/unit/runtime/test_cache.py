@@ -1,7 +1,9 @@
 import importlib.util
+import json
 import os
 import shutil
 import tempfile
+from pathlib import Path
 
 import pytest
 import torch
@@ -80,6 +82,16 @@ def write_and_load_module(code, num_extra_lines):
     return module
 
 
+def test_parse_cached():
+    tree = function_1.parse()
+    assert function_1.parse() is tree
+    function_1.src = function_1.src.replace('i + 1', 'i + 2')
+    updated = function_1.parse()
+    function_1.src = function_1.src.replace('i + 2', 'i + 1')
+    assert updated is not tree
+    assert function_1.parse() is not updated
+
+
 def test_changed_line_numbers_invalidate_cache():
     from textwrap import dedent
     code = dedent("""
@@ -136,6 +148,80 @@ def test_specialize(mode):
     assert counter == target
 
 
+def test_larger_divisibility():
+
+    @triton.jit
+    def kernel(X, stride):
+        tl.store(X + stride, 1)
+
+    x = torch.empty(256, dtype=torch.int32, device='xpu')
+    device = torch.xpu.current_device()
+    kernel[(1, )](x, 16)
+    kernel[(1, )](x, 48)
+    k = kernel[(1, )](x, 64)
+    assert len(kernel.cache[device]) == 2
+    assert "tt.divisibility = 64" in k.asm["ttir"]
+
+
+def test_pointer_range_32(monkeypatch):
+
+    @triton.jit
+    def kernel(X, i):
+        tl.store(X + i.to(tl.int64), i)
+
+    x = torch.zeros(16, dtype=torch.int32, device='xpu')
+    device = torch.xpu.current_device()
+    k = kernel[(1, )](x, 3)
+    assert "tt.pointer_range = 32" in k.asm["ttir"]
+    assert x[3].item() == 3
+    # the kernels not specialized on it are distinct
+    monkeypatch.setattr(triton.runtime.JITFunction, "pointer_range_32", False)
+    k = kernel[(1, )](x, 5)
+    assert "tt.pointer_range" not in k.asm["ttir"]
+    assert len(kernel.cache[device]) == 2
+    assert x[5].item() == 5
+
+
+def test_async_compile():
+
+    @triton.jit
+    def kernel(X, i):
+        tl.store(X, i)
+
+    x = torch.zeros(1, dtype=torch.int32, device='xpu')
+    device = torch.xpu.current_device()
+    calls = []
+    # the first call falls back while the kernel compiles in the background
+    kernel[(1, )](x, 3, fallback=lambda X, i: calls.append(i))
+    assert calls == [3]
+    assert len(kernel.cache[device]) == 0
+    future, = kernel.pending[device].values()
+    future.result()
+    # once compiled, the kernel is launched
+    kernel[(1, )](x, 5, fallback=lambda X, i: calls.append(i))
+    assert calls == [3]
+    assert len(kernel.pending[device]) == 0
+    assert x.item() == 5
+    # without fallback, a miss returns the future of the kernel
+    future = kernel[(1, )](x, 16, async_compile=True)
+    assert future.result() is not None
+
+
+def test_bind_args():
+
+    @triton.jit
+    def kernel(X, i, j=2, BLOCK: tl.constexpr = 1):
+        tl.store(X, i + j + BLOCK)
+
+    x = torch.empty(1, dtype=torch.int32, device='xpu')
+    kernel[(1, )](x, 1)
+    assert x.item() == 4
+    kernel[(1, )](x, 1, BLOCK=4, j=3, num_warps=2)
+    assert x.item() == 8
+    with pytest.raises(TypeError):
+        kernel[(1, )](x, 1, unknown=1)
+
+
 def test_annotation():
 
     @triton.jit
@@ -258,3 +344,242 @@ def test_memory_leak() -> None:
         x0 = xindex
         tmp0 = tl.load(in_ptr0 + (x0), xmask)
         tl.store(out_ptr0 + (x0 + tl.zeros([XBLOCK], tl.int32)), tmp0, xmask)
+
+
+def test_compile_many() -> None:
+    reset_tmp_dir()
+    srcs = [
+        triton.compiler.ASTSource(fn=kernel, signature={0: "*i32", 1: "i32"}, constants={2: block})
+        for block in [128, 256, 512]
+    ]
+    kernels = triton.compile_many(srcs, max_workers=3)
+    assert [k.metadata.hash for k in kernels] == [triton.compile(src).metadata.hash for src in srcs]
+    assert len(set(k.metadata.hash for k in kernels)) == len(srcs)
+
+
+def test_reuse_mlir_context(monkeypatch) -> None:
+    reset_tmp_dir()
+    monkeypatch.setenv("TRITON_REUSE_MLIR_CONTEXT", "1")
+    free_contexts = triton.compiler.compiler._free_contexts
+    free_contexts.clear()
+    srcs = [
+        triton.compiler.ASTSource(fn=kernel, signature={0: "*i32", 1: "i32"}, constants={2: block})
+        for block in [32, 64]
+    ]
+    k0 = triton.compile(srcs[0])
+    contexts = [context for contexts in free_contexts.values() for context in contexts]
+    assert len(contexts) == 1
+    # The next compilation takes the context back.
+    k1 = triton.compile(srcs[1])
+    assert [context for contexts in free_contexts.values() for context in contexts] == contexts
+    assert "tt.func" in k0.asm["ttir"] and "tt.func" in k1.asm["ttir"]
+    assert k0.metadata.hash != k1.metadata.hash
+
+
+def test_reproducer_bundle(monkeypatch, tmp_path) -> None:
+    reset_tmp_dir()
+    monkeypatch.setenv("TRITON_REPRODUCER_DIR", str(tmp_path))
+    from triton.compiler import reproducer
+    src = triton.compiler.ASTSource(fn=kernel, signature={0: "*i32", 1: "i32"}, constants={2: 128})
+    k = triton.compile(src)
+    bundle = tmp_path / f"{src.name}-{k.metadata.hash}"
+    k._init_handles()
+    manifest = json.loads((bundle / "manifest.json").read_text())
+    assert manifest["env"]["TRITON_REPRODUCER_DIR"] == str(tmp_path)
+    assert list(manifest["stages"]) == ["ttir", "ttgir", "llir", "spv", "native"]
+    for stage, record in manifest["stages"].items():
+        assert record["status"] == "done"
+        assert (bundle / record["input"]).exists()
+    assert (bundle / "llir-unoptimized.llir").exists()
+    assert "build_flags" in manifest["stages"]["native"]
+    # the stages are replayed from their inputs
+    spv, _ = reproducer.replay(bundle, "spv")
+    assert spv == k.asm["spv"]
+
+
+def test_store_ir(monkeypatch) -> None:
+    reset_tmp_dir()
+    src = triton.compiler.ASTSource(fn=kernel, signature={0: "*i32", 1: "i32"}, constants={2: 128})
+    # only the binary by default
+    monkeypatch.setenv("TRITON_STORE_IR", "")
+    k = triton.compile(src)
+    assert "ttgir" not in k.asm and "ttir" not in k.asm
+    assert k.asm["spv"] == k.kernel
+    # the kernel is compiled again for the stages then asked for
+    monkeypatch.setenv("TRITON_STORE_IR", "ttgir,llir")
+    k = triton.compile(src)
+    assert "ttir" not in k.asm
+    assert "triton_gpu" in k.asm["ttgir"] and "define" in k.asm["llir"]
+    monkeypatch.setenv("TRITON_STORE_IR", "ttgir")
+    assert triton.compile(src).metadata.hash == k.metadata.hash
+
+
+def test_binary_deduplication() -> None:
+    reset_tmp_dir()
+    srcs = [
+        triton.compiler.ASTSource(fn=kernel, signature={0: "*i32", 1: "i32"}, constants={2: block})
+        for block in [32, 64]
+    ]
+    k0, k1 = [triton.compile(src) for src in srcs]
+    assert k0.metadata.hash != k1.metadata.hash
+    # BLOCK isn't used: both specializations share one binary and one kernel
+    assert k0.asm.files["spv"] == k1.asm.files["spv"]
+    k0._init_handles()
+    k1._init_handles()
+    assert k0.function == k1.function
+
+
+def test_adaptive_specialization(monkeypatch) -> None:
+    reset_tmp_dir()
+    monkeypatch.setattr(JITFunction, "adaptive_threshold", 3)
+
+    @triton.jit
+    def store_value(X, i):
+        tl.store(X, i)
+
+    x = torch.empty(1, dtype=torch.int32, device='xpu')
+    kernels = [store_value[(1, )](x, 7) for _ in range(3)]
+    assert len(set(kernels)) == 1
+    # the variant with i = 7 is compiled in the background after 3 launches
+    device = triton.runtime.driver.active.get_current_device()
+    variants, = store_value.adaptive[device].values()
+    variants.entries[((1, 7), )].result()
+    specialized = store_value[(1, )](x, 7)
+    assert specialized is not kernels[0]
+    assert list(specialized.metadata.ir_arg_names) == ["X"]
+    assert x.item() == 7
+    # the other values still launch the kernel of any value
+    assert store_value[(1, )](x, 8) is kernels[0]
+    assert x.item() == 8
+
+
+def test_bucket() -> None:
+    reset_tmp_dir()
+
+    @triton.jit(bucket={"N": "pow2", "BLOCK_N": "pow2"})
+    def copy_rows(X, Y, N, BLOCK_N: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_N)
+        mask = offsets < N
+        tl.store(Y + offsets, tl.load(X + offsets, mask=mask), mask=mask)
+
+    x = torch.arange(64, dtype=torch.float32, device='xpu')
+    kernels = set()
+    for n in [33, 40, 48, 63, 64]:
+        y = torch.zeros_like(x)
+        kernels.add(copy_rows[(1, )](x, y, n, BLOCK_N=n))
+        assert torch.equal(y[:n], x[:n]) and torch.all(y[n:] == 0)
+    # the sizes of (32, 64] share the kernel of BLOCK_N = 64, that isn't
+    # specialized on the divisibility of N
+    assert len(kernels) == 1
+    kernel, = kernels
+    assert list(kernel.metadata.ir_arg_names) == ["X", "Y", "N"]
+    copy_rows[(1, )](x, torch.zeros_like(x), 4, BLOCK_N=3)
+    device = triton.runtime.driver.active.get_current_device()
+    assert len(copy_rows.cache[device]) == 2
+    with pytest.raises(ValueError):
+        triton.jit(bucket={"M": "pow2"})(copy_rows.fn)
+
+
+def test_compile_timing(monkeypatch) -> None:
+    reset_tmp_dir()
+    monkeypatch.setenv("TRITON_ENABLE_COMPILE_TIMING", "1")
+    src = triton.compiler.ASTSource(fn=kernel, signature={0: "*i32", 1: "i32"}, constants={2: 128})
+    compile_times = dict(triton.compile(src).metadata.compile_times)
+    for name in ["tritongpu-coalesce", "convert-triton-gpu-to-llvm", "optimize_module", "translate_to_spirv"]:
+        assert compile_times[name] >= 0
+    # The timings are cached along with the kernel.
+    assert dict(triton.compile(src).metadata.compile_times) == compile_times
+
+
+def test_compile_cache_hit() -> None:
+    reset_tmp_dir()
+    src = triton.compiler.ASTSource(fn=kernel, signature={0: "*i32", 1: "i32"}, constants={2: 64})
+    triton.compile(src)
+    k = triton.compile(src)
+    # only the binary is read from the cache
+    assert list(k.asm.loaded.keys()) == ["spv"]
+    assert "tt.func" in k.asm["ttir"]
+    assert sorted(k.asm.loaded.keys()) == ["spv", "ttir"]
+    # the kernels indexed in memory are compiled again once the cache is cleared
+    reset_tmp_dir()
+    assert triton.compile(src).metadata.hash == k.metadata.hash
+
+
+def test_remote_cache(tmp_path, monkeypatch) -> None:
+    from triton.runtime.cache import RemoteCacheManager
+    monkeypatch.setenv("TRITON_REMOTE_CACHE_BACKEND", "triton.runtime.cache:SharedDirCacheBackend")
+    monkeypatch.setenv("TRITON_REMOTE_CACHE_DIR", str(tmp_path / "remote"))
+    monkeypatch.setenv("TRITON_CACHE_DIR", str(tmp_path / "node0"))
+    cache = RemoteCacheManager("key")
+    group = {
+        "kernel.spv": cache.put(b"spv", "kernel.spv"),
+        "kernel.json": cache.put("{}", "kernel.json", binary=False),
+    }
+    cache.put_group("kernel.json", group)
+    cache.put(b"zebin", "kernel.zebin")
+
+    # Another node pulls all the files from the remote cache.
+    monkeypatch.setenv("TRITON_CACHE_DIR", str(tmp_path / "node1"))
+    cache = RemoteCacheManager("key")
+    group = cache.get_group("kernel.json")
+    assert sorted(group.keys()) == ["kernel.json", "kernel.spv"]
+    assert Path(group["kernel.spv"]).read_bytes() == b"spv"
+    assert Path(group["kernel.json"]).read_text() == "{}"
+    assert Path(group["kernel.spv"]).is_relative_to(tmp_path / "node1")
+    assert Path(cache.get_file("kernel.zebin")).read_bytes() == b"zebin"
+
+
+def test_packed_cache(tmp_path, monkeypatch) -> None:
+    from triton.runtime.cache import PackedCacheManager, _packs, read_cache_file
+    monkeypatch.setenv("TRITON_CACHE_DIR", str(tmp_path))
+    cache = PackedCacheManager("key")
+    group = {
+        "kernel.spv": cache.put(b"spv", "kernel.spv"),
+        "kernel.json": cache.put("{}", "kernel.json", binary=False),
+    }
+    cache.put_group("kernel.json", group)
+    assert cache.get_file("kernel.zebin") is None
+    cache.put(b"zebin", "kernel.zebin")
+    cache.put(b"new spv", "kernel.spv")
+
+    # Another process reads the index, with the later entries of the files.
+    _packs.clear()
+    cache = PackedCacheManager("key")
+    group = cache.get_group("kernel.json")
+    assert sorted(group.keys()) == ["kernel.json", "kernel.spv"]
+    assert read_cache_file(group["kernel.spv"]) == b"spv"
+    assert read_cache_file(group["kernel.json"], binary=False) == "{}"
+    assert read_cache_file(cache.get_file("kernel.spv")) == b"new spv"
+    assert read_cache_file(cache.get_file("kernel.zebin")) == b"zebin"
+    assert not cache.has_file("kernel.zebin.tmp")
+    assert PackedCacheManager("other").get_file("kernel.spv") is None
+    # The files of all the keys are in the pack, the shared libraries only are
+    # on their own.
+    assert sorted(p.name for p in tmp_path.iterdir()) == ["pack.data", "pack.index", "pack.lock"]
+    assert Path(cache.put(b"so", "launcher.so")).read_bytes() == b"so"
+
+
+def test_cache_eviction(tmp_path, monkeypatch) -> None:
+    from triton.runtime.cache import FileCacheManager, evict_cache
+    monkeypatch.setenv("TRITON_CACHE_DIR", str(tmp_path))
+    binary = FileCacheManager("bin-key")
+    for i, key in enumerate(["old", "hot", "new"]):
+        cache = FileCacheManager(key)
+        group = {"kernel.spv": cache.put(b"0" * 1000, "kernel.spv"), "kernel.json": cache.put("{}", "kernel.json")}
+        if key == "hot":
+            # stored by content, outside of the directory of the key
+            group["kernel.zebin"] = binary.put(b"0" * 1000, "kernel.zebin")
+        cache.put_group("kernel.json", group)
+        for path in [cache.cache_dir, *Path(cache.cache_dir).iterdir()]:
+            os.utime(path, (1000 + i, 1000 + i))
+    os.utime(binary.cache_dir, (0, 0))
+    # The hit on the group of "hot" makes it, and the binaries it refers to,
+    # the most recently used.
+    assert FileCacheManager("hot").get_group("kernel.json") is not None
+    sizes = {p.name: sum(f.stat().st_size for f in p.iterdir()) for p in tmp_path.iterdir() if p.is_dir()}
+    assert evict_cache(str(tmp_path), sum(sizes.values()) + 1, grace=0) == 0
+    max_size = sizes["bin-key"] + sizes["hot"] + sizes["old"] // 2
+    assert evict_cache(str(tmp_path), max_size, grace=0) == sizes["old"] + sizes["new"]
+    assert sorted(p.name for p in tmp_path.iterdir() if p.is_dir()) == ["bin-key", "hot"]
+    # The keys used during the grace period are kept.
+    assert evict_cache(str(tmp_path), 0) == 0
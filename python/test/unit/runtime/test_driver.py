@@ -13,3 +13,677 @@ def test_is_lazy():
     assert triton.runtime.driver.active._obj is None
     utils = triton.runtime.driver.active.utils  # noqa: F841
     assert issubclass(triton.runtime.driver.active._obj.__class__, getattr(triton.backends.driver, "DriverBase"))
+
+
+def test_kernel_properties():
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(dst, src, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_SIZE)
+        tl.store(dst + offsets, tl.load(src + offsets))
+
+    src = torch.zeros(128, device='xpu')
+    dst = torch.empty(128, device='xpu')
+    kernel = _kernel[(1, )](dst, src, BLOCK_SIZE=128, num_warps=4)
+    metadata = kernel.metadata
+    assert metadata.n_spills == kernel.n_spills
+    assert metadata.spill_mem_size == kernel.n_spills
+    assert metadata.max_work_group_size >= 4 * metadata.threads_per_warp
+    assert metadata.required_sub_group_size in (0, metadata.threads_per_warp)
+
+
+def test_kernel_registry():
+    utils = triton.runtime.driver.active.utils
+    device = triton.runtime.driver.active.get_current_device()
+
+    @triton.jit
+    def _kernel():
+        pass
+
+    kernel = triton.compile(triton.compiler.ASTSource(fn=_kernel, signature={}))
+    loads = [utils.load_binary(kernel.name, kernel.kernel, 0, device) for _ in range(2)]
+    # loads of the same binary share one kernel
+    assert loads[0][:2] == loads[1][:2]
+    for load in loads:
+        utils.unload_binary(load[1])
+
+
+def test_binary_override(tmp_path, monkeypatch):
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(x_ptr, VALUE: tl.constexpr):
+        tl.store(x_ptr + tl.arange(0, 16), tl.full([16], VALUE, tl.int32))
+
+    utils = triton.runtime.driver.active.utils
+    srcs = [triton.compiler.ASTSource(fn=_kernel, signature={0: "*i32"}, constants={1: value}) for value in (1, 2, 3)]
+    k1, k2, k3 = map(triton.compile, srcs)
+    x = torch.zeros(16, dtype=torch.int32, device='xpu')
+    k1[(1, 1, 1)](x)
+    assert torch.all(x == 1)
+    # the files of the override directory are looked up by the next loads
+    monkeypatch.setenv("TRITON_BINARY_OVERRIDE_DIR", str(tmp_path))
+    (tmp_path / k1.metadata.hash).mkdir()
+    (tmp_path / k1.metadata.hash / f"{k1.name}.spv").write_bytes(k2.kernel)
+    triton.compile(srcs[0])[(1, 1, 1)](x)
+    assert torch.all(x == 2)
+    # the overrides set at runtime come first
+    utils.override_binary(k1.metadata.hash, k3.kernel)
+    try:
+        triton.compile(srcs[0])[(1, 1, 1)](x)
+        assert torch.all(x == 3)
+    finally:
+        utils.override_binary(k1.metadata.hash, None)
+    # the kernels already loaded keep their binary
+    k1[(1, 1, 1)](x)
+    assert torch.all(x == 1)
+
+def test_graph_replay():
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(x_ptr, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_SIZE)
+        tl.store(x_ptr + offsets, tl.load(x_ptr + offsets) + 1)
+
+    x = torch.zeros(128, device='xpu')
+    y = torch.zeros(128, device='xpu')
+    # make sure the kernel is compiled and loaded outside of the capture
+    _kernel[(1, )](x, BLOCK_SIZE=128)
+    g = triton.runtime.driver.active.utils.graph()
+    with g.capture():
+        _kernel[(1, )](x, BLOCK_SIZE=128)
+    g.replay()
+    g.replay()
+    torch.xpu.synchronize()
+    assert torch.all(x == 3)
+    # capturing again updates the pointer argument of the recorded launch
+    with g.capture():
+        _kernel[(1, )](y, BLOCK_SIZE=128)
+    g.replay()
+    torch.xpu.synchronize()
+    assert torch.all(x == 3)
+    assert torch.all(y == 1)
+
+
+def test_do_bench():
+    import torch
+
+    props = triton.runtime.driver.active.utils.get_device_properties(triton.runtime.driver.active.get_current_device())
+    assert props["l3_cache_size"] > 0
+
+    x = torch.randn(1 << 20, device='xpu')
+    median, p99 = triton.testing.do_bench(lambda: x.mul_(1), warmup=1, rep=5, quantiles=[0.5, 0.99])
+    assert 0 < median <= p99
+    assert triton.testing.do_bench(lambda: x.mul_(1), warmup=1, rep=5, return_mode="p99") > 0
+
+
+def test_large_grid():
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(dst):
+        pid = tl.program_id(0)
+        if pid == tl.num_programs(0) - 1:
+            tl.store(dst, pid)
+
+    # 2^32 work-items, which overflows a 32-bit count of the global range
+    grid = 2**32 // (4 * 32)
+    dst = torch.zeros(1, dtype=torch.int32, device='xpu')
+    _kernel[(grid, )](dst, num_warps=4, threads_per_warp=32)
+    assert dst.item() == grid - 1
+
+
+def test_persistent():
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(dst, BLOCK_SIZE: tl.constexpr):
+        pid_m = tl.program_id(0)
+        pid_n = tl.program_id(1)
+        offsets = tl.arange(0, BLOCK_SIZE)
+        tile = pid_n * tl.num_programs(0) + pid_m
+        tl.store(dst + tile * BLOCK_SIZE + offsets, tile + offsets * 0)
+
+    # more tiles than work-groups resident on the device
+    grid = (1000, 30)
+    ref = torch.arange(grid[0] * grid[1], dtype=torch.int32, device='xpu').repeat_interleave(16)
+    for swizzle_group in (0, 8):
+        dst = torch.zeros(grid[0] * grid[1] * 16, dtype=torch.int32, device='xpu')
+        kernel = _kernel[grid](dst, BLOCK_SIZE=16, enable_persistent=True, swizzle_group=swizzle_group)
+        assert kernel.metadata.persistent
+        assert torch.equal(dst, ref)
+
+
+def test_tile_launch():
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(dst, BLOCK_SIZE: tl.constexpr):
+        pid_m = tl.program_id(0)
+        pid_n = tl.program_id(1)
+        offsets = tl.arange(0, BLOCK_SIZE)
+        tile = pid_n * tl.num_programs(0) + pid_m
+        tl.store(dst + tile * BLOCK_SIZE + offsets, tile + offsets * 0)
+
+    device = triton.runtime.driver.active.get_current_device()
+    num_sub_devices = triton.runtime.driver.active.utils.get_device_properties(device)["num_sub_devices"]
+    grid = (1001, 3)
+    ref = torch.arange(grid[0] * grid[1], dtype=torch.int32, device='xpu').repeat_interleave(16)
+    for enable_persistent in (False, True):
+        dst = torch.zeros(grid[0] * grid[1] * 16, dtype=torch.int32, device='xpu')
+        kernel = _kernel[grid](dst, BLOCK_SIZE=16, tile_launch="explicit", enable_persistent=enable_persistent)
+        # the grid is only split across the tiles of a device that has some
+        assert kernel.metadata.partition_grid == (num_sub_devices > 1)
+        assert torch.equal(dst, ref)
+
+
+def test_launch_event():
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(x_ptr, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_SIZE)
+        tl.store(x_ptr + offsets, tl.load(x_ptr + offsets) + 1)
+
+    x = torch.zeros(128, device='xpu')
+    event = _kernel[(1, )](x, BLOCK_SIZE=128, return_event=True)
+    event.synchronize()
+    assert event.query()
+    assert torch.all(x == 1)
+    # the work submitted to the queue afterwards waits for the kernel
+    event = _kernel[(1, )](x, BLOCK_SIZE=128, return_event=True)
+    event.wait()
+    x.add_(1)
+    torch.xpu.synchronize()
+    assert torch.all(x == 3)
+
+
+def test_multi_device():
+    import pytest
+    import torch
+    import triton.language as tl
+
+    if torch.xpu.device_count() < 2:
+        pytest.skip("needs at least 2 devices")
+
+    @triton.jit
+    def _kernel(x_ptr, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_SIZE)
+        tl.store(x_ptr + offsets, tl.load(x_ptr + offsets) + 1)
+
+    kernel = _kernel[(1, )](torch.zeros(128, device='xpu:0'), BLOCK_SIZE=128)
+    # the compiled kernel is loaded again on each device it is launched on
+    for device in range(torch.xpu.device_count()):
+        with torch.xpu.device(device):
+            x = torch.zeros(128, device=f'xpu:{device}')
+            kernel[(1, )](x)
+            torch.xpu.synchronize()
+            assert torch.all(x == 1)
+    assert len(kernel._handles) == torch.xpu.device_count()
+
+
+def test_launch_trace(tmp_path):
+    import json
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(x_ptr, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_SIZE)
+        tl.store(x_ptr + offsets, tl.load(x_ptr + offsets) + 1)
+
+    x = torch.zeros(128, device='xpu')
+    tracer = triton.runtime.driver.active.utils.tracer()
+    with tracer.trace():
+        for _ in range(3):
+            _kernel[(2, 1, 1)](x, BLOCK_SIZE=128)
+        torch.xpu.synchronize()
+    assert tracer.dropped == 0
+    assert [(name, grid) for name, grid, *_ in tracer.records] == [("_kernel", (2, 1, 1))] * 3
+    submit_ns = [record[2] for record in tracer.records]
+    assert submit_ns == sorted(submit_ns)
+    # no more launches are recorded once stopped
+    _kernel[(1, )](x, BLOCK_SIZE=128)
+    torch.xpu.synchronize()
+    tracer.drain()
+    assert len(tracer.records) == 3
+
+    path = tmp_path / "trace.json"
+    tracer.export_chrome_trace(path)
+    events = json.loads(path.read_text())["traceEvents"]
+    assert len([e for e in events if e["ph"] == "i" and e["name"] == "_kernel"]) == 3
+
+
+def test_zeasm():
+    import pytest
+    import torch
+    import triton.language as tl
+    from triton.tools.zeasm import instruction_mix, path_to_iga
+
+    asm = """
+        (W)     mov (1|M0)               r2.0<1>:ud    0x0:ud
+                dpas.8x8 (16|M0)         r10:f         r10:f         r20:bf        r30.0:bf    {Atomic}
+                sync.nop                 null                                      {Compacted,$1.src}
+                send.ugm (16|M0)         r40      r50     null:0  0x0   0x08200580  {$2} // load.ugm.d32.a64
+        (W)     send.ugm (16|M0)         null     r5      r60:1   0x0   0x040007C4  {$3} // store.ugm.d32x8t.a32.ss[a0.2]
+                send.slm (16|M0)         r70      r80     null:0  0x0   0x04200500  {$4} // load.slm.d32.a32
+    """
+    assert instruction_mix(asm) == {
+        "instructions": 6, "dpas": 1, "send": {"slm": 1, "ugm": 2}, "sync": 1, "spills": 1, "fills": 0
+    }
+
+    try:
+        path_to_iga()
+    except RuntimeError:
+        pytest.skip("iga64 is not available")
+
+    @triton.jit
+    def _kernel(x_ptr, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_SIZE)
+        tl.store(x_ptr + offsets, tl.load(x_ptr + offsets) + 1)
+
+    kernel = _kernel[(1, )](torch.zeros(128, device='xpu'), BLOCK_SIZE=128)
+    assert "zeasm" in kernel.asm
+    zeasm = kernel.asm["zeasm"]
+    assert zeasm.startswith(f"// kernel: {kernel.name}")
+    assert "// send: " in zeasm
+
+
+def test_side_line_info():
+    import json
+    import pytest
+    import torch
+    import triton.language as tl
+    from triton.tools.zeasm import source_line
+
+    @triton.jit
+    def _kernel(x_ptr, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_SIZE)
+        tl.store(x_ptr + offsets, tl.load(x_ptr + offsets) + 1)
+
+    kernel = _kernel[(1, )](torch.zeros(128, device='xpu'), BLOCK_SIZE=128, line_info="side")
+    # the SPIR-V the driver builds has no debug info
+    assert b"test_driver.py" not in kernel.asm["spv"]
+    if "lines" not in kernel.asm:
+        pytest.skip("the driver doesn't expose the native binary of the kernels")
+    table = json.loads(kernel.asm["lines"])
+    assert table["rows"]
+    lines = {source_line(table, offset) for offset, _, _ in table["rows"]}
+    assert any(file.endswith("test_driver.py") for file, _ in lines)
+
+
+def test_spirv_extensions():
+    import subprocess
+    import tempfile
+    import torch
+    import triton.language as tl
+    from triton.backends.intel.compiler import SPIRV_EXTENSIONS, _path_to_binary
+
+    @triton.jit
+    def _kernel(x_ptr, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_SIZE)
+        tl.store(x_ptr + offsets, tl.load(x_ptr + offsets) + 1)
+
+    kernel = _kernel[(1, )](torch.zeros(128, device='xpu'), BLOCK_SIZE=128)
+    # the kernels only declare the extensions the device supports
+    assert set(kernel.metadata.spirv_extensions) <= SPIRV_EXTENSIONS.keys()
+    with tempfile.NamedTemporaryFile(suffix=".spv") as f:
+        f.write(kernel.asm["spv"])
+        f.flush()
+        spv = subprocess.check_output([_path_to_binary("spirv-dis")[0], f.name]).decode("utf-8")
+    extensions = [line.split('"')[1] for line in spv.splitlines() if "OpExtension" in line]
+    assert set(extensions) <= set(kernel.metadata.spirv_extensions)
+
+
+def test_profile_regions():
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(x_ptr, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_SIZE)
+        acc = tl.zeros((BLOCK_SIZE, ), dtype=tl.float32)
+        for i in range(N):
+            acc += tl.load(x_ptr + i * BLOCK_SIZE + offsets)
+        tl.store(x_ptr + offsets, acc)
+
+    grid = (4, )
+    x = torch.ones(8 * 128, device='xpu')
+    kernel = _kernel[grid](x, 8, BLOCK_SIZE=128, profile_regions="loop,load")
+    kinds = [name.split(":")[0] for name in kernel.metadata.profile_regions]
+    assert sorted(kinds) == ["load", "loop"]
+    cycles = kernel.run.region_cycles()
+    # each work-group runs the loop once and the load of its body 8 times
+    counts = {name.split(":")[0]: region["count"] for name, region in cycles.items()}
+    assert counts == {"loop": grid[0], "load": 8 * grid[0]}
+    assert all(region["cycles"] > 0 for region in cycles.values())
+    # the loop takes at least as long as the loads it issues
+    assert sum(r["cycles"] for n, r in cycles.items() if n.startswith("loop")) >= \
+        sum(r["cycles"] for n, r in cycles.items() if n.startswith("load"))
+    kernel.run.reset_region_cycles()
+    assert all(region["count"] == 0 for region in kernel.run.region_cycles().values())
+
+
+def test_generic_launcher():
+    import functools
+    import pytest
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(dst, src, scale, N, indices, offset, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_SIZE)
+        mask = offsets < N
+        tl.store(dst + offsets, tl.load(src + offsets, mask=mask) * scale, mask=mask)
+        tl.store(indices + offsets, offset + offsets)
+
+    src = torch.arange(128, dtype=torch.float32, device='xpu')
+    dst = torch.zeros(128, device='xpu')
+    indices = torch.zeros(128, dtype=torch.int64, device='xpu')
+    kernel = _kernel[(1, )](dst, src, 2.0, 100, indices, 2**40, BLOCK_SIZE=128)
+    # the arguments are decoded by the launcher of the kernels of any signature
+    assert isinstance(kernel.run.launch, functools.partial)
+    assert torch.equal(dst[:100], src[:100] * 2)
+    assert torch.all(dst[100:] == 0)
+    assert torch.equal(indices, torch.arange(128, device='xpu') + 2**40)
+    with pytest.raises(TypeError):
+        kernel.run.launch(1, 1, 1, 4, 1, 1, 1, 1, 0, None, 0, None, None, kernel, dst)
+
+
+def test_native_launch_event(monkeypatch):
+    import torch
+    import triton.language as tl
+
+    monkeypatch.setenv("TRITON_XPU_NATIVE_LAUNCH", "1")
+
+    @triton.jit
+    def _kernel(x_ptr, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.arange(0, BLOCK_SIZE)
+        tl.store(x_ptr + offsets, tl.load(x_ptr + offsets) + 1)
+
+    x = torch.zeros(128, device='xpu')
+    # more events than in a pool, recycled once released
+    for _ in range(300):
+        event = _kernel[(1, )](x, BLOCK_SIZE=128, return_event=True)
+    event.synchronize()
+    assert event.query()
+    assert torch.all(x == 300)
+
+
+def test_device_properties():
+    import pytest
+
+    utils = triton.runtime.driver.active.utils
+    device = triton.runtime.driver.active.get_current_device()
+    props = utils.get_device_properties(device)
+    # queried once, and not modifiable by the callers
+    assert utils.get_device_properties(device) is props
+    with pytest.raises(TypeError):
+        props["max_shared_mem"] = 0
+    assert props["num_eus"] >= props["multiprocessor_count"]
+    assert props["threads_per_eu"] > 0
+    assert props["grf_size"] in (32, 64)
+    assert 16 in props["sub_group_sizes"]
+    assert props["has_dpas"] == (props["dpas_execution_size"] > 0)
+
+
+def test_device_arch():
+    import torch
+    import triton.language as tl
+
+    props = triton.runtime.driver.active.utils.get_device_properties(triton.runtime.driver.active.get_current_device())
+    assert props["arch"] != "unknown"
+    # the architectures with 2D block IO have the DPAS of 16 lanes
+    if props["has_2d_block_io"]:
+        assert props["dpas_execution_size"] == 16 and props["device_arch"] == 1
+
+    @triton.jit
+    def _kernel(a_ptr, b_ptr, c_ptr):
+        offsets = tl.arange(0, 32)[:, None] * 32 + tl.arange(0, 32)[None, :]
+        tl.store(c_ptr + offsets, tl.dot(tl.load(a_ptr + offsets), tl.load(b_ptr + offsets)))
+
+    a = torch.randn((32, 32), dtype=torch.float16, device='xpu')
+    b = torch.randn((32, 32), dtype=torch.float16, device='xpu')
+    c = torch.empty((32, 32), dtype=torch.float32, device='xpu')
+    # the passes are selected by the features of the device, or of the options
+    for has_dpas in (None, False):
+        kernel = _kernel[(1, )](a, b, c, has_dpas=has_dpas, threads_per_warp=16)
+        uses_dpas = props["dpas_execution_size"] == 16 if has_dpas is None else has_dpas
+        assert ("#triton_gpu.dpas<" in kernel.asm["ttgir"]) == uses_dpas
+        torch.testing.assert_close(c, torch.matmul(a.float(), b.float()), atol=1e-2, rtol=1e-2)
+
+
+def test_buffered_prints():
+    import io
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(x_ptr, BLOCK: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+        x = tl.load(x_ptr + offsets)
+        tl.device_print("x", x)
+        tl.device_assert(x < 6, "x < 6")
+
+    x = torch.arange(8, dtype=torch.float32, device='xpu')
+    kernel = _kernel[(2, )](x, BLOCK=4, print_buffer_size=1024, debug=True)
+    assert "tt.print" not in kernel.asm["ttir"]
+    out = io.StringIO()
+    lines = kernel.run.flush_prints(file=out)
+    assert out.getvalue().splitlines() == lines
+    prints = sorted(line for line in lines if "Assertion" not in line)
+    assert prints == sorted(f"pid ({i // 4}, 0, 0) idx ({i % 4}) x: {float(i)}" for i in range(8))
+    failures = sorted(line.split(" ")[5] for line in lines if "Assertion `x < 6` failed" in line)
+    assert failures == ["(2)", "(3)"]
+    # the buffer is empty after a flush, the records that don't fit are dropped
+    assert kernel.run.flush_prints(file=out) == []
+    kernel = _kernel[(2, )](x, BLOCK=4, print_buffer_size=10, debug=True)
+    lines = kernel.run.flush_prints(file=out)
+    assert len(lines) <= 5 and lines[-1].endswith("slots of records dropped, the buffer of the prints holds 10 slots")
+
+
+def test_scratch_pool():
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _count(counters, N):
+        tl.atomic_add(counters + tl.program_id(0) % N, 1)
+
+    @triton.jit
+    def _copy(dst, src, BLOCK: tl.constexpr):
+        offsets = tl.arange(0, BLOCK)
+        tl.store(dst + offsets, tl.load(src + offsets))
+
+    utils = triton.runtime.driver.active.utils
+    out = torch.empty(16, dtype=torch.int32, device='xpu')
+    with utils.scratch(16 * 4, dtype=torch.int32, zero=True) as counters:
+        _count[(64, )](counters, 16)
+        _copy[(1, )](out, counters, BLOCK=16)
+        ptr = counters.data_ptr()
+        assert utils.scratch_stats(utils.get_sycl_queue())["used_bytes"] >= 64
+    # the block is reused by the kernels launched after the release, without
+    # waiting for the ones using it
+    with utils.scratch(16 * 4, dtype=torch.int32, zero=True) as counters:
+        assert counters.data_ptr() == ptr
+        _count[(32, )](counters, 16)
+        assert torch.all(out == 4)
+        _copy[(1, )](out, counters, BLOCK=16)
+    assert torch.all(out == 2)
+    utils.empty_scratch_cache()
+    assert utils.scratch_stats(utils.get_sycl_queue())["cached_bytes"] == 0
+
+
+def _export_ipc_handle(handles, done):
+    import torch
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+    x = torch.arange(256, dtype=torch.float32, device='xpu')
+    torch.xpu.synchronize()
+    handles.put(triton.runtime.driver.active.utils.ipc_handle(x[128:]))
+    # the memory stays allocated until the parent is done with it
+    done.wait()
+
+
+def test_ipc_handle():
+    import multiprocessing
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _copy(dst, src, BLOCK: tl.constexpr):
+        offsets = tl.arange(0, BLOCK)
+        tl.store(dst + offsets, tl.load(src + offsets))
+
+    ctx = multiprocessing.get_context("spawn")
+    handles, done = ctx.Queue(), ctx.Event()
+    proc = ctx.Process(target=_export_ipc_handle, args=(handles, done))
+    proc.start()
+    try:
+        handle = handles.get(timeout=60)
+        assert handle.shape == (128, ) and handle.dtype == torch.float32
+        # the tensor of the child is read by the kernels of the parent
+        with triton.runtime.driver.active.utils.open_ipc_handle(handle) as x:
+            out = torch.empty(128, dtype=torch.float32, device='xpu')
+            _copy[(1, )](out, x, BLOCK=128)
+            torch.xpu.synchronize()
+        assert torch.all(out == torch.arange(128, 256, dtype=torch.float32, device='xpu'))
+    finally:
+        done.set()
+        proc.join()
+    assert proc.exitcode == 0
+
+
+def test_packed_args():
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(dst, a, b, c, d, e, f, scale, offset, BLOCK: tl.constexpr):
+        offsets = tl.arange(0, BLOCK)
+        value = (a + b + c + d + e + f) * scale + offset
+        tl.store(dst + offsets, tl.zeros((BLOCK, ), tl.float32) + value)
+
+    dst = torch.zeros(16, device='xpu')
+    kernel = _kernel[(1, )](dst, 3, 5, 7, 9, 2**33 + 1, 13, 0.5, -1.0, BLOCK=16, pack_scalar_args=4)
+    # the scalars the kernel isn't specialized on are passed in a single buffer
+    assert kernel.metadata.packed_args == list(range(1, 9))
+    assert "!tt.ptr<i64, 1>" in kernel.asm["ttir"]
+    expected = (3 + 5 + 7 + 9 + 2**33 + 1 + 13) * 0.5 - 1.0
+    torch.testing.assert_close(dst, torch.full_like(dst, expected))
+    # the slots of the packed arguments are reused across launches
+    for i in range(100):
+        _kernel[(1, )](dst, i, 0, 0, 0, 0, 0, 1.0, 0.0, BLOCK=16, pack_scalar_args=4)
+    assert torch.all(dst == 99)
+
+
+def test_occupancy():
+    import torch
+    import triton.language as tl
+
+    utils = triton.runtime.driver.active.utils
+    device = utils.get_current_device()
+    props = utils.get_device_properties(device)
+    occupancy = utils.get_occupancy(device, num_warps=4)
+    threads_per_xe_core = props["num_eus"] // props["multiprocessor_count"] * props["threads_per_eu"]
+    assert occupancy["work_groups_per_xe_core"] == threads_per_xe_core // 4
+    assert occupancy["limited_by"] == "threads" and occupancy["occupancy"] == 1.0
+    # the shared local memory and the large register file trade occupancy
+    assert utils.get_occupancy(device, 4, props["max_shared_mem"])["work_groups_per_xe_core"] == 1
+    assert utils.get_occupancy(device, 4, props["max_shared_mem"])["limited_by"] == "shared"
+    assert utils.get_occupancy(device, 4, n_regs=256)["work_groups_per_xe_core"] == threads_per_xe_core // 8
+
+    @triton.jit
+    def _kernel(dst, BLOCK: tl.constexpr):
+        tl.store(dst + tl.arange(0, BLOCK), tl.arange(0, BLOCK))
+
+    dst = torch.empty(16, dtype=torch.int32, device='xpu')
+    kernel = _kernel[(1, )](dst, BLOCK=16)
+    assert kernel.metadata.occupancy == utils.get_occupancy(device, kernel.metadata.num_warps, kernel.metadata.shared,
+                                                            kernel.metadata.n_regs)
+
+
+
+def test_auto_num_warps():
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(dst, src, BLOCK: tl.constexpr):
+        offsets = tl.arange(0, BLOCK)
+        tl.store(dst + offsets, tl.load(src + offsets) + 1)
+
+    # 32 bytes of the loaded and stored tensors per work-item
+    for block, num_warps in ((16, 1), (1024, 8), (4096, 32)):
+        src = torch.arange(block, dtype=torch.float32, device='xpu')
+        dst = torch.empty_like(src)
+        kernel = _kernel[(1, )](dst, src, BLOCK=block, threads_per_warp=16, auto_num_warps=True)
+        assert kernel.metadata.num_warps == num_warps
+        assert torch.equal(dst, src + 1)
+
+def test_concurrent_launches():
+    import threading
+    import torch
+    import triton.language as tl
+
+    @triton.jit
+    def _kernel(dst, value, BLOCK: tl.constexpr):
+        offsets = tl.arange(0, BLOCK)
+        tl.store(dst + offsets, tl.load(dst + offsets) + value)
+
+    num_threads, num_launches = 8, 200
+    dsts = [torch.zeros(64, dtype=torch.int32, device='xpu') for _ in range(num_threads)]
+    _kernel[(1, )](dsts[0], 0, BLOCK=64)
+    errors = []
+
+    def launch(i):
+        try:
+            # the threads launch on their own queues, without waiting for the GIL
+            with torch.xpu.stream(torch.xpu.Stream()):
+                for _ in range(num_launches):
+                    _kernel[(1, )](dsts[i], i + 1, BLOCK=64)
+                torch.xpu.current_stream().synchronize()
+        except Exception as e:
+            errors.append(e)
+
+    threads = [threading.Thread(target=launch, args=(i, )) for i in range(num_threads)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert not errors
+    for i, dst in enumerate(dsts):
+        assert torch.all(dst == (i + 1) * num_launches)
+
+
+def test_itt_tasks(monkeypatch):
+    import torch
+    import triton.language as tl
+    from torch.profiler import itt
+
+    tasks = []
+    monkeypatch.setenv("TRITON_XPU_ITT", "1")
+    monkeypatch.setattr(itt, "is_available", lambda: True)
+    monkeypatch.setattr(itt, "range_push", lambda name: tasks.append(name))
+    monkeypatch.setattr(itt, "range_pop", lambda: tasks.append(None))
+
+    @triton.jit
+    def _kernel(x_ptr, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        tl.store(x_ptr + offsets, tl.load(x_ptr + offsets) + 1)
+
+    x = torch.zeros(256, device='xpu')
+    kernel = _kernel[(2, )](x, BLOCK_SIZE=128, num_warps=4)
+    assert torch.all(x == 1)
+    assert len(tasks) == 2 and tasks[1] is None
+    assert tasks[0].startswith("triton:_kernel [BLOCK_SIZE=128, num_warps=4, ")
+    assert tasks[0].endswith(f"#{kernel.metadata.hash[:8]} grid=2x1x1")
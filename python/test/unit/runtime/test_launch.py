@@ -105,3 +105,62 @@ def test_memory_leak() -> None:
 
 #     # Run empty, which would run empty_kernel internally
 #     empty(*kernel_args)
+
+
+def test_batch_launch() -> None:
+
+    @triton.jit
+    def add_kernel(x, y, n, BLOCK: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+        mask = offsets < n
+        tl.store(y + offsets, tl.load(x + offsets, mask) + 1, mask)
+
+    @triton.jit
+    def fill_kernel(y, N: tl.constexpr):
+        # the rows of the 2D grid, each program filling N elements
+        offsets = (tl.program_id(1) * tl.num_programs(0) + tl.program_id(0)) * N + tl.arange(0, N)
+        tl.store(y + offsets, tl.program_id(1) * 10 + tl.program_id(0))
+
+    x = torch.randn(40, device='xpu')
+    y = torch.empty_like(x)
+    z = torch.empty(2 * 3 * 8, dtype=torch.int32, device='xpu')
+    launches = [
+        (add_kernel, (3, ), (x, y, 40), {"BLOCK": 16}),
+        (fill_kernel, (3, 2), (z, ), {"N": 8}),
+    ]
+    kernel = triton.batch_launch(launches)
+    assert torch.equal(y, x + 1)
+    expected = torch.tensor([r * 10 + c for r in range(2) for c in range(3)], dtype=torch.int32)
+    assert torch.equal(z.cpu(), expected.repeat_interleave(8))
+    # the same kernels with other grids run the same batched kernel
+    y.zero_()
+    assert triton.batch_launch([(add_kernel, lambda args: (triton.cdiv(args["n"], args["BLOCK"]), ), (x, y, 40),
+                                 {"BLOCK": 16}), (fill_kernel, (3, 2), (z, ), {"N": 8})]) is kernel
+    assert torch.equal(y, x + 1)
+
+
+def test_preload(tmp_path) -> None:
+    from triton.runtime import preload
+
+    @triton.jit
+    def add_one_kernel(x, BLOCK: tl.constexpr):
+        offsets = tl.arange(0, BLOCK)
+        tl.store(x + offsets, tl.load(x + offsets) + 1)
+
+    x = torch.zeros(16, device='xpu')
+    manifest = tmp_path / "manifest.json"
+    with preload.record(manifest):
+        add_one_kernel[(1, )](x, BLOCK=16)
+        add_one_kernel[(1, )](x, BLOCK=16)
+    kernels = preload.load(manifest)
+    assert [kernel["name"] for kernel in kernels] == ["add_one_kernel"]
+    # The kernels recorded by another session are kept.
+    with preload.record(manifest):
+        pass
+    assert preload.load(manifest) == kernels
+    try:
+        assert preload.preload(manifest, num_threads=2) == 1
+    finally:
+        preload.release_preloaded()
+    add_one_kernel[(1, )](x, BLOCK=16)
+    assert torch.equal(x.cpu(), torch.full((16, ), 3.0))
@@ -0,0 +1,62 @@
+import torch
+import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+import triton
+import triton.language as tl
+from triton.runtime import replay
+from triton.tools.replay import replay as replay_launches
+
+
+@triton.jit
+def _copy_kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+    offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+    tl.store(dst + offsets, tl.load(src + offsets, mask=offsets < N), mask=offsets < N)
+
+
+@triton.autotune(configs=[triton.Config(kwargs={'BLOCK_SIZE': 32}),
+                          triton.Config(kwargs={'BLOCK_SIZE': 128})], key=['N'], warmup=1, rep=1)
+@triton.jit
+def _tuned_copy_kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+    offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+    tl.store(dst + offsets, tl.load(src + offsets, mask=offsets < N), mask=offsets < N)
+
+
+def test_record(tmp_path):
+    path = tmp_path / "launches.log"
+    with replay.record(path):
+        for N in [1000, 1000, 4096]:
+            src = torch.rand(N, device='xpu')
+            dst = torch.empty(N, device='xpu')
+            _copy_kernel[(triton.cdiv(N, 128), )](dst, src, N, BLOCK_SIZE=128)
+    # no more launches are recorded out of the context
+    _copy_kernel[(1, )](dst, src, N, BLOCK_SIZE=128)
+
+    records = list(replay.load(path))
+    assert [record[0] for record in records] == ["kernel", "launch", "launch", "launch"]
+    _, kernel_id, module, qualname, _, arg_names = records[0]
+    assert (qualname, arg_names) == ("_copy_kernel", ["dst", "src", "N", "BLOCK_SIZE"])
+    _, launch_kernel_id, _, grid, args, options = records[-1]
+    assert launch_kernel_id == kernel_id
+    assert grid == [32, 1, 1]
+    assert args[0][:3] == ["tensor", "float32", [4096]]
+    assert args[2:] == [4096, 128]
+    assert "num_warps" in options
+
+    # the two distinct launches are replayed
+    results = replay_launches(path, bench=True, rep=1)
+    assert [(result["grid"], result["args"][2]) for result in results] == [((8, 1, 1), 1000), ((32, 1, 1), 4096)]
+    assert all(result["ms"] > 0 for result in results)
+
+
+def test_record_tuning(tmp_path):
+    path = tmp_path / "launches.log"
+    N = 1024
+    src = torch.rand(N, device='xpu')
+    dst = torch.empty(N, device='xpu')
+    with replay.record(path):
+        _tuned_copy_kernel[lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )](dst, src, N)
+    tunings = [record for record in replay.load(path) if record[0] == "tune"]
+    assert len(tunings) == 1
+    _, _, key, config, timings = tunings[0]
+    assert key[0] == N
+    assert config in timings and len(timings) == 2
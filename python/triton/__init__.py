@@ -7,6 +7,7 @@ __version__ = '3.0.0'
 # submodules
 from .runtime import (
     autotune,
+    batch_launch,
     Config,
     heuristics,
     JITFunction,
@@ -17,7 +18,7 @@ from .runtime import (
     MockTensor,
 )
 from .runtime.jit import jit
-from .compiler import compile, CompilationError
+from .compiler import compile, compile_many, CompilationError
 
 from . import language
 from . import testing
@@ -25,9 +26,11 @@ from . import tools
 
 __all__ = [
     "autotune",
+    "batch_launch",
     "cdiv",
     "CompilationError",
     "compile",
+    "compile_many",
     "Config",
     "heuristics",
     "impl",
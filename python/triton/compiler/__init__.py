@@ -1,4 +1,4 @@
-from .compiler import CompiledKernel, ASTSource, compile, AttrsDescriptor, make_backend
+from .compiler import CompiledKernel, ASTSource, compile, compile_many, AttrsDescriptor, make_backend
 from .errors import CompilationError
 
-__all__ = ["compile", "make_backend", "ASTSource", "AttrsDescriptor", "CompiledKernel", "CompilationError"]
+__all__ = ["compile", "compile_many", "make_backend", "ASTSource", "AttrsDescriptor", "CompiledKernel", "CompilationError"]
@@ -14,6 +14,9 @@ from .errors import (CompilationError, CompileTimeAssertionFailure, UnsupportedL
 
 
 def mangle_ty(ty):
+    if isinstance(ty, language.tensor_descriptor_type):
+        shape = '_'.join(map(str, ty.block_shape))
+        return f'D{mangle_ty(ty.element_ty)}S{shape}S'
     if ty.is_ptr():
         return 'P' + mangle_ty(ty.element_ty)
     if ty.is_int():
@@ -354,7 +357,10 @@ class CodeGenerator(ast.NodeVisitor):
         self.module.push_back(self.fn)
         entry = self.fn.add_entry_block()
         arg_values = []
+        # the index of the argument of the function, the tensor descriptors
+        # being passed as several ones
         idx = 0
+        param_types = iter(self.prototype.param_types)
         for i, arg_name in enumerate(arg_names):
             if i in self.constants:
                 cst = self.constants[i]
@@ -366,7 +372,13 @@ class CodeGenerator(ast.NodeVisitor):
                 if i in self.attributes:
                     for name, value in self.attributes[i]:
                         self.fn.set_arg_attr(idx, name, value)
-                arg_values.append(tensor(self.fn.args(idx), self.prototype.param_types[idx]))
+                ty = next(param_types)
+                if isinstance(ty, language.tensor_descriptor_type):
+                    handles = [self.fn.args(idx + j) for j in range(4)]
+                    arg_values.append(language.tensor_descriptor(handles, ty))
+                    idx += len(handles)
+                    continue
+                arg_values.append(tensor(self.fn.args(idx), ty))
                 idx += 1
 
         insert_pt = self.builder.get_insertion_block()
@@ -431,7 +443,7 @@ class CodeGenerator(ast.NodeVisitor):
             names = [names]
         if not _is_list_like(values):
             values = [values]
-        native_nontensor_types = (language.dtype, )
+        native_nontensor_types = (language.dtype, language.local_memory)
         for name, value in zip(names, values):
             # by default, constexpr are assigned into python variable
             value = _unwrap_if_constexpr(value)
@@ -837,15 +849,19 @@ class CodeGenerator(ast.NodeVisitor):
                     ast.NodeVisitor.generic_visit(self, stmt)
             return
 
-        if IteratorClass is not range:
-            raise RuntimeError('Only `range` and `static_range` iterators are currently supported')
-
-        # visit iterator arguments
-        # note: only `range` iterator is supported now
-        # collect lower bound (lb), upper bound (ub), and step
-        lb = iter_args[0] if len(iter_args) > 1 else self.visit(ast.Num(0))
-        ub = iter_args[1] if len(iter_args) > 1 else self.visit(node.iter.args[0])
-        step = iter_args[2] if len(iter_args) > 2 else self.visit(ast.Num(1))
+        loop_unroll_factor = None
+        if IteratorClass == language.range:
+            iter_kwargs = {kw.arg: self.visit(kw.value) for kw in node.iter.keywords}
+            iterator = IteratorClass(*iter_args, **iter_kwargs)
+            lb, ub, step = iterator.start, iterator.end, iterator.step
+            loop_unroll_factor = iterator.loop_unroll_factor
+        elif IteratorClass is range:
+            # collect lower bound (lb), upper bound (ub), and step
+            lb = iter_args[0] if len(iter_args) > 1 else self.visit(ast.Num(0))
+            ub = iter_args[1] if len(iter_args) > 1 else self.visit(node.iter.args[0])
+            step = iter_args[2] if len(iter_args) > 2 else self.visit(ast.Num(1))
+        else:
+            raise RuntimeError('Only `range`, `tl.range` and `static_range` iterators are currently supported')
         # handle negative constant step (not supported by scf.for in MLIR)
         negative_step = False
         if _is_constexpr(step) and step.value < 0:
@@ -908,6 +924,9 @@ class CodeGenerator(ast.NodeVisitor):
             # create ForOp
             self._set_insertion_point_and_loc(ip, last_loc)
             for_op = self.builder.create_for_op(lb, ub, step, [arg.handle for arg in init_args])
+            # unrolled on TTGIR, see the loop unrolling of the backends
+            if loop_unroll_factor is not None and loop_unroll_factor > 1:
+                for_op.set_attr("tt.loop_unroll_factor", self.builder.get_int32_attr(loop_unroll_factor))
 
             self.scf_stack.append(node)
             self.builder.set_insertion_point_to_start(for_op.get_body(0))
@@ -966,14 +985,20 @@ class CodeGenerator(ast.NodeVisitor):
     def call_JitFunction(self, fn: JITFunction, args, kwargs):
         args = inspect.getcallargs(fn.fn, *args, **kwargs)
         args = [args[name] for name in fn.arg_names]
-        args = [arg if _is_triton_tensor(arg) else constexpr(arg) for arg in args]
+        args = [arg if _is_triton_tensor(arg) or isinstance(arg, language.tensor_descriptor) else constexpr(arg)
+                for arg in args]
         # generate function def
         attributes = dict()
         constexprs = [i for i, arg in enumerate(args) if _is_constexpr(arg)]
         constants = {i: args[i] for i in constexprs}
         # generate call
         args = [None if i in constexprs else arg for i, arg in enumerate(args)]
-        arg_vals = [arg.handle for arg in args if arg is not None]
+        arg_vals = []
+        for arg in args:
+            if isinstance(arg, language.tensor_descriptor):
+                arg_vals += arg.handles
+            elif arg is not None:
+                arg_vals.append(arg.handle)
         arg_types = [arg.type for arg in args if arg is not None]
         fn_name = mangle_fn(fn.__name__, arg_types, constants)
         # generate function def if necessary
@@ -1148,6 +1173,10 @@ class CodeGenerator(ast.NodeVisitor):
 
 
 def str_to_ty(name):
+    match = re.fullmatch(r"tensordesc<(\w+)\[([\d, ]*)\]>", name)
+    if match:
+        block_shape = [int(s) for s in match.group(2).split(",")]
+        return language.tensor_descriptor_type(str_to_ty(match.group(1)), block_shape)
     if name[0] == "*":
         ty = str_to_ty(name[1:])
         return language.pointer_type(ty)
@@ -1199,7 +1228,8 @@ def ast_to_ttir(fn, specialization, context, options):
     function_name = '_'.join([fn.__name__, kernel_suffix(specialization.signature.values(), attrs)])
     tys = list(specialization.signature.values())
     new_constants = {k: True if k in tys and tys[k] == "i1" else 1 for k in attrs.equal_to_1}
-    new_attrs = {k: [("tt.divisibility", 16)] for k in attrs.divisible_by_16}
+    larger_divisibility = dict(attrs.larger_divisibility)
+    new_attrs = {k: [("tt.divisibility", larger_divisibility.get(k, 16))] for k in attrs.divisible_by_16}
     for k in attrs.divisible_by_8:
         attr = new_attrs[k] if k in new_attrs else []
         if k in attrs.divisible_by_16:
@@ -1207,6 +1237,8 @@ def ast_to_ttir(fn, specialization, context, options):
         else:
             attr.append(("tt.max_divisibility", 8))
         new_attrs[k] = attr
+    for k in attrs.pointer_range_32:
+        new_attrs.setdefault(k, []).append(("tt.pointer_range", 32))
 
     all_constants = constants.copy()
     all_constants.update(new_constants)
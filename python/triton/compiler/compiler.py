@@ -1,20 +1,31 @@
 from __future__ import annotations
+import ast
+import copy
 import hashlib
 import json
 from .._C.libtriton import get_env_vars, ir
 from ..backends import backends
 from .. import __version__
 from ..runtime.autotuner import OutOfResources
-from ..runtime.cache import get_cache_manager, get_dump_manager, get_override_manager
+from ..runtime.cache import (cache_file_exists, get_cache_manager, get_dump_manager, get_override_manager,
+                             make_binary_cache_key, read_cache_file)
 from ..runtime.driver import driver
+from ..runtime.jit import JITFunction
+from ..runtime import preload
+from . import reproducer
 # TODO: this shouldn't be here
 from ..backends.intel.compiler import InfoFromBackendForTensorMap
 from dataclasses import dataclass
 from .code_generator import ast_to_ttir
+from collections.abc import Mapping
 from pathlib import Path
 import re
 import functools
+import threading
+import math
+import operator
 import os
+import sys
 
 
 @dataclass
@@ -23,6 +34,11 @@ class AttrsDescriptor:
     equal_to_1: set = None
     ids_of_folded_args: set = None
     divisible_by_8: set = None
+    # (arg id, divisibility) of the args aligned on one of the larger
+    # specialization buckets of `JITFunction.divisibility_buckets`
+    larger_divisibility: set = None
+    # the pointer args into the tensors of less than 2^31 bytes
+    pointer_range_32: set = None
 
     def __post_init__(self):
         if self.divisible_by_16 is None:
@@ -33,6 +49,10 @@ class AttrsDescriptor:
             self.ids_of_folded_args = set()
         if self.divisible_by_8 is None:
             self.divisible_by_8 = set()
+        if self.larger_divisibility is None:
+            self.larger_divisibility = set()
+        if self.pointer_range_32 is None:
+            self.pointer_range_32 = set()
 
     def hash(self):
         key = str([sorted(x) for x in self.__dict__.values()])
@@ -110,16 +130,21 @@ class ASTSource:
             self.attrs = AttrsDescriptor()
 
     def hash(self):
-        key = f"{self.fn.cache_key}-{self.attrs.hash()}-{self.signature.values()}-{self.constants}"
+        # the @jit functions passed as constexprs are part of the kernel
+        constants = {k: v.cache_key if isinstance(v, JITFunction) else v for k, v in self.constants.items()}
+        key = f"{self.fn.cache_key}-{self.attrs.hash()}-{self.signature.values()}-{constants}"
         return hashlib.md5(key.encode("utf-8")).hexdigest()
 
     def make_ir(self, options, context):
         return ast_to_ttir(self.fn, self, context=context, options=options)
 
     def metadata(self):
-        # TODO: remove once TMA support is cleaned up
+        constant_ids = {self.fn.arg_names.index(k) if isinstance(k, str) else k for k in self.constants}
         return {
+            # TODO: remove once TMA support is cleaned up
             "ids_of_folded_args": tuple([int(k) for k in self.attrs.ids_of_folded_args]),
+            # the parameters of the kernel function in the IR, the constants are folded
+            "ir_arg_names": tuple(name for i, name in enumerate(self.fn.arg_names) if i not in constant_ids),
         }
 
     def parse_options(self):
@@ -195,10 +220,69 @@ def parse(full_name, ext):
         return module
     if ext == "llir" or ext == "ptx":
         return Path(full_name).read_text()
-    if ext == "cubin":
+    if ext == "cubin" or ext == "spv":
         return Path(full_name).read_bytes()
 
 
+# The cache groups of the kernels compiled or found in the cache by this
+# process, by hash, so that later compilations of the same kernels don't look
+# them up in the cache again.
+_compiled_groups = dict()
+
+# The MLIR contexts of the finished compilations, with the dialects of their
+# backend loaded, free to be reused by the next ones with
+# TRITON_REUSE_MLIR_CONTEXT=1, by backend. Loading the dialects is a fixed cost
+# of each compilation that stands out for small kernels.
+_free_contexts = dict()
+_free_contexts_lock = threading.Lock()
+# the contexts kept free for each backend, at most, those of concurrent
+# compilations beyond being dropped when they finish
+MAX_FREE_CONTEXTS = 8
+
+
+def _reuse_contexts():
+    return os.environ.get("TRITON_REUSE_MLIR_CONTEXT", "0") == "1"
+
+
+def _acquire_context(backend):
+    if _reuse_contexts():
+        with _free_contexts_lock:
+            contexts = _free_contexts.get(type(backend))
+            if contexts:
+                return contexts.pop()
+    context = ir.context()
+    ir.load_dialects(context)
+    backend.load_dialects(context)
+    return context
+
+
+def _release_context(backend, context, modules):
+    """
+    Erase the `modules` of a finished compilation and free its `context` for
+    the next ones. The modules must not be used afterwards.
+    """
+    if not _reuse_contexts():
+        return
+    for module in modules:
+        module.erase()
+    with _free_contexts_lock:
+        contexts = _free_contexts.setdefault(type(backend), [])
+        if len(contexts) < MAX_FREE_CONTEXTS:
+            contexts.append(context)
+
+
+def _stored_stages(exts):
+    """
+    The stages among `exts` whose output is stored in the cache: the binary,
+    the last one, and those TRITON_STORE_IR lists, e.g. "ttir,ttgir", or all of
+    them with "all". The LLVM IR of the backends that translate it straight
+    to their binary is only a stage of its own when listed.
+    """
+    store = os.environ.get("TRITON_STORE_IR", "").strip()
+    listed = {ext.strip() for ext in store.split(",")}
+    return {ext for ext in exts if store == "all" or ext in listed} | {exts[-1]}
+
+
 def compile(src, target=None, options=None):
     if target is None:
         target = driver.active.get_current_target()
@@ -212,6 +296,18 @@ def compile(src, target=None, options=None):
     # create cache manager
     key = f"{triton_key()}-{src.hash()}-{backend.hash()}-{options.hash()}-{str(sorted(get_env_vars().items()))}"
     hash = hashlib.md5(key.encode("utf-8")).hexdigest()
+    metadata_filename = f"{src.name}.json"
+    stages = dict()
+    backend.add_stages(stages, options)
+    first_stage = list(stages.keys()).index(src.ext)
+    stored = _stored_stages(list(stages)[first_stage:])
+    binary_ext = list(stages)[-1]
+    stored_filenames = [f"{src.name}.{ext}" for ext in stored]
+    metadata_group = _compiled_groups.get(hash)
+    # the files are gone if the cache has been cleared since
+    if metadata_group is not None and cache_file_exists(metadata_group[metadata_filename]) and \
+            all(name in metadata_group for name in stored_filenames):
+        return CompiledKernel(src, metadata_group)
     fn_cache_manager = get_cache_manager(hash)
     # For dumping/overriding only hash the source as we want it to be independent of triton
     # core changes to make it easier to track kernels by hash.
@@ -219,12 +315,12 @@ def compile(src, target=None, options=None):
     enable_ir_dump = os.environ.get("TRITON_KERNEL_DUMP", "0") == "1"
     fn_override_manager = get_override_manager(src.hash()) if enable_override else None
     fn_dump_manager = get_dump_manager(src.hash()) if enable_ir_dump else None
-    metadata_filename = f"{src.name}.json"
     metadata_group = fn_cache_manager.get_group(metadata_filename) or {}
     metadata_path = metadata_group.get(metadata_filename)
-    if metadata_path is not None:
+    # the kernels compiled without the IRs stored now are compiled again
+    if metadata_path is not None and all(name in metadata_group for name in stored_filenames):
         # cache hit!
-        metadata = json.loads(Path(metadata_path).read_text())
+        _compiled_groups[hash] = metadata_group
         return CompiledKernel(src, metadata_group)
     # initialize metadata
     metadata = {
@@ -235,17 +331,30 @@ def compile(src, target=None, options=None):
         **src.metadata(),
     }
     # run compilation pipeline  and populate metadata
-    stages = dict()
-    backend.add_stages(stages, options)
-    first_stage = list(stages.keys()).index(src.ext)
-    context = ir.context()
-    ir.load_dialects(context)
-    backend.load_dialects(context)
+    metadata_group = {}
+    context = _acquire_context(backend)
     module = src.make_ir(options, context)
+    # the modules of the context, erased once the compilation is done
+    modules = [module]
+    bundle = reproducer.begin(src.name, hash, target, options, src.ext)
+    input_ext = src.ext
     for ext, compile_ir in list(stages.items())[first_stage:]:
-        next_module = compile_ir(module, metadata)
+        try:
+            with reproducer.stage(bundle, ext, input_ext, module, metadata):
+                next_module = compile_ir(module, metadata)
+        except BaseException:
+            reproducer.end(hash)
+            raise
+        input_ext = ext
         ir_filename = f"{src.name}.{ext}"
-        metadata_group[ir_filename] = fn_cache_manager.put(next_module, ir_filename)
+        if ext == binary_ext and isinstance(next_module, bytes):
+            # the group refers to the binary stored once for all the kernels
+            # compiled to it
+            binary_cache_manager = get_cache_manager(make_binary_cache_key(next_module))
+            metadata_group[ir_filename] = binary_cache_manager.get_file(ir_filename) or \
+                binary_cache_manager.put(next_module, ir_filename)
+        elif ext in stored:
+            metadata_group[ir_filename] = fn_cache_manager.put(next_module, ir_filename)
         if fn_dump_manager is not None:
             fn_dump_manager.put(next_module, ir_filename)
         if (fn_override_manager is not None and fn_override_manager.has_file(ir_filename)):
@@ -253,14 +362,50 @@ def compile(src, target=None, options=None):
             full_name = fn_override_manager.get_file(ir_filename)
             next_module = parse(full_name, ext)
         module = next_module
+        if getattr(module, "context", None) is context and module not in modules:
+            modules.append(module)
+    _release_context(backend, context, modules)
+    reproducer.end(hash)
+    # the files the stages keep next to the IRs, by extension, e.g. the line
+    # table of the binary
+    for ext, data in metadata.pop("side_files", {}).items():
+        ir_filename = f"{src.name}.{ext}"
+        metadata_group[ir_filename] = fn_cache_manager.put(data, ir_filename, binary=isinstance(data, bytes))
     # write-back metadata
     metadata_group[metadata_filename] = fn_cache_manager.put(json.dumps(metadata, default=vars), metadata_filename,
                                                              binary=False)
     fn_cache_manager.put_group(metadata_filename, metadata_group)
+    _compiled_groups[hash] = metadata_group
     # return handle to compiled kernel
     return CompiledKernel(src, metadata_group)
 
 
+def compile_many(srcs, target=None, options=None, max_workers=None):
+    """
+    Compile independent kernels concurrently and return their `CompiledKernel`s
+    in the order of `srcs`.
+
+    Each compilation has its own MLIR context and writes its results into the
+    shared cache, as `compile` does. The MLIR and LLVM pipelines release the
+    GIL, so the compilations overlap across up to `max_workers` threads.
+
+    :param options: the options of every kernel, or a list with the options of
+                    each kernel
+    """
+    from concurrent.futures import ThreadPoolExecutor
+    srcs = list(srcs)
+    if options is None or isinstance(options, dict):
+        options = [options] * len(srcs)
+    assert len(options) == len(srcs), "expected one set of options per source"
+    if target is None:
+        target = driver.active.get_current_target()
+    if max_workers is None:
+        max_workers = os.cpu_count()
+    with ThreadPoolExecutor(max_workers=max_workers) as pool:
+        futures = [pool.submit(compile, src, target, opts) for src, opts in zip(srcs, options)]
+        return [future.result() for future in futures]
+
+
 def make_backend(target):
     actives = [x.compiler for x in backends.values() if x.compiler.supports_target(target)]
     if len(actives) != 1:
@@ -269,6 +414,61 @@ def make_backend(target):
     return actives[0](target)
 
 
+class AsmFiles(Mapping):
+    """
+    The text of each level of IR generated during the compilation of a kernel,
+    and its binary, by extension. The files are only read from the cache when
+    they are first accessed.
+
+    `derived` maps additional keys to the functions computing them, e.g. the
+    disassembly of the binary, which are only called when first accessed.
+    """
+
+    def __init__(self, files, binary_ext, derived=None):
+        self.files = files
+        self.binary_ext = binary_ext
+        self.derived = derived or dict()
+        self.loaded = dict()
+
+    def __getitem__(self, ext):
+        if ext not in self.loaded:
+            if ext in self.derived:
+                self.loaded[ext] = self.derived[ext]()
+            else:
+                file = self.files[ext]
+                self.loaded[ext] = read_cache_file(file, binary=ext == self.binary_ext)
+        return self.loaded[ext]
+
+    def __contains__(self, ext):
+        return ext in self.files or ext in self.derived
+
+    def __iter__(self):
+        return iter([*self.files, *self.derived])
+
+    def __len__(self):
+        return len(self.files) + len(self.derived)
+
+
+_TRAFFIC_BOUND_OPS = {ast.Add: operator.add, ast.Sub: operator.sub, ast.Mult: operator.mul, ast.FloorDiv: operator.floordiv}
+
+
+def _eval_traffic_bound(bound, values):
+    # The bounds of the loops of the traffic estimates are Python expressions of
+    # the integer arguments of the kernel, e.g. "((arg3 + 31) // 32)".
+    def visit(node):
+        if isinstance(node, ast.Constant) and isinstance(node.value, int):
+            return node.value
+        if isinstance(node, ast.Name):
+            return int(values[node.id])
+        if isinstance(node, ast.UnaryOp) and isinstance(node.op, ast.USub):
+            return -visit(node.operand)
+        if isinstance(node, ast.BinOp) and type(node.op) in _TRAFFIC_BOUND_OPS:
+            return _TRAFFIC_BOUND_OPS[type(node.op)](visit(node.left), visit(node.right))
+        raise ValueError(f"unexpected bound {bound}")
+
+    return visit(ast.parse(bound, mode="eval").body)
+
+
 class CompiledKernel:
 
     # Hooks for external tools to monitor the execution of triton kernels
@@ -278,8 +478,8 @@ class CompiledKernel:
 
     def __init__(self, src, metadata_group):
         from collections import namedtuple
-        metadata_path = next((Path(p) for c, p in metadata_group.items() if c.endswith(".json")))
-        self.metadata = json.loads(metadata_path.read_text())
+        metadata_path = next((p for c, p in metadata_group.items() if c.endswith(".json")))
+        self.metadata = json.loads(read_cache_file(metadata_path, binary=False))
         self.metadata['tensormaps_info'] = [InfoFromBackendForTensorMap(e) for e in self.metadata['tensormaps_info']
                                             ] if 'tensormaps_info' in self.metadata else []
         for i, _ in enumerate(self.metadata["tensormaps_info"]):
@@ -291,34 +491,153 @@ class CompiledKernel:
         self.name = self.metadata.name
         # create launcher
         self.run = driver.active.launcher_cls(src, self.metadata)
-        # stores the text of each level of IR that was generated during compilation
+        # stores the text of each level of IR that was generated during compilation,
+        # only the binary is read eagerly
         asm_files = [Path(p) for c, p in metadata_group.items() if not c.endswith(".json")]
-        self.asm = {
-            file.suffix[1:]: file.read_bytes() if file.suffix[1:] == driver.active.binary_ext else file.read_text()
-            for file in asm_files
-        }
+        derived = {"zeasm": self._get_zeasm} if driver.active.binary_ext == "spv" else None
+        self.asm = AsmFiles({file.suffix[1:]: file for file in asm_files}, driver.active.binary_ext, derived)
         self.kernel = self.asm[driver.active.binary_ext]
         # binaries are lazily initialized
         # because it involves doing runtime things
         # (e.g., checking amount of shared memory on current device)
         self.module = None
         self.function = None
+        # the (module, function) loaded on each device the kernel has been
+        # launched on
+        self._handles = {}
+        # the values of the SPIR-V specialization constants the kernel is
+        # loaded with, and the kernels of `specialize` by their values
+        self._spec_constants = None
+        self._specializations = {}
+
+    def _get_zeasm(self):
+        # the Gen ISA of the native binary the kernel is finalized to for the
+        # current device
+        from ..tools.zeasm import get_zeasm
+        device = driver.active.get_current_device()
+        native = driver.active.utils.get_native_binary(self.name, self.kernel, self.metadata.shared, device,
+                                                       getattr(self.metadata, "build_flags", ""))
+        if native is None:
+            raise RuntimeError(f"The driver doesn't expose the native binary of {self.name}")
+        return get_zeasm(native, self.name, driver.active.get_current_target()[1])
+
+    def add_metadata(self, **values):
+        """Adds or replaces fields of the metadata of the kernel, e.g. the hardware counters of its runs."""
+        from collections import namedtuple
+        metadata = dict(self.metadata._asdict(), **values)
+        KernelMetadata = namedtuple('KernelMetadata', sorted(list(metadata.keys())))
+        self.metadata = KernelMetadata(**metadata)
+
+    def traffic(self, grid, args):
+        """
+        Estimates the bytes a launch of the kernel over `grid` reads and writes in global memory, and the FLOPs of
+        its dots, from the traffic of a program instance estimated by the compiler. `args` maps the names of the
+        arguments of the kernel to their values, the bounds of its loops are computed from them. Returns None when
+        the backend doesn't estimate the traffic of its kernels.
+
+        The masked accesses are counted whole, and the loops whose bounds aren't computed from the arguments are
+        counted once.
+        """
+        terms = getattr(self.metadata, "traffic", None)
+        if terms is None:
+            return None
+        if callable(grid):
+            grid = grid(args)
+        num_programs = math.prod(grid)
+        arg_names = getattr(self.metadata, "ir_arg_names", ())
+        values = {f"arg{i}": args[name] for i, name in enumerate(arg_names) if name in args}
+        totals = {"bytes_read": 0, "bytes_written": 0, "flops": 0}
+        for term in terms:
+            fields = term.split("|")
+            num_iters = 1
+            for bounds in zip(*[iter(fields[3:])] * 3):
+                try:
+                    lb, ub, step = (_eval_traffic_bound(bound, values) for bound in bounds)
+                    num_iters *= max(0, -(-(ub - lb) // step))
+                except (KeyError, TypeError, ValueError, SyntaxError, ZeroDivisionError):
+                    pass
+            for key, count in zip(totals, fields[:3]):
+                totals[key] += int(count) * num_iters * num_programs
+        return totals
+
+    def specialize(self, spec_constants):
+        """
+        Returns the kernel loaded with the values `spec_constants` of its SPIR-V specialization constants by id, of
+        `tl.spec_constant`, instead of their defaults. The kernels of different values share the compiled kernel and
+        its metadata, each of them is loaded on its own by the driver.
+        """
+        key = tuple(sorted(spec_constants.items()))
+        kernel = self._specializations.get(key)
+        if kernel is None:
+            types = dict(getattr(self.metadata, "spec_constants", ()))
+            unknown = [id for id in spec_constants if id not in types]
+            if unknown:
+                raise KeyError(f"{self.name} has no specialization constants {unknown}")
+            kernel = copy.copy(self)
+            kernel.module = kernel.function = None
+            kernel._handles = {}
+            kernel._specializations = {}
+            kernel._spec_constants = {id: (types[id], value) for id, value in spec_constants.items()}
+            self._specializations[key] = kernel
+        return kernel
 
     def _init_handles(self):
-        if self.module is not None:
-            return
         device = driver.active.get_current_device()
+        handles = self._handles.get(device)
+        if handles is not None:
+            self.module, self.function = handles
+            return
         # not enough shared memory to run the kernel
         max_shared = driver.active.utils.get_device_properties(device)["max_shared_mem"]
         if self.metadata.shared > max_shared:
             raise OutOfResources(self.metadata.shared, max_shared, "shared memory")
         if driver.active.get_current_target()[0] == "xpu":
-            self.module, self.function, self.n_regs, self.n_spills = driver.active.utils.load_binary(
-                self.name, self.kernel, self.metadata.shared, driver.active.utils.get_sycl_device(device))
+            # each device gets its own module, in the context of its queue
+            build_flags = getattr(self.metadata, "build_flags", "")
+            props = driver.active.utils.get_device_properties(device)
+            with reproducer.native_stage(self.name, self.metadata.hash, self.kernel, self.metadata.shared, build_flags,
+                                         props) as record:
+                self.module, self.function, n_regs, n_spills, kernel_props = driver.active.utils.load_binary(
+                    self.name, self.kernel, self.metadata.shared, device, self.metadata.hash, build_flags,
+                    self._spec_constants)
+                record.update(n_regs=n_regs, n_spills=n_spills)
+            if preload.active_manifest is not None:
+                preload.active_manifest.record_load(self, device)
+            if not self._handles:
+                # expose the resource usage of the loaded kernel through its metadata
+                self.n_regs, self.n_spills = n_regs, n_spills
+                remarks = list(getattr(self.metadata, "remarks", []))
+                if n_spills > 0:
+                    remark = ["native", "", f"{n_spills} bytes of spill memory"]
+                    remarks.append(remark)
+                    if os.environ.get("MLIR_ENABLE_REMARK", "0") == "1":
+                        print(f"{self.name}: remark: [native] {remark[2]}", file=sys.stderr)
+                # the work-groups of the loaded kernel resident on the device
+                occupancy = driver.active.utils.get_occupancy(device, self.metadata.num_warps, self.metadata.shared,
+                                                              n_regs)
+                self.add_metadata(n_regs=n_regs, n_spills=n_spills, remarks=remarks, occupancy=occupancy,
+                                  **kernel_props)
         else:
+            if self._spec_constants:
+                raise RuntimeError("specialization constants are only supported by the XPU driver")
             # TODO: n_regs, n_spills should be metadata generated when calling `ptxas`
             self.module, self.function, self.n_regs, self.n_spills = driver.active.utils.load_binary(
                 self.name, self.kernel, self.metadata.shared, device)
+        self._handles[device] = (self.module, self.function)
+
+    def __del__(self):
+        # release the kernels loaded by `_init_handles`, if the driver supports it
+        handles = self.__dict__.get("_handles")
+        if not handles:
+            return
+        try:
+            unload_binary = getattr(driver.active.utils, "unload_binary", None)
+            if unload_binary is not None:
+                for _, function in handles.values():
+                    unload_binary(function)
+        except Exception:
+            # the driver may already be torn down at interpreter exit
+            pass
 
     def __getattribute__(self, name):
         if name == 'run':
@@ -0,0 +1,232 @@
+"""
+Reproducers of the whole compilation of the kernels, from their Triton IR to
+their native binary, written with TRITON_REPRODUCER_DIR set. Each compilation
+writes a bundle in `$TRITON_REPRODUCER_DIR/<name>-<hash>`:
+
+    manifest.json        the target, options and environment of the
+                         compilation, and for each stage its input, the
+                         metadata it started with, its status and duration
+    <stage>-input.<ext>  the input of each stage, e.g. `spv-input.llir` for
+                         the LLVM IR the SPIR-V is translated from
+    llir-unoptimized.llir
+                         the LLVM IR before `optimize_module`
+    native-input.spv     the SPIR-V the Level Zero driver builds, whose build
+                         flags, device and build log are in the `native`
+                         stage of the manifest
+
+The input of a stage is written before the stage runs, so that the bundle of a
+compilation that crashes or hangs holds the input of the stage at fault.
+`pass_manager.run` still writes the MLIR reproducers of TRITON_REPRODUCER_PATH
+for the failures of single pass pipelines.
+
+A stage is replayed from its input by
+
+    python -m triton.compiler.reproducer <bundle> <stage>
+
+e.g. to time `optimize_module` and the SPIR-V translation of a kernel again
+with another LLVM, or IGC with other build flags for the `native` stage.
+"""
+
+import contextlib
+import json
+import os
+import sys
+import threading
+import time
+import traceback
+from pathlib import Path
+
+# the environment variables the stages depend on, recorded in the manifests
+ENV_PREFIXES = ("TRITON_", "MLIR_", "LLVM_", "IGC_", "ZE_", "SYCL_", "ONEAPI_")
+MANIFEST = "manifest.json"
+
+# the bundles of the compilations in progress, by hash
+_bundles = dict()
+_lock = threading.Lock()
+
+
+def enabled():
+    return bool(os.environ.get("TRITON_REPRODUCER_DIR"))
+
+
+def _dump(obj):
+    return json.dumps(obj, indent=2, default=lambda value: vars(value) if hasattr(value, "__dict__") else str(value))
+
+
+class Bundle:
+
+    def __init__(self, path):
+        self.path = Path(path)
+        self.path.mkdir(parents=True, exist_ok=True)
+        manifest = self.path / MANIFEST
+        self.manifest = json.loads(manifest.read_text()) if manifest.exists() else {"stages": {}}
+
+    def write(self, name, data):
+        if not isinstance(data, (bytes, str)) and hasattr(data, "write"):
+            data.write(str(self.path / name))
+            return name
+        mode = "wb" if isinstance(data, bytes) else "w"
+        with open(self.path / name, mode) as f:
+            f.write(data if isinstance(data, (bytes, str)) else str(data))
+        return name
+
+    def save(self):
+        # replaced at once, so that a crash leaves the last complete manifest
+        tmp = self.path / f"{MANIFEST}.{os.getpid()}.{threading.get_ident()}.tmp"
+        tmp.write_text(_dump(self.manifest))
+        os.replace(tmp, self.path / MANIFEST)
+
+    @contextlib.contextmanager
+    def stage(self, stage, record):
+        """Record the status and the duration of `stage`, whose `record` is saved first."""
+        record["status"] = "running"
+        self.manifest["stages"][stage] = record
+        self.save()
+        start = time.perf_counter()
+        try:
+            yield record
+        except BaseException as e:
+            record["status"] = "failed"
+            record["error"] = "".join(traceback.format_exception(type(e), e, e.__traceback__))
+            raise
+        else:
+            record["status"] = "done"
+        finally:
+            record["time"] = time.perf_counter() - start
+            self.save()
+
+
+def _bundle_path(name, hash):
+    return Path(os.environ["TRITON_REPRODUCER_DIR"]) / f"{name}-{hash}"
+
+
+def begin(name, hash, target, options, input_ext):
+    """Start the bundle of the compilation of `hash`, None unless enabled."""
+    if not enabled():
+        return None
+    bundle = Bundle(_bundle_path(name, hash))
+    env = {k: v for k, v in os.environ.items() if k.startswith(ENV_PREFIXES)}
+    bundle.manifest.update(name=name, hash=hash, target=target, options=options.__dict__, input_ext=input_ext,
+                           env=env, stages={})
+    bundle.save()
+    with _lock:
+        _bundles[hash] = bundle
+    return bundle
+
+
+def end(hash):
+    with _lock:
+        _bundles.pop(hash, None)
+
+
+@contextlib.contextmanager
+def stage(bundle, ext, input_ext, module, metadata):
+    """Write the input of stage `ext` of the compilation of `bundle`, if any, and record its outcome."""
+    if bundle is None:
+        yield
+        return
+    record = {
+        "input": bundle.write(f"{ext}-input.{input_ext}", module),
+        "input_ext": input_ext,
+        "metadata": json.loads(_dump(metadata)),
+    }
+    with bundle.stage(ext, record):
+        yield
+
+
+def add_file(metadata, name, data):
+    """
+    Write `data` to the bundle of the compilation of `metadata`, if any, e.g.
+    an intermediate input within a stage. `data` is only converted to a
+    string when it is written.
+    """
+    with _lock:
+        bundle = _bundles.get(metadata.get("hash"))
+    if bundle is not None:
+        bundle.write(name, data)
+
+
+@contextlib.contextmanager
+def native_stage(name, hash, binary, shared, build_flags, device_props):
+    """
+    Record the build of the SPIR-V `binary` by the driver, yielding a dict the
+    caller adds the outcome of the build to. The error of a failed build holds
+    the build log of the driver.
+    """
+    if not enabled():
+        yield {}
+        return
+    bundle = Bundle(_bundle_path(name, hash))
+    record = {
+        "input": bundle.write("native-input.spv", binary),
+        "shared": shared,
+        "build_flags": build_flags,
+        "device": dict(device_props),
+    }
+    with bundle.stage("native", record):
+        yield record
+
+
+def replay(path, stage, output=None):
+    """
+    Run `stage` of the bundle at `path` again from its input, with the target
+    and the options of the compilation, in this environment. Return the output
+    of the stage and its duration in seconds; the output is also written to
+    `output`, if given.
+    """
+    from .._C.libtriton import ir
+    from ..backends.compiler import GPUTarget
+    from ..runtime.driver import driver
+    from .compiler import make_backend
+
+    bundle = Bundle(path)
+    manifest = bundle.manifest
+    record = manifest["stages"][stage]
+    input_path = bundle.path / record["input"]
+    if stage == "native":
+        device = driver.active.get_current_device()
+        start = time.perf_counter()
+        result = driver.active.utils.load_binary(manifest.get("name", "kernel"), input_path.read_bytes(),
+                                                 record["shared"], device, None, record["build_flags"])
+        return result, time.perf_counter() - start
+
+    backend = make_backend(GPUTarget(**manifest["target"]))
+    options = backend.parse_options(manifest["options"])
+    stages = dict()
+    # the stages are split as they were in the bundle
+    old_dir = os.environ.get("TRITON_REPRODUCER_DIR")
+    os.environ["TRITON_REPRODUCER_DIR"] = str(bundle.path.parent)
+    try:
+        backend.add_stages(stages, options)
+    finally:
+        if old_dir is None:
+            del os.environ["TRITON_REPRODUCER_DIR"]
+        else:
+            os.environ["TRITON_REPRODUCER_DIR"] = old_dir
+    if record["input_ext"] in ("ttir", "ttgir"):
+        context = ir.context()
+        ir.load_dialects(context)
+        backend.load_dialects(context)
+        module = ir.parse_mlir_module(str(input_path), context)
+        module.context = context
+    elif record["input_ext"] == "spv":
+        module = input_path.read_bytes()
+    else:
+        module = input_path.read_text()
+    metadata = dict(record["metadata"])
+    start = time.perf_counter()
+    result = stages[stage](module, metadata)
+    duration = time.perf_counter() - start
+    if output is not None:
+        mode = "wb" if isinstance(result, bytes) else "w"
+        with open(output, mode) as f:
+            f.write(result if isinstance(result, (bytes, str)) else str(result))
+    return result, duration
+
+
+if __name__ == "__main__":
+    if len(sys.argv) not in (3, 4):
+        print("usage: python -m triton.compiler.reproducer <bundle> <stage> [<output>]", file=sys.stderr)
+        sys.exit(2)
+    _, seconds = replay(*sys.argv[1:])
+    print(f"{sys.argv[2]}: {seconds:.3f}s")
@@ -64,6 +64,7 @@ from .core import (
     float8e4nv,
     float8e5,
     function_type,
+    grid_barrier,
     histogram,
     inline_asm_elementwise,
     int1,
@@ -72,6 +73,9 @@ from .core import (
     int64,
     int8,
     load,
+    load_pages,
+    local_buffer,
+    local_memory,
     log,
     make_block_ptr,
     max_constancy,
@@ -81,15 +85,20 @@ from .core import (
     pi32_t,
     pointer_type,
     program_id,
+    range,
     reduce,
     reshape,
     sin,
+    spec_constant,
     sqrt,
     static_assert,
     static_print,
     store,
     static_range,
     tensor,
+    tensor_descriptor,
+    tensor_descriptor_type,
+    topk,
     trans,
     # triton,
     uint16,
@@ -163,6 +172,7 @@ __all__ = [
     "float8e5",
     "full",
     "function_type",
+    "grid_barrier",
     "histogram",
     "inline_asm_elementwise",
     "int1",
@@ -173,6 +183,9 @@ __all__ = [
     "ir",
     "math",
     "load",
+    "load_pages",
+    "local_buffer",
+    "local_memory",
     "log",
     "make_block_ptr",
     "max",
@@ -195,6 +208,7 @@ __all__ = [
     "randint4x",
     "randn",
     "randn4x",
+    "range",
     "ravel",
     "reduce",
     "reshape",
@@ -202,6 +216,7 @@ __all__ = [
     "sin",
     "softmax",
     "sort",
+    "spec_constant",
     "sqrt",
     "static_range",
     "static_assert",
@@ -210,6 +225,9 @@ __all__ = [
     "sum",
     "swizzle2d",
     "tensor",
+    "tensor_descriptor",
+    "tensor_descriptor_type",
+    "topk",
     "trans",
     "triton",
     "uint16",
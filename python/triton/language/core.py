@@ -1,5 +1,7 @@
 from __future__ import annotations
 
+import builtins
+
 from warnings import warn
 from contextlib import contextmanager
 from enum import Enum
@@ -381,7 +383,12 @@ class function_type(dtype):
         return f'fn ({self.param_types}) -> {self.ret_types}'
 
     def to_ir(self, builder: ir.builder):
-        ir_param_types = [ty.to_ir(builder) for ty in self.param_types]
+        ir_param_types = []
+        for ty in self.param_types:
+            if isinstance(ty, tensor_descriptor_type):
+                ir_param_types += ty.to_ir_args(builder)
+            else:
+                ir_param_types.append(ty.to_ir(builder))
         ret_types = [ret_type.to_ir(builder) for ret_type in self.ret_types]
         return builder.get_function_ty(ir_param_types, ret_types)
 
@@ -856,6 +863,32 @@ def num_programs(axis, _builder=None):
     return semantic.num_programs(axis, _builder)
 
 
+@builtin
+def spec_constant(id, default, dtype=None, _builder=None):
+    """
+    Returns the SPIR-V specialization constant :code:`id` of the kernel, a
+    scalar whose value is given when the kernel is loaded, e.g.
+    :code:`kernel[grid](..., spec_constants={0: 1e-6})`, and is
+    :code:`default` otherwise. The launches with different values of the
+    constants share the compiled kernel, only its native finalization
+    depends on them, so they suit the values which don't change the code of
+    the kernel: scalar epsilons, enable flags or small constants.
+
+    :param id: The id of the constant, a non-negative integer.
+    :type id: int
+    :param default: The value of the constant when it isn't given.
+    :type default: bool, int or float
+    :param dtype: The type of the constant, int1, int32, int64, float32 or
+        float64, by default int1 for a bool, int32 for an int and float32 for
+        a float.
+    :type dtype: dtype, optional
+    """
+    id = _constexpr_to_value(id)
+    default = _constexpr_to_value(default)
+    dtype = _constexpr_to_value(dtype)
+    return semantic.spec_constant(id, default, dtype, _builder)
+
+
 # -----------------------
 # Block Initialization
 # -----------------------
@@ -1059,21 +1092,36 @@ def expand_dims(input, axis, _builder=None):
 
 
 @builtin
-def dot(input, other, acc=None, allow_tf32=True, max_num_imprecise_acc=None, out_dtype=float32, _builder=None):
+def dot(input, other, acc=None, allow_tf32=True, max_num_imprecise_acc=None, out_dtype=float32, other_format=None,
+        precision=None, _builder=None):
     """
     Returns the matrix product of two blocks.
 
-    The two blocks must be two-dimensional and have compatible inner dimensions.
+    The two blocks must be two-dimensional and have compatible inner dimensions, or three-dimensional with the
+    same leading batch dimension, whose matrices are multiplied pairwise.
 
     :param input: The first tensor to be multiplied.
-    :type input: 2D tensor of scalar-type in {:code:`float16`, :code:`bfloat16`, :code:`float32`}
+    :type input: 2D or 3D tensor of scalar-type in {:code:`float16`, :code:`bfloat16`, :code:`float32`}
     :param other: The second tensor to be multiplied.
-    :type other: 2D tensor of scalar-type in {:code:`float16`, :code:`bfloat16`, :code:`float32`}
+    :type other: 2D or 3D tensor of scalar-type in {:code:`float16`, :code:`bfloat16`, :code:`float32`}
+    :param other_format: If :code:`"int4"` or :code:`"uint4"`, :code:`other` is an :code:`int8` tensor of 4-bit
+        integers packed two per byte along its first dimension, the low nibble first, which are unpacked to the
+        type of :code:`input` in the layout of the operand.
+    :type other_format: str, optional
+    :param precision: If :code:`"bf16x3"` or :code:`"tf32x3"`, the :code:`float32` blocks are split into the sum of
+        a high and a low part in :code:`bfloat16`, respectively :code:`tf32`, and multiplied as the three products
+        of the parts but the product of the low parts, accumulated in :code:`float32`. This gets close to the
+        accuracy of a :code:`float32` product, at the throughput of the matrix units.
+    :type precision: str, optional
     """
     allow_tf32 = _constexpr_to_value(allow_tf32)
     out_dtype = _constexpr_to_value(out_dtype)
     max_num_imprecise_acc = _constexpr_to_value(max_num_imprecise_acc)
-    return semantic.dot(input, other, acc, allow_tf32, max_num_imprecise_acc, out_dtype, _builder)
+    other_format = _constexpr_to_value(other_format)
+    precision = _constexpr_to_value(precision)
+    if precision is not None:
+        return semantic.split_precision_dot(input, other, acc, precision, _builder)
+    return semantic.dot(input, other, acc, allow_tf32, max_num_imprecise_acc, out_dtype, other_format, _builder)
 
 
 # -----------------------
@@ -1133,6 +1181,31 @@ def load(pointer, mask=None, other=None, boundary_check=tuple(), padding_option=
                          volatile, _builder)
 
 
+@builtin
+def load_pages(pointer, pages, page_size, cache_modifier="", eviction_policy="", _builder=None):
+    """
+    Return the block of the 2D block pointer `pointer` whose rows are gathered
+    from the pages of `page_size` consecutive rows of its tensor, e.g. the
+    keys or the values of a paged KV cache. The ith `page_size` rows of the
+    block are the rows of the page `pages[i]`, moved by the row offset of the
+    block pointer. The elements out of the tensor are zeros. Each page of the
+    block is read by 2D block reads on the devices that have them.
+
+    :param pointer: the block pointer of the pages, whose rows are a multiple of `page_size`
+    :param pages: a pointer to the int32 index of each page of the block
+    :param page_size: the rows of a page
+    :type page_size: int
+    :param cache_modifier: changes cache option in NVIDIA PTX
+    :type cache_modifier: str, optional
+    :param eviction_policy: changes eviction policy in NVIDIA PTX
+    :type eviction_policy: str, optional
+    """
+    page_size = _constexpr_to_value(page_size)
+    cache_modifier = _constexpr_to_value(cache_modifier)
+    eviction_policy = _constexpr_to_value(eviction_policy)
+    return semantic.load_pages(pointer, pages, page_size, cache_modifier, eviction_policy, _builder)
+
+
 @builtin
 def store(pointer, value, mask=None, boundary_check=(), cache_modifier="", eviction_policy="", _builder=None):
     """
@@ -1202,6 +1275,144 @@ def advance(base: tensor, offsets, _builder=None):
     return semantic.advance(base, offsets, _builder)
 
 
+class tensor_descriptor_type(dtype):
+    """
+    The type of the tensor descriptors of `element_ty` elements accessed by
+    blocks of `block_shape`, see `tensor_descriptor`.
+    """
+
+    def __init__(self, element_ty: dtype, block_shape: List[int]):
+        self.element_ty = element_ty
+        self.block_shape = [int(s) for s in block_shape]
+        self.name = self.__str__()
+
+    def to_ir_args(self, builder: ir.builder):
+        # the base pointer, the rows, the columns and the pitch
+        return [builder.get_ptr_ty(self.element_ty.to_ir(builder), 1)] + [builder.get_int64_ty()] * 3
+
+    def __str__(self):
+        return f'tensordesc<{self.element_ty}{self.block_shape}>'
+
+    def __repr__(self):
+        return self.__str__()
+
+    def __eq__(self, other) -> bool:
+        if not isinstance(other, tensor_descriptor_type):
+            return False
+        return self.element_ty == other.element_ty and self.block_shape == other.block_shape
+
+    def __ne__(self, other) -> bool:
+        return not self.__eq__(other)
+
+
+class tensor_descriptor:
+    """
+    A 2D tensor of contiguous rows passed to the kernel as a
+    `triton.tools.tensor_descriptor.TensorDescriptor`, whose blocks are loaded
+    and stored through block pointers, with 2D block IO on the devices that
+    have it. The elements of the blocks out of the tensor are zeros when
+    loaded and not written when stored.
+    """
+
+    def __init__(self, handles, type: tensor_descriptor_type):
+        self.handles = list(handles)
+        self.type = type
+        base, rows, cols, pitch = self.handles
+        self.base = tensor(base, pointer_type(type.element_ty))
+        self.shape = (tensor(rows, int64), tensor(cols, int64))
+        self.strides = (tensor(pitch, int64), constexpr(1))
+        self.block_shape = [constexpr(s) for s in type.block_shape]
+
+    def _block_ptr(self, offsets, builder):
+        return semantic.make_block_ptr(self.base, self.shape, self.strides, offsets, self.type.block_shape, (1, 0),
+                                       builder)
+
+    @builtin
+    def load(self, offsets, cache_modifier="", eviction_policy="", _builder=None):
+        """
+        Return the block of the tensor at `offsets`, the row and the column of
+        its first element.
+        """
+        cache_modifier = _constexpr_to_value(cache_modifier)
+        eviction_policy = _constexpr_to_value(eviction_policy)
+        return semantic.load(self._block_ptr(offsets, _builder), None, None, (0, 1), "zero", cache_modifier,
+                             eviction_policy, False, _builder)
+
+    @builtin
+    def load_pages(self, pages, page_size, col=0, cache_modifier="", eviction_policy="", _builder=None):
+        """
+        Return the block of the tensor whose ith `page_size` rows are those
+        of the page `pages[i]`, from the column `col`, see `load_pages`.
+        """
+        page_size = _constexpr_to_value(page_size)
+        cache_modifier = _constexpr_to_value(cache_modifier)
+        eviction_policy = _constexpr_to_value(eviction_policy)
+        return semantic.load_pages(self._block_ptr((0, col), _builder), pages, page_size, cache_modifier,
+                                   eviction_policy, _builder)
+
+    @builtin
+    def store(self, offsets, value, cache_modifier="", eviction_policy="", _builder=None):
+        """Store `value` as the block of the tensor at `offsets`."""
+        value = _to_tensor(value, _builder)
+        cache_modifier = _constexpr_to_value(cache_modifier)
+        eviction_policy = _constexpr_to_value(eviction_policy)
+        return semantic.store(self._block_ptr(offsets, _builder), value, None, (0, 1), cache_modifier, eviction_policy,
+                              _builder)
+
+
+class local_memory:
+    """
+    A buffer of the shared local memory of the program, of `shape` elements
+    of `dtype`, see `local_buffer`. Its elements are addressed by their
+    linear offsets in row-major order. The accesses of the threads of the
+    program are ordered by barriers inserted by the compiler.
+    """
+
+    def __init__(self, handle, dtype: dtype, shape: List[int]):
+        self.handle = handle
+        self.dtype = dtype
+        self.shape = [int(s) for s in shape]
+
+    def __str__(self):
+        return f'local_memory<{self.dtype}{self.shape}>'
+
+    @builtin
+    def load(self, offsets=None, _builder=None):
+        """
+        Return the elements of the buffer, all of them, or those at the
+        `offsets`, a tensor of int32 offsets of their shape.
+        """
+        return semantic.local_load(self, offsets, _builder)
+
+    @builtin
+    def store(self, value, offsets=None, _builder=None):
+        """
+        Store `value` to the buffer, as a whole, or to the `offsets`, a tensor
+        of int32 offsets `value` is broadcast to.
+        """
+        value = _to_tensor(value, _builder)
+        return semantic.local_store(self, value, offsets, _builder)
+
+
+@builtin
+def local_buffer(shape, dtype, _builder=None):
+    """
+    Returns a buffer of the shared local memory of the program, of the given
+    :code:`shape` and :code:`dtype`, whose elements are loaded and stored by
+    its :code:`load` and :code:`store` methods, e.g. for lookup tables or
+    cooperative gathers. Its initial contents are undefined. A buffer is only
+    accessed by the function that allocates it.
+
+    :param shape: Shape of the buffer, e.g., (8, 16) or (8, )
+    :type shape: tuple of ints
+    :param dtype: Data-type of the elements, e.g., :code:`tl.float16`
+    :type dtype: DType
+    """
+    shape = _shape_check_impl(shape)
+    dtype = _constexpr_to_value(dtype)
+    return semantic.local_buffer(shape, dtype, _builder)
+
+
 # -----------------------
 # Atomic Memory Operations
 # -----------------------
@@ -1526,7 +1737,7 @@ def reduce(input, axis, combine_fn, keep_dims=False, _builder=None, _generator=N
             _builder.create_reduce_ret(*handles)
 
     def expand_ndims(t, ndims):
-        for _ in range(ndims):
+        for _ in builtins.range(ndims):
             t = expand_dims(t, 0, _builder=_builder)
         return t
 
@@ -1561,7 +1772,7 @@ def _reduce_with_indices(input, axis, combine_fn, keep_dims=False, _builder=None
 
     if len(input.shape) > 1:
         # Broadcast index across the non-reduced axes
-        axes_to_expand = [constexpr(d) for d in range(len(input.shape))]
+        axes_to_expand = [constexpr(d) for d in builtins.range(len(input.shape))]
         del axes_to_expand[axis]
         index = expand_dims(index, axes_to_expand, _builder=_builder)
         index = broadcast_to(index, input.shape, _builder=_builder)
@@ -1624,6 +1835,28 @@ def associative_scan(input, axis, combine_fn, _builder=None, _generator=None):
     return semantic.associative_scan(input, axis, make_combine_region, _builder)
 
 
+@builtin
+def _sort(input, dim, descending, _builder=None):
+    """sorts input along dim with tt.sort, see standard.sort"""
+    dim = _wrap_axis(_constexpr_to_value(dim), len(input.shape))
+    return semantic.sort(input, dim, bool(_constexpr_to_value(descending)), _builder)
+
+
+@builtin
+def topk(input, k, dim=None, _builder=None, _generator=None):
+    """returns the k largest elements of input along dim, in descending order.
+
+    :param input: the input tensor, of floating point or signed integer elements
+    :param k: the number of elements, a power of two
+    :param dim: the dimension, the last one by default, of a power of two size
+
+    """
+    k = _constexpr_to_value(k)
+    dim = _constexpr_to_value(dim)
+    dim = len(input.shape) - 1 if dim is None else _wrap_axis(dim, len(input.shape))
+    return semantic.topk(input, k, dim, _builder)
+
+
 @builtin
 def histogram(input, num_bins, _builder=None, _generator=None):
     """computes an histogram based on input tensor with num_bins bins the bins have a width of 1 and start at 0.
@@ -1649,6 +1882,19 @@ def debug_barrier(_builder=None):
     return semantic.debug_barrier(_builder)
 
 
+@builtin
+def grid_barrier(_builder=None):
+    '''
+    Insert a barrier to synchronize all the programs of the grid: the writes
+    to global memory of the programs before the barrier are visible to their
+    reads after it. The kernel is launched cooperatively, with all its
+    programs resident at once, so its grid must fit in the device, the launch
+    fails otherwise. All the programs must reach the barrier, e.g. it isn't in
+    a branch taken by some of them only.
+    '''
+    return semantic.grid_barrier(_builder)
+
+
 @builtin
 def multiple_of(input, values, _builder=None):
     """
@@ -1827,6 +2073,9 @@ def inline_asm_elementwise(asm: str, constraints: str, args: Sequence, dtype: Un
         Input elements of size less than 4 bytes are packed into 4-byte
         registers.
 
+        On XPU, the asm is vISA, run by each sub-group over its lanes, with the
+        vISA constraints of its operands, e.g. :code:`"=rw,rw,rw"`.
+
         This op does not support empty :code:`dtype` -- the inline asm must
         return at least one tensor, even if you don't need it.  You can work
         around this by returning a dummy tensor of arbitrary type; it shouldn't
@@ -1986,6 +2235,49 @@ class static_range:
         raise RuntimeError("static_range can only be used in @triton.jit'd functions")
 
 
+class range:
+    """
+    Iterator that counts upward forever, like Python's :code:`range`, with
+    hints to the compiler about the loop.
+
+    .. highlight:: python
+    .. code-block:: python
+
+        @triton.jit
+        def kernel(...):
+            for i in tl.range(0, K, BLOCK_K, loop_unroll_factor=2):
+                ...
+    :note: This is a special iterator used to implement similar semantics to Python's :code:`range` in the context of
+        :code:`triton.jit` functions. Unlike :code:`static_range`, its bounds may be dynamic.
+    :param arg1: the start value.
+    :param arg2: the end value.
+    :param step: the step value.
+    :param loop_unroll_factor: the number of iterations of the loop the body of the compiled loop runs, the remaining
+        ones running in a loop of their own. The loop isn't unrolled when it is None or 1.
+    """
+
+    def __init__(self, arg1, arg2=None, step=None, loop_unroll_factor=None):
+        if step is None:
+            self.step = constexpr(1)
+        else:
+            self.step = step
+        if arg2 is None:
+            self.start = constexpr(0)
+            self.end = arg1
+        else:
+            self.start = arg1
+            self.end = arg2
+        self.loop_unroll_factor = _constexpr_to_value(loop_unroll_factor)
+        assert self.loop_unroll_factor is None or self.loop_unroll_factor >= 1, \
+            "loop_unroll_factor must be a positive integer"
+
+    def __iter__(self):
+        raise RuntimeError("tl.range can only be used in @triton.jit'd functions")
+
+    def __next__(self):
+        raise RuntimeError("tl.range can only be used in @triton.jit'd functions")
+
+
 # -----------------------
 # Extern functions
 # -----------------------
@@ -2050,7 +2342,7 @@ def extern_elementwise(lib_name: str, lib_path: str, args: list, arg_type_symbol
     all_scalar = True
     ret_shape = None
     arg_types = []
-    for i in range(len(dispatch_args)):
+    for i in builtins.range(len(dispatch_args)):
         dispatch_args[i] = _to_tensor(dispatch_args[i], _builder)
         arg_types.append(dispatch_args[i].dtype)
         if dispatch_args[i].type.is_block():
@@ -2067,7 +2359,7 @@ def extern_elementwise(lib_name: str, lib_path: str, args: list, arg_type_symbol
             _, broadcast_arg = semantic.binary_op_type_checking_impl(item, broadcast_arg, _builder,
                                                                      arithmetic_check=arithmetic_check)
         # Change the shape of each argument based on the broadcast shape
-        for i in range(len(dispatch_args)):
+        for i in builtins.range(len(dispatch_args)):
             dispatch_args[i], _ = semantic.binary_op_type_checking_impl(dispatch_args[i], broadcast_arg, _builder,
                                                                         arithmetic_check=arithmetic_check)
         if not all_scalar:
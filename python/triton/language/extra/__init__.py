@@ -1,3 +1,4 @@
 from . import cuda
+from . import intel
 
-__all__ = ['cuda']
+__all__ = ['cuda', 'intel']
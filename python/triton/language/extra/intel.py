@@ -0,0 +1,106 @@
+from .. import core
+
+# The scopes of the SPIR-V builtins.
+_DEVICE_SCOPE = 1
+_SUBGROUP_SCOPE = 3
+
+# The mangled suffixes of the SPIR-V builtins operand types.
+_MANGLED_TYPES = {
+    core.int32: "i",
+    core.uint32: "j",
+    core.int64: "l",
+    core.uint64: "m",
+    core.float16: "Dh",
+    core.float32: "f",
+    core.float64: "d",
+}
+
+
+def _spirv_name(name, operand_types):
+    return f"_Z{len(name)}{name}{operand_types}"
+
+
+@core.extern
+def globaltimer(_builder=None):
+    return core.extern_elementwise("", "", [_DEVICE_SCOPE], {
+        (core.int32, ): (_spirv_name("__spirv_ReadClockKHR", "i"), core.int64),
+    }, is_pure=False, _builder=_builder)
+
+
+@core.extern
+def clock(_builder=None):
+    return core.extern_elementwise("", "", [_SUBGROUP_SCOPE], {
+        (core.int32, ): (_spirv_name("__spirv_ReadClockKHR", "i"), core.int64),
+    }, is_pure=False, _builder=_builder)
+
+
+@core.extern
+def xe_core_id(_builder=None):
+    return core.extern_elementwise("", "", [], {
+        (): ("__builtin_IB_get_subslice_id", core.int32),
+    }, is_pure=True, _builder=_builder)
+
+
+@core.extern
+def eu_id(_builder=None):
+    return core.extern_elementwise("", "", [], {
+        (): ("__builtin_IB_get_eu_id", core.int32),
+    }, is_pure=True, _builder=_builder)
+
+
+@core.extern
+def sub_group_id(_builder=None):
+    return core.extern_elementwise("", "", [], {
+        (): (_spirv_name("__spirv_BuiltInSubgroupId", "v"), core.int32),
+    }, is_pure=True, _builder=_builder)
+
+
+@core.extern
+def sub_group_local_id(_builder=None):
+    return core.extern_elementwise("", "", [], {
+        (): (_spirv_name("__spirv_BuiltInSubgroupLocalInvocationId", "v"), core.int32),
+    }, is_pure=True, _builder=_builder)
+
+
+@core.extern
+def sub_group_size(_builder=None):
+    return core.extern_elementwise("", "", [], {
+        (): (_spirv_name("__spirv_BuiltInSubgroupSize", "v"), core.int32),
+    }, is_pure=True, _builder=_builder)
+
+
+def _sub_group_exchange(name, x, lane, _builder):
+    # The lane is an unsigned integer in the SPIR-V builtins.
+    return core.extern_elementwise(
+        "", "", [_SUBGROUP_SCOPE, x, lane], {
+            (core.int32, dtype, core.int32): (_spirv_name(name, f"i{mangled}j"), dtype)
+            for dtype, mangled in _MANGLED_TYPES.items()
+        }, is_pure=True, _builder=_builder)
+
+
+@core.extern
+def sub_group_shuffle(x, lane, _builder=None):
+    return _sub_group_exchange("__spirv_GroupNonUniformShuffle", x, lane, _builder)
+
+
+@core.extern
+def sub_group_broadcast(x, lane, _builder=None):
+    # `lane` must be the same for all the work-items of the sub-group.
+    return _sub_group_exchange("__spirv_GroupNonUniformBroadcast", x, lane, _builder)
+
+
+@core.extern
+def ballot(pred, _builder=None):
+    # The bitmask of the work-items of the sub-group for which `pred` holds,
+    # built with a bitwise-or reduction of their bits across the sub-group.
+    pred = core._to_tensor(pred, _builder).to(core.int32, _builder=_builder)
+    bits = pred.__lshift__(sub_group_local_id(_builder=_builder), _builder=_builder)
+    # The group operation 0 is the reduction.
+    return core.extern_elementwise("", "", [_SUBGROUP_SCOPE, 0, bits], {
+        (core.int32, core.int32, core.int32): (_spirv_name("__spirv_GroupNonUniformBitwiseOr", "iii"), core.int32),
+    }, is_pure=True, _builder=_builder)
+
+
+@core.builtin
+def num_threads(_builder=None):
+    return core.constexpr(_builder.options.num_warps * _builder.options.threads_per_warp)
@@ -1,5 +1,6 @@
 from ..runtime.jit import jit
 from . import core as tl
+from . import semantic
 from . import standard
 
 N_ROUNDS_DEFAULT = 10  # Default number of rounds for philox
@@ -127,16 +128,35 @@ def uint_to_uniform_float(x):
     return x * scale
 
 
+@tl.builtin
+def philox_words(seed, offset, n_rounds, _builder=None):
+    """
+    Returns the word :code:`offset % 4` of Philox for the counter
+    :code:`offset // 4`, the four words of a counter being generated once for
+    four consecutive offsets.
+    """
+    n_rounds = tl._constexpr_to_value(n_rounds)
+    seed = tl._to_tensor(seed, _builder)
+    offset = tl._to_tensor(offset, _builder)
+    return semantic.philox(seed, offset, n_rounds, _builder)
+
+
 @jit
 def rand(seed, offset, n_rounds: tl.constexpr = N_ROUNDS_DEFAULT):
     """
     Given a :code:`seed` scalar and an :code:`offset` block,
     returns a block of random :code:`float32` in :math:`U(0, 1)`.
 
+    The :code:`int32` offsets use all the words of the Philox counters, four
+    consecutive offsets sharing the same counter.
+
     :param seed: The seed for generating random numbers.
     :param offsets: The offsets to generate random numbers for.
     """
-    source = randint(seed, offset, n_rounds)
+    if tl.constexpr(offset.dtype == tl.int32):
+        source = philox_words(seed, offset, n_rounds)
+    else:
+        source = randint(seed, offset, n_rounds)
     return uint_to_uniform_float(source)
 
 
@@ -35,6 +35,34 @@ def num_programs(axis: int, builder: ir.builder) -> tl.tensor:
     return tl.tensor(builder.create_get_num_programs(axis), tl.int32)
 
 
+# The Itanium codes of the types of the specialization constants, in the
+# mangled names of the SPIR-V builtins the SPIR-V translator lowers to
+# OpSpecConstant.
+_SPEC_CONSTANT_TYPE_CODES = {tl.int1: "b", tl.int32: "i", tl.int64: "l", tl.float32: "f", tl.float64: "d"}
+
+
+def spec_constant(id: int, default, dtype: tl.dtype, builder: ir.builder) -> tl.tensor:
+    if not isinstance(id, int) or id < 0:
+        raise ValueError(f"the id of a specialization constant must be a non-negative int, not {id}")
+    if not isinstance(default, (bool, int, float)):
+        raise TypeError(f"the default of a specialization constant must be a bool, an int or a float, not {default}")
+    if dtype is None:
+        dtype = tl.int1 if isinstance(default, bool) else tl.int32 if isinstance(default, int) else tl.float32
+    if dtype not in _SPEC_CONSTANT_TYPE_CODES:
+        raise TypeError(f"unsupported type of specialization constant {dtype}")
+    if dtype.is_int() and not isinstance(default, int):
+        raise TypeError(f"the default of an {dtype} specialization constant must be an int, not {default}")
+    symbol = "_Z20__spirv_SpecConstanti" + _SPEC_CONSTANT_TYPE_CODES[dtype]
+    if dtype.is_floating():
+        value = builder.get_fp64(default) if dtype.is_fp64() else builder.get_fp32(default)
+    else:
+        value = builder.get_int1(default) if dtype.is_bool() else builder.get_int64(
+            default) if dtype.is_int64() else builder.get_int32(default)
+    return tl.tensor(
+        builder.create_extern_elementwise("", "", symbol, [builder.get_int32(id), value], dtype.to_ir(builder), True),
+        dtype)
+
+
 # ===----------------------------------------------------------------------===//
 #                               Implicit Casting Utilities
 # ===----------------------------------------------------------------------===//
@@ -974,6 +1002,23 @@ def load(ptr: tl.tensor, mask: Optional[tl.tensor], other: Optional[tl.tensor],
         return _load_legacy(ptr, mask, other, boundary_check, padding, cache, eviction, is_volatile, builder)
 
 
+def load_pages(ptr: tl.tensor, pages: tl.tensor, page_size: int, cache_modifier: str, eviction_policy: str,
+               builder: ir.builder) -> tl.tensor:
+    if not (ptr.type.is_ptr() and ptr.type.element_ty.is_block()):
+        raise ValueError("`load_pages` expects a block pointer")
+    dst_ty = ptr.type.element_ty
+    shape = dst_ty.get_block_shapes()
+    if len(shape) != 2:
+        raise ValueError("`load_pages` expects a 2D block pointer")
+    if page_size <= 0 or shape[0] % page_size != 0:
+        raise ValueError(f"the rows of the block, {shape[0]}, must be a multiple of the page size, {page_size}")
+    if pages.type.is_block() or not pages.type.is_ptr() or pages.type.element_ty != tl.int32:
+        raise ValueError(f"the pages must be a pointer to int32, not {pages.type}")
+    cache = _str_to_load_cache_modifier(cache_modifier)
+    eviction = _str_to_eviction_policy(eviction_policy)
+    return tl.tensor(builder.create_load_pages(ptr.handle, pages.handle, page_size, cache, eviction), dst_ty)
+
+
 def _store_block_pointer(ptr, val, mask, boundary_check, cache, eviction, builder):
     # Store by a block pointer: `pointer_type<block_type<>>`
     # Block pointers can not have the `mask` argument
@@ -1219,8 +1264,17 @@ def atomic_xchg(ptr: tl.tensor, val: tl.tensor, mask: tl.tensor, sem: str, scope
 # ===----------------------------------------------------------------------===//
 
 
+def unpack_int4(input: tl.tensor, dtype: tl.dtype, is_signed: bool, builder: ir.builder) -> tl.tensor:
+    assert input.type.is_block() and len(input.shape) == 2, f"Packed int4 input ({input.shape}) is not two dimensional!"
+    assert input.dtype.is_int8() or input.dtype.is_uint8(), f"Packed int4 input ({input.dtype}) must be int8 or uint8"
+    assert dtype.is_int8() or dtype.is_fp16() or dtype.is_bf16() or dtype.is_fp32(), \
+        f"Unsupported dtype {dtype} to unpack int4 values to"
+    ret_ty = tl.block_type(dtype, [2 * input.shape[0].value, input.shape[1].value])
+    return tl.tensor(builder.create_unpack_int4(input.handle, ret_ty.to_ir(builder), is_signed), ret_ty)
+
+
 def dot(lhs: tl.tensor, rhs: tl.tensor, acc: tl.tensor, allow_tf32: bool, max_num_imprecise_acc: int,
-        out_dtype: tl.dtype, builder: ir.builder) -> tl.tensor:
+        out_dtype: tl.dtype, rhs_format: str, builder: ir.builder) -> tl.tensor:
 
     def assert_dtypes_valid(lhs_dtype, rhs_dtype, options):
         if not options.allow_fp8e4nv:
@@ -1252,19 +1306,29 @@ def dot(lhs: tl.tensor, rhs: tl.tensor, acc: tl.tensor, allow_tf32: bool, max_nu
 
     assert lhs.type.is_block() and rhs.type.is_block()
 
+    if rhs_format is not None:
+        # the packed values are unpacked in the layout of the operand
+        assert rhs_format in ("int4", "uint4"), f"Unsupported second input format {rhs_format}"
+        rhs = unpack_int4(rhs, lhs.dtype, rhs_format == "int4", builder)
+
     assert_dtypes_valid(lhs.dtype, rhs.dtype, builder.options)
 
-    assert len(lhs.shape) == 2, f"First input shape ({lhs.shape}) is not two dimensional!"
-    assert len(rhs.shape) == 2, f"Second input shape ({rhs.shape}) is not two dimensional!"
-    assert lhs.shape[1].value == rhs.shape[
-        0].value, f"First input shape ({lhs.shape}) and second input shape {rhs.shape} are not compatible for matmul (second index of first shape ({lhs.shape[1].value}) must be equal to first index of second shape ({rhs.shape[0].value})"
-    assert lhs.shape[0].value >= 16 and lhs.shape[1].value >= 16 \
-        and rhs.shape[1].value >= 16, \
+    # the batched dots multiply the matrices of their leading batch dimension
+    assert len(lhs.shape) in (2, 3), f"First input shape ({lhs.shape}) is not two or three dimensional!"
+    assert len(rhs.shape) == len(lhs.shape), \
+        f"First input shape ({lhs.shape}) and second input shape ({rhs.shape}) don't have the same rank!"
+    if len(lhs.shape) == 3:
+        assert lhs.shape[0].value == rhs.shape[
+            0].value, f"First input shape ({lhs.shape}) and second input shape ({rhs.shape}) don't have the same batch size!"
+    assert lhs.shape[-1].value == rhs.shape[
+        -2].value, f"First input shape ({lhs.shape}) and second input shape {rhs.shape} are not compatible for matmul (last index of first shape ({lhs.shape[-1].value}) must be equal to second to last index of second shape ({rhs.shape[-2].value})"
+    assert lhs.shape[-2].value >= 16 and lhs.shape[-1].value >= 16 \
+        and rhs.shape[-1].value >= 16, \
         f"All values in both first input shape ({lhs.shape}) and second input shape ({rhs.shape}) must be >= 16!"
     if lhs.type.scalar.is_int():
         assert lhs.type.scalar == tl.int8, "only int8 supported!"
         # TODO: This is CUDA specific, check if ROCm has the same limitation
-        assert lhs.shape[1].value >= 32, "small blocks not supported!"
+        assert lhs.shape[-1].value >= 32, "small blocks not supported!"
         _0 = builder.get_int32(0)
         ret_scalar_ty = tl.int32
     elif out_dtype.is_bf16():
@@ -1277,12 +1341,13 @@ def dot(lhs: tl.tensor, rhs: tl.tensor, acc: tl.tensor, allow_tf32: bool, max_nu
         _0 = builder.get_fp16(0) if out_dtype.is_fp16() else builder.get_fp32(0)
         ret_scalar_ty = out_dtype
 
-    M = lhs.type.shape[0]
-    N = rhs.type.shape[1]
+    M = lhs.type.shape[-2]
+    N = rhs.type.shape[-1]
+    ret_shape = [*lhs.type.shape[:-2], M, N]
 
-    ret_ty = tl.block_type(ret_scalar_ty, [M, N])
+    ret_ty = tl.block_type(ret_scalar_ty, ret_shape)
     if acc is None:
-        acc_handle = builder.create_splat(_0, [M, N])
+        acc_handle = builder.create_splat(_0, ret_shape)
     else:
         acc_handle = acc.handle
         assert acc.type == ret_ty
@@ -1297,6 +1362,33 @@ def dot(lhs: tl.tensor, rhs: tl.tensor, acc: tl.tensor, allow_tf32: bool, max_nu
     return tl.tensor(builder.create_dot(lhs.handle, rhs.handle, acc_handle, allow_tf32, max_num_imprecise_acc), ret_ty)
 
 
+def split_fp32(input: tl.tensor, precision: str, builder: ir.builder) -> Tuple[tl.tensor, tl.tensor]:
+    """Splits `input` into the high and low parts of `precision` it is the sum of."""
+    if precision == "bf16x3":
+        hi = cast(input, tl.bfloat16, builder)
+        lo = cast(sub(input, cast(hi, tl.float32, builder), builder), tl.bfloat16, builder)
+        return hi, lo
+    # tf32 keeps the 10 high bits of the mantissa of fp32
+    mask = full(input.type.shape, 0xFFFFE000 - (1 << 32), tl.int32, builder)
+    hi = bitcast(and_(bitcast(input, tl.int32, builder), mask, builder), tl.float32, builder)
+    return hi, sub(input, hi, builder)
+
+
+def split_precision_dot(lhs: tl.tensor, rhs: tl.tensor, acc: tl.tensor, precision: str,
+                        builder: ir.builder) -> tl.tensor:
+    # lhs * rhs ~ lhs_hi * rhs_hi + lhs_hi * rhs_lo + lhs_lo * rhs_hi, the
+    # small products first so that they aren't absorbed by the large one.
+    assert precision in ("bf16x3", "tf32x3"), f"Unsupported dot precision {precision}"
+    assert lhs.type.is_block() and rhs.type.is_block()
+    assert lhs.dtype.is_fp32() and rhs.dtype.is_fp32(), \
+        f"Dot precision {precision} only applies to float32 inputs ({lhs.dtype} and {rhs.dtype})"
+    lhs_hi, lhs_lo = split_fp32(lhs, precision, builder)
+    rhs_hi, rhs_lo = split_fp32(rhs, precision, builder)
+    for x, y in ((lhs_lo, rhs_hi), (lhs_hi, rhs_lo), (lhs_hi, rhs_hi)):
+        acc = dot(x, y, acc, True, None, tl.float32, None, builder)
+    return acc
+
+
 # ===----------------------------------------------------------------------===//
 #                               Indexing
 # ===----------------------------------------------------------------------===//
@@ -1393,6 +1485,81 @@ def histogram(input: tl.tensor, num_bins: int, builder: ir.builder) -> tl.tensor
     return tl.tensor(histogram_op.get_result(0), tl.block_type(tl.int32, (num_bins, )))
 
 
+# ===----------------------------------------------------------------------===
+#                               Sort
+# ===----------------------------------------------------------------------===
+
+
+def _check_sort_input(input: tl.tensor, axis: int, name: str):
+    assert input.type.is_block(), f"{name} only supports tensors"
+    assert 0 <= axis < len(input.shape), f"{name} axis {axis} out of range for a {len(input.shape)}D tensor"
+    size = input.shape[axis]
+    assert size & (size - 1) == 0, f"{name} only supports axes of a power of two size, not {size}"
+
+
+def sort(input: tl.tensor, axis: int, descending: bool, builder: ir.builder) -> tl.tensor:
+    _check_sort_input(input, axis, "sort")
+    return tl.tensor(builder.create_sort(input.handle, axis, descending), input.type)
+
+
+def topk(input: tl.tensor, k: int, axis: int, builder: ir.builder) -> tl.tensor:
+    _check_sort_input(input, axis, "topk")
+    assert input.dtype.is_floating() and input.dtype.primitive_bitwidth >= 16 or input.dtype.is_int_signed(), \
+        f"topk doesn't support {input.dtype}"
+    assert 0 < k <= input.shape[axis] and k & (k - 1) == 0, \
+        f"topk only supports a power of two k no larger than {input.shape[axis]}, not {k}"
+    shape = list(input.shape)
+    shape[axis] = k
+    return tl.tensor(builder.create_topk(input.handle, axis, k), tl.block_type(input.dtype, shape))
+
+
+# ===----------------------------------------------------------------------===
+#                               Local Memory
+# ===----------------------------------------------------------------------===
+
+
+def local_buffer(shape: List[int], dtype: tl.dtype, builder: ir.builder) -> tl.local_memory:
+    assert len(shape) > 0, "local_buffer only supports tensors"
+    assert (dtype.is_floating() or dtype.is_int()) and dtype.primitive_bitwidth >= 8, \
+        f"local_buffer doesn't support {dtype}"
+    return tl.local_memory(builder.create_local_buffer(shape, dtype.to_ir(builder)), dtype, shape)
+
+
+def _check_local_offsets(offsets: Optional[tl.tensor], name: str):
+    if offsets is not None:
+        assert offsets.type.is_block() and offsets.dtype == tl.int32, \
+            f"{name} only supports tensors of int32 offsets, not {offsets.type}"
+
+
+def local_load(buffer: tl.local_memory, offsets: Optional[tl.tensor], builder: ir.builder) -> tl.tensor:
+    _check_local_offsets(offsets, "local_load")
+    shape = buffer.shape if offsets is None else offsets.type.get_block_shapes()
+    handle = builder.create_local_load(buffer.handle, None if offsets is None else offsets.handle)
+    return tl.tensor(handle, tl.block_type(buffer.dtype, shape))
+
+
+def local_store(buffer: tl.local_memory, value: tl.tensor, offsets: Optional[tl.tensor],
+                builder: ir.builder) -> tl.tensor:
+    _check_local_offsets(offsets, "local_store")
+    shape = buffer.shape if offsets is None else offsets.type.get_block_shapes()
+    value = broadcast_impl_shape(cast(value, buffer.dtype, builder), shape, builder)
+    offsets = None if offsets is None else offsets.handle
+    return tl.tensor(builder.create_local_store(buffer.handle, value.handle, offsets), tl.void)
+
+
+# ===----------------------------------------------------------------------===
+#                               Philox
+# ===----------------------------------------------------------------------===
+
+
+def philox(seed: tl.tensor, offset: tl.tensor, n_rounds: int, builder: ir.builder) -> tl.tensor:
+    assert offset.dtype == tl.int32, "philox only supports int32 offsets"
+    seed = cast(seed, tl.int64, builder)
+    if offset.type.is_block():
+        seed = splat(seed, offset.shape, builder)
+    return tl.tensor(builder.create_philox(seed.handle, offset.handle, n_rounds), offset.type)
+
+
 # ===----------------------------------------------------------------------===
 #                               Math
 # ===----------------------------------------------------------------------===
@@ -1502,6 +1669,10 @@ def debug_barrier(builder: ir.builder) -> tl.tensor:
     return tl.tensor(builder.create_barrier(), tl.void)
 
 
+def grid_barrier(builder: ir.builder) -> tl.tensor:
+    return tl.tensor(builder.create_grid_barrier(), tl.void)
+
+
 def device_print(prefix: str, args: List[tl.tensor], builder: ir.builder) -> tl.tensor:
     # It makes sense visually for prefix to end in ": "; make it so.  Also,
     # non-empty prefixes should start with " ".
@@ -401,18 +401,34 @@ def _get_sort_dim(dim, shape):
     return core.constexpr(dim)
 
 
+def _has_sort_op(dtype):
+    # tt.sort compares the floating point types of at least 16 bits and the
+    # signed integers, the other types are sorted by the generic network.
+    dtype = _unwrap_if_constexpr(dtype)
+    return core.constexpr((dtype.is_floating() and dtype.primitive_bitwidth >= 16) or dtype.is_int_signed())
+
+
+def _get_sort_op_dim(dim, shape):
+    dim = _unwrap_if_constexpr(dim)
+    shape = _unwrap_if_constexpr(shape)
+    return core.constexpr(len(shape) - 1 if dim is None else dim)
+
+
 @jit
 def sort(x, dim=None, descending: core.constexpr = 0):
-    core.static_assert(_is_power_of_two(x.shape[_get_sort_dim(dim, x.shape)]))
-    core.static_assert(_is_power_of_two(x.numel))
-    # reshape the tensor to have all dimensions be 2.
-    # TODO: We shouldn't have to change the dimensions not sorted.
-    y = core.reshape(x, [2] * _log2(x.numel))
-    for i in core.static_range(1, _log2(x.shape[_get_sort_dim(dim, x.shape)]) + 1):
-        y = _bitonic_merge(y, _log2(x.numel), i, (descending if
-                                                  (i == _log2(x.shape[_get_sort_dim(dim, x.shape)])) else 2))
-
-    x = core.reshape(y, x.shape)
+    if _has_sort_op(x.dtype):
+        x = core._sort(x, _get_sort_op_dim(dim, x.shape), descending)
+    else:
+        core.static_assert(_is_power_of_two(x.shape[_get_sort_dim(dim, x.shape)]))
+        core.static_assert(_is_power_of_two(x.numel))
+        # reshape the tensor to have all dimensions be 2.
+        # TODO: We shouldn't have to change the dimensions not sorted.
+        y = core.reshape(x, [2] * _log2(x.numel))
+        for i in core.static_range(1, _log2(x.shape[_get_sort_dim(dim, x.shape)]) + 1):
+            y = _bitonic_merge(y, _log2(x.numel), i, (descending if
+                                                      (i == _log2(x.shape[_get_sort_dim(dim, x.shape)])) else 2))
+
+        x = core.reshape(y, x.shape)
     return x
 
 
@@ -1,7 +1,16 @@
-# from .conv import _conv, conv
 from . import blocksparse
+from .all_reduce import AllReduce, peer_barrier
+from .conv import _conv, conv
 from .cross_entropy import _cross_entropy, cross_entropy
 from .flash_attention import attention
-from .matmul import _matmul, get_higher_dtype, matmul
+from .matmul import (_grouped_matmul, _matmul, _matmul_streamk, get_higher_dtype, grouped_matmul, matmul,
+                     matmul_streamk)
+from .norm import layer_norm, rms_norm
+from .reduction import split_reduce
+from .swizzle import get_group_m
 
-__all__ = ["blocksparse", "_cross_entropy", "cross_entropy", "_matmul", "matmul", "attention", "get_higher_dtype"]
+__all__ = [
+    "blocksparse", "AllReduce", "peer_barrier", "_conv", "conv", "_cross_entropy", "cross_entropy", "_matmul", "matmul",
+    "_matmul_streamk", "matmul_streamk", "_grouped_matmul", "grouped_matmul", "attention", "get_higher_dtype",
+    "layer_norm", "rms_norm", "split_reduce", "get_group_m"
+]
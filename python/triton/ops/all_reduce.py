@@ -0,0 +1,138 @@
+import torch
+
+from .. import cdiv, jit, next_power_of_2
+from .. import language as tl
+
+# programs of the all-reduce: they wait for each other on all the devices, so
+# they must all be resident at once
+MAX_PROGRAMS = 64
+# more programs are launched for the large tensors only, so that the barriers
+# of the small ones stay cheap
+ELEMENTS_PER_PROGRAM = 1 << 16
+
+
+@jit
+def peer_barrier(Signals, SignalPtrs, phase, slot, rank, epoch, WORLD: tl.constexpr, BLOCK_WORLD: tl.constexpr,
+                 NUM_SLOTS: tl.constexpr):
+    """
+    Waits until the program of each rank with the same `slot` reaches the
+    barrier of `phase` for the `epoch`, e.g. to read the buffers of the peers
+    once they are written, or to write the own buffer again once they are read.
+    The `Signals` of the rank, of shape (2, NUM_SLOTS, WORLD), hold the epoch
+    each rank reached, and `SignalPtrs` the addresses of those of all ranks.
+    """
+    peers = tl.arange(0, BLOCK_WORLD)
+    mask = peers < WORLD
+    peer_signals = tl.load(SignalPtrs + peers, mask=mask, other=0).to(tl.pointer_type(tl.int32))
+    offset = (phase * NUM_SLOTS + slot) * WORLD
+    # the writes of the rank before the barrier are visible to the peers once
+    # they see its epoch
+    tl.atomic_xchg(peer_signals + offset + rank, epoch, mask=mask, sem="release", scope="sys")
+    own_signals = Signals + offset + peers
+    arrived = tl.min(tl.atomic_add(own_signals, 0, mask=mask, sem="acquire", scope="sys"), 0)
+    while arrived < epoch:
+        arrived = tl.min(tl.atomic_add(own_signals, 0, mask=mask, sem="acquire", scope="sys"), 0)
+
+
+@jit
+def _all_reduce_kernel(Out, BufferPtrs, Signals, SignalPtrs, N, rank, epoch,  #
+                       WORLD: tl.constexpr, BLOCK_WORLD: tl.constexpr, NUM_SLOTS: tl.constexpr,  #
+                       BLOCK: tl.constexpr):
+    pid = tl.program_id(0)
+    num_programs = tl.num_programs(0)
+    dtype = Out.dtype.element_ty
+    # the buffers of the peers are read once they are all written
+    peer_barrier(Signals, SignalPtrs, 0, pid, rank, epoch, WORLD, BLOCK_WORLD, NUM_SLOTS)
+    for start in range(pid * BLOCK, N, num_programs * BLOCK):
+        offsets = start + tl.arange(0, BLOCK)
+        mask = offsets < N
+        acc = tl.zeros((BLOCK, ), dtype=tl.float32)
+        # the buffers are summed in the order of the ranks, so that all the
+        # ranks get the same result
+        for peer in tl.static_range(WORLD):
+            Buffer = tl.load(BufferPtrs + peer).to(tl.pointer_type(dtype))
+            acc += tl.load(Buffer + offsets, mask=mask, other=0.).to(tl.float32)
+        tl.store(Out + offsets, acc.to(dtype), mask=mask)
+    # the buffer of the rank is written again once the peers read it
+    peer_barrier(Signals, SignalPtrs, 1, pid, rank, epoch, WORLD, BLOCK_WORLD, NUM_SLOTS)
+
+
+def _all_gather_object(obj):
+    import torch.distributed as dist
+    objects = [None] * dist.get_world_size()
+    dist.all_gather_object(objects, obj)
+    return objects
+
+
+class AllReduce:
+    """
+    The one-shot all-reduce, by sum, of the tensors of `shape` and `dtype` of
+    the `world_size` ranks of a node, one device and one process each. Each
+    rank writes its tensor to its `buffer`, which the kernel of each rank reads
+    from the peer devices directly, e.g. over Xe Link, instead of exchanging
+    them through the host:
+
+        all_reduce = AllReduce(rank, world_size, x.shape, x.dtype)
+        y = all_reduce(x)
+
+    The buffers are exchanged once, as IPC handles, by `exchange(obj)`, which
+    returns the objects of all the ranks, `torch.distributed.all_gather_object`
+    by default. The ranks must call the all-reduce in the same order. Opening
+    the handles of the peers requires the processes of the ranks to be allowed
+    to ptrace each other, e.g. with `kernel.yama.ptrace_scope=0`.
+
+    `peer_barrier` is the barrier of the kernel, for the kernels fusing their
+    own collectives, e.g. of their output tiles.
+    """
+
+    def __init__(self, rank, world_size, shape, dtype, exchange=None, device=None):
+        from ..runtime import driver
+        utils = driver.active.utils
+        if device is None:
+            device = torch.device("xpu", driver.active.get_current_device())
+        self.rank = rank
+        self.world_size = world_size
+        self.buffer = torch.empty(shape, dtype=dtype, device=device)
+        self.signals = torch.zeros((2, MAX_PROGRAMS, world_size), dtype=torch.int32, device=device)
+        self.epoch = 0
+        exchange = exchange or _all_gather_object
+        handles = exchange((utils.ipc_handle(self.buffer), utils.ipc_handle(self.signals)))
+        assert len(handles) == world_size, "one pair of handles per rank is expected"
+        # the buffers of the rank are used directly, those of the peers mapped
+        self.peers = [[utils.open_ipc_handle(handle, device.index) for handle in peer_handles]
+                      for peer, peer_handles in enumerate(handles) if peer != rank]
+        buffers = [self.buffer if peer == rank else self.peers[peer - (peer > rank)][0] for peer in range(world_size)]
+        signals = [self.signals if peer == rank else self.peers[peer - (peer > rank)][1] for peer in range(world_size)]
+        self.buffer_ptrs = torch.tensor([b.data_ptr() for b in buffers], dtype=torch.int64, device=device)
+        self.signal_ptrs = torch.tensor([s.data_ptr() for s in signals], dtype=torch.int64, device=device)
+        # the signals of each rank are zeroed before the peers set them
+        torch.xpu.synchronize(device)
+        exchange(None)
+
+    def __call__(self, x=None, out=None):
+        """
+        Returns the sum of the `buffer`s of the ranks, after copying `x` to the
+        buffer of the rank if given, in `out` if given.
+        """
+        if x is not None:
+            assert x.shape == self.buffer.shape, "incompatible shape"
+            self.buffer.copy_(x)
+        if out is None:
+            out = torch.empty_like(self.buffer)
+        assert out.is_contiguous(), "the output must be contiguous"
+        N = self.buffer.numel()
+        BLOCK = min(next_power_of_2(N), 2048)
+        num_programs = max(1, min(MAX_PROGRAMS, cdiv(N, ELEMENTS_PER_PROGRAM), cdiv(N, BLOCK)))
+        self.epoch += 1
+        _all_reduce_kernel[(num_programs, )](
+            out, self.buffer_ptrs, self.signals, self.signal_ptrs, N, self.rank, self.epoch,  #
+            WORLD=self.world_size, BLOCK_WORLD=next_power_of_2(self.world_size), NUM_SLOTS=MAX_PROGRAMS,  #
+            BLOCK=BLOCK, num_warps=4)
+        return out
+
+    def close(self):
+        """Unmaps the buffers of the peers, once none of the ranks reduces them anymore."""
+        for peer_buffers in self.peers:
+            for buffer in peer_buffers:
+                buffer.close()
+        self.peers = []
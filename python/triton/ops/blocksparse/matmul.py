@@ -3,6 +3,19 @@ import torch
 from ... import cdiv, heuristics, jit
 from ... import language as tl
 
+
+def _is_xpu(t):
+    return t.device.type == "xpu"
+
+
+def _launch_options(t, xpu_num_warps):
+    # DPAS works on 16 wide sub-groups: on XPU the tiles are split across
+    # `xpu_num_warps` of them, sized to the tile, rather than 4 warps
+    if not _is_xpu(t):
+        return {"num_warps": 4}
+    return {"num_warps": xpu_num_warps, "threads_per_warp": 16}
+
+
 # ********************************************************
 # --------------------------------------------------------
 # Sparse = Dense x Dense (SDD)
@@ -109,7 +122,7 @@ def sdd_matmul(a, b, trans_a, trans_b, trans_c, spdims, block, lut, widths, out=
         c.stride(0), c.stride(1), c.stride(2), c.stride(3),  #
         Ka, 0, lut,  #
         TILE_M=block, TILE_N=block, TILE_K=32, BLOCK=block, num_stages=4,  #
-        num_warps=4  #
+        **_launch_options(a, max(1, block // 16))  #
     )
     return c
 
@@ -234,7 +247,7 @@ def dsd_matmul(a, b, trans_a, trans_b, trans_c, spdims, block, lut, width, out=N
         c.stride(0), c.stride(1), c.stride(3 if trans_c else 2), c.stride(2 if trans_c else 3),  #
         BS3, AS1, lut,  #
         TILE_M=block, TILE_N=TILE_N, TILE_K=min(block, 32), BLOCK=block, num_stages=4,  #
-        num_warps=4, GROUP_SIZE_M=4  #
+        GROUP_SIZE_M=4, **_launch_options(a, max(2, block // 8))  #
     )
     # exit()
     return c
@@ -323,7 +336,12 @@ def dsd_lut(layout, block, step, trans, device):
     width = col_id.size(0)
     offsets = offsets * 2 * div + 4 * width
     segments = segments * div
-    header = torch.stack((offsets, segments, col_id, head_id), dim=1).view(-1).contiguous()
+    header = torch.stack((offsets, segments, col_id, head_id), dim=1)
+    # the programs are scheduled in the order of the rows of the header: the
+    # longest reductions go first so that the shorter ones balance the load of
+    # the compute units at the end of the grid rather than leaving a long tail
+    order = torch.sort(segments, descending=True, stable=True).indices
+    header = header[order].view(-1).contiguous()
     # create increments
     incs = torch.stack((B_incs, A_incs), dim=1).view(-1).contiguous()
     # pad by a factor 2*MAX_NUM_STAGES
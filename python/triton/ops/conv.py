@@ -0,0 +1,149 @@
+import torch
+
+from .. import Config, autotune, cdiv, heuristics, jit
+from .. import language as tl
+from .matmul import _call_hook, _hook_args
+from .swizzle import get_group_m
+
+
+def get_configs():
+    # DPAS friendly tiles of output pixels by output channels, the tiles of
+    # input channels being those of the 2D block loads of the filters
+    return [
+        Config({'BLOCK_M': 256, 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=3, num_warps=16),
+        Config({'BLOCK_M': 128, 'BLOCK_N': 256, 'BLOCK_K': 32}, num_stages=3, num_warps=16),
+        Config({'BLOCK_M': 128, 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=3, num_warps=8),
+        Config({'BLOCK_M': 128, 'BLOCK_N': 64, 'BLOCK_K': 32}, num_stages=3, num_warps=8),
+        Config({'BLOCK_M': 64, 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=3, num_warps=8),
+        Config({'BLOCK_M': 64, 'BLOCK_N': 64, 'BLOCK_K': 32}, num_stages=2, num_warps=4),
+        # for the few input channels of the first layers
+        Config({'BLOCK_M': 128, 'BLOCK_N': 64, 'BLOCK_K': 16}, num_stages=2, num_warps=4),
+    ]
+
+
+@autotune(
+    configs=get_configs(),
+    key=['M', 'C', 'K', 'R', 'S', 'EPILOGUE_FN'],
+)
+@heuristics({
+    'GROUP_M':
+    lambda args: get_group_m(args['M'], args['K'], args['C'] * args['R'] * args['S'], args['BLOCK_M'], args['BLOCK_N'],
+                             args['X'].element_size()),
+})
+@jit
+def _kernel(X, Wt, Y, Bias, M, C, H, W, K, P, Q, R, S,  #
+            stride_xn, stride_xc, stride_xh, stride_xw,  #
+            stride_wk, stride_wc, stride_wr, stride_ws,  #
+            stride_yn, stride_yc, stride_yh, stride_yw,  #
+            stride_h, stride_w, pad_h, pad_w, dil_h, dil_w,  #
+            EPILOGUE_FN: tl.constexpr, E0, E1, E2,  #
+            HAS_BIAS: tl.constexpr,  #
+            allow_tf32: tl.constexpr,  #
+            BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,  #
+            GROUP_M: tl.constexpr  #
+            ):
+    # The convolution is the product of the im2col matrix of X, of M = N*P*Q
+    # output pixels by R*S*C taps of the filters, with Wt, of R*S*C taps by K
+    # output channels. The im2col matrix is addressed on the fly: the tile of
+    # each tap is gathered from X, the padding masked.
+    pid = tl.program_id(0)
+    grid_m = tl.cdiv(M, BLOCK_M)
+    grid_n = tl.cdiv(K, BLOCK_N)
+    # re-order program ID for better L3 performance
+    width = GROUP_M * grid_n
+    group_id = pid // width
+    group_size = min(grid_m - group_id * GROUP_M, GROUP_M)
+    pid_m = group_id * GROUP_M + (pid % group_size)
+    pid_n = (pid % width) // (group_size)
+    # the output pixels of the tile
+    rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    n = rm // (P * Q)
+    p = rm % (P * Q) // Q
+    q = rm % Q
+    rc = tl.arange(0, BLOCK_K)
+    acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
+    # the taps of the filters by tiles of input channels, which are contiguous
+    # in NHWC
+    c_tiles = tl.cdiv(C, BLOCK_K)
+    for k in range(0, R * S * c_tiles):
+        r = k // (S * c_tiles)
+        s = k // c_tiles % S
+        c = k % c_tiles * BLOCK_K
+        h = p * stride_h - pad_h + r * dil_h
+        w = q * stride_w - pad_w + s * dil_w
+        mask = (rm < M) & (h >= 0) & (h < H) & (w >= 0) & (w < W)
+        A = X + (n * stride_xn + h * stride_xh + w * stride_xw)[:, None] + (c + rc)[None, :] * stride_xc
+        a = tl.load(A, mask=mask[:, None] & (c + rc < C)[None, :], other=0.)
+        B = tl.make_block_ptr(base=Wt + r * stride_wr + s * stride_ws, shape=(C, K), strides=(stride_wc, stride_wk),
+                              offsets=(c, pid_n * BLOCK_N), block_shape=(BLOCK_K, BLOCK_N), order=(0, 1))
+        b = tl.load(B, boundary_check=(0, 1), padding_option="zero")
+        acc += tl.dot(a, b, allow_tf32=allow_tf32)
+    rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+    if HAS_BIAS:
+        bias = tl.load(Bias + rn, mask=rn < K, other=0.)
+        acc += bias[None, :].to(tl.float32)
+    # the fused transformation of the output tile, e.g. an activation
+    if EPILOGUE_FN is not None:
+        acc = _call_hook(EPILOGUE_FN, acc, rm, rn, E0, E1, E2)
+    Y = Y + (n * stride_yn + p * stride_yh + q * stride_yw)[:, None] + rn[None, :] * stride_yc
+    tl.store(Y, acc.to(Y.dtype.element_ty), mask=(rm < M)[:, None] & (rn < K)[None, :])
+
+
+def _pair(value):
+    return (value, value) if isinstance(value, int) else tuple(value)
+
+
+class _conv(torch.autograd.Function):
+    kernel = _kernel
+
+    @staticmethod
+    def _call(x, w, bias, stride, padding, dilation, allow_tf32, epilogue_fn, epilogue_args):
+        # the tensors of the shapes of torch, in the NHWC memory format
+        x = x.contiguous(memory_format=torch.channels_last)
+        w = w.contiguous(memory_format=torch.channels_last)
+        N, C, H, W = x.shape
+        K, C_w, R, S = w.shape
+        assert C == C_w, "incompatible numbers of input channels"
+        assert x.dtype == w.dtype, "incompatible dtypes"
+        if bias is not None:
+            assert bias.shape == (K, ), "bias must have one element per output channel"
+            bias = bias.contiguous()
+        stride_h, stride_w = _pair(stride)
+        pad_h, pad_w = _pair(padding)
+        dil_h, dil_w = _pair(dilation)
+        P = (H + 2 * pad_h - dil_h * (R - 1) - 1) // stride_h + 1
+        Q = (W + 2 * pad_w - dil_w * (S - 1) - 1) // stride_w + 1
+        y = torch.empty((N, K, P, Q), device=x.device, dtype=x.dtype, memory_format=torch.channels_last)
+        M = N * P * Q
+        grid = lambda META: (cdiv(M, META['BLOCK_M']) * cdiv(K, META['BLOCK_N']), )
+        _kernel[grid](
+            x, w, y, bias, M, C, H, W, K, P, Q, R, S,  #
+            x.stride(0), x.stride(1), x.stride(2), x.stride(3),  #
+            w.stride(0), w.stride(1), w.stride(2), w.stride(3),  #
+            y.stride(0), y.stride(1), y.stride(2), y.stride(3),  #
+            stride_h, stride_w, pad_h, pad_w, dil_h, dil_w,  #
+            epilogue_fn, *_hook_args(epilogue_args),  #
+            HAS_BIAS=bias is not None,  #
+            allow_tf32=allow_tf32)
+        return y
+
+    @staticmethod
+    def forward(ctx, x, w, bias=None, stride=1, padding=0, dilation=1, allow_tf32=True, epilogue_fn=None,
+                epilogue_args=()):
+        """
+        Returns the 2D convolution of `x`, of shape (N, C, H, W), with the
+        filters `w`, of shape (K, C, R, S), as `torch.nn.functional.conv2d`,
+        in the NHWC memory format, i.e. `torch.channels_last`, which the
+        inputs are converted to if needed.
+
+        `epilogue_fn(y, pixels, channels, *epilogue_args)`, a @jit function,
+        returns the tile of the output at the output pixels, the flat indices
+        of (N, P, Q), and the output channels, with the bias added, to store,
+        e.g. with an activation. Its `epilogue_args` are up to 3 tensors or
+        scalars, and the indices go past the bounds of the output on the
+        edges, where it must mask its loads.
+        """
+        return _conv._call(x, w, bias, stride, padding, dilation, allow_tf32, epilogue_fn, epilogue_args)
+
+
+conv = _conv.apply
@@ -4,58 +4,71 @@ from .. import heuristics, jit
 from .. import language as tl
 from .. import next_power_of_2
 
+# The rows are streamed in tiles of at most this many columns, so that the
+# register usage of the kernels does not grow with the vocabulary size.
+MAX_BLOCK = 4096
 
-def num_warps(N):
-    if N < 2048:
+
+def num_warps(BLOCK):
+    if BLOCK < 2048:
         return 4
-    elif N < 8192:
-        return 8
-    return 16
+    return 8
+
 
+def block_size(N):
+    return min(next_power_of_2(N), MAX_BLOCK)
 
-@heuristics({'num_warps': lambda nargs: num_warps(nargs['N'])})
-@heuristics({'BLOCK': lambda nargs: next_power_of_2(nargs['N'])})
+
+@heuristics({'BLOCK': lambda nargs: block_size(nargs['N'])})
+@heuristics({'num_warps': lambda nargs: num_warps(block_size(nargs['N']))})
 @jit
-def _forward(LOGITS, PROBS, IDX, LOSS, N, BLOCK: tl.constexpr):
+def _forward(LOGITS, IDX, LOSS, LSE, N, BLOCK: tl.constexpr):
     row = tl.program_id(0)
     cols = tl.arange(0, BLOCK)
     idx = tl.load(IDX + row)
-    # pointers to logit and probs
-    LOGITS = LOGITS + row * N + cols
-    WRIT_PROBS = PROBS + row * N + cols
-    READ_PROBS = PROBS + row * N + idx
-    # write-back negative log-probs
-    logits = tl.load(LOGITS, mask=cols < N, other=-float('inf'))
-    logits = logits.to(tl.float32)
-    logits = logits - tl.max(logits, 0)
-    probs = tl.log(tl.sum(tl.exp(logits), 0)) - logits
-    tl.store(WRIT_PROBS, probs, mask=cols < N)
-    # There is a bug in the compiler, which fails to insert a barrier here.
-    # We add it explicitly for now. Will be fixed soon.
-    tl.debug_barrier()
-    # write-back loss
-    probs = tl.load(READ_PROBS)
-    tl.store(LOSS + row, probs)
-
-
-@heuristics({'num_warps': lambda nargs: num_warps(nargs['N'])})
-@heuristics({'BLOCK': lambda nargs: next_power_of_2(nargs['N'])})
+    LOGITS = LOGITS + row.to(tl.int64) * N
+    # online softmax: every lane keeps the running max and the sum of the
+    # exponentials of the columns it sees, rescaled when its max grows
+    m = tl.full((BLOCK, ), float('-inf'), tl.float32)
+    s = tl.zeros((BLOCK, ), tl.float32)
+    for start in range(0, N, BLOCK):
+        logits = tl.load(LOGITS + start + cols, mask=start + cols < N, other=-float('inf'))
+        logits = logits.to(tl.float32)
+        m_new = tl.maximum(m, logits)
+        # the lanes that only saw -inf so far would rescale by exp(-inf + inf)
+        m_ref = tl.where(m_new == float('-inf'), 0., m_new)
+        s = s * tl.exp(m - m_ref) + tl.exp(logits - m_ref)
+        m = m_new
+    # merge the lanes into the log-sum-exp of the row
+    m_row = tl.max(m, 0)
+    lse = m_row + tl.log(tl.sum(s * tl.exp(m - m_row), 0))
+    # write-back negative log-prob of the target and the log-sum-exp for the
+    # backward pass
+    target = tl.load(LOGITS + idx).to(tl.float32)
+    tl.store(LOSS + row, lse - target)
+    tl.store(LSE + row, lse)
+
+
+@heuristics({'BLOCK': lambda nargs: block_size(nargs['N'])})
+@heuristics({'num_warps': lambda nargs: num_warps(block_size(nargs['N']))})
 @jit
-def _backward(PROBS, IDX, DPROBS, N, BLOCK: tl.constexpr):
+def _backward(LOGITS, IDX, LSE, DLOSS, DLOGITS, N, BLOCK: tl.constexpr):
     row = tl.program_id(0)
     cols = tl.arange(0, BLOCK)
     idx = tl.load(IDX + row)
-    # pointers to probs
-    PROBS = PROBS + row * N + cols
+    lse = tl.load(LSE + row)
+    dout = tl.load(DLOSS + row).to(tl.float32)
+    LOGITS = LOGITS + row.to(tl.int64) * N
+    DLOGITS = DLOGITS + row.to(tl.int64) * N
     # We know d(-log(p[i])/dlogit[k] = -id_mat[i,k] + p[k]
-    # and we have -log(p[k]) stored in PROBS, so this is easy
-    probs = -tl.load(PROBS, mask=cols < N, other=float('inf'))
-    probs = tl.exp(probs.to(tl.float32))
-    delta = cols == idx
-    # write result in-place in PROBS
-    dout = tl.load(DPROBS + row)
-    din = (probs - delta) * dout
-    tl.store(PROBS, din.to(PROBS.dtype.element_ty), mask=cols < N)
+    # and p[k] = exp(logit[k] - lse) is recomputed from the log-sum-exp
+    for start in range(0, N, BLOCK):
+        mask = start + cols < N
+        logits = tl.load(LOGITS + start + cols, mask=mask, other=0.)
+        probs = tl.exp(logits.to(tl.float32) - lse)
+        delta = start + cols == idx
+        din = (probs - delta) * dout
+        tl.store(DLOGITS + start + cols, din.to(DLOGITS.dtype.element_ty), mask=mask)
 
 
 class _cross_entropy(torch.autograd.Function):
@@ -66,31 +79,31 @@ class _cross_entropy(torch.autograd.Function):
         assert (indices.dtype == torch.int64), "Indices are expected to be of type long."
         # make kernel
         device, dtype = logits.device, logits.dtype
+        logits = logits.contiguous()
         n_cols = logits.shape[-1]
         # run the kernel
         result = torch.empty_like(indices, dtype=dtype, device=device)
-        neg_logprobs = torch.empty_like(logits, dtype=dtype, device=device)
+        lse = torch.empty_like(indices, dtype=torch.float32, device=device)
         grid = lambda opt: (logits.numel() // n_cols, )
-        _forward[grid](logits, neg_logprobs, indices, result, n_cols)
+        _forward[grid](logits, indices, result, lse, n_cols)
         # save for backward
-        ctx.save_for_backward(neg_logprobs, indices)
+        ctx.save_for_backward(logits, indices, lse)
         return result
 
     @classmethod
     def backward(cls, ctx, dneg_logprobs):
         """We know d(-log(p[i])/dlogit[k] = -id_mat[i,k] + p[k]
-        so we initialize the gradient as neg_logprobs, so we can just exponentiate
-        to get p[k], which is most of what we need...  neg_logprobs will be
-        modified in place to become the gradient we want
+        and the forward pass saved the log-sum-exp of every row, so p[k] is
+        recomputed in a single pass over the logits alongside the gradient
         """
         # load saved tensors
-        neg_logprobs, indices = ctx.saved_tensors
+        logits, indices, lse = ctx.saved_tensors
         # run the kernel
-        # neg_logprobs will be modified in place to become our gradient:
-        n_cols = neg_logprobs.shape[-1]
-        grid = lambda opt: (neg_logprobs.numel() // n_cols, )
-        _backward[grid](neg_logprobs, indices, dneg_logprobs, n_cols)
-        return neg_logprobs, None
+        n_cols = logits.shape[-1]
+        dlogits = torch.empty_like(logits)
+        grid = lambda opt: (logits.numel() // n_cols, )
+        _backward[grid](logits, indices, lse, dneg_logprobs.contiguous(), dlogits, n_cols)
+        return dlogits, None
 
 
 cross_entropy = _cross_entropy.apply
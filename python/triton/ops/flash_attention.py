@@ -14,6 +14,51 @@ from .. import cdiv, jit
 from .. import language as tl
 
 
+@jit
+def _fwd_inner(acc, l_i, m_i, q,  #
+               K_block_ptr, V_block_ptr,  #
+               start_m, offs_m, offs_n, N_CTX,  #
+               BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr,  #
+               STAGE: tl.constexpr  #
+               ):
+    # STAGE 1: the blocks strictly below the diagonal, which need no mask
+    # STAGE 2: the blocks on the diagonal, which are partially masked
+    # STAGE 3: all the blocks of a non causal attention
+    # The blocks above the diagonal are fully masked and never visited.
+    if STAGE == 1:
+        lo, hi = 0, start_m * BLOCK_M
+    elif STAGE == 2:
+        lo, hi = start_m * BLOCK_M, (start_m + 1) * BLOCK_M
+        lo = tl.multiple_of(lo, BLOCK_M)
+        K_block_ptr = tl.advance(K_block_ptr, (0, lo))
+        V_block_ptr = tl.advance(V_block_ptr, (lo, 0))
+    else:
+        lo, hi = 0, N_CTX
+    for start_n in range(lo, hi, BLOCK_N):
+        # -- load k, v --
+        k = tl.load(K_block_ptr)
+        v = tl.load(V_block_ptr)
+        # -- compute qk ---
+        qk = tl.zeros([BLOCK_M, BLOCK_N], dtype=tl.float32)
+        if STAGE == 2:
+            qk = tl.where(offs_m[:, None] >= (start_n + offs_n[None, :]), qk, float("-inf"))
+        qk += tl.dot(q, k, allow_tf32=True)
+        # -- compute scaling constant ---
+        m_i_new = tl.maximum(m_i, tl.max(qk, 1))
+        alpha = tl.math.exp2(m_i - m_i_new)
+        p = tl.math.exp2(qk - m_i_new[:, None])
+        # -- scale and update acc --
+        acc *= alpha[:, None]
+        acc += tl.dot(p.to(v.dtype), v, allow_tf32=True)
+        # -- update m_i and l_i --
+        l_i = l_i * alpha + tl.sum(p, 1)
+        m_i = m_i_new
+        # update pointers
+        K_block_ptr = tl.advance(K_block_ptr, (0, BLOCK_N))
+        V_block_ptr = tl.advance(V_block_ptr, (BLOCK_N, 0))
+    return acc, l_i, m_i
+
+
 @jit
 def _fwd_kernel(Q, K, V, sm_scale,  #
                 L,  #
@@ -22,7 +67,7 @@ def _fwd_kernel(Q, K, V, sm_scale,  #
                 stride_kz, stride_kh, stride_kn, stride_kk,  #
                 stride_vz, stride_vh, stride_vn, stride_vk,  #
                 stride_oz, stride_oh, stride_om, stride_on,  #
-                Z, H, N_CTX,  #
+                Z, H, H_KV, N_CTX,  #
                 Z_H_N_CTX,  #
                 BLOCK_M: tl.constexpr, BLOCK_DMODEL: tl.constexpr,  #
                 BLOCK_N: tl.constexpr,  #
@@ -30,22 +75,30 @@ def _fwd_kernel(Q, K, V, sm_scale,  #
                 ):
     start_m = tl.program_id(0)
     off_hz = tl.program_id(1)
+    off_z = off_hz // H
+    off_h = off_hz % H
+    # grouped-query attention: consecutive groups of H // H_KV query heads
+    # share the same key/value head
+    off_h_kv = off_h // (H // H_KV)
     qvk_offset = off_hz * stride_qh
     vk_offset = qvk_offset // stride_qm
+    k_offset = (off_z * stride_kz + off_h_kv * stride_kh) // stride_kn
+    v_offset = (off_z * stride_vz + off_h_kv * stride_vh) // stride_vn
+    Z_H_KV_N_CTX = Z * H_KV * N_CTX
 
     K_block_ptr = tl.make_block_ptr(
         base=K,
-        shape=(BLOCK_DMODEL, Z_H_N_CTX),
+        shape=(BLOCK_DMODEL, Z_H_KV_N_CTX),
         strides=(stride_kk, stride_kn),
-        offsets=(0, vk_offset),
+        offsets=(0, k_offset),
         block_shape=(BLOCK_DMODEL, BLOCK_N),
         order=(0, 1),
     )
     V_block_ptr = tl.make_block_ptr(
         base=V,
-        shape=(Z_H_N_CTX, BLOCK_DMODEL),
+        shape=(Z_H_KV_N_CTX, BLOCK_DMODEL),
         strides=(stride_vn, stride_vk),
-        offsets=(vk_offset, 0),
+        offsets=(v_offset, 0),
         block_shape=(BLOCK_N, BLOCK_DMODEL),
         order=(1, 0),
     )
@@ -68,30 +121,18 @@ def _fwd_kernel(Q, K, V, sm_scale,  #
     q = tl.load(Q_ptrs)
 
     q = (q * qk_scale).to(K.dtype.element_ty)
-    lo = 0
-    hi = (start_m + 1) * BLOCK_M if IS_CAUSAL else N_CTX
-    for start_n in range(lo, hi, BLOCK_N):
-        # -- load k, v --
-        k = tl.load(K_block_ptr)
-        v = tl.load(V_block_ptr)
-        # -- compute qk ---
-        qk = tl.zeros([BLOCK_M, BLOCK_N], dtype=tl.float32)
-        if IS_CAUSAL:
-            qk = tl.where(offs_m[:, None] >= (start_n + offs_n[None, :]), qk, float("-inf"))
-        qk += tl.dot(q, k, allow_tf32=True)
-        # -- compute scaling constant ---
-        m_i_new = tl.maximum(m_i, tl.max(qk, 1))
-        alpha = tl.math.exp2(m_i - m_i_new)
-        p = tl.math.exp2(qk - m_i_new[:, None])
-        # -- scale and update acc --
-        acc *= alpha[:, None]
-        acc += tl.dot(p.to(V.dtype.element_ty), v, allow_tf32=True)
-        # -- update m_i and l_i --
-        l_i = l_i * alpha + tl.sum(p, 1)
-        m_i = m_i_new
-        # update pointers
-        K_block_ptr = tl.advance(K_block_ptr, (0, BLOCK_N))
-        V_block_ptr = tl.advance(V_block_ptr, (BLOCK_N, 0))
+    if IS_CAUSAL:
+        # the blocks below the diagonal skip the mask computation
+        acc, l_i, m_i = _fwd_inner(acc, l_i, m_i, q, K_block_ptr, V_block_ptr,  #
+                                   start_m, offs_m, offs_n, N_CTX,  #
+                                   BLOCK_M, BLOCK_N, 1)
+        acc, l_i, m_i = _fwd_inner(acc, l_i, m_i, q, K_block_ptr, V_block_ptr,  #
+                                   start_m, offs_m, offs_n, N_CTX,  #
+                                   BLOCK_M, BLOCK_N, 2)
+    else:
+        acc, l_i, m_i = _fwd_inner(acc, l_i, m_i, q, K_block_ptr, V_block_ptr,  #
+                                   start_m, offs_m, offs_n, N_CTX,  #
+                                   BLOCK_M, BLOCK_N, 3)
     # write back l and m
     acc = acc / l_i[:, None]
     l_ptrs = L + off_hz * N_CTX + offs_m
@@ -360,6 +401,16 @@ def _bwd_kernel(Q, K, V, sm_scale,  #
                                   )
 
 
+def _is_xpu(t):
+    return t.device.type == "xpu"
+
+
+def _launch_options(t):
+    # DPAS works on 16 wide sub-groups, so the XPU kernels are compiled with
+    # sub-groups of 16 work-items rather than the default of 32
+    return {"threads_per_warp": 16} if _is_xpu(t) else {}
+
+
 class _attention(torch.autograd.Function):
 
     @staticmethod
@@ -375,10 +426,18 @@ class _attention(torch.autograd.Function):
         Lq, Lk, Lv = q.shape[-1], k.shape[-1], v.shape[-1]
         assert Lq == Lk and Lk == Lv
         assert Lk in {16, 32, 64, 128}
+        # MQA/GQA: k and v may have fewer heads than q
+        H, H_KV = q.shape[1], k.shape[1]
+        assert k.shape == v.shape and H % H_KV == 0
         o = torch.empty_like(q)
         grid = (cdiv(q.shape[2], BLOCK_M), q.shape[0] * q.shape[1], 1)
         L = torch.empty((q.shape[0] * q.shape[1], q.shape[2]), device=q.device, dtype=torch.float32)
-        num_warps = 4 if Lk <= 64 else 8
+        if _is_xpu(q):
+            # 8 sub-groups of 16 work-items, each computing 16 rows (two DPAS
+            # repeats of 8) of the 128 x 64 block of scores
+            num_warps, num_stages = 8, 3
+        else:
+            num_warps, num_stages = (4 if Lk <= 64 else 8), 4
         _fwd_kernel[grid](
             q, k, v, sm_scale,  #
             L,  #
@@ -387,12 +446,13 @@ class _attention(torch.autograd.Function):
             k.stride(0), k.stride(1), k.stride(2), k.stride(3),  #
             v.stride(0), v.stride(1), v.stride(2), v.stride(3),  #
             o.stride(0), o.stride(1), o.stride(2), o.stride(3),  #
-            q.shape[0], q.shape[1], q.shape[2],  #
+            q.shape[0], H, H_KV, q.shape[2],  #
             q.shape[0] * q.shape[1] * q.shape[2],  #
             BLOCK_M=BLOCK_M, BLOCK_N=BLOCK_N, BLOCK_DMODEL=Lk,  #
             IS_CAUSAL=causal,  #
             num_warps=num_warps,  #
-            num_stages=4  #
+            num_stages=num_stages,  #
+            **_launch_options(q)  #
         )
 
         ctx.save_for_backward(q, k, v, o, L)
@@ -412,6 +472,12 @@ class _attention(torch.autograd.Function):
         BLOCK = 128
         q, k, v, o, L = ctx.saved_tensors
         sequence_parallel = ctx.sequence_parallel
+        # the backward kernels work on one key/value head per query head:
+        # expand the shared heads and reduce their gradients afterwards
+        group = q.shape[1] // k.shape[1]
+        if group > 1:
+            k = k.repeat_interleave(group, dim=1)
+            v = v.repeat_interleave(group, dim=1)
         seq_len_kv = k.shape[2]
         do = do.contiguous()
         if sequence_parallel:
@@ -448,11 +514,16 @@ class _attention(torch.autograd.Function):
             CAUSAL=ctx.causal,  #
             MMA_V3=MMA_V3,  #
             num_warps=8,  #
-            num_stages=1  #
+            num_stages=1,  #
+            **_launch_options(q)  #
         )
 
         if len(dq.shape) == 5:
             dq = dq.sum(dim=0)
+        if group > 1:
+            Z, H, N_CTX, D_HEAD = dk.shape
+            dk = dk.view(Z, H // group, group, N_CTX, D_HEAD).sum(dim=2)
+            dv = dv.view(Z, H // group, group, N_CTX, D_HEAD).sum(dim=2)
         return dq, dk, dv, None, None, None
 
 
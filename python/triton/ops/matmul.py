@@ -1,8 +1,9 @@
 import torch
 
-from .. import Config, autotune, cdiv, heuristics, jit
+from .. import Config, autotune, cdiv, heuristics, jit, next_power_of_2
 from .. import language as tl
-from .matmul_perf_model import early_config_prune, estimate_matmul_time
+from .matmul_perf_model import early_config_prune, estimate_matmul_time, resource_prune
+from .swizzle import get_group_m
 
 _ordered_datatypes = [torch.int8, torch.float16, torch.bfloat16, torch.float32]
 
@@ -33,6 +34,19 @@ def init_to_zero(name):
     return lambda nargs: nargs[name].zero_()
 
 
+def _prune_configs(configs, named_args):
+    # the epilogues apply to the whole sums, which the split-k programs only
+    # have once they're all added to C
+    if named_args['EPILOGUE_FN'] is not None:
+        configs = [config for config in configs if config.kwargs['SPLIT_K'] == 1]
+    return early_config_prune(configs, named_args)
+
+
+def _get_group_m(args):
+    # the swizzle of the tiles of the config for the L3 of the device
+    return get_group_m(args['M'], args['N'], args['K'], args['BLOCK_M'], args['BLOCK_N'], args['A'].element_size())
+
+
 def get_configs_io_bound():
     configs = []
     for num_stages in [2, 3, 4, 5, 6]:
@@ -74,24 +88,29 @@ def get_configs_io_bound():
         Config({'BLOCK_M': 128, 'BLOCK_N': 32, 'BLOCK_K': 64, 'SPLIT_K': 1}, num_stages=4, num_warps=4),
         Config({'BLOCK_M': 64, 'BLOCK_N': 32, 'BLOCK_K': 64, 'SPLIT_K': 1}, num_stages=5, num_warps=2),
     ] + get_configs_io_bound(),
-    key=['M', 'N', 'K'],
+    key=['M', 'N', 'K', 'PROLOGUE_FN', 'EPILOGUE_FN'],
     prune_configs_by={
-        'early_config_prune': early_config_prune,
+        'early_config_prune': _prune_configs,
         'perf_model': estimate_matmul_time,
         'top_k': 10,
+        'resource_prune': resource_prune,
     },
 )
 @heuristics({
     'EVEN_K': lambda args: args['K'] % (args['BLOCK_K'] * args['SPLIT_K']) == 0,
+    'GROUP_M': lambda args: _get_group_m(args),
 })
 @jit
-def _kernel(A, B, C, M, N, K,  #
+def _kernel(A, B, C, Scale, M, N, K,  #
             stride_am, stride_ak,  #
             stride_bk, stride_bn,  #
             stride_cm, stride_cn,  #
+            PROLOGUE_FN: tl.constexpr, P0, P1, P2,  #
+            EPILOGUE_FN: tl.constexpr, E0, E1, E2,  #
             acc_dtype: tl.constexpr,  #
             allow_tf32: tl.constexpr,  #
             fp8_fast_accum: tl.constexpr,  #
+            HAS_SCALE: tl.constexpr,  #
             BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,  #
             GROUP_M: tl.constexpr, SPLIT_K: tl.constexpr, EVEN_K: tl.constexpr, AB_DTYPE: tl.constexpr  #
             ):
@@ -100,7 +119,7 @@ def _kernel(A, B, C, M, N, K,  #
     pid_z = tl.program_id(1)
     grid_m = tl.cdiv(M, BLOCK_M)
     grid_n = tl.cdiv(N, BLOCK_N)
-    # re-order program ID for better L2 performance
+    # re-order program ID for better L3 performance
     width = GROUP_M * grid_n
     group_id = pid // width
     group_size = min(grid_m - group_id * GROUP_M, GROUP_M)
@@ -125,6 +144,13 @@ def _kernel(A, B, C, M, N, K,  #
             _0 = tl.zeros((1, 1), dtype=C.dtype.element_ty)
             a = tl.load(A, mask=rk[None, :] < k_remaining, other=_0)
             b = tl.load(B, mask=rk[:, None] < k_remaining, other=_0)
+        # the fused transformation of the tile of A, e.g. a dequantization
+        if PROLOGUE_FN is not None:
+            rak = rk + k * BLOCK_K * SPLIT_K
+            a = _call_hook(PROLOGUE_FN, a, ram, rak, P0, P1, P2)
+            if not EVEN_K:
+                # the padding of the last tile must stay zero
+                a = tl.where(rk[None, :] < k_remaining, a, 0)
         if AB_DTYPE is not None:
             a = a.to(AB_DTYPE)
             b = b.to(AB_DTYPE)
@@ -134,10 +160,18 @@ def _kernel(A, B, C, M, N, K,  #
             acc += tl.dot(a, b, out_dtype=acc_dtype, allow_tf32=allow_tf32)
         A += BLOCK_K * SPLIT_K * stride_ak
         B += BLOCK_K * SPLIT_K * stride_bk
-    acc = acc.to(C.dtype.element_ty)
     # rematerialize rm and rn to save registers
     rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
     rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+    # apply the per output column scale of quantized operands
+    if HAS_SCALE:
+        scale = tl.load(Scale + rn, mask=rn < N, other=0.)
+        acc = acc.to(tl.float32) * scale[None, :]
+    # the fused transformation of the tile of C in the layout of the dot, e.g.
+    # a bias and an activation
+    if EPILOGUE_FN is not None:
+        acc = _call_hook(EPILOGUE_FN, acc, rm, rn, E0, E1, E2)
+    acc = acc.to(C.dtype.element_ty)
     C = C + (rm[:, None] * stride_cm + rn[None, :] * stride_cn)
     mask = (rm < M)[:, None] & (rn < N)[None, :]
     # handles write-back with reduction-splitting
@@ -147,73 +181,453 @@ def _kernel(A, B, C, M, N, K,  #
         tl.atomic_add(C, acc, mask=mask)
 
 
-class _matmul(torch.autograd.Function):
-    kernel = _kernel
+@jit
+def _call_hook(fn: tl.constexpr, x, rows, cols, arg0, arg1, arg2):
+    # calls `fn` with the arguments given to `matmul`, the others are None
+    if arg0 is None:
+        return fn(x, rows, cols)
+    elif arg1 is None:
+        return fn(x, rows, cols, arg0)
+    elif arg2 is None:
+        return fn(x, rows, cols, arg0, arg1)
+    else:
+        return fn(x, rows, cols, arg0, arg1, arg2)
 
-    _locks = {}
 
-    @staticmethod
-    def _call(a, b, acc_dtype, allow_tf32, fp8_fast_accum, output_dtype):
-        device = a.device
-        # handle non-contiguous inputs if necessary
-        if a.stride(0) > 1 and a.stride(1) > 1:
-            a = a.contiguous()
-        if b.stride(0) > 1 and b.stride(1) > 1:
-            b = b.contiguous()
-        # checks constraints
-        assert a.shape[1] == b.shape[0], "incompatible dimensions"
-        M, K = a.shape
-        _, N = b.shape
-
-        # common type between a and b
-        ab_dtype = get_higher_dtype(a.dtype, b.dtype)
-
-        # allocates output
-        if (output_dtype is None):
-            output_dtype = ab_dtype
-
-        c = torch.empty((M, N), device=device, dtype=output_dtype)
-
-        # Allowed types for acc_type given the types of a and b.
-        supported_acc_dtypes = {
-            torch.float16: (torch.float32, torch.float16), torch.bfloat16: (torch.float32, torch.bfloat16),
-            torch.float32: (torch.float32, ), torch.int8: (torch.int32, )
-        }
-
-        if acc_dtype is None:
-            acc_dtype = supported_acc_dtypes[ab_dtype][0]
+def _hook_args(args):
+    # the arguments of a hook, padded with None to the 3 of `_call_hook`
+    assert len(args) <= 3, "the hooks take up to 3 extra arguments"
+    assert all(arg is not None for arg in args), "the arguments of the hooks can't be None"
+    return tuple(args) + (None, ) * (3 - len(args))
+
+
+def get_configs_streamk():
+    # DPAS friendly tiles, with enough sub-groups to keep the XMX engines of an
+    # Xe-core busy
+    return [
+        Config({'BLOCK_M': 256, 'BLOCK_N': 256, 'BLOCK_K': 32}, num_stages=3, num_warps=32),
+        Config({'BLOCK_M': 128, 'BLOCK_N': 256, 'BLOCK_K': 32}, num_stages=3, num_warps=16),
+        Config({'BLOCK_M': 256, 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=3, num_warps=16),
+        Config({'BLOCK_M': 128, 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=3, num_warps=8),
+        Config({'BLOCK_M': 64, 'BLOCK_N': 128, 'BLOCK_K': 64}, num_stages=3, num_warps=8),
+        Config({'BLOCK_M': 64, 'BLOCK_N': 64, 'BLOCK_K': 64}, num_stages=2, num_warps=4),
+    ]
+
+
+@jit
+def _tile_coords(tile_id, M, N, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, GROUP_M: tl.constexpr):
+    # re-order tiles for better L3 performance
+    grid_m = tl.cdiv(M, BLOCK_M)
+    grid_n = tl.cdiv(N, BLOCK_N)
+    width = GROUP_M * grid_n
+    group_id = tile_id // width
+    group_size = min(grid_m - group_id * GROUP_M, GROUP_M)
+    pid_m = group_id * GROUP_M + (tile_id % group_size)
+    pid_n = (tile_id % width) // (group_size)
+    return pid_m, pid_n
+
+
+@autotune(
+    configs=get_configs_streamk(),
+    key=['M', 'N', 'K'],
+)
+@heuristics({
+    'EVEN_K': lambda args: args['K'] % args['BLOCK_K'] == 0,
+    'GROUP_M': lambda args: _get_group_m(args),
+})
+@jit
+def _streamk_kernel(A, B, C, Scale, Partials, M, N, K,  #
+                    stride_am, stride_ak,  #
+                    stride_bk, stride_bn,  #
+                    stride_cm, stride_cn,  #
+                    acc_dtype: tl.constexpr,  #
+                    allow_tf32: tl.constexpr,  #
+                    fp8_fast_accum: tl.constexpr,  #
+                    HAS_SCALE: tl.constexpr,  #
+                    BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,  #
+                    GROUP_M: tl.constexpr, EVEN_K: tl.constexpr, AB_DTYPE: tl.constexpr  #
+                    ):
+    # Each program runs an even share of the BLOCK_K iterations of all the
+    # tiles. The tiles it covers entirely are stored to C, the partial sums of
+    # the first and last tiles it only covers partly are stored to its two
+    # `Partials` slots, which `_streamk_fixup_kernel` reduces.
+    pid = tl.program_id(0).to(tl.int64)
+    num_programs = tl.num_programs(0)
+    iters_per_tile = tl.cdiv(K, BLOCK_K)
+    total_iters = tl.cdiv(M, BLOCK_M) * tl.cdiv(N, BLOCK_N) * iters_per_tile
+    start = (pid * total_iters // num_programs).to(tl.int32)
+    end = ((pid + 1) * total_iters // num_programs).to(tl.int32)
+    it = start
+    while it < end:
+        tile_id = it // iters_per_tile
+        tile_start = tile_id * iters_per_tile
+        seg_end = min(end, tile_start + iters_per_tile)
+        pid_m, pid_n = _tile_coords(tile_id, M, N, BLOCK_M, BLOCK_N, GROUP_M)
+        rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+        rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+        ram = tl.max_contiguous(tl.multiple_of(rm % M, BLOCK_M), BLOCK_M)
+        rbn = tl.max_contiguous(tl.multiple_of(rn % N, BLOCK_N), BLOCK_N)
+        rk = (it - tile_start) * BLOCK_K + tl.arange(0, BLOCK_K)
+        A_ptr = A + (ram[:, None] * stride_am + rk[None, :] * stride_ak)
+        B_ptr = B + (rk[:, None] * stride_bk + rbn[None, :] * stride_bn)
+        acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=acc_dtype)
+        for k in range(it - tile_start, seg_end - tile_start):
+            if EVEN_K:
+                a = tl.load(A_ptr)
+                b = tl.load(B_ptr)
+            else:
+                k_remaining = K - k * BLOCK_K
+                _0 = tl.zeros((1, 1), dtype=C.dtype.element_ty)
+                a = tl.load(A_ptr, mask=tl.arange(0, BLOCK_K)[None, :] < k_remaining, other=_0)
+                b = tl.load(B_ptr, mask=tl.arange(0, BLOCK_K)[:, None] < k_remaining, other=_0)
+            if AB_DTYPE is not None:
+                a = a.to(AB_DTYPE)
+                b = b.to(AB_DTYPE)
+            if fp8_fast_accum:
+                acc = tl.dot(a, b, acc, out_dtype=acc_dtype, allow_tf32=allow_tf32)
+            else:
+                acc += tl.dot(a, b, out_dtype=acc_dtype, allow_tf32=allow_tf32)
+            A_ptr += BLOCK_K * stride_ak
+            B_ptr += BLOCK_K * stride_bk
+        if it == tile_start and seg_end == tile_start + iters_per_tile:
+            if HAS_SCALE:
+                scale = tl.load(Scale + rn, mask=rn < N, other=0.)
+                acc = acc.to(tl.float32) * scale[None, :]
+            C_ptr = C + (rm[:, None] * stride_cm + rn[None, :] * stride_cn)
+            mask = (rm < M)[:, None] & (rn < N)[None, :]
+            tl.store(C_ptr, acc.to(C.dtype.element_ty), mask=mask)
         else:
-            assert isinstance(acc_dtype, torch.dtype), "acc_dtype must be a torch.dtype"
-            assert acc_dtype in supported_acc_dtypes[a.dtype], "acc_dtype not compatible with the type of a"
-            assert acc_dtype in supported_acc_dtypes[b.dtype], "acc_dtype not compatible with the type of b"
+            slot = tl.where(tile_id == start // iters_per_tile, 0, 1)
+            rpm = tl.arange(0, BLOCK_M)
+            rpn = tl.arange(0, BLOCK_N)
+            P_ptr = Partials + ((pid * 2 + slot) * BLOCK_M + rpm[:, None]) * BLOCK_N + rpn[None, :]
+            tl.store(P_ptr, acc)
+        it = seg_end
 
-        def to_tl_type(ty):
-            return getattr(tl, str(ty).split(".")[-1])
 
-        acc_dtype = to_tl_type(acc_dtype)
-        ab_dtype = to_tl_type(ab_dtype)
-        output_dtype = to_tl_type(output_dtype)
+@jit
+def _streamk_fixup_kernel(C, Scale, Partials, M, N,  #
+                          stride_cm, stride_cn,  #
+                          total_iters, iters_per_tile, num_programs,  #
+                          HAS_SCALE: tl.constexpr,  #
+                          BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, GROUP_M: tl.constexpr  #
+                          ):
+    # Sums the partial sums of a tile in the order of the programs that
+    # computed them, so that the result doesn't depend on their scheduling.
+    tile_id = tl.program_id(0).to(tl.int64)
+    tile_start = tile_id * iters_per_tile
+    tile_end = tile_start + iters_per_tile
+    first = ((tile_start + 1) * num_programs - 1) // total_iters
+    last = (tile_end * num_programs - 1) // total_iters
+    if first != last:
+        rpm = tl.arange(0, BLOCK_M)
+        rpn = tl.arange(0, BLOCK_N)
+        acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=Partials.dtype.element_ty)
+        for p in range(first, last + 1):
+            p_start = p * total_iters // num_programs
+            slot = tl.where(p_start // iters_per_tile == tile_id, 0, 1)
+            acc += tl.load(Partials + ((p * 2 + slot) * BLOCK_M + rpm[:, None]) * BLOCK_N + rpn[None, :])
+        pid_m, pid_n = _tile_coords(tile_id, M, N, BLOCK_M, BLOCK_N, GROUP_M)
+        rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+        rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+        if HAS_SCALE:
+            scale = tl.load(Scale + rn, mask=rn < N, other=0.)
+            acc = acc.to(tl.float32) * scale[None, :]
+        C_ptr = C + (rm[:, None] * stride_cm + rn[None, :] * stride_cn)
+        mask = (rm < M)[:, None] & (rn < N)[None, :]
+        tl.store(C_ptr, acc.to(C.dtype.element_ty), mask=mask)
+
+
+def get_configs_grouped():
+    # DPAS friendly tiles, from the large GEMMs down to the skinny experts of
+    # MoE layers that only get a few tokens each
+    return [
+        Config({'BLOCK_M': 256, 'BLOCK_N': 256, 'BLOCK_K': 32}, num_stages=3, num_warps=32),
+        Config({'BLOCK_M': 128, 'BLOCK_N': 256, 'BLOCK_K': 32}, num_stages=3, num_warps=16),
+        Config({'BLOCK_M': 128, 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=3, num_warps=8),
+        Config({'BLOCK_M': 64, 'BLOCK_N': 128, 'BLOCK_K': 64}, num_stages=3, num_warps=8),
+        Config({'BLOCK_M': 64, 'BLOCK_N': 64, 'BLOCK_K': 64}, num_stages=2, num_warps=4),
+        Config({'BLOCK_M': 32, 'BLOCK_N': 128, 'BLOCK_K': 64}, num_stages=2, num_warps=4),
+        Config({'BLOCK_M': 16, 'BLOCK_N': 128, 'BLOCK_K': 64}, num_stages=2, num_warps=2),
+    ]
+
+
+@autotune(
+    configs=get_configs_grouped(),
+    key=['num_groups', 'TOTAL_MN', 'MAX_K'],
+)
+@jit
+def _grouped_kernel(Ptrs, Sizes, Strides, num_groups,  #
+                    TOTAL_MN, MAX_K,  #
+                    acc_dtype: tl.constexpr,  #
+                    allow_tf32: tl.constexpr,  #
+                    A_DTYPE: tl.constexpr, B_DTYPE: tl.constexpr, C_DTYPE: tl.constexpr,  #
+                    BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,  #
+                    GROUP_M: tl.constexpr, AB_DTYPE: tl.constexpr  #
+                    ):
+    # Each persistent program takes every `num_programs`-th tile of the
+    # concatenation of the tiles of all the GEMMs. `Ptrs` holds the addresses
+    # of A, B and C of each GEMM, `Sizes` their M, N and K, and `Strides` the
+    # strides of A, B and C.
+    tile_id = tl.program_id(0)
+    num_programs = tl.num_programs(0)
+    group_start = 0
+    for g in range(num_groups):
+        M = tl.load(Sizes + g * 3)
+        N = tl.load(Sizes + g * 3 + 1)
+        K = tl.load(Sizes + g * 3 + 2)
+        group_tiles = tl.cdiv(M, BLOCK_M) * tl.cdiv(N, BLOCK_N)
+        while tile_id >= group_start and tile_id < group_start + group_tiles:
+            A = tl.load(Ptrs + g * 3).to(tl.pointer_type(A_DTYPE))
+            B = tl.load(Ptrs + g * 3 + 1).to(tl.pointer_type(B_DTYPE))
+            C = tl.load(Ptrs + g * 3 + 2).to(tl.pointer_type(C_DTYPE))
+            stride_am = tl.load(Strides + g * 6)
+            stride_ak = tl.load(Strides + g * 6 + 1)
+            stride_bk = tl.load(Strides + g * 6 + 2)
+            stride_bn = tl.load(Strides + g * 6 + 3)
+            stride_cm = tl.load(Strides + g * 6 + 4)
+            stride_cn = tl.load(Strides + g * 6 + 5)
+            pid_m, pid_n = _tile_coords(tile_id - group_start, M, N, BLOCK_M, BLOCK_N, GROUP_M)
+            rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+            rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+            ram = tl.max_contiguous(tl.multiple_of(rm % M, BLOCK_M), BLOCK_M)
+            rbn = tl.max_contiguous(tl.multiple_of(rn % N, BLOCK_N), BLOCK_N)
+            rk = tl.arange(0, BLOCK_K)
+            A_ptr = A + (ram[:, None] * stride_am + rk[None, :] * stride_ak)
+            B_ptr = B + (rk[:, None] * stride_bk + rbn[None, :] * stride_bn)
+            acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=acc_dtype)
+            for k in range(0, tl.cdiv(K, BLOCK_K)):
+                k_remaining = K - k * BLOCK_K
+                a = tl.load(A_ptr, mask=rk[None, :] < k_remaining, other=0.)
+                b = tl.load(B_ptr, mask=rk[:, None] < k_remaining, other=0.)
+                if AB_DTYPE is not None:
+                    a = a.to(AB_DTYPE)
+                    b = b.to(AB_DTYPE)
+                acc += tl.dot(a, b, out_dtype=acc_dtype, allow_tf32=allow_tf32)
+                A_ptr += BLOCK_K * stride_ak
+                B_ptr += BLOCK_K * stride_bk
+            C_ptr = C + (rm[:, None] * stride_cm + rn[None, :] * stride_cn)
+            mask = (rm < M)[:, None] & (rn < N)[None, :]
+            tl.store(C_ptr, acc.to(C_DTYPE), mask=mask)
+            tile_id += num_programs
+        group_start += group_tiles
+
+
+def _prepare_operands(a, b, acc_dtype, output_dtype, scale):
+    device = a.device
+    # handle non-contiguous inputs if necessary
+    if a.stride(0) > 1 and a.stride(1) > 1:
+        a = a.contiguous()
+    if b.stride(0) > 1 and b.stride(1) > 1:
+        b = b.contiguous()
+    # checks constraints
+    assert a.shape[1] == b.shape[0], "incompatible dimensions"
+    M, K = a.shape
+    _, N = b.shape
+
+    # common type between a and b
+    ab_dtype = get_higher_dtype(a.dtype, b.dtype)
+
+    # allocates output
+    if (output_dtype is None):
+        # scaled integer products are real numbers
+        output_dtype = torch.float32 if scale is not None and ab_dtype is torch.int8 else ab_dtype
+    if scale is not None:
+        assert scale.shape == (N, ), "scale must have one element per column of b"
+        scale = scale.contiguous()
+
+    c = torch.empty((M, N), device=device, dtype=output_dtype)
+
+    # Allowed types for acc_type given the types of a and b.
+    supported_acc_dtypes = {
+        torch.float16: (torch.float32, torch.float16), torch.bfloat16: (torch.float32, torch.bfloat16),
+        torch.float32: (torch.float32, ), torch.int8: (torch.int32, )
+    }
 
-        # Tensor cores support input with mixed float8 types.
-        if a.dtype in [tl.float8e4nv, tl.float8e5] and b.dtype in [tl.float8e4nv, tl.float8e5]:
-            ab_dtype = None
+    if acc_dtype is None:
+        acc_dtype = supported_acc_dtypes[ab_dtype][0]
+    else:
+        assert isinstance(acc_dtype, torch.dtype), "acc_dtype must be a torch.dtype"
+        assert acc_dtype in supported_acc_dtypes[a.dtype], "acc_dtype not compatible with the type of a"
+        assert acc_dtype in supported_acc_dtypes[b.dtype], "acc_dtype not compatible with the type of b"
+
+    def to_tl_type(ty):
+        return getattr(tl, str(ty).split(".")[-1])
+
+    acc_dtype = to_tl_type(acc_dtype)
+    ab_dtype = to_tl_type(ab_dtype)
+    output_dtype = to_tl_type(output_dtype)
+
+    # Tensor cores support input with mixed float8 types.
+    if a.dtype in [tl.float8e4nv, tl.float8e5] and b.dtype in [tl.float8e4nv, tl.float8e5]:
+        ab_dtype = None
+    return a, b, c, scale, M, N, K, acc_dtype, ab_dtype
+
+
+class _matmul(torch.autograd.Function):
+    kernel = _kernel
+
+    _locks = {}
+
+    @staticmethod
+    def _call(a, b, acc_dtype, allow_tf32, fp8_fast_accum, output_dtype, scale, prologue_fn=None, prologue_args=(),
+              epilogue_fn=None, epilogue_args=()):
+        a, b, c, scale, M, N, K, acc_dtype, ab_dtype = _prepare_operands(a, b, acc_dtype, output_dtype, scale)
+        prologue_args = _hook_args(prologue_args)
+        epilogue_args = _hook_args(epilogue_args)
         # launch kernel
         grid = lambda META: (cdiv(M, META['BLOCK_M']) * cdiv(N, META['BLOCK_N']), META['SPLIT_K'])
+        # the hooks are passed by position, for the pruning of the configs
         _kernel[grid](
-            a, b, c, M, N, K,  #
+            a, b, c, scale, M, N, K,  #
             a.stride(0), a.stride(1),  #
             b.stride(0), b.stride(1),  #
             c.stride(0), c.stride(1),  #
+            prologue_fn, *prologue_args,  #
+            epilogue_fn, *epilogue_args,  #
             acc_dtype=acc_dtype,  #
             allow_tf32=allow_tf32,  #
             fp8_fast_accum=fp8_fast_accum,  #
-            GROUP_M=8, AB_DTYPE=ab_dtype)
+            HAS_SCALE=scale is not None,  #
+            AB_DTYPE=ab_dtype)
         return c
 
     @staticmethod
-    def forward(ctx, a, b, acc_dtype=None, allow_tf32=True, fp8_fast_accum=True, output_dtype=None):
+    def forward(ctx, a, b, acc_dtype=None, allow_tf32=True, fp8_fast_accum=True, output_dtype=None, scale=None,
+                prologue_fn=None, prologue_args=(), epilogue_fn=None, epilogue_args=()):
+        """
+        Returns `a @ b`, with the element-wise operations of `prologue_fn` and
+        `epilogue_fn`, @jit functions, fused into the kernel, which is compiled
+        for each of them:
+
+        - `prologue_fn(a, rows, cols, *prologue_args)` returns the tile of `a`
+          at `rows` and `cols` as loaded, converted first, e.g. dequantized,
+        - `epilogue_fn(c, rows, cols, *epilogue_args)` returns the tile of the
+          product at `rows` and `cols`, scaled by `scale` if given, to store,
+          e.g. with a bias, an activation or a residual added.
+
+        Their `*_args` are up to 3 tensors or scalars. The rows and columns of
+        the epilogue go past the bounds of the product on its edges, where the
+        hook must mask its loads, the prologue gets those of the elements of
+        `a` loaded. The products with an epilogue aren't split along K.
+        """
         return _matmul._call(a, b, acc_dtype=acc_dtype, allow_tf32=allow_tf32, fp8_fast_accum=fp8_fast_accum,
-                             output_dtype=output_dtype)
+                             output_dtype=output_dtype, scale=scale, prologue_fn=prologue_fn,
+                             prologue_args=prologue_args, epilogue_fn=epilogue_fn, epilogue_args=epilogue_args)
 
 
 matmul = _matmul.apply
+
+
+class _matmul_streamk(torch.autograd.Function):
+    kernel = _streamk_kernel
+
+    _partials = {}
+
+    @staticmethod
+    def _get_partials(device, num_programs, dtype):
+        # Room for the two partial tiles of each program with the largest tiles
+        # of the configs.
+        tile_size = max(config.kwargs['BLOCK_M'] * config.kwargs['BLOCK_N'] for config in _streamk_kernel.configs)
+        size = num_programs * 2 * tile_size
+        key = (device, dtype)
+        partials = _matmul_streamk._partials.get(key)
+        if partials is None or partials.numel() < size:
+            partials = torch.empty(size, device=device, dtype=dtype)
+            _matmul_streamk._partials[key] = partials
+        return partials
+
+    @staticmethod
+    def _call(a, b, acc_dtype, allow_tf32, fp8_fast_accum, output_dtype, scale):
+        from ..runtime import driver
+        a, b, c, scale, M, N, K, acc_dtype, ab_dtype = _prepare_operands(a, b, acc_dtype, output_dtype, scale)
+        # one persistent program per Xe-core
+        device = driver.active.get_current_device()
+        num_programs = driver.active.utils.get_device_properties(device)["multiprocessor_count"]
+        partials_dtype = torch.int32 if acc_dtype is tl.int32 else torch.float32
+        partials = _matmul_streamk._get_partials(a.device, num_programs, partials_dtype)
+        iters_per_tile = lambda META: cdiv(K, META['BLOCK_K'])
+        num_tiles = lambda META: cdiv(M, META['BLOCK_M']) * cdiv(N, META['BLOCK_N'])
+        # the iterations are split across programs from the grid size
+        grid = lambda META: (min(num_programs, num_tiles(META) * iters_per_tile(META)), )
+        _streamk_kernel[grid](
+            a, b, c, scale, partials, M, N, K,  #
+            a.stride(0), a.stride(1),  #
+            b.stride(0), b.stride(1),  #
+            c.stride(0), c.stride(1),  #
+            acc_dtype=acc_dtype,  #
+            allow_tf32=allow_tf32,  #
+            fp8_fast_accum=fp8_fast_accum,  #
+            HAS_SCALE=scale is not None,  #
+            AB_DTYPE=ab_dtype)
+        META = _streamk_kernel.best_config.kwargs
+        _streamk_fixup_kernel[(num_tiles(META), )](
+            c, scale, partials, M, N,  #
+            c.stride(0), c.stride(1),  #
+            num_tiles(META) * iters_per_tile(META), iters_per_tile(META), grid(META)[0],  #
+            HAS_SCALE=scale is not None,  #
+            BLOCK_M=META['BLOCK_M'], BLOCK_N=META['BLOCK_N'],
+            GROUP_M=get_group_m(M, N, K, META['BLOCK_M'], META['BLOCK_N'], a.element_size()))
+        return c
+
+    @staticmethod
+    def forward(ctx, a, b, acc_dtype=None, allow_tf32=True, fp8_fast_accum=True, output_dtype=None, scale=None):
+        return _matmul_streamk._call(a, b, acc_dtype=acc_dtype, allow_tf32=allow_tf32, fp8_fast_accum=fp8_fast_accum,
+                                     output_dtype=output_dtype, scale=scale)
+
+
+# Balances the work of the GEMMs with few output tiles, e.g. skinny ones with a
+# large K, across all the Xe-cores with a stream-K decomposition.
+matmul_streamk = _matmul_streamk.apply
+
+
+class _grouped_matmul:
+    kernel = _grouped_kernel
+
+    @staticmethod
+    def _call(a, b, acc_dtype, allow_tf32, output_dtype):
+        from ..runtime import driver
+        assert len(a) == len(b) and len(a) > 0, "expected as many A as B matrices"
+        groups = []
+        for x, y in zip(a, b):
+            x, y, z, _, M, N, K, group_acc_dtype, ab_dtype = _prepare_operands(x, y, acc_dtype, output_dtype, None)
+            groups.append((x, y, z, M, N, K))
+        x, y, z = groups[0][:3]
+        for group in groups:
+            assert tuple(t.dtype for t in group[:3]) == (x.dtype, y.dtype, z.dtype), "the GEMMs must have the same types"
+
+        def to_tl_type(ty):
+            return getattr(tl, str(ty).split(".")[-1])
+
+        device = x.device
+        ptrs = torch.tensor([[x.data_ptr(), y.data_ptr(), z.data_ptr()] for x, y, z, *_ in groups], dtype=torch.int64,
+                            device=device)
+        sizes = torch.tensor([[M, N, K] for *_, M, N, K in groups], dtype=torch.int32, device=device)
+        strides = torch.tensor([[*x.stride(), *y.stride(), *z.stride()] for x, y, z, *_ in groups], dtype=torch.int64,
+                               device=device)
+        # one persistent program per Xe-core
+        num_programs = driver.active.utils.get_device_properties(
+            driver.active.get_current_device())["multiprocessor_count"]
+        num_tiles = lambda META: sum(cdiv(M, META['BLOCK_M']) * cdiv(N, META['BLOCK_N']) for *_, M, N, K in groups)
+        grid = lambda META: (max(1, min(num_programs, num_tiles(META))), )
+        # the tuning keys are rounded so that the varying number of tokens per
+        # expert doesn't retune the kernel at every call
+        total_mn = next_power_of_2(sum(M * N for *_, M, N, K in groups))
+        max_k = next_power_of_2(max(K for *_, K in groups))
+        _grouped_kernel[grid](
+            ptrs, sizes, strides, len(groups),  #
+            total_mn, max_k,  #
+            acc_dtype=group_acc_dtype,  #
+            allow_tf32=allow_tf32,  #
+            A_DTYPE=to_tl_type(x.dtype), B_DTYPE=to_tl_type(y.dtype), C_DTYPE=to_tl_type(z.dtype),  #
+            GROUP_M=8, AB_DTYPE=ab_dtype)
+        return [z for _, _, z, *_ in groups]
+
+
+def grouped_matmul(a, b, acc_dtype=None, allow_tf32=True, output_dtype=None):
+    """
+    Computes the products `a[i] @ b[i]` of the lists of matrices `a` and `b`,
+    e.g. the GEMMs of the experts of a MoE layer, in a single persistent launch.
+    The GEMMs may have different shapes but must have the same types.
+    """
+    return _grouped_matmul._call(a, b, acc_dtype=acc_dtype, allow_tf32=allow_tf32, output_dtype=output_dtype)
@@ -25,7 +25,42 @@ def get_simd_tflops(device, num_ctas, num_warps, dtype):
     return tflops
 
 
+def is_xpu():
+    return driver.active.get_current_target()[0] == "xpu"
+
+
+# Per device_arch, the number of vector engines of an Xe-core, each paired with a
+# DPAS engine, and the dense DPAS throughput of an Xe-core in ops per clock.
+_XPU_ENGINES_PER_XE_CORE = {0: 16, 1: 8}  # Arc, PVC
+_XPU_DPAS_OPS_PER_CLOCK = {
+    0: {torch.float16: 2048, torch.bfloat16: 2048, torch.int8: 4096},  # Arc
+    1: {torch.float16: 4096, torch.bfloat16: 4096, torch.float32: 2048, torch.int8: 8192},  # PVC, fp32 as tf32
+}
+# The vector engines of an Xe-core run 256 fp32 ops per clock on both.
+_XPU_SIMD_OPS_PER_CLOCK = 256
+
+
+def get_xpu_tflops(device, num_ctas, num_warps, dtype):
+    ''' return compute throughput in TOPS '''
+    props = driver.active.utils.get_device_properties(device)
+    arch = props["device_arch"]
+    num_xe_cores = props["multiprocessor_count"]
+    ops_per_clock = _XPU_DPAS_OPS_PER_CLOCK.get(arch, {}).get(dtype, _XPU_SIMD_OPS_PER_CLOCK)
+    # Each sub-group keeps one engine busy.
+    num_engines = num_xe_cores * _XPU_ENGINES_PER_XE_CORE.get(arch, 8)
+    active_ratio = min(1, num_ctas * num_warps / num_engines)
+    return active_ratio * num_xe_cores * ops_per_clock * props["sm_clock_rate"] * 1e6 / 1e12
+
+
+def get_xpu_dram_gbps(device):
+    ''' return DRAM bandwidth in GB/s '''
+    props = driver.active.utils.get_device_properties(device)
+    return props["mem_clock_rate"] * 1e6 * props["mem_bus_width"] * 2 / 8 / 1e9  # clock in MHz
+
+
 def get_tflops(device, num_ctas, num_warps, dtype):
+    if is_xpu():
+        return get_xpu_tflops(device, num_ctas, num_warps, dtype)
     capability = torch.cuda.get_device_capability(device)
     if capability[0] < 8 and dtype == torch.float32:
         return get_simd_tflops(device, num_ctas, num_warps, dtype)
@@ -42,7 +77,7 @@ def estimate_matmul_time(
 ):
     ''' return estimated running time in ms
           = max(compute, loading) + store '''
-    device = torch.cuda.current_device()
+    device = driver.active.get_current_device()
     dtype = A.dtype
     dtsize = A.element_size()
 
@@ -62,9 +97,17 @@ def estimate_matmul_time(
     # time to load data
     num_sm = driver.active.utils.get_device_properties(device)["multiprocessor_count"]
     active_cta_ratio = min(1, num_ctas / num_sm)
-    active_cta_ratio_bw1 = min(1, num_ctas / 32)  # 32 active ctas are enough to saturate
-    active_cta_ratio_bw2 = max(min(1, (num_ctas - 32) / (108 - 32)), 0)  # 32-108, remaining 5%
-    dram_bw = get_dram_gbps(device) * (active_cta_ratio_bw1 * 0.95 + active_cta_ratio_bw2 * 0.05)  # in GB/s
+    if is_xpu():
+        # a quarter of the Xe-cores are enough to saturate
+        saturating_ctas = max(1, num_sm // 4)
+        active_cta_ratio_bw1 = min(1, num_ctas / saturating_ctas)
+        active_cta_ratio_bw2 = max(min(1, (num_ctas - saturating_ctas) / max(1, num_sm - saturating_ctas)), 0)
+        dram_gbps = get_xpu_dram_gbps(device)
+    else:
+        active_cta_ratio_bw1 = min(1, num_ctas / 32)  # 32 active ctas are enough to saturate
+        active_cta_ratio_bw2 = max(min(1, (num_ctas - 32) / (108 - 32)), 0)  # 32-108, remaining 5%
+        dram_gbps = get_dram_gbps(device)
+    dram_bw = dram_gbps * (active_cta_ratio_bw1 * 0.95 + active_cta_ratio_bw2 * 0.05)  # in GB/s
     l2_bw = dram_bw * 4  # rough estimation (should be 4.7 for A100?)
     # assume 80% of (following) loads are in L2 cache
     load_a_dram = M * K * dtsize * (1 + 0.2 * (num_cta_n - 1))
@@ -98,8 +141,9 @@ def estimate_matmul_time(
 
 
 def early_config_prune(configs, named_args):
-    device = torch.cuda.current_device()
-    capability = torch.cuda.get_device_capability()
+    device = driver.active.get_current_device()
+    xpu = is_xpu()
+    capability = None if xpu else torch.cuda.get_device_capability()
     # BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K, num_warps, num_stages
     dtsize = named_args['A'].element_size()
     dtype = named_args['A'].dtype
@@ -137,7 +181,22 @@ def early_config_prune(configs, named_args):
     pruned_configs = []
     for k, v in configs_map.items():
         BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K, num_warps = k
-        if capability[0] >= 8:
+        if xpu:
+            # each sub-group issues 8x16x16 DPAS, taking 8 cycles with a
+            # systolic depth of 8
+            dpas = BLOCK_M * BLOCK_N * BLOCK_K / (8 * 16 * 16)
+            dpas_cycles = dpas / num_warps * 8
+
+            load_latency = 500  # of 2D block loads from HBM
+            optimal_num_stages = load_latency / dpas_cycles
+
+            nearest = heapq.nsmallest(
+                2, v, key=lambda x: 10 + abs(x[1] - optimal_num_stages)
+                if (x[1] - optimal_num_stages) < 0 else x[1] - optimal_num_stages)
+
+            for n in nearest:
+                pruned_configs.append(n[0])
+        elif capability[0] >= 8:
             # compute cycles (only works for ampere GPUs)
             mmas = BLOCK_M * BLOCK_N * BLOCK_K / (16 * 8 * 16)
             mma_cycles = mmas / min(4, num_warps) * 8
@@ -157,3 +216,12 @@ def early_config_prune(configs, named_args):
             random_config.num_stages = 2
             pruned_configs.append(random_config)
     return pruned_configs
+
+
+def resource_prune(config, metadata):
+    """Rejects the configs whose kernel, as estimated by the compiler before building it, doesn't fit in the
+    registers of a hardware thread or can't run a single work-group on an Xe core."""
+    estimate = getattr(metadata, "resource_estimate", None)
+    if estimate is None:
+        return True
+    return estimate["work_groups_per_xe_core"] > 0 and estimate["num_grf"] <= estimate["max_num_grf"]
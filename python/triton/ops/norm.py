@@ -0,0 +1,345 @@
+import torch
+
+from .. import cdiv, jit
+from .. import language as tl
+from .. import next_power_of_2
+
+# The rows are normalized in tiles of at most this many columns.
+MAX_BLOCK = 4096
+# The rows longer than a tile are kept in the shared local memory between the
+# passes over them when they fit in this many bytes, in fp32, and are read
+# again from the global memory otherwise.
+SLM_BYTES = 64 * 1024
+# programs of the backward pass per Xe-core, each accumulating the gradients
+# of the weights of its rows
+PROGRAMS_PER_XE_CORE = 4
+# the largest magnitude of each quantized type
+QUANT_MAX = {"int8": 127.0, "fp8": 448.0}
+QUANT_DTYPES = {"int8": torch.int8, "fp8": torch.float8_e4m3fn if hasattr(torch, "float8_e4m3fn") else None}
+
+
+@jit
+def _load_input(X, Residual, ResidualOut, cols, mask, HAS_RESIDUAL: tl.constexpr, STORE_RESIDUAL: tl.constexpr):
+    # the input of the norm, with the residual added
+    x = tl.load(X + cols, mask=mask, other=0.).to(tl.float32)
+    if HAS_RESIDUAL:
+        x += tl.load(Residual + cols, mask=mask, other=0.).to(tl.float32)
+        if STORE_RESIDUAL:
+            tl.store(ResidualOut + cols, x.to(ResidualOut.dtype.element_ty), mask=mask)
+    return x
+
+
+@jit
+def _normalize(x, mean, rstd, W, B, cols, mask, HAS_BIAS: tl.constexpr):
+    w = tl.load(W + cols, mask=mask, other=0.).to(tl.float32)
+    y = (x - mean) * rstd * w
+    if HAS_BIAS:
+        y += tl.load(B + cols, mask=mask, other=0.).to(tl.float32)
+    return y
+
+
+@jit
+def _quantize(y, scale, QUANT: tl.constexpr, dtype):
+    y = y / scale
+    if QUANT == "int8":
+        # rounded to nearest
+        y = tl.where(y >= 0, y + 0.5, y - 0.5)
+        y = tl.minimum(tl.maximum(y, -127.), 127.)
+    return y.to(dtype)
+
+
+@jit
+def _norm_fwd_kernel(X, Residual, ResidualOut, W, B, Y, Scale, Mean, Rstd,  #
+                     stride_x, stride_r, stride_ro, stride_y, N, eps,  #
+                     IS_RMS: tl.constexpr, HAS_RESIDUAL: tl.constexpr, HAS_BIAS: tl.constexpr,  #
+                     QUANT: tl.constexpr, QUANT_MAX: tl.constexpr,  #
+                     BLOCK: tl.constexpr, NUM_BLOCKS: tl.constexpr, IN_SLM: tl.constexpr):
+    # Each program normalizes a row, in a single tile or by passes over its
+    # tiles: the statistics of the row, then its absolute maximum for the
+    # quantization, then its output.
+    row = tl.program_id(0).to(tl.int64)
+    X += row * stride_x
+    Y += row * stride_y
+    if HAS_RESIDUAL:
+        Residual += row * stride_r
+        ResidualOut += row * stride_ro
+    offsets = tl.max_contiguous(tl.multiple_of(tl.arange(0, BLOCK), BLOCK), BLOCK)
+    if NUM_BLOCKS == 1:
+        mask = offsets < N
+        x = _load_input(X, Residual, ResidualOut, offsets, mask, HAS_RESIDUAL, True)
+        if IS_RMS:
+            mean = 0.
+        else:
+            mean = tl.sum(x, axis=0) / N
+        xc = tl.where(mask, x - mean, 0.)
+        rstd = 1 / tl.sqrt(tl.sum(xc * xc, axis=0) / N + eps)
+        y = _normalize(x, mean, rstd, W, B, offsets, mask, HAS_BIAS)
+        if QUANT is not None:
+            scale = tl.maximum(tl.max(tl.where(mask, tl.abs(y), 0.), axis=0), 1e-12) / QUANT_MAX
+            tl.store(Scale + row, scale)
+            y = _quantize(y, scale, QUANT, Y.dtype.element_ty)
+        tl.store(Y + offsets, y.to(Y.dtype.element_ty), mask=mask)
+    else:
+        if IN_SLM:
+            row_buffer = tl.local_buffer((NUM_BLOCKS * BLOCK, ), tl.float32)
+        num_blocks = tl.cdiv(N, BLOCK)
+        # the sum, or the sum of the squares for the RMS norm
+        acc = tl.zeros((BLOCK, ), dtype=tl.float32)
+        for i in range(0, num_blocks):
+            cols = i * BLOCK + offsets
+            x = _load_input(X, Residual, ResidualOut, cols, cols < N, HAS_RESIDUAL, True)
+            if IN_SLM:
+                row_buffer.store(x, cols)
+            if IS_RMS:
+                acc += x * x
+            else:
+                acc += x
+        if IS_RMS:
+            mean = 0.
+            rstd = 1 / tl.sqrt(tl.sum(acc, axis=0) / N + eps)
+        else:
+            mean = tl.sum(acc, axis=0) / N
+            acc = tl.zeros((BLOCK, ), dtype=tl.float32)
+            for i in range(0, num_blocks):
+                cols = i * BLOCK + offsets
+                if IN_SLM:
+                    x = row_buffer.load(cols)
+                else:
+                    x = _load_input(X, Residual, ResidualOut, cols, cols < N, HAS_RESIDUAL, False)
+                xc = tl.where(cols < N, x - mean, 0.)
+                acc += xc * xc
+            rstd = 1 / tl.sqrt(tl.sum(acc, axis=0) / N + eps)
+        if QUANT is not None:
+            absmax = tl.zeros((BLOCK, ), dtype=tl.float32)
+            for i in range(0, num_blocks):
+                cols = i * BLOCK + offsets
+                if IN_SLM:
+                    x = row_buffer.load(cols)
+                else:
+                    x = _load_input(X, Residual, ResidualOut, cols, cols < N, HAS_RESIDUAL, False)
+                y = _normalize(x, mean, rstd, W, B, cols, cols < N, HAS_BIAS)
+                absmax = tl.maximum(absmax, tl.where(cols < N, tl.abs(y), 0.))
+            scale = tl.maximum(tl.max(absmax, axis=0), 1e-12) / QUANT_MAX
+            tl.store(Scale + row, scale)
+        for i in range(0, num_blocks):
+            cols = i * BLOCK + offsets
+            if IN_SLM:
+                x = row_buffer.load(cols)
+            else:
+                x = _load_input(X, Residual, ResidualOut, cols, cols < N, HAS_RESIDUAL, False)
+            y = _normalize(x, mean, rstd, W, B, cols, cols < N, HAS_BIAS)
+            if QUANT is not None:
+                y = _quantize(y, scale, QUANT, Y.dtype.element_ty)
+            tl.store(Y + cols, y.to(Y.dtype.element_ty), mask=cols < N)
+    if not IS_RMS:
+        tl.store(Mean + row, mean)
+    tl.store(Rstd + row, rstd)
+
+
+@jit
+def _norm_bwd_kernel(DY, DH, X, W, Mean, Rstd, DX, DW, DB,  #
+                     stride_dy, stride_dh, stride_x, stride_dx, M, N,  #
+                     IS_RMS: tl.constexpr, HAS_DH: tl.constexpr, HAS_BIAS: tl.constexpr,  #
+                     BLOCK: tl.constexpr, NUM_BLOCKS: tl.constexpr, IN_SLM: tl.constexpr):
+    # Each program computes the gradients of the inputs of a share of the
+    # rows, and accumulates those of the weights of its rows in its row of DW
+    # and DB, which are summed afterwards.
+    pid = tl.program_id(0)
+    num_programs = tl.num_programs(0)
+    DW += pid * N
+    if HAS_BIAS:
+        DB += pid * N
+    offsets = tl.max_contiguous(tl.multiple_of(tl.arange(0, BLOCK), BLOCK), BLOCK)
+    if NUM_BLOCKS == 1:
+        mask = offsets < N
+        w = tl.load(W + offsets, mask=mask, other=0.).to(tl.float32)
+        dw = tl.zeros((BLOCK, ), dtype=tl.float32)
+        db = tl.zeros((BLOCK, ), dtype=tl.float32)
+    elif IN_SLM:
+        x_buffer = tl.local_buffer((NUM_BLOCKS * BLOCK, ), tl.float32)
+        dy_buffer = tl.local_buffer((NUM_BLOCKS * BLOCK, ), tl.float32)
+    for r in range(pid, M, num_programs):
+        row = r.to(tl.int64)
+        x_row = X + row * stride_x
+        dy_row = DY + row * stride_dy
+        dx_row = DX + row * stride_dx
+        if HAS_DH:
+            dh_row = DH + row * stride_dh
+        if IS_RMS:
+            mean = 0.
+        else:
+            mean = tl.load(Mean + row)
+        rstd = tl.load(Rstd + row)
+        if NUM_BLOCKS == 1:
+            x = tl.load(x_row + offsets, mask=mask, other=0.).to(tl.float32)
+            dy = tl.load(dy_row + offsets, mask=mask, other=0.).to(tl.float32)
+            xhat = tl.where(mask, (x - mean) * rstd, 0.)
+            wdy = w * dy
+            c1 = tl.sum(xhat * wdy, axis=0) / N
+            if IS_RMS:
+                dx = (wdy - xhat * c1) * rstd
+            else:
+                c2 = tl.sum(wdy, axis=0) / N
+                dx = (wdy - (xhat * c1 + c2)) * rstd
+            if HAS_DH:
+                dx += tl.load(dh_row + offsets, mask=mask, other=0.).to(tl.float32)
+            tl.store(dx_row + offsets, dx.to(DX.dtype.element_ty), mask=mask)
+            dw += dy * xhat
+            db += dy
+        else:
+            num_blocks = tl.cdiv(N, BLOCK)
+            acc1 = tl.zeros((BLOCK, ), dtype=tl.float32)
+            acc2 = tl.zeros((BLOCK, ), dtype=tl.float32)
+            for i in range(0, num_blocks):
+                cols = i * BLOCK + offsets
+                x = tl.load(x_row + cols, mask=cols < N, other=0.).to(tl.float32)
+                dy = tl.load(dy_row + cols, mask=cols < N, other=0.).to(tl.float32)
+                if IN_SLM:
+                    x_buffer.store(x, cols)
+                    dy_buffer.store(dy, cols)
+                xhat = tl.where(cols < N, (x - mean) * rstd, 0.)
+                wdy = tl.load(W + cols, mask=cols < N, other=0.).to(tl.float32) * dy
+                acc1 += xhat * wdy
+                acc2 += wdy
+            c1 = tl.sum(acc1, axis=0) / N
+            c2 = tl.sum(acc2, axis=0) / N
+            for i in range(0, num_blocks):
+                cols = i * BLOCK + offsets
+                if IN_SLM:
+                    x = x_buffer.load(cols)
+                    dy = dy_buffer.load(cols)
+                else:
+                    x = tl.load(x_row + cols, mask=cols < N, other=0.).to(tl.float32)
+                    dy = tl.load(dy_row + cols, mask=cols < N, other=0.).to(tl.float32)
+                xhat = tl.where(cols < N, (x - mean) * rstd, 0.)
+                wdy = tl.load(W + cols, mask=cols < N, other=0.).to(tl.float32) * dy
+                if IS_RMS:
+                    dx = (wdy - xhat * c1) * rstd
+                else:
+                    dx = (wdy - (xhat * c1 + c2)) * rstd
+                if HAS_DH:
+                    dx += tl.load(dh_row + cols, mask=cols < N, other=0.).to(tl.float32)
+                tl.store(dx_row + cols, dx.to(DX.dtype.element_ty), mask=cols < N)
+                # the rows of DW and DB are only accessed by their program
+                tl.store(DW + cols, tl.load(DW + cols, mask=cols < N) + dy * xhat, mask=cols < N)
+                if HAS_BIAS:
+                    tl.store(DB + cols, tl.load(DB + cols, mask=cols < N) + dy, mask=cols < N)
+    if NUM_BLOCKS == 1:
+        tl.store(DW + offsets, dw, mask=mask)
+        if HAS_BIAS:
+            tl.store(DB + offsets, db, mask=mask)
+
+
+def _get_block(N, buffers):
+    # the tile of the rows, and whether the rows of several tiles fit in SLM
+    # with their `buffers`
+    BLOCK = min(next_power_of_2(N), MAX_BLOCK)
+    num_blocks = next_power_of_2(cdiv(N, BLOCK))
+    in_slm = num_blocks > 1 and buffers * num_blocks * BLOCK * 4 <= SLM_BYTES
+    # a few elements of each work-item per tile for the vector loads, the
+    # tiles being reduced within the sub-groups first
+    num_warps = min(max(BLOCK // 256, 1), 16)
+    return BLOCK, num_blocks, in_slm, num_warps
+
+
+class _norm(torch.autograd.Function):
+
+    @staticmethod
+    def forward(ctx, x, weight, bias, residual, eps, is_rms, quantize):
+        assert quantize is None or quantize in QUANT_MAX, f"quantize must be one of {', '.join(QUANT_MAX)}"
+        shape = x.shape
+        N = shape[-1]
+        assert weight.shape == (N, ), "weight must have one element per column"
+        assert bias is None or bias.shape == (N, ), "bias must have one element per column"
+        x = x.reshape(-1, N)
+        if x.stride(-1) != 1:
+            x = x.contiguous()
+        M = x.shape[0]
+        if residual is not None:
+            assert residual.shape == shape, "residual must have the shape of x"
+            residual = residual.reshape(-1, N)
+            if residual.stride(-1) != 1:
+                residual = residual.contiguous()
+            residual_out = torch.empty_like(x)
+        else:
+            residual_out = None
+        if quantize is not None:
+            assert QUANT_DTYPES[quantize] is not None, f"torch doesn't support {quantize}"
+            y = torch.empty((M, N), device=x.device, dtype=QUANT_DTYPES[quantize])
+            scale = torch.empty(M, device=x.device, dtype=torch.float32)
+        else:
+            y = torch.empty_like(x)
+            scale = None
+        mean = None if is_rms else torch.empty(M, device=x.device, dtype=torch.float32)
+        rstd = torch.empty(M, device=x.device, dtype=torch.float32)
+        BLOCK, num_blocks, in_slm, num_warps = _get_block(N, buffers=1)
+        _norm_fwd_kernel[(M, )](
+            x, residual, residual_out, weight, bias, y, scale, mean, rstd,  #
+            x.stride(0), 0 if residual is None else residual.stride(0),  #
+            0 if residual_out is None else residual_out.stride(0), y.stride(0), N, eps,  #
+            IS_RMS=is_rms, HAS_RESIDUAL=residual is not None, HAS_BIAS=bias is not None,  #
+            QUANT=quantize, QUANT_MAX=QUANT_MAX.get(quantize, 1.0),  #
+            BLOCK=BLOCK, NUM_BLOCKS=num_blocks, IN_SLM=in_slm, num_warps=num_warps)
+        ctx.save_for_backward(x if residual_out is None else residual_out, weight, bias, mean, rstd)
+        ctx.shape = shape
+        ctx.is_rms = is_rms
+        ctx.has_residual = residual is not None
+        outputs = [y.reshape(shape)]
+        if scale is not None:
+            outputs.append(scale.reshape(shape[:-1]))
+            ctx.mark_non_differentiable(outputs[0], outputs[1])
+        if residual_out is not None:
+            outputs.append(residual_out.reshape(shape))
+        return tuple(outputs) if len(outputs) > 1 else outputs[0]
+
+    @staticmethod
+    def backward(ctx, dy, *doutputs):
+        from ..runtime import driver
+        x, weight, bias, mean, rstd = ctx.saved_tensors
+        M, N = x.shape
+        dy = dy.reshape(-1, N)
+        if dy.stride(-1) != 1:
+            dy = dy.contiguous()
+        # the gradient of the residual output
+        dh = doutputs[-1].reshape(-1, N) if ctx.has_residual and doutputs[-1] is not None else None
+        if dh is not None and dh.stride(-1) != 1:
+            dh = dh.contiguous()
+        dx = torch.empty_like(x)
+        BLOCK, num_blocks, in_slm, num_warps = _get_block(N, buffers=2)
+        num_xe_cores = driver.active.utils.get_device_properties(x.device.index)["multiprocessor_count"]
+        num_programs = max(1, min(M, num_xe_cores * PROGRAMS_PER_XE_CORE))
+        dw = torch.zeros((num_programs, N), device=x.device, dtype=torch.float32)
+        db = torch.zeros((num_programs, N), device=x.device, dtype=torch.float32) if bias is not None else None
+        _norm_bwd_kernel[(num_programs, )](
+            dy, dh, x, weight, mean, rstd, dx, dw, db,  #
+            dy.stride(0), 0 if dh is None else dh.stride(0), x.stride(0), dx.stride(0), M, N,  #
+            IS_RMS=ctx.is_rms, HAS_DH=dh is not None, HAS_BIAS=bias is not None,  #
+            BLOCK=BLOCK, NUM_BLOCKS=num_blocks, IN_SLM=in_slm, num_warps=num_warps)
+        dx = dx.reshape(ctx.shape)
+        dw = dw.sum(0).to(weight.dtype)
+        db = db.sum(0).to(bias.dtype) if bias is not None else None
+        return dx, dw, db, dx if ctx.has_residual else None, None, None, None
+
+
+def layer_norm(x, weight, bias=None, eps=1e-5, residual=None, quantize=None):
+    """
+    Returns the layer norm of `x` along its last dimension, scaled by `weight`
+    and shifted by `bias`, of `x + residual` when `residual` is given, in fp32.
+
+    With `quantize`, "int8" or "fp8" (e4m3), the output is quantized with a
+    scale per row, its absolute maximum over the largest magnitude of the
+    type, and returned with the fp32 scales. With `residual`, the sum
+    `x + residual` is returned last, e.g. as the residual of the next layer.
+    The rows of up to `MAX_BLOCK` columns are normalized in registers, the
+    longer ones by passes over their tiles, kept in the shared local memory
+    when they fit. The quantized outputs aren't differentiable.
+    """
+    return _norm.apply(x, weight, bias, residual, eps, False, quantize)
+
+
+def rms_norm(x, weight, eps=1e-6, residual=None, quantize=None):
+    """
+    Returns the RMS norm of `x` along its last dimension, scaled by `weight`,
+    of `x + residual` when `residual` is given, as `layer_norm`.
+    """
+    return _norm.apply(x, weight, None, residual, eps, True, quantize)
@@ -0,0 +1,171 @@
+import torch
+
+from .. import cdiv, jit
+from .. import language as tl
+from .. import next_power_of_2
+from ..language.standard import _argmax_combine_tie_break_left, _argmin_combine_tie_break_left
+
+# The rows are streamed in tiles of at most this many columns by each program.
+MAX_BLOCK = 4096
+# programs per Xe-core the rows are split across, so that a few rows still
+# keep all the Xe-cores busy
+PROGRAMS_PER_XE_CORE = 4
+# the value of the masked columns for each reduction
+IDENTITIES = {
+    "sum": 0.0, "max": float("-inf"), "min": float("inf"), "argmax": float("-inf"), "argmin": float("inf")
+}
+
+
+@jit
+def _combine(a, b, OP: tl.constexpr):
+    if OP == "sum":
+        c = a + b
+    elif OP == "max":
+        c = tl.maximum(a, b)
+    else:
+        c = tl.minimum(a, b)
+    return c
+
+
+@jit
+def _reduce(x, OP: tl.constexpr):
+    if OP == "sum":
+        y = tl.sum(x, 0)
+    elif OP == "max":
+        y = tl.max(x, 0)
+    else:
+        y = tl.min(x, 0)
+    return y
+
+
+@jit
+def _combine_with_indices(a, a_index, b, b_index, OP: tl.constexpr):
+    # `b` comes after `a`, which is kept when they are equal
+    if OP == "argmax":
+        keep_b = b > a
+    else:
+        keep_b = b < a
+    return tl.where(keep_b, b, a), tl.where(keep_b, b_index, a_index)
+
+
+@jit
+def _reduce_with_indices(x, index, OP: tl.constexpr):
+    # the (value, index) reductions are lowered to a single reduction of the
+    # pairs packed into 64 bits
+    if OP == "argmax":
+        y, y_index = tl.reduce((x, index), 0, _argmax_combine_tie_break_left)
+    else:
+        y, y_index = tl.reduce((x, index), 0, _argmin_combine_tie_break_left)
+    return y, y_index
+
+
+@jit
+def _split_reduce_kernel(X, Partials, IndexPartials, Counters, Out, N, stride_row, BLOCKS_PER_SPLIT,  #
+                         OP: tl.constexpr, IDENTITY: tl.constexpr, BLOCK: tl.constexpr,  #
+                         NUM_SPLITS: tl.constexpr, SINGLE_LAUNCH: tl.constexpr, WITH_INDICES: tl.constexpr):
+    row = tl.program_id(0)
+    split = tl.program_id(1)
+    offsets = tl.arange(0, BLOCK)
+    acc = tl.full([BLOCK], IDENTITY, tl.float32)
+    acc_index = tl.zeros([BLOCK], tl.int32)
+    start = split * BLOCKS_PER_SPLIT * BLOCK
+    for i in range(0, BLOCKS_PER_SPLIT):
+        cols = start + i * BLOCK + offsets
+        x = tl.load(X + row * stride_row + cols, mask=cols < N, other=IDENTITY)
+        if WITH_INDICES:
+            acc, acc_index = _combine_with_indices(acc, acc_index, x.to(tl.float32), cols, OP)
+        else:
+            acc = _combine(acc, x.to(tl.float32), OP)
+    if WITH_INDICES:
+        partial, partial_index = _reduce_with_indices(acc, acc_index, OP)
+        tl.store(IndexPartials + row * NUM_SPLITS + split, partial_index)
+    else:
+        partial = _reduce(acc, OP)
+    tl.store(Partials + row * NUM_SPLITS + split, partial)
+    if SINGLE_LAUNCH:
+        # The last program of the row to be done, which sees the partials of
+        # the others, reduces them.
+        if tl.atomic_add(Counters + row, 1) == NUM_SPLITS - 1:
+            splits = row * NUM_SPLITS + tl.arange(0, NUM_SPLITS)
+            partials = tl.load(Partials + splits, volatile=True)
+            if WITH_INDICES:
+                index_partials = tl.load(IndexPartials + splits, volatile=True)
+                _, index = _reduce_with_indices(partials, index_partials, OP)
+                tl.store(Out + row, index)
+            else:
+                tl.store(Out + row, _reduce(partials, OP))
+
+
+@jit
+def _finish_reduce_kernel(Partials, IndexPartials, Out, OP: tl.constexpr, NUM_SPLITS: tl.constexpr,
+                          WITH_INDICES: tl.constexpr):
+    row = tl.program_id(0)
+    splits = row * NUM_SPLITS + tl.arange(0, NUM_SPLITS)
+    partials = tl.load(Partials + splits)
+    if WITH_INDICES:
+        _, index = _reduce_with_indices(partials, tl.load(IndexPartials + splits), OP)
+        tl.store(Out + row, index)
+    else:
+        tl.store(Out + row, _reduce(partials, OP))
+
+
+def split_reduce(x, dim=-1, op="sum", single_launch=True, num_splits=None):
+    """
+    Reduce `x` along `dim` with `op`, "sum", "max", "min", "argmax" or
+    "argmin", in fp32, the rows longer than a block being split across
+    programs, so that a few long rows are reduced by all the Xe-cores.
+    "argmax" and "argmin" return the int64 index of the first extremum of
+    each row, of rows without NaNs.
+
+    Each program writes the reduction of its part of a row to a workspace of
+    the scratch pool. With `single_launch`, the last program of each row to be
+    done, counted by an atomic counter, reduces the partials of the row in the
+    same launch, otherwise a second kernel reduces them.
+
+    :param num_splits: the number of programs of each row, rounded down to a
+                       power of 2, from the Xe-cores of the device by default
+    """
+    from ..runtime import driver
+    assert op in IDENTITIES, f"op must be one of {', '.join(IDENTITIES)}"
+    assert x.is_floating_point(), "only floating point tensors are reduced"
+    x = x.movedim(dim, -1)
+    out_shape = x.shape[:-1]
+    N = x.shape[-1]
+    assert N > 0, "the reduced dimension must not be empty"
+    x = x.reshape(-1, N)
+    if x.stride(-1) != 1:
+        x = x.contiguous()
+    rows = x.shape[0]
+    with_indices = op in ("argmax", "argmin")
+    out = torch.empty(rows, device=x.device, dtype=torch.int64 if with_indices else x.dtype)
+    if rows == 0:
+        return out.reshape(out_shape)
+
+    BLOCK = min(next_power_of_2(N), MAX_BLOCK)
+    num_blocks = cdiv(N, BLOCK)
+    utils = driver.active.utils
+    if num_splits is None:
+        num_xe_cores = utils.get_device_properties(x.device.index)["multiprocessor_count"]
+        num_splits = max(1, num_xe_cores * PROGRAMS_PER_XE_CORE // rows)
+    num_splits = 1 << (max(1, min(num_splits, num_blocks)).bit_length() - 1)
+    blocks_per_split = cdiv(num_blocks, num_splits)
+    num_warps = 4 if BLOCK < 2048 else 8
+
+    with utils.scratch(rows * num_splits * 4, dtype=torch.float32, device=x.device.index) as partials:
+        index_partials = utils.scratch(rows * num_splits * 4, dtype=torch.int32,
+                                       device=x.device.index) if with_indices else None
+        counters = utils.scratch(rows * 4, dtype=torch.int32, zero=True,
+                                 device=x.device.index) if single_launch else None
+        _split_reduce_kernel[(rows, num_splits)](x, partials, index_partials, counters, out, N, x.stride(0),
+                                                 blocks_per_split,  #
+                                                 OP=op, IDENTITY=IDENTITIES[op], BLOCK=BLOCK,  #
+                                                 NUM_SPLITS=num_splits, SINGLE_LAUNCH=single_launch,  #
+                                                 WITH_INDICES=with_indices, num_warps=num_warps)
+        if counters is not None:
+            counters.release()
+        else:
+            _finish_reduce_kernel[(rows, )](partials, index_partials, out, OP=op, NUM_SPLITS=num_splits,
+                                            WITH_INDICES=with_indices)
+        if index_partials is not None:
+            index_partials.release()
+    return out.reshape(out_shape)
@@ -0,0 +1,36 @@
+import math
+
+from .. import cdiv
+
+# The group size of the tile swizzles tuned for the L2 of NVIDIA GPUs, used on
+# the devices whose L3 size isn't known.
+_DEFAULT_GROUP_M = 8
+
+
+def get_group_m(M, N, K, BLOCK_M, BLOCK_N, elem_size, device=None):
+    """
+    The rows of tiles `GROUP_M` of the groups the tiles of an (M, K) x (K, N)
+    GEMM are swizzled by, e.g. by `tl.swizzle2d`, from the L3 size and the
+    Xe-cores of `device`, the current device by default.
+
+    The tiles of a wave, one per Xe-core, run together and read the row
+    blocks of A of the rows of tiles of their group and the column blocks of
+    B of its columns: the fewest bytes are read by about
+    sqrt(cores * BLOCK_N / BLOCK_M) rows, which are limited so that the row
+    blocks of A of a group stay in half of the L3 while the group sweeps the
+    columns of B. No swizzle is needed when both operands fit in the L3.
+    """
+    from ..runtime import driver
+    if device is None:
+        device = driver.active.get_current_device()
+    props = driver.active.utils.get_device_properties(device)
+    l3_size = props.get("l3_cache_size", 0)
+    if not l3_size:
+        return _DEFAULT_GROUP_M
+    if (M + N) * K * elem_size <= l3_size:
+        return 1
+    grid_m = cdiv(M, BLOCK_M)
+    wave = min(props["multiprocessor_count"], grid_m * cdiv(N, BLOCK_N))
+    group_m = 1 << max(0, round(math.log2(math.sqrt(wave * BLOCK_N / BLOCK_M))))
+    max_group_m = max(1, l3_size // 2 // (BLOCK_M * K * elem_size))
+    return max(1, min(group_m, max_group_m, grid_m))
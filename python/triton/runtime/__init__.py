@@ -1,8 +1,10 @@
+from .batch import batch_launch
 from .autotuner import (Autotuner, Config, Heuristics, OutOfResources, autotune, heuristics)
 from .driver import driver
 from .jit import JITFunction, KernelInterface, MockTensor, TensorWrapper, reinterpret
 
 __all__ = [
+    "batch_launch",
     "driver",
     "Config",
     "Heuristics",
@@ -1,11 +1,16 @@
 from __future__ import annotations
 
 import builtins
+import hashlib
+import json
+import math
+import os
 import time
 from typing import Dict
 
-from ..testing import do_bench
-from .jit import KernelInterface
+from ..testing import do_bench, get_achieved_throughput
+from . import replay
+from .jit import KernelInterface, bucket_fn
 
 
 class OutOfResources(Exception):
@@ -36,12 +41,36 @@ class Autotuner(KernelInterface):
         prune_configs_by: Dict = None,
         warmup=25,
         rep=100,
+        cache_results=False,
+        collect_metrics=None,
+        successive_halving=False,
+        bucket=None,
     ):
         """
         :param prune_configs_by: a dict of functions that are used to prune configs, fields:
             'perf_model': performance model used to predicate running time with different configs, returns running time
             'top_k': number of configs to bench
             'prune_num_stages_by'(optional): a function used to prune num_stages. It takes configs:List[Config] as its input, and returns pruned configs.
+            'max_spills'(optional): configs whose compiled kernel spills more than this are discarded.
+            'resource_prune'(optional): a function used to prune the configs from the resources of their compiled
+            kernels, before they are benchmarked. It takes a config and the metadata of its kernel, e.g. its
+            `resource_estimate` on the XPU, as its input, and returns whether the config is kept.
+            'cost_model'(optional): a learned cost model, see `triton.runtime.cost_model`, predicting the time of the
+            compiled configs. Only its `top_k` fastest configs are benchmarked, and it learns from the benchmarks.
+        :param cache_results: whether the best configs are stored in the cache directory, and reused by later processes
+            on the same device and driver version.
+        :param collect_metrics: the metric group, e.g. "ComputeBasic", whose hardware counters are sampled while each
+            config runs, on the devices whose driver supports it. The mean values of the counters of each config are
+            exposed by `configs_metrics` and by the `metrics` of the metadata of its compiled kernel.
+        :param successive_halving: whether the configs are benchmarked by rounds of successive halving: all the
+            configs run for a short time, the slower half is dropped, as are the configs clearly slower than the
+            fastest one from the quantiles of their timings, and the time of the next round is doubled for the others.
+            The last round runs for `rep`.
+        :param bucket: maps the arguments of `key` to the buckets of their values, see `triton.jit`, the configs being
+            tuned once per bucket. The buckets of the jit function are used for the others.
+
+        The achieved bandwidth and FLOPS of each config, from the traffic of its kernel estimated by the compiler, are
+        exposed by `configs_throughput` on the backends that estimate it.
         """
         if not configs:
             self.configs = [Config({}, num_warps=4, num_stages=2, num_ctas=1)]
@@ -83,16 +112,36 @@ class Autotuner(KernelInterface):
         self.perf_model = None
         self.configs_top_k = 1.0
         self.early_config_prune = None
+        self.max_spills = None
+        self.resource_prune = None
+        self.cost_model = None
+        if os.environ.get("TRITON_AUTOTUNE_COST_MODEL"):
+            from .cost_model import get_cost_model
+            self.cost_model = get_cost_model(os.environ["TRITON_AUTOTUNE_COST_MODEL"])
         if prune_configs_by:
             self.perf_model = prune_configs_by.get("perf_model", self.perf_model)
             self.configs_top_k = prune_configs_by.get("top_k", self.configs_top_k)
             self.early_config_prune = prune_configs_by.get("early_config_prune", self.early_config_prune)
+            self.max_spills = prune_configs_by.get("max_spills", self.max_spills)
+            self.resource_prune = prune_configs_by.get("resource_prune", self.resource_prune)
+            self.cost_model = prune_configs_by.get("cost_model", self.cost_model)
 
         self.fn = fn
         self.num_warmups = warmup
         self.num_reps = rep
-
-    def _bench(self, *args, config, **meta):
+        self.cache_results = cache_results or os.environ.get("TRITON_CACHE_AUTOTUNING", "0") == "1"
+        self.metrics_group = collect_metrics or os.environ.get("TRITON_AUTOTUNE_METRICS") or None
+        self.successive_halving = successive_halving or os.environ.get("TRITON_AUTOTUNE_HALVING", "0") == "1"
+        self.configs_metrics = {}
+        self.configs_throughput = {}
+        # the buckets of the jit function, under the heuristics
+        jit_fn = fn
+        while jit_fn is not None and not hasattr(jit_fn, "bucket"):
+            jit_fn = getattr(jit_fn, "fn", None)
+        buckets = dict(getattr(jit_fn, "bucket", {}), **(bucket or {}))
+        self.key_buckets = [bucket_fn(buckets[k]) if k in buckets else None for k in key]
+
+    def _bench(self, *args, config, rep=None, **meta):
         # check for conflicts, i.e. meta-parameters both provided
         # as kwargs and by the autotuner
         conflicts = meta.keys() & config.kwargs.keys()
@@ -102,12 +151,13 @@ class Autotuner(KernelInterface):
         # augment meta-parameters with tunable ones
         current = dict(meta, **config.kwargs)
         full_nargs = {**self.nargs, **current}
+        kernels = []
 
         def kernel_call():
             if config.pre_hook:
                 config.pre_hook(full_nargs)
             self.pre_hook(args)
-            self.fn.run(
+            kernel = self.fn.run(
                 *args,
                 num_warps=config.num_warps,
                 num_stages=config.num_stages,
@@ -115,15 +165,108 @@ class Autotuner(KernelInterface):
                 enable_warp_specialization=config.enable_warp_specialization,
                 # TODO: Make it configurable
                 # enable_persistent=False,
+                **config.backend_options(),
                 **current,
             )
             self.post_hook(args)
+            kernels[:] = [kernel]
+            return kernel
 
         try:
-            return do_bench(kernel_call, warmup=self.num_warmups, rep=self.num_reps, quantiles=(0.5, 0.2, 0.8))
+            if self.max_spills is not None:
+                kernel = kernel_call()
+                n_spills = getattr(kernel, "n_spills", 0)
+                if n_spills > self.max_spills:
+                    raise OutOfResources(n_spills, self.max_spills, "spills")
+            # the shorter runs of the rounds of successive halving warm up
+            # for the same share of their time
+            warmup = self.num_warmups if rep is None else self.num_warmups * rep / self.num_reps
+            timings = do_bench(kernel_call, warmup=warmup, rep=rep or self.num_reps, quantiles=(0.5, 0.2, 0.8))
+            throughput = get_achieved_throughput(kernels[0], meta["grid"], full_nargs, timings[0]) if kernels else None
+            if throughput is not None:
+                self.configs_throughput[config] = throughput
+            if self.metrics_group is not None and rep is None:
+                self._collect_metrics(kernel_call, config)
+            return timings
         except OutOfResources:
             return [float("inf"), float("inf"), float("inf")]
 
+    def _bench_successive_halving(self, *args, configs, **kwargs):
+        # The rounds double the time of each config, up to `rep` for the last
+        # round of the two fastest configs. Returns the timings of the last
+        # round each config ran in.
+        num_rounds = builtins.max(1, math.ceil(math.log2(len(configs))))
+        rep = self.num_reps / 2**(num_rounds - 1)
+        timings = {}
+        while True:
+            last = len(configs) <= 2
+            for config in configs:
+                timings[config] = self._bench(*args, config=config, rep=None if last else rep, **kwargs)
+            if last:
+                return timings
+            # the median, 20th and 80th percentiles of each config
+            configs = sorted(configs, key=lambda config: timings[config][0])
+            best_p80 = timings[configs[0]][2]
+            configs = [config for config in configs[:(len(configs) + 1) // 2] if timings[config][1] <= best_p80]
+            rep *= 2
+
+    def _collect_metrics(self, kernel_call, config):
+        from .driver import driver
+        utils = driver.active.utils
+        if not hasattr(utils, "collect_metrics"):
+            return
+        kernels = []
+        metrics = utils.collect_metrics(lambda: kernels.append(kernel_call()), self.metrics_group)
+        self.configs_metrics[config] = metrics
+        kernels[0].add_metadata(metrics=metrics)
+
+    def _precompile(self, *args, configs, **kwargs):
+        # Compile all the configs ahead so that their benchmarks run back to
+        # back. The compilations overlap since the MLIR and LLVM pipelines
+        # release the GIL.
+        from concurrent.futures import ThreadPoolExecutor
+
+        def compile_config(config):
+            try:
+                return self.fn.run(
+                    *args,
+                    num_warps=config.num_warps,
+                    num_stages=config.num_stages,
+                    num_ctas=config.num_ctas,
+                    enable_warp_specialization=config.enable_warp_specialization,
+                    **config.backend_options(),
+                    **dict(kwargs, warmup=True),
+                    **config.kwargs,
+                )
+            except Exception:
+                # The error is reported again when benchmarking the config.
+                return None
+
+        with ThreadPoolExecutor(max_workers=builtins.min(len(configs), os.cpu_count() or 1)) as pool:
+            return dict(zip(configs, pool.map(compile_config, configs)))
+
+    def _prune_by_resources(self, kernels):
+        # The configs that failed to compile are kept, their error is reported
+        # when they are benchmarked.
+        pruned_configs = [
+            config for config, kernel in kernels.items()
+            if not hasattr(kernel, "metadata") or self.resource_prune(config, kernel.metadata)
+        ]
+        return pruned_configs or list(kernels)
+
+    def _cost_model_name(self):
+        fn = self._jit_fn()
+        return f"{fn.module}:{fn.__name__}"
+
+    def _prune_by_cost_model(self, key, configs, kernels):
+        # Returns the configs predicted to be the fastest, and whether they
+        # were predicted.
+        predictions = self.cost_model.predict(self._cost_model_name(), key, configs, kernels)
+        if predictions is None:
+            return configs, False
+        configs = sorted(configs, key=lambda config: predictions.get(config, float("inf")))
+        return configs[:builtins.max(1, self.cost_model.top_k)], True
+
     def run(self, *args, **kwargs):
         self.nargs = dict(zip(self.arg_names, args))
         if len(self.configs) > 1:
@@ -132,21 +275,48 @@ class Autotuner(KernelInterface):
             for name in self.arg_names:
                 if name in all_args:
                     _args.append(all_args[name])
-            key = [_args[i] for i in self.key_idx]
+            key = [_args[i] if b is None else b(_args[i]) for i, b in zip(self.key_idx, self.key_buckets)]
             for arg in _args:
                 if hasattr(arg, "dtype"):
                     key.append(str(arg.dtype))
             key = tuple(key)
+            if key not in self.cache and self.cache_results:
+                config = self._find_config(self._load_results().get(key))
+                if config is not None:
+                    self.cache[key] = config
             if key not in self.cache:
                 # prune configs
                 pruned_configs = self.prune_configs(kwargs)
+                kernels, predicted = {}, False
+                if len(pruned_configs) > 1:
+                    kernels = self._precompile(*args, configs=pruned_configs, **kwargs)
+                    if self.resource_prune:
+                        pruned_configs = self._prune_by_resources(kernels)
+                    if self.cost_model is not None and len(pruned_configs) > 1:
+                        pruned_configs, predicted = self._prune_by_cost_model(key, pruned_configs, kernels)
+                self.configs_metrics = {}
+                self.configs_throughput = {}
                 bench_start = time.time()
-                timings = {config: self._bench(*args, config=config, **kwargs) for config in pruned_configs}
+                benchmarked = not predicted or len(pruned_configs) > 1
+                if not benchmarked:
+                    # the config predicted the fastest isn't benchmarked
+                    timings = {pruned_configs[0]: [float("nan")] * 3}
+                elif self.successive_halving and len(pruned_configs) > 2:
+                    timings = self._bench_successive_halving(*args, configs=pruned_configs, **kwargs)
+                else:
+                    timings = {config: self._bench(*args, config=config, **kwargs) for config in pruned_configs}
                 bench_end = time.time()
                 self.bench_time = bench_end - bench_start
+                if self.cost_model is not None and kernels and benchmarked:
+                    medians = {config: timing[0] for config, timing in timings.items()}
+                    self.cost_model.observe(self._cost_model_name(), key, medians, kernels)
                 self.cache[key] = builtins.min(timings, key=timings.get)
                 self.pre_hook(args, reset_only=True)
                 self.configs_timings = timings
+                if replay.active_recorder is not None:
+                    replay.active_recorder.record_tuning(self._jit_fn(), key, self.cache[key], timings)
+                if self.cache_results:
+                    self._store_results({key: self.cache[key]})
             config = self.cache[key]
         else:
             config = self.configs[0]
@@ -160,12 +330,73 @@ class Autotuner(KernelInterface):
             num_stages=config.num_stages,
             num_ctas=config.num_ctas,
             enable_warp_specialization=config.enable_warp_specialization,
+            **config.backend_options(),
             **kwargs,
             **config.kwargs,
         )
         self.nargs = None
         return ret
 
+    _results_filename = "autotune.json"
+
+    def _jit_fn(self):
+        # the kernel under the heuristics and autotuners
+        from .jit import JITFunction
+        fn = self.fn
+        while not isinstance(fn, JITFunction):
+            fn = fn.fn
+        return fn
+
+    def _results_cache(self):
+        # The results are only valid for the same kernel and configs on the
+        # same device and driver.
+        from .cache import get_cache_manager
+        from .driver import driver
+        fn = self._jit_fn()
+        device = driver.active.get_current_device()
+        props = driver.active.utils.get_device_properties(device)
+        key = [fn.cache_key, str(driver.active.get_current_target()), str(props.get("driver_version"))]
+        key += [str(config) for config in self.configs]
+        return get_cache_manager(hashlib.sha256("-".join(key).encode("utf-8")).hexdigest())
+
+    def _load_results(self):
+        from .cache import read_cache_file
+        path = self._results_cache().get_file(self._results_filename)
+        if path is None:
+            return {}
+        results = json.loads(read_cache_file(path, binary=False))["results"]
+        return {tuple(key): config for key, config in results}
+
+    def _store_results(self, configs):
+        results = self._load_results()
+        results.update({key: str(config) for key, config in configs.items()})
+        try:
+            data = json.dumps({"results": [[list(key), config] for key, config in results.items()]})
+        except TypeError:
+            # Some of the tuning keys can't be serialized.
+            return
+        self._results_cache().put(data, self._results_filename, binary=False)
+
+    def _find_config(self, name):
+        # The configs are looked up by name since their hooks can't be stored.
+        return next((config for config in self.configs if str(config) == name), None)
+
+    def export_results(self, path):
+        """Writes the best configs found on the current device to `path`."""
+        results = self._load_results() if self.cache_results else {}
+        results.update({key: str(config) for key, config in self.cache.items()})
+        with open(path, "w") as f:
+            json.dump({"results": [[list(key), config] for key, config in results.items()]}, f)
+
+    def import_results(self, path):
+        """Reuses the best configs written by `export_results`."""
+        with open(path) as f:
+            results = {tuple(key): self._find_config(config) for key, config in json.load(f)["results"]}
+        results = {key: config for key, config in results.items() if config is not None}
+        self.cache.update(results)
+        if self.cache_results:
+            self._store_results(results)
+
     def prune_configs(self, kwargs):
         pruned_configs = self.configs
         if self.early_config_prune:
@@ -206,6 +437,7 @@ class Autotuner(KernelInterface):
                     enable_warp_specialization=config.enable_warp_specialization,
                     # TODO: Make it configurable
                     # enable_persistent=False,
+                    **config.backend_options(),
                     **kwargs,
                     **config.kwargs,
                 ))
@@ -229,11 +461,20 @@ class Config:
     :ivar num_ctas: number of blocks in a block cluster. SM90+ only.
     :type enable_warp_specialization: bool
     :ivar enable_warp_specialization: enable specialization (spatial partitioning) or not. See https://docs.nvidia.com/cuda/cuda-c-programming-guide/index.html#spatial-partitioning-also-known-as-warp-specialization
+    :type grf_mode: str
+    :ivar grf_mode: the register file size of the kernel on XPU, "default" or "large". Large GRF
+                    mode often removes the spills of the larger kernels, at the cost of occupancy.
+                    The backend default is used when not set.
+    :type spec_constants: dict[int, Any]
+    :ivar spec_constants: the values of the SPIR-V specialization constants of the kernel by id, of
+                          `tl.spec_constant`, on XPU. The configs which only differ by them share the
+                          compiled kernel.
     :ivar pre_hook: a function that will be called before the kernel is called. Parameters of this
                     function are args.
     """
 
-    def __init__(self, kwargs, num_warps=4, num_stages=2, num_ctas=1, enable_warp_specialization=False, pre_hook=None):
+    def __init__(self, kwargs, num_warps=4, num_stages=2, num_ctas=1, enable_warp_specialization=False, pre_hook=None,
+                 grf_mode=None, spec_constants=None):
         self.kwargs = kwargs
         self.num_warps = num_warps
         self.num_ctas = num_ctas
@@ -242,6 +483,17 @@ class Config:
         # TODO[shuhaoj]: May make enable_persistent configurable in future if necessary.
         self.enable_persistent = False
         self.pre_hook = pre_hook
+        self.grf_mode = grf_mode
+        self.spec_constants = spec_constants
+
+    def backend_options(self):
+        """The options of the config only some backends support, when set."""
+        options = {}
+        if self.grf_mode is not None:
+            options["grf_mode"] = self.grf_mode
+        if self.spec_constants:
+            options["spec_constants"] = self.spec_constants
+        return options
 
     def __str__(self):
         res = []
@@ -252,10 +504,15 @@ class Config:
         res.append(f"num_stages: {self.num_stages}")
         res.append(f"enable_warp_specialization: {self.enable_warp_specialization}")
         res.append(f"enable_persistent: {self.enable_persistent}")
+        if self.grf_mode is not None:
+            res.append(f"grf_mode: {self.grf_mode}")
+        if self.spec_constants:
+            res.append(f"spec_constants: {self.spec_constants}")
         return ", ".join(res)
 
 
-def autotune(configs, key, prune_configs_by=None, reset_to_zero=None, restore_value=None, warmup=25, rep=100):
+def autotune(configs, key, prune_configs_by=None, reset_to_zero=None, restore_value=None, warmup=25, rep=100,
+             cache_results=False, collect_metrics=None, successive_halving=False, bucket=None):
     """
     Decorator for auto-tuning a :code:`triton.jit`'d function.
 
@@ -284,6 +541,14 @@ def autotune(configs, key, prune_configs_by=None, reset_to_zero=None, restore_va
         'perf_model': performance model used to predicate running time with different configs, returns running time
         'top_k': number of configs to bench
         'early_config_prune'(optional): a function used to do early prune (eg, num_stages). It takes configs:List[Config] as its input, and returns pruned configs.
+        'max_spills'(optional): configs whose compiled kernel spills more than this are discarded.
+        'resource_prune'(optional): a function used to prune the configs from the resources of their compiled kernels,
+        before they are benchmarked. It takes a config and the metadata of its kernel, e.g. its `resource_estimate`
+        on the XPU, as its input, and returns whether the config is kept.
+        'cost_model'(optional): a learned cost model, e.g. a `triton.runtime.cost_model.LearnedCostModel`, which
+        predicts the time of the compiled configs from their TTGIR and the tuning key once trained on enough
+        benchmarks, so that only its `top_k` fastest configs are benchmarked, none when it is 1. A model stored at
+        a path is used by all the kernels with `TRITON_AUTOTUNE_COST_MODEL=<path>`.
     :param reset_to_zero: a list of argument names whose value will be reset to zero before evaluating any configs.
     :type reset_to_zero: list[str]
     :param restore_value: a list of argument names whose value will be restored after evaluating any configs.
@@ -292,10 +557,35 @@ def autotune(configs, key, prune_configs_by=None, reset_to_zero=None, restore_va
     :type warmup: int
     :param rep: Repetition time (in ms) to pass to benchmarking, defaults to 100.
     :type rep: int
+    :param cache_results: whether to store the best configs in the cache directory so that later processes reuse
+        them instead of benchmarking again, defaults to False. Storing them can also be enabled for all the
+        kernels with `TRITON_CACHE_AUTOTUNING=1`.
+    :type cache_results: bool
+    :param collect_metrics: the metric group whose hardware counters are sampled while each config runs, e.g.
+        "ComputeBasic" on XPU, defaults to None. They are then available as `configs_metrics`, next to the
+        `configs_timings`. The counters can also be collected for all the kernels with
+        `TRITON_AUTOTUNE_METRICS=<group>`.
+    :type collect_metrics: str
+    :param successive_halving: whether to benchmark the configs by rounds of successive halving rather than each of
+        them for `rep`, defaults to False: each round drops the slower half of the configs, and those whose 20th
+        percentile is above the 80th percentile of the fastest one, and doubles the time of the next round, the last
+        round of two configs running for `rep`. The tuning is then much shorter when there are many configs. It can
+        also be enabled for all the kernels with `TRITON_AUTOTUNE_HALVING=1`.
+    :type successive_halving: bool
+    :param bucket: maps the arguments of `key` to the buckets of their values, "pow2" for the next power of 2, an int
+        for the next multiple of it or a function of the value, e.g. :code:`bucket={'N': 'pow2'}`, so that the configs
+        are tuned once per bucket rather than for each value. The kernel must handle all the values of a bucket with
+        the config of the bucket, e.g. by masking with :code:`N`. The buckets of the :code:`triton.jit` function are
+        used for the other arguments.
+    :type bucket: dict
+
+    The achieved bandwidth and FLOPS of the configs are available as `configs_throughput` on the backends whose
+    compiler estimates the traffic of the kernels, e.g. the XPU.
     """
 
     def decorator(fn):
-        return Autotuner(fn, fn.arg_names, configs, key, reset_to_zero, restore_value, prune_configs_by, warmup, rep)
+        return Autotuner(fn, fn.arg_names, configs, key, reset_to_zero, restore_value, prune_configs_by, warmup, rep,
+                         cache_results, collect_metrics, successive_halving, bucket)
 
     return decorator
 
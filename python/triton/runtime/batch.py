@@ -0,0 +1,146 @@
+"""
+Launch of independent kernels with small grids as a single kernel, see
+`batch_launch`.
+
+The batched kernel runs the programs of each kernel on a contiguous range of
+its 1D grid:
+
+    def batched(k0_x, k0_BLOCK: tl.constexpr, k0_start, k0_end, k0_g0, ...):
+        pid = tl.program_id(0)
+        if (pid >= k0_start) & (pid < k0_end):
+            local = pid - k0_start
+            k0(k0_x, k0_BLOCK, local % k0_g0, ..., k0_g0, k0_g1, k0_g2)
+        ...
+
+where `k0` is the first kernel as a function of the program ids and the grid
+it was launched with, its `tl.program_id` and `tl.num_programs` being
+replaced by these arguments. The ranges and the grids are arguments too, so
+that a batch of the same kernels is compiled once whatever their grids.
+"""
+
+import ast
+import itertools
+import linecache
+import threading
+
+from .jit import JITFunction, jit
+
+# the generated functions get their own file names, under which `inspect`
+# finds their source
+_counter = itertools.count()
+_lock = threading.Lock()
+# kernels as functions of their program ids, by kernel and source
+_programs = {}
+# batched kernels, by the kernels they run and their sources
+_batches = {}
+
+_PROGRAM_ARGS = ["_batch_pid0", "_batch_pid1", "_batch_pid2", "_batch_nprog0", "_batch_nprog1", "_batch_nprog2"]
+
+
+class _ProgramIdRewriter(ast.NodeTransformer):
+    """Replace `tl.program_id(axis)` and `tl.num_programs(axis)` by arguments."""
+
+    def visit_Call(self, node):
+        self.generic_visit(node)
+        func = node.func
+        name = func.attr if isinstance(func, ast.Attribute) else getattr(func, "id", None)
+        if name not in ("program_id", "num_programs"):
+            return node
+        axis = node.args[0] if node.args else next((kw.value for kw in node.keywords if kw.arg == "axis"), None)
+        if not isinstance(axis, ast.Constant) or axis.value not in (0, 1, 2):
+            raise ValueError(f"batched kernels need a constant axis for tl.{name}, at line {node.lineno}")
+        prefix = "_batch_pid" if name == "program_id" else "_batch_nprog"
+        return ast.copy_location(ast.Name(id=f"{prefix}{axis.value}", ctx=ast.Load()), node)
+
+
+def _make_function(src, name, globals):
+    """The function `name` defined by `src`, with its source known to `inspect`."""
+    filename = f"<triton batch {next(_counter)}>"
+    linecache.cache[filename] = (len(src), None, src.splitlines(keepends=True), filename)
+    scope = dict(globals)
+    exec(compile(src, filename, "exec"), scope)
+    return scope[name]
+
+
+def _as_program(kernel):
+    key = (kernel, kernel.src)
+    with _lock:
+        program = _programs.get(key)
+        if program is None:
+            tree = ast.parse(kernel.src)
+            tree = _ProgramIdRewriter().visit(tree)
+            func = tree.body[0]
+            func.decorator_list = []
+            func.args.args += [ast.arg(arg=name) for name in _PROGRAM_ARGS]
+            ast.fix_missing_locations(tree)
+            fn = _make_function(ast.unparse(tree), func.name, kernel.__globals__)
+            program = _programs[key] = jit(fn, debug=kernel.debug, noinline=kernel.noinline)
+    return program
+
+
+def _make_batch(kernels):
+    from .. import language as tl
+    params, body, scope = [], ["    pid = tl.program_id(0)"], {"tl": tl}
+    for i, kernel in enumerate(kernels):
+        scope[f"k{i}"] = _as_program(kernel)
+        args = []
+        for param in kernel.params:
+            args.append(f"k{i}_{param.name}")
+            params.append(args[-1] + (": tl.constexpr" if param.is_constexpr else ""))
+        params += [f"k{i}_start", f"k{i}_end", f"k{i}_g0", f"k{i}_g1", f"k{i}_g2"]
+        program_ids = [f"local % k{i}_g0", f"local // k{i}_g0 % k{i}_g1", f"local // (k{i}_g0 * k{i}_g1)"]
+        args += program_ids + [f"k{i}_g0", f"k{i}_g1", f"k{i}_g2"]
+        body += [
+            f"    if (pid >= k{i}_start) & (pid < k{i}_end):",
+            f"        local = pid - k{i}_start",
+            f"        k{i}({', '.join(args)})",
+        ]
+    src = f"def batched_kernel({', '.join(params)}):\n" + "\n".join(body) + "\n"
+    return jit(_make_function(src, "batched_kernel", scope))
+
+
+def batch_launch(launches, **options):
+    """
+    Launch the independent `launches` as a single kernel, e.g. the many
+    kernels of a few programs each that a step of a model runs, whose launches
+    take longer than the kernels.
+
+    The batched kernel of the same kernels, in the same order, is compiled
+    once, and cached like the kernels themselves by the types and the
+    constexprs of its arguments, the arguments of the kernels. Only the
+    `tl.program_id` and `tl.num_programs` of the kernels themselves refer to
+    their own grids, not those of the functions they call.
+
+    :param launches: (kernel, grid, args) or (kernel, grid, args, kwargs)
+                     tuples, `kernel` being a `JITFunction` and `grid` its
+                     grid, or a function of its arguments returning it
+    :param options: the launch options of the batched kernel, e.g. num_warps
+    :return: the `CompiledKernel` of the batched kernel, None if the grids
+             have no programs
+    """
+    launches = [tuple(launch) + ({}, ) * (4 - len(launch)) for launch in launches]
+    kernels = tuple(launch[0] for launch in launches)
+    for kernel in kernels:
+        if not isinstance(kernel, JITFunction):
+            raise TypeError(f"only JIT functions can be batched, not {kernel!r}")
+    key = tuple((kernel, kernel.src) for kernel in kernels)
+    with _lock:
+        batch = _batches.get(key)
+    if batch is None:
+        batch = _make_batch(kernels)
+        with _lock:
+            batch = _batches.setdefault(key, batch)
+
+    args, start = [], 0
+    for kernel, grid, kernel_args, kernel_kwargs in launches:
+        bound = kernel.signature.bind(*kernel_args, **kernel_kwargs)
+        bound.apply_defaults()
+        if callable(grid):
+            grid = grid(dict(bound.arguments))
+        grid = tuple(grid) + (1, ) * (3 - len(grid))
+        end = start + grid[0] * grid[1] * grid[2]
+        args += list(bound.arguments.values()) + [start, end, *grid]
+        start = end
+    if start == 0:
+        return None
+    return batch[(start, )](*args, **options)
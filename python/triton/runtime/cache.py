@@ -1,6 +1,12 @@
 import json
+import mmap
 import os
 import random
+import re
+import shutil
+import struct
+import time
+import warnings
 from abc import ABC, abstractmethod
 from pathlib import Path
 from typing import Dict, Optional
@@ -19,6 +25,80 @@ def default_dump_dir():
     return os.path.join(Path.home(), ".triton", "dump")
 
 
+def _parse_size(value: str) -> int:
+    # a number of bytes, e.g. "500M" or "20G"
+    units = {"K": 1 << 10, "M": 1 << 20, "G": 1 << 30, "T": 1 << 40}
+    value = value.strip().upper().removesuffix("B")
+    if value and value[-1] in units:
+        return int(float(value[:-1]) * units[value[-1]])
+    return int(value)
+
+
+# The seconds between two evictions of the cache, by any of the processes.
+_EVICTION_INTERVAL = 60
+
+
+def evict_cache(cache_dir, max_size: int, grace: float = 600) -> int:
+    """
+    Removes the least recently used keys of the cache in `cache_dir` once its
+    files take more than `max_size` bytes, until they take at most 90% of it,
+    and returns the bytes removed. The last use of a key is the latest
+    modification of its directory and of its groups, which the hits of
+    `get_group` touch. The keys used in the last `grace` seconds are kept, as
+    other processes may be reading them. Only one process evicts at once, the
+    others skip the eviction.
+    """
+    import fcntl
+    lock_path = os.path.join(cache_dir, ".eviction.lock")
+    with open(lock_path, "a") as lock:
+        try:
+            fcntl.flock(lock, fcntl.LOCK_EX | fcntl.LOCK_NB)
+        except OSError:
+            return 0
+        # the time of the last eviction, see `FileCacheManager._maybe_evict`
+        os.utime(lock_path)
+        keys = []
+        total = 0
+        with os.scandir(cache_dir) as entries:
+            for entry in entries:
+                if not entry.is_dir(follow_symlinks=False):
+                    continue
+                if ".evicted." in entry.name:
+                    # left by an interrupted eviction
+                    shutil.rmtree(entry.path, ignore_errors=True)
+                    continue
+                try:
+                    size, last_use = 0, entry.stat().st_mtime
+                    with os.scandir(entry.path) as files:
+                        for file in files:
+                            stat = file.stat(follow_symlinks=False)
+                            size += stat.st_size
+                            if file.name.startswith("__grp__"):
+                                last_use = max(last_use, stat.st_mtime)
+                except FileNotFoundError:
+                    continue
+                keys.append((last_use, size, entry.path))
+                total += size
+        if total <= max_size:
+            return 0
+        target = max_size * 9 // 10
+        now = time.time()
+        removed = 0
+        for last_use, size, path in sorted(keys):
+            if total - removed <= target or now - last_use < grace:
+                break
+            # renamed first, so that the other processes see all the files of
+            # the key or none of them
+            evicted = f"{path}.evicted.pid_{os.getpid()}"
+            try:
+                os.rename(path, evicted)
+            except OSError:
+                continue
+            shutil.rmtree(evicted, ignore_errors=True)
+            removed += size
+    return removed
+
+
 class CacheManager(ABC):
 
     def __init__(self, key):
@@ -50,6 +130,9 @@ class FileCacheManager(CacheManager):
     def __init__(self, key, override=False, dump=False):
         self.key = key
         self.lock_path = None
+        # Only the cache of the compiled kernels is bounded by
+        # `TRITON_CACHE_MAX_SIZE`, see `evict_cache`.
+        self.evictable = not override and not dump
         if dump:
             self.cache_dir = default_dump_dir()
             self.cache_dir = os.path.join(self.cache_dir, self.key)
@@ -97,21 +180,51 @@ class FileCacheManager(CacheManager):
         for c, p in child_paths.items():
             if os.path.exists(p):
                 result[c] = p
+        if self.evictable:
+            self._touch(grp_filepath, result.values())
         return result
 
+    def _touch(self, grp_filepath, child_paths):
+        # The hit is the last use of the key, and of the keys of the files of
+        # the group stored by content, for the eviction.
+        try:
+            os.utime(grp_filepath)
+            for dirname in {os.path.dirname(p) for p in child_paths} - {self.cache_dir}:
+                os.utime(dirname)
+        except OSError:
+            pass
+
+    def _maybe_evict(self):
+        max_size = os.getenv("TRITON_CACHE_MAX_SIZE", "").strip()
+        if not max_size or not self.evictable:
+            return
+        cache_root = os.path.dirname(self.cache_dir)
+        try:
+            if time.time() - os.path.getmtime(os.path.join(cache_root, ".eviction.lock")) < _EVICTION_INTERVAL:
+                return
+        except FileNotFoundError:
+            pass
+        evict_cache(cache_root, _parse_size(max_size))
+
     # Note a group of pushed files as being part of a group
     def put_group(self, filename: str, group: Dict[str, str]) -> str:
         if not self.cache_dir:
             raise RuntimeError("Could not create or locate cache dir")
         grp_contents = json.dumps({"child_paths": group})
         grp_filename = f"__grp__{filename}"
-        return self.put(grp_contents, grp_filename, binary=False)
+        grp_filepath = self.put(grp_contents, grp_filename, binary=False)
+        # once per compilation, after its files are all stored
+        self._maybe_evict()
+        return grp_filepath
 
     def put(self, data, filename, binary=True) -> str:
         if not self.cache_dir:
             raise RuntimeError("Could not create or locate cache dir")
         binary = isinstance(data, bytes)
-        if not binary:
+        # MLIR modules are printed straight to their file, the IR of large
+        # kernels taking hundreds of MB as a string
+        streamed = not binary and hasattr(data, "write")
+        if not binary and not streamed:
             data = str(data)
         assert self.lock_path is not None
         filepath = self._make_path(filename)
@@ -121,15 +234,373 @@ class FileCacheManager(CacheManager):
         pid = os.getpid()
         # use tempfile to be robust against program interruptions
         temp_path = f"{filepath}.tmp.pid_{pid}_{rnd_id}"
-        mode = "wb" if binary else "w"
-        with open(temp_path, mode) as f:
-            f.write(data)
+        if streamed:
+            data.write(temp_path)
+        else:
+            mode = "wb" if binary else "w"
+            with open(temp_path, mode) as f:
+                f.write(data)
         # Replace is guaranteed to be atomic on POSIX systems if it succeeds
         # so filepath cannot see a partial write
         os.replace(temp_path, filepath)
         return filepath
 
 
+class _Pack:
+    """
+    The files of the packed cache of a directory: an append-only data file,
+    and an append-only index of fixed-size entries mapping the hash of the key
+    and name of each file to its offset and length in the data file. The
+    later entries of a file replace the earlier ones. Both files are mapped in
+    memory, the index is decoded as it grows so that the lookups are reads of
+    a dict, and the files are read from the mapping of the data.
+    """
+
+    _entry = struct.Struct("<16sQQ")
+
+    def __init__(self, dirname):
+        os.makedirs(dirname, exist_ok=True)
+        self.data_path = os.path.join(dirname, "pack.data")
+        self.index_path = os.path.join(dirname, "pack.index")
+        self.lock_path = os.path.join(dirname, "pack.lock")
+        self.entries = {}
+        # the bytes of the index decoded into `entries`
+        self._index_size = 0
+        self._data = None
+
+    @staticmethod
+    def digest(key, filename) -> bytes:
+        return hashlib.md5(f"{key}/{filename}".encode("utf-8")).digest()
+
+    def _read_index(self):
+        # The entries put by the other processes since the last read; an entry
+        # cut short by an interrupted write is ignored.
+        try:
+            size = os.path.getsize(self.index_path)
+        except FileNotFoundError:
+            return
+        size -= size % self._entry.size
+        if size <= self._index_size:
+            return
+        with open(self.index_path, "rb") as f, mmap.mmap(f.fileno(), size, access=mmap.ACCESS_READ) as index:
+            for pos in range(self._index_size, size, self._entry.size):
+                digest, offset, length = self._entry.unpack_from(index, pos)
+                self.entries[digest] = (offset, length)
+        self._index_size = size
+
+    def lookup(self, digest):
+        entry = self.entries.get(digest)
+        if entry is None:
+            self._read_index()
+            entry = self.entries.get(digest)
+        return entry
+
+    def read(self, offset, length) -> bytes:
+        end = offset + length
+        if self._data is None or end > len(self._data):
+            # mapped again once the data has grown past the mapping
+            with open(self.data_path, "rb") as f:
+                if os.fstat(f.fileno()).st_size < end:
+                    raise FileNotFoundError(f"{self.data_path} has no file at {offset}:{length}")
+                self._data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        return self._data[offset:end]
+
+    def append(self, digest, data: bytes):
+        import fcntl
+        with open(self.lock_path, "a") as lock:
+            fcntl.flock(lock, fcntl.LOCK_EX)
+            self._read_index()
+            entry = self.entries.get(digest)
+            if entry is not None and entry[1] == len(data) and self.read(*entry) == data:
+                return entry
+            # The data is written before its entry, so that the entries read
+            # by the other processes refer to complete files.
+            with open(self.data_path, "ab") as f:
+                offset = f.seek(0, os.SEEK_END)
+                f.write(data)
+            with open(self.index_path, "ab") as f:
+                size = f.seek(0, os.SEEK_END)
+                if size % self._entry.size:
+                    f.truncate(size - size % self._entry.size)
+                f.write(self._entry.pack(digest, offset, len(data)))
+        self.entries[digest] = (offset, len(data))
+        return self.entries[digest]
+
+    def path(self, entry, filename) -> str:
+        offset, length = entry
+        return f"{self.data_path}::{offset}:{length}/{filename}"
+
+
+# The packs by directory, shared by the cache managers of all the keys.
+_packs: Dict[str, _Pack] = {}
+
+# The paths of the files of a pack, "<data file>::<offset>:<length>/<name>".
+_PACKED_PATH = re.compile(r"^(.*)::(\d+):(\d+)/([^/]*)$")
+
+
+def _get_pack(dirname) -> _Pack:
+    dirname = os.path.abspath(dirname)
+    if dirname not in _packs:
+        _packs[dirname] = _Pack(dirname)
+    return _packs[dirname]
+
+
+def read_cache_file(path, binary=True):
+    """Reads a file returned by a cache manager, stored on its own or in a pack."""
+    match = _PACKED_PATH.match(str(path))
+    if match is None:
+        return Path(path).read_bytes() if binary else Path(path).read_text()
+    data = _get_pack(os.path.dirname(match[1])).read(int(match[2]), int(match[3]))
+    return data if binary else data.decode("utf-8")
+
+
+def cache_file_exists(path) -> bool:
+    match = _PACKED_PATH.match(str(path))
+    if match is None:
+        return os.path.exists(path)
+    try:
+        return os.path.getsize(match[1]) >= int(match[2]) + int(match[3])
+    except OSError:
+        return False
+
+
+class PackedCacheManager(CacheManager):
+    """
+    Stores the files of all the keys in the pack of the cache directory, see
+    `_Pack`, instead of a directory per key, for the file systems where the
+    metadata operations are slow, e.g. NFS or Lustre home directories. Selected
+    with `TRITON_CACHE_MANAGER=triton.runtime.cache:PackedCacheManager`.
+
+    The files are referred to by paths into the pack, read with
+    `read_cache_file`. The shared libraries, which are loaded from their path,
+    and the overridden and dumped files are stored on their own by a
+    `FileCacheManager`. The pack is append-only, it isn't bounded by
+    `TRITON_CACHE_MAX_SIZE`.
+    """
+
+    def __init__(self, key, override=False, dump=False):
+        self.key = key
+        self._override = override
+        self._dump = dump
+        self._files = None
+        self._pack = None
+        if not override and not dump:
+            cache_dir = os.getenv("TRITON_CACHE_DIR", "").strip() or default_cache_dir()
+            self._pack = _get_pack(cache_dir)
+
+    def _file_manager(self) -> FileCacheManager:
+        # created on demand, as it creates the directory of the key
+        if self._files is None:
+            self._files = FileCacheManager(self.key, override=self._override, dump=self._dump)
+        return self._files
+
+    def _is_file(self, filename) -> bool:
+        return self._pack is None or filename.endswith(".so")
+
+    def has_file(self, filename) -> bool:
+        if self._is_file(filename):
+            return self._file_manager().has_file(filename)
+        return self._pack.lookup(_Pack.digest(self.key, filename)) is not None
+
+    def get_file(self, filename) -> Optional[str]:
+        if self._is_file(filename):
+            return self._file_manager().get_file(filename)
+        entry = self._pack.lookup(_Pack.digest(self.key, filename))
+        return None if entry is None else self._pack.path(entry, filename)
+
+    def get_group(self, filename: str) -> Optional[Dict[str, str]]:
+        if self._pack is None:
+            return self._file_manager().get_group(filename)
+        grp_path = self.get_file(f"__grp__{filename}")
+        if grp_path is None:
+            return None
+        child_paths = json.loads(read_cache_file(grp_path, binary=False)).get("child_paths", None)
+        # Invalid group data.
+        if child_paths is None:
+            return None
+        # The files of the pack outlive the group, only the others are checked.
+        return {c: p for c, p in child_paths.items() if _PACKED_PATH.match(p) or os.path.exists(p)}
+
+    def put_group(self, filename: str, group: Dict[str, str]) -> str:
+        return self.put(json.dumps({"child_paths": group}), f"__grp__{filename}", binary=False)
+
+    def put(self, data, filename, binary=True) -> str:
+        if self._is_file(filename):
+            return self._file_manager().put(data, filename, binary)
+        if not isinstance(data, bytes) and hasattr(data, "write"):
+            # the MLIR modules are printed to a file, read back
+            temp_path = f"{self._pack.data_path}.tmp.pid_{os.getpid()}_{random.randint(0, 1000000)}"
+            data.write(temp_path)
+            try:
+                data = Path(temp_path).read_bytes()
+            finally:
+                os.remove(temp_path)
+        elif not isinstance(data, bytes):
+            data = str(data).encode("utf-8")
+        entry = self._pack.append(_Pack.digest(self.key, filename), data)
+        return self._pack.path(entry, filename)
+
+
+class RemoteCacheBackend(ABC):
+    """A store of cache artifacts shared by several hosts."""
+
+    @abstractmethod
+    def get(self, key: str) -> Dict[str, bytes]:
+        """Returns all the files stored for `key`, by name."""
+        pass
+
+    @abstractmethod
+    def put(self, key: str, filename: str, data: bytes):
+        pass
+
+
+class RedisCacheBackend(RemoteCacheBackend):
+    """Stores the files of each key in a Redis hash, so that they are all
+    fetched in a single request."""
+
+    def __init__(self):
+        import redis
+        host = os.environ.get("TRITON_REDIS_HOST", "localhost")
+        port = int(os.environ.get("TRITON_REDIS_PORT", "6379"))
+        self._redis = redis.Redis(host=host, port=port)
+
+    def get(self, key: str) -> Dict[str, bytes]:
+        return {name.decode(): data for name, data in self._redis.hgetall(f"triton:{key}").items()}
+
+    def put(self, key: str, filename: str, data: bytes):
+        self._redis.hset(f"triton:{key}", filename, data)
+
+
+class SharedDirCacheBackend(RemoteCacheBackend):
+    """Stores the files in a directory shared by the hosts, e.g. on NFS."""
+
+    def __init__(self):
+        self._dir = os.environ.get("TRITON_REMOTE_CACHE_DIR", "").strip()
+        if not self._dir:
+            raise RuntimeError("TRITON_REMOTE_CACHE_DIR is not set")
+
+    def get(self, key: str) -> Dict[str, bytes]:
+        key_dir = Path(self._dir) / key
+        if not key_dir.is_dir():
+            return {}
+        return {p.name: p.read_bytes() for p in key_dir.iterdir() if ".tmp.pid_" not in p.name}
+
+    def put(self, key: str, filename: str, data: bytes):
+        key_dir = os.path.join(self._dir, key)
+        os.makedirs(key_dir, exist_ok=True)
+        filepath = os.path.join(key_dir, filename)
+        temp_path = f"{filepath}.tmp.pid_{os.getpid()}_{random.randint(0, 1000000)}"
+        with open(temp_path, "wb") as f:
+            f.write(data)
+        os.replace(temp_path, filepath)
+
+
+def get_remote_cache_backend() -> RemoteCacheBackend:
+    import importlib
+
+    backend = os.environ.get("TRITON_REMOTE_CACHE_BACKEND", "triton.runtime.cache:RedisCacheBackend")
+    module_path, clz_nme = backend.split(":")
+    module = importlib.import_module(module_path)
+    return getattr(module, clz_nme)()
+
+
+class RemoteCacheManager(CacheManager):
+    """
+    Reads through the local cache to the remote store selected with
+    `TRITON_REMOTE_CACHE_BACKEND`, and writes the files to both.
+
+    On the first miss, all the files of the key, including those put outside
+    of the groups such as the native device binaries, are pulled at once.
+    Failures of the remote store are reported as warnings and fall back to the
+    local cache.
+    """
+
+    def __init__(self, key, override=False, dump=False):
+        self.key = key
+        self._local = FileCacheManager(key, override=override, dump=dump)
+        self._remote = None
+        self._pulled = False
+        # Overridden and dumped files are local by nature.
+        if not override and not dump:
+            try:
+                self._remote = get_remote_cache_backend()
+            except Exception as e:
+                warnings.warn(f"Remote cache unavailable: {e}")
+
+    def _pull(self):
+        if self._remote is None or self._pulled:
+            return
+        self._pulled = True
+        try:
+            files = self._remote.get(self.key)
+        except Exception as e:
+            warnings.warn(f"Could not read the remote cache: {e}")
+            return
+        groups = {}
+        for filename, data in files.items():
+            if filename.startswith("__grp__"):
+                groups[filename] = json.loads(data)
+            elif not self._local.has_file(filename):
+                self._local.put(data, filename)
+        # The groups are written last so that their files are all present once
+        # they are visible, and refer to the local copies of these files.
+        for filename, grp_data in groups.items():
+            if self._local.has_file(filename):
+                continue
+            child_paths = {c: self._local._make_path(name) for c, name in grp_data.get("child_paths", {}).items()}
+            self._local.put(json.dumps({"child_paths": child_paths}), filename, binary=False)
+
+    def _push(self, data, filename):
+        if self._remote is None:
+            return
+        if not isinstance(data, bytes):
+            data = str(data).encode("utf-8")
+        try:
+            self._remote.put(self.key, filename, data)
+        except Exception as e:
+            warnings.warn(f"Could not write to the remote cache: {e}")
+
+    def has_file(self, filename) -> bool:
+        if not self._local.has_file(filename):
+            self._pull()
+        return self._local.has_file(filename)
+
+    def get_file(self, filename) -> Optional[str]:
+        if not self._local.has_file(filename):
+            self._pull()
+        return self._local.get_file(filename)
+
+    def get_group(self, filename: str) -> Optional[Dict[str, str]]:
+        group = self._local.get_group(filename)
+        if group is None:
+            self._pull()
+            group = self._local.get_group(filename)
+        return group
+
+    def put_group(self, filename: str, group: Dict[str, str]) -> str:
+        filepath = self._local.put_group(filename, group)
+        # The files of the group have already been pushed, so publishing the
+        # group makes it complete at once. The remote group refers to the
+        # files by name since their paths are local.
+        child_names = {}
+        for c, p in group.items():
+            child_names[c] = os.path.basename(p)
+            # The files shared with other keys, e.g. the binaries stored by
+            # content, are stored under each key remotely.
+            if os.path.dirname(os.path.abspath(p)) != os.path.abspath(self._local.cache_dir):
+                self._push(Path(p).read_bytes(), child_names[c])
+        self._push(json.dumps({"child_paths": child_names}), f"__grp__{filename}")
+        return filepath
+
+    def put(self, data, filename, binary=True) -> str:
+        filepath = self._local.put(data, filename, binary)
+        if not isinstance(data, (bytes, str)) and hasattr(data, "write"):
+            # the remote stores need the bytes, read back from the local copy
+            data = Path(filepath).read_bytes()
+        self._push(data, filename)
+        return filepath
+
+
 __cache_cls = FileCacheManager
 __cache_cls_nme = "DEFAULT"
 
@@ -137,16 +608,19 @@ __cache_cls_nme = "DEFAULT"
 def get_cache_manager(key) -> CacheManager:
     import os
 
-    user_cache_manager = os.environ.get("TRITON_CACHE_MANAGER", None)
+    user_cache_manager = os.environ.get("TRITON_CACHE_MANAGER", "DEFAULT")
     global __cache_cls
     global __cache_cls_nme
 
-    if user_cache_manager is not None and user_cache_manager != __cache_cls_nme:
-        import importlib
+    if user_cache_manager != __cache_cls_nme:
+        if user_cache_manager == "DEFAULT":
+            __cache_cls = FileCacheManager
+        else:
+            import importlib
 
-        module_path, clz_nme = user_cache_manager.split(":")
-        module = importlib.import_module(module_path)
-        __cache_cls = getattr(module, clz_nme)
+            module_path, clz_nme = user_cache_manager.split(":")
+            module = importlib.import_module(module_path)
+            __cache_cls = getattr(module, clz_nme)
         __cache_cls_nme = user_cache_manager
 
     return __cache_cls(key)
@@ -168,3 +642,10 @@ def make_so_cache_key(version_hash, signature, constants, ids, **kwargs):
         key = f"{key}-{kwargs.get(kw)}"
     key = hashlib.md5(key.encode("utf-8")).hexdigest()
     return key
+
+
+def make_binary_cache_key(binary: bytes) -> str:
+    # The binaries are stored by content, once for all the kernels compiled to
+    # the same binary, e.g. the specializations on constexprs that don't
+    # change the code.
+    return "bin-" + hashlib.md5(binary).hexdigest()
@@ -0,0 +1,135 @@
+"""
+Learned cost models, which predict the time of the configs of an autotuned
+kernel so that the autotuner only benchmarks the most promising ones, or none
+at all, on the shapes it hasn't tuned yet.
+
+A cost model is given to `triton.autotune` with
+`prune_configs_by={'cost_model': model}`, or to all the autotuners with
+`TRITON_AUTOTUNE_COST_MODEL=<path>` for a `LearnedCostModel` stored at the
+path. It implements:
+
+    predict(name, key, configs, kernels) -> {config: ms}, or None
+    observe(name, key, timings, kernels)
+
+where `name` names the kernel, `key` is its tuning key, `kernels` the compiled
+kernel of each config and `timings` the median time in ms of each benchmarked
+config. The autotuner benchmarks the `top_k` configs of the predictions, and
+keeps the best one without benchmarking it when `top_k` is 1.
+"""
+
+import json
+import math
+import os
+
+# the ops of the TTGIR of the kernels counted as their features
+_TTGIR_OPS = ("tt.dot", "tt.load", "tt.store", "tt.reduce", "tt.atomic_rmw", "scf.for", "triton_gpu.convert_layout",
+              "triton_gpu.local_load", "triton_gpu.local_store", "math.")
+
+
+def _log(value):
+    return math.log2(1 + abs(value))
+
+
+def kernel_features(kernel):
+    """Returns the features of a compiled kernel: the number of its TTGIR ops of each kind, and its shared memory."""
+    ttgir = kernel.asm["ttgir"] if "ttgir" in kernel.asm else ""
+    return [_log(ttgir.count(op)) for op in _TTGIR_OPS] + [_log(getattr(kernel.metadata, "shared", 0))]
+
+
+def config_features(key, config, kernel):
+    """
+    Returns the features of `config` on the tuning `key`, from the numeric values of the key and of the config and
+    from its compiled kernel, along with their products.
+    """
+    values = [value for value in key if isinstance(value, (int, float)) and not isinstance(value, bool)]
+    values += [value for _, value in sorted(config.kwargs.items()) if isinstance(value, (int, float))]
+    values += [config.num_warps, config.num_stages]
+    x = [_log(value) for value in values] + kernel_features(kernel)
+    return [1.0] + x + [x[i] * x[j] for i in range(len(x)) for j in range(i, len(x))]
+
+
+class LearnedCostModel:
+    """
+    A ridge regression of the log of the times of the configs of each kernel on their features, trained on the
+    benchmarks of the autotuner and stored at `path` if given.
+
+    :param top_k: the number of configs the autotuner benchmarks on the shapes the model predicts.
+    :param min_samples: the number of benchmarked configs of a kernel from which its times are predicted.
+    :param l2: the weight of the regularization.
+    :param max_samples: the number of benchmarked configs kept per kernel, the oldest ones are dropped.
+    """
+
+    def __init__(self, path=None, top_k=1, min_samples=64, l2=1e-2, max_samples=4096):
+        self.path = path
+        self.top_k = top_k
+        self.min_samples = min_samples
+        self.l2 = l2
+        self.max_samples = max_samples
+        # the [features, ms] of the benchmarked configs of each kernel
+        self.samples = {}
+        # the fitted (mean, scale, weights) of each kernel
+        self.fits = {}
+        if path is not None and os.path.exists(path):
+            with open(path) as f:
+                self.samples = json.load(f)["kernels"]
+
+    def observe(self, name, key, timings, kernels):
+        samples = self.samples.setdefault(name, [])
+        for config, ms in timings.items():
+            kernel = kernels.get(config)
+            if kernel is None or not math.isfinite(ms) or ms <= 0:
+                continue
+            samples.append([config_features(key, config, kernel), ms])
+        del samples[:-self.max_samples]
+        self.fits.pop(name, None)
+        if self.path is not None:
+            self.save(self.path)
+
+    def _fit(self, name, num_features):
+        import numpy as np
+        if name in self.fits and self.fits[name][2].shape[0] == num_features:
+            return self.fits[name]
+        # the samples of other features, e.g. from older configs, are left out
+        samples = [(x, ms) for x, ms in self.samples.get(name, []) if len(x) == num_features]
+        if len(samples) < self.min_samples:
+            return None
+        x = np.array([x for x, _ in samples])
+        y = np.log(np.array([ms for _, ms in samples]))
+        mean, scale = x.mean(axis=0), x.std(axis=0)
+        mean[0], scale[0] = 0.0, 1.0
+        scale[scale == 0] = 1.0
+        x = (x - mean) / scale
+        weights = np.linalg.solve(x.T @ x + self.l2 * len(samples) * np.eye(num_features), x.T @ y)
+        self.fits[name] = (mean, scale, weights)
+        return self.fits[name]
+
+    def predict(self, name, key, configs, kernels):
+        import numpy as np
+        features = {config: config_features(key, config, kernels[config]) for config in configs if kernels.get(config)}
+        if not features:
+            return None
+        fit = self._fit(name, len(next(iter(features.values()))))
+        if fit is None:
+            return None
+        mean, scale, weights = fit
+        return {
+            config: float(np.exp(((np.array(x) - mean) / scale) @ weights)) if len(x) == len(weights) else math.inf
+            for config, x in features.items()
+        }
+
+    def save(self, path):
+        temp_path = f"{path}.tmp.pid_{os.getpid()}"
+        with open(temp_path, "w") as f:
+            json.dump({"kernels": self.samples}, f)
+        os.replace(temp_path, path)
+
+
+# the models of `TRITON_AUTOTUNE_COST_MODEL` by path
+_models = {}
+
+
+def get_cost_model(path):
+    """Returns the `LearnedCostModel` stored at `path`, shared by the autotuners."""
+    if path not in _models:
+        _models[path] = LearnedCostModel(path)
+    return _models[path]
@@ -1,4 +1,8 @@
 import inspect
+import itertools
+import os
+import threading
+from concurrent.futures import ThreadPoolExecutor
 
 import numpy as np
 
@@ -90,13 +94,19 @@ class Builder:
 
     def __init__(self) -> None:
         self.arch = None
-        # pass
+        # the program ids are per thread, the programs of a grid may run
+        # concurrently, see `GridExecutor`
+        self._local = threading.local()
+
+    @property
+    def grid_idx(self):
+        return getattr(self._local, "grid_idx", None)
 
     def set_grid_idx(self, x, y, z):
         assert x < self.grid_dim[0]
         assert y < self.grid_dim[1]
         assert z < self.grid_dim[2]
-        self.grid_idx = (x, y, z)
+        self._local.grid_idx = (x, y, z)
 
     def set_grid_dim(self, nx, ny, nz):
         self.grid_dim = (nx, ny, nz)
@@ -196,6 +206,15 @@ class Builder:
     def create_fp_to_fp(self, src, dst_type):
         assert "float8 not NotImplemented yet"
 
+    def create_unpack_int4(self, src, dst_type, is_signed):
+        packed = src.data.view(np.int8 if is_signed else np.uint8)
+        four = packed.dtype.type(4)
+        lo = (packed << four) >> four if is_signed else packed & packed.dtype.type(0xf)
+        hi = packed >> four
+        # the low nibble of the byte (k, n) is the row 2 * k, the high one the row 2 * k + 1
+        unpacked = np.stack([lo, hi], axis=1).reshape(2 * packed.shape[0], *packed.shape[1:])
+        return self.cast_impl(TensorHandle(unpacked, src.dtype), dst_type)
+
     def create_bitcast(self, src, dst_type):
         return TensorHandle(src.data.view(self.np_dtype(dst_type)), dst_type)
 
@@ -279,6 +298,25 @@ class Builder:
     def create_make_range(self, start, stop):
         return TensorHandle(np.arange(start, stop, dtype=np.int32), tl.int32)
 
+    def create_philox(self, seed, offset, n_rounds):
+        offset_data = offset.data.astype(np.uint32)
+        seed_data = np.broadcast_to(seed.data, offset_data.shape).astype(np.uint64)
+        k0 = (seed_data & 0xffffffff).astype(np.uint32)
+        k1 = (seed_data >> 32).astype(np.uint32)
+        zero = np.zeros_like(offset_data)
+        c0, c1, c2, c3 = offset_data // 4, zero, zero, zero
+        for _ in range(n_rounds):
+            prod_b = c2.astype(np.uint64) * np.uint64(0xCD9E8D57)
+            prod_a = c0.astype(np.uint64) * np.uint64(0xD2511F53)
+            c0 = (prod_b >> np.uint64(32)).astype(np.uint32) ^ c1 ^ k0
+            c1 = prod_b.astype(np.uint32)
+            c2 = (prod_a >> np.uint64(32)).astype(np.uint32) ^ c3 ^ k1
+            c3 = prod_a.astype(np.uint32)
+            k0 = k0 + np.uint32(0x9E3779B9)
+            k1 = k1 + np.uint32(0xBB67AE85)
+        words = np.choose(offset_data % 4, [c0, c1, c2, c3])
+        return TensorHandle(words.view(np.int32), tl.int32)
+
     # pointer arithmetic
 
     def create_addptr(self, ptr, offset):
@@ -489,6 +527,10 @@ class GridExecutor:
         _patch_lang_core(lang[0], builder)
         _patch_lang_math(lang[0], builder)
 
+    def _run_program(self, idx, args):
+        builder.set_grid_idx(*idx)
+        self.fn(**args)
+
     def __call__(self, *args_dev, **kwargs):
         args_hst = [_unwrap(arg).cpu() if hasattr(arg, "data_ptr") else arg for arg in args_dev]
         # removes reserved keywords from kwargs
@@ -504,11 +546,16 @@ class GridExecutor:
         assert len(grid) <= 3
         grid = grid + (1, ) * (3 - len(grid))
         builder.set_grid_dim(*grid)
-        for x in range(grid[0]):
-            for y in range(grid[1]):
-                for z in range(grid[2]):
-                    builder.set_grid_idx(x, y, z)
-                    self.fn(**args)
+        programs = itertools.product(range(grid[0]), range(grid[1]), range(grid[2]))
+        # The programs only interleave in the numpy ops and the memory
+        # accesses, which release the GIL.
+        num_threads = int(os.environ.get("TRITON_INTERPRET_NUM_THREADS", "1"))
+        if num_threads > 1:
+            with ThreadPoolExecutor(num_threads) as executor:
+                list(executor.map(lambda idx: self._run_program(idx, args), programs))
+        else:
+            for idx in programs:
+                self._run_program(idx, args)
         # copy arguments back to propagate side-effects
         for arg_dev, arg_hst in zip(args_dev, args_hst):
             if hasattr(arg_dev, "data_ptr"):
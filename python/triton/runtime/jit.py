@@ -5,9 +5,12 @@ import inspect
 import os
 import textwrap
 from collections import defaultdict, namedtuple
+from concurrent.futures import Future
 from functools import cached_property
-from typing import Callable, Generic, Iterable, List, Optional, TypeVar, Union, cast, overload
+from typing import Callable, Dict, Generic, Iterable, List, Optional, TypeVar, Union, cast, overload
 from ..runtime.driver import driver
+from ..tools.tensor_descriptor import TensorDescriptor
+from . import replay
 
 TRITON_MODULE = __name__[:-len(".runtime.jit")]
 
@@ -78,10 +81,13 @@ class KernelParam:
     KernelArg.
     """
 
-    def __init__(self, num: int, param: inspect.Parameter, do_not_specialize: bool):
+    def __init__(self, num: int, param: inspect.Parameter, do_not_specialize: bool, bucket=None):
         self.num = num
         self._param = param
         self.do_not_specialize = do_not_specialize
+        # the function mapping the values of the parameter to their bucket, see
+        # `jit`
+        self.bucket = bucket
 
     @cached_property
     def name(self):
@@ -133,19 +139,55 @@ class KernelArg:
 
     def specialization_key(self):
         assert not self.param.do_not_specialize
+        return JITFunction._specialization_key_of(self.value)
 
-        if hasattr(self.value, "data_ptr"):
-            return (self.value.data_ptr() % JITFunction.divisibility == 0, )
 
-        if isinstance(self.value, int):
-            # bool is a subclass of int, so we don't check explicitly above.
-            return (
-                self.value % JITFunction.divisibility == 0,
-                self.value % JITFunction.divisibility_8 == 0,
-                self.value == 1,
-            )
+class _AdaptiveVariants:
+    """
+    The launches of a kernel by the values of its integer arguments, then the
+    futures of its variants specialized on them, then these variants.
+    """
 
-        return (False, )
+    def __init__(self, src):
+        self.src = src
+        # the arguments that may be specialized on, including those of
+        # `do_not_specialize`: the variants are only compiled for the values
+        # that keep coming back
+        fn = src.fn
+        constants = {fn.arg_names.index(k) if isinstance(k, str) else k for k in src.constants}
+        self.params = [
+            p.num for p in fn.params if not p.is_constexpr and p.num not in constants and p.bucket is None
+            and p.annotation not in ("bool", "float")
+        ]
+        self.entries = dict()
+        self.compiled = 0
+
+
+def bucket_fn(kind):
+    """
+    The function mapping the integers to their bucket of `kind`: "pow2" for
+    the next power of 2, an int for the next multiple of it, or a function of
+    the integers.
+    """
+    if callable(kind):
+        return kind
+    if kind == "pow2":
+
+        def next_pow2(value):
+            if not isinstance(value, int):
+                raise TypeError(f"only integers are bucketed, got {value!r}")
+            return 1 << (value - 1).bit_length() if value > 1 else value
+
+        return next_pow2
+    if isinstance(kind, int) and not isinstance(kind, bool) and kind > 0:
+
+        def next_multiple(value):
+            if not isinstance(value, int):
+                raise TypeError(f"only integers are bucketed, got {value!r}")
+            return -(-value // kind) * kind
+
+        return next_multiple
+    raise ValueError(f"unknown bucket {kind!r}, expected 'pow2', a positive int or a function")
 
 
 class KernelInterface(Generic[T]):
@@ -170,9 +212,34 @@ class JITFunction(KernelInterface[T]):
     # So whether the LoadOp and StoreOp will lowering into TMA copy depend on whether the tensor stride is divisible by 8.
     # TODO: Make it more reasonable to handle multiple dtypes.
     divisibility_8 = 8
+    # Larger divisibilities that pointers and integers are specialized on.
+    # Level Zero USM allocations are at least 64-byte aligned and 2D block IO
+    # needs aligned pitches: knowing these alignments lets the backend emit
+    # wider accesses without runtime checks. Set with TRITON_DIVISIBILITY_BUCKETS,
+    # e.g. "64,128", or to an empty string to only specialize on 16.
+    divisibility_buckets = tuple(int(d) for d in os.environ.get("TRITON_DIVISIBILITY_BUCKETS", "64").split(",") if d)
+    # Whether the tensors of less than 2^31 bytes are specialized on, the
+    # offsets of the pointers into them being computed in i32 rather than i64.
+    # Disable with TRITON_POINTER_RANGE_32=0, e.g. for the kernels accessing
+    # out of the storage of their tensor arguments.
+    pointer_range_32 = os.environ.get("TRITON_POINTER_RANGE_32", "1") == "1"
+    # executor of the background compilations of the launch-when-ready mode
+    async_compile_pool = None
+    # The launches with the same values of the integer arguments of a kernel
+    # after which a variant of the kernel with these values as constants is
+    # compiled in the background, 0 not to, see `_adaptive_kernel`. Set with
+    # TRITON_ADAPTIVE_SPECIALIZATION.
+    adaptive_threshold = int(os.environ.get("TRITON_ADAPTIVE_SPECIALIZATION", "0"))
+    # the values tracked and the variants compiled, at most, by kernel
+    adaptive_max_tracked = 64
+    adaptive_max_variants = 8
+    # backends of the targets, created on their first launch
+    backends = {}
 
     @staticmethod
     def _key_of(arg):
+        if isinstance(arg, TensorDescriptor):
+            return f"tensordesc<{JITFunction._type_of(arg.dtype)[1:]}{list(arg.block_shape)}>"
         if hasattr(arg, "dtype"):
             return arg.dtype
         elif isinstance(arg, bool):
@@ -191,6 +258,43 @@ class JITFunction(KernelInterface[T]):
         else:
             raise TypeError(f"Unsupported type {type(arg)} for {arg}")
 
+    @staticmethod
+    def _specialization_key_of(arg):
+        if hasattr(arg, "data_ptr"):
+            return (
+                arg.data_ptr() % JITFunction.divisibility == 0,
+                JITFunction._larger_divisibility_of(arg),
+                JITFunction._fits_in_pointer_range_32(arg),
+            )
+
+        if isinstance(arg, int):
+            # bool is a subclass of int, so we don't check explicitly above.
+            return (
+                arg % JITFunction.divisibility == 0,
+                arg % JITFunction.divisibility_8 == 0,
+                JITFunction._larger_divisibility_of(arg),
+                arg == 1,
+            )
+
+        return (False, )
+
+    @staticmethod
+    def _larger_divisibility_of(arg):
+        """The largest of `divisibility_buckets` dividing `arg`, 0 if none does."""
+        value = arg.data_ptr() if hasattr(arg, "data_ptr") else arg
+        if not isinstance(value, int) or isinstance(value, bool):
+            return 0
+        buckets = [d for d in JITFunction.divisibility_buckets if d > JITFunction.divisibility and value % d == 0]
+        return max(buckets, default=0)
+
+    @staticmethod
+    def _fits_in_pointer_range_32(arg):
+        """Whether the storage of the tensor `arg` is smaller than 2^31 bytes, all
+        its elements being at offsets of its data pointer fitting in i32."""
+        if not JITFunction.pointer_range_32 or not hasattr(arg, "untyped_storage"):
+            return False
+        return arg.untyped_storage().nbytes() < 2**31
+
     @staticmethod
     def _spec_of(arg):
         if hasattr(arg, "data_ptr"):
@@ -234,12 +338,20 @@ class JITFunction(KernelInterface[T]):
             for param, arg in zip(self.params, args)
             if isinstance(arg, int) and not isinstance(arg, bool) and arg == 1 and not param.do_not_specialize
         }
+        larger_divisibility = {(param.num, self._larger_divisibility_of(arg))
+                               for param, arg in zip(self.params, args)
+                               if self._larger_divisibility_of(arg) and not param.do_not_specialize}
+        pointer_range_32 = {
+            param.num
+            for param, arg in zip(self.params, args)
+            if self._fits_in_pointer_range_32(arg) and not param.do_not_specialize
+        }
         # folded equal_to_1 and None
         # TODO: method to collect all folded args
         none_args = {param.num for param, arg in zip(self.params, args) if arg is None and not param.do_not_specialize}
         ids_of_folded_args = equal_to_1 | none_args
         return AttrsDescriptor(tuple(divisible_by_16), tuple(equal_to_1), tuple(ids_of_folded_args),
-                               tuple(divisible_by_8))
+                               tuple(divisible_by_8), tuple(larger_divisibility), tuple(pointer_range_32))
         # return _triton.code_gen.instance_descriptor(divisible_by_16,
         # equal_to_1)
 
@@ -331,51 +443,194 @@ class JITFunction(KernelInterface[T]):
             already_compiled=False,
         )
 
+    @staticmethod
+    def _async_compile_pool():
+        if JITFunction.async_compile_pool is None:
+            from concurrent.futures import ThreadPoolExecutor
+            workers = int(os.environ.get("TRITON_ASYNC_COMPILE_WORKERS", os.cpu_count() or 1))
+            JITFunction.async_compile_pool = ThreadPoolExecutor(max_workers=workers,
+                                                                thread_name_prefix="triton-compile")
+        return JITFunction.async_compile_pool
+
+    def _adaptive_kernel(self, kernel, device, key, values, target, options):
+        """
+        The variant of `kernel` specialized on the `values` of its integer
+        arguments, once they have been the same for `adaptive_threshold`
+        launches, e.g. head dimensions or bucketed sequence lengths, so that
+        the hot shapes get kernels with these values folded without turning
+        the arguments into constexprs. `kernel` is returned until the variant
+        has been compiled in the background, and for good if it fails.
+        """
+        variants = self.adaptive[device].get(key)
+        if variants is None:
+            return kernel
+        ints = tuple((i, values[i]) for i in variants.params if type(values[i]) is int)
+        if not ints:
+            return kernel
+        entry = variants.entries.get(ints)
+        if entry is None:
+            if len(variants.entries) < JITFunction.adaptive_max_tracked:
+                variants.entries[ints] = 1
+            return kernel
+        if isinstance(entry, int):
+            entry += 1
+            if entry < JITFunction.adaptive_threshold or variants.compiled >= JITFunction.adaptive_max_variants:
+                variants.entries[ints] = entry
+                return kernel
+            from ..compiler import ASTSource, compile
+            src = variants.src
+            src = ASTSource(self, src.signature, {**src.constants, **dict(ints)}, src.attrs)
+            variants.entries[ints] = self._async_compile_pool().submit(compile, src, target=target,
+                                                                        options=options.__dict__)
+            variants.compiled += 1
+            return kernel
+        if not isinstance(entry, Future):
+            return entry
+        if not entry.done():
+            return kernel
+        try:
+            variants.entries[ints] = entry.result()
+        except Exception:
+            # e.g. the kernel uses the argument as a tensor
+            variants.entries[ints] = kernel
+        return variants.entries[ints]
+
+    def _make_binder(self):
+        # Generates a function mapping the arguments of a launch to the values
+        # of the parameters, the launch options, the parts of the cache key
+        # that depend on the arguments, and the arguments passed to the
+        # launcher. It is specialized to the signature of the kernel, so that
+        # the launches skip `Signature.bind` and don't build a `KernelArg` per
+        # argument.
+        params, values, launch_args, sig_key, constexpr_key, spec_key = [], [], [], [], [], []
+        scope = {"_key_of": JITFunction._key_of, "_specialization_key_of": JITFunction._specialization_key_of}
+        for p in self.params:
+            if p.has_default:
+                scope[f"_default_{p.num}"] = p.default
+                params.append(f"{p.name}=_default_{p.num}")
+            else:
+                params.append(p.name)
+            if p.is_constexpr:
+                value = p.name
+                if p.bucket is not None:
+                    # the kernel is compiled for the bucket of the value
+                    scope[f"_bucket_{p.num}"] = p.bucket
+                    value = f"_bucket_{p.num}({p.name})"
+                values.append(value)
+                constexpr_key.append(value)
+            else:
+                values.append(p.name)
+                launch_args.append(p.name)
+                # mirrors KernelArg.signature_key
+                if "Tensor" in p.annotation:
+                    sig_key.append(f"{p.name}.dtype")
+                elif p.annotation == "bool":
+                    sig_key.append("'i1'")
+                elif p.annotation == "float":
+                    sig_key.append("'fp32'")
+                else:
+                    sig_key.append(f"_key_of({p.name})")
+            if not p.do_not_specialize:
+                spec_key.append(f"_specialization_key_of({p.name})")
+
+        def as_tuple(exprs):
+            return "(" + "".join(f"{e}, " for e in exprs) + ")"
+
+        src = f"def binder({', '.join(params + ['**_options'])}):\n"
+        src += f"    return ({as_tuple(values)}, {as_tuple(launch_args)}, _options, {as_tuple(sig_key)}, "
+        src += f"{as_tuple(constexpr_key)}, {as_tuple(spec_key)})\n"
+        exec(src, scope)
+        return scope["binder"]
+
+    def _parse_options(self, backend, target, kwargs):
+        # The options of the launches are parsed once per set of options.
+        try:
+            key = (target, tuple(sorted(kwargs.items())))
+            hash(key)
+        except TypeError:
+            key = None
+        options = self.options_cache.get(key) if key is not None else None
+        if options is None:
+            options = backend.parse_options(dict(kwargs, debug=self.debug))
+            unknown = [k for k in kwargs if k not in options.__dict__]
+            if unknown:
+                raise TypeError(f"{self.__name__}() got unexpected keyword arguments {unknown}")
+            if key is not None:
+                self.options_cache[key] = options
+        return options
+
+    @staticmethod
+    def _backend_of(target):
+        from ..compiler import make_backend
+        backend = JITFunction.backends.get(target)
+        if backend is None:
+            backend = JITFunction.backends[target] = make_backend(target)
+        return backend
+
     def run(self, *args, grid, warmup, **kwargs):
-        from ..compiler import CompiledKernel, compile, ASTSource, make_backend
+        from ..compiler import CompiledKernel, compile, ASTSource
         # deprecated arguments
         assert "device_type" not in kwargs, "device_type option is deprecated; current target will be used"
         assert "device" not in kwargs, "device option is deprecated; current device will be used"
         assert "stream" not in kwargs, "stream option is deprecated; current stream will be used"
-        # parse options
+        # launch-when-ready mode: a cache miss schedules the compilation in the
+        # background instead of blocking. Until the kernel is ready, the calls
+        # run `fallback` with the arguments of the kernel and return its result,
+        # or return a future of the `CompiledKernel` when there is no fallback.
+        # The kernel is not launched by these calls.
+        fallback = kwargs.pop("fallback", None)
+        async_compile = kwargs.pop("async_compile", False) or fallback is not None
+        # return the completion event of the launch instead of the kernel, on
+        # the drivers whose launchers support it
+        return_event = kwargs.pop("return_event", False)
+        # the values of the SPIR-V specialization constants of the kernel by
+        # id, which are set when it is loaded and don't recompile it
+        spec_constants = kwargs.pop("spec_constants", None)
+        if fallback is not None:
+            fallback_args = (args, {k: v for k, v in kwargs.items() if k in self.arg_names})
         device = driver.active.get_current_device()
         stream = driver.active.get_current_stream(device)
         target = driver.active.get_current_target()
-        backend = make_backend(target)
-        kwargs["debug"] = self.debug
-        options = backend.parse_options(kwargs)
-        # bind non-reserved keyword args and set defaults
-        kwargs = {k: v for k, v in kwargs.items() if not k in options.__dict__}
-        bound_args = self.signature.bind(*args, **kwargs)
-        bound_args.apply_defaults()
-        assert len(bound_args.arguments) == len(self.params)
+        backend = self._backend_of(target)
+        # bind the arguments, the other keyword args are the launch options
+        if self.binder is None:
+            self.binder = self._make_binder()
+        values, launch_args, kwargs, sig_key, constexpr_key, spec_key = self.binder(*args, **kwargs)
+        options = self._parse_options(backend, target, kwargs)
         # canonicalize grid
         assert grid is not None
         if callable(grid):
             # Arguments are passed as a dict to `grid`, by contract.
             # TODO(jlebar): In the new launch API, pass the compiler flags as a
             # second parameter to `grid`.
-            grid = grid(dict(bound_args.arguments))
+            grid = grid(dict(zip(self.arg_names, values)))
         grid_size = len(grid)
         grid_0 = grid[0]
         grid_1 = grid[1] if grid_size > 1 else 1
         grid_2 = grid[2] if grid_size > 2 else 1
         # compute cache key
-        args = [KernelArg(arg_value, param) for (_, arg_value), param in zip(bound_args.arguments.items(), self.params)]
-        sig_key = tuple(arg.signature_key() for arg in args if not arg.param.is_constexpr)
-        spec_key = tuple(arg.specialization_key() for arg in args if not arg.param.do_not_specialize)
-        constexpr_key = tuple(arg.value for arg in args if arg.param.is_constexpr)
         key = (sig_key, constexpr_key, spec_key, options)
+        # The kernel is being compiled in the background.
+        future = self.pending[device].get(key)
+        if future is not None:
+            if async_compile and not future.done():
+                return fallback(*fallback_args[0], **fallback_args[1]) if fallback is not None else future
+            self.pending[device].pop(key, None)
+            # waits for the synchronous calls, and raises the errors of the
+            # compilation
+            self.cache[device][key] = future.result()
         # Kernel is not cached; we have to compile.
         if key not in self.cache[device]:
-            configs = (self._get_config(*[arg.value for arg in args]), )
+            args = [KernelArg(value, param) for value, param in zip(values, self.params)]
+            configs = (self._get_config(*values), )
             constants = {
                 arg.param.num: arg.value
                 for arg in args
                 if arg.param.is_constexpr or arg.param.num in configs[0].equal_to_1 or arg.value is None
             }
+            # the @jit functions are called by the kernel, they're inlined
             for i, arg in constants.items():
-                if callable(arg):
+                if callable(arg) and not isinstance(arg, JITFunction):
                     raise TypeError(f"Callable constexpr at index {i} is not supported")
 
             # Build kernel signature -- doesn't include constexpr arguments.
@@ -391,25 +646,45 @@ class JITFunction(KernelInterface[T]):
                 return None
             # compile the kernel
             src = ASTSource(self, signature, constants, configs[0])
+            if async_compile:
+                future = self._async_compile_pool().submit(compile, src, target=target, options=options.__dict__)
+                self.pending[device][key] = future
+                return fallback(*fallback_args[0], **fallback_args[1]) if fallback is not None else future
             self.cache[device][key] = compile(
                 src,
                 target=target,
                 options=options.__dict__,
             )
+            if JITFunction.adaptive_threshold > 0:
+                self.adaptive[device][key] = _AdaptiveVariants(src)
 
         kernel = self.cache[device][key]
+        if JITFunction.adaptive_threshold > 0:
+            kernel = self._adaptive_kernel(kernel, device, key, values, target, options)
+        if spec_constants:
+            kernel = kernel.specialize(spec_constants)
         if not warmup:
-            args = [arg.value for arg in args if not arg.param.is_constexpr]
+            if replay.active_recorder is not None:
+                replay.active_recorder.record_launch(self, values, (grid_0, grid_1, grid_2), kwargs, key)
+            args = launch_args
             metadata = kernel.metadata
-            kernel.run(grid_0, grid_1, grid_2, metadata.num_warps,
-                       metadata.num_ctas,  # number of warps/ctas per instance
-                       metadata.cluster_dims[0], metadata.cluster_dims[1], metadata.cluster_dims[2],  # cluster
-                       metadata.shared, stream, kernel.function, CompiledKernel.launch_enter_hook,
-                       CompiledKernel.launch_exit_hook, metadata,
-                       *driver.active.assemble_tensormap_to_arg(metadata.tensormaps_info, args))
+            if return_event:
+                if not hasattr(kernel.run, "launch_with_event"):
+                    raise RuntimeError("the launcher of the active driver doesn't return events")
+                launch = kernel.run.launch_with_event
+            else:
+                launch = kernel.run
+            event = launch(grid_0, grid_1, grid_2, metadata.num_warps,
+                           metadata.num_ctas,  # number of warps/ctas per instance
+                           metadata.cluster_dims[0], metadata.cluster_dims[1], metadata.cluster_dims[2],  # cluster
+                           metadata.shared, stream, kernel.function, CompiledKernel.launch_enter_hook,
+                           CompiledKernel.launch_exit_hook, metadata,
+                           *driver.active.assemble_tensormap_to_arg(metadata.tensormaps_info, args))
+            if return_event:
+                return event
         return kernel
 
-    def __init__(self, fn, version=None, do_not_specialize=None, debug=None, noinline=None):
+    def __init__(self, fn, version=None, do_not_specialize=None, debug=None, noinline=None, bucket=None):
         do_not_specialize = do_not_specialize if do_not_specialize else []
 
         self.fn = fn
@@ -420,15 +695,32 @@ class JITFunction(KernelInterface[T]):
         self.starting_line_number = inspect.getsourcelines(fn)[1]
 
         self.params = []
+        arg_names = list(self.signature.parameters)
+        # the buckets of the parameters by name
+        self.bucket = {arg_names[k] if isinstance(k, int) else k: kind for k, kind in (bucket or {}).items()}
+        unknown = [name for name in self.bucket if name not in arg_names]
+        if unknown:
+            raise ValueError(f"{fn.__name__} has no parameters {unknown} to bucket")
         for i, param in enumerate(self.signature.parameters.values()):
             dns = do_not_specialize and (i in do_not_specialize or param.name in do_not_specialize)
-            self.params.append(KernelParam(i, param, dns))
+            kind = self.bucket.get(param.name)
+            # the integer arguments that are bucketed are not specialized on,
+            # all the values of a bucket sharing the kernel
+            self.params.append(KernelParam(i, param, dns or kind is not None, None if kind is None else bucket_fn(kind)))
 
         # function source code (without decorators)
         self.src = textwrap.dedent(inspect.getsource(fn))
         self.src = self.src[self.src.find("def"):]
         # cache of just-in-time compiled kernels
         self.cache = defaultdict(dict)
+        # futures of the kernels compiled in the background, see `run`
+        self.pending = defaultdict(dict)
+        # the sources of the kernels and their variants specialized on the
+        # values of their integer arguments, see `_adaptive_kernel`
+        self.adaptive = defaultdict(dict)
+        # see `_make_binder` and `_parse_options`
+        self.binder = None
+        self.options_cache = {}
         self.hash = None
         # JITFunction can be instantiated as kernel
         # when called with a grid using __getitem__
@@ -462,22 +754,27 @@ class JITFunction(KernelInterface[T]):
     # we do not parse `src` in the constructor because
     # the user might want to monkey-patch self.src dynamically.
     # Our unit tests do this, for example.
+    # The tree is parsed once per version of `src` and shared by the code
+    # generation of all the specializations, which never modifies it.
     def parse(self):
-        tree = ast.parse(self.src)
-        assert isinstance(tree, ast.Module)
-        assert len(tree.body) == 1
-        assert isinstance(tree.body[0], ast.FunctionDef)
-        return tree
+        if self.tree is None:
+            tree = ast.parse(self.src)
+            assert isinstance(tree, ast.Module)
+            assert len(tree.body) == 1
+            assert isinstance(tree.body[0], ast.FunctionDef)
+            self.tree = tree
+        return self.tree
 
     def __call__(self, *args, **kwargs):
         raise RuntimeError("Cannot call @triton.jit'd outside of the scope of a kernel")
 
     def __setattr__(self, name, value):
         super(JITFunction, self).__setattr__(name, value)
-        # - when `.src` attribute is set, cache path needs
+        # - when `.src` attribute is set, cache path and parsed tree need
         #   to be reinitialized
         if name == "src":
             self.hash = None
+            self.tree = None
 
     def __repr__(self):
         return f"JITFunction({self.module}:{self.fn.__name__})"
@@ -500,6 +797,7 @@ def jit(
     do_not_specialize: Optional[Iterable[int]] = None,
     debug: Optional[bool] = None,
     noinline: Optional[bool] = None,
+    bucket: Optional[Dict] = None,
 ) -> Callable[[T], JITFunction[T]]:
     ...
 
@@ -511,6 +809,7 @@ def jit(
     do_not_specialize: Optional[Iterable[int]] = None,
     debug: Optional[bool] = None,
     noinline: Optional[bool] = None,
+    bucket: Optional[Dict] = None,
 ) -> Union[JITFunction[T], Callable[[T], JITFunction[T]]]:
     """
     Decorator for JIT-compiling a function using the Triton compiler.
@@ -528,6 +827,14 @@ def jit(
 
     :param fn: the function to be jit-compiled
     :type fn: Callable
+    :param bucket: maps parameters, by name or index, to the buckets of their integer values, to bound the number of
+        kernels compiled for dynamic sizes: "pow2" for the next power of 2, an int for the next multiple of it, or a
+        function of the value, e.g. :code:`bucket={'BLOCK_N': 'pow2', 'N': 'pow2'}`. A :code:`tl.constexpr` parameter
+        takes the bucket of its value, the kernel is compiled once per bucket and must mask its accesses with a
+        runtime size: :code:`BLOCK_N` covers :code:`N` but may exceed it. The other parameters keep their values and
+        are not specialized on, e.g. on their divisibility by 16, all their values sharing one kernel. The autotuners
+        of the function tune the parameters of their key once per bucket.
+    :type bucket: dict
     """
 
     def decorator(fn: T) -> JITFunction[T]:
@@ -542,6 +849,7 @@ def jit(
                 do_not_specialize=do_not_specialize,
                 debug=debug,
                 noinline=noinline,
+                bucket=bucket,
             )
 
     if fn is not None:
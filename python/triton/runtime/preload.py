@@ -0,0 +1,140 @@
+"""
+Preloading of the kernels a service uses, so that the first requests after a
+deploy don't build their modules.
+
+The kernels loaded by a process are recorded to a manifest, a JSON file of
+their binaries in the cache, with `TRITON_PRELOAD_MANIFEST=<path>` or within
+`record`. At startup, `preload` loads the kernels of the manifest on their
+devices, in parallel across host threads: the modules are built without the
+GIL, from the native binaries of the cache when the driver has stored them.
+The kernels stay loaded, so that the first launch of each finds its kernel
+loaded by the driver.
+"""
+
+import atexit
+import contextlib
+import json
+import os
+import threading
+import warnings
+
+# the manifest the loaded kernels are recorded to, if any
+active_manifest = None
+
+
+class Manifest:
+
+    def __init__(self, path):
+        self.path = path
+        self.entries = {}
+        self.lock = threading.Lock()
+        # the kernels of the previous sessions are kept
+        if os.path.exists(path):
+            for entry in load(path):
+                self.entries[_entry_key(entry)] = entry
+
+    def record_load(self, kernel, device):
+        entry = {
+            "name": kernel.name,
+            "hash": kernel.metadata.hash,
+            "binary": str(kernel.asm.files[kernel.asm.binary_ext]),
+            "shared": kernel.metadata.shared,
+            "build_flags": getattr(kernel.metadata, "build_flags", ""),
+            "spec_constants": [[id, ty, value] for id, (ty, value) in sorted((kernel._spec_constants or {}).items())],
+            "device": device,
+        }
+        with self.lock:
+            self.entries.setdefault(_entry_key(entry), entry)
+
+    def write(self):
+        with self.lock:
+            data = json.dumps({"kernels": list(self.entries.values())}, indent=1)
+        temp_path = f"{self.path}.tmp.pid_{os.getpid()}"
+        with open(temp_path, "w") as f:
+            f.write(data)
+        os.replace(temp_path, self.path)
+
+
+def _entry_key(entry):
+    return (entry["hash"], entry["device"], json.dumps(entry["spec_constants"]))
+
+
+@contextlib.contextmanager
+def record(path):
+    """Records the kernels loaded while in the context to the manifest at `path`, written on exit."""
+    global active_manifest
+    previous, active_manifest = active_manifest, Manifest(path)
+    try:
+        yield active_manifest
+    finally:
+        active_manifest.write()
+        active_manifest = previous
+
+
+def load(path):
+    """Returns the kernels of the manifest at `path`."""
+    with open(path) as f:
+        return json.load(f)["kernels"]
+
+
+# the handles of the preloaded kernels, which keep them loaded
+_preloaded = []
+_preloaded_lock = threading.Lock()
+
+
+def preload(path, num_threads=None, devices=None):
+    """
+    Loads the kernels of the manifest at `path` on their devices, or on
+    `devices` when given, with `num_threads` host threads, one per CPU by
+    default, and returns the number of kernels loaded. The kernels whose
+    binary is no longer in the cache, e.g. evicted or compiled by another
+    version, are skipped with a warning.
+    """
+    from concurrent.futures import ThreadPoolExecutor
+    from .cache import read_cache_file
+    from .driver import driver
+
+    entries = load(path)
+    num_devices = driver.active.utils.device_count[0]
+    tasks = []
+    for entry in entries:
+        for device in devices if devices is not None else [entry["device"]]:
+            if 0 <= device < num_devices:
+                tasks.append((entry, device))
+
+    def load_kernel(task):
+        entry, device = task
+        try:
+            binary = read_cache_file(entry["binary"])
+        except OSError:
+            warnings.warn(f"{entry['name']} isn't in the cache anymore, not preloaded")
+            return False
+        spec_constants = {id: (ty, value) for id, ty, value in entry["spec_constants"]} or None
+        _, function, *_ = driver.active.utils.load_binary(entry["name"], binary, entry["shared"], device,
+                                                          entry["hash"], entry["build_flags"], spec_constants)
+        with _preloaded_lock:
+            _preloaded.append(function)
+        return True
+
+    if not tasks:
+        return 0
+    num_threads = num_threads or min(len(tasks), os.cpu_count() or 1)
+    with ThreadPoolExecutor(max_workers=num_threads) as executor:
+        return sum(executor.map(load_kernel, tasks))
+
+
+def release_preloaded():
+    """Releases the kernels preloaded by `preload`, those launched since stay loaded."""
+    from .driver import driver
+    with _preloaded_lock:
+        functions = _preloaded[:]
+        _preloaded.clear()
+    for function in functions:
+        driver.active.utils.unload_binary(function)
+
+
+# TRITON_PRELOAD_MANIFEST=<path> records the kernels loaded by the whole
+# process, written at exit.
+if os.environ.get("TRITON_PRELOAD_MANIFEST"):
+    active_manifest = Manifest(os.environ["TRITON_PRELOAD_MANIFEST"])
+    atexit.register(active_manifest.write)
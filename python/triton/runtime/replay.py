@@ -0,0 +1,134 @@
+"""
+Recording of the kernel launches, e.g. of the dynamic shapes a model runs in
+production, to replay them offline with synthetic tensors, see
+`triton/tools/replay.py`.
+
+The log is a zlib stream of JSON records, one per line:
+
+    ["kernel", id, module, qualname, file, arg_names]
+    ["launch", kernel id, specialization key, grid, args, options]
+    ["tune", kernel id, tuning key, best config, {config: median ms}]
+
+The kernels are written once, the first time they are launched. The tensor
+arguments are described by ["tensor", dtype, shape, strides, alignment], the
+alignment being the offset of their address modulo 16 bytes, the other values
+by themselves, or by ["dtype", name] and ["repr", repr] for the constexprs
+that aren't JSON values.
+"""
+
+import atexit
+import contextlib
+import inspect
+import json
+import os
+import threading
+import zlib
+
+# the recorder the launches are written to, if any
+active_recorder = None
+
+
+def _describe(value):
+    if hasattr(value, "data_ptr") and hasattr(value, "dtype"):
+        return ["tensor", str(value.dtype).split(".")[-1], list(value.shape), list(value.stride()), value.data_ptr() % 16]
+    if value is None or isinstance(value, (bool, int, float, str)):
+        return value
+    from ..language import dtype
+    if isinstance(value, dtype):
+        return ["dtype", value.name]
+    return ["repr", repr(value)]
+
+
+class Recorder:
+
+    # the compressed stream is flushed every `flush_every` records, so that the
+    # log stays readable if the process dies
+    flush_every = 256
+
+    def __init__(self, path):
+        self.path = path
+        self.file = open(path, "wb")
+        self.compressor = zlib.compressobj()
+        self.kernel_ids = {}
+        self.num_pending = 0
+        self.lock = threading.Lock()
+
+    def _write(self, record):
+        data = (json.dumps(record, separators=(",", ":"), default=repr) + "\n").encode()
+        self.file.write(self.compressor.compress(data))
+        self.num_pending += 1
+        if self.num_pending >= self.flush_every:
+            self.flush()
+
+    def _kernel_id(self, fn):
+        kernel_id = self.kernel_ids.get(fn)
+        if kernel_id is None:
+            kernel_id = self.kernel_ids[fn] = len(self.kernel_ids)
+            try:
+                file = inspect.getsourcefile(fn.fn)
+            except TypeError:
+                file = None
+            self._write(["kernel", kernel_id, fn.module, fn.fn.__qualname__, file, fn.arg_names])
+        return kernel_id
+
+    def record_launch(self, fn, values, grid, options, key):
+        args = [_describe(value) for value in values]
+        options = {name: _describe(value) for name, value in options.items()}
+        with self.lock:
+            if self.file is not None:
+                self._write(["launch", self._kernel_id(fn), repr(key[:3]), list(grid), args, options])
+
+    def record_tuning(self, fn, key, config, timings):
+        key = [_describe(value) for value in key]
+        timings = {str(c): timing[0] for c, timing in timings.items()}
+        with self.lock:
+            if self.file is not None:
+                self._write(["tune", self._kernel_id(fn), key, str(config), timings])
+
+    def flush(self):
+        if self.file is not None:
+            self.file.write(self.compressor.flush(zlib.Z_SYNC_FLUSH))
+            self.file.flush()
+            self.num_pending = 0
+
+    def close(self):
+        with self.lock:
+            if self.file is None:
+                return
+            self.file.write(self.compressor.flush())
+            self.file.close()
+            self.file = None
+
+
+@contextlib.contextmanager
+def record(path):
+    """Records the launches of the kernels to the log at `path` while in the context."""
+    global active_recorder
+    previous, active_recorder = active_recorder, Recorder(path)
+    try:
+        yield active_recorder
+    finally:
+        active_recorder.close()
+        active_recorder = previous
+
+
+def load(path):
+    """Yields the records of the log at `path`, the partial record of an interrupted process excepted."""
+    decompressor = zlib.decompressobj()
+    pending = b""
+    with open(path, "rb") as f:
+        while chunk := f.read(1 << 16):
+            try:
+                pending += decompressor.decompress(chunk)
+            except zlib.error:
+                break
+            *lines, pending = pending.split(b"\n")
+            for line in lines:
+                yield json.loads(line)
+
+
+# TRITON_RECORD_LAUNCHES=<path> records the launches of the whole process,
+# "{pid}" in the path being replaced by its id.
+if os.environ.get("TRITON_RECORD_LAUNCHES"):
+    active_recorder = Recorder(os.environ["TRITON_RECORD_LAUNCHES"].format(pid=os.getpid()))
+    atexit.register(active_recorder.close)
@@ -77,9 +77,133 @@ def do_bench_cudagraph(fn, rep=20, grad_to_none=None):
     return torch.mean(torch.tensor(ret)).item()
 
 
+def do_bench_xpugraph(fn, rep=20, grad_to_none=None):
+    import torch
+    """
+    Benchmark the runtime of the provided function, replaying its launches from a SYCL graph.
+
+    :param fn: Function to benchmark
+    :type fn: Callable
+    :param rep: Repetition time (in ms)
+    :type rep: int
+    :param grad_to_none: Reset the gradient of the provided tensor to None
+    :type grad_to_none: torch.tensor, optional
+    """
+    from .runtime.driver import driver
+    # warmup, which also compiles and loads the kernels, so that only launches get recorded
+    fn()
+    torch.xpu.synchronize()
+    if grad_to_none is not None:
+        for x in grad_to_none:
+            x.detach_()
+            x.requires_grad_(True)
+            x.grad = None
+    # step 1 - we estimate the amount of time the kernel call takes
+    g = driver.active.utils.graph()
+    with g.capture():
+        fn()
+    start_event = torch.xpu.Event(enable_timing=True)
+    end_event = torch.xpu.Event(enable_timing=True)
+    start_event.record()
+    g.replay()
+    end_event.record()
+    torch.xpu.synchronize()
+    estimate_ms = start_event.elapsed_time(end_event)
+    n_repeat = max(1, int(rep / estimate_ms))
+    # step 2 - construct a graph with `n_repeat` unrolled function calls to minimize
+    # host overhead
+    g = driver.active.utils.graph()
+    with g.capture():
+        for i in range(n_repeat):
+            if grad_to_none is not None:
+                for x in grad_to_none:
+                    x.grad = None
+            fn()
+    torch.xpu.synchronize()
+    # measure time and return
+    ret = []
+    n_retries = 10
+    for i in range(n_retries):
+        start_event = torch.xpu.Event(enable_timing=True)
+        end_event = torch.xpu.Event(enable_timing=True)
+        start_event.record()
+        g.replay()
+        end_event.record()
+        torch.xpu.synchronize()
+        ret += [start_event.elapsed_time(end_event) / n_repeat]
+    return torch.mean(torch.tensor(ret)).item()
+
+
+def _summarize_times(times, quantiles, return_mode):
+    import torch
+    if quantiles is not None:
+        ret = torch.quantile(times, torch.tensor(quantiles, dtype=torch.float)).tolist()
+        if len(ret) == 1:
+            ret = ret[0]
+        return ret
+    if return_mode == "p99":
+        return torch.quantile(times, 0.99).item()
+    return getattr(torch, return_mode)(times).item()
+
+
+def do_bench_xpu(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fast_flush=True, return_mode="mean"):
+    """
+    Benchmark the runtime of the provided function on XPU. Each run is timed on the device with profiling events, so
+    the time spent submitting the kernels from the host isn't included, and the L3 cache is flushed before each run.
+
+    The parameters are the ones of :code:`do_bench`.
+    """
+    import torch
+    from .runtime.driver import driver
+
+    fn()
+    torch.xpu.synchronize()
+
+    # Writing twice the size of the L3 cache evicts the data of the previous run.
+    props = driver.active.utils.get_device_properties(driver.active.get_current_device())
+    cache_size = 2 * props.get("l3_cache_size", 0) or int(256e6)
+    if fast_flush:
+        cache = torch.empty(cache_size // 4, dtype=torch.int, device='xpu')
+    else:
+        cache = torch.empty(cache_size, dtype=torch.int8, device='xpu')
+
+    # Estimate the runtime of the function
+    start_event = torch.xpu.Event(enable_timing=True)
+    end_event = torch.xpu.Event(enable_timing=True)
+    start_event.record()
+    for _ in range(5):
+        cache.zero_()
+        fn()
+    end_event.record()
+    torch.xpu.synchronize()
+    estimate_ms = start_event.elapsed_time(end_event) / 5
+
+    # compute number of warmup and repeat
+    n_warmup = max(1, int(warmup / estimate_ms))
+    n_repeat = max(1, int(rep / estimate_ms))
+    start_events = [torch.xpu.Event(enable_timing=True) for i in range(n_repeat)]
+    end_events = [torch.xpu.Event(enable_timing=True) for i in range(n_repeat)]
+
+    # Warm-up
+    for _ in range(n_warmup):
+        fn()
+    # Benchmark
+    for i in range(n_repeat):
+        if grad_to_none is not None:
+            for x in grad_to_none:
+                x.grad = None
+        cache.zero_()
+        start_events[i].record()
+        fn()
+        end_events[i].record()
+    torch.xpu.synchronize()
+    times = torch.tensor([s.elapsed_time(e) for s, e in zip(start_events, end_events)], dtype=torch.float)
+    return _summarize_times(times, quantiles, return_mode)
+
+
 def do_bench(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fast_flush=True, return_mode="mean",
              device='xpu'):
-    assert return_mode in ["min", "max", "mean", "median"]
+    assert return_mode in ["min", "max", "mean", "median", "p99"]
     import torch
     """
     Benchmark the runtime of the provided function. By default, return the median runtime of :code:`fn` along with
@@ -97,8 +221,14 @@ def do_bench(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fast_flu
     :type quantiles: list[float]
     :param fast_flush: Use faster kernel to flush L2 between measurements
     :type fast_flush: bool
+    :param return_mode: The statistic to return when :code:`quantiles` isn't given: "min", "max", "mean", "median"
+        or "p99"
+    :type return_mode: str
     """
 
+    if device == 'xpu':
+        return do_bench_xpu(fn, warmup, rep, grad_to_none, quantiles, fast_flush, return_mode)
+
     fn()
     if torch.cuda.is_available():
         torch.cuda.synchronize()
@@ -155,12 +285,7 @@ def do_bench(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fast_flu
         torch.xpu.synchronize()
     times = torch.tensor([(e.timestamp() - s.timestamp()) * 1000 for s, e in zip(start_times, end_times)],
                          dtype=torch.float)
-    if quantiles is not None:
-        ret = torch.quantile(times, torch.tensor(quantiles, dtype=torch.float)).tolist()
-        if len(ret) == 1:
-            ret = ret[0]
-        return ret
-    return getattr(torch, return_mode)(times).item()
+    return _summarize_times(times, quantiles, return_mode)
 
 
 def assert_close(x, y, atol=None, rtol=None, err_msg=''):
@@ -414,6 +539,86 @@ def get_max_tensorcore_tflops(dtype, clock_rate, device=None):
     return tflops
 
 
+def get_xpu_clocks(device=None):
+    ''' return the current frequencies in MHz of the compute engines and of the memory of an XPU device '''
+    from .runtime import driver
+    if device is None:
+        device = driver.active.get_current_device()
+    utils = driver.active.utils
+    freqs = utils.get_device_frequencies(device)
+    props = utils.get_device_properties(device)
+    # Level Zero only reports the frequencies when ZES_ENABLE_SYSMAN=1, fall back
+    # to the maximum ones of the device otherwise.
+    gpu_clock = freqs["gpu_clock_rate"] if freqs["gpu_clock_rate"] > 0 else props["sm_clock_rate"]
+    mem_clock = freqs["mem_clock_rate"] if freqs["mem_clock_rate"] > 0 else props["mem_clock_rate"]
+    return gpu_clock, mem_clock
+
+
+def get_xpu_dram_gbps(mem_clock_rate=None, device=None):
+    ''' return DRAM bandwidth in GB/s of an XPU device, at `mem_clock_rate` MHz or at its maximum frequency '''
+    from .runtime import driver
+    if device is None:
+        device = driver.active.get_current_device()
+    props = driver.active.utils.get_device_properties(device)
+    if mem_clock_rate is None:
+        mem_clock_rate = props["mem_clock_rate"]
+    # Level Zero reports the effective data rate of the memory.
+    return mem_clock_rate * props["mem_bus_width"] / 8 / 1e3
+
+
+def get_max_xmx_tflops(dtype, clock_rate, device=None):
+    ''' return the peak TFLOPS of the XMX engines of an XPU device running at `clock_rate` kHz '''
+    import torch
+
+    from .runtime import driver
+    if device is None:
+        device = driver.active.get_current_device()
+    props = driver.active.utils.get_device_properties(device)
+    num_xe_cores = props["multiprocessor_count"]
+    # The Xe cores have 8 XMX engines on PVC with TF32 support, 16 narrower ones
+    # on Arc which run FP32 on the vector engines.
+    is_pvc = props["device_arch"] == 1
+    if dtype in [torch.float32, torch.int32]:
+        ops_per_xe_core = 2048 if is_pvc else 256
+    elif dtype in [torch.float16, torch.bfloat16, torch.int16]:
+        ops_per_xe_core = 4096 if is_pvc else 2048
+    elif dtype in [torch.int8, tl.float8e4nv, tl.float8e4b15, tl.float8e5]:
+        ops_per_xe_core = 8192 if is_pvc else 4096
+    else:
+        raise RuntimeError("dtype not supported")
+    tflops = num_xe_cores * clock_rate * ops_per_xe_core * 1e-9
+    return tflops
+
+
+def get_achieved_throughput(kernel, grid, args, ms, dtype=None, device=None):
+    '''
+    return the GB/s and TFLOPS a run of the compiled `kernel` over `grid` achieves in `ms` milliseconds, from the
+    traffic estimated by the compiler, or None if the backend doesn't estimate it. `args` maps the names of the
+    arguments of the kernel to their values. On XPU devices, the fractions of the peak DRAM bandwidth, and when the
+    `dtype` of the dots is given, of the peak XMX TFLOPS and of the roofline they reach are returned as well.
+    '''
+    traffic = kernel.traffic(grid, args) if hasattr(kernel, "traffic") else None
+    if not traffic or ms <= 0:
+        return None
+    gbps = (traffic["bytes_read"] + traffic["bytes_written"]) / ms * 1e-6
+    tflops = traffic["flops"] / ms * 1e-9
+    throughput = {"gbps": gbps, "tflops": tflops}
+    from .runtime import driver
+    if driver.active.get_current_target()[0] != "xpu":
+        return throughput
+    gpu_clock, mem_clock = get_xpu_clocks(device)
+    peak_gbps = get_xpu_dram_gbps(mem_clock, device)
+    throughput["bandwidth_utilization"] = gbps / peak_gbps
+    if dtype is not None and traffic["flops"]:
+        peak_tflops = get_max_xmx_tflops(dtype, gpu_clock * 1e3, device)
+        # The roofline caps the FLOPS at the peak ones, or at those the DRAM
+        # bandwidth feeds at the arithmetic intensity of the kernel.
+        intensity = traffic["flops"] / max(traffic["bytes_read"] + traffic["bytes_written"], 1)
+        throughput["compute_utilization"] = tflops / peak_tflops
+        throughput["roofline_utilization"] = tflops / min(peak_tflops, intensity * peak_gbps * 1e-3)
+    return throughput
+
+
 # create decorator that wraps test function into
 # a cuda-memcheck system call
 
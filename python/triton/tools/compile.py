@@ -1,6 +1,7 @@
 import binascii
 import hashlib
 import importlib.util
+import json
 import sys
 from argparse import ArgumentParser
 from pathlib import Path
@@ -17,6 +18,10 @@ This program compiles the kernel with name `kernel-name` in the file at the
 provided `path` into self-contained C source-code that embeds the `cubin`
 data along with utilities to load, unload and launch the kernel.
 
+On XPU, the generated code embeds the SPIR-V of the kernel instead, and
+optionally the native binary it is finalized to for the current device, and
+launches it through Level Zero.
+
 signature is provided as a list of (optionally divisibility-hinted) types
 or constexpr values, e.g.
 
@@ -30,6 +35,12 @@ The resulting entry point will have signature
 
 CUresult kernel_{specialization_suffix}(CUstream stream, unsigned gX, unsigned gY, unsigned gZ, float* arg0, int32_t arg1, int32_t arg2)
 
+or on XPU
+
+ze_result_t kernel_{specialization_suffix}(ze_command_list_handle_t cmd_list, float* arg0, int32_t arg1, int32_t arg2)
+
+where the kernel must first be loaded on a device with `load_kernel_{specialization_suffix}(context, device)`.
+
 Different such specialized entry points can be combined using the `linker.py` script.
 
 NOTE: when resolving the scope of /path/to/kernel.py, the file will be executed from within its parent directory with the python interpreter
@@ -51,6 +62,12 @@ if __name__ == "__main__":
     parser.add_argument("--out-path", "-o", type=Path, default=None, help="Out filename")
     parser.add_argument("--signature", "-s", type=str, help="Signature of the kernel", required=True)
     parser.add_argument("--grid", "-g", type=str, help="Launch grid of the kernel", required=True)
+    parser.add_argument("--native-binary", action="store_true",
+                        help="Also embed the native binary of the current device (XPU only)")
+    parser.add_argument("--grf-mode", type=str, default=None,
+                        help="Register file size of the kernel, \"default\" or \"large\" (XPU only)")
+    parser.add_argument("--build-flags", type=str, default=None,
+                        help="Flags passed to IGC when building the kernel (XPU only)")
     args = parser.parse_args()
 
     out_name = args.out_name if args.out_name else args.kernel_name
@@ -109,6 +126,10 @@ if __name__ == "__main__":
         constants.update({i: 1})
     src = triton.compiler.ASTSource(fn=kernel, constants=constants, signature=signature, attrs=attrs)
     opts = {"num_warps": args.num_warps, "num_stages": args.num_stages}
+    if args.grf_mode is not None:
+        opts["grf_mode"] = args.grf_mode
+    if args.build_flags is not None:
+        opts["build_flags"] = args.build_flags
     ccinfo = triton.compile(src, options=opts)
     arg_names = []
     arg_types = []
@@ -121,7 +142,9 @@ if __name__ == "__main__":
     suffix = kernel_suffix(signature.values(), attrs)
     func_name = '_'.join([out_name, sig_hash, suffix])
     triton_kernel_name = '_'.join([args.kernel_name, suffix])
-    hex_ = str(binascii.hexlify(ccinfo.asm["cubin"]))[2:-1]
+    binary_ext = triton.runtime.driver.active.binary_ext
+    xpu = binary_ext == "spv"
+    hex_ = str(binascii.hexlify(ccinfo.asm[binary_ext]))[2:-1]
     params = {
         "kernel_name": func_name,
         "triton_kernel_name": triton_kernel_name,
@@ -140,7 +163,29 @@ if __name__ == "__main__":
         "gridZ": grid[2],
         "_placeholder": "",
     }
+    if xpu:
+        native = b""
+        if args.native_binary:
+            utils = triton.runtime.driver.active.utils
+            native = utils.get_native_binary(ccinfo.metadata.name, ccinfo.kernel, ccinfo.metadata.shared,
+                                             utils.get_current_device(), ccinfo.metadata.build_flags) or b""
+        # the name of the SPIR-V entry point, and the size of the work-groups
+        params.update({
+            "triton_kernel_name": ccinfo.metadata.name,
+            "bin_size": len(hex_) // 2,
+            "native_size": len(native),
+            "native_data": ", ".join([f"0x{b:02x}" for b in native]) or "0",
+            "arg_sizes": ", ".join([f"sizeof({arg})" for arg in arg_names]),
+            "threads_per_warp": ccinfo.metadata.threads_per_warp,
+            "build_flags": json.dumps(ccinfo.metadata.build_flags),
+        })
+    else:
+        assert not args.native_binary, "--native-binary is only supported on XPU"
+    template_name = "compile_xpu" if xpu else "compile"
     for ext in ['h', 'c']:
-        template_path = Path(__file__).parent / f"compile.{ext}"
+        template_path = Path(__file__).parent / f"{template_name}.{ext}"
         with out_path.with_suffix(f".{sig_hash}_{suffix}.{ext}").open("w") as fp:
             fp.write(Path(template_path).read_text().format(**params))
+    if xpu:
+        # the SPIR-V of the kernels can be linked into one module by `link.py --bundle`
+        out_path.with_suffix(f".{sig_hash}_{suffix}.spv").write_bytes(ccinfo.kernel)
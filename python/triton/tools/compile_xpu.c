@@ -0,0 +1,101 @@
+/* clang-format off */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+#include <level_zero/ze_api.h>
+
+
+// helpers to check for level zero errors
+#define ZE_CHECK(ans) {{\
+    gpuAssert((ans), __FILE__, __LINE__);\
+  }}\
+
+static inline void gpuAssert(ze_result_t code, const char *file, int line) {{
+  if (code != ZE_RESULT_SUCCESS) {{
+    printf("Triton Error [ZE]: 0x%x at %s:%d\\n", (unsigned)code, file, line);
+    exit(code);
+  }}
+}}
+
+// globals
+#define SPIRV_NAME {kernel_name}_spirv
+#define NATIVE_NAME {kernel_name}_native
+ze_module_handle_t {kernel_name}_mod = NULL;
+ze_kernel_handle_t {kernel_name}_func = NULL;
+// whether the module has been created for this kernel alone, rather than
+// shared with the other kernels of a bundle
+int {kernel_name}_owns_mod = 0;
+unsigned char SPIRV_NAME[{bin_size}] = {{ {bin_data} }};
+// the binary the SPIR-V has been finalized to for the device it was compiled
+// on, empty if not embedded
+unsigned char NATIVE_NAME[{native_size} + 1] = {{ {native_data} }};
+
+
+void unload_{kernel_name}(void) {{
+    ZE_CHECK(zeKernelDestroy({kernel_name}_func));
+    if ({kernel_name}_owns_mod)
+      ZE_CHECK(zeModuleDestroy({kernel_name}_mod));
+    {kernel_name}_func = NULL;
+    {kernel_name}_mod = NULL;
+}}
+
+static ze_result_t create_module_{kernel_name}(ze_context_handle_t context, ze_device_handle_t device, ze_module_format_t format, const unsigned char *bin, size_t size) {{
+    ze_module_desc_t desc = {{ZE_STRUCTURE_TYPE_MODULE_DESC}};
+    desc.format = format;
+    desc.inputSize = size;
+    desc.pInputModule = bin;
+    desc.pBuildFlags = {build_flags};
+    return zeModuleCreate(context, device, &desc, &{kernel_name}_mod, NULL);
+}}
+
+// Load the kernel `name` from a module it has been linked into, e.g. by
+// `link.py --bundle`.
+void load_{kernel_name}_from_module(ze_module_handle_t module, const char *name) {{
+    {kernel_name}_mod = module;
+    ze_kernel_desc_t kernel_desc = {{ZE_STRUCTURE_TYPE_KERNEL_DESC}};
+    kernel_desc.flags = ZE_KERNEL_FLAG_FORCE_RESIDENCY;
+    kernel_desc.pKernelName = name;
+    ZE_CHECK(zeKernelCreate({kernel_name}_mod, &kernel_desc, &{kernel_name}_func));
+    ZE_CHECK(zeKernelSetGroupSize({kernel_name}_func, {num_warps} * {threads_per_warp}, 1, 1));
+}}
+
+// TODO: some code duplication with `third_party/intel/backend/driver.c`
+void load_{kernel_name}(ze_context_handle_t context, ze_device_handle_t device) {{
+    // The native binary is only valid on the devices and drivers it has been
+    // built for, the SPIR-V is finalized for the device otherwise.
+    if ({native_size} == 0 ||
+        create_module_{kernel_name}(context, device, ZE_MODULE_FORMAT_NATIVE, NATIVE_NAME, {native_size}) != ZE_RESULT_SUCCESS)
+      ZE_CHECK(create_module_{kernel_name}(context, device, ZE_MODULE_FORMAT_IL_SPIRV, SPIRV_NAME, sizeof(SPIRV_NAME)));
+    load_{kernel_name}_from_module({kernel_name}_mod, "{triton_kernel_name}");
+    {kernel_name}_owns_mod = 1;
+}}
+
+/*
+{kernel_docstring}
+*/
+ze_result_t {kernel_name}(ze_command_list_handle_t cmd_list, {signature}) {{
+    if ({kernel_name}_func == NULL)
+       return ZE_RESULT_ERROR_UNINITIALIZED;
+    unsigned int gX = {gridX};
+    unsigned int gY = {gridY};
+    unsigned int gZ = {gridZ};
+    void *args[{num_args}] = {{ {arg_pointers} }};
+    size_t arg_sizes[{num_args}] = {{ {arg_sizes} }};
+    for (uint32_t i = 0; i < {num_args}; ++i) {{
+      ze_result_t result = zeKernelSetArgumentValue({kernel_name}_func, i, arg_sizes[i], args[i]);
+      if (result != ZE_RESULT_SUCCESS)
+        return result;
+    }}
+    // the shared local memory is the last argument of the kernel
+    if ({shared} > 0) {{
+      ze_result_t result = zeKernelSetArgumentValue({kernel_name}_func, {num_args}, {shared}, NULL);
+      if (result != ZE_RESULT_SUCCESS)
+        return result;
+    }}
+    ze_group_count_t group_count = {{gX, gY, gZ}};
+    if (gX * gY * gZ > 0)
+      return zeCommandListAppendLaunchKernel(cmd_list, {kernel_name}_func, &group_count, NULL, 0, NULL);
+    return ZE_RESULT_SUCCESS;
+}}
@@ -26,6 +26,28 @@ class KernelLinkerMeta:
     """ number of specialized arguments """
 
 
+@dataclass(frozen=True)
+class LinkerBackend:
+    """ the API the kernels generated by compile.py are launched through """
+    include: str
+    stream_type: str
+    result_type: str
+    invalid_value: str
+    # parameters of the load functions
+    load_params: str = ""
+    load_args: str = ""
+
+
+CUDA = LinkerBackend("#include <cuda.h>", "CUstream", "CUresult", "CUDA_ERROR_INVALID_VALUE")
+XPU = LinkerBackend("#include <level_zero/ze_api.h>", "ze_command_list_handle_t", "ze_result_t",
+                    "ZE_RESULT_ERROR_INVALID_ARGUMENT", "ze_context_handle_t context, ze_device_handle_t device",
+                    "context, device")
+
+
+def backend_of(header: str) -> LinkerBackend:
+    return XPU if "level_zero/ze_api.h" in header else CUDA
+
+
 class HeaderParser:
 
     def __init__(self) -> None:
@@ -36,7 +58,7 @@ class HeaderParser:
         # [name, hash, suffix]
         self.kernel_name = re.compile("^([\\w]+)_([\\w]+)_([\\w]+)$")
         # [(type, name)]
-        self.c_sig = re.compile("[\\s]*(\\w+)\\s(\\w+)[,]?")
+        self.c_sig = re.compile("[\\s]*(\\w+\\*?)\\s(\\w+)[,]?")
         # [d|c]
         self.arg_suffix = re.compile("[c,d]")
 
@@ -131,40 +153,83 @@ def gen_signature(m):
 
 
 # generate declarations of kernels with meta-parameter and constant values
-def make_algo_decls(name: str, metas: Sequence[KernelLinkerMeta]) -> str:
+def make_algo_decls(name: str, metas: Sequence[KernelLinkerMeta], backend: LinkerBackend = CUDA) -> str:
     return f"""
-CUresult {name}(CUstream stream, {gen_signature_with_full_args(metas[-1])});
-void load_{name}();
+{backend.result_type} {name}({backend.stream_type} stream, {gen_signature_with_full_args(metas[-1])});
+void load_{name}({backend.load_params});
 void unload_{name}();
     """
 
 
 # generate declarations of kernels with meta-parameter and constant values
-def make_global_decl(meta: KernelLinkerMeta) -> str:
+def make_global_decl(meta: KernelLinkerMeta, backend: LinkerBackend = CUDA) -> str:
     return f"""
-CUresult {meta.orig_kernel_name}_default(CUstream stream, {gen_signature_with_full_args(meta)});
-CUresult {meta.orig_kernel_name}(CUstream stream, {gen_signature_with_full_args(meta)}, int algo_id);
-void load_{meta.orig_kernel_name}();
+{backend.result_type} {meta.orig_kernel_name}_default({backend.stream_type} stream, {gen_signature_with_full_args(meta)});
+{backend.result_type} {meta.orig_kernel_name}({backend.stream_type} stream, {gen_signature_with_full_args(meta)}, int algo_id);
+void load_{meta.orig_kernel_name}({backend.load_params});
 void unload_{meta.orig_kernel_name}();
     """
 
 
 # generate dispatcher function for kernels with different meta-parameter and constant values
-def make_default_algo_kernel(meta: KernelLinkerMeta) -> str:
-    src = f"CUresult {meta.orig_kernel_name}_default(CUstream stream, {gen_signature_with_full_args(meta)}){{\n"
+def make_default_algo_kernel(meta: KernelLinkerMeta, backend: LinkerBackend = CUDA) -> str:
+    src = f"{backend.result_type} {meta.orig_kernel_name}_default({backend.stream_type} stream, {gen_signature_with_full_args(meta)}){{\n"
     src += (f"  return {meta.orig_kernel_name}(stream, {', '.join(meta.arg_names)}, 0);\n")
     src += "}\n"
     return src
 
 
+# generate the module the kernels linked by `--bundle` are loaded from
+def make_bundle_def(spirv: bytes) -> str:
+    src = f"static unsigned char bundle_spirv[{len(spirv)}] = {{ {', '.join(f'0x{x:02x}' for x in spirv)} }};\n"
+    src += "static ze_module_handle_t bundle_mod = NULL;\n\n"
+    src += "static ze_module_handle_t get_bundle_module(ze_context_handle_t context, ze_device_handle_t device) {\n"
+    src += "  if (bundle_mod != NULL)\n"
+    src += "    return bundle_mod;\n"
+    src += "  ze_module_desc_t desc = {ZE_STRUCTURE_TYPE_MODULE_DESC};\n"
+    src += "  desc.format = ZE_MODULE_FORMAT_IL_SPIRV;\n"
+    src += "  desc.inputSize = sizeof(bundle_spirv);\n"
+    src += "  desc.pInputModule = bundle_spirv;\n"
+    src += "  desc.pBuildFlags = \"\";\n"
+    src += "  ze_result_t result = zeModuleCreate(context, device, &desc, &bundle_mod, NULL);\n"
+    src += "  if (result != ZE_RESULT_SUCCESS) {\n"
+    src += "    printf(\"Triton Error [ZE]: 0x%x at %s:%d\\n\", (unsigned)result, __FILE__, __LINE__);\n"
+    src += "    exit(result);\n"
+    src += "  }\n"
+    src += "  return bundle_mod;\n"
+    src += "}\n\n"
+    src += "static void destroy_bundle_module(void) {\n"
+    src += "  if (bundle_mod != NULL)\n"
+    src += "    zeModuleDestroy(bundle_mod);\n"
+    src += "  bundle_mod = NULL;\n"
+    src += "}\n"
+    return src
+
+
+def link_bundle(parser: HeaderParser, headers: Sequence[str]) -> bytes:
+    from triton._C.libtriton import llvm
+
+    # the SPIR-V of each kernel is written next to its header by compile.py, its
+    # kernel is renamed after the C function launching it
+    binaries, names = [], []
+    for header in headers:
+        for ln in Path(header).read_text().splitlines():
+            m = parser.linker_directives.match(ln)
+            if _exists(m):
+                binaries.append(Path(header).with_suffix(".spv").read_bytes())
+                names.append(m.group(1))
+    return llvm.link_spirv(binaries, names)
+
+
 # generate dispatcher function for kernels with different integer value hints
-def make_kernel_hints_dispatcher(name: str, metas: Sequence[KernelLinkerMeta]) -> str:
+def make_kernel_hints_dispatcher(name: str, metas: Sequence[KernelLinkerMeta], backend: LinkerBackend = CUDA,
+                                 bundle: bool = False) -> str:
     src = f"// launcher for: {name}\n"
     for meta in sorted(metas, key=lambda m: -m.num_specs):
-        src += f"CUresult {meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}(CUstream stream, {gen_signature(meta)});\n"
+        src += f"{backend.result_type} {meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}({backend.stream_type} stream, {gen_signature(meta)});\n"
     src += "\n"
 
-    src += (f"CUresult {name}(CUstream stream, {gen_signature_with_full_args(metas[-1])}){{")
+    src += (f"{backend.result_type} {name}({backend.stream_type} stream, {gen_signature_with_full_args(metas[-1])}){{")
     src += "\n"
     for meta in sorted(metas, key=lambda m: -m.num_specs):
         cond_fn = (  #
@@ -174,8 +239,9 @@ def make_kernel_hints_dispatcher(name: str, metas: Sequence[KernelLinkerMeta]) -
             if hint == 1  #
             else None)
         conds = " && ".join([  #
-            cond_fn(val, hint)  #
-            for val, hint in zip(meta.arg_names, meta.sizes)  #
+            # pointers are checked through their address
+            cond_fn(f"(uintptr_t){val}" if ty.endswith("*") else val, hint)  #
+            for val, hint, ty in zip(meta.arg_names, meta.sizes, meta.arg_ctypes)  #
             if hint is not None
         ])
         src += (f"  if ({conds})\n" if any(meta.sizes) else "if (1)\n"
@@ -183,24 +249,35 @@ def make_kernel_hints_dispatcher(name: str, metas: Sequence[KernelLinkerMeta]) -
         arg_names = [arg for arg, hint in zip(meta.arg_names, meta.sizes) if hint != 1]
         src += f"    return {meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}(stream, {', '.join(arg_names)});\n"
     src += "\n"
-    src += "  return CUDA_ERROR_INVALID_VALUE;\n"
+    src += f"  return {backend.invalid_value};\n"
     src += "}\n"
 
     for mode in ["load", "unload"]:
+        params = backend.load_params if mode == "load" else ""
+        args = backend.load_args if mode == "load" else ""
         src += f"\n// {mode} for: {name}\n"
         for meta in sorted(metas, key=lambda m: -m.num_specs):
-            src += f"void {mode}_{meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}();\n"
-        src += f"void {mode}_{name}() {{"
+            spec_name = f"{meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}"
+            if bundle and mode == "load":
+                # the bundled kernels are all created from the same module
+                src += f"void load_{spec_name}_from_module(ze_module_handle_t module, const char *name);\n"
+            else:
+                src += f"void {mode}_{spec_name}({params});\n"
+        src += f"void {mode}_{name}({params}) {{"
         src += "\n"
         for meta in sorted(metas, key=lambda m: -m.num_specs):
-            src += (f"  {mode}_{meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}();\n")
+            spec_name = f"{meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}"
+            if bundle and mode == "load":
+                src += f"  load_{spec_name}_from_module(get_bundle_module({args}), \"{spec_name}\");\n"
+            else:
+                src += (f"  {mode}_{spec_name}({args});\n")
         src += "}\n"
     return src
 
 
 # generate dispatcher function for kernels with different meta-parameter and constant values
-def make_kernel_meta_const_dispatcher(meta: KernelLinkerMeta) -> str:
-    src = f"CUresult {meta.orig_kernel_name}(CUstream stream, {gen_signature_with_full_args(meta)}, int algo_id){{\n"
+def make_kernel_meta_const_dispatcher(meta: KernelLinkerMeta, backend: LinkerBackend = CUDA) -> str:
+    src = f"{backend.result_type} {meta.orig_kernel_name}({backend.stream_type} stream, {gen_signature_with_full_args(meta)}, int algo_id){{\n"
     src += f"  assert (algo_id < (int)sizeof({meta.orig_kernel_name}_kernels));\n"
     src += f"  return {meta.orig_kernel_name}_kernels[algo_id](stream, {', '.join(meta.arg_names)});\n"
     src += "}\n"
@@ -208,9 +285,9 @@ def make_kernel_meta_const_dispatcher(meta: KernelLinkerMeta) -> str:
 
 
 # generate definition of function pointers of kernel dispatchers based on meta-parameter and constant values
-def make_func_pointers(names: str, meta: KernelLinkerMeta) -> str:
+def make_func_pointers(names: str, meta: KernelLinkerMeta, backend: LinkerBackend = CUDA) -> str:
     # the table of hint dispatchers
-    src = f"typedef CUresult (*kernel_func_t)(CUstream stream, {gen_signature_with_full_args(meta)});\n"
+    src = f"typedef {backend.result_type} (*kernel_func_t)({backend.stream_type} stream, {gen_signature_with_full_args(meta)});\n"
     src += f"kernel_func_t {meta.orig_kernel_name}_kernels[] = {{\n"
     for name in names:
         src += f"  {name},\n"
@@ -219,12 +296,17 @@ def make_func_pointers(names: str, meta: KernelLinkerMeta) -> str:
 
 
 # generate definition for load/unload functions for kernels with different meta-parameter and constant values
-def make_kernel_load_def(names: str, meta: KernelLinkerMeta) -> str:
+def make_kernel_load_def(names: str, meta: KernelLinkerMeta, backend: LinkerBackend = CUDA,
+                         bundle: bool = False) -> str:
     src = ""
     for mode in ["load", "unload"]:
-        src += f"void {mode}_{meta.orig_kernel_name}(void){{\n"
+        params = (backend.load_params or "void") if mode == "load" else "void"
+        args = backend.load_args if mode == "load" else ""
+        src += f"void {mode}_{meta.orig_kernel_name}({params}){{\n"
         for name in names:
-            src += f"  {mode}_{name}();\n"
+            src += f"  {mode}_{name}({args});\n"
+        if bundle and mode == "unload":
+            src += "  destroy_bundle_module();\n"
         src += "}\n\n"
     return src
 
@@ -250,6 +332,9 @@ kernel given the specializations that were compiled.
 
 Example usage:
 python link.py /path/to/headers/*.h -o kernel_name
+
+On XPU, `--bundle` links the SPIR-V of all the kernels into a single module,
+so that loading them builds one module rather than one per kernel.
 """
 
 if __name__ == "__main__":
@@ -268,25 +353,37 @@ if __name__ == "__main__":
         default="",
         help="String to prefix kernel dispatcher names",
     )
+    parser.add_argument(
+        "--bundle",
+        action="store_true",
+        help="Link the SPIR-V of the kernels into a single module (XPU only)",
+    )
     args = parser.parse_args()
 
     # metadata
     parser = HeaderParser()
     includes = []
+    backends = set()
     for header in args.headers:
         h_path = Path(header)
         h_str = h_path.read_text()
         includes.append(h_path.name)
         parser.extract_linker_meta(h_str)
+        backends.add(backend_of(h_str))
+    if len(backends) != 1:
+        raise LinkerError("kernels compiled for different backends can't be linked together")
+    backend = backends.pop()
+    if args.bundle and backend != XPU:
+        raise LinkerError("only the kernels compiled for XPU can be bundled")
 
     # generate headers
-    algo_decls = [make_algo_decls(name, meta) for name, meta in parser.kernels.items()]
+    algo_decls = [make_algo_decls(name, meta, backend) for name, meta in parser.kernels.items()]
     meta_lists = [meta for name, meta in parser.kernels.items()]
     meta = meta_lists[0][0]
     get_num_algos_decl = make_get_num_algos_decl(meta)
-    global_decl = make_global_decl(meta)
+    global_decl = make_global_decl(meta, backend)
     with args.out.with_suffix(".h").open("w") as fp:
-        out = "#include <cuda.h>\n"
+        out = f"{backend.include}\n"
         out += "\n".join(algo_decls)
         out += "\n"
         out += get_num_algos_decl
@@ -295,19 +392,25 @@ if __name__ == "__main__":
         fp.write(out)
 
     # generate source
-    defs = [make_kernel_hints_dispatcher(name, meta) for name, meta in parser.kernels.items()]
+    defs = [make_kernel_hints_dispatcher(name, meta, backend, args.bundle) for name, meta in parser.kernels.items()]
     names = [name for name in parser.kernels.keys()]
-    func_pointers_def = make_func_pointers(names, meta)
-    meta_const_def = make_kernel_meta_const_dispatcher(meta)
-    load_unload_def = make_kernel_load_def(names, meta)
+    func_pointers_def = make_func_pointers(names, meta, backend)
+    meta_const_def = make_kernel_meta_const_dispatcher(meta, backend)
+    load_unload_def = make_kernel_load_def(names, meta, backend, args.bundle)
     get_num_algos_def = make_get_num_algos_def(meta)
-    default_algo_kernel = make_default_algo_kernel(meta)
+    default_algo_kernel = make_default_algo_kernel(meta, backend)
     with args.out.with_suffix(".c").open("w") as fp:
         out = ""
-        out += "#include <cuda.h>\n"
+        out += f"{backend.include}\n"
         out += "#include <stdint.h>\n"
         out += "#include <assert.h>\n"
         out += "\n"
+        if args.bundle:
+            out += "#include <stdio.h>\n"
+            out += "#include <stdlib.h>\n"
+            out += "\n"
+            out += make_bundle_def(link_bundle(parser, args.headers))
+            out += "\n"
         out += "\n".join(defs)
         out += "\n"
         out += func_pointers_def
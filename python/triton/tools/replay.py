@@ -0,0 +1,144 @@
+"""
+Replay of the kernel launches recorded with `TRITON_RECORD_LAUNCHES=<path>` or
+`triton.runtime.replay.record(path)`, with synthetic tensors of the recorded
+dtypes, shapes, strides and alignments, e.g. to tune the kernels offline on the
+shapes a model runs in production, or to benchmark them for regressions:
+
+    python -m triton.tools.replay launches.log --bench
+
+Each distinct launch, i.e. kernel, arguments, grid and options, is replayed
+once. The floating-point tensors are filled with random values and the other
+ones with zeros, so that the integer tensors used as indices stay in bounds.
+
+The launch options and the meta-parameters that don't change the grid can be
+overridden to compare them on the recorded launches, e.g.
+
+    python -m triton.tools.replay launches.log --bench --set num_warps=8 --set grf_mode='"large"'
+"""
+
+import importlib
+import importlib.util
+import json
+import sys
+from argparse import ArgumentParser
+
+from ..runtime.replay import load
+
+
+def load_kernel(module, qualname, file=None):
+    """Returns the object the kernel `qualname` of `module`, or of the source `file` it was defined in, is bound to."""
+    mod = sys.modules.get(module)
+    if mod is None and module != "__main__":
+        try:
+            mod = importlib.import_module(module)
+        except ImportError:
+            mod = None
+    if (mod is None or module == "__main__") and file is not None:
+        spec = importlib.util.spec_from_file_location(f"_triton_replay_{abs(hash(file))}", file)
+        mod = importlib.util.module_from_spec(spec)
+        spec.loader.exec_module(mod)
+    if mod is None or "<locals>" in qualname:
+        raise ValueError(f"kernel {module}.{qualname} can't be loaded")
+    obj = mod
+    for name in qualname.split("."):
+        obj = getattr(obj, name)
+    return obj
+
+
+def _jit_fn(obj):
+    from ..runtime.jit import JITFunction
+    while not isinstance(obj, JITFunction):
+        obj = obj.fn
+    return obj
+
+
+def make_arg(desc, device="xpu"):
+    """Returns a value matching the description of an argument in the log, with a synthetic tensor for a tensor."""
+    if not isinstance(desc, list):
+        return desc
+    kind = desc[0]
+    if kind == "dtype":
+        from .. import language as tl
+        return tl.dtype(desc[1])
+    if kind != "tensor":
+        raise ValueError(f"argument {desc[1]} can't be replayed")
+    import torch
+    _, dtype, shape, strides, alignment = desc
+    dtype = getattr(torch, dtype)
+    size = 1 + sum((dim - 1) * stride for dim, stride in zip(shape, strides)) if all(shape) else 0
+    itemsize = torch.empty((), dtype=dtype).element_size()
+    # The address of the tensor has the same alignment as the recorded one, as
+    # the kernels are specialized by it.
+    offset = alignment // itemsize if alignment % itemsize == 0 else 0
+    storage = torch.empty(size + offset, dtype=dtype, device=device)
+    if dtype.is_floating_point:
+        storage.normal_()
+    else:
+        storage.zero_()
+    return storage.as_strided(shape, strides, offset)
+
+
+def replay(path, bench=False, kernel=None, overrides=None, device="xpu", rep=100):
+    """
+    Replays the distinct launches of the log at `path`, of the kernels named `kernel` if given, with the arguments or
+    options in `overrides` replaced. With `bench`, the launches are benchmarked and their median time in ms is returned
+    along with them.
+    """
+    import torch
+    from ..testing import do_bench
+    kernels, results, seen = {}, [], set()
+    for record in load(path):
+        if record[0] == "kernel":
+            _, kernel_id, module, qualname, file, _ = record
+            kernels[kernel_id] = (module, qualname, file)
+            continue
+        if record[0] != "launch":
+            continue
+        _, kernel_id, _, grid, args, options = record
+        module, qualname, file = kernels[kernel_id]
+        if kernel is not None and qualname.split(".")[-1] != kernel:
+            continue
+        launch = json.dumps([kernel_id, grid, args, options])
+        if launch in seen:
+            continue
+        seen.add(launch)
+        # The recorded launch is the one of the config the autotuner picked, the
+        # kernel itself is launched.
+        fn = _jit_fn(load_kernel(module, qualname, file))
+        values = [make_arg(arg, device) for arg in args]
+        options = {name: make_arg(value, device) for name, value in options.items()}
+        for name, value in (overrides or {}).items():
+            if name in fn.arg_names:
+                values[fn.arg_names.index(name)] = value
+            else:
+                options[name] = value
+        grid = tuple(grid)
+        fn[grid](*values, **options)
+        result = {"kernel": qualname, "grid": grid, "args": args}
+        if bench:
+            result["ms"] = do_bench(lambda: fn[grid](*values, **options), rep=rep)
+        getattr(torch, device).synchronize()
+        results.append(result)
+    return results
+
+
+def _describe_args(args):
+    return ", ".join(f"{arg[1]}{arg[2]}" if isinstance(arg, list) and arg[0] == "tensor" else str(arg) for arg in args)
+
+
+if __name__ == "__main__":
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("path", help="log of the launches")
+    parser.add_argument("--kernel", "-k", default=None, help="name of the kernel to replay, all of them by default")
+    parser.add_argument("--bench", action="store_true", help="benchmark the launches")
+    parser.add_argument("--set", action="append", default=[], metavar="NAME=VALUE",
+                        help="override an argument or a launch option with a JSON value, e.g. num_warps=8")
+    parser.add_argument("--rep", type=int, default=100, help="repetition time of the benchmarks in ms")
+    parser.add_argument("--device", default="xpu", help="device the tensors are allocated on")
+    args = parser.parse_args()
+    overrides = {name: json.loads(value) for name, value in (override.split("=", 1) for override in args.set)}
+    for result in replay(args.path, args.bench, args.kernel, overrides, args.device, args.rep):
+        line = f"{result['kernel']}[{result['grid']}]({_describe_args(result['args'])})"
+        if "ms" in result:
+            line += f": {result['ms']:.4f} ms"
+        print(line)
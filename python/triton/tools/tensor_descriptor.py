@@ -0,0 +1,43 @@
+class TensorDescriptor:
+    """
+    A 2D tensor of contiguous rows passed to a kernel as one argument, with the
+    shape of the blocks the kernel loads and stores, e.g.
+
+        desc = TensorDescriptor.from_tensor(a, [BLOCK_M, BLOCK_K])
+        kernel[grid](desc, ...)
+
+    and in the kernel:
+
+        a = desc.load([pid_m * BLOCK_M, k])
+
+    The kernel gets the base pointer, the rows, the columns and the pitch of
+    the tensor, in elements, which the launch takes from the tensor once, as
+    the operands of the 2D block IO the blocks are accessed with. The kernels
+    are specialized on the element type and the block shape of the
+    descriptors, and on the alignment of their base like pointers are.
+    """
+
+    def __init__(self, base, shape, strides, block_shape):
+        if len(shape) != 2 or len(strides) != 2 or len(block_shape) != 2:
+            raise ValueError("only 2D tensor descriptors are supported")
+        if strides[1] != 1:
+            raise ValueError(f"the rows of a tensor descriptor must be contiguous, not of stride {strides[1]}")
+        self.base = base
+        self.shape = tuple(int(s) for s in shape)
+        self.strides = tuple(int(s) for s in strides)
+        self.block_shape = tuple(int(s) for s in block_shape)
+
+    @staticmethod
+    def from_tensor(tensor, block_shape):
+        return TensorDescriptor(tensor, tensor.shape, tensor.stride(), block_shape)
+
+    @property
+    def dtype(self):
+        return self.base.dtype
+
+    def data_ptr(self):
+        return self.base.data_ptr()
+
+    def launch_args(self):
+        """The arguments the kernels get for the descriptor."""
+        return (self.base.data_ptr(), self.shape[0], self.shape[1], self.strides[0])
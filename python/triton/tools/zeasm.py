@@ -0,0 +1,301 @@
+"""
+Disassembly of the native binaries (zebin) the Level Zero driver finalizes the
+SPIR-V kernels to, with the open source Intel Graphics Assembler (IGA), and
+the instruction mix of the disassembled kernels.
+"""
+
+import bisect
+import collections
+import functools
+import os
+import re
+import shutil
+import struct
+import subprocess
+import tempfile
+from pathlib import Path
+
+# IGA platform of each `DeviceArch`, see `triton/Dialect/TritonGPU/Transforms/Passes.h`
+IGA_PLATFORMS = {0: "xehpg", 1: "xehpc"}
+
+# [opcode, sub-function], e.g. `dpas.8x8 (16|M0) ...`, `(W) send.ugm (1|M0) ...`
+# or `sync.nop null`
+INST_RE = re.compile(r'^\s*(?:\([^)]*\)\s*)?([a-z]\w*)(?:\.([\w.]+))?(?:\s|$)')
+# the messages accessing the scratch space, i.e. the spills and fills of the
+# registers
+SCRATCH_RE = re.compile(r'\bscratch\b|\.ss\[')
+STORE_RE = re.compile(r'\b(?:store|write)\b')
+
+
+def path_to_iga():
+    paths = [
+        os.environ.get("TRITON_IGA64_PATH", ""),
+        str(Path(__file__).parent.parent / "backends" / "intel" / "bin" / "iga64"),
+        shutil.which("iga64") or "",
+    ]
+    for path in paths:
+        if os.path.isfile(path):
+            return path
+    raise RuntimeError("Cannot find iga64, set TRITON_IGA64_PATH to disassemble the native binaries")
+
+
+def get_sections(zebin):
+    """Return the sections of the ELF `zebin` by name."""
+    if zebin[:4] != b"\x7fELF" or zebin[4] != 2:
+        raise ValueError("not a 64-bit zebin")
+    shoff, = struct.unpack_from("<Q", zebin, 0x28)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", zebin, 0x3a)
+
+    def section(i):
+        # sh_name, sh_offset and sh_size of the i-th section header
+        header = shoff + i * shentsize
+        sh_name, = struct.unpack_from("<I", zebin, header)
+        sh_offset, sh_size = struct.unpack_from("<QQ", zebin, header + 0x18)
+        return sh_name, sh_offset, sh_size
+
+    _, strtab, _ = section(shstrndx)
+    sections = {}
+    for i in range(shnum):
+        sh_name, offset, size = section(i)
+        end = zebin.index(b"\0", strtab + sh_name)
+        sections[zebin[strtab + sh_name:end].decode()] = zebin[offset:offset + size]
+    return sections
+
+
+def extract_kernel(zebin, name):
+    """Return the Gen ISA of the kernel `name` in the ELF `zebin`."""
+    text = get_sections(zebin).get(f".text.{name}")
+    if text is None:
+        raise ValueError(f"no kernel {name} in the zebin")
+    return text
+
+
+@functools.lru_cache()
+def get_zeasm(zebin, name, capability):
+    """
+    Disassemble the kernel `name` of `zebin`, built for the device with the
+    given `DeviceArch`. The text starts with its instruction mix.
+    """
+    if capability not in IGA_PLATFORMS:
+        raise RuntimeError(f"Cannot disassemble the kernels of the device arch {capability}")
+    fd, path = tempfile.mkstemp(suffix=".bin")
+    try:
+        with open(fd, "wb") as f:
+            f.write(extract_kernel(zebin, name))
+        asm = subprocess.check_output([path_to_iga(), "-d", f"-p={IGA_PLATFORMS[capability]}", path]).decode()
+    finally:
+        os.remove(path)
+    summary = "\n".join(f"// {key}: {value}" for key, value in instruction_mix(asm).items())
+    return f"// kernel: {name}\n{summary}\n\n{asm}"
+
+
+def instruction_mix(asm):
+    """
+    Count the instructions of the disassembled kernel `asm`: the DPAS, the
+    messages by shared function (e.g. `send.ugm`), the `sync` instructions the
+    threads stall on and the spills and fills of the registers.
+    """
+    opcodes = collections.Counter()
+    sends = collections.Counter()
+    spills = fills = 0
+    for line in asm.splitlines():
+        m = INST_RE.match(line)
+        if m is None:
+            continue
+        opcode, subfunction = m.group(1), m.group(2) or ""
+        opcodes[opcode] += 1
+        if opcode.startswith("send"):
+            sends[subfunction.split(".")[0]] += 1
+            if SCRATCH_RE.search(line):
+                if STORE_RE.search(line):
+                    spills += 1
+                else:
+                    fills += 1
+    return {
+        "instructions": sum(opcodes.values()),
+        "dpas": opcodes["dpas"] + opcodes["dpasw"],
+        "send": dict(sorted(sends.items())),
+        "sync": opcodes["sync"],
+        "spills": spills,
+        "fills": fills,
+    }
+
+
+class _Reader:
+    """Sequential reads of the little-endian DWARF data `data`."""
+
+    def __init__(self, data, pos=0):
+        self.data = data
+        self.pos = pos
+
+    def fixed(self, fmt):
+        value, = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += struct.calcsize(fmt)
+        return value
+
+    def uleb(self):
+        value = shift = 0
+        while True:
+            byte = self.data[self.pos]
+            self.pos += 1
+            value |= (byte & 0x7f) << shift
+            shift += 7
+            if byte < 0x80:
+                return value
+
+    def sleb(self):
+        value = shift = 0
+        while True:
+            byte = self.data[self.pos]
+            self.pos += 1
+            value |= (byte & 0x7f) << shift
+            shift += 7
+            if byte < 0x80:
+                return value - (1 << shift) if byte & 0x40 else value
+
+    def cstr(self, data=None, pos=None):
+        if data is not None:
+            return data[pos:data.index(b"\0", pos)].decode()
+        end = self.data.index(b"\0", self.pos)
+        value = self.data[self.pos:end].decode()
+        self.pos = end + 1
+        return value
+
+
+def _read_entry_formats(reader, sections, offset_size):
+    # the (content type, value) of the directory and file entries of DWARF 5
+    formats = [(reader.uleb(), reader.uleb()) for _ in range(reader.fixed("<B"))]
+    entries = []
+    for _ in range(reader.uleb()):
+        entry = {}
+        for content, form in formats:
+            if form == 0x08:  # DW_FORM_string
+                value = reader.cstr()
+            elif form in (0x1f, 0x0e):  # DW_FORM_line_strp, DW_FORM_strp
+                strings = sections[".debug_line_str" if form == 0x1f else ".debug_str"]
+                value = reader.cstr(strings, reader.fixed("<I" if offset_size == 4 else "<Q"))
+            elif form == 0x0f:  # DW_FORM_udata
+                value = reader.uleb()
+            elif form in (0x0b, 0x05, 0x06, 0x07):  # DW_FORM_data1/2/4/8
+                value = reader.fixed({0x0b: "<B", 0x05: "<H", 0x06: "<I", 0x07: "<Q"}[form])
+            elif form == 0x1e:  # DW_FORM_data16, e.g. the MD5 of the files
+                reader.pos += 16
+                value = None
+            elif form == 0x09:  # DW_FORM_block
+                reader.pos += reader.uleb()
+                value = None
+            else:
+                raise ValueError(f"unsupported DWARF form {form:#x} in the line table")
+            entry[content] = value
+        entries.append(entry)
+    return entries
+
+
+def _line_programs(debug_line, sections):
+    # the (address, file, line) rows of the line number programs of
+    # `debug_line`, DWARF 2 to 5
+    reader = _Reader(debug_line)
+    while reader.pos < len(debug_line):
+        offset_size = 4
+        unit_length = reader.fixed("<I")
+        if unit_length == 0xffffffff:
+            offset_size = 8
+            unit_length = reader.fixed("<Q")
+        unit_end = reader.pos + unit_length
+        version = reader.fixed("<H")
+        if version >= 5:
+            reader.pos += 2  # address_size, segment_selector_size
+        header_length = reader.fixed("<I" if offset_size == 4 else "<Q")
+        program = reader.pos + header_length
+        min_inst_length = reader.fixed("<B")
+        if version >= 4:
+            reader.pos += 1  # maximum_operations_per_instruction
+        reader.pos += 1  # default_is_stmt
+        line_base = reader.fixed("<b")
+        line_range = reader.fixed("<B")
+        opcode_base = reader.fixed("<B")
+        opcode_lengths = [reader.fixed("<B") for _ in range(opcode_base - 1)]
+        if version >= 5:
+            dirs = [entry.get(1, "") for entry in _read_entry_formats(reader, sections, offset_size)]
+            files = [os.path.join(dirs[entry.get(2, 0)] if dirs else "", entry.get(1, ""))
+                     for entry in _read_entry_formats(reader, sections, offset_size)]
+        else:
+            dirs = [""]
+            while reader.data[reader.pos]:
+                dirs.append(reader.cstr())
+            reader.pos += 1
+            # the files are numbered from 1 before DWARF 5
+            files = [""]
+            while reader.data[reader.pos]:
+                name = reader.cstr()
+                directory = reader.uleb()
+                reader.uleb(), reader.uleb()  # mtime, length
+                files.append(os.path.join(dirs[directory], name))
+            reader.pos += 1
+
+        reader.pos = program
+        address, file, line = 0, 1, 1
+        while reader.pos < unit_end:
+            opcode = reader.fixed("<B")
+            if opcode >= opcode_base:
+                adjusted = opcode - opcode_base
+                address += adjusted // line_range * min_inst_length
+                line += line_base + adjusted % line_range
+                yield address, files[file], line
+            elif opcode == 0:
+                length = reader.uleb()
+                end = reader.pos + length
+                sub_opcode = reader.fixed("<B")
+                if sub_opcode == 1:  # DW_LNE_end_sequence
+                    address, file, line = 0, 1, 1
+                elif sub_opcode == 2:  # DW_LNE_set_address
+                    address = int.from_bytes(reader.data[reader.pos:end], "little")
+                reader.pos = end
+            elif opcode == 1:  # DW_LNS_copy
+                yield address, files[file], line
+            elif opcode == 2:  # DW_LNS_advance_pc
+                address += reader.uleb() * min_inst_length
+            elif opcode == 3:  # DW_LNS_advance_line
+                line += reader.sleb()
+            elif opcode == 4:  # DW_LNS_set_file
+                file = reader.uleb()
+            elif opcode == 8:  # DW_LNS_const_add_pc
+                address += (255 - opcode_base) // line_range * min_inst_length
+            elif opcode == 9:  # DW_LNS_fixed_advance_pc
+                address += reader.fixed("<H")
+            else:
+                for _ in range(opcode_lengths[opcode - 1]):
+                    reader.uleb()
+        reader.pos = unit_end
+
+
+def get_line_table(zebin):
+    """
+    The line table of the native binary `zebin` built with debug info: the
+    source files and the rows [offset, file index, line] sorted by offset, an
+    offset in the Gen ISA of the kernel starting the instructions of the line
+    of the row up to the next row. None if the zebin has no line table.
+    """
+    sections = get_sections(zebin)
+    if ".debug_line" not in sections:
+        return None
+    files, rows = [], []
+    file_ids = {}
+    for address, file, line in sorted(_line_programs(sections[".debug_line"], sections)):
+        file_id = file_ids.setdefault(file, len(file_ids))
+        if file_id == len(files):
+            files.append(file)
+        # the rows of the same line are merged
+        if rows and rows[-1][1:] == [file_id, line]:
+            continue
+        rows.append([address, file_id, line])
+    return {"files": files, "rows": rows}
+
+
+def source_line(table, offset):
+    """The (file, line) the instruction at `offset` in the Gen ISA comes from by the line table `table`, or None."""
+    i = bisect.bisect_right(table["rows"], [offset, float("inf")]) - 1
+    if i < 0:
+        return None
+    _, file_id, line = table["rows"][i]
+    return table["files"][file_id], line
@@ -653,3 +653,63 @@ tt.func @tensor_ptr(%arg0: !tt.ptr<tensor<64x16xi32>, 1>) {
     !tt.ptr<tensor<64x16xi32>, 1> -> tensor<64x16xi32>
   tt.return
 }
+
+// -----
+
+module {
+
+// CHECK-LABEL: @mul16
+tt.func private @mul16(%arg0: i32) -> i32 attributes {noinline = true} {
+  // CHECK: contiguity = [1], divisibility = [16], constancy = [1], constant_value = 16
+  %cst16 = arith.constant 16 : i32
+  // CHECK-NEXT: contiguity = [1], divisibility = [64], constancy = [1], constant_value = <none>
+  %0 = arith.muli %arg0, %cst16 : i32
+  tt.return %0 : i32
+}
+
+// CHECK-LABEL: @call_result
+tt.func @call_result(%arg0: i32 {tt.divisibility = 4 : i32}) {
+  // The result of the call is the value returned by the callee.
+  // CHECK: contiguity = [1], divisibility = [64], constancy = [1], constant_value = <none>
+  %0 = tt.call @mul16(%arg0) : (i32) -> i32
+  tt.return
+}
+
+}
+
+// -----
+
+// CHECK-LABEL: @for_if_ptr
+tt.func @for_if_ptr(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %cond: i1) {
+  // CHECK: contiguity = [1], divisibility = [4611686018427387904], constancy = [1], constant_value = 0
+  %lb = arith.constant 0 : index
+  // CHECK-NEXT: contiguity = [1], divisibility = [128], constancy = [1], constant_value = 128
+  %ub = arith.constant 128 : index
+  // CHECK-NEXT: contiguity = [1], divisibility = [16], constancy = [1], constant_value = 16
+  %step = arith.constant 16 : index
+  // CHECK-NEXT: contiguity = [1], divisibility = [64], constancy = [64], constant_value = 64
+  %cst = arith.constant dense<64> : tensor<64xi32>
+  // CHECK-NEXT: contiguity = [64], divisibility = [1073741824], constancy = [1], constant_value = <none>
+  %range = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+  // CHECK-NEXT: contiguity = [1], divisibility = [16], constancy = [64], constant_value = <none>
+  %ptrs = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<64x!tt.ptr<f32>>
+  // CHECK-NEXT: contiguity = [64], divisibility = [16], constancy = [1], constant_value = <none>
+  %p0 = tt.addptr %ptrs, %range : tensor<64x!tt.ptr<f32>>, tensor<64xi32>
+  // The pointers incremented in the loop, through the results of an scf.if,
+  // keep their contiguity.
+  // CHECK-NEXT: contiguity = [64], divisibility = [16], constancy = [1], constant_value = <none>
+  // CHECK-NEXT: contiguity = [64], divisibility = [16], constancy = [1], constant_value = <none>
+  // CHECK-NEXT: contiguity = [64], divisibility = [16], constancy = [1], constant_value = <none>
+  // CHECK-NEXT: contiguity = [64], divisibility = [16], constancy = [1], constant_value = <none>
+  %r = scf.for %iv = %lb to %ub step %step iter_args(%p = %p0) -> (tensor<64x!tt.ptr<f32>>) {
+    %q = scf.if %cond -> (tensor<64x!tt.ptr<f32>>) {
+      %a = tt.addptr %p, %cst : tensor<64x!tt.ptr<f32>>, tensor<64xi32>
+      scf.yield %a : tensor<64x!tt.ptr<f32>>
+    } else {
+      scf.yield %p : tensor<64x!tt.ptr<f32>>
+    }
+    %n = tt.addptr %q, %cst : tensor<64x!tt.ptr<f32>>, tensor<64xi32>
+    scf.yield %n : tensor<64x!tt.ptr<f32>>
+  }
+  tt.return
+}
@@ -581,3 +581,53 @@ tt.func @call_graph_2(%A : !tt.ptr<f16>, %cond : i1) {
 }
 
 }
+
+// -----
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#A_SHARED = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.max-shared-mem" = 65536 : i32} {
+
+// The buffers are packed by size when the shared memory of the device is
+// known: %cst_2 and %cst share the bottom of the memory, %cst_3 goes right above
+// %cst_2, and the peak goes down from 512 to 416 bytes.
+// CHECK-LABEL: compact
+tt.func @compact() {
+  // CHECK: offset = 0, size = 128
+  %cst = arith.constant dense<0.000000e+00> : tensor<16x4xf16, #A_SHARED>
+  // CHECK-NEXT: offset = 256, size = 128
+  %cst_0 = arith.constant dense<0.000000e+00> : tensor<16x4xf16, #A_SHARED>
+  %0 = triton_gpu.convert_layout %cst : (tensor<16x4xf16, #A_SHARED>) -> tensor<16x4xf16, #AL>
+  // CHECK-NEXT: offset = 384, size = 32
+  %cst_1 = arith.constant dense<0.000000e+00> : tensor<4x4xf16, #A_SHARED>
+  // CHECK-NEXT: offset = 0, size = 256
+  %cst_2 = arith.constant dense<0.000000e+00> : tensor<4x32xf16, #A_SHARED>
+  %1 = triton_gpu.convert_layout %cst_1 : (tensor<4x4xf16, #A_SHARED>) -> tensor<4x4xf16, #AL>
+  %2 = triton_gpu.convert_layout %cst_0 : (tensor<16x4xf16, #A_SHARED>) -> tensor<16x4xf16, #AL>
+  %3 = triton_gpu.convert_layout %cst_1 : (tensor<4x4xf16, #A_SHARED>) -> tensor<4x4xf16, #AL>
+  // CHECK-NEXT: offset = 256, size = 32
+  %cst_3 = arith.constant dense<0.000000e+00> : tensor<4x4xf16, #A_SHARED>
+  %4 = triton_gpu.convert_layout %cst_2 : (tensor<4x32xf16, #A_SHARED>) -> tensor<4x32xf16, #AL>
+  tt.return
+  // CHECK-NEXT: size = 416
+}
+
+// The scratch buffer of the conversion overlays %cst, which is dead by then,
+// rather than going above %cst_0.
+// CHECK-LABEL: compact_scratch
+tt.func @compact_scratch() {
+  // CHECK: offset = 0, size = 2048
+  %cst = arith.constant dense<0.000000e+00> : tensor<32x32xf16, #A_SHARED>
+  // CHECK-NEXT: offset = 2048, size = 512
+  %cst_0 = arith.constant dense<0.000000e+00> : tensor<16x16xf16, #A_SHARED>
+  %0 = triton_gpu.convert_layout %cst : (tensor<32x32xf16, #A_SHARED>) -> tensor<32x32xf16, #AL>
+  %cst_1 = arith.constant dense<0.000000e+00> : tensor<16x32xf16, #AL>
+  // CHECK-NEXT: scratch offset = 0, size = 1152
+  %1 = triton_gpu.convert_layout %cst_1 : (tensor<16x32xf16, #AL>) -> tensor<16x32xf16, #AL>
+  %2 = triton_gpu.convert_layout %cst_0 : (tensor<16x16xf16, #A_SHARED>) -> tensor<16x16xf16, #AL>
+  tt.return
+  // CHECK-NEXT: size = 2560
+}
+
+}
@@ -0,0 +1,78 @@
+// RUN: triton-opt %s -split-input-file --mlir-disable-threading --convert-scf-to-cf -test-print-membar=sub-group-barriers=true 2>&1 | FileCheck %s
+// RUN: triton-opt %s -split-input-file --mlir-disable-threading --convert-scf-to-cf -test-print-membar="sub-group-barriers=true split-barriers=true" 2>&1 | FileCheck %s --check-prefix=SPLIT
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [1, 4], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [1, 4], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+
+// CHECK-LABEL: sub_group_local
+// COM: Each warp reads back the columns it has written.
+tt.func @sub_group_local(%arg0: tensor<32x64xf16, #blocked>) {
+  // CHECK: triton_gpu.convert_layout
+  // CHECK-NEXT: gpu.barrier {sub_group}
+  // CHECK-NEXT: triton_gpu.convert_layout
+  %0 = triton_gpu.convert_layout %arg0 : (tensor<32x64xf16, #blocked>) -> tensor<32x64xf16, #shared>
+  %1 = triton_gpu.convert_layout %0 : (tensor<32x64xf16, #shared>) -> tensor<32x64xf16, #dot1>
+  tt.return
+}
+
+// CHECK-LABEL: sub_group_shared
+// COM: The A operand is replicated across the warps, which read the rows
+// COM: written by the others.
+tt.func @sub_group_shared(%arg0: tensor<64x64xf16, #blocked>) {
+  // CHECK: triton_gpu.convert_layout
+  // CHECK-NEXT: gpu.barrier{{$}}
+  // CHECK-NEXT: triton_gpu.convert_layout
+  %0 = triton_gpu.convert_layout %arg0 : (tensor<64x64xf16, #blocked>) -> tensor<64x64xf16, #shared>
+  %1 = triton_gpu.convert_layout %0 : (tensor<64x64xf16, #shared>) -> tensor<64x64xf16, #dot0>
+  tt.return
+}
+
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [1, 4], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [1, 4], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+
+// SPLIT-LABEL: split_barrier
+// COM: The work-group arrives once the rows are written and only waits before
+// COM: reading them, the computation in between isn't synchronized.
+tt.func @split_barrier(%arg0: tensor<64x64xf16, #blocked>, %arg1: tensor<64x64xf32, #blocked>) {
+  // SPLIT: triton_gpu.convert_layout
+  // SPLIT-NEXT: arith.constant 0 : i32
+  // SPLIT-NEXT: arith.constant 64 : i32
+  // SPLIT-NEXT: triton_nvidia_gpu.bar_arrive
+  // SPLIT-NEXT: arith.mulf
+  // SPLIT-NEXT: arith.addf
+  // SPLIT-NEXT: triton_nvidia_gpu.bar_wait
+  // SPLIT-NEXT: triton_gpu.convert_layout
+  %0 = triton_gpu.convert_layout %arg0 : (tensor<64x64xf16, #blocked>) -> tensor<64x64xf16, #shared>
+  %1 = arith.mulf %arg1, %arg1 : tensor<64x64xf32, #blocked>
+  %2 = arith.addf %1, %arg1 : tensor<64x64xf32, #blocked>
+  %3 = triton_gpu.convert_layout %0 : (tensor<64x64xf16, #shared>) -> tensor<64x64xf16, #dot0>
+  tt.return
+}
+
+// SPLIT-LABEL: arrive_wait
+// COM: The accesses before an arrive are ordered by the following wait.
+tt.func @arrive_wait(%arg0: tensor<64x64xf16, #blocked>, %bar: i32, %num_threads: i32) {
+  // SPLIT: triton_nvidia_gpu.bar_wait
+  // SPLIT-NEXT: triton_gpu.convert_layout
+  // SPLIT-NOT: gpu.barrier
+  %0 = triton_gpu.convert_layout %arg0 : (tensor<64x64xf16, #blocked>) -> tensor<64x64xf16, #shared>
+  triton_nvidia_gpu.bar_arrive %bar, %num_threads : i32, i32
+  triton_nvidia_gpu.bar_wait %bar, %num_threads : i32, i32
+  %1 = triton_gpu.convert_layout %0 : (tensor<64x64xf16, #shared>) -> tensor<64x64xf16, #dot0>
+  tt.return
+}
+
+}
@@ -636,3 +636,30 @@ tt.func @call_graph_2(%A : !tt.ptr<f16>, %cond : i1) {
 }
 
 }
+
+// -----
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#LOCAL = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32} {
+
+// CHECK-LABEL: local_buffer
+tt.func @local_buffer(%value : tensor<16x16xf16, #AL>, %offsets : tensor<16x16xi32, #AL>) {
+  %0 = triton_gpu.alloc_tensor : tensor<16x16xf16, #LOCAL>
+  // CHECK-NOT: gpu.barrier
+  // CHECK: tt.local_store
+  tt.local_store %0, %value : tensor<16x16xf16, #LOCAL>, tensor<16x16xf16, #AL>
+  // CHECK-NEXT: gpu.barrier
+  // CHECK-NEXT: tt.local_load
+  %1 = tt.local_load %0[%offsets] : tensor<16x16xf16, #LOCAL>, tensor<16x16xi32, #AL> -> tensor<16x16xf16, #AL>
+  // CHECK-NOT: gpu.barrier
+  // CHECK-NEXT: tt.local_load
+  %2 = tt.local_load %0 : tensor<16x16xf16, #LOCAL> -> tensor<16x16xf16, #AL>
+  // CHECK-NEXT: gpu.barrier
+  // CHECK-NEXT: tt.local_store
+  tt.local_store %0[%offsets], %1 : tensor<16x16xf16, #LOCAL>, tensor<16x16xf16, #AL>, tensor<16x16xi32, #AL>
+  tt.return
+}
+
+}
@@ -0,0 +1,85 @@
+// RUN: triton-opt %s -split-input-file --allocate-shared-memory="target=genx" --convert-triton-gpu-to-llvm="target=genx" | FileCheck %s --check-prefixes=CHECK,SLM --implicit-check-not=llvm.store --implicit-check-not=llvm.load
+// RUN: triton-opt %s -split-input-file --allocate-shared-memory="target=genx" --convert-triton-gpu-to-llvm="target=genx" | FileCheck %s --check-prefixes=CHECK,BARRIER --implicit-check-not=genx.barrier
+// RUN: triton-opt %s -split-input-file --allocate-shared-memory="target=genx" --convert-triton-gpu-to-llvm="target=genx" | FileCheck %s --check-prefixes=CHECK,SHUFFLE --implicit-check-not=genx.sub_group_shuffle
+// RUN: triton-opt %s -split-input-file --allocate-shared-memory="target=genx" --convert-triton-gpu-to-llvm="target=genx" | FileCheck %s --check-prefixes=CHECK,DPAS --implicit-check-not=genx.matrix.dpas
+
+// COM: Code quality checks of the lowering of the layout conversions and of
+// COM: the DPAS. Each RUN line counts one category of instructions: the SLM
+// COM: loads and stores, the barriers, the sub-group shuffles and the DPAS.
+// COM: The implicit checks make any instruction of the category that isn't
+// COM: counted below fail the test, so update the counts along with the
+// COM: lowering when it emits fewer instructions.
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [8, 4], warpsPerCTA = [1, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [4, 1], threadsPerWarp = [4, 8], warpsPerCTA = [1, 1], order = [0, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: convert_layout_transpose
+  tt.func @convert_layout_transpose(%arg0: tensor<16x16xf32, #blocked0>) {
+    // SLM-COUNT-8: llvm.store
+    // BARRIER: genx.barrier
+    // SLM-COUNT-8: llvm.load
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<16x16xf32, #blocked0>) -> tensor<16x16xf32, #blocked1>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [8, 4], warpsPerCTA = [1, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [16, 2], warpsPerCTA = [1, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: convert_layout_vec
+  tt.func @convert_layout_vec(%arg0: tensor<16x16xf32, #blocked0>) {
+    // COM: The elements are stored and loaded 4 at a time.
+    // SLM-COUNT-2: llvm.store
+    // BARRIER: genx.barrier
+    // SLM-COUNT-2: llvm.load
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<16x16xf32, #blocked0>) -> tensor<16x16xf32, #blocked1>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [8, 4], warpsPerCTA = [1, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [1, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: convert_layout_intra_warp
+  tt.func @convert_layout_intra_warp(%arg0: tensor<16x16xf32, #blocked0>) {
+    // COM: The elements are exchanged between the lanes of the warp, without
+    // COM: SLM nor barrier.
+    // SHUFFLE-COUNT-16: genx.sub_group_shuffle
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<16x16xf32, #blocked0>) -> tensor<16x16xf32, #blocked1>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount=8, warpsPerCTA=[1,1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx=0, parent=#dpas}>
+#dot_operand_b = #triton_gpu.dot_op<{opIdx=1, parent=#dpas}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: dot_f16_16x16x16
+  tt.func @dot_f16_16x16x16(%a: tensor<16x16xf16, #dot_operand_a>, %b: tensor<16x16xf16, #dot_operand_b>, %c: tensor<16x16xf32, #dpas>) {
+    // COM: 2 repetitions along M.
+    // DPAS-COUNT-2: genx.matrix.dpas
+    %0 = tt.dot %a, %b, %c {allowTF32 = true, maxNumImpreciseAcc = 0 : i32, transA = false, transB = false} : tensor<16x16xf16, #dot_operand_a> * tensor<16x16xf16, #dot_operand_b> -> tensor<16x16xf32, #dpas>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount=8, warpsPerCTA=[1,1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx=0, parent=#dpas}>
+#dot_operand_b = #triton_gpu.dot_op<{opIdx=1, parent=#dpas}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: dot_f16_32x32x32
+  tt.func @dot_f16_32x32x32(%a: tensor<32x32xf16, #dot_operand_a>, %b: tensor<32x32xf16, #dot_operand_b>, %c: tensor<32x32xf32, #dpas>) {
+    // COM: 4 repetitions along M, 2 along N and 2 along K.
+    // DPAS-COUNT-16: genx.matrix.dpas
+    %0 = tt.dot %a, %b, %c {allowTF32 = true, maxNumImpreciseAcc = 0 : i32, transA = false, transB = false} : tensor<32x32xf16, #dot_operand_a> * tensor<32x32xf16, #dot_operand_b> -> tensor<32x32xf32, #dpas>
+    tt.return
+  }
+}
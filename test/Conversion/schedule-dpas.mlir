@@ -0,0 +1,49 @@
+// RUN: triton-opt %s -split-input-file -schedule-dpas | FileCheck %s
+
+// COM: The loads of the next operands are spread between the DPAS, with the
+// COM: address computations they depend on.
+// CHECK-LABEL: llvm.func @interleave
+// CHECK: genx.matrix.dpas
+// CHECK-NEXT: llvm.getelementptr
+// CHECK-NEXT: llvm.load
+// CHECK-NEXT: genx.matrix.dpas
+// CHECK-NEXT: llvm.getelementptr
+// CHECK-NEXT: llvm.load
+// CHECK-NEXT: genx.matrix.dpas
+// CHECK-NEXT: genx.matrix.dpas
+// CHECK-NEXT: llvm.mlir.undef
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  llvm.func @interleave(%c: vector<8xf32>, %a: vector<8xf16>, %b: vector<16xf16>, %ptr: !llvm.ptr<1>) -> !llvm.struct<(vector<8xf32>, vector<8xf16>, vector<16xf16>)> {
+    %0 = genx.matrix.dpas %c, %a, %b {pa = #genx.precision_type<FP16>, pb = #genx.precision_type<FP16>, rc = 8 : i32} : (vector<8xf32>, vector<8xf16>, vector<16xf16>) -> vector<8xf32>
+    %1 = genx.matrix.dpas %0, %a, %b {pa = #genx.precision_type<FP16>, pb = #genx.precision_type<FP16>, rc = 8 : i32} : (vector<8xf32>, vector<8xf16>, vector<16xf16>) -> vector<8xf32>
+    %2 = genx.matrix.dpas %1, %a, %b {pa = #genx.precision_type<FP16>, pb = #genx.precision_type<FP16>, rc = 8 : i32} : (vector<8xf32>, vector<8xf16>, vector<16xf16>) -> vector<8xf32>
+    %3 = genx.matrix.dpas %2, %a, %b {pa = #genx.precision_type<FP16>, pb = #genx.precision_type<FP16>, rc = 8 : i32} : (vector<8xf32>, vector<8xf16>, vector<16xf16>) -> vector<8xf32>
+    %4 = llvm.getelementptr %ptr[16] : (!llvm.ptr<1>) -> !llvm.ptr<1>, f16
+    %5 = llvm.load %4 : !llvm.ptr<1> -> vector<8xf16>
+    %6 = llvm.getelementptr %ptr[32] : (!llvm.ptr<1>) -> !llvm.ptr<1>, f16
+    %7 = llvm.load %6 : !llvm.ptr<1> -> vector<16xf16>
+    %8 = llvm.mlir.undef : !llvm.struct<(vector<8xf32>, vector<8xf16>, vector<16xf16>)>
+    %9 = llvm.insertvalue %3, %8[0] : !llvm.struct<(vector<8xf32>, vector<8xf16>, vector<16xf16>)>
+    %10 = llvm.insertvalue %5, %9[1] : !llvm.struct<(vector<8xf32>, vector<8xf16>, vector<16xf16>)>
+    %11 = llvm.insertvalue %7, %10[2] : !llvm.struct<(vector<8xf32>, vector<8xf16>, vector<16xf16>)>
+    llvm.return %11 : !llvm.struct<(vector<8xf32>, vector<8xf16>, vector<16xf16>)>
+  }
+}
+
+// -----
+
+// COM: Nothing is moved across a store.
+// CHECK-LABEL: llvm.func @store
+// CHECK: genx.matrix.dpas
+// CHECK-NEXT: genx.matrix.dpas
+// CHECK-NEXT: llvm.store
+// CHECK-NEXT: llvm.load
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  llvm.func @store(%c: vector<8xf32>, %a: vector<8xf16>, %b: vector<16xf16>, %ptr: !llvm.ptr<1>) -> vector<8xf16> {
+    %0 = genx.matrix.dpas %c, %a, %b {pa = #genx.precision_type<FP16>, pb = #genx.precision_type<FP16>, rc = 8 : i32} : (vector<8xf32>, vector<8xf16>, vector<16xf16>) -> vector<8xf32>
+    %1 = genx.matrix.dpas %0, %a, %b {pa = #genx.precision_type<FP16>, pb = #genx.precision_type<FP16>, rc = 8 : i32} : (vector<8xf32>, vector<8xf16>, vector<16xf16>) -> vector<8xf32>
+    llvm.store %1, %ptr : vector<8xf32>, !llvm.ptr<1>
+    %2 = llvm.load %ptr : !llvm.ptr<1> -> vector<8xf16>
+    llvm.return %2 : vector<8xf16>
+  }
+}
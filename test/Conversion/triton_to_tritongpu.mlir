@@ -87,3 +87,17 @@ tt.func public @select_op(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg
   tt.store %6, %4 {cache = 1 : i32, evict = 1 : i32} : tensor<128xf32>
   tt.return
 }
+
+// -----
+
+tt.func @dot_int4(%a: tensor<128x64xf16>, %b: tensor<32x128xi8>) {
+  // CHECK-LABEL: dot_int4
+  // COM: The packed operand is unpacked in the layout of the dot operand.
+  // CHECK: %[[B:.*]] = triton_gpu.convert_layout %{{.*}} -> tensor<32x128xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #[[BLOCKED:.*]]}>>
+  // CHECK: %[[UNPACKED:.*]] = tt.unpack_int4 %[[B]] {is_signed = false} : tensor<32x128xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #[[BLOCKED]]}>> -> tensor<64x128xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[BLOCKED]]}>>
+  // CHECK: tt.dot %{{.*}}, %[[UNPACKED]], %{{.*}}
+  %c = arith.constant dense<0.00e+00> : tensor<128x128xf32>
+  %unpacked = tt.unpack_int4 %b {is_signed = false} : tensor<32x128xi8> -> tensor<64x128xf16>
+  %0 = tt.dot %a, %unpacked, %c {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<128x64xf16> * tensor<64x128xf16> -> tensor<128x128xf32>
+  tt.return
+}
@@ -12,6 +12,18 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
 
 // -----
 
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK: llvm.func @test_empty_kernel_sub_group_16(%arg0: i64, %arg1: !llvm.ptr<1>)
+  // Here the 64 comes from the 4 in module attribute multiples 16
+  // CHECK-SAME: attributes {genx.intel_reqd_sub_group_size = [16 : i32], genx.kernel = 1 : i32, genx.max_work_group_size = [64 : i32, 1 : i32, 1 : i32]} {
+  tt.func @test_empty_kernel_sub_group_16(%lb : index, %A : !tt.ptr<f16>) {
+    // CHECK:  llvm.return
+    tt.return
+  }
+} // end module
+
+// -----
+
 #blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
   // CHECK-LABEL: basic_load
@@ -25,21 +37,23 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
     // CHECK-NEXT: [[CST_0:%.*]] = llvm.mlir.constant(0 : index) : i32
     // CHECK-NEXT: [[IE1:%.*]] = llvm.insertelement [[ARG2_0]], [[VEC]][[[CST_0]] : i32] : vector<1xf32>
     // CHECK-NEXT: [[BCAST0:%.*]] = llvm.bitcast {{.*}} : vector<1xf32> to i32
-    // CHECK:      llvm.cond_br [[ARG1_0]], ^bb1, ^bb2([[BCAST0]] : i32)
-    // CHECK-NEXT: ^bb1:
-    // CHECK-NEXT:   [[BCAST1:%.*]] = llvm.bitcast [[ARG0_0]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   [[LOAD1:%.*]] = llvm.load [[BCAST1]] : !llvm.ptr<1> -> i32
-    // CHECK-NEXT:   llvm.br ^bb2([[LOAD1]] : i32)
-    // CHECK-NEXT: ^bb2([[V1:%.*]]: i32):
+    // CHECK:        [[BCAST1:%.*]] = llvm.bitcast [[ARG0_0]] : !llvm.ptr<1> to !llvm.ptr<1>
+    // CHECK-NEXT:   [[PASS1:%.*]] = llvm.bitcast [[BCAST0]] : i32 to vector<1xi32>
+    // CHECK-NEXT:   [[MASK1:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[ZERO1:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT: [[MASK1_0:%.*]] = llvm.insertelement [[ARG1_0]], [[MASK1]][[[ZERO1]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   [[LOAD1:%.*]] = llvm.intr.masked.load [[BCAST1]], [[MASK1_0]], [[PASS1]] {alignment = 4 : i32} : (!llvm.ptr<1>, vector<1xi1>, vector<1xi32>) -> vector<1xi32>
+    // CHECK-NEXT:   [[V1:%.*]] = llvm.bitcast [[LOAD1]] : vector<1xi32> to i32
     // CHECK-NEXT:   [[BCAST_V1:%.*]] = llvm.bitcast [[V1]] : i32 to vector<1xf32>
     // CHECK:        [[EE1:%.*]] = llvm.extractelement [[BCAST_V1]][{{.*}} : i32] : vector<1xf32>
     // CHECK:        [[BCAST2:%.*]] = llvm.bitcast {{.*}} : vector<1xf32> to i32
-    // CHECK:        llvm.cond_br [[ARG1_1]], ^bb3, ^bb4([[BCAST2]] : i32)
-    // CHECK-NEXT: ^bb3:
-    // CHECK-NEXT:   [[BCAST3:%.*]] = llvm.bitcast [[ARG0_1]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   [[LOAD2:%.*]] = llvm.load [[BCAST3]] : !llvm.ptr<1> -> i32
-    // CHECK-NEXT:   llvm.br ^bb4([[LOAD2]] : i32)
-    // CHECK-NEXT: ^bb4([[V2:%.*]]: i32):
+    // CHECK:        [[BCAST3:%.*]] = llvm.bitcast [[ARG0_1]] : !llvm.ptr<1> to !llvm.ptr<1>
+    // CHECK-NEXT:   [[PASS2:%.*]] = llvm.bitcast [[BCAST2]] : i32 to vector<1xi32>
+    // CHECK-NEXT:   [[MASK2:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[ZERO2:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK2_0:%.*]] = llvm.insertelement [[ARG1_1]], [[MASK2]][[[ZERO2]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   [[LOAD2:%.*]] = llvm.intr.masked.load [[BCAST3]], [[MASK2_0]], [[PASS2]] {alignment = 4 : i32} : (!llvm.ptr<1>, vector<1xi1>, vector<1xi32>) -> vector<1xi32>
+    // CHECK-NEXT:   [[V2:%.*]] = llvm.bitcast [[LOAD2]] : vector<1xi32> to i32
     // CHECK-NEXT:   [[BCAST_V2:%.*]] = llvm.bitcast [[V2]] : i32 to vector<1xf32>
     // CHECK:        [[EE2:%.*]] = llvm.extractelement [[BCAST_V2]][{{.*}} : i32] : vector<1xf32>
     // CHECK-NEXT:   [[RES1:%.*]] = llvm.mlir.undef : !llvm.struct<(f32, f32)>
@@ -65,21 +79,23 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
     // CHECK-NEXT: [[CST_0:%.*]] = llvm.mlir.constant(0 : index) : i32
     // CHECK-NEXT: [[IE1:%.*]] = llvm.insertelement [[ARG2_0]], [[VEC]][[[CST_0]] : i32] : vector<1xf32>
     // CHECK-NEXT: [[BCAST0:%.*]] = llvm.bitcast {{.*}} : vector<1xf32> to i32
-    // CHECK:      llvm.cond_br [[ARG1_0]], ^bb1, ^bb2([[BCAST0]] : i32)
-    // CHECK-NEXT: ^bb1:
-    // CHECK-NEXT:   [[BCAST1:%.*]] = llvm.bitcast [[ARG0_0]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   [[LOAD1:%.*]] = llvm.load [[BCAST1]] : !llvm.ptr<1> -> i32
-    // CHECK-NEXT:   llvm.br ^bb2([[LOAD1]] : i32)
-    // CHECK-NEXT: ^bb2([[V1:%.*]]: i32):
+    // CHECK:        [[BCAST1:%.*]] = llvm.bitcast [[ARG0_0]] : !llvm.ptr<1> to !llvm.ptr<1>
+    // CHECK-NEXT:   [[PASS1:%.*]] = llvm.bitcast [[BCAST0]] : i32 to vector<1xi32>
+    // CHECK-NEXT:   [[MASK1:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[ZERO1:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT: [[MASK1_0:%.*]] = llvm.insertelement [[ARG1_0]], [[MASK1]][[[ZERO1]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   [[LOAD1:%.*]] = llvm.intr.masked.load [[BCAST1]], [[MASK1_0]], [[PASS1]] {alignment = 4 : i32} : (!llvm.ptr<1>, vector<1xi1>, vector<1xi32>) -> vector<1xi32>
+    // CHECK-NEXT:   [[V1:%.*]] = llvm.bitcast [[LOAD1]] : vector<1xi32> to i32
     // CHECK-NEXT:   [[BCAST_V1:%.*]] = llvm.bitcast [[V1]] : i32 to vector<1xf32>
     // CHECK:        [[EE1:%.*]] = llvm.extractelement [[BCAST_V1]][{{.*}} : i32] : vector<1xf32>
     // CHECK:        [[BCAST2:%.*]] = llvm.bitcast {{.*}} : vector<1xf32> to i32
-    // CHECK:        llvm.cond_br [[ARG1_1]], ^bb3, ^bb4([[BCAST2]] : i32)
-    // CHECK-NEXT: ^bb3:
-    // CHECK-NEXT:   [[BCAST3:%.*]] = llvm.bitcast [[ARG0_1]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   [[LOAD2:%.*]] = llvm.load [[BCAST3]] : !llvm.ptr<1> -> i32
-    // CHECK-NEXT:   llvm.br ^bb4([[LOAD2]] : i32)
-    // CHECK-NEXT: ^bb4([[V2:%.*]]: i32):
+    // CHECK:        [[BCAST3:%.*]] = llvm.bitcast [[ARG0_1]] : !llvm.ptr<1> to !llvm.ptr<1>
+    // CHECK-NEXT:   [[PASS2:%.*]] = llvm.bitcast [[BCAST2]] : i32 to vector<1xi32>
+    // CHECK-NEXT:   [[MASK2:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[ZERO2:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK2_0:%.*]] = llvm.insertelement [[ARG1_1]], [[MASK2]][[[ZERO2]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   [[LOAD2:%.*]] = llvm.intr.masked.load [[BCAST3]], [[MASK2_0]], [[PASS2]] {alignment = 4 : i32} : (!llvm.ptr<1>, vector<1xi1>, vector<1xi32>) -> vector<1xi32>
+    // CHECK-NEXT:   [[V2:%.*]] = llvm.bitcast [[LOAD2]] : vector<1xi32> to i32
     // CHECK-NEXT:   [[BCAST_V2:%.*]] = llvm.bitcast [[V2]] : i32 to vector<1xf32>
     // CHECK:        [[EE2:%.*]] = llvm.extractelement [[BCAST_V2]][{{.*}} : i32] : vector<1xf32>
     // CHECK-NEXT:   [[RES1:%.*]] = llvm.mlir.undef : !llvm.struct<(f32, f32)>
@@ -118,82 +134,83 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
     // CHECK-NEXT: [[CST_0:%.*]] = llvm.mlir.constant(0 : index) : i32
     // CHECK-NEXT: [[IE1:%.*]] = llvm.insertelement [[ARG2_0]], [[VEC]][[[CST_0]] : i32] : vector<1xf16>
     // CHECK-NEXT: [[BCAST0:%.*]] = llvm.bitcast [[IE1]] : vector<1xf16> to i16
-    // CHECK:      llvm.cond_br [[ARG1_0]], ^bb1, ^bb2([[BCAST0]] : i16)
-    // CHECK-NEXT: ^bb1:
-    // CHECK-NEXT:   [[BCAST1:%.*]] = llvm.bitcast [[ARG0_0]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   [[LOAD1:%.*]] = llvm.load [[BCAST1]] : !llvm.ptr<1> -> i16
-    // CHECK-NEXT:   llvm.br ^bb2([[LOAD1]] : i16)
-    // CHECK-NEXT: ^bb2([[V1:%.*]]: i16):
+    // CHECK:        [[BCAST1:%.*]] = llvm.bitcast [[ARG0_0]] : !llvm.ptr<1> to !llvm.ptr<1>
+    // CHECK-NEXT:   [[PASS1:%.*]] = llvm.bitcast [[BCAST0]] : i16 to vector<1xi16>
+    // CHECK-NEXT:   [[MASK1:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[ZERO1:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT: [[MASK1_0:%.*]] = llvm.insertelement [[ARG1_0]], [[MASK1]][[[ZERO1]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   [[LOAD1:%.*]] = llvm.intr.masked.load [[BCAST1]], [[MASK1_0]], [[PASS1]] {alignment = 2 : i32} : (!llvm.ptr<1>, vector<1xi1>, vector<1xi16>) -> vector<1xi16>
+    // CHECK-NEXT:   [[V1:%.*]] = llvm.bitcast [[LOAD1]] : vector<1xi16> to i16
     // CHECK-NEXT:   [[BCAST_V1:%.*]] = llvm.bitcast [[V1]] : i16 to vector<1xf16>
     // CHECK:        [[EE1:%.*]] = llvm.extractelement [[BCAST_V1]][{{.*}} : i32] : vector<1xf16>
     // CHECK:        [[BCAST2:%.*]] = llvm.bitcast {{.*}} : vector<1xf16> to i16
-    // CHECK:        llvm.cond_br [[ARG1_1]], ^bb3, ^bb4([[BCAST2]] : i16)
-
-    // CHECK-NEXT: ^bb3:
-    // CHECK-NEXT:   [[BCAST3:%.*]] = llvm.bitcast [[ARG0_1]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   [[LOAD2:%.*]] = llvm.load [[BCAST3]] : !llvm.ptr<1> -> i16
-    // CHECK-NEXT:   llvm.br ^bb4([[LOAD2]] : i16)
-    // CHECK-NEXT: ^bb4([[V2:%.*]]: i16):
+    // CHECK:        [[BCAST3:%.*]] = llvm.bitcast [[ARG0_1]] : !llvm.ptr<1> to !llvm.ptr<1>
+    // CHECK-NEXT:   [[PASS2:%.*]] = llvm.bitcast [[BCAST2]] : i16 to vector<1xi16>
+    // CHECK-NEXT:   [[MASK2:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[ZERO2:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK2_0:%.*]] = llvm.insertelement [[ARG1_1]], [[MASK2]][[[ZERO2]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   [[LOAD2:%.*]] = llvm.intr.masked.load [[BCAST3]], [[MASK2_0]], [[PASS2]] {alignment = 2 : i32} : (!llvm.ptr<1>, vector<1xi1>, vector<1xi16>) -> vector<1xi16>
+    // CHECK-NEXT:   [[V2:%.*]] = llvm.bitcast [[LOAD2]] : vector<1xi16> to i16
     // CHECK-NEXT:   [[BCAST_V2:%.*]] = llvm.bitcast [[V2]] : i16 to vector<1xf16>
     // CHECK:        [[EE2:%.*]] = llvm.extractelement [[BCAST_V2]][{{.*}} : i32] : vector<1xf16>
     // CHECK:        [[BCAST4:%.*]] = llvm.bitcast {{.*}} : vector<1xf16> to i16
-    // CHECK:        llvm.cond_br [[ARG1_2]], ^bb5, ^bb6([[BCAST4]] : i16)
-
-    // CHECK-NEXT: ^bb5:
-    // CHECK-NEXT:   [[BCAST5:%.*]] = llvm.bitcast [[ARG0_2]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   [[LOAD3:%.*]] = llvm.load [[BCAST5]] : !llvm.ptr<1> -> i16
-    // CHECK-NEXT:   llvm.br ^bb6([[LOAD3]] : i16)
-    // CHECK-NEXT: ^bb6([[V3:%.*]]: i16):
+    // CHECK:        [[BCAST5:%.*]] = llvm.bitcast [[ARG0_2]] : !llvm.ptr<1> to !llvm.ptr<1>
+    // CHECK-NEXT:   [[PASS3:%.*]] = llvm.bitcast [[BCAST4]] : i16 to vector<1xi16>
+    // CHECK-NEXT:   [[MASK3:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[ZERO3:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK3_0:%.*]] = llvm.insertelement [[ARG1_2]], [[MASK3]][[[ZERO3]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   [[LOAD3:%.*]] = llvm.intr.masked.load [[BCAST5]], [[MASK3_0]], [[PASS3]] {alignment = 2 : i32} : (!llvm.ptr<1>, vector<1xi1>, vector<1xi16>) -> vector<1xi16>
+    // CHECK-NEXT:   [[V3:%.*]] = llvm.bitcast [[LOAD3]] : vector<1xi16> to i16
     // CHECK-NEXT:   [[BCAST_V3:%.*]] = llvm.bitcast [[V3]] : i16 to vector<1xf16>
     // CHECK:        [[EE3:%.*]] = llvm.extractelement [[BCAST_V3]][{{.*}} : i32] : vector<1xf16>
     // CHECK:        [[BCAST5:%.*]] = llvm.bitcast {{.*}} : vector<1xf16> to i16
-    // CHECK:        llvm.cond_br [[ARG1_3]], ^bb7, ^bb8([[BCAST5]] : i16)
-
-    // CHECK-NEXT: ^bb7:
     // CHECK:        [[BCAST6:%.*]] = llvm.bitcast [[ARG0_3]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   [[LOAD4:%.*]] = llvm.load [[BCAST6]] : !llvm.ptr<1> -> i16
-    // CHECK-NEXT:   llvm.br ^bb8([[LOAD4]] : i16)
-    // CHECK-NEXT: ^bb8([[V4:%.*]]: i16):
+    // CHECK-NEXT:   [[PASS4:%.*]] = llvm.bitcast [[BCAST5]] : i16 to vector<1xi16>
+    // CHECK-NEXT:   [[MASK4:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[ZERO4:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK4_0:%.*]] = llvm.insertelement [[ARG1_3]], [[MASK4]][[[ZERO4]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   [[LOAD4:%.*]] = llvm.intr.masked.load [[BCAST6]], [[MASK4_0]], [[PASS4]] {alignment = 2 : i32} : (!llvm.ptr<1>, vector<1xi1>, vector<1xi16>) -> vector<1xi16>
+    // CHECK-NEXT:   [[V4:%.*]] = llvm.bitcast [[LOAD4]] : vector<1xi16> to i16
     // CHECK-NEXT:   [[BCAST_V4:%.*]] = llvm.bitcast [[V4]] : i16 to vector<1xf16>
     // CHECK:        [[EE4:%.*]] = llvm.extractelement [[BCAST_V4]][{{.*}} : i32] : vector<1xf16>
     // CHECK:        [[BCAST7:%.*]] = llvm.bitcast {{.*}} : vector<1xf16> to i16
-    // CHECK:        llvm.cond_br [[ARG1_4]], ^bb9, ^bb10([[BCAST7]] : i16)
-
-    // CHECK-NEXT: ^bb9:
     // CHECK:        [[BCAST8:%.*]] = llvm.bitcast [[ARG0_4]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   [[LOAD5:%.*]] = llvm.load [[BCAST8]] : !llvm.ptr<1> -> i16
-    // CHECK-NEXT:   llvm.br ^bb10([[LOAD5]] : i16)
-    // CHECK-NEXT: ^bb10([[V5:%.*]]: i16):
+    // CHECK-NEXT:   [[PASS5:%.*]] = llvm.bitcast [[BCAST7]] : i16 to vector<1xi16>
+    // CHECK-NEXT:   [[MASK5:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[ZERO5:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK5_0:%.*]] = llvm.insertelement [[ARG1_4]], [[MASK5]][[[ZERO5]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   [[LOAD5:%.*]] = llvm.intr.masked.load [[BCAST8]], [[MASK5_0]], [[PASS5]] {alignment = 2 : i32} : (!llvm.ptr<1>, vector<1xi1>, vector<1xi16>) -> vector<1xi16>
+    // CHECK-NEXT:   [[V5:%.*]] = llvm.bitcast [[LOAD5]] : vector<1xi16> to i16
     // CHECK-NEXT:   [[BCAST_V5:%.*]] = llvm.bitcast [[V5]] : i16 to vector<1xf16>
     // CHECK:        [[EE5:%.*]] = llvm.extractelement [[BCAST_V5]][{{.*}} : i32] : vector<1xf16>
     // CHECK:        [[BCAST8:%.*]] = llvm.bitcast {{.*}} : vector<1xf16> to i16
-    // CHECK:        llvm.cond_br [[ARG1_5]], ^bb11, ^bb12([[BCAST8]] : i16)
-
-    // CHECK-NEXT: ^bb11:
     // CHECK:        [[BCAST9:%.*]] = llvm.bitcast [[ARG0_5]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   [[LOAD6:%.*]] = llvm.load [[BCAST9]] : !llvm.ptr<1> -> i16
-    // CHECK-NEXT:   llvm.br ^bb12([[LOAD6]] : i16)
-    // CHECK-NEXT: ^bb12([[V6:%.*]]: i16):
+    // CHECK-NEXT:   [[PASS6:%.*]] = llvm.bitcast [[BCAST8]] : i16 to vector<1xi16>
+    // CHECK-NEXT:   [[MASK6:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[ZERO6:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK6_0:%.*]] = llvm.insertelement [[ARG1_5]], [[MASK6]][[[ZERO6]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   [[LOAD6:%.*]] = llvm.intr.masked.load [[BCAST9]], [[MASK6_0]], [[PASS6]] {alignment = 2 : i32} : (!llvm.ptr<1>, vector<1xi1>, vector<1xi16>) -> vector<1xi16>
+    // CHECK-NEXT:   [[V6:%.*]] = llvm.bitcast [[LOAD6]] : vector<1xi16> to i16
     // CHECK-NEXT:   [[BCAST_V6:%.*]] = llvm.bitcast [[V6]] : i16 to vector<1xf16>
     // CHECK:        [[EE6:%.*]] = llvm.extractelement [[BCAST_V6]][{{.*}} : i32] : vector<1xf16>
     // CHECK:        [[BCAST10:%.*]] = llvm.bitcast {{.*}} : vector<1xf16> to i16
-    // CHECK:        llvm.cond_br [[ARG1_6]], ^bb13, ^bb14([[BCAST10]] : i16)
-
-    // CHECK-NEXT: ^bb13:
     // CHECK:        [[BCAST11:%.*]] = llvm.bitcast [[ARG0_6]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   [[LOAD7:%.*]] = llvm.load [[BCAST11]] : !llvm.ptr<1> -> i16
-    // CHECK-NEXT:   llvm.br ^bb14([[LOAD7]] : i16)
-    // CHECK-NEXT: ^bb14([[V7:%.*]]: i16):
+    // CHECK-NEXT:   [[PASS7:%.*]] = llvm.bitcast [[BCAST10]] : i16 to vector<1xi16>
+    // CHECK-NEXT:   [[MASK7:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[ZERO7:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK7_0:%.*]] = llvm.insertelement [[ARG1_6]], [[MASK7]][[[ZERO7]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   [[LOAD7:%.*]] = llvm.intr.masked.load [[BCAST11]], [[MASK7_0]], [[PASS7]] {alignment = 2 : i32} : (!llvm.ptr<1>, vector<1xi1>, vector<1xi16>) -> vector<1xi16>
+    // CHECK-NEXT:   [[V7:%.*]] = llvm.bitcast [[LOAD7]] : vector<1xi16> to i16
     // CHECK-NEXT:   [[BCAST_V7:%.*]] = llvm.bitcast [[V7]] : i16 to vector<1xf16>
     // CHECK:        [[EE7:%.*]] = llvm.extractelement [[BCAST_V7]][{{.*}} : i32] : vector<1xf16>
     // CHECK:        [[BCAST12:%.*]] = llvm.bitcast {{.*}} : vector<1xf16> to i16
-    // CHECK:        llvm.cond_br [[ARG1_7]], ^bb15, ^bb16([[BCAST12]] : i16)
-
-    // CHECK-NEXT: ^bb15:
     // CHECK:        [[BCAST13:%.*]] = llvm.bitcast [[ARG0_7]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   [[LOAD8:%.*]] = llvm.load [[BCAST13]] : !llvm.ptr<1> -> i16
-    // CHECK-NEXT:   llvm.br ^bb16([[LOAD8]] : i16)
-    // CHECK-NEXT: ^bb16([[V8:%.*]]: i16):
+    // CHECK-NEXT:   [[PASS8:%.*]] = llvm.bitcast [[BCAST12]] : i16 to vector<1xi16>
+    // CHECK-NEXT:   [[MASK8:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[ZERO8:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK8_0:%.*]] = llvm.insertelement [[ARG1_7]], [[MASK8]][[[ZERO8]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   [[LOAD8:%.*]] = llvm.intr.masked.load [[BCAST13]], [[MASK8_0]], [[PASS8]] {alignment = 2 : i32} : (!llvm.ptr<1>, vector<1xi1>, vector<1xi16>) -> vector<1xi16>
+    // CHECK-NEXT:   [[V8:%.*]] = llvm.bitcast [[LOAD8]] : vector<1xi16> to i16
     // CHECK-NEXT:   [[BCAST_V8:%.*]] = llvm.bitcast [[V8]] : i16 to vector<1xf16>
     // CHECK:        [[EE8:%.*]] = llvm.extractelement [[BCAST_V8]][{{.*}} : i32] : vector<1xf16>
     // CHECK-NEXT:   [[RES1:%.*]] = llvm.mlir.undef : !llvm.struct<(f16, f16, f16, f16, f16, f16, f16, f16)>
@@ -222,18 +239,17 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
     // CHECK-NEXT: [[STRUCT:%.*]] = llvm.mlir.undef : !llvm.struct<(f32, f32)>
     // CHECK-NEXT: [[STRUCT1:%.*]] = llvm.insertvalue [[ARG0_0]], [[STRUCT]][0]
     // CHECK-NEXT: [[STRUCT2:%.*]] = llvm.insertvalue [[ARG0_1]], [[STRUCT1]][1]
-    // CHECK-NEXT: [[T0:%.*]] = llvm.extractvalue [[STRUCT2]][0]
-    // CHECK-NEXT: [[T1:%.*]] = llvm.extractvalue [[STRUCT2]][1]
     %0 = tt.reshape %arg {allow_reorder = true} : tensor<256xf32, #blocked0> -> tensor<256x1xf32,#blocked2>
-    // CHECK:      [[RES:%.*]] = llvm.mlir.undef : !llvm.struct<(f32, f32, f32, f32, f32, f32, f32, f32)>
-    // CHECK-NEXT: [[RES1:%.*]] = llvm.insertvalue [[T0]], [[RES]][0]
-    // CHECK-NEXT: [[RES2:%.*]] = llvm.insertvalue [[T1]], [[RES1]][1]
-    // CHECK-NEXT: [[RES3:%.*]] = llvm.insertvalue [[T0]], [[RES2]][2]
-    // CHECK-NEXT: [[RES4:%.*]] = llvm.insertvalue [[T1]], [[RES3]][3]
-    // CHECK-NEXT: [[RES5:%.*]] = llvm.insertvalue [[T0]], [[RES4]][4]
-    // CHECK-NEXT: [[RES6:%.*]] = llvm.insertvalue [[T1]], [[RES5]][5]
-    // CHECK-NEXT: [[RES7:%.*]] = llvm.insertvalue [[T0]], [[RES6]][6]
-    // CHECK-NEXT: [[RES8:%.*]] = llvm.insertvalue [[T1]], [[RES7]][7]
+    // COM: The elements of the reshape are forwarded without extracting them.
+    // CHECK-NEXT: [[RES:%.*]] = llvm.mlir.undef : !llvm.struct<(f32, f32, f32, f32, f32, f32, f32, f32)>
+    // CHECK-NEXT: [[RES1:%.*]] = llvm.insertvalue [[ARG0_0]], [[RES]][0]
+    // CHECK-NEXT: [[RES2:%.*]] = llvm.insertvalue [[ARG0_1]], [[RES1]][1]
+    // CHECK-NEXT: [[RES3:%.*]] = llvm.insertvalue [[ARG0_0]], [[RES2]][2]
+    // CHECK-NEXT: [[RES4:%.*]] = llvm.insertvalue [[ARG0_1]], [[RES3]][3]
+    // CHECK-NEXT: [[RES5:%.*]] = llvm.insertvalue [[ARG0_0]], [[RES4]][4]
+    // CHECK-NEXT: [[RES6:%.*]] = llvm.insertvalue [[ARG0_1]], [[RES5]][5]
+    // CHECK-NEXT: [[RES7:%.*]] = llvm.insertvalue [[ARG0_0]], [[RES6]][6]
+    // CHECK-NEXT: [[RES8:%.*]] = llvm.insertvalue [[ARG0_1]], [[RES7]][7]
     %1 = tt.broadcast %0 : (tensor<256x1xf32,#blocked2>) -> tensor<256x4xf32, #blocked2>
     tt.return
   }
@@ -275,6 +291,32 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
 
 // -----
 
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: packed_addf_f16
+  tt.func @packed_addf_f16(%arg0 : tensor<512xf16,#blocked0>, %arg1 : tensor<512xf16,#blocked0>) {
+    // CHECK-COUNT-4: llvm.insertelement {{.*}} : vector<4xf16>
+    // CHECK-COUNT-4: llvm.insertelement {{.*}} : vector<4xf16>
+    // CHECK:         llvm.fadd {{.*}} : vector<4xf16>
+    // CHECK-NOT:     llvm.fadd
+    %1 = arith.addf %arg0, %arg1 : tensor<512xf16,#blocked0>
+    tt.return
+  }
+
+  // CHECK-LABEL: packed_mulf_bf16
+  tt.func @packed_mulf_bf16(%arg0 : tensor<512xbf16,#blocked0>, %arg1 : tensor<512xbf16,#blocked0>) {
+    // CHECK:     llvm.call spir_funccc @_Z27__spirv_ConvertBF16ToFINTELDv4_t({{.*}}) : (vector<4xi16>) -> vector<4xf32>
+    // CHECK:     llvm.call spir_funccc @_Z27__spirv_ConvertBF16ToFINTELDv4_t({{.*}}) : (vector<4xi16>) -> vector<4xf32>
+    // CHECK:     llvm.fmul {{.*}} : vector<4xf32>
+    // CHECK:     llvm.call spir_funccc @_Z27__spirv_ConvertFToBF16INTELDv4_f({{.*}}) : (vector<4xf32>) -> vector<4xi16>
+    // CHECK-NOT: llvm.fmul
+    %1 = arith.mulf %arg0, %arg1 : tensor<512xbf16,#blocked0>
+    tt.return
+  }
+}
+
+// -----
+
 #blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
   // CHECK-LABEL: basic_addi
@@ -433,22 +475,20 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
     // CHECK-NEXT: [[VEC2:%.*]] = llvm.mlir.undef : vector<1xi32>
     // CHECK-NEXT: [[ZERO:%.*]] = llvm.mlir.constant(0 : i32) : i32
     // CHECK-NEXT: [[IE2:%.*]] = llvm.insertelement [[BCAST1]], [[VEC2]][[[ZERO]] : i32] : vector<1xi32>
-    // CHECK-NEXT: llvm.cond_br [[AND1]], ^bb1, ^bb2
-    // CHECK-NEXT: ^bb1:
-    // CHECK-NEXT:   [[BCAST2:%.*]] = llvm.bitcast [[ARG0_0]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   llvm.store [[IE2]], [[BCAST2]] : vector<1xi32>, !llvm.ptr<1>
-    // CHECK-NEXT:   llvm.br ^bb2
-    // CHECK-NEXT: ^bb2:
+    // CHECK-NEXT: [[BCAST2:%.*]] = llvm.bitcast [[ARG0_0]] : !llvm.ptr<1> to !llvm.ptr<1>
+    // CHECK-NEXT: [[MASK1:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT: [[C0_1:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT: [[MASK1_0:%.*]] = llvm.insertelement [[AND1]], [[MASK1]][[[C0_1]] : i32] : vector<1xi1>
+    // CHECK-NEXT: llvm.intr.masked.store [[IE2]], [[BCAST2]], [[MASK1_0]] {alignment = 4 : i32} : vector<1xi32>, vector<1xi1> into !llvm.ptr<1>
     // CHECK:        [[AND2:%.*]] = llvm.and {{.*}}, [[ARG2_1]] : i1
     // CHECK-NEXT:   [[VEC3:%.*]] = llvm.mlir.undef : vector<1xi32>
     // CHECK-NEXT:   [[ZERO:%.*]] = llvm.mlir.constant(0 : i32) : i32
     // CHECK-NEXT:   [[IE3:%.*]] = llvm.insertelement {{.*}}, [[VEC3]][[[ZERO]] : i32] : vector<1xi32>
-    // CHECK:        llvm.cond_br [[AND2]], ^bb3, ^bb4
-    // CHECK-NEXT: ^bb3:
-    // CHECK-NEXT:   [[BCAST2:%.*]] = llvm.bitcast [[ARG0_1]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   llvm.store [[IE3]], [[BCAST2]] : vector<1xi32>, !llvm.ptr<1>
-    // CHECK-NEXT:   llvm.br ^bb4
-    // CHECK-NEXT: ^bb4:
+    // CHECK:        [[BCAST2:%.*]] = llvm.bitcast [[ARG0_1]] : !llvm.ptr<1> to !llvm.ptr<1>
+    // CHECK-NEXT:   [[MASK2:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[C0_2:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK2_0:%.*]] = llvm.insertelement [[AND2]], [[MASK2]][[[C0_2]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   llvm.intr.masked.store [[IE3]], [[BCAST2]], [[MASK2_0]] {alignment = 4 : i32} : vector<1xi32>, vector<1xi1> into !llvm.ptr<1>
     tt.store %ptrs, %vals, %mask : tensor<256xf32, #blocked0>
     tt.return
   }
@@ -527,21 +567,14 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
   // CHECK-LABEL: convert_layout_blocked_blocked_multi_rep({{.*}}%arg1: !llvm.ptr<3>)
   tt.func @convert_layout_blocked_blocked_multi_rep(%arg0: tensor<16x16xf32, #blocked0>) {
-    // CHECK: llvm.store
-    // CHECK-SAME: vector<4xf32>, !llvm.ptr<3>
-    // CHECK: genx.barrier
-    // CHECK: llvm.load
-    // CHECK-SAME: !llvm.ptr<3> -> vector<4xf32>
-    // CHECK: llvm.load
-    // CHECK-SAME: !llvm.ptr<3> -> vector<4xf32>
-    // CHECK: genx.barrier
-    // CHECK: llvm.store
-    // CHECK-SAME: vector<4xf32>, !llvm.ptr<3>
-    // CHECK: genx.barrier
-    // CHECK: llvm.load
-    // CHECK-SAME: !llvm.ptr<3> -> vector<4xf32>
-    // CHECK: llvm.load
-    // CHECK-SAME: !llvm.ptr<3> -> vector<4xf32>
+    // COM: The elements are exchanged between the lanes of the warp.
+    // CHECK-NOT: llvm.store
+    // CHECK-NOT: llvm.load
+    // CHECK-NOT: genx.barrier
+    // CHECK-COUNT-16: genx.sub_group_shuffle
+    // CHECK-NOT: llvm.store
+    // CHECK-NOT: llvm.load
+    // CHECK-NOT: genx.barrier
     %0 = triton_gpu.convert_layout %arg0 : (tensor<16x16xf32, #blocked0>) -> tensor<16x16xf32, #blocked1>
     tt.return
   }
@@ -549,6 +582,26 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
 
 // -----
 
+#dpas = #triton_gpu.dpas<{repeatCount=8, warpsPerCTA=[1,1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+#dot_operand_b = #triton_gpu.dot_op<{opIdx=1, parent=#dpas}>
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: unpack_int4_dpas
+  tt.func @unpack_int4_dpas(%b: tensor<32x16xi8, #dot_operand_b>) {
+    // COM: The packed operand vector is unpacked in registers into the 4 vectors of the f16 operand.
+    // CHECK: [[LO_SHL:%.*]] = llvm.shl %{{.*}}, %{{.*}} : vector<32xi8>
+    // CHECK: [[LO:%.*]] = llvm.ashr [[LO_SHL]], %{{.*}} : vector<32xi8>
+    // CHECK: [[HI:%.*]] = llvm.ashr %{{.*}}, %{{.*}} : vector<32xi8>
+    // CHECK: [[UNPACKED:%.*]] = llvm.shufflevector [[LO]], [[HI]] [0, 32, 1, 33, {{.*}}] : vector<32xi8>
+    // CHECK-COUNT-4: llvm.sitofp %{{.*}} : vector<16xi8> to vector<16xf16>
+    // CHECK-NOT: llvm.sitofp
+    %0 = tt.unpack_int4 %b {is_signed = true} : tensor<32x16xi8, #dot_operand_b> -> tensor<64x16xf16, #dot_operand_b>
+    tt.return
+  }
+}
+
+// -----
+
 #dpas = #triton_gpu.dpas<{repeatCount=8, warpsPerCTA=[1,1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
 #dot_operand_a = #triton_gpu.dot_op<{opIdx=0, parent=#dpas}>
 #dot_operand_b = #triton_gpu.dot_op<{opIdx=1, parent=#dpas}>
@@ -584,6 +637,24 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
 #dot_operand_a = #triton_gpu.dot_op<{opIdx=0, parent=#dpas}>
 #dot_operand_b = #triton_gpu.dot_op<{opIdx=1, parent=#dpas}>
 
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: With sub-groups of 16 work-items, the DPAS is computed by the OpenCL
+  // COM: matrix multiply accumulate builtins.
+  // CHECK-LABEL: dot_f32_f16_f16_f32_simd16
+  tt.func @dot_f32_f16_f16_f32_simd16(%a: tensor<8x16xf16, #dot_operand_a>, %b: tensor<16x16xf16, #dot_operand_b>, %c: tensor<8x16xf32, #dpas>) {
+    // CHECK-NOT: genx.matrix.dpas
+    // CHECK: llvm.call spir_funccc @_Z38intel_sub_group_f16_f16_matrix_mad_k16Dv8_sDv8_iDv8_f({{.*}}) : (vector<8xi16>, vector<8xi32>, vector<8xf32>) -> vector<8xf32>
+    %0 = tt.dot %a, %b, %c {allowTF32 = true, maxNumImpreciseAcc = 0 : i32, transA = false, transB = false} : tensor<8x16xf16, #dot_operand_a> * tensor<16x16xf16, #dot_operand_b> -> tensor<8x16xf32, #dpas>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount=8, warpsPerCTA=[1,1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx=0, parent=#dpas}>
+#dot_operand_b = #triton_gpu.dot_op<{opIdx=1, parent=#dpas}>
+
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
   // CHECK-LABEL: dot_i32_i8_i8_i32_1
   tt.func @dot_i32_i8_i8_i32_1(%a: tensor<8x32xi8, #dot_operand_a>, %b: tensor<32x16xi8, #dot_operand_b>, %c: tensor<8x16xi32, #dpas>) {
@@ -682,21 +753,72 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
   }
 }
 
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [2, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx=0, parent=#dpas}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 2 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: convert_layout_dpas_dot_a
+  tt.func @convert_layout_dpas_dot_a(%arg0: tensor<16x32xf16, #dpas>) {
+    // COM: The accumulator is repacked in registers without going through SLM.
+    // CHECK-NOT: genx.barrier
+    // CHECK-NOT: llvm.store
+    // CHECK-NOT: llvm.load
+    // CHECK-COUNT-16: llvm.insertelement {{.*}} : vector<8xf16>
+    // CHECK-NOT: genx.barrier
+    // CHECK-NOT: llvm.store
+    // CHECK-NOT: llvm.load
+    // CHECK: llvm.insertvalue {{.*}} : !llvm.struct<(vector<8xf16>, vector<8xf16>)>
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<16x32xf16, #dpas>) -> tensor<16x32xf16, #dot_operand_a>
+    tt.return
+  }
+}
+
 // -----
 #blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [8, 4], warpsPerCTA = [8, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
 #shared0 = #triton_gpu.shared<{vec = 8, perPhase = 2, maxPhase = 4, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 : i32} {
   // CHECK-LABEL: convert_layout_blocked_shared
   tt.func @convert_layout_blocked_shared(%arg0: tensor<128x32xf32, #blocked0>) {
-    // CHECK: llvm.store
-    // CHECK-SAME: vector<8xf32>, !llvm.ptr<3>
-    // CHECK: llvm.store
-    // CHECK-SAME: vector<8xf32>, !llvm.ptr<3>
+    // COM: The SLM block messages are at most 128-bit wide.
+    // CHECK-COUNT-4: llvm.store {{.*}} : vector<4xf32>, !llvm.ptr<3>
+    // CHECK-NOT: llvm.store
     %0 = triton_gpu.convert_layout %arg0 : (tensor<128x32xf32, #blocked0>) -> tensor<128x32xf32, #shared0>
     tt.return
   }
 }
 
+// -----
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#shared0 = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: convert_layout_blocked_shared_unswizzled
+  tt.func @convert_layout_blocked_shared_unswizzled(%arg0: tensor<64x32xf16, #blocked0>) {
+    // COM: Without swizzling the stores are only bounded by the contiguity.
+    // CHECK-COUNT-4: llvm.store {{.*}} : vector<8xf16>, !llvm.ptr<3>
+    // CHECK-NOT: llvm.store
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<64x32xf16, #blocked0>) -> tensor<64x32xf16, #shared0>
+    // CHECK-COUNT-4: llvm.load {{.*}} : !llvm.ptr<3> -> vector<8xf16>
+    // CHECK-NOT: llvm.load
+    %1 = triton_gpu.convert_layout %0 : (tensor<64x32xf16, #shared0>) -> tensor<64x32xf16, #blocked0>
+    tt.return
+  }
+}
+
+// -----
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [1, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#shared0 = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: convert_layout_blocked_shared_small
+  tt.func @convert_layout_blocked_shared_small(%arg0: tensor<4x32xf16, #blocked0>) {
+    // COM: Small buffers are only 8-byte aligned.
+    // CHECK-COUNT-2: llvm.store {{.*}} : vector<4xf16>, !llvm.ptr<3>
+    // CHECK-NOT: llvm.store
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<4x32xf16, #blocked0>) -> tensor<4x32xf16, #shared0>
+    tt.return
+  }
+}
+
 // -----
 
 #blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [1], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
@@ -704,7 +826,11 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 :
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
   // CHECK-LABEL: convert_blocked1d_to_slice0
   tt.func @convert_blocked1d_to_slice0(%src:tensor<32xi32, #blocked0>) {
-    // CHECK-COUNT-4: llvm.load {{.*}} : !llvm.ptr<3> -> vector<1xi32>
+    // CHECK-NOT: llvm.store
+    // CHECK-NOT: llvm.load
+    // CHECK-COUNT-4: genx.sub_group_shuffle
+    // CHECK-NOT: llvm.store
+    // CHECK-NOT: llvm.load
     %cvt = triton_gpu.convert_layout %src : (tensor<32xi32, #blocked0>) -> tensor<32xi32, #triton_gpu.slice<{dim = 0, parent = #blocked1}>>
     tt.return
   }
@@ -717,7 +843,11 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
   // CHECK-LABEL: convert_blocked1d_to_slice1
   tt.func @convert_blocked1d_to_slice1(%src:tensor<32xi32, #blocked0>) {
-    // CHECK-COUNT-8: llvm.load {{.*}} : !llvm.ptr<3> -> vector<1xi32>
+    // CHECK-NOT: llvm.store
+    // CHECK-NOT: llvm.load
+    // CHECK-COUNT-8: genx.sub_group_shuffle
+    // CHECK-NOT: llvm.store
+    // CHECK-NOT: llvm.load
     %cvt = triton_gpu.convert_layout %src : (tensor<32xi32, #blocked0>) -> tensor<32xi32, #triton_gpu.slice<{dim = 1, parent = #blocked1}>>
     tt.return
   }
@@ -725,15 +855,34 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
 
 // -----
 
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [16, 1], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: convert_slice_to_blocked_in_thread
+  tt.func @convert_slice_to_blocked_in_thread(%src: tensor<64xf32, #triton_gpu.slice<{dim = 1, parent = #blocked0}>>) {
+    // COM: Every thread already holds its element, e.g. for reduction results.
+    // CHECK-NOT: llvm.store
+    // CHECK-NOT: llvm.load
+    // CHECK-NOT: genx.sub_group_shuffle
+    // CHECK-NOT: genx.barrier
+    // CHECK: llvm.return
+    %cvt = triton_gpu.convert_layout %src : (tensor<64xf32, #triton_gpu.slice<{dim = 1, parent = #blocked0}>>) -> tensor<64xf32, #blocked1>
+    tt.return
+  }
+}
+
+// -----
+
 #blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [1], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
 #blocked1 = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [1], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
   // CHECK-LABEL: convert_blocked_to_blocked_ptr
   tt.func @convert_blocked_to_blocked_ptr(%src:tensor<32x!tt.ptr<f32>, #blocked0>) {
-    // CHECK: llvm.ptrtoint
-    // CHECK: llvm.store
-    // CHECK: genx.barrier
+    // CHECK-NOT: genx.barrier
+    // CHECK-COUNT-4: llvm.ptrtoint
+    // CHECK: genx.sub_group_shuffle
     // CHECK: llvm.inttoptr
+    // CHECK-NOT: genx.barrier
     // CHECK-COUNT-4: llvm.insertvalue
     %cvt = triton_gpu.convert_layout %src : (tensor<32x!tt.ptr<f32>, #blocked0>) -> tensor<32x!tt.ptr<f32>, #blocked1>
     tt.return
@@ -817,6 +966,29 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
 
 // -----
 
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: All the lanes update the same address: the values are summed within
+  // COM: the sub-group and only the first lane issues the atomic.
+  // CHECK-LABEL: atomic_add_f32_uniform
+  tt.func @atomic_add_f32_uniform(%arg0 : !tt.ptr<f32>, %arg1 : tensor<64xi1, #blocked0>, %arg2 : tensor<64xf32, #blocked0>) {
+    // CHECK:      [[SELECT:%.*]] = llvm.select {{.*}} : i1, f32
+    // CHECK:      [[SUM:%.*]] = llvm.call spir_funccc @_Z27__spirv_GroupNonUniformFAddiif({{.*}}, {{.*}}, [[SELECT]]) : (i32, i32, f32) -> f32
+    // CHECK:      [[ACTIVE:%.*]] = llvm.call spir_funccc @_Z27__spirv_GroupNonUniformUMaxiii({{.*}}) : (i32, i32, i32) -> i32
+    // CHECK:      [[ANY:%.*]] = llvm.icmp "ne" [[ACTIVE]], {{.*}} : i32
+    // CHECK-NEXT: [[PRED:%.*]] = llvm.and {{.*}}, [[ANY]] : i1
+    // CHECK:      llvm.cond_br [[PRED]], ^bb1, ^bb2
+    // CHECK-NEXT: ^bb1:
+    // CHECK-NEXT:   [[VAL:%.*]] = llvm.bitcast [[SUM]] : f32 to f32
+    // CHECK-NEXT:   llvm.atomicrmw fadd {{.*}}, [[VAL]] acq_rel : !llvm.ptr<1>, f32
+    %0 = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<64x!tt.ptr<f32>, #blocked0>
+    %1 = "tt.atomic_rmw" (%0, %arg2, %arg1) {atomic_rmw_op = 5 : i32, sem = 1 : i32, scope = 1 : i32} : (tensor<64x!tt.ptr<f32>, #blocked0>, tensor<64xf32, #blocked0>, tensor<64xi1, #blocked0>) -> tensor<64xf32, #blocked0>
+    tt.return
+  }
+}
+
+// -----
+
 module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
   // CHECK-LABEL: atomic_add_f32_scalar
   // CHECK-SAME:    ({{.*}}, [[SMEM:%.*]]: !llvm.ptr<3>)
@@ -863,19 +1035,19 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
 
     // CHECK:      [[TRUE:%.*]] = llvm.mlir.constant(true) : i1
     // CHECK:      genx.workitem.id.x : i32
-    // CHECK:      llvm.cond_br [[TRUE]], ^bb1, ^bb2
-    // CHECK-NEXT: ^bb1:
-    // CHECK-NEXT:   [[BCAST:%.*]] = llvm.bitcast [[ARG0_0]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   llvm.store {{.*}}, [[BCAST]] : vector<1xi32>, !llvm.ptr<1>
-    // CHECK-NEXT:   llvm.br ^bb2
-    // CHECK-NEXT: ^bb2:
+    // CHECK:        [[BCAST:%.*]] = llvm.bitcast [[ARG0_0]] : !llvm.ptr<1> to !llvm.ptr<1>
+    // CHECK-NEXT:   [[MASK3:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[C0_3:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK3_0:%.*]] = llvm.insertelement [[TRUE]], [[MASK3]][[[C0_3]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   llvm.intr.masked.store {{.*}}, [[BCAST]], [[MASK3_0]] {alignment = 4 : i32} : vector<1xi32>, vector<1xi1> into !llvm.ptr<1>
     // CHECK:        [[VEC:%.*]] = llvm.mlir.undef : vector<1xi32>
     // CHECK-NEXT:   [[ZERO:%.*]] = llvm.mlir.constant(0 : i32) : i32
     // CHECK-NEXT:   [[IE1:%.*]] = llvm.insertelement {{.*}}, [[VEC]][[[ZERO]] : i32] : vector<1xi32>
-    // CHECK:        llvm.cond_br [[TRUE]], ^bb3, ^bb4
-    // CHECK-NEXT: ^bb3:
-    // CHECK-NEXT:   [[BCAST1:%.*]] = llvm.bitcast [[ARG0_1]] : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   llvm.store [[IE1]], [[BCAST1]] : vector<1xi32>, !llvm.ptr<1>
+    // CHECK:        [[BCAST1:%.*]] = llvm.bitcast [[ARG0_1]] : !llvm.ptr<1> to !llvm.ptr<1>
+    // CHECK-NEXT:   [[MASK4:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[C0_4:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK4_0:%.*]] = llvm.insertelement [[TRUE]], [[MASK4]][[[C0_4]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   llvm.intr.masked.store [[IE1]], [[BCAST1]], [[MASK4_0]] {alignment = 4 : i32} : vector<1xi32>, vector<1xi1> into !llvm.ptr<1>
 
     tt.store %arg0, %arg1 : tensor<256xf32, #blocked0>
     tt.return
@@ -888,10 +1060,11 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
   // CHECK-LABEL: store_f32_scalar
   tt.func @store_f32_scalar(%arg0 : !tt.ptr<f32>, %arg1 : f32) {
     // CHECK:      llvm.icmp "eq"
-    // CHECK:      llvm.cond_br {{.*}}, ^bb1, ^bb2
-    // CHECK-NEXT: ^bb1:
-    // CHECK-NEXT:   [[BCAST:%.*]] = llvm.bitcast %arg0 : !llvm.ptr<1> to !llvm.ptr<1>
-    // CHECK-NEXT:   llvm.store {{.*}}, [[BCAST]] : vector<1xi32>, !llvm.ptr<1>
+    // CHECK:        [[BCAST:%.*]] = llvm.bitcast %arg0 : !llvm.ptr<1> to !llvm.ptr<1>
+    // CHECK-NEXT:   [[MASK5:%.*]] = llvm.mlir.undef : vector<1xi1>
+    // CHECK-NEXT:   [[C0_5:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK-NEXT:   [[MASK5_0:%.*]] = llvm.insertelement {{.*}}, [[MASK5]][[[C0_5]] : i32] : vector<1xi1>
+    // CHECK-NEXT:   llvm.intr.masked.store {{.*}}, [[BCAST]], [[MASK5_0]] {alignment = 4 : i32} : vector<1xi32>, vector<1xi1> into !llvm.ptr<1>
     tt.store %arg0, %arg1 : f32
     tt.return
   }
@@ -997,3 +1170,522 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
     tt.return
   }
 }
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-DAG: llvm.func spir_funccc @_Z27__spirv_GroupNonUniformFAddiif(i32, i32, f32) -> f32
+  // CHECK-DAG: llvm.func spir_funccc @_Z27__spirv_GroupNonUniformSMaxiiij(i32, i32, i32, i32) -> i32
+  // CHECK-LABEL: sub_group_reduce
+  tt.func @sub_group_reduce(%f : tensor<4x16xf32, #blocked>, %i : tensor<4x4xi32, #blocked1>) {
+    // COM: A row spanning the sub-group is reduced with a single instruction.
+    // CHECK: llvm.call spir_funccc @_Z27__spirv_GroupNonUniformFAddiif({{.*}}) : (i32, i32, f32) -> f32
+    %0 = "tt.reduce" (%f) ({
+    ^bb0(%arg0: f32, %arg1: f32):
+      %add = arith.addf %arg0, %arg1 : f32
+      tt.reduce.return %add : f32
+    }) {axis = 1 : i32} : (tensor<4x16xf32, #blocked>) -> tensor<4xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    // COM: Rows spanning 4 lanes are reduced by clusters of 4 lanes.
+    // CHECK: llvm.call spir_funccc @_Z27__spirv_GroupNonUniformSMaxiiij({{.*}}) : (i32, i32, i32, i32) -> i32
+    %1 = "tt.reduce" (%i) ({
+    ^bb0(%arg0: i32, %arg1: i32):
+      %max = arith.maxsi %arg0, %arg1 : i32
+      tt.reduce.return %max : i32
+    }) {axis = 1 : i32} : (tensor<4x4xi32, #blocked1>) -> tensor<4xi32, #triton_gpu.slice<{dim = 1, parent = #blocked1}>>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount=8, warpsPerCTA=[4,1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dpas_reduce
+  tt.func @dpas_reduce(%f : tensor<32x32xf32, #dpas>) {
+    // COM: Each thread first reduces the 2 columns it holds in each of its 8
+    // COM: rows, then each row is reduced across the sub-group, without going
+    // COM: through the shared local memory.
+    // CHECK-COUNT-8: llvm.fadd
+    // CHECK-COUNT-8: llvm.call spir_funccc @_Z27__spirv_GroupNonUniformFAddiif({{.*}}) : (i32, i32, f32) -> f32
+    // CHECK-NOT: genx.barrier
+    %0 = "tt.reduce" (%f) ({
+    ^bb0(%arg0: f32, %arg1: f32):
+      %add = arith.addf %arg0, %arg1 : f32
+      tt.reduce.return %add : f32
+    }) {axis = 1 : i32} : (tensor<32x32xf32, #dpas>) -> tensor<32xf32, #triton_gpu.slice<{dim = 1, parent = #dpas}>>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount=8, warpsPerCTA=[2,2], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dpas_reduce_across_warps
+  tt.func @dpas_reduce_across_warps(%f : tensor<16x32xf32, #dpas>) {
+    // COM: The rows split across the 2 warps along the columns are combined
+    // COM: through the shared local memory by clusters of 2 lanes.
+    // CHECK-COUNT-8: llvm.call spir_funccc @_Z27__spirv_GroupNonUniformFAddiif({{.*}}) : (i32, i32, f32) -> f32
+    // CHECK: genx.barrier
+    // CHECK: llvm.call spir_funccc @_Z27__spirv_GroupNonUniformFAddiifj({{.*}}) : (i32, i32, f32, i32) -> f32
+    // CHECK: genx.barrier
+    %0 = "tt.reduce" (%f) ({
+    ^bb0(%arg0: f32, %arg1: f32):
+      %add = arith.addf %arg0, %arg1 : f32
+      tt.reduce.return %add : f32
+    }) {axis = 1 : i32} : (tensor<16x32xf32, #dpas>) -> tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = #dpas}>>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: sub_group_reduce_nan_propagating_max
+  tt.func @sub_group_reduce_nan_propagating_max(%f : tensor<4x16xf32, #blocked>) {
+    // COM: The sub-group FMax doesn't propagate NaNs, shuffles are kept.
+    // CHECK-NOT: __spirv_GroupNonUniform
+    // CHECK: llvm.return
+    %0 = "tt.reduce" (%f) ({
+    ^bb0(%arg0: f32, %arg1: f32):
+      %max = arith.maximumf %arg0, %arg1 : f32
+      tt.reduce.return %max : f32
+    }) {axis = 1 : i32} : (tensor<4x16xf32, #blocked>) -> tensor<4xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: sub_group_argmax
+  tt.func @sub_group_argmax(%f : tensor<4x16xf32, #blocked>, %i : tensor<4x16xi32, #blocked>) {
+    // COM: The value and the index are packed into 64 bits, reduced with a
+    // COM: single unsigned max of the sub-group.
+    // CHECK: llvm.shl {{.*}} : i64
+    // CHECK: llvm.or {{.*}} : i64
+    // CHECK-NOT: genx.sub_group_shuffle
+    // CHECK: llvm.call spir_funccc @_Z27__spirv_GroupNonUniformUMaxiil({{.*}}) : (i32, i32, i64) -> i64
+    // CHECK-NOT: genx.sub_group_shuffle
+    // CHECK: llvm.lshr {{.*}} : i64
+    // CHECK: llvm.return
+    %0:2 = "tt.reduce" (%f, %i) ({
+    ^bb0(%arg0: f32, %arg1: i32, %arg2: f32, %arg3: i32):
+      %gt = arith.cmpf ogt, %arg0, %arg2 : f32
+      %eq = arith.cmpf oeq, %arg0, %arg2 : f32
+      %lt = arith.cmpi slt, %arg1, %arg3 : i32
+      %tie = arith.andi %eq, %lt : i1
+      %keep = arith.ori %gt, %tie : i1
+      %v = arith.select %keep, %arg0, %arg2 : f32
+      %idx = arith.select %keep, %arg1, %arg3 : i32
+      tt.reduce.return %v, %idx : f32, i32
+    }) {axis = 1 : i32} : (tensor<4x16xf32, #blocked>, tensor<4x16xi32, #blocked>) -> (tensor<4xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>, tensor<4xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>)
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK: llvm.func spir_funccc @_Z27__spirv_GroupNonUniformIAddiii(i32, i32, i32) -> i32
+  // CHECK-LABEL: sub_group_scan
+  tt.func @sub_group_scan(%i : tensor<4x16xi32, #blocked>, %f : tensor<4x16xf32, #blocked>) {
+    // COM: A row spanning the sub-group is scanned with a single instruction.
+    // CHECK: [[SCAN:%.*]] = llvm.mlir.constant(1 : i32) : i32
+    // CHECK-NEXT: llvm.call spir_funccc @_Z27__spirv_GroupNonUniformIAddiii({{.*}}, [[SCAN]], {{.*}}) : (i32, i32, i32) -> i32
+    %0 = "tt.scan" (%i) <{axis = 1 : i32}> ({
+    ^bb0(%arg0: i32, %arg1: i32):
+      %add = arith.addi %arg0, %arg1 : i32
+      tt.scan.return %add : i32
+    }) : (tensor<4x16xi32, #blocked>) -> tensor<4x16xi32, #blocked>
+    // COM: Other combiners keep the shuffles.
+    // CHECK-NOT: __spirv_GroupNonUniform
+    // CHECK: llvm.return
+    %1 = "tt.scan" (%f) <{axis = 1 : i32}> ({
+    ^bb0(%arg0: f32, %arg1: f32):
+      %mul = arith.mulf %arg0, %arg1 : f32
+      tt.scan.return %mul : f32
+    }) : (tensor<4x16xf32, #blocked>) -> tensor<4x16xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: block_pointer_dot
+  tt.func @block_pointer_dot(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>, %arg2: !tt.ptr<f32, 1>, %arg3: i64, %arg4: i64, %arg5: i64) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<32x16xf32, #dpas>
+    %0 = tt.make_tensor_ptr %arg0, [%arg3, %arg5], [%arg5, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x32xf16, #dot0>, 1>
+    %1 = tt.make_tensor_ptr %arg1, [%arg5, %arg4], [%arg4, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x16xf16, #dot1>, 1>
+    %2 = tt.make_tensor_ptr %arg2, [%arg3, %arg4], [%arg4, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x16xf32, #dpas>, 1>
+    // CHECK-COUNT-2: genx.matrix.2Dblockload {{.*}} {elem_size_in_bits = 16 : i32, tile_height = 8 : i32, tile_width = 16 : i32, transpose = false, v_blocks = 1 : i32, vnni_transform = false}
+    %3 = tt.load %0 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x32xf16, #dot0>, 1> -> tensor<32x32xf16, #dot0>
+    // CHECK-COUNT-2: genx.matrix.2Dblockload {{.*}} {elem_size_in_bits = 16 : i32, tile_height = 16 : i32, tile_width = 16 : i32, transpose = false, v_blocks = 1 : i32, vnni_transform = true}
+    %4 = tt.load %1 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x16xf16, #dot1>, 1> -> tensor<32x16xf16, #dot1>
+    // CHECK-COUNT-2: genx.matrix.dpas
+    %5 = tt.dot %3, %4, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<32x32xf16, #dot0> * tensor<32x16xf16, #dot1> -> tensor<32x16xf32, #dpas>
+    // CHECK: genx.matrix.2Dblockstore {{.*}} {elem_size_in_bits = 32 : i32, tile_height = 8 : i32, tile_width = 16 : i32, transpose = false, v_blocks = 1 : i32, vnni_transform = false}
+    tt.store %2, %5 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32} : !tt.ptr<tensor<32x16xf32, #dpas>, 1>, tensor<32x16xf32, #dpas>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: column_major_block_pointer_load
+  tt.func @column_major_block_pointer_load(%arg0: !tt.ptr<f16, 1>, %arg1: i64, %arg2: i64) -> tensor<32x16xf16, #dot1> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %0 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%c1_i64, %arg1], [%c0_i32, %c0_i32] {order = array<i32: 0, 1>} : <tensor<32x16xf16, #dot1>, 1>
+    // COM: Each lane reads its column of 16 halves as 8 dwords of a transposed 16x8 block.
+    // CHECK-COUNT-2: genx.matrix.2Dblockload {{.*}} {elem_size_in_bits = 32 : i32, tile_height = 16 : i32, tile_width = 8 : i32, transpose = true, v_blocks = 1 : i32, vnni_transform = false}
+    %1 = tt.load %0 {cache = 1 : i32, evict = 1 : i32, isVolatile = false, triton_gpu.column_major} : !tt.ptr<tensor<32x16xf16, #dot1>, 1> -> tensor<32x16xf16, #dot1>
+    tt.return %1 : tensor<32x16xf16, #dot1>
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: load_pages
+  tt.func @load_pages(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<i32, 1>, %arg2: i64, %arg3: i64) -> tensor<32x16xf16, #dot1> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %0 = tt.make_tensor_ptr %arg0, [%arg2, %arg3], [%arg3, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x16xf16, #dot1>, 1>
+    // COM: Each 16x16 tile is read from the row of its page.
+    // CHECK: llvm.getelementptr {{.*}} : (!llvm.ptr<1>, i32) -> !llvm.ptr<1>, i32
+    // CHECK: llvm.load {{.*}} : !llvm.ptr<1> -> i32
+    // CHECK: genx.matrix.2Dblockload {{.*}} {elem_size_in_bits = 16 : i32, tile_height = 16 : i32, tile_width = 16 : i32, transpose = false, v_blocks = 1 : i32, vnni_transform = true}
+    // CHECK: llvm.getelementptr {{.*}} : (!llvm.ptr<1>, i32) -> !llvm.ptr<1>, i32
+    // CHECK: llvm.load {{.*}} : !llvm.ptr<1> -> i32
+    // CHECK: genx.matrix.2Dblockload {{.*}} {elem_size_in_bits = 16 : i32, tile_height = 16 : i32, tile_width = 16 : i32, transpose = false, v_blocks = 1 : i32, vnni_transform = true}
+    %1 = tt.load_pages %0, %arg1 {pageSize = 16 : i32} : !tt.ptr<tensor<32x16xf16, #dot1>, 1>, !tt.ptr<i32, 1> -> tensor<32x16xf16, #dot1>
+    tt.return %1 : tensor<32x16xf16, #dot1>
+  }
+}
+
+// -----
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK: llvm.func spir_funccc @__builtin_IB_lsc_store_global_uint(!llvm.ptr<1>, i32, i32, i32)
+  // CHECK: llvm.func spir_funccc @__builtin_IB_lsc_load_global_uint(!llvm.ptr<1>, i32, i32) -> i32
+  // CHECK-LABEL: load_store_cache_hints
+  tt.func @load_store_cache_hints(%src : tensor<64x!tt.ptr<f32, 1>, #blocked0>, %dst : tensor<64x!tt.ptr<f32, 1>, #blocked0>) {
+    // COM: .cg loads bypass L1.
+    // CHECK: llvm.call spir_funccc @__builtin_IB_lsc_load_global_uint({{.*}}) : (!llvm.ptr<1>, i32, i32) -> i32
+    %0 = tt.load %src {cache = 3 : i32, evict = 1 : i32, isVolatile = false} : tensor<64xf32, #blocked0>
+    // COM: .cs stores stream through L1 and bypass L3.
+    // CHECK: llvm.call spir_funccc @__builtin_IB_lsc_store_global_uint({{.*}}) : (!llvm.ptr<1>, i32, i32, i32) -> ()
+    tt.store %dst, %0 {cache = 5 : i32, evict = 1 : i32} : tensor<64xf32, #blocked0>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK: llvm.func spir_funccc @__builtin_IB_subgroup_block_write_cacheopts_u32_m8k16v1(i64, i32, i32, i32, vector<2xi32>, vector<8xi32>, i32)
+  // CHECK-LABEL: block_pointer_store_cache_hints
+  tt.func @block_pointer_store_cache_hints(%arg0: !tt.ptr<f32, 1>, %arg1: i64, %arg2: i64, %arg3: tensor<32x16xf32, #dpas>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %0 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%arg2, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x16xf32, #dpas>, 1>
+    // COM: The .cs block writes stream through L1 and bypass L3 (L1S_L3UC).
+    // CHECK-NOT: genx.matrix.2Dblockstore
+    // CHECK: llvm.call spir_funccc @__builtin_IB_subgroup_block_write_cacheopts_u32_m8k16v1({{.*}}) : (i64, i32, i32, i32, vector<2xi32>, vector<8xi32>, i32) -> ()
+    // CHECK-NOT: genx.matrix.2Dblockstore
+    tt.store %0, %arg3 {boundaryCheck = array<i32: 0, 1>, cache = 5 : i32, evict = 1 : i32} : !tt.ptr<tensor<32x16xf32, #dpas>, 1>, tensor<32x16xf32, #dpas>
+    tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK: llvm.func spir_funccc @__builtin_IB_lsc_prefetch_global_uint(!llvm.ptr<1>, i32, i32)
+  // CHECK-LABEL: prefetch_block_pointer
+  tt.func @prefetch_block_pointer(%arg0: !tt.ptr<f16, 1>, %arg1: i64, %arg2: i64) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %0 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%arg2, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<64x32xf16, #dot0>, 1>
+    // COM: The 64 cache lines of the block are prefetched by the 64 work-items.
+    // CHECK: llvm.cond_br {{.*}}, ^bb1, ^bb2
+    // CHECK-NEXT: ^bb1:
+    // CHECK: [[ADDR:%.*]] = llvm.getelementptr {{.*}} : (!llvm.ptr<1>, i64) -> !llvm.ptr<1>, i8
+    // CHECK: [[CC:%.*]] = llvm.mlir.constant(4 : i32) : i32
+    // CHECK: llvm.call spir_funccc @__builtin_IB_lsc_prefetch_global_uint([[ADDR]], {{.*}}, [[CC]])
+    // CHECK-NOT: llvm.call spir_funccc @__builtin_IB_lsc_prefetch_global_uint
+    triton_gpu.prefetch %0 : !tt.ptr<tensor<64x32xf16, #dot0>, 1>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [1], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-DAG: llvm.func spir_funccc @_Z27__spirv_ConvertBF16ToFINTELt(i16) -> f32
+  // CHECK-DAG: llvm.func spir_funccc @_Z27__spirv_ConvertFToBF16INTELf(f32) -> i16
+  // CHECK-LABEL: bf16_conversions
+  tt.func @bf16_conversions(%in0: tensor<128xbf16, #blocked>, %in1: tensor<128xf32, #blocked>, %in2: tensor<128xf8E5M2, #blocked>) {
+    // CHECK-COUNT-4: llvm.call spir_funccc @_Z27__spirv_ConvertBF16ToFINTELt({{.*}}) : (i16) -> f32
+    %out0 = arith.extf %in0 : tensor<128xbf16, #blocked> to tensor<128xf32, #blocked>
+    // CHECK-COUNT-4: llvm.call spir_funccc @_Z27__spirv_ConvertFToBF16INTELf({{.*}}) : (f32) -> i16
+    %out1 = arith.truncf %in1 : tensor<128xf32, #blocked> to tensor<128xbf16, #blocked>
+    // COM: fp8 -> bf16 goes through the packed fp8 -> f16 sequence.
+    // CHECK-COUNT-4: llvm.call spir_funccc @_Z27__spirv_ConvertFToBF16INTELf({{.*}}) : (f32) -> i16
+    %out2 = tt.fp_to_fp %in2 : tensor<128xf8E5M2, #blocked> -> tensor<128xbf16, #blocked>
+    // CHECK-COUNT-4: llvm.call spir_funccc @_Z27__spirv_ConvertBF16ToFINTELt({{.*}}) : (i16) -> f32
+    %out3 = tt.fp_to_fp %in0 {rounding = 1 : i32} : tensor<128xbf16, #blocked> -> tensor<128xf16, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [1], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: fp8e4nv_to_fp16
+  tt.func @fp8e4nv_to_fp16(%in0: tensor<128xf8E4M3FNUZ, #blocked>) {
+    // COM: The fp8 values are rescaled with a f16 multiply, two at a time.
+    // CHECK-NOT: llvm.extractelement {{.*}} : vector<8xi32>
+    // CHECK-COUNT-2: llvm.fmul {{.*}} : vector<2xf16>
+    // CHECK-NOT: llvm.extractelement {{.*}} : vector<8xi32>
+    %out0 = tt.fp_to_fp %in0 : tensor<128xf8E4M3FNUZ, #blocked> -> tensor<128xf16, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK: llvm.func spir_funccc @_Z22__spirv_ControlBarrieriii(i32, i32, i32)
+  // CHECK-LABEL: sub_group_barrier
+  tt.func @sub_group_barrier() {
+    // CHECK: [[SCOPE:%.*]] = llvm.mlir.constant(3 : i32) : i32
+    // CHECK-NEXT: [[SCOPE1:%.*]] = llvm.mlir.constant(3 : i32) : i32
+    // CHECK-NEXT: [[SEMANTICS:%.*]] = llvm.mlir.constant(264 : i32) : i32
+    // CHECK-NEXT: llvm.call spir_funccc @_Z22__spirv_ControlBarrieriii([[SCOPE]], [[SCOPE1]], [[SEMANTICS]]) : (i32, i32, i32) -> ()
+    // CHECK-NOT: genx.barrier
+    gpu.barrier {sub_group}
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: Each sub-group computes the histogram of its values with ballots in
+  // COM: its own copy, the copies are then summed without atomics.
+  // CHECK-LABEL: histogram
+  tt.func @histogram(%arg0: tensor<256xi32, #blocked>) -> tensor<16xi32, #blocked1> {
+    // CHECK-COUNT-16: llvm.call spir_funccc @_Z29__spirv_GroupNonUniformBallotib({{.*}}) : (i32, i1) -> vector<4xi32>
+    // CHECK-NOT: llvm.atomicrmw
+    // CHECK: genx.barrier
+    // CHECK-COUNT-4: llvm.load {{.*}} : !llvm.ptr<3> -> i32
+    %0 = tt.histogram %arg0 : tensor<256xi32, #blocked> -> tensor<16xi32, #blocked1>
+    tt.return %0 : tensor<16xi32, #blocked1>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [1], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: The elements of a sub-group are sorted within the registers of the
+  // COM: lanes and with shuffles across them, without the shared memory: the 10
+  // COM: exchanges at the distances 4 to 32 shuffle the 4 elements of a lane.
+  // CHECK-LABEL: sort_sub_group
+  tt.func @sort_sub_group(%arg0: tensor<64xf32, #blocked>) -> tensor<64xf32, #blocked> {
+    // CHECK-NOT: genx.barrier
+    // CHECK-COUNT-40: genx.sub_group_shuffle
+    // CHECK-NOT: genx.barrier
+    // CHECK: llvm.return
+    %0 = tt.sort %arg0 {axis = 0 : i32, descending = false} : tensor<64xf32, #blocked>
+    tt.return %0 : tensor<64xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: The elements of the sub-groups are merged through the shared memory,
+  // COM: through which the largest ones are then gathered into the result.
+  // CHECK-LABEL: topk
+  tt.func @topk(%arg0: tensor<256xf32, #blocked>) -> tensor<16xf32, #blocked1> {
+    // CHECK: genx.sub_group_shuffle
+    // CHECK: llvm.store {{.*}} : f32, !llvm.ptr<3>
+    // CHECK: genx.barrier
+    // CHECK: llvm.load {{.*}} : !llvm.ptr<3> -> f32
+    // CHECK: genx.barrier
+    // CHECK: genx.sub_group_shuffle
+    // CHECK: genx.barrier
+    // CHECK: llvm.load {{.*}} : !llvm.ptr<3> -> f32
+    // CHECK: llvm.return
+    %0 = tt.topk %arg0 {axis = 0 : i32, k = 16 : i32} : tensor<256xf32, #blocked> -> tensor<16xf32, #blocked1>
+    tt.return %0 : tensor<16xf32, #blocked1>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [1], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: The elements are stored and gathered one by one, at their offsets,
+  // COM: fenced by a barrier of the membar analysis.
+  // CHECK-LABEL: local_buffer
+  tt.func @local_buffer(%arg0: tensor<16xf32, #blocked>, %arg1: tensor<16xi32, #blocked>) -> tensor<16xf32, #blocked> {
+    // CHECK: llvm.store {{.*}} : f32, !llvm.ptr<3>
+    // CHECK: genx.barrier
+    // CHECK: [[OFFSET:%.*]] = llvm.extractvalue %arg1[0]
+    // CHECK: llvm.getelementptr {{.*}}[[[OFFSET]]] : (!llvm.ptr<3>, i32) -> !llvm.ptr<3>
+    // CHECK-NEXT: llvm.load {{.*}} : !llvm.ptr<3> -> f32
+    %0 = triton_gpu.alloc_tensor : tensor<16xf32, #shared>
+    tt.local_store %0, %arg0 : tensor<16xf32, #shared>, tensor<16xf32, #blocked>
+    %1 = tt.local_load %0[%arg1] : tensor<16xf32, #shared>, tensor<16xi32, #blocked> -> tensor<16xf32, #blocked>
+    tt.return %1 : tensor<16xf32, #blocked>
+  }
+}
+
+// -----
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // COM: The named barriers map to the split barrier of the work-group.
+  // CHECK-LABEL: split_barrier
+  tt.func @split_barrier(%bar: i32, %num_threads: i32) {
+    // CHECK: [[SCOPE:%.*]] = llvm.mlir.constant(2 : i32) : i32
+    // CHECK-NEXT: [[SCOPE1:%.*]] = llvm.mlir.constant(2 : i32) : i32
+    // CHECK-NEXT: [[SEMANTICS:%.*]] = llvm.mlir.constant(264 : i32) : i32
+    // CHECK-NEXT: llvm.call spir_funccc @_Z33__spirv_ControlBarrierArriveINTELiii([[SCOPE]], [[SCOPE1]], [[SEMANTICS]]) : (i32, i32, i32) -> ()
+    triton_nvidia_gpu.bar_arrive %bar, %num_threads : i32, i32
+    // CHECK: llvm.call spir_funccc @_Z31__spirv_ControlBarrierWaitINTELiii({{.*}}) : (i32, i32, i32) -> ()
+    triton_nvidia_gpu.bar_wait %bar, %num_threads : i32, i32
+    tt.return
+  }
+}
+
+// -----
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: A barrier of a subset of the sub-groups is a named barrier for them,
+  // COM: initialized once at the entry of the function.
+  // CHECK-LABEL: named_barrier
+  tt.func @named_barrier() {
+    // CHECK: [[COUNT:%.*]] = llvm.mlir.constant(2 : i32) : i32
+    // CHECK-NEXT: [[BARRIER:%.*]] = llvm.call spir_funccc @_Z30__spirv_NamedBarrierInitializei([[COUNT]]) {{.*}}triton_gpu.named_barrier_id = 1 : i64{{.*}} : (i32) -> !llvm.ptr<3>
+    // CHECK-NOT: @_Z30__spirv_NamedBarrierInitializei
+    // CHECK-COUNT-2: llvm.call spir_funccc @_Z26__spirv_MemoryNamedBarrierPU3AS3iii([[BARRIER]], {{.*}}) : (!llvm.ptr<3>, i32, i32) -> ()
+    // CHECK-NOT: llvm.inline_asm
+    gpu.barrier {bar_id = 1 : i64, num_threads = 32 : i64}
+    gpu.barrier {bar_id = 1 : i64, num_threads = 32 : i64}
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [1], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: The 4 contiguous offsets of a thread are the 4 words of one counter.
+  // CHECK-LABEL: philox_contiguous
+  tt.func @philox_contiguous(%seed: i64) -> tensor<64xi32, #blocked> {
+    // CHECK-COUNT-2: llvm.mul {{.*}} : i64
+    // CHECK-NOT: llvm.mul {{.*}} : i64
+    // CHECK-NOT: llvm.select
+    %0 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #blocked>
+    %1 = tt.splat %seed : (i64) -> tensor<64xi64, #blocked>
+    %2 = tt.philox %1, %0 {n_rounds = 1 : i32} : tensor<64xi64, #blocked>, tensor<64xi32, #blocked> -> tensor<64xi32, #blocked>
+    tt.return %2 : tensor<64xi32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [1], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: Arbitrary offsets select the word of their counter.
+  // CHECK-LABEL: philox_gather
+  tt.func @philox_gather(%seed: i64, %offset: tensor<64xi32, #blocked>) -> tensor<64xi32, #blocked> {
+    // CHECK-COUNT-2: llvm.mul {{.*}} : i64
+    // CHECK-COUNT-3: llvm.select
+    // CHECK-COUNT-2: llvm.mul {{.*}} : i64
+    // CHECK-COUNT-3: llvm.select
+    // CHECK-COUNT-2: llvm.mul {{.*}} : i64
+    // CHECK-COUNT-3: llvm.select
+    // CHECK-COUNT-2: llvm.mul {{.*}} : i64
+    // CHECK-COUNT-3: llvm.select
+    %0 = tt.splat %seed : (i64) -> tensor<64xi64, #blocked>
+    %1 = tt.philox %0, %offset {n_rounds = 1 : i32} : tensor<64xi64, #blocked>, tensor<64xi32, #blocked> -> tensor<64xi32, #blocked>
+    tt.return %1 : tensor<64xi32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: broadcast_load_dedup
+  tt.func public @broadcast_load_dedup(%arg0: !tt.ptr<f32, 1> {tt.divisibility = 16 : i32}) -> tensor<64x16xf32, #blocked> {
+    // COM: The pointers are the same along the rows: the thread loads its row once.
+    // CHECK: llvm.intr.masked.load {{.*}} -> vector<4xi32>
+    // CHECK-NOT: llvm.intr.masked.load
+    %0 = tt.make_range {end = 16 : i32, start = 0 : i32} : tensor<16xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>
+    %1 = tt.expand_dims %0 {axis = 0 : i32} : (tensor<16xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>) -> tensor<1x16xi32, #blocked>
+    %2 = tt.broadcast %1 : (tensor<1x16xi32, #blocked>) -> tensor<64x16xi32, #blocked>
+    %3 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<64x16x!tt.ptr<f32, 1>, #blocked>
+    %4 = tt.addptr %3, %2 : tensor<64x16x!tt.ptr<f32, 1>, #blocked>, tensor<64x16xi32, #blocked>
+    %5 = tt.load %4 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x16xf32, #blocked>
+    tt.return %5 : tensor<64x16xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-DAG: llvm.func spir_funccc @_Z15__spirv_ocl_expDv4_f(vector<4xf32>) -> vector<4xf32>
+  // CHECK-DAG: llvm.func spir_funccc @_Z15__spirv_ocl_powDv4_fS_(vector<4xf32>, vector<4xf32>) -> vector<4xf32>
+  // CHECK-DAG: llvm.func @__imf_erfcxf(f32) -> f32
+  // CHECK-LABEL: extern_elementwise_vector_math
+  tt.func public @extern_elementwise_vector_math(%arg0: tensor<256xf32, #blocked>, %arg1: tensor<256xf32, #blocked>) {
+    // COM: The four elements of the thread are computed by the vector builtins.
+    // CHECK-COUNT-4: llvm.insertelement
+    // CHECK: llvm.call spir_funccc @_Z15__spirv_ocl_expDv4_f
+    // CHECK-COUNT-4: llvm.extractelement
+    // CHECK-NOT: llvm.call spir_funccc @_Z15__spirv_ocl_exp
+    %0 = tt.extern_elementwise %arg0 {libname = "libsycl", libpath = "libsycl-spir64-unknown-unknown.bc", pure = true, symbol = "__imf_expf"} : (tensor<256xf32, #blocked>) -> tensor<256xf32, #blocked>
+    // CHECK-COUNT-8: llvm.insertelement
+    // CHECK: llvm.call spir_funccc @_Z15__spirv_ocl_powDv4_fS_
+    // CHECK-COUNT-4: llvm.extractelement
+    %1 = tt.extern_elementwise %0, %arg1 {libname = "libsycl", libpath = "libsycl-spir64-unknown-unknown.bc", pure = true, symbol = "__imf_powf"} : (tensor<256xf32, #blocked>, tensor<256xf32, #blocked>) -> tensor<256xf32, #blocked>
+    // COM: The functions without builtins are still called per element.
+    // CHECK-COUNT-4: llvm.call spir_funccc @__imf_erfcxf
+    %2 = tt.extern_elementwise %1 {libname = "libsycl", libpath = "libsycl-spir64-unknown-unknown.bc", pure = true, symbol = "__imf_erfcxf"} : (tensor<256xf32, #blocked>) -> tensor<256xf32, #blocked>
+    tt.return
+  }
+}
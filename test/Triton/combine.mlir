@@ -191,6 +191,58 @@ tt.func @test_canonicalize_masked_store_fail_pattern(%ptr: tensor<8x!tt.ptr<f32>
     tt.return
 }
 
+// CHECK-LABEL: @test_combine_guarded_mask_pattern
+tt.func @test_combine_guarded_mask_pattern(%ptr: tensor<8x!tt.ptr<f32>>, %cond: i1, %cond1: i1) {
+    %mask = tt.splat %cond : (i1) -> tensor<8xi1>
+    %mask1 = tt.splat %cond1 : (i1) -> tensor<8xi1>
+    %other_val = arith.constant dense<0.0> : tensor<8xf32>
+    // CHECK: scf.if
+    scf.if %cond {
+      // CHECK-NEXT: %[[x:.*]] = tt.load %{{.*}} {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<8xf32>
+      %x = tt.load %ptr, %mask, %other_val {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<8xf32>
+      // CHECK-NEXT: tt.store %{{.*}}, %[[x]] : tensor<8xf32>
+      tt.store %ptr, %x, %mask : tensor<8xf32>
+      // The mask of another condition is kept.
+      // CHECK-NEXT: tt.store %{{.*}}, %[[x]], %{{.*}} : tensor<8xf32>
+      tt.store %ptr, %x, %mask1 : tensor<8xf32>
+    } else {
+      // CHECK: tt.store %{{.*}}, %{{.*}}, %{{.*}} : tensor<8xf32>
+      tt.store %ptr, %other_val, %mask : tensor<8xf32>
+    }
+    tt.return
+}
+
+// CHECK-LABEL: @test_combine_select_masked_store_pattern
+tt.func @test_combine_select_masked_store_pattern(%ptr: tensor<8x!tt.ptr<f32>>, %val: tensor<8xf32>, %mask: tensor<8xi1>) {
+    %other_val = arith.constant dense<0.0> : tensor<8xf32>
+    // CHECK-NOT: arith.select
+    // CHECK: tt.store %{{.*}}, %{{.*}}, %{{.*}} : tensor<8xf32>
+    %0 = arith.select %mask, %val, %other_val : tensor<8xi1>, tensor<8xf32>
+    tt.store %ptr, %0, %mask : tensor<8xf32>
+    tt.return
+}
+
+// CHECK-LABEL: @test_combine_unused_load_other_pattern
+tt.func @test_combine_unused_load_other_pattern(%ptr: tensor<8x!tt.ptr<f32>>, %mask: tensor<8xi1>, %mask1: tensor<8xi1>) -> tensor<8xf32> {
+    %other_val = arith.constant dense<0.0> : tensor<8xf32>
+    %one = arith.constant dense<1.0> : tensor<8xf32>
+    // The masked lanes of the load are only stored under the same mask.
+    // CHECK: %[[x:.*]] = tt.load %{{.*}}, %{{.*}} {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<8xf32>
+    %x = tt.load %ptr, %mask, %other_val {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<8xf32>
+    %0 = arith.addf %x, %one : tensor<8xf32>
+    %1 = math.exp %0 : tensor<8xf32>
+    tt.store %ptr, %1, %mask : tensor<8xf32>
+    // The masked lanes of the load are returned.
+    // CHECK: %[[y:.*]] = tt.load %{{.*}}, %{{.*}}, %{{.*}} {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<8xf32>
+    %y = tt.load %ptr, %mask, %other_val {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<8xf32>
+    %2 = arith.addf %y, %one : tensor<8xf32>
+    // The masked lanes of the load are stored under another mask.
+    // CHECK: %[[z:.*]] = tt.load %{{.*}}, %{{.*}}, %{{.*}} {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<8xf32>
+    %z = tt.load %ptr, %mask, %other_val {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<8xf32>
+    tt.store %ptr, %z, %mask1 : tensor<8xf32>
+    tt.return %2 : tensor<8xf32>
+}
+
 // CHECK-LABEL: @test_canonicalize_expand_dims
 tt.func @test_canonicalize_expand_dims(%arg0: tensor<f32>, %arg1: tensor<1xf32>) -> (tensor<1x8xf32>, tensor<8x8xf32>) {
     %splat = tt.splat %arg0 : (tensor<f32>) -> tensor<8xf32>
@@ -0,0 +1,74 @@
+// RUN: triton-opt %s -split-input-file -triton-fold-masks | FileCheck %s
+
+// CHECK-LABEL: @fold_range_mask
+tt.func @fold_range_mask(%arg0: !tt.ptr<f32>) -> tensor<64xf32> {
+  // CHECK: %[[TRUE:.*]] = arith.constant dense<true> : tensor<64xi1>
+  // CHECK-NOT: arith.cmpi
+  // CHECK: tt.load %{{.*}}, %[[TRUE]]
+  %c64 = arith.constant dense<64> : tensor<64xi32>
+  %0 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+  %1 = arith.cmpi slt, %0, %c64 : tensor<64xi32>
+  %2 = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<64x!tt.ptr<f32>>
+  %3 = tt.addptr %2, %0 : tensor<64x!tt.ptr<f32>>, tensor<64xi32>
+  %4 = tt.load %3, %1 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64xf32>
+  tt.return %4 : tensor<64xf32>
+}
+
+// -----
+
+// COM: The program id is non-negative, but the bound of the offsets depends
+// COM: on the number of elements.
+// CHECK-LABEL: @fold_pid_mask
+tt.func @fold_pid_mask(%arg0: i32) -> (i1, tensor<64xi1>) {
+  // CHECK-DAG: %[[TRUE:.*]] = arith.constant true
+  // CHECK-DAG: %[[LT:.*]] = arith.cmpi slt
+  // CHECK-NOT: arith.cmpi
+  // CHECK: tt.return %[[TRUE]], %[[LT]]
+  %c0_i32 = arith.constant 0 : i32
+  %c64_i32 = arith.constant 64 : i32
+  %0 = tt.get_program_id x : i32
+  %1 = arith.cmpi sge, %0, %c0_i32 : i32
+  %2 = arith.muli %0, %c64_i32 : i32
+  %3 = tt.splat %2 : (i32) -> tensor<64xi32>
+  %4 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+  %5 = arith.addi %3, %4 : tensor<64xi32>
+  %6 = tt.splat %arg0 : (i32) -> tensor<64xi32>
+  %7 = arith.cmpi slt, %5, %6 : tensor<64xi32>
+  tt.return %1, %7 : i1, tensor<64xi1>
+}
+
+// -----
+
+// COM: The offsets of the programs may wrap around, nothing is folded.
+// CHECK-LABEL: @overflow
+tt.func @overflow() -> tensor<64xi1> {
+  // CHECK: arith.cmpi sge
+  %c1024_i32 = arith.constant 1024 : i32
+  %zero = arith.constant dense<0> : tensor<64xi32>
+  %0 = tt.get_program_id x : i32
+  %1 = arith.muli %0, %c1024_i32 : i32
+  %2 = tt.splat %1 : (i32) -> tensor<64xi32>
+  %3 = arith.cmpi sge, %2, %zero : tensor<64xi32>
+  tt.return %3 : tensor<64xi1>
+}
+
+// -----
+
+// CHECK-LABEL: @fold_loop_mask
+tt.func @fold_loop_mask() -> tensor<32xi1> {
+  // CHECK: %[[FALSE:.*]] = arith.constant dense<false> : tensor<32xi1>
+  // CHECK: scf.yield %[[FALSE]]
+  %c0 = arith.constant 0 : i32
+  %c32 = arith.constant 32 : i32
+  %c128 = arith.constant 128 : i32
+  %c256 = arith.constant dense<256> : tensor<32xi32>
+  %init = arith.constant dense<true> : tensor<32xi1>
+  %0 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32>
+  %1 = scf.for %iv = %c0 to %c128 step %c32 iter_args(%arg = %init) -> (tensor<32xi1>) : i32 {
+    %2 = tt.splat %iv : (i32) -> tensor<32xi32>
+    %3 = arith.addi %2, %0 : tensor<32xi32>
+    %4 = arith.cmpi uge, %3, %c256 : tensor<32xi32>
+    scf.yield %4 : tensor<32xi1>
+  }
+  tt.return %1 : tensor<32xi1>
+}
@@ -113,3 +113,51 @@ tt.func public @fn(%arg0: tensor<32x32xf32, #blocked>) {
     tt.return
 }
 }  // end module
+
+// -----
+
+tt.func public @unpack_int4_shape(%arg0: tensor<32x32xi8>) {
+    // expected-error @+1 {{twice as many rows}}
+    %a = tt.unpack_int4 %arg0 {is_signed = true} : tensor<32x32xi8> -> tensor<32x64xf16>
+    tt.return
+}
+
+// -----
+
+tt.func public @sort_axis_size(%arg0: tensor<8x24xf32>) {
+    // expected-error @+1 {{power of two}}
+    %a = tt.sort %arg0 {axis = 1 : i32, descending = false} : tensor<8x24xf32>
+    tt.return
+}
+
+// -----
+
+tt.func public @topk_shape(%arg0: tensor<8x32xf32>) {
+    // expected-error @+1 {{k elements along the axis}}
+    %a = tt.topk %arg0 {axis = 1 : i32, k = 4 : i32} : tensor<8x32xf32> -> tensor<4x32xf32>
+    tt.return
+}
+
+// -----
+
+tt.func public @load_pages_page_size(%arg0: !tt.ptr<tensor<48x64xf16>>, %arg1: !tt.ptr<i32>) {
+    // expected-error @+1 {{multiple of the page size}}
+    %a = tt.load_pages %arg0, %arg1 {pageSize = 32 : i32} : !tt.ptr<tensor<48x64xf16>>, !tt.ptr<i32> -> tensor<48x64xf16>
+    tt.return
+}
+
+// -----
+
+tt.func public @local_load_shape(%arg0: tensor<16x16xf32>, %arg1: tensor<32xi32>) {
+    // expected-error @+1 {{the shape of the offsets}}
+    %a = tt.local_load %arg0[%arg1] : tensor<16x16xf32>, tensor<32xi32> -> tensor<16xf32>
+    tt.return
+}
+
+// -----
+
+tt.func public @local_store_element_type(%arg0: tensor<16x16xf32>, %arg1: tensor<16x16xf16>) {
+    // expected-error @+1 {{the element type of the buffer}}
+    tt.local_store %arg0, %arg1 : tensor<16x16xf32>, tensor<16x16xf16>
+    tt.return
+}
@@ -0,0 +1,186 @@
+// RUN: triton-opt %s -split-input-file --tritonintelgpu-accelerate-matmul=device-architecture=pvc | FileCheck %s
+// RUN: triton-opt %s -split-input-file --tritonintelgpu-accelerate-matmul=device-architecture=ats | FileCheck %s --check-prefix=CHECK-ATS
+// RUN: triton-opt %s -split-input-file --tritonintelgpu-accelerate-matmul="device-architecture=pvc repeat-count=8" | FileCheck %s --check-prefix=CHECK-RC8
+
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+// CHECK-ATS-NOT: triton_gpu.dpas
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dot_f16
+  tt.func public @dot_f16(
+    %a: tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<128x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #blocked>
+    // CHECK: triton_gpu.convert_layout {{.*}} -> tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #[[DPAS]]}>>
+    // CHECK: triton_gpu.convert_layout {{.*}} -> tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>
+    // CHECK: tt.dot {{.*}} -> tensor<128x64xf32, #[[DPAS]]>
+    %d = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} :
+      tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<128x64xf32, #blocked>
+    tt.return %d : tensor<128x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// CHECK-NOT: triton_gpu.dpas
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dot_f32_no_tf32
+  tt.func public @dot_f32_no_tf32(
+    %a: tensor<128x32xf32, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<32x64xf32, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<128x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #blocked>
+    // CHECK: tt.dot {{.*}} -> tensor<128x64xf32, #blocked>
+    %d = tt.dot %a, %b, %cst {allowTF32 = false, maxNumImpreciseAcc = 0 : i32} :
+      tensor<128x32xf32, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf32, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<128x64xf32, #blocked>
+    tt.return %d : tensor<128x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// CHECK-NOT: triton_gpu.dpas
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [2, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // CHECK-LABEL: dot_sub_group_32
+  tt.func public @dot_sub_group_32(
+    %a: tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<128x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #blocked>
+    // CHECK: tt.dot {{.*}} -> tensor<128x64xf32, #blocked>
+    %d = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} :
+      tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<128x64xf32, #blocked>
+    tt.return %d : tensor<128x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dot_f16_f8
+  tt.func public @dot_f16_f8(
+    %a: tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<32x64xf8E5M2, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<128x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #blocked>
+    // COM: The fp8 operand is upcast before it is converted to the DPAS layout.
+    // CHECK: %[[B:.*]] = tt.fp_to_fp %{{.*}} : tensor<32x64xf8E5M2, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>
+    // CHECK: triton_gpu.convert_layout {{.*}} -> tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #[[DPAS]]}>>
+    // CHECK: triton_gpu.convert_layout %[[B]] {{.*}} -> tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>
+    // CHECK: tt.dot {{.*}} -> tensor<128x64xf32, #[[DPAS]]>
+    %d = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} :
+      tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf8E5M2, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<128x64xf32, #blocked>
+    tt.return %d : tensor<128x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dot_bf16_f8e4nv
+  tt.func public @dot_bf16_f8e4nv(
+    %a: tensor<128x32xbf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<32x64xf8E4M3FNUZ, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<128x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #blocked>
+    // COM: The fp8 operand is upcast to the type of the other operand.
+    // CHECK: %[[B:.*]] = tt.fp_to_fp %{{.*}} : tensor<32x64xf8E4M3FNUZ, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<32x64xbf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>
+    // CHECK: triton_gpu.convert_layout %[[B]] {{.*}} -> tensor<32x64xbf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>
+    // CHECK: tt.dot {{.*}} -> tensor<128x64xf32, #[[DPAS]]>
+    %d = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} :
+      tensor<128x32xbf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf8E4M3FNUZ, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<128x64xf32, #blocked>
+    tt.return %d : tensor<128x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dot_i8
+  tt.func public @dot_i8(
+    %a: tensor<128x32xi8, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<32x64xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<128x64xi32, #blocked> {
+    %cst = arith.constant dense<0> : tensor<128x64xi32, #blocked>
+    // CHECK: triton_gpu.convert_layout {{.*}} -> tensor<128x32xi8, #triton_gpu.dot_op<{opIdx = 0, parent = #[[DPAS]]}>>
+    // CHECK: triton_gpu.convert_layout {{.*}} -> tensor<32x64xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>
+    // CHECK: tt.dot {{.*}} -> tensor<128x64xi32, #[[DPAS]]>
+    %d = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} :
+      tensor<128x32xi8, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<128x64xi32, #blocked>
+    tt.return %d : tensor<128x64xi32, #blocked>
+  }
+}
+
+// -----
+
+// COM: The rows of skinny tiles are split across the warps with a smaller
+// COM: repeat count, unless the repeat count is forced.
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 4, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+// CHECK-RC8: #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dot_skinny
+  tt.func public @dot_skinny(
+    %a: tensor<16x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<32x16xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<16x16xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<16x16xf32, #blocked>
+    // CHECK: tt.dot {{.*}} -> tensor<16x16xf32, #[[DPAS]]>
+    %d = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} :
+      tensor<16x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x16xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<16x16xf32, #blocked>
+    tt.return %d : tensor<16x16xf32, #blocked>
+  }
+}
+
+// -----
+
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: dot_f16_int4
+  tt.func public @dot_f16_int4(
+    %a: tensor<128x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<32x64xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<128x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #blocked>
+    // COM: The packed operand is converted to the DPAS layout and unpacked in it.
+    // CHECK: %[[B:.*]] = triton_gpu.convert_layout %{{.*}} -> tensor<32x64xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>
+    // CHECK: %[[UNPACKED:.*]] = tt.unpack_int4 %[[B]] {is_signed = true} : tensor<32x64xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>> -> tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>
+    // CHECK: tt.dot %{{.*}}, %[[UNPACKED]], %{{.*}} {{.*}} -> tensor<128x64xf32, #[[DPAS]]>
+    %unpacked = tt.unpack_int4 %b {is_signed = true} : tensor<32x64xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>
+    %d = tt.dot %a, %unpacked, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} :
+      tensor<128x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<128x64xf32, #blocked>
+    tt.return %d : tensor<128x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// COM: The dot of a single row is the reduction along K of the products laid
+// COM: out like the loads of B, each work-item holding the row.
+// CHECK: #[[PRODUCT:.+]] = #triton_gpu.blocked<{sizePerThread = [1, 1, 4], threadsPerWarp = [1, 1, 16], warpsPerCTA = [1, 4, 1], order = [2, 1, 0], CTAsPerCGA = [1, 1, 1], CTASplitNum = [1, 1, 1], CTAOrder = [2, 1, 0]}>
+// CHECK-ATS: #[[PRODUCT:.+]] = #triton_gpu.blocked<{sizePerThread = [1, 1, 4]
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [1, 4], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: gemv
+  tt.func public @gemv(%a: tensor<1x128xf16, #blocked1>, %b: tensor<128x64xf16, #blocked>) -> tensor<1x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<1x64xf32, #blocked>
+    %0 = triton_gpu.convert_layout %a : (tensor<1x128xf16, #blocked1>) -> tensor<1x128xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>
+    %1 = triton_gpu.convert_layout %b : (tensor<128x64xf16, #blocked>) -> tensor<128x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>
+    // CHECK-NOT: tt.dot
+    // CHECK: tt.fp_to_fp {{.*}} : tensor<1x128xf16, #blocked1> -> tensor<1x128xf32, #blocked1>
+    // CHECK: tt.expand_dims {{.*}} {axis = 2 : i32} : (tensor<1x128xf32, #triton_gpu.slice<{dim = 2, parent = #[[PRODUCT]]}>>) -> tensor<1x128x1xf32, #[[PRODUCT]]>
+    // CHECK: tt.fp_to_fp {{.*}} : tensor<128x64xf16, #blocked> -> tensor<128x64xf32, #blocked>
+    // CHECK: tt.expand_dims {{.*}} {axis = 0 : i32} : (tensor<128x64xf32, #triton_gpu.slice<{dim = 0, parent = #[[PRODUCT]]}>>) -> tensor<1x128x64xf32, #[[PRODUCT]]>
+    // CHECK: arith.mulf {{.*}} : tensor<1x128x64xf32, #[[PRODUCT]]>
+    // CHECK: "tt.reduce"
+    // CHECK: arith.addf
+    // CHECK: {axis = 1 : i32} : (tensor<1x128x64xf32, #[[PRODUCT]]>) -> tensor<1x64xf32, #triton_gpu.slice<{dim = 1, parent = #[[PRODUCT]]}>>
+    // CHECK: arith.addf {{.*}} : tensor<1x64xf32, #triton_gpu.slice<{dim = 1, parent = #[[PRODUCT]]}>>
+    %d = tt.dot %0, %1, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} :
+      tensor<1x128xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<128x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<1x64xf32, #blocked>
+    tt.return %d : tensor<1x64xf32, #blocked>
+  }
+}
@@ -0,0 +1,37 @@
+// RUN: triton-opt %s -split-input-file --tritonintelgpu-accelerate-matmul=device-architecture=pvc | FileCheck %s
+
+// COM: The warps are distributed to the matrices of the batch first.
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1, 1], CTAsPerCGA = [1, 1, 1], CTASplitNum = [1, 1, 1], CTAOrder = [2, 1, 0]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4, 4], threadsPerWarp = [1, 1, 16], warpsPerCTA = [4, 1, 1], order = [2, 1, 0], CTAsPerCGA = [1, 1, 1], CTASplitNum = [1, 1, 1], CTAOrder = [2, 1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: batched_dot_f16
+  tt.func public @batched_dot_f16(
+    %a: tensor<8x32x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<8x32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<8x32x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<8x32x64xf32, #blocked>
+    // CHECK: triton_gpu.convert_layout {{.*}} -> tensor<8x32x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #[[DPAS]]}>>
+    // CHECK: triton_gpu.convert_layout {{.*}} -> tensor<8x32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>
+    // CHECK: tt.dot {{.*}} -> tensor<8x32x64xf32, #[[DPAS]]>
+    %d = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} :
+      tensor<8x32x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<8x32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<8x32x64xf32, #blocked>
+    tt.return %d : tensor<8x32x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// COM: The warps left by a small batch are distributed to its matrices.
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [2, 2, 1], CTAsPerCGA = [1, 1, 1], CTASplitNum = [1, 1, 1], CTAOrder = [2, 1, 0]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4, 4], threadsPerWarp = [1, 1, 16], warpsPerCTA = [2, 2, 1], order = [2, 1, 0], CTAsPerCGA = [1, 1, 1], CTASplitNum = [1, 1, 1], CTAOrder = [2, 1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: batched_dot_small_batch
+  tt.func public @batched_dot_small_batch(
+    %a: tensor<2x64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<2x32x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<2x64x32xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<2x64x32xf32, #blocked>
+    // CHECK: tt.dot {{.*}} -> tensor<2x64x32xf32, #[[DPAS]]>
+    %d = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} :
+      tensor<2x64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<2x32x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<2x64x32xf32, #blocked>
+    tt.return %d : tensor<2x64x32xf32, #blocked>
+  }
+}
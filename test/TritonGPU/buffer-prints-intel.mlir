@@ -0,0 +1,64 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-buffer-prints | FileCheck %s
+
+// COM: The print reserves a record of 4 + 16 slots with a scalar atomic on the
+// COM: cursor, and writes its id, the program id and the values when the
+// COM: record fits in the capacity of the buffer passed last.
+// CHECK: module attributes {"triton_gpu.buffered_prints" = ["{\22args\22:[{\22shape\22:[16],\22type\22:\22f32\22}],\22kind\22:\22print\22,\22prefix\22:\22 x: \22}"]}
+// CHECK-LABEL: tt.func public @print_kernel
+// CHECK-SAME: %[[BUFFER:[a-zA-Z0-9_]+]]: !tt.ptr<i64, 1>)
+// CHECK-NOT: tt.print
+// CHECK: %[[SIZE:.*]] = arith.constant 20 : i64
+// CHECK: %[[BASE:.*]] = "tt.atomic_rmw"(%[[BUFFER]], %[[SIZE]])
+// CHECK: %[[END:.*]] = arith.addi %[[BASE]], %[[SIZE]] : i64
+// CHECK: %[[CAPACITY:.*]] = tt.load {{.*}} : i64
+// CHECK: %[[FITS:.*]] = arith.cmpi sle, %[[END]], %[[CAPACITY]] : i64
+// CHECK: tt.get_program_id x
+// CHECK: tt.get_program_id y
+// CHECK: tt.get_program_id z
+// CHECK: %[[VALUES:.*]] = arith.extf %{{.*}} : tensor<16xf32> to tensor<16xf64>
+// CHECK: %[[BITS:.*]] = arith.bitcast %[[VALUES]] : tensor<16xf64> to tensor<16xi64>
+// CHECK: tt.make_range {end = 16 : i32, start = 0 : i32}
+// CHECK: %[[MASK:.*]] = tt.splat %[[FITS]] : (i1) -> tensor<16xi1>
+// CHECK: tt.store %{{.*}}, %[[BITS]], %[[MASK]]
+module {
+  tt.func public @print_kernel(%arg0: !tt.ptr<f32, 1>) {
+    %0 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<16x!tt.ptr<f32, 1>>
+    %1 = tt.load %0 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<16xf32>
+    tt.print " x: " : %1 : tensor<16xf32>
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Each false element of the asserted condition reserves its own record
+// COM: of 5 slots, the kernel isn't stopped.
+// CHECK: module attributes {"triton_gpu.buffered_prints" = ["{\22file\22:\22kernel.py\22,\22func\22:\22assert_kernel\22,\22kind\22:\22assert\22,\22line\22:7,\22message\22:\22x > 0\22,\22shape\22:[4,8]}"]}
+// CHECK-LABEL: tt.func public @assert_kernel
+// CHECK-SAME: %[[BUFFER:[a-zA-Z0-9_]+]]: !tt.ptr<i64, 1>)
+// CHECK-NOT: tt.assert
+// CHECK: %[[FAILED:.*]] = arith.cmpi eq, %{{.*}}, %{{.*}} : tensor<4x8xi1>
+// CHECK: %[[CURSORS:.*]] = tt.splat %[[BUFFER]] : (!tt.ptr<i64, 1>) -> tensor<4x8x!tt.ptr<i64, 1>>
+// CHECK: "tt.atomic_rmw"(%[[CURSORS]], %{{.*}}, %[[FAILED]])
+// CHECK: tt.expand_dims
+// CHECK: tt.broadcast
+// CHECK: tt.store
+// CHECK-NOT: tt.assert
+module {
+  tt.func public @assert_kernel(%arg0: tensor<4x8xi1>) {
+    tt.assert %arg0, "x > 0", "kernel.py", "assert_kernel", 7 : tensor<4x8xi1>
+    tt.return
+  }
+}
+
+// -----
+
+// COM: The kernels without prints get no buffer.
+// CHECK-NOT: triton_gpu.buffered_prints
+// CHECK-LABEL: tt.func public @no_print_kernel
+// CHECK-SAME: (%{{.*}}: !tt.ptr<f32, 1>)
+module {
+  tt.func public @no_print_kernel(%arg0: !tt.ptr<f32, 1>) {
+    tt.return
+  }
+}
@@ -0,0 +1,26 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-coalesce | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritongpu-coalesce=max-vector-bits=256 | FileCheck %s --check-prefix=WIDE
+
+// COM: The sub-groups of 16 work-items access 128 bits per work-item by
+// COM: default, and 256 bits when the device supports wider messages.
+// CHECK: #[[LAYOUT:.+]] = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+// WIDE: #[[LAYOUT:.+]] = #triton_gpu.blocked<{sizePerThread = [8], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+// CHECK-LABEL: copy
+// CHECK: tt.load {{.*}} : tensor<4096xf32, #[[LAYOUT]]>
+// CHECK: tt.store {{.*}} : tensor<4096xf32, #[[LAYOUT]]>
+// WIDE-LABEL: copy
+// WIDE: tt.load {{.*}} : tensor<4096xf32, #[[LAYOUT]]>
+// WIDE: tt.store {{.*}} : tensor<4096xf32, #[[LAYOUT]]>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func @copy(%arg0: !tt.ptr<f32> {tt.divisibility = 32 : i32}, %arg1: !tt.ptr<f32> {tt.divisibility = 32 : i32}) {
+    %0 = tt.make_range {end = 4096 : i32, start = 0 : i32} : tensor<4096xi32, #blocked>
+    %1 = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<4096x!tt.ptr<f32>, #blocked>
+    %2 = tt.addptr %1, %0 : tensor<4096x!tt.ptr<f32>, #blocked>, tensor<4096xi32, #blocked>
+    %3 = tt.load %2 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<4096xf32, #blocked>
+    %4 = tt.splat %arg1 : (!tt.ptr<f32>) -> tensor<4096x!tt.ptr<f32>, #blocked>
+    %5 = tt.addptr %4, %0 : tensor<4096x!tt.ptr<f32>, #blocked>, tensor<4096xi32, #blocked>
+    tt.store %5, %3 {cache = 1 : i32, evict = 1 : i32} : tensor<4096xf32, #blocked>
+    tt.return
+  }
+}
@@ -2061,3 +2061,66 @@ module attributes {"triton_gpu.compute-capability" = 80 : i32, "triton_gpu.num-c
     tt.return %4 : tensor<1xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
   }
 }
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+// COM: The producers of the conversion to DPAS are only used by it, so they
+// COM: are rematerialized in the DPAS layout.
+// CHECK-LABEL: @dpas_remat
+//   CHECK-NOT:   triton_gpu.convert_layout
+//       CHECK:   tt.return
+  tt.func public @dpas_remat(%arg0: f32, %arg1: tensor<64x64xf32, #dpas>) -> tensor<64x64xf32, #dpas> {
+    %0 = tt.splat %arg0 : (f32) -> tensor<64x64xf32, #blocked>
+    %1 = arith.mulf %0, %0 : tensor<64x64xf32, #blocked>
+    %2 = arith.addf %1, %0 : tensor<64x64xf32, #blocked>
+    %3 = math.exp %2 : tensor<64x64xf32, #blocked>
+    %4 = triton_gpu.convert_layout %3 : (tensor<64x64xf32, #blocked>) -> tensor<64x64xf32, #dpas>
+    %5 = arith.addf %arg1, %4 : tensor<64x64xf32, #dpas>
+    tt.return %5 : tensor<64x64xf32, #dpas>
+  }
+
+// COM: The producers of the conversion to DPAS are also stored, so
+// COM: rematerializing them would duplicate more work than the conversion
+// COM: through the shared local memory costs.
+// CHECK-LABEL: @dpas_keep_convert
+//       CHECK:   %[[EXP:.*]] = math.exp {{.*}} : tensor<64x64xf32, #blocked>
+//       CHECK:   tt.store {{.*}}, %[[EXP]]
+//       CHECK:   triton_gpu.convert_layout %[[EXP]] : (tensor<64x64xf32, #blocked>) -> tensor<64x64xf32, #dpas>
+  tt.func public @dpas_keep_convert(%arg0: f32, %arg1: tensor<64x64xf32, #dpas>, %arg2: tensor<64x64x!tt.ptr<f32, 1>, #blocked>) -> tensor<64x64xf32, #dpas> {
+    %0 = tt.splat %arg0 : (f32) -> tensor<64x64xf32, #blocked>
+    %1 = arith.mulf %0, %0 : tensor<64x64xf32, #blocked>
+    %2 = arith.addf %1, %0 : tensor<64x64xf32, #blocked>
+    %3 = math.exp %2 : tensor<64x64xf32, #blocked>
+    tt.store %arg2, %3 {cache = 1 : i32, evict = 1 : i32} : tensor<64x64xf32, #blocked>
+    %4 = triton_gpu.convert_layout %3 : (tensor<64x64xf32, #blocked>) -> tensor<64x64xf32, #dpas>
+    %5 = arith.addf %arg1, %4 : tensor<64x64xf32, #dpas>
+    tt.return %5 : tensor<64x64xf32, #dpas>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+#blocked4 = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+#blocked8 = #triton_gpu.blocked<{sizePerThread = [8], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+// COM: The layout of the loads is propagated through the cat, which then
+// COM: concatenates the registers of the threads, with no conversion.
+// CHECK-LABEL: @cat_register_rename
+//       CHECK:   %[[A:.*]] = tt.load {{.*}} : tensor<256xf32, #blocked>
+//   CHECK-NOT:   triton_gpu.convert_layout
+//       CHECK:   %[[C:.*]] = tt.cat %[[A]], %[[A]] : (tensor<256xf32, #blocked>, tensor<256xf32, #blocked>) -> tensor<512xf32, #blocked1>
+//   CHECK-NOT:   triton_gpu.convert_layout
+//       CHECK:   tt.store {{.*}}, %[[C]] : tensor<512xf32, #blocked1>
+  tt.func public @cat_register_rename(%arg0: tensor<256x!tt.ptr<f32, 1>, #blocked4>, %arg1: tensor<512x!tt.ptr<f32, 1>, #blocked8>) {
+    %0 = tt.load %arg0 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked4>
+    %1 = triton_gpu.convert_layout %0 : (tensor<256xf32, #blocked4>) -> tensor<256xf32, #blocked>
+    %2 = tt.cat %1, %1 : (tensor<256xf32, #blocked>, tensor<256xf32, #blocked>) -> tensor<512xf32, #blocked>
+    %3 = triton_gpu.convert_layout %2 : (tensor<512xf32, #blocked>) -> tensor<512xf32, #blocked8>
+    tt.store %arg1, %3 {cache = 1 : i32, evict = 1 : i32} : tensor<512xf32, #blocked8>
+    tt.return
+  }
+}
@@ -0,0 +1,43 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-distribute-reductions | FileCheck %s
+
+// COM: The warps are moved from the reduced columns to the rows, for the load
+// COM: and the store of the rows alike.
+// CHECK: #[[ROWS:.*]] = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+// CHECK-LABEL: @softmax
+// CHECK: tt.load {{.*}} : tensor<4x4096xf32, #[[ROWS]]>
+// CHECK: tt.reduce
+// CHECK: tt.store {{.*}} : tensor<4x4096xf32, #[[ROWS]]>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [1, 4], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @softmax(%arg0: tensor<4x4096x!tt.ptr<f32, 1>, #blocked>, %arg1: tensor<4x4096x!tt.ptr<f32, 1>, #blocked>) {
+    %0 = tt.load %arg0 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<4x4096xf32, #blocked>
+    %1 = "tt.reduce" (%0) ({
+    ^bb0(%arg2: f32, %arg3: f32):
+      %5 = arith.maximumf %arg2, %arg3 : f32
+      tt.reduce.return %5 : f32
+    }) {axis = 1 : i32} : (tensor<4x4096xf32, #blocked>) -> tensor<4xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    %2 = tt.expand_dims %1 {axis = 1 : i32} : (tensor<4xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>) -> tensor<4x1xf32, #blocked>
+    %3 = tt.broadcast %2 : (tensor<4x1xf32, #blocked>) -> tensor<4x4096xf32, #blocked>
+    %4 = arith.subf %0, %3 : tensor<4x4096xf32, #blocked>
+    tt.store %arg1, %4 {cache = 1 : i32, evict = 1 : i32} : tensor<4x4096xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// COM: A single row is reduced by all the warps.
+// CHECK-LABEL: @single_row
+// CHECK-NOT: triton_gpu.convert_layout
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [1, 4], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @single_row(%arg0: tensor<1x4096x!tt.ptr<f32, 1>, #blocked>) -> tensor<1xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>> {
+    %0 = tt.load %arg0 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<1x4096xf32, #blocked>
+    %1 = "tt.reduce" (%0) ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %2 = arith.addf %arg1, %arg2 : f32
+      tt.reduce.return %2 : f32
+    }) {axis = 1 : i32} : (tensor<1x4096xf32, #blocked>) -> tensor<1xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    tt.return %1 : tensor<1xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+  }
+}
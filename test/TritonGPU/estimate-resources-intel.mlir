@@ -0,0 +1,28 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-estimate-resources | FileCheck %s
+
+// COM: 3 tensors of 32 fp32 per work-item are live at the second add, i.e.
+// COM: 384 bytes per work-item, 96 registers of 64 bytes for 16 work-items.
+// COM: The Xe core runs 16 work-groups of 4 warps.
+// CHECK: module attributes {"triton_gpu.estimated_num_grf" = 96 : i32, "triton_gpu.estimated_shared" = 0 : i32, "triton_gpu.estimated_work_groups_per_xe_core" = 16 : i32
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func @live_tensors(%arg0: tensor<32x64xf32, #blocked>) -> tensor<32x64xf32, #blocked> {
+    %0 = arith.addf %arg0, %arg0 : tensor<32x64xf32, #blocked>
+    %1 = arith.addf %0, %arg0 : tensor<32x64xf32, #blocked>
+    %2 = arith.addf %1, %1 : tensor<32x64xf32, #blocked>
+    tt.return %2 : tensor<32x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// COM: The 64 KB of shared local memory of the work-group limit the Xe core to
+// COM: 2 of them, rather than the 8 work-groups of 8 warps of its threads.
+// CHECK: module attributes {"triton_gpu.estimated_num_grf" = 0 : i32, "triton_gpu.estimated_shared" = 65536 : i32, "triton_gpu.estimated_work_groups_per_xe_core" = 2 : i32
+#shared = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func @shared_memory() {
+    %0 = triton_gpu.alloc_tensor : tensor<128x256xf16, #shared>
+    tt.return
+  }
+}
@@ -0,0 +1,53 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-estimate-traffic | FileCheck %s
+
+// COM: An iteration of the loop over K loads 64x32 and 32x64 f16 tiles, and
+// COM: multiplies them in 2 * 64 * 64 * 32 FLOPs. The loop runs cdiv(K, 32)
+// COM: times, K being the fourth argument. The result is stored once.
+// CHECK: module attributes {{.*}}"triton_gpu.traffic" = ["8192|0|262144|0|((arg3 + 31) // 32)|1", "0|16384|0"]
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot_a = #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>
+#dot_b = #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>
+module attributes {"triton_gpu.compute-capability" = 2 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @matmul_kernel(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>, %arg2: !tt.ptr<f32, 1>, %arg3: i32) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c31_i32 = arith.constant 31 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32, #blocked>
+    %0 = arith.addi %arg3, %c31_i32 : i32
+    %1 = arith.divsi %0, %c32_i32 : i32
+    %2 = tt.splat %arg0 : (!tt.ptr<f16, 1>) -> tensor<64x32x!tt.ptr<f16, 1>, #dot_a>
+    %3 = tt.splat %arg1 : (!tt.ptr<f16, 1>) -> tensor<32x64x!tt.ptr<f16, 1>, #dot_b>
+    %4 = scf.for %arg4 = %c0_i32 to %1 step %c1_i32 iter_args(%arg5 = %cst) -> (tensor<64x64xf32, #blocked>)  : i32 {
+      %6 = tt.load %2 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x32xf16, #dot_a>
+      %7 = tt.load %3 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x64xf16, #dot_b>
+      %8 = tt.dot %6, %7, %arg5 {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<64x32xf16, #dot_a> * tensor<32x64xf16, #dot_b> -> tensor<64x64xf32, #blocked>
+      scf.yield %8 : tensor<64x64xf32, #blocked>
+    }
+    %5 = tt.splat %arg2 : (!tt.ptr<f32, 1>) -> tensor<64x64x!tt.ptr<f32, 1>, #blocked>
+    tt.store %5, %4 {cache = 1 : i32, evict = 1 : i32} : tensor<64x64xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// COM: The bound of the loop loaded from memory isn't an expression of the
+// COM: arguments, the loop is counted once.
+// CHECK: module attributes {{.*}}"triton_gpu.traffic" = ["4|0|0", "1024|0|0|0|?|1"]
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.compute-capability" = 2 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @sum_kernel(%arg0: !tt.ptr<f32, 1>, %arg1: !tt.ptr<i32, 1>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<256xf32, #blocked>
+    %0 = tt.load %arg1 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : i32
+    %1 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<256x!tt.ptr<f32, 1>, #blocked>
+    %2 = scf.for %arg2 = %c0_i32 to %0 step %c1_i32 iter_args(%arg3 = %cst) -> (tensor<256xf32, #blocked>)  : i32 {
+      %3 = tt.load %1 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked>
+      %4 = arith.addf %arg3, %3 : tensor<256xf32, #blocked>
+      scf.yield %4 : tensor<256xf32, #blocked>
+    }
+    tt.return
+  }
+}
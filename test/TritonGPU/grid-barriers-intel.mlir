@@ -0,0 +1,50 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-grid-barriers | FileCheck %s
+
+// COM: The grid barrier arrives on the first counter passed last, the last
+// COM: program resets it and starts the next generation of the second one,
+// COM: which the others wait for, between barriers of the work-group.
+// CHECK: module attributes {"triton_gpu.cooperative" = 1 : i32}
+// CHECK-LABEL: tt.func public @grid_barrier_kernel
+// CHECK-SAME: %[[SYNC:[a-zA-Z0-9_]+]]: !tt.ptr<i32, 1>)
+// CHECK-NOT: tt.grid_barrier
+// CHECK: tt.store
+// CHECK: gpu.barrier
+// CHECK: %[[GENERATION_PTR:.*]] = tt.addptr %[[SYNC]]
+// CHECK: %[[GENERATION:.*]] = "tt.atomic_rmw"(%[[GENERATION_PTR]]
+// CHECK: %[[ARRIVALS:.*]] = "tt.atomic_rmw"(%[[SYNC]]
+// CHECK: tt.get_num_programs {axis = 0 : i32}
+// CHECK: tt.get_num_programs {axis = 1 : i32}
+// CHECK: tt.get_num_programs {axis = 2 : i32}
+// CHECK: %[[LAST:.*]] = arith.cmpi eq, %[[ARRIVALS]]
+// CHECK: scf.if %[[LAST]] {
+// CHECK: "tt.atomic_rmw"(%[[SYNC]]
+// CHECK: "tt.atomic_rmw"
+// CHECK: } else {
+// CHECK: scf.while
+// CHECK: %[[CURRENT:.*]] = "tt.atomic_rmw"
+// CHECK: %[[WAITING:.*]] = arith.cmpi eq, %[[CURRENT]], %[[GENERATION]]
+// CHECK: scf.condition(%[[WAITING]])
+// CHECK: gpu.barrier
+// CHECK: tt.load
+module {
+  tt.func public @grid_barrier_kernel(%arg0: !tt.ptr<f32, 1>, %arg1: !tt.ptr<f32, 1>) {
+    %c1 = arith.constant 1.0 : f32
+    tt.store %arg0, %c1 {cache = 1 : i32, evict = 1 : i32} : f32
+    tt.grid_barrier
+    %0 = tt.load %arg1 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : f32
+    tt.store %arg0, %0 {cache = 1 : i32, evict = 1 : i32} : f32
+    tt.return
+  }
+}
+
+// -----
+
+// COM: The kernels without grid barriers are left as they are.
+// CHECK-NOT: triton_gpu.cooperative
+// CHECK-LABEL: tt.func public @no_grid_barrier_kernel
+// CHECK-SAME: (%{{.*}}: !tt.ptr<f32, 1>)
+module {
+  tt.func public @no_grid_barrier_kernel(%arg0: !tt.ptr<f32, 1>) {
+    tt.return
+  }
+}
@@ -0,0 +1,57 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-instrument-regions | FileCheck %s
+
+// COM: The load and the loop are timed, in the order of the walk of the
+// COM: kernel, and their cycles are added to the buffer passed last.
+// CHECK: module attributes {{.*}}"triton_gpu.profile_regions" = ["load:kernel.py:11", "loop:kernel.py:10"]
+// CHECK-LABEL: tt.func public @sum_kernel
+// CHECK-SAME: %[[PROFILE:[a-zA-Z0-9_]+]]: !tt.ptr<i64, 1>)
+// CHECK: %[[LOOP_START:.*]] = tt.extern_elementwise {{.*}}symbol = "_Z20__spirv_ReadClockKHRi"{{.*}} : (i32) -> i64
+// CHECK-NEXT: %[[SUM:.*]] = scf.for
+// CHECK: %[[LOAD_START:.*]] = tt.extern_elementwise {{.*}}symbol = "_Z20__spirv_ReadClockKHRi"
+// CHECK-NEXT: tt.load
+// CHECK: %[[LOAD_END:.*]] = tt.extern_elementwise {{.*}}symbol = "_Z20__spirv_ReadClockKHRi"
+// CHECK-NEXT: %[[LOAD_CYCLES:.*]] = arith.subi %[[LOAD_END]], %[[LOAD_START]] : i64
+// CHECK: %[[LOAD_PTR:.*]] = tt.addptr %[[PROFILE]], %{{.*}} : !tt.ptr<i64, 1>, i32
+// CHECK-NEXT: "tt.atomic_rmw"(%[[LOAD_PTR]], %[[LOAD_CYCLES]])
+// CHECK: %[[ONE:.*]] = arith.constant 1 : i64
+// CHECK: %[[LOAD_COUNT_PTR:.*]] = tt.addptr %[[PROFILE]], %{{.*}} : !tt.ptr<i64, 1>, i32
+// CHECK-NEXT: "tt.atomic_rmw"(%[[LOAD_COUNT_PTR]], %[[ONE]])
+// CHECK: scf.yield
+// CHECK: %[[LOOP_END:.*]] = tt.extern_elementwise {{.*}}symbol = "_Z20__spirv_ReadClockKHRi"
+// CHECK-NEXT: %[[LOOP_CYCLES:.*]] = arith.subi %[[LOOP_END]], %[[LOOP_START]] : i64
+// CHECK: tt.store %{{.*}}, %[[SUM]]
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @sum_kernel(%arg0: !tt.ptr<f32, 1>, %arg1: i32) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<256xf32, #blocked>
+    %0 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<256x!tt.ptr<f32, 1>, #blocked>
+    %1 = scf.for %arg2 = %c0_i32 to %arg1 step %c1_i32 iter_args(%arg3 = %cst) -> (tensor<256xf32, #blocked>)  : i32 {
+      %2 = tt.load %0 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked> loc(#loc1)
+      %3 = arith.addf %arg3, %2 : tensor<256xf32, #blocked>
+      scf.yield %3 : tensor<256xf32, #blocked>
+    } loc(#loc0)
+    tt.store %0, %1 {cache = 1 : i32, evict = 1 : i32} : tensor<256xf32, #blocked>
+    tt.return
+  }
+}
+#loc0 = loc("kernel.py":10:4)
+#loc1 = loc("kernel.py":11:8)
+
+// -----
+
+// COM: Without any region to time, the kernel is left as is.
+// CHECK-NOT: triton_gpu.profile_regions
+// CHECK-LABEL: tt.func public @fill_kernel
+// CHECK-SAME: (%{{.*}}: !tt.ptr<f32, 1>)
+// CHECK-NOT: tt.extern_elementwise
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @fill_kernel(%arg0: !tt.ptr<f32, 1>) {
+    %cst = arith.constant dense<0.000000e+00> : tensor<256xf32, #blocked>
+    %0 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<256x!tt.ptr<f32, 1>, #blocked>
+    tt.store %0, %cst {cache = 1 : i32, evict = 1 : i32} : tensor<256xf32, #blocked>
+    tt.return
+  }
+}
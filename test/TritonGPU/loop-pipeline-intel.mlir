@@ -0,0 +1,74 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-pipeline=num-stages=3 | FileCheck %s
+
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas
+// CHECK-LABEL: matmul_block_pointer
+// COM: The loads of the first two iterations are issued before the loop.
+// CHECK-COUNT-4: scf.if
+// COM: The loaded operands are buffered in registers across iterations.
+// CHECK: scf.for {{.*}} -> (tensor<128x64xf32, #[[DPAS]]>, {{.*}}, tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #[[DPAS]]}>>, tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>, tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #[[DPAS]]}>>, tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>)
+// COM: The loads of iteration i + 2 are issued before the DPAS of iteration i.
+// CHECK:   scf.if
+// CHECK:     tt.load
+// CHECK:   scf.if
+// CHECK:     tt.load
+// CHECK:   tt.dot
+// CHECK:   scf.yield
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @matmul_block_pointer(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>, %arg3: i64, %arg4: i64, %arg5: i64, %arg6: i32) -> tensor<128x64xf32, #dpas> {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #dpas>
+    %0 = tt.make_tensor_ptr %arg0, [%arg3, %arg5], [%arg5, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<128x32xf16, #dot0>, 1>
+    %1 = tt.make_tensor_ptr %arg1, [%arg5, %arg4], [%arg4, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16, #dot1>, 1>
+    %2:3 = scf.for %arg7 = %c0_i32 to %arg6 step %c32_i32 iter_args(%arg8 = %cst, %arg9 = %0, %arg10 = %1) -> (tensor<128x64xf32, #dpas>, !tt.ptr<tensor<128x32xf16, #dot0>, 1>, !tt.ptr<tensor<32x64xf16, #dot1>, 1>) : i32 {
+      %4 = tt.load %arg9 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<128x32xf16, #dot0>, 1> -> tensor<128x32xf16, #dot0>
+      %5 = tt.load %arg10 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false} : !tt.ptr<tensor<32x64xf16, #dot1>, 1> -> tensor<32x64xf16, #dot1>
+      %8 = tt.dot %4, %5, %arg8 {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<128x32xf16, #dot0> * tensor<32x64xf16, #dot1> -> tensor<128x64xf32, #dpas>
+      %9 = tt.advance %arg9, [%c0_i32, %c32_i32] : <tensor<128x32xf16, #dot0>, 1>
+      %10 = tt.advance %arg10, [%c32_i32, %c0_i32] : <tensor<32x64xf16, #dot1>, 1>
+      scf.yield %8, %9, %10 : tensor<128x64xf32, #dpas>, !tt.ptr<tensor<128x32xf16, #dot0>, 1>, !tt.ptr<tensor<32x64xf16, #dot1>, 1>
+    }
+    tt.return %2#0 : tensor<128x64xf32, #dpas>
+  }
+}
+
+// -----
+
+// CHECK-LABEL: matmul_tensor_of_pointers
+// COM: Loads of iterations that may not exist are masked.
+// CHECK: %[[COND:.*]] = arith.cmpi slt
+// CHECK: %[[MASK:.*]] = tt.splat %[[COND]] : (i1) -> tensor<128x32xi1, #blocked>
+// CHECK: tt.load {{.*}}, %[[MASK]]
+// CHECK: scf.for
+// CHECK:   tt.load
+// CHECK:   tt.load
+// CHECK:   triton_gpu.convert_layout
+// CHECK:   triton_gpu.convert_layout
+// CHECK:   tt.dot
+// CHECK:   scf.yield
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @matmul_tensor_of_pointers(%a_init: tensor<128x32x!tt.ptr<f16, 1>, #blocked>, %b_init: tensor<32x64x!tt.ptr<f16, 1>, #blocked>, %a_off: tensor<128x32xi32, #blocked>, %b_off: tensor<32x64xi32, #blocked>, %ub: i32) -> tensor<128x64xf32, #dpas> {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #dpas>
+    %0:3 = scf.for %iv = %c0_i32 to %ub step %c32_i32 iter_args(%acc = %cst, %a_ptr = %a_init, %b_ptr = %b_init) -> (tensor<128x64xf32, #dpas>, tensor<128x32x!tt.ptr<f16, 1>, #blocked>, tensor<32x64x!tt.ptr<f16, 1>, #blocked>) : i32 {
+      %a = tt.load %a_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16, #blocked>
+      %b = tt.load %b_ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32x64xf16, #blocked>
+      %a_op = triton_gpu.convert_layout %a : (tensor<128x32xf16, #blocked>) -> tensor<128x32xf16, #dot0>
+      %b_op = triton_gpu.convert_layout %b : (tensor<32x64xf16, #blocked>) -> tensor<32x64xf16, #dot1>
+      %c = tt.dot %a_op, %b_op, %acc {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<128x32xf16, #dot0> * tensor<32x64xf16, #dot1> -> tensor<128x64xf32, #dpas>
+      %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<128x32x!tt.ptr<f16, 1>, #blocked>, tensor<128x32xi32, #blocked>
+      %next_b_ptr = tt.addptr %b_ptr, %b_off : tensor<32x64x!tt.ptr<f16, 1>, #blocked>, tensor<32x64xi32, #blocked>
+      scf.yield %c, %next_a_ptr, %next_b_ptr : tensor<128x64xf32, #dpas>, tensor<128x32x!tt.ptr<f16, 1>, #blocked>, tensor<32x64x!tt.ptr<f16, 1>, #blocked>
+    }
+    tt.return %0#0 : tensor<128x64xf32, #dpas>
+  }
+}
@@ -0,0 +1,49 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-loop-unroll | FileCheck %s
+
+// COM: The loop of a dynamic trip count runs its body twice per iteration,
+// COM: the last iteration, if any, in an epilogue loop.
+// CHECK-LABEL: @unroll_dynamic
+// CHECK: scf.for
+// CHECK-COUNT-2: tt.load
+// CHECK: scf.yield
+// CHECK: scf.for
+// CHECK-COUNT-1: tt.load
+// CHECK-NOT: tt.loop_unroll_factor
+module {
+  tt.func public @unroll_dynamic(%arg0: tensor<16x!tt.ptr<f32, 1>>, %arg1: i32) -> tensor<16xf32> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<16xf32>
+    %0 = scf.for %arg2 = %c0_i32 to %arg1 step %c1_i32 iter_args(%arg3 = %cst) -> (tensor<16xf32>) : i32 {
+      %1 = tt.splat %arg2 : (i32) -> tensor<16xi32>
+      %2 = tt.addptr %arg0, %1 : tensor<16x!tt.ptr<f32, 1>>, tensor<16xi32>
+      %3 = tt.load %2 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<16xf32>
+      %4 = arith.addf %arg3, %3 : tensor<16xf32>
+      scf.yield %4 : tensor<16xf32>
+    } {tt.loop_unroll_factor = 2 : i32}
+    tt.return %0 : tensor<16xf32>
+  }
+}
+
+// -----
+
+// COM: The loops without a factor are left alone.
+// CHECK-LABEL: @no_unroll
+// CHECK: scf.for
+// CHECK-COUNT-1: tt.load
+// CHECK-NOT: scf.for
+module {
+  tt.func public @no_unroll(%arg0: tensor<16x!tt.ptr<f32, 1>>, %arg1: i32) -> tensor<16xf32> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<16xf32>
+    %0 = scf.for %arg2 = %c0_i32 to %arg1 step %c1_i32 iter_args(%arg3 = %cst) -> (tensor<16xf32>) : i32 {
+      %1 = tt.splat %arg2 : (i32) -> tensor<16xi32>
+      %2 = tt.addptr %arg0, %1 : tensor<16x!tt.ptr<f32, 1>>, tensor<16xi32>
+      %3 = tt.load %2 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<16xf32>
+      %4 = arith.addf %arg3, %3 : tensor<16xf32>
+      scf.yield %4 : tensor<16xf32>
+    }
+    tt.return %0 : tensor<16xf32>
+  }
+}
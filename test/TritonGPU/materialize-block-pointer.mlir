@@ -0,0 +1,142 @@
+// RUN: triton-opt %s -split-input-file --tritonintelgpu-materialize-block-pointer=device-architecture=pvc | FileCheck %s
+// RUN: triton-opt %s -split-input-file --tritonintelgpu-materialize-block-pointer=device-architecture=ats | FileCheck %s --check-prefix=CHECK-ATS
+
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: matmul_block_pointer
+  tt.func public @matmul_block_pointer(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>, %arg2: !tt.ptr<f32, 1>, %arg3: i64, %arg4: i64, %arg5: i64, %arg6: i32) {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #dpas>
+    // CHECK: tt.make_tensor_ptr {{.*}} : <tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #[[DPAS]]}>>, 1>
+    // CHECK-ATS: tt.make_tensor_ptr {{.*}} : <tensor<128x32xf16, #blocked>, 1>
+    %0 = tt.make_tensor_ptr %arg0, [%arg3, %arg5], [%arg5, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<128x32xf16, #blocked>, 1>
+    // CHECK: tt.make_tensor_ptr {{.*}} : <tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>, 1>
+    %1 = tt.make_tensor_ptr %arg1, [%arg5, %arg4], [%arg4, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16, #blocked>, 1>
+    %2:3 = scf.for %arg7 = %c0_i32 to %arg6 step %c32_i32 iter_args(%arg8 = %cst, %arg9 = %0, %arg10 = %1) -> (tensor<128x64xf32, #dpas>, !tt.ptr<tensor<128x32xf16, #blocked>, 1>, !tt.ptr<tensor<32x64xf16, #blocked>, 1>) : i32 {
+      // CHECK: [[A:%.*]] = tt.load {{.*}} -> tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #[[DPAS]]}>>
+      // CHECK: [[B:%.*]] = tt.load {{.*}} -> tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>
+      // CHECK-NOT: triton_gpu.convert_layout
+      // CHECK: tt.dot [[A]], [[B]]
+      %4 = tt.load %arg9 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<128x32xf16, #blocked>, 1> -> tensor<128x32xf16, #blocked>
+      %5 = tt.load %arg10 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false} : !tt.ptr<tensor<32x64xf16, #blocked>, 1> -> tensor<32x64xf16, #blocked>
+      %6 = triton_gpu.convert_layout %4 : (tensor<128x32xf16, #blocked>) -> tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>>
+      %7 = triton_gpu.convert_layout %5 : (tensor<32x64xf16, #blocked>) -> tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>>
+      %8 = tt.dot %6, %7, %arg8 {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>> * tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>> -> tensor<128x64xf32, #dpas>
+      // CHECK: tt.advance {{.*}} : <tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #[[DPAS]]}>>, 1>
+      %9 = tt.advance %arg9, [%c0_i32, %c32_i32] : <tensor<128x32xf16, #blocked>, 1>
+      // CHECK: tt.advance {{.*}} : <tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>, 1>
+      %10 = tt.advance %arg10, [%c32_i32, %c0_i32] : <tensor<32x64xf16, #blocked>, 1>
+      scf.yield %8, %9, %10 : tensor<128x64xf32, #dpas>, !tt.ptr<tensor<128x32xf16, #blocked>, 1>, !tt.ptr<tensor<32x64xf16, #blocked>, 1>
+    }
+    // CHECK: [[C:%.*]] = tt.make_tensor_ptr {{.*}} : <tensor<128x64xf32, #[[DPAS]]>, 1>
+    %3 = tt.make_tensor_ptr %arg2, [%arg3, %arg4], [%arg4, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<128x64xf32, #blocked>, 1>
+    %11 = triton_gpu.convert_layout %2#0 : (tensor<128x64xf32, #dpas>) -> tensor<128x64xf32, #blocked>
+    // CHECK: tt.store [[C]], {{.*}} : !tt.ptr<tensor<128x64xf32, #[[DPAS]]>, 1>, tensor<128x64xf32, #[[DPAS]]>
+    tt.store %3, %11 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32} : !tt.ptr<tensor<128x64xf32, #blocked>, 1>, tensor<128x64xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Out of bound elements are zero-filled by 2D block reads, block pointers padded with NaN are left untouched.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: load_nan_padding
+  tt.func public @load_nan_padding(%arg0: !tt.ptr<f16, 1>, %arg1: i64, %arg2: i64) -> tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    // CHECK: tt.make_tensor_ptr {{.*}} : <tensor<128x32xf16, #blocked>, 1>
+    %0 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%arg2, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<128x32xf16, #blocked>, 1>
+    // CHECK: triton_gpu.convert_layout
+    %1 = tt.load %0 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 2 : i32} : !tt.ptr<tensor<128x32xf16, #blocked>, 1> -> tensor<128x32xf16, #blocked>
+    %2 = triton_gpu.convert_layout %1 : (tensor<128x32xf16, #blocked>) -> tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>>
+    tt.return %2 : tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>>
+  }
+}
+
+// -----
+
+// COM: The K^T operand of the attention is read through the transposed block pointer, instead of being transposed in shared memory.
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#shared1 = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [0, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: transposed_block_pointer
+  tt.func public @transposed_block_pointer(%arg0: tensor<128x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>>, %arg1: !tt.ptr<f16, 1>, %arg2: i64, %arg3: i64, %arg4: i32) -> tensor<128x32xf32, #dpas> {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x32xf32, #dpas>
+    // CHECK: [[PTR:%.*]] = tt.make_tensor_ptr %arg1, [%arg3, %arg2], [%c1_i64, %arg3], [%c0_i32, %arg4] {order = array<i32: 0, 1>} : <tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>, 1>
+    %0 = tt.make_tensor_ptr %arg1, [%arg2, %arg3], [%arg3, %c1_i64], [%arg4, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16, #blocked>, 1>
+    // CHECK: [[B:%.*]] = tt.load [[PTR]] {boundaryCheck = array<i32: 1>, {{.*}}triton_gpu.column_major} : !tt.ptr<tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>, 1> -> tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>
+    // CHECK-NOT: triton_gpu.convert_layout
+    // CHECK-NOT: tt.trans
+    // CHECK: tt.dot %arg0, [[B]]
+    %1 = tt.load %0 {boundaryCheck = array<i32: 0>, cache = 1 : i32, evict = 1 : i32, isVolatile = false} : !tt.ptr<tensor<32x64xf16, #blocked>, 1> -> tensor<32x64xf16, #blocked>
+    %2 = triton_gpu.convert_layout %1 : (tensor<32x64xf16, #blocked>) -> tensor<32x64xf16, #shared>
+    %3 = tt.trans %2 : (tensor<32x64xf16, #shared>) -> tensor<64x32xf16, #shared1>
+    %4 = triton_gpu.convert_layout %3 : (tensor<64x32xf16, #shared1>) -> tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>>
+    %5 = tt.dot %arg0, %4, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<128x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>> * tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>> -> tensor<128x32xf32, #dpas>
+    tt.return %5 : tensor<128x32xf32, #dpas>
+  }
+}
+
+// -----
+
+// COM: The B operands with contiguous columns are read by transposed 2D block reads, the A operands are left untouched.
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 1], threadsPerWarp = [8, 2], warpsPerCTA = [1, 4], order = [0, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: column_major_block_pointer
+  tt.func public @column_major_block_pointer(%arg0: !tt.ptr<f16, 1>, %arg1: i64, %arg2: i64) -> (tensor<128x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>>, tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    // CHECK: tt.make_tensor_ptr {{.*}} : <tensor<128x64xf16, #blocked>, 1>
+    %0 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%c1_i64, %arg1], [%c0_i32, %c0_i32] {order = array<i32: 0, 1>} : <tensor<128x64xf16, #blocked>, 1>
+    // CHECK: tt.make_tensor_ptr {{.*}} : <tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #{{.*}}}>>, 1>
+    %1 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%c1_i64, %arg1], [%c0_i32, %c0_i32] {order = array<i32: 0, 1>} : <tensor<64x32xf16, #blocked>, 1>
+    // CHECK: triton_gpu.convert_layout
+    %2 = tt.load %0 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : !tt.ptr<tensor<128x64xf16, #blocked>, 1> -> tensor<128x64xf16, #blocked>
+    %3 = triton_gpu.convert_layout %2 : (tensor<128x64xf16, #blocked>) -> tensor<128x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>>
+    // CHECK: tt.load {{.*}}triton_gpu.column_major
+    // CHECK-NOT: triton_gpu.convert_layout
+    %4 = tt.load %1 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : !tt.ptr<tensor<64x32xf16, #blocked>, 1> -> tensor<64x32xf16, #blocked>
+    %5 = triton_gpu.convert_layout %4 : (tensor<64x32xf16, #blocked>) -> tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>>
+    tt.return %3, %5 : tensor<128x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>>, tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>>
+  }
+}
+
+// -----
+
+// COM: The pages of tt.load_pages are read by the tiles of their rows, the pages must be made of whole tiles.
+// CHECK: #[[DPAS:.+]] = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: load_pages
+  tt.func public @load_pages(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<i32, 1>, %arg2: i64, %arg3: i64) -> (tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>>, tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    // CHECK: tt.make_tensor_ptr {{.*}} : <tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>, 1>
+    %0 = tt.make_tensor_ptr %arg0, [%arg2, %arg3], [%arg3, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<64x64xf16, #blocked>, 1>
+    // CHECK: tt.load_pages {{.*}} -> tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]]}>>
+    // CHECK-NOT: triton_gpu.convert_layout
+    %1 = tt.load_pages %0, %arg1 {pageSize = 16 : i32} : !tt.ptr<tensor<64x64xf16, #blocked>, 1>, !tt.ptr<i32, 1> -> tensor<64x64xf16, #blocked>
+    %2 = triton_gpu.convert_layout %1 : (tensor<64x64xf16, #blocked>) -> tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>>
+    // CHECK: tt.make_tensor_ptr {{.*}} : <tensor<64x64xf16, #blocked>, 1>
+    %3 = tt.make_tensor_ptr %arg0, [%arg2, %arg3], [%arg3, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<64x64xf16, #blocked>, 1>
+    // CHECK: triton_gpu.convert_layout
+    %4 = tt.load_pages %3, %arg1 {pageSize = 8 : i32} : !tt.ptr<tensor<64x64xf16, #blocked>, 1>, !tt.ptr<i32, 1> -> tensor<64x64xf16, #blocked>
+    %5 = triton_gpu.convert_layout %4 : (tensor<64x64xf16, #blocked>) -> tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>>
+    tt.return %2, %5 : tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>>, tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>>
+  }
+}
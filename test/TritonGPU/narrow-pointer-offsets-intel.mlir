@@ -0,0 +1,54 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-narrow-pointer-offsets | FileCheck %s
+
+// COM: The i64 offsets from the arguments addressing less than 2GB are
+// COM: computed in i32 from the values they are extended from.
+// CHECK-LABEL: @narrow_offsets
+// CHECK-SAME: %[[BASE:[a-zA-Z0-9_]+]]: !tt.ptr<f16, 1> {tt.pointer_range = 32 : i32}, %[[STRIDE:[a-zA-Z0-9_]+]]: i32
+// CHECK-NOT: i64
+// CHECK: %[[RANGE:.*]] = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32, #blocked>
+// CHECK: %[[SPLAT:.*]] = tt.splat %[[STRIDE]] : (i32) -> tensor<32xi32, #blocked>
+// CHECK: %[[OFFS:.*]] = arith.muli %[[RANGE]], %[[SPLAT]] : tensor<32xi32, #blocked>
+// CHECK: %[[C64:.*]] = arith.constant dense<64> : tensor<32xi32, #blocked>
+// CHECK: %[[OFFS2:.*]] = arith.addi %[[OFFS]], %[[C64]] : tensor<32xi32, #blocked>
+// CHECK: tt.addptr %{{.*}}, %[[OFFS2]] : tensor<32x!tt.ptr<f16, 1>, #blocked>, tensor<32xi32, #blocked>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [2], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 2 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @narrow_offsets(%arg0: !tt.ptr<f16, 1> {tt.pointer_range = 32 : i32}, %arg1: i32) -> tensor<32xf16, #blocked> {
+    %0 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32, #blocked>
+    %1 = arith.extsi %0 : tensor<32xi32, #blocked> to tensor<32xi64, #blocked>
+    %2 = arith.extsi %arg1 : i32 to i64
+    %3 = tt.splat %2 : (i64) -> tensor<32xi64, #blocked>
+    %4 = arith.muli %1, %3 : tensor<32xi64, #blocked>
+    %cst = arith.constant dense<64> : tensor<32xi64, #blocked>
+    %5 = arith.addi %4, %cst : tensor<32xi64, #blocked>
+    %6 = tt.splat %arg0 : (!tt.ptr<f16, 1>) -> tensor<32x!tt.ptr<f16, 1>, #blocked>
+    %7 = tt.addptr %6, %5 : tensor<32x!tt.ptr<f16, 1>, #blocked>, tensor<32xi64, #blocked>
+    %8 = tt.load %7 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32xf16, #blocked>
+    tt.return %8 : tensor<32xf16, #blocked>
+  }
+}
+
+// -----
+
+// COM: The offsets from the arguments without the specialization, and those
+// COM: computed otherwise from tensors, are left in i64.
+// CHECK-LABEL: @keep_offsets
+// CHECK: tt.addptr %{{.*}}, %{{.*}} : tensor<32x!tt.ptr<f16, 1>, #blocked>, tensor<32xi64, #blocked>
+// CHECK: tt.addptr %{{.*}}, %{{.*}} : tensor<32x!tt.ptr<f16, 1>, #blocked>, tensor<32xi64, #blocked>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [2], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 2 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @keep_offsets(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1> {tt.pointer_range = 32 : i32}) -> tensor<32xf16, #blocked> {
+    %0 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32, #blocked>
+    %1 = arith.extsi %0 : tensor<32xi32, #blocked> to tensor<32xi64, #blocked>
+    %2 = tt.splat %arg0 : (!tt.ptr<f16, 1>) -> tensor<32x!tt.ptr<f16, 1>, #blocked>
+    %3 = tt.addptr %2, %1 : tensor<32x!tt.ptr<f16, 1>, #blocked>, tensor<32xi64, #blocked>
+    %4 = tt.load %3 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32xf16, #blocked>
+    %cst = arith.constant dense<3> : tensor<32xi64, #blocked>
+    %5 = arith.divsi %1, %cst : tensor<32xi64, #blocked>
+    %6 = tt.splat %arg1 : (!tt.ptr<f16, 1>) -> tensor<32x!tt.ptr<f16, 1>, #blocked>
+    %7 = tt.addptr %6, %5 : tensor<32x!tt.ptr<f16, 1>, #blocked>, tensor<32xi64, #blocked>
+    %8 = tt.load %7 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32xf16, #blocked>
+    %9 = arith.addf %4, %8 : tensor<32xf16, #blocked>
+    tt.return %9 : tensor<32xf16, #blocked>
+  }
+}
@@ -0,0 +1,18 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-optimize-epilogue | FileCheck %s
+
+// COM: The result of the DPAS is stored from its registers, the pointers and
+// COM: the mask are converted to the DPAS layout instead.
+// CHECK-LABEL: @store_dpas
+// CHECK: %[[PTR:.*]] = triton_gpu.convert_layout %arg0 : (tensor<64x64x!tt.ptr<f32, 1>, #[[BLOCKED:.*]]>) -> tensor<64x64x!tt.ptr<f32, 1>, #[[DPAS:.*]]>
+// CHECK: %[[MASK:.*]] = triton_gpu.convert_layout %arg2 : (tensor<64x64xi1, #[[BLOCKED]]>) -> tensor<64x64xi1, #[[DPAS]]>
+// CHECK-NOT: triton_gpu.convert_layout
+// CHECK: tt.store %[[PTR]], %arg1, %[[MASK]] {{.*}} : tensor<64x64xf32, #[[DPAS]]>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @store_dpas(%arg0: tensor<64x64x!tt.ptr<f32, 1>, #blocked>, %arg1: tensor<64x64xf32, #dpas>, %arg2: tensor<64x64xi1, #blocked>) {
+    %0 = triton_gpu.convert_layout %arg1 : (tensor<64x64xf32, #dpas>) -> tensor<64x64xf32, #blocked>
+    tt.store %arg0, %0, %arg2 {cache = 1 : i32, evict = 1 : i32} : tensor<64x64xf32, #blocked>
+    tt.return
+  }
+}
@@ -0,0 +1,44 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-pack-scalar-args=min-num-args=3 | FileCheck %s
+
+// COM: The scalars are loaded from the slots of the buffer passed first, in
+// COM: their order, the pointers and the divisible scalars stay arguments.
+// CHECK: module attributes {"triton_gpu.packed_args" = [1 : i32, 2 : i32, 3 : i32, 5 : i32]}
+// CHECK-LABEL: tt.func public @kernel
+// CHECK-SAME: (%[[ARGS:.*]]: !tt.ptr<i64, 1>, %[[X:.*]]: !tt.ptr<f32, 1>, %[[STRIDE:.*]]: i32 {tt.divisibility = 16 : i32})
+// CHECK: %[[C0:.*]] = arith.constant 0 : i32
+// CHECK: %[[PTR0:.*]] = tt.addptr %[[ARGS]], %[[C0]] : !tt.ptr<i64, 1>, i32
+// CHECK: %[[SLOT0:.*]] = tt.load %[[PTR0]]
+// CHECK: %[[N:.*]] = arith.trunci %[[SLOT0]] : i64 to i32
+// CHECK: %[[SLOT1:.*]] = tt.load
+// CHECK: %[[BITS:.*]] = arith.trunci %[[SLOT1]] : i64 to i32
+// CHECK: %[[SCALE:.*]] = arith.bitcast %[[BITS]] : i32 to f32
+// CHECK: %[[OFFSET:.*]] = tt.load
+// CHECK: %[[SLOT3:.*]] = tt.load
+// CHECK: %[[ALPHA:.*]] = arith.bitcast %[[SLOT3]] : i64 to f64
+// CHECK: arith.addi %[[N]], %[[STRIDE]] : i32
+// CHECK: arith.mulf %{{.*}}, %[[SCALE]] : f32
+// CHECK: tt.addptr %[[X]], %[[OFFSET]] : !tt.ptr<f32, 1>, i64
+module {
+  tt.func public @kernel(%arg0: !tt.ptr<f32, 1>, %arg1: i32, %arg2: f32, %arg3: i64, %arg4: i32 {tt.divisibility = 16 : i32}, %arg5: f64) {
+    %0 = arith.addi %arg1, %arg4 : i32
+    %1 = arith.sitofp %0 : i32 to f32
+    %2 = arith.mulf %1, %arg2 : f32
+    %3 = tt.addptr %arg0, %arg3 : !tt.ptr<f32, 1>, i64
+    tt.store %3, %2 {cache = 1 : i32, evict = 1 : i32} : f32
+    %4 = arith.truncf %arg5 : f64 to f32
+    tt.store %arg0, %4 {cache = 1 : i32, evict = 1 : i32} : f32
+    tt.return
+  }
+}
+
+// -----
+
+// COM: The kernels with fewer scalars keep their arguments.
+// CHECK-NOT: triton_gpu.packed_args
+// CHECK-LABEL: tt.func public @few_args_kernel
+// CHECK-SAME: (%{{.*}}: !tt.ptr<f32, 1>, %{{.*}}: i32, %{{.*}}: f32)
+module {
+  tt.func public @few_args_kernel(%arg0: !tt.ptr<f32, 1>, %arg1: i32, %arg2: f32) {
+    tt.return
+  }
+}
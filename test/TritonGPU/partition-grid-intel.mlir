@@ -0,0 +1,53 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-partition-grid | FileCheck %s
+
+// CHECK: module attributes {{.*}}"triton_gpu.partition_grid" = 1 : i32
+// CHECK-LABEL: tt.func public @add_kernel
+// CHECK-SAME: %[[OFFSET_X:[a-zA-Z0-9_]+]]: i32, %[[GRID_X:[a-zA-Z0-9_]+]]: i32)
+// CHECK: %[[PID_X:.*]] = tt.get_program_id x : i32
+// CHECK: %[[OFFSET_PID_X:.*]] = arith.addi %[[PID_X]], %[[OFFSET_X]] : i32
+// CHECK: %[[PID_Y:.*]] = tt.get_program_id y : i32
+// CHECK-NOT: tt.get_num_programs
+// CHECK: %[[ROW:.*]] = arith.muli %[[PID_Y]], %[[GRID_X]] : i32
+// CHECK: arith.addi %[[ROW]], %[[OFFSET_PID_X]] : i32
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @add_kernel(%arg0: !tt.ptr<f32, 1>, %arg1: !tt.ptr<f32, 1>) {
+    %c256_i32 = arith.constant 256 : i32
+    %0 = tt.get_program_id x : i32
+    %1 = tt.get_program_id y : i32
+    %2 = tt.get_num_programs {axis = 0 : i32} : i32
+    %3 = arith.muli %1, %2 : i32
+    %4 = arith.addi %3, %0 : i32
+    %5 = arith.muli %4, %c256_i32 : i32
+    %6 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked>
+    %7 = tt.splat %5 : (i32) -> tensor<256xi32, #blocked>
+    %8 = arith.addi %7, %6 : tensor<256xi32, #blocked>
+    %9 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<256x!tt.ptr<f32, 1>, #blocked>
+    %10 = tt.addptr %9, %8 : tensor<256x!tt.ptr<f32, 1>, #blocked>, tensor<256xi32, #blocked>
+    %11 = tt.load %10 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked>
+    %12 = tt.splat %arg1 : (!tt.ptr<f32, 1>) -> tensor<256x!tt.ptr<f32, 1>, #blocked>
+    %13 = tt.addptr %12, %8 : tensor<256x!tt.ptr<f32, 1>, #blocked>, tensor<256xi32, #blocked>
+    tt.store %13, %11 {cache = 1 : i32, evict = 1 : i32} : tensor<256xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// COM: The program ids of the functions called by the kernel can't be
+// COM: offset, the kernel is left as is.
+// CHECK-NOT: triton_gpu.partition_grid
+// CHECK-LABEL: tt.func public @call_kernel
+// CHECK-SAME: (%{{.*}}: !tt.ptr<i32, 1>) {
+// CHECK-NOT: arith.addi
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func private @get_pid() -> i32 attributes {noinline = true} {
+    %0 = tt.get_program_id x : i32
+    tt.return %0 : i32
+  }
+  tt.func public @call_kernel(%arg0: !tt.ptr<i32, 1>) {
+    %0 = tt.call @get_pid() : () -> i32
+    tt.store %arg0, %0 {cache = 1 : i32, evict = 1 : i32} : i32
+    tt.return
+  }
+}
@@ -0,0 +1,63 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-prefetch-block=num-stages=2 | FileCheck %s
+
+// CHECK-LABEL: matmul_block_pointer
+// COM: The blocks of the first two iterations are prefetched before the loop.
+// CHECK: %[[A0:.*]] = tt.make_tensor_ptr %arg0
+// CHECK: %[[B0:.*]] = tt.make_tensor_ptr %arg1
+// CHECK: triton_gpu.prefetch %[[A0]]
+// CHECK: %[[A1:.*]] = tt.advance %[[A0]]
+// CHECK: triton_gpu.prefetch %[[A1]]
+// CHECK: %[[A2:.*]] = tt.advance %[[A1]]
+// CHECK: triton_gpu.prefetch %[[B0]]
+// CHECK: %[[B1:.*]] = tt.advance %[[B0]]
+// CHECK: triton_gpu.prefetch %[[B1]]
+// CHECK: %[[B2:.*]] = tt.advance %[[B1]]
+// COM: The loop prefetches the blocks of iteration i + 2.
+// CHECK: scf.for {{.*}} iter_args({{.*}}, %[[PA:.*]] = %[[A2]], %[[PB:.*]] = %[[B2]])
+// CHECK-NEXT: triton_gpu.prefetch %[[PA]]
+// CHECK-NEXT: triton_gpu.prefetch %[[PB]]
+// CHECK: tt.dot
+// CHECK: %[[NEXT_PA:.*]] = tt.advance %[[PA]]
+// CHECK: %[[NEXT_PB:.*]] = tt.advance %[[PB]]
+// CHECK: scf.yield {{.*}}, %[[NEXT_PA]], %[[NEXT_PB]]
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @matmul_block_pointer(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>, %arg3: i64, %arg4: i64, %arg5: i64, %arg6: i32) -> tensor<128x64xf32, #dpas> {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #dpas>
+    %0 = tt.make_tensor_ptr %arg0, [%arg3, %arg5], [%arg5, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<128x32xf16, #dot0>, 1>
+    %1 = tt.make_tensor_ptr %arg1, [%arg5, %arg4], [%arg4, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16, #dot1>, 1>
+    %2:3 = scf.for %arg7 = %c0_i32 to %arg6 step %c32_i32 iter_args(%arg8 = %cst, %arg9 = %0, %arg10 = %1) -> (tensor<128x64xf32, #dpas>, !tt.ptr<tensor<128x32xf16, #dot0>, 1>, !tt.ptr<tensor<32x64xf16, #dot1>, 1>) : i32 {
+      %4 = tt.load %arg9 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<128x32xf16, #dot0>, 1> -> tensor<128x32xf16, #dot0>
+      %5 = tt.load %arg10 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false} : !tt.ptr<tensor<32x64xf16, #dot1>, 1> -> tensor<32x64xf16, #dot1>
+      %8 = tt.dot %4, %5, %arg8 {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<128x32xf16, #dot0> * tensor<32x64xf16, #dot1> -> tensor<128x64xf32, #dpas>
+      %9 = tt.advance %arg9, [%c0_i32, %c32_i32] : <tensor<128x32xf16, #dot0>, 1>
+      %10 = tt.advance %arg10, [%c32_i32, %c0_i32] : <tensor<32x64xf16, #dot1>, 1>
+      scf.yield %8, %9, %10 : tensor<128x64xf32, #dpas>, !tt.ptr<tensor<128x32xf16, #dot0>, 1>, !tt.ptr<tensor<32x64xf16, #dot1>, 1>
+    }
+    tt.return %2#0 : tensor<128x64xf32, #dpas>
+  }
+}
+
+// -----
+
+// CHECK-LABEL: tensor_of_pointers
+// CHECK-NOT: triton_gpu.prefetch
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @tensor_of_pointers(%init: tensor<128x32x!tt.ptr<f16, 1>, #blocked>, %off: tensor<128x32xi32, #blocked>, %ub: i32) {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %0 = scf.for %iv = %c0_i32 to %ub step %c32_i32 iter_args(%ptr = %init) -> (tensor<128x32x!tt.ptr<f16, 1>, #blocked>) : i32 {
+      %a = tt.load %ptr {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128x32xf16, #blocked>
+      tt.store %ptr, %a : tensor<128x32xf16, #blocked>
+      %next = tt.addptr %ptr, %off : tensor<128x32x!tt.ptr<f16, 1>, #blocked>, tensor<128x32xi32, #blocked>
+      scf.yield %next : tensor<128x32x!tt.ptr<f16, 1>, #blocked>
+    }
+    tt.return
+  }
+}
@@ -0,0 +1,70 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-reduce-data-duplication | FileCheck %s
+
+// COM: The rows of operand A read at once by a sub-group are swizzled to
+// COM: different banks of the shared local memory.
+// CHECK: #[[SHARED:.*]] = #triton_gpu.shared<{vec = 16, perPhase = 1, maxPhase = 2, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+// CHECK-LABEL: @operand_a
+// CHECK: triton_gpu.convert_layout %arg0 : (tensor<64x32xf16, #{{.*}}>) -> tensor<64x32xf16, #[[SHARED]]>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @operand_a(%arg0: tensor<64x32xf16, #blocked>) -> tensor<64x32xf16, #dot0> {
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<64x32xf16, #blocked>) -> tensor<64x32xf16, #dot0>
+    tt.return %0 : tensor<64x32xf16, #dot0>
+  }
+}
+
+// -----
+
+// COM: The rows of operand B are read as a whole, they are not swizzled.
+// CHECK: #[[SHARED:.*]] = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+// CHECK-LABEL: @operand_b
+// CHECK: triton_gpu.convert_layout %arg0 : (tensor<32x64xf16, #{{.*}}>) -> tensor<32x64xf16, #[[SHARED]]>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @operand_b(%arg0: tensor<32x64xf16, #blocked>) -> tensor<32x64xf16, #dot1> {
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<32x64xf16, #blocked>) -> tensor<32x64xf16, #dot1>
+    tt.return %0 : tensor<32x64xf16, #dot1>
+  }
+}
+
+// -----
+
+// COM: The A operand of a DPAS result computed by a single sub-group per row
+// COM: of tiles stays in the registers.
+// CHECK-LABEL: @dpas_operand_a
+// CHECK-NEXT: triton_gpu.convert_layout %arg0 : (tensor<64x32xf16, #{{.*}}>) -> tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #{{.*}}}>>
+// CHECK-NEXT: tt.return
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @dpas_operand_a(%arg0: tensor<64x32xf16, #dpas>) -> tensor<64x32xf16, #dot0> {
+    %0 = triton_gpu.convert_layout %arg0 : (tensor<64x32xf16, #dpas>) -> tensor<64x32xf16, #dot0>
+    tt.return %0 : tensor<64x32xf16, #dot0>
+  }
+}
+
+// -----
+
+// COM: The operand loaded through a block pointer is read by 2D block loads
+// COM: in the DPAS operand layout.
+// CHECK-LABEL: @block_pointer_operand_a
+// CHECK: tt.make_tensor_ptr {{.*}} : <tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #{{.*}}}>>, 1>
+// CHECK: tt.load {{.*}} -> tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #{{.*}}}>>
+// CHECK-NOT: triton_gpu.convert_layout
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dpas = #triton_gpu.dpas<{repeatCount = 8, warpsPerCTA = [4, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @block_pointer_operand_a(%arg0: !tt.ptr<f16, 1>, %arg1: i64, %arg2: i64) -> tensor<64x32xf16, #dot0> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %0 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%arg2, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<64x32xf16, #blocked>, 1>
+    %1 = tt.load %0 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<64x32xf16, #blocked>, 1> -> tensor<64x32xf16, #blocked>
+    %2 = triton_gpu.convert_layout %1 : (tensor<64x32xf16, #blocked>) -> tensor<64x32xf16, #dot0>
+    tt.return %2 : tensor<64x32xf16, #dot0>
+  }
+}
@@ -0,0 +1,43 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-coalesce -tritonintelgpu-accelerate-matmul=device-architecture=pvc -verify-diagnostics
+
+// COM: The work-items load 4 elements each, one at a time, as the addresses
+// COM: they load aren't contiguous.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.compute-capability" = 2 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @broadcast_load(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}) -> tensor<256xf32, #blocked> {
+    %0 = tt.splat %arg0 : (!tt.ptr<f32>) -> tensor<256x!tt.ptr<f32>, #blocked>
+    // expected-remark @+1 {{tt.load not vectorized: contiguity 1, divisibility}}
+    %1 = tt.load %0 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<256xf32, #blocked>
+    tt.return %1 : tensor<256xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 2 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @dot_f32_no_tf32(
+    %a: tensor<128x32xf32, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<32x64xf32, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<128x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #blocked>
+    // expected-remark @+1 {{dot not mapped to DPAS: f32 operands without allowTF32}}
+    %d = tt.dot %a, %b, %cst {allowTF32 = false, maxNumImpreciseAcc = 0 : i32} :
+      tensor<128x32xf32, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf32, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<128x64xf32, #blocked>
+    tt.return %d : tensor<128x64xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.compute-capability" = 2 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @dot_i8_i32(
+    %a: tensor<64x16xi8, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<16x64xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<64x64xi32, #blocked> {
+    %cst = arith.constant dense<0> : tensor<64x64xi32, #blocked>
+    // expected-remark @+1 {{dot not mapped to DPAS: shape 64x64x16 isn't a multiple of the DPAS tile 8x16x32}}
+    %d = tt.dot %a, %b, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} :
+      tensor<64x16xi8, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<16x64xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<64x64xi32, #blocked>
+    tt.return %d : tensor<64x64xi32, #blocked>
+  }
+}
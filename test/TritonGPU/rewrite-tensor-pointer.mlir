@@ -136,3 +136,28 @@ module attributes {"triton_gpu.compute-capability" = 80 : i32, "triton_gpu.num-c
     tt.return %1 : tensor<1024x1024xi8, #blocked>
   }
 }
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // COM: The rows of the pages are gathered by the index of their page, the elements out of the tensor are zeros.
+  // CHECK-LABEL: @load_pages
+  tt.func public @load_pages(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<i32, 1>, %arg2: i64, %arg3: i64, %arg4: i32) -> tensor<64x64xf16, #blocked> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    // CHECK-NOT: tt.make_tensor_ptr
+    %0 = tt.make_tensor_ptr %arg0, [%arg2, %arg3], [%arg3, %c1_i64], [%arg4, %c0_i32] {order = array<i32: 1, 0>} : <tensor<64x64xf16, #blocked>, 1>
+    // CHECK: arith.divsi
+    // CHECK: arith.remsi
+    // CHECK: [[PAGE_PTRS:%.*]] = tt.addptr {{.*}} : tensor<64x64x!tt.ptr<i32, 1>, #blocked>, tensor<64x64xi64, #blocked>
+    // CHECK: [[PAGES:%.*]] = tt.load [[PAGE_PTRS]] {{.*}} : tensor<64x64xi32, #blocked>
+    // CHECK: arith.extsi [[PAGES]]
+    // CHECK: arith.muli
+    // CHECK: arith.addi
+    // CHECK: tt.load %{{.*}}, %{{.*}}, %{{.*}} {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<64x64xf16, #blocked>
+    // CHECK-NOT: tt.load_pages
+    %1 = tt.load_pages %0, %arg1 {pageSize = 16 : i32} : !tt.ptr<tensor<64x64xf16, #blocked>, 1>, !tt.ptr<i32, 1> -> tensor<64x64xf16, #blocked>
+    tt.return %1 : tensor<64x64xf16, #blocked>
+  }
+}
@@ -0,0 +1,34 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-select-num-warps=threads-per-warp=16 | FileCheck %s
+
+// COM: The 128x128 accumulator gets 8 warps of 128 elements per work-item.
+// CHECK: module attributes {triton_gpu.selected_num_warps = 8 : i32}
+module {
+  tt.func public @matmul(%arg0: tensor<128x32xf16>, %arg1: tensor<32x128xf16>) -> tensor<128x128xf32> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x128xf32>
+    %0 = tt.dot %arg0, %arg1, %cst {allowTF32 = true, maxNumImpreciseAcc = 0 : i32} : tensor<128x32xf16> * tensor<32x128xf16> -> tensor<128x128xf32>
+    tt.return %0 : tensor<128x128xf32>
+  }
+}
+
+// -----
+
+// COM: The 1024 elements of 4 bytes loaded get 8 warps of 32 bytes per
+// COM: work-item.
+// CHECK: module attributes {triton_gpu.selected_num_warps = 8 : i32}
+module {
+  tt.func public @add(%arg0: tensor<1024x!tt.ptr<f32, 1>>) -> tensor<1024xf32> {
+    %0 = tt.load %arg0 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<1024xf32>
+    tt.return %0 : tensor<1024xf32>
+  }
+}
+
+// -----
+
+// COM: The number of warps is bounded by the largest work-group.
+// CHECK: module attributes {triton_gpu.selected_num_warps = 64 : i32}
+module {
+  tt.func public @large(%arg0: tensor<65536x!tt.ptr<f32, 1>>) -> tensor<65536xf32> {
+    %0 = tt.load %arg0 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<65536xf32>
+    tt.return %0 : tensor<65536xf32>
+  }
+}
@@ -0,0 +1,102 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-strength-reduce-pointers | FileCheck %s
+
+// COM: The pointers computed from the offset carried by the loop are carried
+// COM: instead, from their value for the first iteration, and incremented by
+// COM: the step of the offset times the stride.
+// CHECK-LABEL: @offset_iter_arg
+// CHECK-SAME: %[[BASE:[a-zA-Z0-9_]+]]: !tt.ptr<f16, 1>, %[[STRIDE:[a-zA-Z0-9_]+]]: i32
+// CHECK: %[[C32:.*]] = arith.constant 32 : i32
+// CHECK: %[[STEP:.*]] = arith.extsi %[[C32]] : i32 to i64
+// CHECK: %[[STRIDE64:.*]] = arith.extsi %[[STRIDE]] : i32 to i64
+// CHECK: %[[INC:.*]] = arith.muli %[[STEP]], %[[STRIDE64]] : i64
+// CHECK: %[[PTRS0:.*]] = tt.addptr
+// CHECK: scf.for {{.*}} iter_args(%{{.*}} = %{{.*}}, %[[PTRS:.*]] = %[[PTRS0]])
+// CHECK-NOT: arith.muli
+// CHECK: tt.load %[[PTRS]]
+// CHECK: %[[SPLAT:.*]] = tt.splat %[[INC]] : (i64) -> tensor<32xi64, #blocked>
+// CHECK: %[[NEXT:.*]] = tt.addptr %[[PTRS]], %[[SPLAT]]
+// CHECK: scf.yield %{{.*}}, %{{.*}}, %[[NEXT]]
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [2], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 2 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @offset_iter_arg(%arg0: !tt.ptr<f16, 1>, %arg1: i32) -> tensor<32xf16, #blocked> {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c4096_i32 = arith.constant 4096 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<32xf16, #blocked>
+    %0 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32, #blocked>
+    %1 = tt.splat %arg0 : (!tt.ptr<f16, 1>) -> tensor<32x!tt.ptr<f16, 1>, #blocked>
+    %2 = tt.splat %arg1 : (i32) -> tensor<32xi32, #blocked>
+    %3:2 = scf.for %arg2 = %c0_i32 to %c4096_i32 step %c32_i32 iter_args(%arg3 = %c0_i32, %arg4 = %cst) -> (i32, tensor<32xf16, #blocked>) : i32 {
+      %4 = tt.splat %arg3 : (i32) -> tensor<32xi32, #blocked>
+      %5 = arith.addi %4, %0 : tensor<32xi32, #blocked>
+      %6 = arith.muli %5, %2 : tensor<32xi32, #blocked>
+      %7 = tt.addptr %1, %6 : tensor<32x!tt.ptr<f16, 1>, #blocked>, tensor<32xi32, #blocked>
+      %8 = tt.load %7 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32xf16, #blocked>
+      %9 = arith.addf %arg4, %8 : tensor<32xf16, #blocked>
+      %10 = arith.addi %arg3, %c32_i32 : i32
+      scf.yield %10, %9 : i32, tensor<32xf16, #blocked>
+    }
+    tt.return %3#1 : tensor<32xf16, #blocked>
+  }
+}
+
+// -----
+
+// COM: The pointers computed from the loop index are carried too, and the
+// COM: offsets still needed by the mask are kept.
+// CHECK-LABEL: @loop_index
+// CHECK: %[[PTRS0:.*]] = tt.addptr
+// CHECK: scf.for {{.*}} iter_args(%{{.*}} = %{{.*}}, %[[PTRS:.*]] = %[[PTRS0]])
+// CHECK: %[[MASK:.*]] = arith.cmpi slt
+// CHECK: tt.load %[[PTRS]], %[[MASK]]
+// CHECK: tt.addptr %[[PTRS]]
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [2], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 2 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @loop_index(%arg0: !tt.ptr<f16, 1>, %arg1: i32) -> tensor<32xf16, #blocked> {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<32xf16, #blocked>
+    %0 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32, #blocked>
+    %1 = tt.splat %arg0 : (!tt.ptr<f16, 1>) -> tensor<32x!tt.ptr<f16, 1>, #blocked>
+    %2 = tt.splat %arg1 : (i32) -> tensor<32xi32, #blocked>
+    %3 = scf.for %arg2 = %c0_i32 to %arg1 step %c32_i32 iter_args(%arg3 = %cst) -> (tensor<32xf16, #blocked>) : i32 {
+      %4 = tt.splat %arg2 : (i32) -> tensor<32xi32, #blocked>
+      %5 = arith.addi %4, %0 : tensor<32xi32, #blocked>
+      %6 = arith.cmpi slt, %5, %2 : tensor<32xi32, #blocked>
+      %7 = tt.addptr %1, %5 : tensor<32x!tt.ptr<f16, 1>, #blocked>, tensor<32xi32, #blocked>
+      %8 = tt.load %7, %6 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32xf16, #blocked>
+      %9 = arith.addf %arg3, %8 : tensor<32xf16, #blocked>
+      scf.yield %9 : tensor<32xf16, #blocked>
+    }
+    tt.return %3 : tensor<32xf16, #blocked>
+  }
+}
+
+// -----
+
+// COM: The pointers loaded in the loop aren't affine in the induction
+// COM: variables and are left alone.
+// CHECK-LABEL: @gather
+// CHECK: scf.for {{.*}} iter_args(%{{.*}} = %{{.*}}) -> (tensor<32xf16, #blocked>)
+// CHECK: tt.load
+// CHECK: tt.addptr
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [2], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.compute-capability" = 1 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 2 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @gather(%arg0: !tt.ptr<f16, 1>, %arg1: tensor<32x!tt.ptr<i32, 1>, #blocked>) -> tensor<32xf16, #blocked> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c8_i32 = arith.constant 8 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<32xf16, #blocked>
+    %1 = tt.splat %arg0 : (!tt.ptr<f16, 1>) -> tensor<32x!tt.ptr<f16, 1>, #blocked>
+    %3 = scf.for %arg2 = %c0_i32 to %c8_i32 step %c1_i32 iter_args(%arg3 = %cst) -> (tensor<32xf16, #blocked>) : i32 {
+      %4 = tt.load %arg1 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32xi32, #blocked>
+      %5 = tt.splat %arg2 : (i32) -> tensor<32xi32, #blocked>
+      %6 = arith.addi %4, %5 : tensor<32xi32, #blocked>
+      %7 = tt.addptr %1, %6 : tensor<32x!tt.ptr<f16, 1>, #blocked>, tensor<32xi32, #blocked>
+      %8 = tt.load %7 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<32xf16, #blocked>
+      %9 = arith.addf %arg3, %8 : tensor<32xf16, #blocked>
+      scf.yield %9 : tensor<32xf16, #blocked>
+    }
+    tt.return %3 : tensor<32xf16, #blocked>
+  }
+}
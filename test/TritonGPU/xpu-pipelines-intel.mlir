@@ -0,0 +1,32 @@
+// RUN: triton-opt %s --triton-xpu-ttir-pipeline --triton-xpu-ttgir-pipeline="num-warps=2 threads-per-warp=16 capability=1" | FileCheck %s
+// RUN: triton-opt %s --triton-xpu-ttir-pipeline --triton-xpu-ttgir-pipeline="num-warps=2 threads-per-warp=16 capability=1" --triton-xpu-llvmir-pipeline="capability=1" | FileCheck %s --check-prefix=LLVM
+
+// COM: The pipelines of the stages of the XPU backend run from the command
+// COM: line as they do in Python.
+// CHECK: #[[BLOCKED:.*]] = #triton_gpu.blocked<{sizePerThread = [{{.*}}], threadsPerWarp = [16], warpsPerCTA = [2], order = [0]
+// CHECK: module attributes {{{.*}}"triton_gpu.num-warps" = 2 : i32{{.*}}"triton_gpu.threads-per-warp" = 16 : i32
+// CHECK: tt.func public @add_kernel
+// CHECK: tt.load {{.*}} : tensor<128xf32, #[[BLOCKED]]>
+// CHECK: tt.store
+// LLVM: llvm.func @add_kernel
+module {
+  tt.func public @add_kernel(%arg0: !tt.ptr<f32, 1>, %arg1: !tt.ptr<f32, 1>, %arg2: !tt.ptr<f32, 1>) {
+    %c128_i32 = arith.constant 128 : i32
+    %0 = tt.get_program_id x : i32
+    %1 = arith.muli %0, %c128_i32 : i32
+    %2 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+    %3 = tt.splat %1 : (i32) -> tensor<128xi32>
+    %4 = arith.addi %3, %2 : tensor<128xi32>
+    %5 = tt.splat %arg0 : (!tt.ptr<f32, 1>) -> tensor<128x!tt.ptr<f32, 1>>
+    %6 = tt.addptr %5, %4 : tensor<128x!tt.ptr<f32, 1>>, tensor<128xi32>
+    %7 = tt.load %6 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128xf32>
+    %8 = tt.splat %arg1 : (!tt.ptr<f32, 1>) -> tensor<128x!tt.ptr<f32, 1>>
+    %9 = tt.addptr %8, %4 : tensor<128x!tt.ptr<f32, 1>>, tensor<128xi32>
+    %10 = tt.load %9 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : tensor<128xf32>
+    %11 = arith.addf %7, %10 : tensor<128xf32>
+    %12 = tt.splat %arg2 : (!tt.ptr<f32, 1>) -> tensor<128x!tt.ptr<f32, 1>>
+    %13 = tt.addptr %12, %4 : tensor<128x!tt.ptr<f32, 1>>, tensor<128xi32>
+    tt.store %13, %11 : tensor<128xf32>
+    tt.return
+  }
+}
@@ -15,6 +15,20 @@ struct TestMembarPass
 
   MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestMembarPass);
 
+  TestMembarPass() = default;
+  TestMembarPass(const TestMembarPass &other) : PassWrapper(other) {}
+
+  Option<bool> subGroupBarriers{
+      *this, "sub-group-barriers",
+      llvm::cl::desc("Use sub-group barriers for sub-group local accesses"),
+      llvm::cl::init(false)};
+
+  Option<bool> splitBarriers{
+      *this, "split-barriers",
+      llvm::cl::desc("Split the barriers following operations that don't "
+                     "access the shared memory into an arrive and a wait"),
+      llvm::cl::init(false)};
+
   StringRef getArgument() const final { return "test-print-membar"; }
   StringRef getDescription() const final {
     return "print the result of the allocation pass";
@@ -25,7 +39,8 @@ struct TestMembarPass
     ModuleOp moduleOp = cast<ModuleOp>(operation);
     // Print all ops after membar pass
     ModuleAllocation allocation(moduleOp);
-    ModuleMembarAnalysis membarPass(&allocation);
+    ModuleMembarAnalysis membarPass(&allocation, subGroupBarriers,
+                                    splitBarriers);
     membarPass.run();
   }
 };
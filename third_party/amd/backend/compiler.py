@@ -102,10 +102,13 @@ class HIPBackend(BaseBackend):
         amd.passes.ttgpuir.add_remove_layout_conversions(pm)
         # amd.passes.ttgpuir.add_optimize_epilogue(pm)
         passes.ttgpuir.add_optimize_dot_operands(pm)
-        if opt.num_stages == 0 and opt.matrix_core_version != 0:
-            amd.passes.ttgpuir.add_stream_pipeline(pm)
+        # The stream pipeliner stages the dot operands through registers and a double buffer in LDS, with the
+        # global loads issued `num_stages - 1` iterations ahead. `num_stages == 0` selects its 2-stage schedule.
+        if opt.matrix_core_version != 0 and (opt.num_stages == 0 or opt.num_stages > 2):
+            amd.passes.ttgpuir.add_stream_pipeline(pm, max(opt.num_stages, 2))
             passes.common.add_canonicalizer(pm)
-        passes.ttgpuir.add_pipeline(pm, opt.num_stages, opt.num_warps, opt.num_ctas, 0)
+        else:
+            passes.ttgpuir.add_pipeline(pm, opt.num_stages, opt.num_warps, opt.num_ctas, 0)
         passes.ttgpuir.add_optimize_dot_operands(pm)
         amd.passes.ttgpuir.add_remove_layout_conversions(pm)
         amd.passes.ttgpuir.add_decompose_conversions(pm)
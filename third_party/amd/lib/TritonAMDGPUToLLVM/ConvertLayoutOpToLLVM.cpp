@@ -954,31 +954,44 @@ private:
       // get source values
       auto vals = getTypeConverter()->unpackLLElements(loc, adaptor.getSrc(),
                                                        rewriter, srcTy);
-      unsigned elems = getTotalElemsPerThread(srcTy);
       Type elemTy =
           this->getTypeConverter()->convertType(srcTy.getElementType());
-      // for the destination type, we need to pack values together
-      // so they can be consumed by tensor core operations
-      SmallVector<Value> vecVals;
-      SmallVector<Type> types;
-      auto elemSize = elemTy.getIntOrFloatBitWidth();
       // TODO: Support types other than float16 and
       // bf16 (represented as int16 in llvm ir).
-      assert((type::isFloat(elemTy) || type::isInt(elemTy)) && elemSize == 16);
-      // vecSize is an number of sequential elements stored by one thread
-      // - For MFMA (nonKDim == 32) encoding it is 4
-      // - For MFMA (nonKDim == 32) operand encoding it is dotOperandEndocing::kWidth,
-      //   which is 4 for fp16 and bfloat16 dtypes
-      //
-      // For mentioned types MFMA and MFMA operand layouts are the same
+      assert((type::isFloat(elemTy) || type::isInt(elemTy)) &&
+             elemTy.getIntOrFloatBitWidth() == 16);
+      // vecSize is the number of sequential K elements held by one thread,
+      // dotOperandEncoding::kWidth, which is 4 for fp16 and bfloat16 dtypes.
+      // The accumulator values of a tile are groups of vecSize sequential
+      // elements along the dimension that becomes K, so the operand vectors
+      // are packed without moving data between lanes.
       const unsigned vecSize = 4;
+      auto mfmaLayout = srcTy.getEncoding().cast<MfmaEncodingAttr>();
+      auto dotOpLayout = dstTy.getEncoding().cast<DotOperandEncodingAttr>();
+      SmallVector<unsigned> shapePerCTATile = getShapePerCTATile(mfmaLayout);
+      unsigned numRepM = srcTy.getShape()[0] / shapePerCTATile[0];
+      unsigned numRepN = srcTy.getShape()[1] / shapePerCTATile[1];
+      unsigned nonKDim = mfmaLayout.getNonKDim();
+      unsigned elemsPerTile =
+          nonKDim * nonKDim / triton::gpu::getWarpSize(mfmaLayout);
       Type vecTy = vec_ty(elemTy, vecSize);
-      types = SmallVector<Type>(elems / vecSize, vecTy);
-      for (unsigned i = 0; i < elems; i += vecSize) {
+      auto pack = [&](unsigned offset) {
         Value packed = rewriter.create<LLVM::UndefOp>(loc, vecTy);
         for (unsigned j = 0; j < vecSize; j++)
-          packed = insert_element(vecTy, packed, vals[i + j], i32_val(j));
-        vecVals.push_back(packed);
+          packed = insert_element(vecTy, packed, vals[offset + j], i32_val(j));
+        return packed;
+      };
+      // The accumulator values are ordered by (m, n) tile; the A operand is
+      // ordered by (m, k) and the B operand by (n, k).
+      SmallVector<Value> vecVals;
+      if (dotOpLayout.getOpIdx() == 0) {
+        for (unsigned i = 0; i < vals.size(); i += vecSize)
+          vecVals.push_back(pack(i));
+      } else {
+        for (unsigned n = 0; n < numRepN; ++n)
+          for (unsigned m = 0; m < numRepM; ++m)
+            for (unsigned k = 0; k < elemsPerTile; k += vecSize)
+              vecVals.push_back(pack((m * numRepN + n) * elemsPerTile + k));
       }
       Value view =
           getTypeConverter()->packLLElements(loc, vecVals, rewriter, dstTy);
@@ -7,6 +7,7 @@
 #include "triton/Analysis/Utility.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "TritonAMDGPUTransforms/Passes.h"
+#include "triton/Dialect/TritonGPU/Transforms/PipelineExpander.h"
 #include "triton/Dialect/TritonGPU/Transforms/Utility.h"
 #include "llvm/ADT/MapVector.h"
 
@@ -30,10 +31,20 @@
 //   - Store next tile into shared mem
 // - Epilogue: Peeled non-load loop body for last iteration
 //
+// With more than 2 stages, the loop is instead pipelined by the pipeline
+// expander:
+// - Stage 0: the global loads of iteration `i + numStages - 1`, kept in
+// registers while they are in flight
+// - Stage numStages - 2: the store of the tile of iteration `i + 1` into one
+// of the two shared memory buffers of each operand
+// - Stage numStages - 1: the load of the tile of iteration `i` from the other
+// shared memory buffer and the compute
+//
 //===----------------------------------------------------------------------===//
 
 using llvm::MapVector;
 using namespace mlir;
+namespace tt = mlir::triton;
 namespace ttg = triton::gpu;
 
 #define GEN_PASS_CLASSES
@@ -796,10 +807,292 @@ scf::ForOp LoopPipeliner::createNewForOp() {
 }
 
 // Stream Pipeline
+//===----------------------------------------------------------------------===//
+// Multi-stage pipelining
+//===----------------------------------------------------------------------===//
+
+/// The number of shared memory buffers of each pipelined operand: the tile of
+/// the next iteration is stored while the tile of the current one is read.
+static constexpr int numSharedBuffers = 2;
+
+struct DotOperandLoad {
+  tt::LoadOp loadOp;
+  ttg::ConvertLayoutOp cvtOp;
+};
+
+/// Collect the loads of the loop body whose single use is a conversion to a
+/// dot operand.
+static SmallVector<DotOperandLoad> collectDotOperandLoads(scf::ForOp forOp) {
+  SmallVector<DotOperandLoad> loads;
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    auto loadOp = dyn_cast<tt::LoadOp>(op);
+    if (!loadOp || tt::isTensorPointerType(loadOp.getPtr().getType()))
+      continue;
+    auto tensorTy = loadOp.getType().dyn_cast<RankedTensorType>();
+    if (!tensorTy || tensorTy.getRank() != 2 ||
+        !tensorTy.getEncoding().isa<ttg::BlockedEncodingAttr>() ||
+        !loadOp.getResult().hasOneUse())
+      continue;
+    auto cvtOp =
+        dyn_cast<ttg::ConvertLayoutOp>(*loadOp.getResult().getUsers().begin());
+    if (!cvtOp || !cvtOp.getType()
+                       .cast<RankedTensorType>()
+                       .getEncoding()
+                       .isa<ttg::DotOperandEncodingAttr>())
+      continue;
+    loads.push_back({loadOp, cvtOp});
+  }
+  return loads;
+}
+
+/// Add `op` and its dependencies in the loop body to `deps`. The dependencies
+/// carried by the loop are followed through the loop iteration arguments.
+static void addDep(Operation *op, DenseSet<Operation *> &deps) {
+  if (!deps.insert(op).second)
+    return;
+  Block *body = op->getBlock();
+  for (Value operand : op->getOperands()) {
+    Value v = operand;
+    llvm::SmallDenseSet<Value> seen;
+    while (auto arg = v.dyn_cast<BlockArgument>()) {
+      if (!seen.insert(v).second || arg.getOwner() != body ||
+          arg.getArgNumber() == 0)
+        break;
+      v = body->getTerminator()->getOperand(arg.getArgNumber() - 1);
+    }
+    Operation *defOp = v.getDefiningOp();
+    if (defOp && defOp->getBlock() == body)
+      addDep(defOp, deps);
+  }
+}
+
+/// Replace the yield with a new one with the given operands appended.
+static void appendToYield(scf::ForOp forOp, ArrayRef<Value> newOperands) {
+  Operation *yieldOp = forOp.getBody()->getTerminator();
+  SmallVector<Value> operands(yieldOp->getOperands());
+  operands.append(newOperands.begin(), newOperands.end());
+  OpBuilder builder(yieldOp);
+  builder.create<scf::YieldOp>(yieldOp->getLoc(), operands);
+  yieldOp->erase();
+}
+
+/// Allocate the shared memory buffers of the tiles of `loadOp`, in the swizzled
+/// layout of the dot operand they are converted to.
+static Value createSharedBuffers(scf::ForOp forOp, DotOperandLoad load) {
+  OpBuilder builder(forOp);
+  auto ty = load.loadOp.getType().cast<RankedTensorType>();
+  auto dotOpEnc = load.cvtOp.getType()
+                      .cast<RankedTensorType>()
+                      .getEncoding()
+                      .cast<ttg::DotOperandEncodingAttr>();
+  auto sharedEnc = ttg::SharedEncodingAttr::get(
+      ty.getContext(), dotOpEnc, ty.getShape(), ttg::getOrder(ty.getEncoding()),
+      ttg::getCTALayout(ty.getEncoding()), ty.getElementType());
+  SmallVector<int64_t> bufferShape(ty.getShape().begin(), ty.getShape().end());
+  bufferShape.insert(bufferShape.begin(), numSharedBuffers);
+  auto bufferTy =
+      RankedTensorType::get(bufferShape, ty.getElementType(), sharedEnc);
+  return builder.create<ttg::AllocTensorOp>(load.loadOp.getLoc(), bufferTy);
+}
+
+/// Stage the loaded tiles through the shared memory buffers: each load is
+/// stored into the buffer selected by a rotating insert index, and the dot
+/// operand is converted from the buffer selected by a rotating extract index.
+/// Return the insert_slice ops.
+static SmallVector<Operation *>
+createSharedStores(scf::ForOp &forOp, ArrayRef<DotOperandLoad> loads) {
+  SmallVector<Value> newOperands;
+  for (const DotOperandLoad &load : loads)
+    newOperands.push_back(createSharedBuffers(forOp, load));
+
+  OpBuilder builder(forOp);
+  Location loc = forOp.getLoc();
+  Value minusOne = builder.create<arith::ConstantIntOp>(loc, -1, 32);
+  Value zero = builder.create<arith::ConstantIntOp>(loc, 0, 32);
+  Value one = builder.create<arith::ConstantIntOp>(loc, 1, 32);
+  Value numBuffersVal =
+      builder.create<arith::ConstantIntOp>(loc, numSharedBuffers, 32);
+  newOperands.push_back(minusOne);
+  newOperands.push_back(minusOne);
+
+  unsigned newOperandIndex = forOp.getBody()->getNumArguments();
+  scf::ForOp newForOp =
+      replaceForOpWithNewSignature(builder, forOp, newOperands);
+  forOp.erase();
+  forOp = newForOp;
+  Block *body = forOp.getBody();
+
+  // Advance the indices separately so that each one is computed in the stage
+  // that uses it.
+  auto advance = [&](Value idx) -> Value {
+    idx = builder.create<arith::AddIOp>(loc, idx, one);
+    Value cnd = builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::slt,
+                                              idx, numBuffersVal);
+    return builder.create<arith::SelectOp>(loc, cnd, idx, zero);
+  };
+  builder.setInsertionPoint(loads.front().loadOp);
+  Value insertIdx =
+      advance(body->getArgument(newOperandIndex + loads.size()));
+  Value extractIdx =
+      advance(body->getArgument(newOperandIndex + loads.size() + 1));
+
+  auto intAttr = [&](int64_t v) { return builder.getI64IntegerAttr(v); };
+  SmallVector<Operation *> stores;
+  SmallVector<Value> newYieldOperands;
+  for (auto [i, load] : llvm::enumerate(loads)) {
+    tt::LoadOp loadOp = load.loadOp;
+    ttg::ConvertLayoutOp cvtOp = load.cvtOp;
+    auto ty = loadOp.getType().cast<RankedTensorType>();
+    Value buffer = body->getArgument(newOperandIndex + i);
+    auto bufferTy = buffer.getType().cast<RankedTensorType>();
+    SmallVector<OpFoldResult> sizes = {intAttr(1), intAttr(ty.getShape()[0]),
+                                       intAttr(ty.getShape()[1])};
+    SmallVector<OpFoldResult> strides = {intAttr(1), intAttr(1), intAttr(1)};
+
+    builder.setInsertionPointAfter(loadOp);
+    auto insertOp = builder.create<tensor::InsertSliceOp>(
+        loc, loadOp.getResult(), buffer,
+        SmallVector<OpFoldResult>{insertIdx, intAttr(0), intAttr(0)}, sizes,
+        strides);
+    auto sliceTy = RankedTensorType::get(ty.getShape(), ty.getElementType(),
+                                         bufferTy.getEncoding());
+    auto extractOp = builder.create<ttg::ExtractSliceOp>(
+        loc, sliceTy, insertOp.getResult(),
+        SmallVector<OpFoldResult>{extractIdx, intAttr(0), intAttr(0)}, sizes,
+        strides);
+    cvtOp.getSrcMutable().assign(extractOp.getResult());
+    stores.push_back(insertOp);
+    newYieldOperands.push_back(insertOp.getResult());
+  }
+  newYieldOperands.push_back(insertIdx);
+  newYieldOperands.push_back(extractIdx);
+  appendToYield(forOp, newYieldOperands);
+  return stores;
+}
+
+/// Return true if `op` can be placed in a stage that is predicated in the
+/// prologue and in the last iterations of the loop, which is only supported
+/// for loads and side effect free ops outside of the computation.
+static bool canBePredicated(Operation *op) {
+  if (isa<tt::DotOp>(op) || op->getNumRegions() != 0)
+    return false;
+  return isa<tt::LoadOp>(op) || isMemoryEffectFree(op);
+}
+
+/// Create the schedule of the loop: the global loads and the computation of
+/// their addresses go in stage 0, the stores to shared memory in stage
+/// `numStages - 2` and everything else in stage `numStages - 1`. The stores are
+/// placed after the compute so that the tile of the next iteration is written
+/// once the current one has been read.
+static void
+createSchedule(scf::ForOp forOp, ArrayRef<DotOperandLoad> loads,
+               ArrayRef<Operation *> stores, int numStages,
+               std::vector<std::pair<Operation *, unsigned>> &schedule) {
+  DenseSet<Operation *> loadDeps;
+  for (const DotOperandLoad &load : loads)
+    addDep(load.loadOp, loadDeps);
+  DenseSet<Operation *> storeDeps;
+  for (Operation *store : stores)
+    addDep(store, storeDeps);
+
+  auto getStage = [&](Operation *op) {
+    if (loadDeps.count(op))
+      return 0;
+    if (storeDeps.count(op))
+      return numStages - 2;
+    return numStages - 1;
+  };
+  for (int stage : {0, numStages - 1, numStages - 2})
+    for (Operation &op : forOp.getBody()->without_terminator())
+      if (getStage(&op) == stage)
+        schedule.emplace_back(&op, stage);
+}
+
+/// Function to mask operations during scheduling.
+static Operation *predicateOp(RewriterBase &rewriter, Operation *op,
+                              Value pred) {
+  OpBuilder::InsertionGuard guard(rewriter);
+  if (isMemoryEffectFree(op))
+    return op;
+
+  auto loadOp = cast<tt::LoadOp>(op);
+  rewriter.setInsertionPoint(loadOp);
+  Location loc = loadOp.getLoc();
+  Type maskType = tt::getI1SameShape(loadOp.getPtr().getType());
+  Value mask = rewriter.create<tt::SplatOp>(loc, maskType, pred);
+  if (Value currentMask = loadOp.getMask())
+    mask = rewriter.create<arith::AndIOp>(loc, mask, currentMask);
+  loadOp.getMaskMutable().assign(mask);
+  return op;
+}
+
+/// Return true if the preconditions for pipelining the loop are met.
+static bool preCondition(scf::ForOp forOp) {
+  // Skip loop with distance > 1.
+  if (llvm::any_of(forOp.getBody()->getTerminator()->getOperands(),
+                   [](Value operand) { return !operand.getDefiningOp(); }))
+    return false;
+  // Don't pipeline outer loops.
+  return !forOp
+              ->walk([&](Operation *op) {
+                if (forOp.getOperation() == op)
+                  return WalkResult::advance();
+                if (isa<scf::ForOp, scf::WhileOp>(op))
+                  return WalkResult::interrupt();
+                return WalkResult::advance();
+              })
+              .wasInterrupted();
+}
+
+static void pipelineLoop(scf::ForOp forOp, int numStages) {
+  if (!preCondition(forOp))
+    return;
+
+  SmallVector<DotOperandLoad> loads = collectDotOperandLoads(forOp);
+  if (loads.empty())
+    return;
+
+  // The loads must not depend on the result of the computation. This is
+  // checked before rewriting the loop; the stores to shared memory added by
+  // the rewrite only depend on the loads and on their own indices.
+  DenseSet<Operation *> loadDeps;
+  for (const DotOperandLoad &load : loads)
+    addDep(load.loadOp, loadDeps);
+  if (!llvm::all_of(loadDeps, canBePredicated))
+    return;
+
+  SmallVector<Operation *> stores = createSharedStores(forOp, loads);
+  std::vector<std::pair<Operation *, unsigned>> schedule;
+  createSchedule(forOp, loads, stores, numStages, schedule);
+
+  tt::PipeliningOption options;
+  options.getScheduleFn =
+      [schedule](scf::ForOp forOp,
+                 std::vector<std::pair<Operation *, unsigned>> &s) {
+        s = std::move(schedule);
+      };
+  options.peelEpilogue = false;
+  options.predicateFn = predicateOp;
+  options.supportDynamicLoops = true;
+
+  IRRewriter rewriter(forOp->getContext());
+  rewriter.setInsertionPoint(forOp);
+  (void)tt::pipelineForLoop(rewriter, forOp, options);
+}
+
 struct PipelinePass : public TritonAMDGPUStreamPipelineBase<PipelinePass> {
   PipelinePass() = default;
+  PipelinePass(int numStages) { this->numStages = numStages; }
 
   void runOnOperation() override {
+    if (numStages > 2) {
+      SmallVector<scf::ForOp> loops;
+      getOperation()->walk([&](scf::ForOp forOp) { loops.push_back(forOp); });
+      for (scf::ForOp forOp : loops)
+        pipelineLoop(forOp, numStages);
+      return;
+    }
+
     // Pre-processing
     // we make sure element-wise ops are done *after* the conversion
     // to dot operands
@@ -833,6 +1126,6 @@ struct PipelinePass : public TritonAMDGPUStreamPipelineBase<PipelinePass> {
 };
 } // anonymous namespace
 
-std::unique_ptr<Pass> mlir::createTritonAMDGPUStreamPipelinePass() {
-  return std::make_unique<PipelinePass>();
+std::unique_ptr<Pass> mlir::createTritonAMDGPUStreamPipelinePass(int numStages) {
+  return std::make_unique<PipelinePass>(numStages);
 }
@@ -1,15 +1,20 @@
 from triton.backends.compiler import BaseBackend
 from triton._C.libtriton import ir, passes, llvm, intel
 from triton.backends.intel.driver import XPUUtils
+from triton.compiler import reproducer
 from dataclasses import dataclass
+import contextlib
 import functools
 from typing import Any
 import hashlib
+import json
 import re
 import tempfile
 import signal
 import os
 import subprocess
+import time
+import warnings
 from pathlib import Path
 
 # ------------- TMA stuff ----------------#
@@ -43,15 +48,6 @@ def dummy_tensormaps_info(n=2):
     return ret
 
 
-def parse_tma_info(infos, ids_of_folded_args):
-    ret = []
-    for info in infos:
-        e = InfoFromBackendForTensorMap(infos=info)
-        e.ids_of_folded_args = ids_of_folded_args
-        ret.append(e)
-    return ret
-
-
 def get_tma_mapping(tensormaps_info):
     ret = {}
     if tensormaps_info is not None:
@@ -315,6 +311,37 @@ def _path_to_binary(binary: str):
     raise RuntimeError(f"Cannot find {binary}")
 
 
+def compile_timing_enabled():
+    return os.environ.get("TRITON_ENABLE_COMPILE_TIMING", "0") == "1"
+
+
+def run_passes(pm, mod, metadata):
+    # The remarks of the passes, e.g. the loads they couldn't vectorize, are
+    # added to the kernel metadata as [pass, location, message], and printed
+    # as well with MLIR_ENABLE_REMARK=1.
+    remarks = pm.enable_remarks()
+    # The time spent in each pass is added to the kernel metadata, and thus
+    # cached along with the kernel, when compile timing is enabled.
+    timings = pm.enable_timing() if compile_timing_enabled() else None
+    pm.run(mod)
+    kernel_remarks = metadata.setdefault("remarks", [])
+    for remark in map(list, remarks.get()):
+        if remark not in kernel_remarks:
+            kernel_remarks.append(remark)
+    if timings is not None:
+        metadata.setdefault("compile_times", []).extend(timings.get())
+
+
+@contextlib.contextmanager
+def timed(metadata, name):
+    if not compile_timing_enabled():
+        yield
+        return
+    start = time.perf_counter()
+    yield
+    metadata.setdefault("compile_times", []).append((name, time.perf_counter() - start))
+
+
 @functools.lru_cache()
 def ptx_get_version(cuda_version) -> int:
     '''
@@ -331,21 +358,112 @@ def ptx_get_version(cuda_version) -> int:
     raise RuntimeError("Triton only support CUDA 10.0 or higher")
 
 
+# The SPIR-V extensions the kernels may use, and the OpenCL extension of the
+# device each of them requires, if any. IGC parses the modules faster when
+# they don't declare extensions they don't use.
+SPIRV_EXTENSIONS = {
+    "SPV_KHR_bit_instructions": None,
+    "SPV_KHR_expect_assume": None,
+    "SPV_KHR_linkonce_odr": None,
+    "SPV_KHR_no_integer_wrap_decoration": None,
+    "SPV_INTEL_arbitrary_precision_integers": None,
+    "SPV_INTEL_inline_assembly": None,
+    "SPV_INTEL_long_constant_composite": None,
+    "SPV_INTEL_unstructured_loop_controls": None,
+    "SPV_INTEL_subgroups": "cl_intel_subgroups",
+    "SPV_INTEL_bfloat16_conversion": "cl_intel_bfloat16_conversions",
+    "SPV_INTEL_split_barrier": "cl_intel_split_work_group_barrier",
+    "SPV_EXT_shader_atomic_float_add": "cl_ext_float_atomics",
+    "SPV_EXT_shader_atomic_float_min_max": "cl_ext_float_atomics",
+    "SPV_EXT_shader_atomic_float16_add": "cl_ext_float_atomics",
+    "SPV_KHR_integer_dot_product": "cl_khr_integer_dot_product",
+}
+
+
+def get_spirv_extensions(device_extensions):
+    """The SPIR-V extensions of a device with the given OpenCL extensions."""
+    return tuple(ext for ext, required in SPIRV_EXTENSIONS.items() if required is None or required in device_extensions)
+
+
+# the IGC flags of the register file sizes of the kernels
+GRF_MODE_FLAGS = {"default": "", "large": "-ze-opt-large-register-file"}
+# number of general registers of a hardware thread in each GRF mode
+GRF_SIZES = {"default": 128, "large": 256}
+# hardware threads of an EU in each GRF mode
+THREADS_PER_EU = {"default": 8, "large": 4}
+# the `DeviceArch`s of the passes specific to an architecture
+DEVICE_ARCH_PVC = 1
+DEVICE_ARCH_UNKNOWN = 3
+# EUs, bytes of a general register and bytes of shared local memory of an Xe
+# core, by `DeviceArch`: Arc (0) and PVC (1)
+XE_CORE_EUS = {0: 16, 1: 8}
+XE_CORE_GRF_BYTES = {0: 32, 1: 64}
+XE_CORE_SHARED_MEM = {0: 65536, 1: 131072}
+
+
 @dataclass(frozen=True)
 class XPUOptions:
     num_warps: int = 4
+    threads_per_warp: int = 32
     num_ctas: int = 1
     num_stages: int = 2
     cluster_dims: tuple = (1, 1, 1)
     ptx_version: int = None
     enable_warp_specialization: bool = False
     enable_persistent: bool = False
-    optimize_epilogue: bool = False
+    # number of tiles along the first dimension of the grid that persistent
+    # kernels visit before moving along the second one, 0 to visit it in order
+    swizzle_group: int = 0
+    # "explicit" splits the grid across the tiles of a device exposing them as
+    # sub-devices, e.g. PVC in COMPOSITE mode, each tile running a contiguous
+    # range of the grid from its own queue. "implicit" leaves the distribution
+    # of the work-groups of the root device to the driver.
+    tile_launch: str = "implicit"
+    # store the results of the DPAS straight from their registers, rather than
+    # through the shared local memory
+    optimize_epilogue: bool = True
     enable_fp_fusion: bool = True
+    # map the libdevice functions of tl.math, e.g. exp, log, rsqrt and tanh, to
+    # the native approximations of the device, at the cost of their precision
+    fast_math: bool = False
     allow_fp8e4nv: bool = False
     max_num_imprecise_acc_default: bool = None
     extern_libs: dict = None
     debug: bool = False
+    # size in bytes of the shared local memory of the device, 0 if unknown
+    max_shared_mem: int = 0
+    # flags passed to IGC when the driver builds the SPIR-V module, e.g.
+    # "-ze-opt-level=1"
+    build_flags: str = ""
+    # "large" doubles the registers of each thread, at the cost of half the
+    # threads per EU, which often removes the spills of the larger kernels
+    grf_mode: str = "default"
+    # the SPIR-V extensions the kernels may use, all the ones the translator
+    # supports if empty
+    spirv_extensions: tuple = ()
+    # comma-separated kinds of the regions of the kernel whose cycles are
+    # counted, among "loop", "dot" and "load", see `XPULauncher.region_cycles`
+    profile_regions: str = ""
+    # number of i64 slots of the buffer the prints and the assertions of the
+    # kernel append their records to instead of calling printf, 0 to print
+    # through printf, see `XPULauncher.flush_prints`
+    print_buffer_size: int = 0
+    # number of scalar arguments from which the kernels get them packed in a
+    # buffer the launcher fills with a single copy, 0 to never pack them
+    pack_scalar_args: int = 0
+    # the features of the device the passes are selected by, those of its
+    # architecture by default: the dots are mapped to the DPAS of 16 lanes, the
+    # block pointers feeding them lowered to 2D block IO
+    has_dpas: bool = None
+    has_2d_block_io: bool = None
+    # select the number of warps from the shapes of the tensors of the kernel
+    # rather than take `num_warps`, see `metadata.num_warps` for the selection
+    auto_num_warps: bool = False
+    # where the source lines of the kernel are kept: "device" in the debug
+    # info of its SPIR-V, "side" in a line table of the native binary stored in
+    # the cache, `asm["lines"]`, the SPIR-V loaded by the driver having no
+    # debug info, "none" not at all
+    line_info: str = "device"
 
     def __post_init__(self):
         default_libdir = Path(__file__).parent / 'lib'
@@ -355,6 +473,20 @@ class XPUOptions:
         object.__setattr__(self, 'extern_libs', tuple(extern_libs.items()))
         assert self.num_warps > 0 and (self.num_warps & (self.num_warps - 1)) == 0, \
                "num_warps must be a power of 2"
+        assert self.threads_per_warp in (8, 16, 32), \
+               "threads_per_warp must be one of the sub-group sizes supported by the device (8, 16 or 32)"
+        assert self.grf_mode in GRF_MODE_FLAGS, \
+               f"grf_mode must be one of {', '.join(GRF_MODE_FLAGS)}"
+        assert self.tile_launch in ("implicit", "explicit"), \
+               "tile_launch must be either implicit or explicit"
+        assert self.line_info in ("device", "side", "none"), \
+               "line_info must be one of device, side or none"
+        build_flags = self.build_flags.split()
+        if GRF_MODE_FLAGS[self.grf_mode] and GRF_MODE_FLAGS[self.grf_mode] not in build_flags:
+            build_flags.append(GRF_MODE_FLAGS[self.grf_mode])
+        object.__setattr__(self, 'build_flags', ' '.join(build_flags))
+        if self.profile_regions == "1":
+            object.__setattr__(self, 'profile_regions', "loop,dot,load")
 
     def hash(self):
         key = '_'.join([f'{name}-{val}' for name, val in self.__dict__.items()])
@@ -375,150 +507,302 @@ class XPUBackend(BaseBackend):
     def parse_options(self, opts) -> Any:
         args = {k: opts[k] for k in XPUOptions.__dataclass_fields__.keys() if k in opts}
         args["allow_fp8e4nv"] = True
-        args["max_num_imprecise_acc_default"] = 2**30 if self.capability == 90 else 0
+        args["max_num_imprecise_acc_default"] = 0
+        args.setdefault("profile_regions", os.environ.get("TRITON_INTEL_PROFILE_REGIONS", ""))
+        args.setdefault("print_buffer_size", int(os.environ.get("TRITON_INTEL_PRINT_BUFFER", "0")))
+        args.setdefault("pack_scalar_args", int(os.environ.get("TRITON_INTEL_PACK_SCALAR_ARGS", "0")))
+        args.setdefault("auto_num_warps", os.environ.get("TRITON_INTEL_AUTO_NUM_WARPS", "0") == "1")
+        if os.environ.get("TRITON_DISABLE_LINE_INFO", "0") == "1":
+            args["line_info"] = "none"
+        args.setdefault("line_info", os.environ.get("TRITON_INTEL_LINE_INFO", "device"))
+        explicit_tiles = args.get("tile_launch") == "explicit"
+        features = ("max_shared_mem", "spirv_extensions", "has_dpas", "has_2d_block_io")
+        if any(args.get(name) is None for name in features) or explicit_tiles:
+            utils = XPUUtils()
+            props = utils.get_device_properties(utils.get_current_device())
+            args.setdefault("max_shared_mem", props["max_shared_mem"])
+            if args.get("has_dpas") is None:
+                args["has_dpas"] = props["dpas_execution_size"] == 16
+            if args.get("has_2d_block_io") is None:
+                args["has_2d_block_io"] = props["has_2d_block_io"]
+            # no restriction if the device doesn't report its extensions
+            if props.get("extensions"):
+                args.setdefault("spirv_extensions", get_spirv_extensions(props["extensions"]))
+            # a single tile has no grid to split
+            if explicit_tiles and props["num_sub_devices"] < 2:
+                args["tile_launch"] = "implicit"
         return XPUOptions(**args)
 
     def load_dialects(self, ctx):
         intel.load_dialects(ctx)
 
+    # The passes of the stages are mirrored by the pipelines of
+    # bin/RegisterXPUPipelines.h, for triton-opt, update them together.
     @staticmethod
     def make_ttir(mod, metadata, opt):
         pm = ir.pass_manager(mod.context)
         pm.enable_debug()
         passes.common.add_inliner(pm)
         passes.ttir.add_combine(pm)
+        passes.ttir.add_fold_masks(pm)
         passes.common.add_canonicalizer(pm)
         passes.ttir.add_reorder_broadcast(pm)
         passes.common.add_cse(pm)
         passes.common.add_licm(pm)
         passes.common.add_symbol_dce(pm)
-        pm.run(mod)
+        # The buffer of the packed arguments is the first argument of the
+        # kernel, the buffer of the prints follows its own arguments, and
+        # precedes the arguments added to the kernel on TTGIR.
+        if opt.pack_scalar_args > 0:
+            intel.passes.ttgpuir.add_pack_scalar_args(pm, opt.pack_scalar_args)
+        if opt.print_buffer_size > 0:
+            intel.passes.ttgpuir.add_buffer_prints(pm)
+        # The counters of the grid barriers follow the buffer of the prints.
+        intel.passes.ttgpuir.add_grid_barriers(pm)
+        run_passes(pm, mod, metadata)
+        # The launcher of the kernels with buffered prints passes them the
+        # buffer and decodes its records.
+        metadata["buffered_prints"] = mod.get_str_array_attr("triton_gpu.buffered_prints") or []
+        # The launcher of the kernels with packed arguments copies them to the
+        # buffer of their first argument.
+        metadata["packed_args"] = mod.get_int_array_attr("triton_gpu.packed_args") or []
+        # The launcher of the kernels with grid barriers launches them
+        # cooperatively and passes them the counters of the barriers.
+        metadata["cooperative"] = mod.get_int_attr("triton_gpu.cooperative") == 1
         return mod
 
     @staticmethod
     def make_ttgir(mod, metadata, opt, capability):
-        cluster_info = intel.ClusterInfo()
-        if opt.cluster_dims is not None:
-            cluster_info.clusterDimX = opt.cluster_dims[0]
-            cluster_info.clusterDimY = opt.cluster_dims[1]
-            cluster_info.clusterDimZ = opt.cluster_dims[2]
         # TTIR -> TTGIR
+        # Only the passes that are relevant for GENX run here: the CTA
+        # planning, warp specialization and TMA passes of the NVIDIA pipeline
+        # target Hopper features the XPU doesn't have.
+        threads_per_xe_core = XE_CORE_EUS.get(capability, 8) * THREADS_PER_EU[opt.grf_mode]
+        num_warps = opt.num_warps
+        if opt.auto_num_warps:
+            # The layouts of the conversion are those of the selected number
+            # of warps, which the launcher takes from the metadata.
+            pm = ir.pass_manager(mod.context)
+            pm.enable_debug()
+            intel.passes.ttgpuir.add_select_num_warps(pm, opt.threads_per_warp, threads_per_xe_core)
+            run_passes(pm, mod, metadata)
+            num_warps = mod.get_int_attr("triton_gpu.selected_num_warps")
+            metadata["num_warps"] = num_warps
         pm = ir.pass_manager(mod.context)
         pm.enable_debug()
-        passes.ttir.add_convert_to_ttgpuir(pm, opt.num_warps, 32, opt.num_ctas, capability)
+        passes.ttir.add_convert_to_ttgpuir(pm, num_warps, opt.threads_per_warp, opt.num_ctas, capability)
         # optimize TTGIR
-        passes.ttgpuir.add_coalesce(pm)
-        # TODO(Qingyi): Move PlanCTAPass to the front of CoalescePass
-        intel.passes.ttnvgpuir.add_plan_cta(pm, cluster_info)
-        intel.passes.ttgpuir.add_rewrite_tensor_pointer(pm, capability)
-        intel.passes.ttnvgpuir.add_plan_cta(pm, cluster_info)
+        intel.passes.ttgpuir.add_coalesce(pm, capability)
+        intel.passes.ttgpuir.add_distribute_reductions(pm)
         passes.ttgpuir.add_remove_layout_conversions(pm)
         passes.ttgpuir.add_optimize_thread_locality(pm)
-        passes.ttgpuir.add_accelerate_matmul(pm, capability)
+        # The passes specific to an architecture are selected by the features
+        # of the device, the DPAS and 2D block IO of PVC.
+        intel.passes.ttgpuir.add_accelerate_matmul(pm, DEVICE_ARCH_PVC if opt.has_dpas else DEVICE_ARCH_UNKNOWN)
         passes.ttgpuir.add_remove_layout_conversions(pm)
+        # Block pointers feeding DPAS are kept intact and lowered to 2D block
+        # IO, the other ones are rewritten into tensors of pointers.
+        intel.passes.ttgpuir.add_materialize_block_pointer(
+            pm, DEVICE_ARCH_PVC if opt.has_dpas and opt.has_2d_block_io else DEVICE_ARCH_UNKNOWN)
+        intel.passes.ttgpuir.add_rewrite_tensor_pointer(pm, capability)
+        passes.ttgpuir.add_remove_layout_conversions(pm)
+        # The offsets of the pointers into the tensors of less than 2GB are
+        # computed in i32.
+        intel.passes.ttgpuir.add_narrow_pointer_offsets(pm)
+        # The rewritten pointers are carried by the loops rather than recomputed
+        # from the offsets at each iteration.
+        intel.passes.ttgpuir.add_strength_reduce_pointers(pm)
+        passes.common.add_licm(pm)
         if opt.optimize_epilogue:
             passes.ttgpuir.add_optimize_epilogue(pm)
         passes.ttgpuir.add_optimize_dot_operands(pm)
         passes.common.add_cse(pm)
-        # `num_warps` does not mean the total number of warps of a CTA when
-        # warp specialization is enabled.
-        # it's the responsibility of the compiler to figure out the exact
-        # `num_warps` to use.
-        # TODO: support the case where `num_warps` from user is not 4.
-        ws_enabled = False
-        if capability // 10 >= 9 and opt.enable_warp_specialization and opt.num_warps == 4:
-            intel.passes.ttnvgpuir.add_wsfeasibility_checking(pm, capability)
-            pm.run(mod)
-            ws_enabled = intel.passes.ttnvgpuir.is_ws_supported(mod)
-            pm = ir.pass_manager(mod.context)
-            pm.enable_debug()
-        metadata["ws_enabled"] = ws_enabled
-        if ws_enabled:
-            intel.passes.ttnvgpuir.add_wsdecomposing(pm, capability)
-            intel.passes.ttnvgpuir.add_wspipeline(pm, opt.num_stages, opt.num_warps, capability)
-            intel.passes.ttnvgpuir.add_wsmutex(pm, capability)
-            intel.passes.ttnvgpuir.add_wsmaterialization(pm, capability)
-            passes.common.add_licm(pm)
-            passes.common.add_cse(pm)
-        else:
-            passes.ttgpuir.add_pipeline(pm, opt.num_stages, opt.num_warps, opt.num_ctas, capability)
-        intel.passes.ttnvgpuir.add_materialize_load_store(pm, opt.num_warps, capability)
-        if capability // 10 <= 8:
-            passes.ttgpuir.add_prefetch(pm)
+        # The traffic is estimated before the loops are pipelined, while their
+        # bounds are those of the source.
+        intel.passes.ttgpuir.add_estimate_traffic(pm)
+        # The loops with a loop_unroll_factor are pipelined unrolled.
+        intel.passes.ttgpuir.add_loop_unroll(pm)
+        intel.passes.ttgpuir.add_prefetch_block(pm, opt.num_stages)
+        intel.passes.ttgpuir.add_pipeline(pm, opt.num_stages)
+        passes.ttgpuir.add_prefetch(pm)
         passes.ttgpuir.add_optimize_dot_operands(pm)
         passes.ttgpuir.add_remove_layout_conversions(pm)
         passes.ttgpuir.add_reduce_data_duplication(pm)
-        intel.passes.ttnvgpuir.add_wsfixup_missing_attrs(pm)
         passes.ttgpuir.add_reorder_instructions(pm)
+        if opt.enable_persistent:
+            intel.passes.ttgpuir.add_persistent(pm, opt.swizzle_group)
+        if opt.tile_launch == "explicit":
+            intel.passes.ttgpuir.add_partition_grid(pm)
+        # The buffer of the instrumented regions is the last argument of the
+        # kernel, after the ones of the grid.
+        if opt.profile_regions:
+            intel.passes.ttgpuir.add_instrument_regions(pm, opt.profile_regions)
         passes.common.add_cse(pm)
         passes.common.add_symbol_dce(pm)
-        if capability // 10 >= 9:
-            intel.passes.ttnvgpuir.add_fence_insertion(pm)
-        intel.passes.ttnvgpuir.add_wsfixup_missing_attrs(pm)
         passes.common.add_canonicalizer(pm)
-        pm.run(mod)
-        metadata["cluster_dims"] = (cluster_info.clusterDimX, cluster_info.clusterDimY, cluster_info.clusterDimZ)
+        intel.passes.ttgpuir.add_estimate_resources(pm, XE_CORE_GRF_BYTES.get(capability, 64), threads_per_xe_core,
+                                                    XE_CORE_SHARED_MEM.get(capability, 131072))
+        run_passes(pm, mod, metadata)
+        metadata["cluster_dims"] = opt.cluster_dims
+        # Estimates of the resources of the kernel, before it is lowered, e.g.
+        # for the autotuner to reject the configs that can't fit.
+        work_groups = mod.get_int_attr("triton_gpu.estimated_work_groups_per_xe_core")
+        metadata["resource_estimate"] = {
+            "num_grf": mod.get_int_attr("triton_gpu.estimated_num_grf"),
+            "max_num_grf": GRF_SIZES[opt.grf_mode],
+            "shared": mod.get_int_attr("triton_gpu.estimated_shared"),
+            "work_groups_per_xe_core": work_groups,
+            "occupancy": work_groups * num_warps / threads_per_xe_core,
+        }
+        # The launcher of persistent kernels passes them the grid.
+        metadata["persistent"] = mod.get_int_attr("triton_gpu.persistent") == 1
+        # The launcher of the partitioned kernels passes them their range of the
+        # grid.
+        metadata["partition_grid"] = mod.get_int_attr("triton_gpu.partition_grid") == 1
+        # The launcher of the instrumented kernels passes them the buffer of the
+        # cycles of these regions.
+        metadata["profile_regions"] = mod.get_str_array_attr("triton_gpu.profile_regions") or []
+        # The bytes read and written in global memory and the FLOPs of a
+        # program instance, completed at launch time by `CompiledKernel.traffic`.
+        metadata["traffic"] = mod.get_str_array_attr("triton_gpu.traffic") or []
         return mod
 
     @staticmethod
-    def make_llir(src, metadata, options, capability):
-        # warp-specialization mutates num_warps
-        num_warp_groups = src.get_int_attr("triton_gpu.num-warp-groups-per-cta")
-        if num_warp_groups is not None:
-            metadata["num_warps"] *= num_warp_groups
+    def make_llvm_module(src, metadata, options, capability, context):
         mod = src
         # TritonGPU -> LLVM-IR (MLIR)
-        tma_infos = intel.TMAInfos()
         pm = ir.pass_manager(mod.context)
         pm.enable_debug()
         passes.ttgpuir.add_decompose_unsupported_conversions(pm)
         passes.convert.add_scf_to_cf(pm)
         passes.convert.add_index_to_llvmir(pm)
-        passes.ttgpuir.add_allocate_shared_memory(pm)
-        intel.passes.ttgpuir.add_to_llvmir(pm, capability, tma_infos)
-        if metadata["ws_enabled"]:
-            passes.common.add_licm(pm)
-            passes.common.add_cse(pm)
-        intel.passes.ttnvgpuir.add_nvgpu_to_llvm(pm)
+        intel.passes.ttgpuir.add_allocate_shared_memory(pm, options.max_shared_mem)
+        run_passes(pm, mod, metadata)
+        # Kernels that don't fit in the shared local memory of the device are
+        # rejected before being lowered, so that e.g. the autotuner can skip
+        # their configs without building them.
+        shared = mod.get_int_attr("triton_gpu.shared")
+        if options.max_shared_mem and shared > options.max_shared_mem:
+            from triton.runtime.autotuner import OutOfResources
+            raise OutOfResources(shared, options.max_shared_mem, "shared memory")
+        pm = ir.pass_manager(mod.context)
+        pm.enable_debug()
+        intel.passes.ttgpuir.add_to_llvmir(pm, capability)
+        intel.passes.ttgpuir.add_nvgpu_to_llvm(pm)
         passes.convert.add_arith_to_llvmir(pm)
         passes.common.add_canonicalizer(pm)
         passes.common.add_cse(pm)
+        intel.passes.ttgpuir.add_schedule_dpas(pm, GRF_SIZES[options.grf_mode])
         passes.common.add_symbol_dce(pm)
-        if os.environ.get("TRITON_DISABLE_LINE_INFO", "0") == "0":
+        if options.line_info != "none":
             passes.llvmir.add_di_scope(pm)
-        pm.run(mod)
+        run_passes(pm, mod, metadata)
         # LLVM-IR (MLIR) -> LLVM-IR (LLVM)
         llvm.init_targets()
-        context = llvm.context()
         llvm_mod = llvm.to_module(mod, context)
         llvm.set_spv_target_triple(llvm_mod)
+        if options.fast_math:
+            intel.replace_with_native_math(llvm_mod)
         if options.extern_libs:
             for name, path in options.extern_libs:
                 llvm.link_extern_lib(llvm_mod, path)
-        llvm.optimize_module(llvm_mod, llvm.OPTIMIZE_O3)
+        intel.inline_extern_lib_calls(llvm_mod)
+        reproducer.add_file(metadata, "llir-unoptimized.llir", llvm_mod)
+        with timed(metadata, "optimize_module"):
+            # The SLP vectorizer pays off on the FMA and conversion code of XPU.
+            slp_vectorize = os.environ.get("TRITON_INTEL_DISABLE_SLP", "0") == "0"
+            # The assert handlers and the unlikely branches are outlined, so
+            # that the unrolled main loops keep the instruction cache.
+            outline_cold = os.environ.get("TRITON_INTEL_DISABLE_COLD_OUTLINING", "0") == "0"
+            llvm.optimize_module(llvm_mod, llvm.OPTIMIZE_O3, slp_vectorize=slp_vectorize,
+                                 outline_cold=outline_cold, llvm_options=XPUBackend.llvm_options)
         # Get some metadata
-        if len(tma_infos) > 0:
-            metadata["tensormaps_info"] = parse_tma_info(tma_infos, metadata["ids_of_folded_args"])
-            for i, _ in enumerate(metadata["tensormaps_info"]):
-                metadata["tensormaps_info"][i].ids_of_folded_args = metadata["ids_of_folded_args"]
-        metadata["ids_of_tensormaps"] = get_ids_of_tensormaps(metadata.get("tensormaps_info", None))
+        metadata["ids_of_tensormaps"] = None
         metadata["shared"] = src.get_int_attr("triton_gpu.shared")
+        # the (id, type) of the specialization constants set when the kernel is loaded
+        metadata["spec_constants"] = intel.get_spec_constants(llvm_mod)
+        return llvm_mod
+
+    # Tuning of the LLVM cost models, which only have the generic TTI for SPIR-V:
+    # - the vectors of the SLP vectorizer may hold 16 32-bit lanes, the widest
+    #   SPIR-V vectors, instead of the 32 bits of the generic TTI,
+    # - the few loops left after the lowering are unrolled with twice the O3
+    #   threshold.
+    llvm_options = {
+        "slp-max-reg-size": "512",
+        "unroll-threshold": "600",
+    }
+
+    @staticmethod
+    def make_llir(src, metadata, options, capability):
+        context = llvm.context()
+        llvm_mod = XPUBackend.make_llvm_module(src, metadata, options, capability, context)
         ret = str(llvm_mod)
         del llvm_mod
         del context
         return ret
 
     @staticmethod
-    def make_spv(src, metadata):
-        ret, name = llvm.translate_to_spirv(src)
+    def make_spv(src, metadata, options):
+        # the LLVM IR is already verified by its translation from MLIR
+        extensions = list(options.spirv_extensions)
+        with timed(metadata, "translate_to_spirv"):
+            if options.line_info == "side":
+                debug_spv, _ = llvm.translate_to_spirv(src, options.debug, extensions)
+            ret, name = llvm.translate_to_spirv(src, options.debug, extensions,
+                                                strip_debug_info=options.line_info == "side")
         metadata["name"] = name
+        if options.line_info == "side":
+            with timed(metadata, "line_table"):
+                lines = XPUBackend.make_line_table(debug_spv, metadata, options)
+            if lines is not None:
+                metadata.setdefault("side_files", {})["lines"] = json.dumps(lines, separators=(",", ":"))
+        return ret
+
+    @staticmethod
+    def make_line_table(debug_spv, metadata, options):
+        # The SPIR-V with debug info is finalized once, with -g, for the line
+        # table of its native binary, keeping the debug info off the SPIR-V
+        # the driver builds at every load of the kernel.
+        from triton.tools.zeasm import get_line_table
+        utils = XPUUtils()
+        try:
+            native = utils.get_native_binary(metadata["name"], debug_spv, metadata["shared"],
+                                             utils.get_current_device(), f"{options.build_flags} -g".strip())
+        except RuntimeError as e:
+            warnings.warn(f"No line table for {metadata['name']}: {e}")
+            return None
+        return get_line_table(native) if native is not None else None
+
+    @staticmethod
+    def make_llir_spv(src, metadata, options, capability):
+        # Hand the LLVM module straight to the SPIR-V translator rather than
+        # printing it and parsing it back.
+        context = llvm.context()
+        llvm_mod = XPUBackend.make_llvm_module(src, metadata, options, capability, context)
+        ret = XPUBackend.make_spv(llvm_mod, metadata, options)
+        del llvm_mod
+        del context
         return ret
 
+    @staticmethod
+    def emit_llir():
+        # The textual LLVM IR is only needed when the kernel IRs are dumped,
+        # overridden or stored, or for the reproducers of the SPIR-V
+        # translation.
+        stored = os.environ.get("TRITON_STORE_IR", "").split(",")
+        return os.environ.get("TRITON_KERNEL_DUMP", "0") == "1" or \
+               os.environ.get("TRITON_KERNEL_OVERRIDE", "0") == "1" or reproducer.enabled() or \
+               "llir" in (ext.strip() for ext in stored)
+
     def add_stages(self, stages, options):
         stages["ttir"] = lambda src, metadata: self.make_ttir(src, metadata, options)
         stages["ttgir"] = lambda src, metadata: self.make_ttgir(src, metadata, options, self.capability)
-        stages["llir"] = lambda src, metadata: self.make_llir(src, metadata, options, self.capability)
-        stages["spv"] = lambda src, metadata: self.make_spv(src, metadata)
+        if self.emit_llir():
+            stages["llir"] = lambda src, metadata: self.make_llir(src, metadata, options, self.capability)
+            stages["spv"] = lambda src, metadata: self.make_spv(src, metadata, options)
+        else:
+            stages["spv"] = lambda src, metadata: self.make_llir_spv(src, metadata, options, self.capability)
 
     @functools.lru_cache()
     def hash(self):
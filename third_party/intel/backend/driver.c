@@ -6,11 +6,26 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <iostream>
 #include <level_zero/ze_api.h>
+#include <level_zero/zes_api.h>
+#include <level_zero/zet_api.h>
+#if __has_include(<level_zero/ze_intel_gpu.h>)
+// Intel specific extensions, used to query the register file size of kernels.
+#include <level_zero/ze_intel_gpu.h>
+#define HAS_ZEX_REGISTER_FILE_SIZE
+#endif
+#include <map>
+#include <optional>
 #include <string>
+#include <sys/syscall.h>
 #include <sycl/sycl.hpp>
+#include <tuple>
+#include <unistd.h>
 #include <unordered_map>
 #include <utility>
 #include <variant>
@@ -57,6 +72,58 @@ static inline void gpuAssert(ze_result_t code, const char *file, int line) {
       return NULL;                                                             \
   }
 
+// The architecture of an Intel GPU and the features the code generation
+// depends on. `device_arch` is the `triton::gpu::intel::DeviceArch` whose code
+// generation the architecture shares: PVC for Xe-HPC and the Xe2 and later
+// architectures, with the same DPAS and 2D block IO, ATS for the other Xe
+// ones.
+struct IntelArch {
+  const char *name;
+  int device_arch;
+  // lanes of the DPAS instructions, 0 without DPAS
+  int dpas_execution_size;
+  bool has_2d_block_io;
+};
+
+// The architecture of a device from its IP version, `(architecture << 22) |
+// (release << 14) | revision`, reported by recent drivers, or else from its
+// PCI device id.
+// https://dgpu-docs.intel.com/devices/hardware-table.html
+static IntelArch getIntelArch(uint32_t ip_version, int pci_device_id) {
+  if (ip_version != 0) {
+    uint32_t arch = ip_version >> 22;
+    uint32_t release = (ip_version >> 14) & 0xFF;
+    if (arch >= 30)
+      return {"xe3", 1, 16, true};
+    if (arch == 20)
+      return {release == 4 ? "xe2-lpg" : "xe2-hpg", 1, 16, true};
+    if (arch == 12) {
+      if (release >= 60 && release < 70)
+        return {"xe-hpc", 1, 16, true};
+      if (release >= 55 && release < 60)
+        return {"xe-hpg", 0, 8, false};
+      if (release == 74)
+        return {"xe-lpg+", 0, 8, false};
+      if (release >= 70)
+        return {"xe-lpg", 0, 0, false};
+    }
+  }
+  switch ((pci_device_id >> 8) & 0xFF) {
+  case 0x56: // Arc GPUs 56xx
+    return {"xe-hpg", 0, 8, false};
+  case 0x0B: // PVC GPUs 0Bxx
+    return {"xe-hpc", 1, 16, true};
+  case 0xE2: // Battlemage GPUs E2xx
+    return {"xe2-hpg", 1, 16, true};
+  case 0x64: // Lunar Lake GPUs 64xx
+    return {"xe2-lpg", 1, 16, true};
+  case 0x7D: // Meteor Lake and Arrow Lake GPUs 7Dxx
+    return {"xe-lpg", 0, 0, false};
+  default:
+    return {"unknown", 3, 0, false}; // DeviceArch::UNKNOWN
+  }
+}
+
 static PyObject *getDeviceProperties(PyObject *self, PyObject *args) {
   int device_id;
   if (!PyArg_ParseTuple(args, "i", &device_id))
@@ -74,26 +141,24 @@ static PyObject *getDeviceProperties(PyObject *self, PyObject *args) {
   // create a struct to hold device properties
   ze_device_properties_t device_properties = {};
   device_properties.stype = ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES;
+  uint32_t ip_version = 0;
+#ifdef ZE_DEVICE_IP_VERSION_EXT_NAME
+  ze_device_ip_version_ext_t ip_version_ext = {};
+  ip_version_ext.stype = ZE_STRUCTURE_TYPE_DEVICE_IP_VERSION_EXT;
+  device_properties.pNext = &ip_version_ext;
+#endif
   zeDeviceGetProperties(phDevice, &device_properties);
+#ifdef ZE_DEVICE_IP_VERSION_EXT_NAME
+  ip_version = ip_version_ext.ipVersion;
+#endif
 
   int multiprocessor_count =
       device_properties.numSlices * device_properties.numSubslicesPerSlice;
   int sm_clock_rate = device_properties.coreClockRate;
 
-  // Extract triton::gpu::intel::DeviceArch from pci_device_id
-  // https://dgpu-docs.intel.com/devices/hardware-table.html
   int pci_device_id = device_properties.deviceId;
-  int gpu_arch = 3; // triton::gpu::intel::DeviceArch::UNKNOWN
-  switch ((pci_device_id >> 8) & 0xFF) {
-  case 0x56:
-    gpu_arch = 0; // Arc GPUs 56xx
-    break;
-  case 0x0B:      // PVC GPUs 0Bxx
-    gpu_arch = 1; // PVC
-    break;
-  default:
-    ; // fall through
-  }
+  IntelArch arch = getIntelArch(ip_version, pci_device_id);
+  int gpu_arch = arch.device_arch;
 
   ze_device_compute_properties_t compute_properties = {};
   compute_properties.stype = ZE_STRUCTURE_TYPE_DEVICE_COMPUTE_PROPERTIES;
@@ -114,11 +179,135 @@ static PyObject *getDeviceProperties(PyObject *self, PyObject *args) {
 
   delete[] pMemoryProperties;
 
-  return Py_BuildValue("{s:i, s:i, s:i, s:i, s:i, s:i}", "max_shared_mem",
-                       max_shared_mem, "multiprocessor_count",
-                       multiprocessor_count, "sm_clock_rate", sm_clock_rate,
-                       "mem_clock_rate", mem_clock_rate, "mem_bus_width",
-                       mem_bus_width, "device_arch", gpu_arch);
+  // The last level cache, i.e. the L3, is the largest one.
+  uint32_t cacheCount = 0;
+  zeDeviceGetCacheProperties(phDevice, &cacheCount, nullptr);
+  std::vector<ze_device_cache_properties_t> cacheProperties(cacheCount);
+  for (auto &cacheProps : cacheProperties) {
+    cacheProps.stype = ZE_STRUCTURE_TYPE_DEVICE_CACHE_PROPERTIES;
+    cacheProps.pNext = nullptr;
+  }
+  zeDeviceGetCacheProperties(phDevice, &cacheCount, cacheProperties.data());
+  unsigned long long l3_cache_size = 0;
+  for (const auto &cacheProps : cacheProperties)
+    l3_cache_size = std::max<unsigned long long>(l3_cache_size,
+                                                 cacheProps.cacheSize);
+
+  // The driver version tells whether native binaries built by a previous run
+  // can be reused.
+  ze_driver_handle_t phDriver =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(
+          device.first.get_platform());
+  ze_driver_properties_t driver_properties = {};
+  driver_properties.stype = ZE_STRUCTURE_TYPE_DRIVER_PROPERTIES;
+  zeDriverGetProperties(phDriver, &driver_properties);
+  unsigned int driver_version = driver_properties.driverVersion;
+
+  // The tiles of a PVC device are its sub-devices when the device is exposed
+  // as a whole (ZE_FLAT_DEVICE_HIERARCHY=COMPOSITE), with implicit scaling of
+  // the kernels across them. Each tile is a device without sub-devices
+  // otherwise.
+  uint32_t num_sub_devices = 0;
+  zeDeviceGetSubDevices(phDevice, &num_sub_devices, nullptr);
+
+  // The OpenCL extensions of the device tell which SPIR-V extensions its
+  // kernels can use.
+  PyObject *py_extensions = PyList_New(0);
+  if (!py_extensions)
+    return NULL;
+  for (const auto &extension :
+       device.first.get_info<sycl::info::device::extensions>()) {
+    PyObject *py_extension = PyUnicode_FromString(extension.c_str());
+    if (!py_extension || PyList_Append(py_extensions, py_extension) < 0) {
+      Py_XDECREF(py_extension);
+      Py_DECREF(py_extensions);
+      return NULL;
+    }
+    Py_DECREF(py_extension);
+  }
+
+  // The execution resources of the device: its EUs, their hardware threads
+  // and the bytes of a general register of a thread, 64 with the DPAS of 16
+  // lanes and 32 otherwise.
+  int num_eus = multiprocessor_count * device_properties.numEUsPerSubslice;
+  int threads_per_eu = device_properties.numThreadsPerEU;
+  int grf_size = arch.dpas_execution_size == 16 ? 64 : 32;
+
+  PyObject *py_sub_group_sizes = PyList_New(0);
+  if (!py_sub_group_sizes) {
+    Py_DECREF(py_extensions);
+    return NULL;
+  }
+  for (size_t sub_group_size :
+       device.first.get_info<sycl::info::device::sub_group_sizes>()) {
+    PyObject *py_size = PyLong_FromSize_t(sub_group_size);
+    if (!py_size || PyList_Append(py_sub_group_sizes, py_size) < 0) {
+      Py_XDECREF(py_size);
+      Py_DECREF(py_sub_group_sizes);
+      Py_DECREF(py_extensions);
+      return NULL;
+    }
+    Py_DECREF(py_size);
+  }
+
+  return Py_BuildValue(
+      "{s:i, s:i, s:i, s:i, s:i, s:i, s:i, s:I, s:K, s:I, s:N, s:i, s:i, s:i, "
+      "s:O, s:N, s:I, s:s, s:i, s:O}",
+      "max_shared_mem", max_shared_mem, "multiprocessor_count",
+      multiprocessor_count, "sm_clock_rate", sm_clock_rate, "mem_clock_rate",
+      mem_clock_rate, "mem_bus_width", mem_bus_width, "device_arch", gpu_arch,
+      "device_id", pci_device_id, "driver_version", driver_version,
+      "l3_cache_size", l3_cache_size, "num_sub_devices", num_sub_devices,
+      "extensions", py_extensions, "num_eus", num_eus, "threads_per_eu",
+      threads_per_eu, "grf_size", grf_size, "has_dpas",
+      arch.dpas_execution_size ? Py_True : Py_False, "sub_group_sizes",
+      py_sub_group_sizes, "ip_version", ip_version, "arch", arch.name,
+      "dpas_execution_size", arch.dpas_execution_size, "has_2d_block_io",
+      arch.has_2d_block_io ? Py_True : Py_False);
+}
+
+// Return the current frequencies in MHz of the compute engines and of the
+// memory of a device, read from the Sysman frequency domains of Level Zero.
+// The Sysman API is only usable through the core device handles when
+// ZES_ENABLE_SYSMAN=1 is set before Level Zero is initialized, the frequencies
+// are -1 otherwise or when the driver does not report them.
+static PyObject *getDeviceFrequencies(PyObject *self, PyObject *args) {
+  int device_id;
+  if (!PyArg_ParseTuple(args, "i", &device_id))
+    return NULL;
+
+  if (device_id >= sycl_l0_device_list.size()) {
+    PyErr_SetString(PyExc_ValueError, "device is not found");
+    return NULL;
+  }
+  auto phDevice = (zes_device_handle_t)sycl_l0_device_list[device_id].second;
+
+  double gpu_clock_rate = -1, mem_clock_rate = -1;
+  uint32_t domainCount = 0;
+  if (zesDeviceEnumFrequencyDomains(phDevice, &domainCount, nullptr) ==
+      ZE_RESULT_SUCCESS) {
+    std::vector<zes_freq_handle_t> domains(domainCount);
+    zesDeviceEnumFrequencyDomains(phDevice, &domainCount, domains.data());
+    for (auto domain : domains) {
+      zes_freq_properties_t props = {};
+      props.stype = ZES_STRUCTURE_TYPE_FREQ_PROPERTIES;
+      zes_freq_state_t state = {};
+      state.stype = ZES_STRUCTURE_TYPE_FREQ_STATE;
+      if (zesFrequencyGetProperties(domain, &props) != ZE_RESULT_SUCCESS ||
+          zesFrequencyGetState(domain, &state) != ZE_RESULT_SUCCESS ||
+          state.actual < 0)
+        continue;
+      // The tiles of a device have a domain each, they run at the same
+      // frequency.
+      if (props.type == ZES_FREQ_DOMAIN_GPU)
+        gpu_clock_rate = state.actual;
+      else if (props.type == ZES_FREQ_DOMAIN_MEMORY)
+        mem_clock_rate = state.actual;
+    }
+  }
+
+  return Py_BuildValue("{s:d, s:d}", "gpu_clock_rate", gpu_clock_rate,
+                       "mem_clock_rate", mem_clock_rate);
 }
 
 /*Sycl code Start*/
@@ -130,35 +319,52 @@ bool getBoolEnv(const std::string &env) {
   return (str == "on" || str == "true" || str == "1");
 }
 
+// Build a Level Zero module, `build_flags` are passed to the IGC compiler, e.g.
+// "-ze-opt-large-register-file", and `constants` are the values of the SPIR-V
+// specialization constants. They are ignored for native binaries.
 ze_module_handle_t create_module(ze_context_handle_t context,
                                  ze_device_handle_t device,
-                                 uint32_t *binary_ptr, size_t binary_size) {
-  const char *build_flags = "";
-  const ze_module_format_t format = ZE_MODULE_FORMAT_IL_SPIRV;
+                                 uint8_t *binary_ptr, size_t binary_size,
+                                 ze_module_format_t format,
+                                 const char *build_flags = "",
+                                 const ze_module_constants_t *constants =
+                                     nullptr) {
   ze_module_desc_t module_description = {};
   module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
   module_description.format = format;
-  module_description.inputSize =
-      static_cast<uint32_t>(binary_size * sizeof(uint32_t));
-  module_description.pInputModule = (uint8_t *)binary_ptr;
+  module_description.inputSize = binary_size;
+  module_description.pInputModule = binary_ptr;
   module_description.pBuildFlags = build_flags;
+  module_description.pConstants = constants;
   ze_module_build_log_handle_t buildlog;
   ze_module_handle_t module;
   auto context_initial = context;
   auto device_initial = device;
   auto error_no = ZE_RESULT_SUCCESS;
+  // The SPIR-V is compiled without the GIL, so that the other threads keep
+  // launching kernels meanwhile.
+  Py_BEGIN_ALLOW_THREADS;
   error_no =
       zeModuleCreate(context, device, &module_description, &module, &buildlog);
+  Py_END_ALLOW_THREADS;
   if (error_no != ZE_RESULT_SUCCESS) {
+    // The build log of IGC is part of the error, e.g. for the reproducers of
+    // the native builds.
     size_t szLog = 0;
-    ZE_CHECK(zeModuleBuildLogGetString(buildlog, &szLog, nullptr));
-    char *strLog = (char *)malloc(szLog);
-    ZE_CHECK(zeModuleBuildLogGetString(buildlog, &szLog, strLog));
-    std::cerr << "L0 build module failed. Log: " << strLog << std::endl;
-    free(strLog);
-    ZE_CHECK(zeModuleBuildLogDestroy(buildlog));
-  }
-  ZE_CHECK(error_no);
+    std::string log;
+    if (zeModuleBuildLogGetString(buildlog, &szLog, nullptr) ==
+        ZE_RESULT_SUCCESS) {
+      log.resize(szLog);
+      zeModuleBuildLogGetString(buildlog, &szLog, &log[0]);
+      log.resize(strlen(log.c_str()));
+    }
+    zeModuleBuildLogDestroy(buildlog);
+    std::string err = "Triton Error [ZE]: " + std::to_string(error_no) +
+                      ", L0 build module failed. Log: " + log;
+    PyErr_SetString(PyExc_RuntimeError, err.c_str());
+    return nullptr;
+  }
+  ZE_CHECK(zeModuleBuildLogDestroy(buildlog));
   return module;
 }
 
@@ -198,17 +404,85 @@ ze_kernel_handle_t create_function(ze_module_handle_t module,
   return create_function(module, ZE_KERNEL_FLAG_FORCE_RESIDENCY, func_name);
 }
 
-std::vector<std::unique_ptr<sycl::kernel>> compiled_kernels;
+// A kernel loaded on a device, shared by all the loads of the same binary.
+struct LoadedKernel {
+  sycl::kernel_bundle<sycl::bundle_state::executable> bundle;
+  sycl::kernel kernel;
+  int32_t n_regs;
+  int32_t n_spills;
+  PyObject *py_kernel_props;
+  size_t ref_count;
+};
+
+// Loaded kernels keyed by module hash, kernel name, device and context. The
+// Level Zero module of a kernel is released with its entry, once every load of
+// it has been unloaded. Only accessed with the GIL held, which the loads
+// release while their module is built.
+using KernelKey = std::tuple<std::string, std::string, ze_device_handle_t,
+                             ze_context_handle_t>;
+std::map<KernelKey, std::unique_ptr<LoadedKernel>> compiled_kernels;
+
+// Return the native binary the given module has been finalized to, so that
+// later loads can skip the SPIR-V compilation.
+static PyObject *getNativeBinary(ze_module_handle_t module) {
+  size_t native_size = 0;
+  ZE_CHECK(zeModuleGetNativeBinary(module, &native_size, nullptr));
+  std::vector<uint8_t> native_binary(native_size);
+  ZE_CHECK(zeModuleGetNativeBinary(module, &native_size, native_binary.data()));
+  return PyBytes_FromStringAndSize(
+      reinterpret_cast<const char *>(native_binary.data()), native_size);
+}
+
+static PyObject *buildLoadResult(LoadedKernel *loaded,
+                                 PyObject *py_native_binary) {
+  Py_INCREF(loaded->py_kernel_props);
+  return Py_BuildValue("(KKiiNN)", (uint64_t)&loaded->bundle,
+                       (uint64_t)&loaded->kernel, loaded->n_regs,
+                       loaded->n_spills, loaded->py_kernel_props,
+                       py_native_binary);
+}
 
 static PyObject *loadSyclBinary(PyObject *self, PyObject *args) {
   const char *name;
   int shared;
   PyObject *py_bytes;
   PyObject *py_dev;
-  if (!PyArg_ParseTuple(args, "sSiO", &name, &py_bytes, &shared, &py_dev)) {
+  const char *module_hash;
+  int is_native = 0;
+  const char *build_flags = "";
+  PyObject *py_queue = Py_None;
+  PyObject *py_spec_constants = Py_None;
+  if (!PyArg_ParseTuple(args, "sSiOs|psOO", &name, &py_bytes, &shared, &py_dev,
+                        &module_hash, &is_native, &build_flags, &py_queue,
+                        &py_spec_constants)) {
     std::cerr << "loadSyclBinary arg parse failed" << std::endl;
     return NULL;
   }
+  // The specialization constants by id, with the bits of their values, which
+  // the driver reads with the size of the type of each constant.
+  std::vector<uint32_t> constant_ids;
+  std::vector<uint64_t> constant_values;
+  if (py_spec_constants != Py_None) {
+    if (!PyDict_Check(py_spec_constants)) {
+      PyErr_SetString(PyExc_TypeError,
+                      "the specialization constants must be a dict");
+      return NULL;
+    }
+    PyObject *py_id, *py_value;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(py_spec_constants, &pos, &py_id, &py_value)) {
+      constant_ids.push_back(PyLong_AsUnsignedLong(py_id));
+      constant_values.push_back(PyLong_AsUnsignedLongLong(py_value));
+    }
+    if (PyErr_Occurred())
+      return NULL;
+  }
+  std::vector<const void *> constant_ptrs;
+  for (const uint64_t &value : constant_values)
+    constant_ptrs.push_back(&value);
+  ze_module_constants_t constants = {
+      static_cast<uint32_t>(constant_ids.size()), constant_ids.data(),
+      constant_ptrs.data()};
   int32_t n_regs = 0;
   int32_t n_spills = 0;
   void *pdevID = PyCapsule_GetPointer(py_dev, PyCapsule_GetName(py_dev));
@@ -217,28 +491,72 @@ static PyObject *loadSyclBinary(PyObject *self, PyObject *args) {
 
   sycl::device device = *(static_cast<sycl::device *>(pdevID));
   std::string kernel_name = name;
-  size_t binary_size = PyBytes_Size(py_bytes);
-  binary_size = binary_size / sizeof(uint32_t);
-
-  uint32_t *binary_ptr = (uint32_t *)PyBytes_AsString(py_bytes);
-  ;
-  auto ctx = device.get_platform().ext_oneapi_get_default_context();
   auto l0_device =
       sycl::get_native<sycl::backend::ext_oneapi_level_zero>(device);
+  // The kernel is created in the context of the queue it is launched on, the
+  // default context of the platform if none is given.
+  auto ctx = device.get_platform().ext_oneapi_get_default_context();
+  if (py_queue != Py_None) {
+    void *queue = PyCapsule_GetPointer(py_queue, PyCapsule_GetName(py_queue));
+    if (queue == nullptr)
+      return NULL;
+    ctx = static_cast<sycl::queue *>(queue)->get_context();
+  }
   auto l0_context = sycl::get_native<sycl::backend::ext_oneapi_level_zero>(ctx);
-  auto l0_module =
-      create_module(l0_context, l0_device, binary_ptr, binary_size);
+
+  KernelKey key{module_hash, kernel_name, l0_device, l0_context};
+  auto it = compiled_kernels.find(key);
+  if (it != compiled_kernels.end()) {
+    // Already loaded, nothing new to cache.
+    ++it->second->ref_count;
+    Py_INCREF(Py_None);
+    return buildLoadResult(it->second.get(), Py_None);
+  }
+
+  size_t binary_size = PyBytes_Size(py_bytes);
+  uint8_t *binary_ptr = (uint8_t *)PyBytes_AsString(py_bytes);
+  auto l0_module = create_module(
+      l0_context, l0_device, binary_ptr, binary_size,
+      is_native ? ZE_MODULE_FORMAT_NATIVE : ZE_MODULE_FORMAT_IL_SPIRV,
+      build_flags, constant_ids.empty() ? nullptr : &constants);
+  if (PyErr_Occurred())
+    return NULL;
   auto l0_kernel = create_function(l0_module, kernel_name);
 
   if (PyErr_Occurred()) {
     // check for errors from module/kernel creation
     return NULL;
   }
+  // Loaded by another thread while the module was built.
+  it = compiled_kernels.find(key);
+  if (it != compiled_kernels.end()) {
+    ZE_CHECK(zeKernelDestroy(l0_kernel));
+    ZE_CHECK(zeModuleDestroy(l0_module));
+    ++it->second->ref_count;
+    Py_INCREF(Py_None);
+    return buildLoadResult(it->second.get(), Py_None);
+  }
+
+  PyObject *py_native_binary = Py_None;
+  if (is_native) {
+    Py_INCREF(Py_None);
+  } else if (!(py_native_binary = getNativeBinary(l0_module))) {
+    return NULL;
+  }
 
-  ze_kernel_properties_t props;
+  ze_kernel_properties_t props = {};
   props.stype = ZE_STRUCTURE_TYPE_KERNEL_PROPERTIES;
   props.pNext = nullptr;
+#ifdef HAS_ZEX_REGISTER_FILE_SIZE
+  zex_kernel_register_file_size_exp_t register_file_size = {};
+  register_file_size.stype = ZEX_STRUCTURE_KERNEL_REGISTER_FILE_SIZE_EXP;
+  register_file_size.pNext = nullptr;
+  props.pNext = &register_file_size;
+#endif
   ZE_CHECK(zeKernelGetProperties(l0_kernel, &props));
+#ifdef HAS_ZEX_REGISTER_FILE_SIZE
+  n_regs = register_file_size.registerFileSize;
+#endif
   n_spills = props.spillMemSize;
   auto mod = sycl::make_kernel_bundle<sycl::backend::ext_oneapi_level_zero,
                                       sycl::bundle_state::executable>(
@@ -246,21 +564,57 @@ static PyObject *loadSyclBinary(PyObject *self, PyObject *args) {
   auto fun = sycl::make_kernel<sycl::backend::ext_oneapi_level_zero>(
       {mod, l0_kernel, sycl::ext::oneapi::level_zero::ownership::transfer},
       ctx);
-  compiled_kernels.push_back(std::make_unique<sycl::kernel>(fun));
-  sycl::kernel *ptr = compiled_kernels[compiled_kernels.size() - 1].get();
+
+  size_t max_work_group_size =
+      fun.get_info<sycl::info::kernel_device_specific::work_group_size>(
+          device);
+  PyObject *py_kernel_props = Py_BuildValue(
+      "{s:I, s:I, s:I, s:I, s:n}", "private_mem_size", props.privateMemSize,
+      "spill_mem_size", props.spillMemSize, "local_mem_size",
+      props.localMemSize, "required_sub_group_size", props.requiredSubgroupSize,
+      "max_work_group_size", (Py_ssize_t)max_work_group_size);
+  if (!py_kernel_props) {
+    Py_DECREF(py_native_binary);
+    return NULL;
+  }
+
+  auto &loaded = compiled_kernels[key];
+  loaded.reset(
+      new LoadedKernel{mod, fun, n_regs, n_spills, py_kernel_props, 1});
   if (getBoolEnv("MLIR_ENABLE_DUMP")) {
-    std::cout << "compiled kernel ptr: " << ptr << std::endl;
+    std::cout << "compiled kernel ptr: " << &loaded->kernel << std::endl;
     std::cout << "total kernels:" << compiled_kernels.size() << std::endl;
-    for (auto &k : compiled_kernels) {
+    for (auto &entry : compiled_kernels) {
       std::cout << "  kernel:"
-                << k->get_info<sycl::info::kernel::function_name>() << " @"
-                << k.get() << std::endl;
+                << entry.second->kernel
+                       .get_info<sycl::info::kernel::function_name>()
+                << " @" << &entry.second->kernel << std::endl;
     }
   }
-  sycl::kernel *k = new sycl::kernel(*ptr);
-  sycl::kernel_bundle<sycl::bundle_state::executable> *kb =
-      new sycl::kernel_bundle<sycl::bundle_state::executable>(mod);
-  return Py_BuildValue("(KKii)", (uint64_t)kb, (uint64_t)k, n_regs, n_spills);
+  return buildLoadResult(loaded.get(), py_native_binary);
+}
+
+// Drop one reference to a kernel returned by loadSyclBinary, releasing the
+// kernel and its module once it is no longer used.
+static PyObject *unloadSyclBinary(PyObject *self, PyObject *args) {
+  uint64_t kernel_ptr;
+  if (!PyArg_ParseTuple(args, "K", &kernel_ptr))
+    return NULL;
+
+  for (auto it = compiled_kernels.begin(); it != compiled_kernels.end();
+       ++it) {
+    LoadedKernel *loaded = it->second.get();
+    if ((uint64_t)&loaded->kernel != kernel_ptr)
+      continue;
+    if (--loaded->ref_count == 0) {
+      Py_DECREF(loaded->py_kernel_props);
+      compiled_kernels.erase(it);
+    }
+    Py_RETURN_NONE;
+  }
+
+  PyErr_SetString(PyExc_ValueError, "unknown kernel");
+  return NULL;
 }
 /*Sycl code end*/
 
@@ -412,13 +766,722 @@ static PyObject *getL0CtxtPtr(PyObject *self, PyObject *args) {
   return Py_BuildValue("(K)", (uint64_t)(sycl_queue_map[*sycl_queue].context));
 }
 
+static sycl::queue *getSyclQueue(PyObject *cap) {
+  return static_cast<sycl::queue *>(
+      PyCapsule_GetPointer(cap, PyCapsule_GetName(cap)));
+}
+
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+namespace syclex = sycl::ext::oneapi::experimental;
+using modifiable_graph = syclex::command_graph<syclex::graph_state::modifiable>;
+using executable_graph =
+    syclex::command_graph<syclex::graph_state::executable>;
+#endif
+
+// Start recording the work submitted to a queue into a SYCL graph.
+static PyObject *beginGraphCapture(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "O", &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+  auto *graph = new modifiable_graph(sycl_queue->get_context(),
+                                     sycl_queue->get_device());
+  graph->begin_recording(*sycl_queue);
+  return Py_BuildValue("K", (uint64_t)graph);
+#else
+  PyErr_SetString(PyExc_RuntimeError, "SYCL graphs are not supported");
+  return NULL;
+#endif
+}
+
+// Stop recording and return the executable graph. When an executable graph
+// recorded from the same sequence of kernels is given, it is updated with the
+// arguments of the new recording instead of finalizing another graph.
+static PyObject *endGraphCapture(PyObject *self, PyObject *args) {
+  uint64_t recording;
+  PyObject *cap;
+  uint64_t exec_graph;
+  if (!PyArg_ParseTuple(args, "KOK", &recording, &cap, &exec_graph))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+  std::unique_ptr<modifiable_graph> graph(
+      reinterpret_cast<modifiable_graph *>(recording));
+  graph->end_recording(*sycl_queue);
+  try {
+    if (exec_graph) {
+      reinterpret_cast<executable_graph *>(exec_graph)->update(*graph);
+      return Py_BuildValue("K", exec_graph);
+    }
+    auto *exec = new executable_graph(
+        graph->finalize(syclex::property::graph::updatable{}));
+    return Py_BuildValue("K", (uint64_t)exec);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+#else
+  PyErr_SetString(PyExc_RuntimeError, "SYCL graphs are not supported");
+  return NULL;
+#endif
+}
+
+static PyObject *replayGraph(PyObject *self, PyObject *args) {
+  uint64_t exec_graph;
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "KO", &exec_graph, &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+  sycl_queue->ext_oneapi_graph(
+      *reinterpret_cast<executable_graph *>(exec_graph));
+#endif
+  Py_RETURN_NONE;
+}
+
+static PyObject *destroyGraph(PyObject *self, PyObject *args) {
+  uint64_t exec_graph;
+  if (!PyArg_ParseTuple(args, "K", &exec_graph))
+    return NULL;
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+  delete reinterpret_cast<executable_graph *>(exec_graph);
+#endif
+  Py_RETURN_NONE;
+}
+
+// The events of the kernels launched by the launchers, handed to Python as
+// pointers to heap allocated `sycl::event`s.
+static sycl::event *getEvent(uint64_t handle) {
+  return reinterpret_cast<sycl::event *>(handle);
+}
+
+// Block until the kernel of an event completes.
+static PyObject *synchronizeEvent(PyObject *self, PyObject *args) {
+  uint64_t handle;
+  if (!PyArg_ParseTuple(args, "K", &handle))
+    return NULL;
+  sycl::event *event = getEvent(handle);
+  Py_BEGIN_ALLOW_THREADS
+  event->wait();
+  Py_END_ALLOW_THREADS
+  Py_RETURN_NONE;
+}
+
+// Make the work submitted to a queue from now on wait for the kernel of an
+// event, without blocking the host.
+static PyObject *waitEvent(PyObject *self, PyObject *args) {
+  uint64_t handle;
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "KO", &handle, &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+  sycl_queue->ext_oneapi_submit_barrier({*getEvent(handle)});
+  Py_RETURN_NONE;
+}
+
+// Return whether the kernel of an event has completed.
+static PyObject *queryEvent(PyObject *self, PyObject *args) {
+  uint64_t handle;
+  if (!PyArg_ParseTuple(args, "K", &handle))
+    return NULL;
+  auto status =
+      getEvent(handle)
+          ->get_info<sycl::info::event::command_execution_status>();
+  return PyBool_FromLong(status == sycl::info::event_command_status::complete);
+}
+
+// Return the time in milliseconds from the start of the kernel of an event
+// to the end of the kernel of another one, which may be the same. The queue
+// of the kernels must have been created with profiling enabled.
+static PyObject *eventElapsedTime(PyObject *self, PyObject *args) {
+  uint64_t start, end;
+  if (!PyArg_ParseTuple(args, "KK", &start, &end))
+    return NULL;
+  try {
+    uint64_t start_ns = getEvent(start)->get_profiling_info<
+        sycl::info::event_profiling::command_start>();
+    uint64_t end_ns = getEvent(end)->get_profiling_info<
+        sycl::info::event_profiling::command_end>();
+    return PyFloat_FromDouble((double(end_ns) - double(start_ns)) * 1e-6);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+}
+
+static PyObject *destroyEvent(PyObject *self, PyObject *args) {
+  uint64_t handle;
+  if (!PyArg_ParseTuple(args, "K", &handle))
+    return NULL;
+  delete getEvent(handle);
+  Py_RETURN_NONE;
+}
+
+// The scratch pool: blocks of device USM memory, e.g. the workspaces of the
+// kernels, reused in the order of the queue they are released on. A block
+// released after the launches that use it are submitted to an in-order queue
+// is handed to the next allocation on the same queue without waiting, as the
+// kernels it is allocated for run after them. The blocks have power of 2
+// sizes, and are only freed by `scratchEmptyCache`.
+constexpr size_t min_scratch_block = 512;
+
+struct ScratchPool {
+  std::unordered_map<size_t, std::vector<void *>> free_blocks;
+  size_t cached_bytes = 0;
+  size_t used_bytes = 0;
+};
+static std::unordered_map<sycl::queue, ScratchPool> scratch_pools;
+
+static size_t getScratchBlockSize(size_t nbytes) {
+  size_t size = min_scratch_block;
+  while (size < nbytes)
+    size <<= 1;
+  return size;
+}
+
+static void emptyScratchCache(sycl::queue &queue, ScratchPool &pool) {
+  queue.wait();
+  for (auto &[size, blocks] : pool.free_blocks)
+    for (void *block : blocks)
+      sycl::free(block, queue);
+  pool.free_blocks.clear();
+  pool.cached_bytes = 0;
+}
+
+// Return the address and size of a block of at least `nbytes` for the
+// kernels submitted to a queue, filled with zeros before them if `zero`.
+static PyObject *scratchAlloc(PyObject *self, PyObject *args) {
+  unsigned long long nbytes;
+  PyObject *cap;
+  int zero;
+  if (!PyArg_ParseTuple(args, "KOp", &nbytes, &cap, &zero))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+  ScratchPool &pool = scratch_pools[*sycl_queue];
+  size_t size = getScratchBlockSize(nbytes);
+  void *block = nullptr;
+  auto it = pool.free_blocks.find(size);
+  if (it != pool.free_blocks.end() && !it->second.empty()) {
+    block = it->second.back();
+    it->second.pop_back();
+    pool.cached_bytes -= size;
+  } else {
+    block = sycl::malloc_device(size, *sycl_queue);
+    if (!block && pool.cached_bytes) {
+      // the cached blocks of other sizes are given back first
+      emptyScratchCache(*sycl_queue, pool);
+      block = sycl::malloc_device(size, *sycl_queue);
+    }
+    if (!block) {
+      PyErr_Format(PyExc_MemoryError,
+                   "failed to allocate %zu bytes of scratch memory", size);
+      return NULL;
+    }
+  }
+  pool.used_bytes += size;
+  if (zero)
+    sycl_queue->memset(block, 0, nbytes);
+  return Py_BuildValue("(KK)", (uint64_t)block, (uint64_t)size);
+}
+
+// Give a block back to the pool of the queue the kernels using it were
+// submitted to. The blocks of an out-of-order queue are given back once its
+// kernels complete.
+static PyObject *scratchFree(PyObject *self, PyObject *args) {
+  uint64_t block, size;
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "KKO", &block, &size, &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+  if (!sycl_queue->is_in_order()) {
+    Py_BEGIN_ALLOW_THREADS
+    sycl_queue->wait();
+    Py_END_ALLOW_THREADS
+  }
+  ScratchPool &pool = scratch_pools[*sycl_queue];
+  pool.free_blocks[size].push_back(reinterpret_cast<void *>(block));
+  pool.cached_bytes += size;
+  pool.used_bytes -= size;
+  Py_RETURN_NONE;
+}
+
+static PyObject *scratchEmptyCache(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "O", &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+  emptyScratchCache(*sycl_queue, scratch_pools[*sycl_queue]);
+  Py_RETURN_NONE;
+}
+
+// The bytes of the blocks of a queue in use and cached by the pool.
+static PyObject *scratchStats(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "O", &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+  ScratchPool &pool = scratch_pools[*sycl_queue];
+  return Py_BuildValue("{s:K,s:K}", "used_bytes", (uint64_t)pool.used_bytes,
+                       "cached_bytes", (uint64_t)pool.cached_bytes);
+}
+
+// Inter-process memory: a device allocation is exported as a Level Zero IPC
+// handle, which the other processes of the node open to map the allocation
+// in their own context, e.g. to read the buffers of the peer devices over Xe
+// Link from a kernel. The handle holds a file descriptor of the exporting
+// process, which the opening process duplicates with pidfd_getfd (Linux 5.6).
+
+static ze_context_handle_t getZeContext(sycl::queue &queue) {
+  return sycl::get_native<sycl::backend::ext_oneapi_level_zero>(
+      queue.get_context());
+}
+
+// Return the IPC handle of the allocation holding `ptr`, the offset of `ptr`
+// in it, its size and the pid of the process.
+static PyObject *ipcGetHandle(PyObject *self, PyObject *args) {
+  uint64_t ptr;
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "KO", &ptr, &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+  ze_context_handle_t ctx = getZeContext(*sycl_queue);
+  void *base = nullptr;
+  size_t size = 0;
+  ZE_CHECK(zeMemGetAddressRange(ctx, reinterpret_cast<void *>(ptr), &base,
+                                &size));
+  ze_ipc_mem_handle_t handle;
+  ZE_CHECK(zeMemGetIpcHandle(ctx, base, &handle));
+  return Py_BuildValue("(y#KKi)", handle.data,
+                       (Py_ssize_t)ZE_MAX_IPC_HANDLE_SIZE,
+                       ptr - (uint64_t)base, (uint64_t)size, (int)getpid());
+}
+
+// Map the allocation of an IPC handle exported by the process `pid` in the
+// context of a queue, and return its base address.
+static PyObject *ipcOpenHandle(PyObject *self, PyObject *args) {
+  const char *data;
+  Py_ssize_t len;
+  int pid;
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "y#iO", &data, &len, &pid, &cap))
+    return NULL;
+  if (len != ZE_MAX_IPC_HANDLE_SIZE) {
+    PyErr_SetString(PyExc_ValueError, "invalid IPC handle size");
+    return NULL;
+  }
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+  ze_ipc_mem_handle_t handle;
+  memcpy(handle.data, data, len);
+  int fd = -1;
+  if (pid != getpid()) {
+#ifdef SYS_pidfd_getfd
+    int remote_fd;
+    memcpy(&remote_fd, handle.data, sizeof(remote_fd));
+    int pidfd = syscall(SYS_pidfd_open, pid, 0);
+    if (pidfd >= 0) {
+      fd = syscall(SYS_pidfd_getfd, pidfd, remote_fd, 0);
+      close(pidfd);
+    }
+    if (fd < 0) {
+      PyErr_SetFromErrno(PyExc_OSError);
+      return NULL;
+    }
+    memcpy(handle.data, &fd, sizeof(fd));
+#else
+    PyErr_SetString(PyExc_NotImplementedError,
+                    "opening the IPC handles of other processes requires "
+                    "pidfd_getfd");
+    return NULL;
+#endif
+  }
+  ze_device_handle_t device =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(
+          sycl_queue->get_device());
+  void *ptr = nullptr;
+  ze_result_t result =
+      zeMemOpenIpcHandle(getZeContext(*sycl_queue), device, handle, 0, &ptr);
+  // the driver keeps its own reference to the imported memory
+  if (fd >= 0)
+    close(fd);
+  ZE_CHECK(result);
+  return Py_BuildValue("K", (uint64_t)ptr);
+}
+
+// Unmap an allocation mapped by `ipcOpenHandle`.
+static PyObject *ipcCloseHandle(PyObject *self, PyObject *args) {
+  uint64_t ptr;
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "KO", &ptr, &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+  ZE_CHECK(zeMemCloseIpcHandle(getZeContext(*sycl_queue),
+                               reinterpret_cast<void *>(ptr)));
+  Py_RETURN_NONE;
+}
+
+// Whether the kernels on the device of a queue can access the memory of the
+// device of another one.
+static PyObject *canAccessPeer(PyObject *self, PyObject *args) {
+  PyObject *cap, *peer_cap;
+  if (!PyArg_ParseTuple(args, "OO", &cap, &peer_cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  sycl::queue *peer_queue = getSyclQueue(peer_cap);
+  if (!sycl_queue || !peer_queue)
+    return NULL;
+  ze_bool_t value = false;
+  ZE_CHECK(zeDeviceCanAccessPeer(
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(
+          sycl_queue->get_device()),
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(
+          peer_queue->get_device()),
+      &value));
+  return PyBool_FromLong(value);
+}
+
+// Hardware counters: a Level Zero metric streamer samples the counters of a
+// metric group, e.g. "ComputeBasic", while the kernels submitted between
+// `startMetrics` and `stopMetrics` run. The metrics are only exposed by the
+// driver when ZET_ENABLE_METRICS=1 is set before Level Zero is initialized.
+struct MetricsSession {
+  ze_context_handle_t context;
+  ze_device_handle_t device;
+  zet_metric_group_handle_t group;
+  zet_metric_streamer_handle_t streamer;
+};
+static std::optional<MetricsSession> metrics_session;
+
+static PyObject *startMetrics(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  const char *group_name;
+  unsigned int sampling_period_ns;
+  if (!PyArg_ParseTuple(args, "OsI", &cap, &group_name, &sampling_period_ns))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+  if (metrics_session) {
+    PyErr_SetString(PyExc_RuntimeError, "the metrics are already collected");
+    return NULL;
+  }
+  if (sycl_queue_map.find(*sycl_queue) == sycl_queue_map.end())
+    update(*sycl_queue);
+  ze_context_handle_t ctx = sycl_queue_map[*sycl_queue].context;
+  ze_device_handle_t device = sycl_queue_map[*sycl_queue].device;
+
+  // the time based metric group of the given name
+  uint32_t groupCount = 0;
+  ZE_CHECK(zetMetricGroupGet(device, &groupCount, nullptr));
+  std::vector<zet_metric_group_handle_t> groups(groupCount);
+  ZE_CHECK(zetMetricGroupGet(device, &groupCount, groups.data()));
+  zet_metric_group_handle_t group = nullptr;
+  for (auto candidate : groups) {
+    zet_metric_group_properties_t props = {};
+    props.stype = ZET_STRUCTURE_TYPE_METRIC_GROUP_PROPERTIES;
+    ZE_CHECK(zetMetricGroupGetProperties(candidate, &props));
+    if (std::string(props.name) == group_name &&
+        (props.samplingType &
+         ZET_METRIC_GROUP_SAMPLING_TYPE_FLAG_TIME_BASED)) {
+      group = candidate;
+      break;
+    }
+  }
+  if (!group) {
+    PyErr_Format(PyExc_ValueError, "unknown metric group: %s", group_name);
+    return NULL;
+  }
+
+  ZE_CHECK(zetContextActivateMetricGroups(ctx, device, 1, &group));
+  zet_metric_streamer_desc_t desc = {};
+  desc.stype = ZET_STRUCTURE_TYPE_METRIC_STREAMER_DESC;
+  desc.notifyEveryNReports = 32768;
+  desc.samplingPeriod = sampling_period_ns;
+  zet_metric_streamer_handle_t streamer;
+  ze_result_t result =
+      zetMetricStreamerOpen(ctx, device, group, &desc, nullptr, &streamer);
+  if (result != ZE_RESULT_SUCCESS) {
+    zetContextActivateMetricGroups(ctx, device, 0, nullptr);
+    ZE_CHECK(result);
+  }
+  metrics_session = MetricsSession{ctx, device, group, streamer};
+  Py_RETURN_NONE;
+}
+
+static double typedValueToDouble(const zet_typed_value_t &value) {
+  switch (value.type) {
+  case ZET_VALUE_TYPE_UINT32:
+    return value.value.ui32;
+  case ZET_VALUE_TYPE_UINT64:
+    return value.value.ui64;
+  case ZET_VALUE_TYPE_FLOAT32:
+    return value.value.fp32;
+  case ZET_VALUE_TYPE_FLOAT64:
+    return value.value.fp64;
+  case ZET_VALUE_TYPE_BOOL8:
+    return value.value.b8;
+  default:
+    return 0;
+  }
+}
+
+// Stop the collection of the metrics and return the mean over the samples of
+// each metric of the group, by name.
+static PyObject *stopMetrics(PyObject *self, PyObject *args) {
+  if (!metrics_session) {
+    PyErr_SetString(PyExc_RuntimeError, "the metrics are not collected");
+    return NULL;
+  }
+  MetricsSession session = *metrics_session;
+  metrics_session.reset();
+
+  size_t rawSize = 0;
+  std::vector<uint8_t> raw;
+  ze_result_t result = zetMetricStreamerReadData(session.streamer, UINT32_MAX,
+                                                 &rawSize, nullptr);
+  if (result == ZE_RESULT_SUCCESS) {
+    raw.resize(rawSize);
+    result = zetMetricStreamerReadData(session.streamer, UINT32_MAX, &rawSize,
+                                       raw.data());
+  }
+  zetMetricStreamerClose(session.streamer);
+  zetContextActivateMetricGroups(session.context, session.device, 0, nullptr);
+  ZE_CHECK(result);
+
+  uint32_t valueCount = 0;
+  std::vector<zet_typed_value_t> values;
+  if (rawSize) {
+    ZE_CHECK(zetMetricGroupCalculateMetricValues(
+        session.group, ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES,
+        rawSize, raw.data(), &valueCount, nullptr));
+    values.resize(valueCount);
+    ZE_CHECK(zetMetricGroupCalculateMetricValues(
+        session.group, ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES,
+        rawSize, raw.data(), &valueCount, values.data()));
+  }
+
+  uint32_t metricCount = 0;
+  ZE_CHECK(zetMetricGet(session.group, &metricCount, nullptr));
+  std::vector<zet_metric_handle_t> metrics(metricCount);
+  ZE_CHECK(zetMetricGet(session.group, &metricCount, metrics.data()));
+
+  // The values are the ones of each metric, for each sample in turn.
+  size_t numSamples = metricCount ? valueCount / metricCount : 0;
+  PyObject *py_metrics = PyDict_New();
+  if (!py_metrics)
+    return NULL;
+  for (uint32_t i = 0; i < metricCount; ++i) {
+    zet_metric_properties_t props = {};
+    props.stype = ZET_STRUCTURE_TYPE_METRIC_PROPERTIES;
+    ZE_CHECK(zetMetricGetProperties(metrics[i], &props));
+    double sum = 0;
+    for (size_t sample = 0; sample < numSamples; ++sample)
+      sum += typedValueToDouble(values[sample * metricCount + i]);
+    PyObject *py_value =
+        PyFloat_FromDouble(numSamples ? sum / numSamples : 0.);
+    if (!py_value || PyDict_SetItemString(py_metrics, props.name, py_value)) {
+      Py_XDECREF(py_value);
+      Py_DECREF(py_metrics);
+      return NULL;
+    }
+    Py_DECREF(py_value);
+  }
+  return py_metrics;
+}
+
+// Launch tracing: the launchers append a record of each of their launches to
+// a ring buffer, without taking the GIL nor a lock, that Python drains from
+// time to time. The launchers get the addresses of `trace_enabled` and
+// `traceLaunch` once, see `getTraceHooks`.
+struct TraceRecord {
+  // The position in the buffer of the record the slot holds once written, or
+  // of the next record that can be written to it.
+  std::atomic<uint64_t> seq;
+  const void *kernel;
+  uint32_t grid[3];
+  uint64_t submit_ns;
+  // a copy of the event of the launch, none for the launches through Level
+  // Zero
+  std::optional<sycl::event> event;
+};
+
+struct TraceBuffer {
+  explicit TraceBuffer(size_t capacity)
+      : records(capacity), mask(capacity - 1) {
+    for (size_t i = 0; i < capacity; ++i)
+      records[i].seq.store(i, std::memory_order_relaxed);
+  }
+  std::vector<TraceRecord> records;
+  size_t mask;
+  std::atomic<uint64_t> head{0};
+  // only read and written by `drainTrace`, under the GIL
+  uint64_t tail = 0;
+  std::atomic<uint64_t> dropped{0};
+};
+
+static std::atomic<bool> trace_enabled{false};
+// Never released, the launchers may be writing to it.
+static std::atomic<TraceBuffer *> trace_buffer{nullptr};
+
+// Append a record of a launch to the trace buffer, or drop it if the buffer is
+// full. Called by the launchers, possibly from several threads at once.
+static void traceLaunch(const void *kernel, uint32_t gridX, uint32_t gridY,
+                        uint32_t gridZ, const sycl::event *event) {
+  TraceBuffer *buffer = trace_buffer.load(std::memory_order_acquire);
+  if (!buffer)
+    return;
+  uint64_t pos = buffer->head.load(std::memory_order_relaxed);
+  TraceRecord *record;
+  for (;;) {
+    record = &buffer->records[pos & buffer->mask];
+    uint64_t seq = record->seq.load(std::memory_order_acquire);
+    if (seq == pos) {
+      if (buffer->head.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed))
+        break;
+    } else if (seq < pos) {
+      // the slot still holds a record that has not been drained
+      buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      pos = buffer->head.load(std::memory_order_relaxed);
+    }
+  }
+  record->kernel = kernel;
+  record->grid[0] = gridX;
+  record->grid[1] = gridY;
+  record->grid[2] = gridZ;
+  record->submit_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now().time_since_epoch())
+                          .count();
+  if (event)
+    record->event.emplace(*event);
+  record->seq.store(pos + 1, std::memory_order_release);
+}
+
+// Start recording the launches into a buffer of `capacity` records, rounded
+// up to a power of 2. The buffer is allocated by the first start only.
+static PyObject *startTrace(PyObject *self, PyObject *args) {
+  unsigned long long capacity;
+  if (!PyArg_ParseTuple(args, "K", &capacity))
+    return NULL;
+  if (!trace_buffer.load(std::memory_order_acquire)) {
+    size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+    trace_buffer.store(new TraceBuffer(size), std::memory_order_release);
+  }
+  trace_enabled.store(true, std::memory_order_relaxed);
+  Py_RETURN_NONE;
+}
+
+static PyObject *stopTrace(PyObject *self, PyObject *args) {
+  trace_enabled.store(false, std::memory_order_relaxed);
+  Py_RETURN_NONE;
+}
+
+static PyObject *getTraceHooks(PyObject *self, PyObject *args) {
+  return Py_BuildValue("KK", (uint64_t)&trace_enabled, (uint64_t)&traceLaunch);
+}
+
+// Return the records of the launches in the order of their submission, as
+// (name, grid, submit_ns, start_ns, end_ns) tuples, and the number of launches
+// dropped since the last drain. The records stop at the first kernel that has
+// not completed yet, the next drain returns it. The device times are None when
+// the events of the kernels are not known or have no profiling information.
+static PyObject *drainTrace(PyObject *self, PyObject *args) {
+  PyObject *py_records = PyList_New(0);
+  if (!py_records)
+    return NULL;
+  TraceBuffer *buffer = trace_buffer.load(std::memory_order_acquire);
+  if (!buffer)
+    return Py_BuildValue("NK", py_records, 0ULL);
+
+  // The kernels are only known by their address, the name of the ones
+  // unloaded since their launch is empty.
+  std::unordered_map<const void *, const std::string *> names;
+  for (const auto &entry : compiled_kernels)
+    names[&entry.second->kernel] = &std::get<1>(entry.first);
+
+  for (;;) {
+    TraceRecord &record = buffer->records[buffer->tail & buffer->mask];
+    if (record.seq.load(std::memory_order_acquire) != buffer->tail + 1)
+      break;
+    PyObject *py_start = Py_None, *py_end = Py_None;
+    if (record.event) {
+      auto status = record.event->get_info<
+          sycl::info::event::command_execution_status>();
+      if (status != sycl::info::event_command_status::complete)
+        break;
+      try {
+        uint64_t start_ns = record.event->get_profiling_info<
+            sycl::info::event_profiling::command_start>();
+        uint64_t end_ns = record.event->get_profiling_info<
+            sycl::info::event_profiling::command_end>();
+        py_start = PyLong_FromUnsignedLongLong(start_ns);
+        py_end = PyLong_FromUnsignedLongLong(end_ns);
+      } catch (const sycl::exception &) {
+        // the queue has not been created with profiling enabled
+      }
+      record.event.reset();
+    }
+    if (py_start == Py_None)
+      Py_INCREF(py_start);
+    if (py_end == Py_None)
+      Py_INCREF(py_end);
+    auto name = names.find(record.kernel);
+    PyObject *py_record = Py_BuildValue(
+        "(s(III)KNN)", name != names.end() ? name->second->c_str() : "",
+        record.grid[0], record.grid[1], record.grid[2], record.submit_ns,
+        py_start, py_end);
+    // The slot is free for the record `capacity` positions further.
+    record.seq.store(buffer->tail + buffer->mask + 1,
+                     std::memory_order_release);
+    ++buffer->tail;
+    if (!py_record || PyList_Append(py_records, py_record) < 0) {
+      Py_XDECREF(py_record);
+      Py_DECREF(py_records);
+      return NULL;
+    }
+    Py_DECREF(py_record);
+  }
+  uint64_t dropped = buffer->dropped.exchange(0, std::memory_order_relaxed);
+  return Py_BuildValue("NK", py_records, dropped);
+}
+
 static PyMethodDef ModuleMethods[] = {
     {"load_binary", loadSyclBinary, METH_VARARGS,
-     "Load provided SPV into ZE driver"},
+     "Load provided SPV or native binary into ZE driver"},
     {"load_sycl_binary", loadSyclBinary, METH_VARARGS,
      "Load provided SPV into ZE driver"},
+    {"unload_binary", unloadSyclBinary, METH_VARARGS,
+     "Release a kernel returned by load_binary"},
     {"get_device_properties", getDeviceProperties, METH_VARARGS,
      "Get the properties for a given device"},
+    {"get_device_frequencies", getDeviceFrequencies, METH_VARARGS,
+     "Get the current frequencies of a given device"},
     {"init_context", initContext, METH_VARARGS,
      "Initialize the ZE GPU context"},
     {"init_devices", initDevices, METH_VARARGS,
@@ -426,6 +1489,51 @@ static PyMethodDef ModuleMethods[] = {
     {"get_l0_queue", getL0Queue, METH_VARARGS, "Get l0 queue from sycl queue"},
     {"get_l0_ctxt_ptr", getL0CtxtPtr, METH_VARARGS,
      "Extract l0 context pointer from sycl queue"},
+    {"begin_graph_capture", beginGraphCapture, METH_VARARGS,
+     "Start recording the work submitted to a sycl queue"},
+    {"end_graph_capture", endGraphCapture, METH_VARARGS,
+     "Stop recording and return the executable graph"},
+    {"replay_graph", replayGraph, METH_VARARGS,
+     "Submit an executable graph to a sycl queue"},
+    {"destroy_graph", destroyGraph, METH_VARARGS,
+     "Release an executable graph"},
+    {"synchronize_event", synchronizeEvent, METH_VARARGS,
+     "Block until the kernel of an event completes"},
+    {"wait_event", waitEvent, METH_VARARGS,
+     "Make a sycl queue wait for the kernel of an event"},
+    {"query_event", queryEvent, METH_VARARGS,
+     "Return whether the kernel of an event has completed"},
+    {"event_elapsed_time", eventElapsedTime, METH_VARARGS,
+     "Return the time in ms between the kernels of two events"},
+    {"destroy_event", destroyEvent, METH_VARARGS, "Release an event"},
+    {"scratch_alloc", scratchAlloc, METH_VARARGS,
+     "Allocate a block of the scratch pool of a sycl queue"},
+    {"scratch_free", scratchFree, METH_VARARGS,
+     "Give a block back to the scratch pool of a sycl queue"},
+    {"scratch_empty_cache", scratchEmptyCache, METH_VARARGS,
+     "Free the cached blocks of the scratch pool of a sycl queue"},
+    {"scratch_stats", scratchStats, METH_VARARGS,
+     "Return the bytes used and cached by the scratch pool of a sycl queue"},
+    {"ipc_get_handle", ipcGetHandle, METH_VARARGS,
+     "Return the IPC handle of the device allocation holding an address"},
+    {"ipc_open_handle", ipcOpenHandle, METH_VARARGS,
+     "Map the device allocation of an IPC handle of a process"},
+    {"ipc_close_handle", ipcCloseHandle, METH_VARARGS,
+     "Unmap a device allocation mapped by ipc_open_handle"},
+    {"can_access_peer", canAccessPeer, METH_VARARGS,
+     "Return whether a device can access the memory of a peer device"},
+    {"start_metrics", startMetrics, METH_VARARGS,
+     "Start sampling the hardware counters of a metric group"},
+    {"stop_metrics", stopMetrics, METH_NOARGS,
+     "Stop sampling the hardware counters and return their mean values"},
+    {"start_trace", startTrace, METH_VARARGS,
+     "Start recording the launches of the kernels"},
+    {"stop_trace", stopTrace, METH_NOARGS,
+     "Stop recording the launches of the kernels"},
+    {"get_trace_hooks", getTraceHooks, METH_NOARGS,
+     "Return the addresses of the tracing state and function of the launchers"},
+    {"drain_trace", drainTrace, METH_NOARGS,
+     "Return and remove the records of the completed launches"},
     {NULL, NULL, 0, NULL} // sentinel
 };
 
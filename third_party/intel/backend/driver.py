@@ -1,9 +1,21 @@
+import atexit
 import os
+import functools
 import hashlib
+import importlib
+import json
+import struct
+import sys
 import tempfile
+import threading
+import weakref
+from collections import namedtuple
+from contextlib import contextmanager
 from pathlib import Path
+from types import MappingProxyType
 from triton.runtime.build import _build
-from triton.runtime.cache import get_cache_manager
+from triton.runtime.cache import get_cache_manager, make_binary_cache_key, read_cache_file
+from triton.tools.tensor_descriptor import TensorDescriptor
 from triton.backends.driver import DriverBase
 
 
@@ -16,6 +28,18 @@ library_dir = [os.path.join(dirname, "lib")]
 libraries = ['ze_loader']
 
 
+def _spec_constant_bits(ty, value):
+    # The bits of the value of a specialization constant of type `ty`, which
+    # the driver reads from the first bytes of the 64 bits, little-endian.
+    if ty == "fp32":
+        return struct.unpack("<I", struct.pack("<f", value))[0]
+    if ty == "fp64":
+        return struct.unpack("<Q", struct.pack("<d", value))[0]
+    if not ty.startswith("i") or isinstance(value, float):
+        raise TypeError(f"invalid value {value} of a specialization constant of type {ty}")
+    return int(value) & ((1 << int(ty[1:])) - 1)
+
+
 def compile_module_from_src(src, name):
     key = hashlib.md5(src.encode("utf-8")).hexdigest()
     cache = get_cache_manager(key)
@@ -35,10 +59,30 @@ def compile_module_from_src(src, name):
     return mod
 
 
+def load_prebuilt_module(name):
+    """
+    Return the module `name` built with the package by the SYCL compiler, see
+    `third_party/intel/CMakeLists.txt`, or None if it hasn't been built, in
+    which case it is compiled on first use. `TRITON_XPU_JIT_DRIVER=1` ignores
+    the prebuilt modules, e.g. to test changes to their sources.
+    """
+    if os.environ.get("TRITON_XPU_JIT_DRIVER", "0") == "1":
+        return None
+    try:
+        return importlib.import_module(f"triton._C.{name}")
+    except ImportError:
+        return None
+
+
 # ------------------------
 # Utils
 # ------------------------
 
+# The binaries loaded instead of those of the compiled kernels, by kernel hash
+# and PCI device id, None for all the devices, see `XPUUtils.override_binary`.
+_binary_overrides = {}
+
+
 
 class XPUUtils(object):
 
@@ -48,26 +92,99 @@ class XPUUtils(object):
         return cls.instance
 
     def __init__(self):
-        dirname = os.path.dirname(os.path.realpath(__file__))
-        mod = compile_module_from_src(Path(os.path.join(dirname, "driver.c")).read_text(), "spirv_utils")
-        self.load_binary = mod.load_binary
+        mod = load_prebuilt_module("spirv_utils")
+        if mod is None:
+            dirname = os.path.dirname(os.path.realpath(__file__))
+            mod = compile_module_from_src(Path(os.path.join(dirname, "driver.c")).read_text(), "spirv_utils")
+        self._load_binary = mod.load_binary
         self.load_sycl_binary = mod.load_sycl_binary
-        self.get_device_properties = mod.get_device_properties
+        self.unload_binary = mod.unload_binary
+        self.begin_graph_capture = mod.begin_graph_capture
+        self.end_graph_capture = mod.end_graph_capture
+        self.replay_graph = mod.replay_graph
+        self.destroy_graph = mod.destroy_graph
+        self.synchronize_event = mod.synchronize_event
+        self.wait_event = mod.wait_event
+        self.query_event = mod.query_event
+        self.event_elapsed_time = mod.event_elapsed_time
+        self.destroy_event = mod.destroy_event
+        self.start_metrics = mod.start_metrics
+        self.stop_metrics = mod.stop_metrics
+        self.start_trace = mod.start_trace
+        self.stop_trace = mod.stop_trace
+        self.get_trace_hooks = mod.get_trace_hooks
+        self.drain_trace = mod.drain_trace
+        self.scratch_alloc = mod.scratch_alloc
+        self.scratch_free = mod.scratch_free
+        self.scratch_empty_cache = mod.scratch_empty_cache
+        self.scratch_stats = mod.scratch_stats
+        self.ipc_get_handle = mod.ipc_get_handle
+        self.ipc_open_handle = mod.ipc_open_handle
+        self.ipc_close_handle = mod.ipc_close_handle
+        self._can_access_peer = mod.can_access_peer
+        self._get_device_properties = mod.get_device_properties
+        # the properties of the devices, queried once, kept when the instance
+        # is initialized again
+        self.device_properties = getattr(self, "device_properties", {})
+        self.get_device_frequencies = mod.get_device_frequencies
         self.get_l0_queue = mod.get_l0_queue
         self.get_l0_ctxt_ptr = mod.get_l0_ctxt_ptr
         self.context = mod.init_context(self.get_sycl_queue())
         self.device_count = mod.init_devices(self.get_sycl_queue())
-        self.current_device = 0 if self.device_count[0] > 0 else -1
+
+    def get_device_properties(self, device):
+        """
+        The properties of a device, e.g. its shared memory, Xe cores (the
+        `multiprocessor_count`), EUs and threads per EU, bytes of a general
+        register (`grf_size`), L3 size, DPAS support and sub-group sizes. They
+        are queried on the first call and returned as a read-only mapping.
+        """
+        props = self.device_properties.get(device)
+        if props is None:
+            props = self._get_device_properties(device)
+            props["sub_group_sizes"] = tuple(props["sub_group_sizes"])
+            props["extensions"] = frozenset(props["extensions"])
+            props = self.device_properties[device] = MappingProxyType(props)
+        return props
+
+    def get_occupancy(self, device, num_warps, shared=0, n_regs=128):
+        """
+        The work-groups of `num_warps` sub-groups, each using `shared` bytes of
+        shared local memory and `n_regs` registers per thread, resident on each
+        Xe-core of `device`, e.g. for the autotuner to prefer the configs that
+        fill the device, or to size the grid of the persistent kernels. Each
+        sub-group runs on a hardware thread of an EU, and the threads per EU
+        are halved with 256 registers per thread. The shared local memory of an
+        Xe-core is the largest one of a work-group. Returns the work-groups per
+        Xe-core, resident on the device, the fraction of the hardware threads
+        they use, and the resource limiting them, "threads" or "shared".
+        """
+        props = self.get_device_properties(device)
+        num_xe_cores = max(1, props["multiprocessor_count"])
+        threads_per_eu = props["threads_per_eu"] // (2 if n_regs > 128 else 1)
+        threads_per_xe_core = props["num_eus"] // num_xe_cores * threads_per_eu
+        work_groups, limited_by = threads_per_xe_core // num_warps, "threads"
+        if shared > 0 and props["max_shared_mem"] // shared < work_groups:
+            work_groups, limited_by = props["max_shared_mem"] // shared, "shared"
+        return {
+            "work_groups_per_xe_core": work_groups,
+            "resident_work_groups": work_groups * num_xe_cores,
+            "occupancy": work_groups * num_warps / threads_per_xe_core if threads_per_xe_core else 0.0,
+            "limited_by": limited_by,
+        }
 
     def get_current_device(self):
-        return self.current_device
+        # follow the device selected by `torch.xpu.set_device`, so that the
+        # kernels are compiled, loaded and launched for it
+        import torch
+        return torch.xpu.current_device() if self.device_count[0] > 0 else -1
 
     def get_event_pool(self):
         return self.event_pool
 
-    def get_sycl_queue(self):
+    def get_sycl_queue(self, device=None):
         import torch
-        return torch.xpu.current_stream().sycl_queue
+        return torch.xpu.current_stream(device).sycl_queue
 
     def get_sycl_device(self, device_id):
         import torch
@@ -76,6 +193,384 @@ class XPUUtils(object):
     def use_icl(self):
         return self.get_l0_queue(self.get_sycl_queue())[0] == 0
 
+    def graph(self):
+        return XPUGraph(self)
+
+    def collect_metrics(self, fn, group="ComputeBasic", sampling_period_ns=10000):
+        """
+        Call `fn` and return the mean values, by name, of the hardware counters
+        of the metric `group` while the kernels it submits to the current queue
+        run, e.g. the XMX utilization, the L3 hit rate or the stall reasons of
+        the EUs.
+
+        The driver only exposes the counters when ZET_ENABLE_METRICS=1 is set
+        before the first use of the device.
+        """
+        import torch
+        self.start_metrics(self.get_sycl_queue(), group, sampling_period_ns)
+        try:
+            fn()
+            torch.xpu.synchronize()
+        finally:
+            metrics = self.stop_metrics()
+        return metrics
+
+    def tracer(self, capacity=1 << 16, interval=0.1):
+        return XPUTracer(self, capacity, interval)
+
+    def scratch(self, nbytes, dtype=None, zero=False, device=None):
+        """
+        A block of at least `nbytes` of the scratch pool of the current queue,
+        passed to the kernels like a tensor of `dtype`, uint8 by default, e.g.
+        as the workspace of a split-K reduction, filled with zeros with `zero`.
+        The block goes back to the pool when released, as soon as the kernels
+        using it are launched: the next kernels of the queue run after them.
+        """
+        return XPUScratch(self, self.get_sycl_queue(device), nbytes, dtype, zero)
+
+    def empty_scratch_cache(self, device=None):
+        """Free the blocks cached by the scratch pool of the current queue, once its kernels complete."""
+        self.scratch_empty_cache(self.get_sycl_queue(device))
+
+    def ipc_handle(self, tensor):
+        """
+        The IPC handle of the memory of `tensor`, picklable, e.g. to send it
+        to the other processes of the node, which open it with
+        `open_ipc_handle`. The memory must stay allocated while they use it.
+        """
+        queue = self.get_sycl_queue(tensor.device)
+        data, offset, _, pid = self.ipc_get_handle(tensor.data_ptr(), queue)
+        return XPUIpcHandle(data, offset, pid, tensor.dtype, tuple(tensor.shape), tuple(tensor.stride()))
+
+    def open_ipc_handle(self, handle, device=None):
+        """
+        The memory of an `XPUIpcHandle` of another process, mapped for the
+        kernels of the current queue, passed to them like a tensor, e.g. to
+        read the buffer of a peer device. The handles of this process are
+        opened as well, but their memory is mapped again.
+        """
+        return XPUPeerBuffer(self, self.get_sycl_queue(device), handle)
+
+    def can_access_peer(self, device, peer):
+        """Whether the kernels on `device` can access the memory of `peer`, e.g. over Xe Link."""
+        return self._can_access_peer(self.get_sycl_queue(device), self.get_sycl_queue(peer))
+
+    def load_binary(self, name, kernel, shared, device, cache_key=None, build_flags="", spec_constants=None):
+        """
+        Load the SPIR-V `kernel` on the device with index `device`.
+
+        Return the module and function handles, the register file size, the
+        spill size and a dict of the Level Zero properties of the kernel.
+
+        Loads of the same binary on the same device share one kernel, which is
+        released once each of its loads has been passed to `unload_binary`. The
+        kernel is created in the context of the current queue of the device.
+
+        When `cache_key` is given, the native binary the driver finalizes the
+        SPIR-V to is stored in the cache, next to the `.spv` the compiler
+        stores once for all the kernels with the same binary, and is loaded
+        instead of the SPIR-V by later runs on the same device and driver
+        version with the same `build_flags`.
+
+        `build_flags` are passed to the driver when it builds the SPIR-V. The
+        kernels are identified by their binary and build flags, so that the
+        specializations of a kernel compiled to the same binary, e.g. on
+        constexprs that don't change its code, share one kernel.
+
+        `spec_constants` maps the ids of the SPIR-V specialization constants
+        set when the module is built to their (type, value), e.g.
+        {0: ("fp32", 1e-6)}. The loads with different values share the SPIR-V
+        and get their own native binary.
+        """
+        sycl_device = self.get_sycl_device(device)
+        queue = self.get_sycl_queue(device)
+        module_hash = hashlib.md5(kernel + build_flags.encode("utf-8")).hexdigest()
+        constants = None
+        spec_suffix = ""
+        if spec_constants:
+            constants = {id: _spec_constant_bits(ty, value) for id, (ty, value) in spec_constants.items()}
+            spec_suffix = f"-spec-{hashlib.md5(repr(sorted(constants.items())).encode('utf-8')).hexdigest()[:8]}"
+            module_hash += spec_suffix
+        if cache_key is None:
+            return self._load_binary(name, kernel, shared, sycl_device, module_hash, False, build_flags, queue,
+                                     constants)[:5]
+
+        props = self.get_device_properties(device)
+        override = self.get_binary_override(name, cache_key, props["device_id"])
+        if override is not None:
+            binary, native = override
+            module_hash = f"{cache_key}-override-{hashlib.md5(binary).hexdigest()}{spec_suffix}"
+            return self._load_binary(name, binary, shared, sycl_device, module_hash, native, build_flags, queue,
+                                     constants)[:5]
+        cache = get_cache_manager(make_binary_cache_key(kernel))
+        flags_suffix = f"-{hashlib.md5(build_flags.encode('utf-8')).hexdigest()[:8]}" if build_flags else ""
+        native_name = f"{name}-{props['device_id']:x}-{props['driver_version']}{flags_suffix}{spec_suffix}.zebin"
+        native_path = cache.get_file(native_name)
+        if native_path is not None:
+            try:
+                return self._load_binary(name, read_cache_file(native_path), shared, sycl_device, module_hash, True,
+                                         build_flags, queue)[:5]
+            except RuntimeError:
+                # A stale or corrupted native binary; rebuild it from the SPIR-V.
+                pass
+
+        module, function, n_regs, n_spills, kernel_props, native = self._load_binary(
+            name, kernel, shared, sycl_device, module_hash, False, build_flags, queue, constants)
+        if native is not None:
+            cache.put(native, native_name, binary=True)
+        return module, function, n_regs, n_spills, kernel_props
+
+    def override_binary(self, cache_key, binary, native=False, device_id=None):
+        """
+        Load `binary`, a SPIR-V module or with `native` a zebin, instead of the
+        binary of the kernel whose `metadata.hash` is `cache_key`, e.g. to
+        deploy a hand-tuned kernel without recompiling it or rebuilding the
+        package. The kernels already loaded keep their binary, the override
+        applies from the next loads of the kernel on.
+
+        With `device_id`, the PCI device id of the devices the override is
+        built for, it only applies to them, otherwise to all the devices. A
+        None `binary` removes the override.
+        """
+        key = (cache_key, device_id)
+        if binary is None:
+            _binary_overrides.pop(key, None)
+        else:
+            _binary_overrides[key] = (bytes(binary), native)
+
+    def get_binary_override(self, name, cache_key, device_id):
+        """
+        The (binary, native) loaded instead of the kernel `name` whose
+        `metadata.hash` is `cache_key` on the devices with PCI device id
+        `device_id`, None if it isn't overridden.
+
+        The overrides of `override_binary` come first, then the files of the
+        `TRITON_BINARY_OVERRIDE_DIR/<cache_key>` directory, looked up on each
+        load so that new files are picked up without restarting:
+        `<name>-<device_id:x>.zebin` for that device, `<name>.zebin` and
+        `<name>.spv` for all of them.
+        """
+        for key in [(cache_key, device_id), (cache_key, None)]:
+            override = _binary_overrides.get(key)
+            if override is not None:
+                return override
+        override_dir = os.environ.get("TRITON_BINARY_OVERRIDE_DIR")
+        if not override_dir:
+            return None
+        path = Path(override_dir) / cache_key
+        for file, native in [(f"{name}-{device_id:x}.zebin", True), (f"{name}.zebin", True), (f"{name}.spv", False)]:
+            if (path / file).is_file():
+                return (path / file).read_bytes(), native
+        return None
+
+    def get_native_binary(self, name, kernel, shared, device, build_flags=""):
+        """
+        Return the native binary the SPIR-V `kernel` is finalized to for the
+        device with index `device`, e.g. to embed it into ahead-of-time
+        compiled kernels.
+        """
+        module_hash = f"{hashlib.md5(kernel + build_flags.encode('utf-8')).hexdigest()}-native"
+        _, function, _, _, _, native = self._load_binary(name, kernel, shared, self.get_sycl_device(device),
+                                                         module_hash, False, build_flags)
+        self.unload_binary(function)
+        return native
+
+class XPUGraph(object):
+    """
+    Records the kernels launched on the current queue and replays them with a
+    single submission.
+
+    Capturing again updates the recorded kernels with their new arguments, e.g.
+    new pointers, as long as the same kernels are launched in the same order.
+    """
+
+    def __init__(self, utils):
+        self.utils = utils
+        self.queue = None
+        self.graph = 0
+
+    @contextmanager
+    def capture(self):
+        self.queue = self.utils.get_sycl_queue()
+        recording = self.utils.begin_graph_capture(self.queue)
+        try:
+            yield self
+        finally:
+            self.graph = self.utils.end_graph_capture(recording, self.queue, self.graph)
+
+    def replay(self):
+        assert self.graph, "nothing has been captured"
+        self.utils.replay_graph(self.graph, self.queue)
+
+    def __del__(self):
+        if self.graph:
+            self.utils.destroy_graph(self.graph)
+
+
+class XPUScratch(object):
+    """
+    A block of device memory of the scratch pool of a queue, see
+    `XPUUtils.scratch`, released on `release`, at the end of a `with` block or
+    when collected:
+
+        with utils.scratch(num_tiles * 4, dtype=torch.int32, zero=True) as counters:
+            kernel[grid](a, b, c, counters)
+    """
+
+    def __init__(self, utils, queue, nbytes, dtype=None, zero=False):
+        if dtype is None:
+            import torch
+            dtype = torch.uint8
+        self.utils = utils
+        self.queue = queue
+        self.nbytes = nbytes
+        self.dtype = dtype
+        self.ptr, self.block_size = utils.scratch_alloc(nbytes, queue, zero)
+
+    def data_ptr(self):
+        return self.ptr
+
+    def release(self):
+        if self.ptr:
+            self.utils.scratch_free(self.ptr, self.block_size, self.queue)
+            self.ptr = 0
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.release()
+
+    def __del__(self):
+        self.release()
+
+
+# The IPC handle of a tensor, see `XPUUtils.ipc_handle`: the handle of its
+# allocation, its offset in the allocation and the pid of its process.
+XPUIpcHandle = namedtuple("XPUIpcHandle", ["handle", "offset", "pid", "dtype", "shape", "strides"])
+
+
+class XPUPeerBuffer(object):
+    """
+    The memory of the tensor of an IPC handle of another process, see
+    `XPUUtils.open_ipc_handle`, passed to the kernels like the tensor and
+    unmapped on `close` or when collected. The other process must not free the
+    tensor before.
+    """
+
+    def __init__(self, utils, queue, handle):
+        self.utils = utils
+        self.queue = queue
+        self.dtype = handle.dtype
+        self.shape = handle.shape
+        self.strides = handle.strides
+        self.base = utils.ipc_open_handle(handle.handle, handle.pid, queue)
+        self.ptr = self.base + handle.offset
+
+    def data_ptr(self):
+        return self.ptr
+
+    def stride(self, dim=None):
+        return self.strides if dim is None else self.strides[dim]
+
+    def close(self):
+        if self.base:
+            self.utils.ipc_close_handle(self.base, self.queue)
+            self.base = self.ptr = 0
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+
+class XPUTracer(object):
+    """
+    Traces the launches of the kernels from the launchers themselves: each
+    launch appends its kernel, grid, submission time and event to a ring buffer
+    of the driver, drained by a background thread every `interval` seconds.
+    The launches are dropped, and counted in `dropped`, while the buffer of
+    `capacity` records is full.
+
+    The submission times are on the clock of `time.monotonic_ns`. The device
+    times, only known for the kernels submitted to SYCL on a queue created with
+    profiling enabled, are on the clock of the device.
+
+    The buffer is shared by all the tracers, only one may be started at a time.
+    """
+
+    def __init__(self, utils, capacity=1 << 16, interval=0.1):
+        self.utils = utils
+        self.capacity = capacity
+        self.interval = interval
+        # the (name, grid, submit_ns, start_ns, end_ns) of the launches
+        self.records = []
+        self.dropped = 0
+        self._lock = threading.Lock()
+        self._stop = None
+        self._thread = None
+
+    def start(self):
+        self.utils.start_trace(self.capacity)
+        self._stop = threading.Event()
+        self._thread = threading.Thread(target=self._drain_periodically, daemon=True)
+        self._thread.start()
+
+    def stop(self):
+        """
+        Stop tracing and drain the records of the completed kernels, all of
+        them once the device has been synchronized.
+        """
+        self.utils.stop_trace()
+        self._stop.set()
+        self._thread.join()
+        self.drain()
+
+    @contextmanager
+    def trace(self):
+        self.start()
+        try:
+            yield self
+        finally:
+            self.stop()
+
+    def drain(self):
+        records, dropped = self.utils.drain_trace()
+        with self._lock:
+            self.records.extend(records)
+            self.dropped += dropped
+
+    def _drain_periodically(self):
+        while not self._stop.wait(self.interval):
+            self.drain()
+
+    def export_chrome_trace(self, path):
+        """
+        Write the records in the Chrome trace event format, that Perfetto
+        reads as well: the submissions are instants on the host, the kernels
+        with device times slices on the device.
+        """
+        events = [
+            {"name": "process_name", "ph": "M", "pid": 0, "args": {"name": "host"}},
+            {"name": "process_name", "ph": "M", "pid": 1, "args": {"name": "xpu"}},
+        ]
+        with self._lock:
+            records = list(self.records)
+        for name, grid, submit_ns, start_ns, end_ns in records:
+            args = {"grid": list(grid)}
+            events.append({"name": name, "ph": "i", "s": "t", "ts": submit_ns / 1e3, "pid": 0, "tid": 0, "args": args})
+            if start_ns is not None:
+                duration = (end_ns - start_ns) / 1e3
+                events.append({"name": name, "ph": "X", "ts": start_ns / 1e3, "dur": duration, "pid": 1, "tid": 0,
+                               "args": args})
+        with open(path, "w") as f:
+            json.dump({"traceEvents": events}, f)
+
+
 # ------------------------
 # Launcher
 # ------------------------
@@ -109,11 +604,55 @@ def generate_cu_signature(constants, signature, ids):
     return signature, num_regular_signatures
 
 
-def make_launcher(constants, signature, ids):
+def expand_descriptors(signature, constants):
+    """
+    The signature and the constants of the arguments of the kernels, the
+    `tensordesc<...>` of the tensor descriptors being expanded into the base
+    pointer, the rows, the columns and the pitch the kernels get for them, and
+    the arguments after them renumbered.
+    """
+    if not any(ty.startswith("tensordesc<") for ty in signature.values()):
+        return signature, constants
+    expanded_signature, expanded_constants, index = {}, {}, 0
+    for i in sorted({*signature, *constants}):
+        if i in constants:
+            expanded_constants[index] = constants[i]
+        ty = signature.get(i)
+        if ty is not None and ty.startswith("tensordesc<"):
+            elem_ty = ty[len("tensordesc<"):ty.index("[")]
+            for ty in [f"*{elem_ty}", "i64", "i64", "i64"]:
+                expanded_signature[index] = ty
+                index += 1
+            continue
+        if ty is not None:
+            expanded_signature[index] = ty
+        index += 1
+    return expanded_signature, expanded_constants
+
+
+@functools.lru_cache()
+def _launcher_header():
+    dirname = os.path.dirname(os.path.realpath(__file__))
+    return Path(os.path.join(dirname, "launcher.h")).read_text()
+
+
+def make_launcher(constants, signature, ids, native_launch=False, persistent=False, partition_grid=False,
+                  profile_regions=False, cooperative=False):
     # Record the end of regular arguments;
     # subsequent arguments are architecture-specific descriptors, such as tensor descriptors for CUDA.
     signature, desc_start_idx = generate_cu_signature(constants, signature, ids)
-    arg_decls = ', '.join(f"{ty_to_cpp(ty)} arg{i}" for i, ty in signature.items())
+    # Persistent kernels get the grid as their last arguments, partitioned
+    # kernels get the first program id and the number of programs along x of
+    # their range after them.
+    grid_args = ["tiles0", "tiles1", "tiles2"] if persistent else []
+    if partition_grid:
+        grid_args += ["tile_offset", "tile_grid"]
+    params = [f"ptr_info{i}.dev_ptr" if ty[0] == "*" else f"_arg{i}"
+              for i, ty in signature.items()
+              if i not in constants] + grid_args
+    # Instrumented kernels get the buffer of the cycles of their regions last.
+    if profile_regions:
+        params.append("profile_info.dev_ptr")
 
     def _extracted_type(ty):
         if ty[0] == '*':
@@ -144,161 +683,45 @@ def make_launcher(constants, signature, ids):
         }[ty]
 
     format = "iiiiiiiiiOKOOO" + ''.join(
-        [format_of(_extracted_type(ty)) for ty in signature.values()])
+        [format_of(_extracted_type(ty)) for ty in signature.values()]) + ("O" if profile_regions else "")
+    launch_args = "params, param_sizes, num_params"
+    # the arrays end with a sentinel, as the kernels may have no parameter
+    param_ptrs = ''.join(f"&{param}, " for param in params)
+    param_sizes = ''.join(f"sizeof({param}), " for param in params)
+    launch = "sycl_kernel_launch(launchX, launchY, launchZ, num_warps, threads_per_warp, shared_memory, stream, *kernel_ptr, " + launch_args + ")"
+    if partition_grid:
+        launch = "tile_kernel_launch(launchX, launchY, launchZ, num_warps, threads_per_warp, shared_memory, stream, *kernel_ptr, " + launch_args + ", &tile_offset, &tile_grid)"
+    ze_launch = "ze_kernel_launch(launchX, launchY, launchZ, num_warps, threads_per_warp, shared_memory, stream, *kernel_ptr, " + launch_args + ", with_event ? &ze_event : nullptr)"
+    cooperative_launch = "cooperative_kernel_launch(launchX, launchY, launchZ, num_warps, threads_per_warp, shared_memory, stream, *kernel_ptr, " + launch_args + ", with_event ? &ze_event : nullptr)"
 
     # generate glue code
     src = f"""
-    #include <cstddef>
-    #include <string>
-    #include <iostream>
-    #include <iomanip>
-    #include <level_zero/ze_api.h>
-    #include <sycl/sycl.hpp>
-
-    #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
-    #include <Python.h>
-    #include <stdio.h>
-    #include <numpy/arrayobject.h>
-
-    static inline void gpuAssert(ze_result_t code, const char *file, int line)
-    {{
-      if (code != ZE_RESULT_SUCCESS)
-      {{
-         const char* prefix = "Triton Error [ZE]: ";
-         std::string str = std::to_string(code);
-         char err[1024] = {{0}};
-         strcat(err, prefix);
-         strcat(err, str.c_str());
-         PyErr_SetString(PyExc_RuntimeError, err);
-      }}
-    }}
+{_launcher_header()}
 
-    #define ZE_CHECK(ans) {{ gpuAssert((ans), __FILE__, __LINE__); }}
-
-    typedef struct _DevicePtrInfo {{
-      void* dev_ptr;
-      bool valid;
-    }} DevicePtrInfo;
-
-    static inline DevicePtrInfo getPointer(PyObject *obj, int idx) {{
-      DevicePtrInfo ptr_info;
-      ptr_info.dev_ptr = 0;
-      ptr_info.valid = true;
-      if (PyLong_Check(obj)) {{
-        ptr_info.dev_ptr = (void*) PyLong_AsLongLong(obj);
-        return ptr_info;
-      }}
-      if (obj == Py_None) {{
-        // valid nullptr
-        return ptr_info;
-      }}
-      PyObject *ptr = PyObject_GetAttrString(obj, "data_ptr");
-      if(ptr){{
-        PyObject *empty_tuple = PyTuple_New(0);
-        PyObject *ret = PyObject_Call(ptr, empty_tuple, NULL);
-        Py_DECREF(empty_tuple);
-        Py_DECREF(ptr);
-        if (!PyLong_Check(ret)) {{
-          PyErr_SetString(PyExc_TypeError, "data_ptr method of Pointer object must return 64-bit int");
-          ptr_info.valid = false;
-          return ptr_info;
-        }}
-        ptr_info.dev_ptr = (void*) PyLong_AsLongLong(ret);
-        if(!ptr_info.dev_ptr) {{
-          return ptr_info;
-        }}
-        Py_DECREF(ret);  // Thanks ChatGPT!
-        return ptr_info;
-      }}
-      PyErr_SetString(PyExc_TypeError, "Pointer argument must be either uint64 or have data_ptr method");
-      ptr_info.valid = false;
-      return ptr_info;
-    }}
-// start sycl
-  static void set_scalar_arg(
-          sycl::handler& cgh,
-          int index,
-          size_t size,
-          const void* value) {{
-      switch (size) {{
-      case sizeof(uint8_t):
-      cgh.set_arg(index, *static_cast<const uint8_t*>(value));
-      break;
-      case sizeof(uint16_t):
-      cgh.set_arg(index, *static_cast<const uint16_t*>(value));
-      break;
-      case sizeof(uint32_t):
-      cgh.set_arg(index, *static_cast<const uint32_t*>(value));
-      break;
-      case sizeof(uint64_t):
-      cgh.set_arg(index, *static_cast<const uint64_t*>(value));
-      break;
-      default:
-      assert(false && "wrong scalar size in sycl gen.");
-      }}
-  }}
-  static void sycl_kernel_launch(uint32_t gridX, uint32_t gridY, uint32_t gridZ, int num_warps, int threads_per_warp, int shared_memory, sycl::queue& stream, sycl::kernel& kernel_ptr {', ' + arg_decls if len(arg_decls) > 0 else ''}) {{
-
-    std::string kernel_name = kernel_ptr.get_info<sycl::info::kernel::function_name>();
-    void *params[] = {{ {', '.join(f"&arg{i}" for i in signature.keys() if i not in constants)} }};
-    uint32_t num_params = sizeof(params)/sizeof(params[0]);
-    uint32_t expected_num_params = kernel_ptr.get_info<sycl::info::kernel::num_args>();
-    size_t global_range_x = gridX*threads_per_warp*num_warps;
-    size_t global_range_y = gridY;
-    size_t global_range_z = gridZ;
-    size_t local_range_x = num_warps*threads_per_warp;
-    size_t local_range_y = 1;
-    size_t local_range_z = 1;
-    sycl::range<3> global_range(global_range_z, global_range_y, global_range_x);
-    sycl::range<3> local_range(local_range_z, local_range_y, local_range_x);
-    sycl::nd_range<3> parallel_work_size(global_range, local_range);
-    if (shared_memory) {{
-      expected_num_params -= 1;
-    }}
-    assert(num_params == expected_num_params && "number of kernel param not matched");
-    // Submit the imported kernel.
-    auto cgf = [&](sycl::handler &cgh) {{
-      {" ".join(f'set_scalar_arg(cgh, {idx}, sizeof({ty_to_cpp(item)}), params[{idx}]);' for idx, item in enumerate([signature[i] for i in signature if i not in constants]))}
-      if (shared_memory) {{
-          using share_mem_t = sycl::local_accessor<int8_t, 1>;
-          share_mem_t local_buffer = share_mem_t(shared_memory, cgh);
-          cgh.set_arg(num_params, local_buffer);
-          //cgh.parallel_for(sycl::nd_range{{sycl::range{{(uint32_t)gridX*threads_per_warp*num_warps}}, sycl::range{{work_group_size}}}}, kernel_ptr);
-          cgh.parallel_for(parallel_work_size, kernel_ptr);
-      }} else {{
-          cgh.parallel_for(parallel_work_size, kernel_ptr);
-      }}
-      }};
-    auto event = stream.submit(cgf);
-  }}
-// end sycl
-    static PyObject* launch(PyObject* self, PyObject* args) {{
+    // Launch the kernel, and return a handle to a heap allocated copy of its
+    // event if `with_event`.
+    static PyObject* launch_kernel(PyObject* args, bool with_event) {{
 
       int gridX, gridY, gridZ;
-      uint64_t _queue;
-      uint64_t _stream;
-      uint64_t _function;
-      uint64_t _event_pool;
-      uint64_t _dev;
-      uint64_t _ctxt;
       int num_warps;
       int num_ctas;
       int clusterDimX;
       int clusterDimY;
       int clusterDimZ;
-      int _is_icl;
       int shared_memory;
       PyObject *launch_enter_hook = NULL;
       PyObject *launch_exit_hook = NULL;
       PyObject *compiled_kernel = NULL;
       PyObject *py_obj_stream;
+      PyObject *profile_obj = NULL;
       void* pKrnl;
 
       {' '.join([f"{_extracted_type(ty)} _arg{i}; " for i, ty in signature.items()])}
       if (!PyArg_ParseTuple(args, \"{format}\", &gridX, &gridY, &gridZ, &num_warps, &num_ctas,
                             &clusterDimX, &clusterDimY, &clusterDimZ, &shared_memory, &py_obj_stream,
                             &pKrnl, &launch_enter_hook, &launch_exit_hook, &compiled_kernel
-                            {', ' + ', '.join(f"&_arg{i}" for i, ty in signature.items()) if len(signature) > 0 else ''})) {{
+                            {', ' + ', '.join(f"&_arg{i}" for i, ty in signature.items()) if len(signature) > 0 else ''}
+                            {", &profile_obj" if profile_regions else ""})) {{
         return NULL;
       }}
 
@@ -311,11 +734,33 @@ def make_launcher(constants, signature, ids):
       if(pStream == nullptr || pKrnl == nullptr) return NULL;
 
       sycl::queue stream = *(static_cast<sycl::queue*>(pStream));
-      sycl::kernel kernel = *(static_cast<sycl::kernel*>(pKrnl));
-      auto threads_per_warp = 32;
+      sycl::kernel *kernel_ptr = static_cast<sycl::kernel*>(pKrnl);
+      int threads_per_warp = get_threads_per_warp(compiled_kernel);
 
       {"; ".join([f"DevicePtrInfo ptr_info{i} = getPointer(_arg{i}, {i}); if (!ptr_info{i}.valid) return NULL;" if ty[0] == "*" else "" for i, ty in signature.items()])};
-      sycl_kernel_launch(gridX, gridY, gridZ, num_warps, threads_per_warp, shared_memory, stream, kernel {',' + ', '.join(f"ptr_info{i}.dev_ptr" if ty[0]=="*" else f"_arg{i}" for i, ty in signature.items()) if len(signature) > 0 else ''});
+      {"DevicePtrInfo profile_info = getPointer(profile_obj, -1); if (!profile_info.valid) return NULL;" if profile_regions else ""}
+      {"int32_t tiles0 = gridX, tiles1 = gridY, tiles2 = gridZ;" if persistent else ""}
+      {"int32_t tile_offset = 0, tile_grid = gridX;" if partition_grid else ""}
+      void *params[] = {{ {param_ptrs}nullptr }};
+      size_t param_sizes[] = {{ {param_sizes}0 }};
+      uint32_t num_params = {len(params)};
+      uint32_t launchX = gridX, launchY = gridY, launchZ = gridZ;
+      {"if (!get_persistent_grid(gridX, gridY, gridZ, num_warps, shared_memory, compiled_kernel, stream, &launchX)) return NULL; launchY = launchZ = 1;" if persistent else ""}
+      if (!check_launch(launchX, launchY, launchZ, num_warps, threads_per_warp, num_ctas, clusterDimX, clusterDimY, clusterDimZ, shared_memory, stream, *kernel_ptr, num_params))
+        return NULL;
+      // The launches through Level Zero have no SYCL event, those whose event
+      // is returned signal an event of the pool of their context.
+      sycl::event event;
+      ze_event_handle_t ze_event = nullptr;
+      {"if (!" + cooperative_launch + ") return NULL;" if cooperative else ""}
+      bool has_event = {"false" if cooperative else "!" + ze_launch if native_launch and not partition_grid else "true"};
+      if (has_event)
+        event = {launch};
+      sycl::event *lent_event = ze_event ? lend_ze_event(stream, ze_event) : nullptr;
+      if (lent_event)
+        event = *lent_event;
+      if (trace_enabled && trace_enabled->load(std::memory_order_relaxed))
+        trace_launch(pKrnl, gridX, gridY, gridZ, has_event || lent_event ? &event : nullptr);
 
       if (launch_exit_hook != Py_None) {{
         PyObject_CallObject(launch_exit_hook, args);
@@ -324,13 +769,29 @@ def make_launcher(constants, signature, ids):
         return NULL;
       }}
 
+      if (lent_event)
+        return PyLong_FromUnsignedLongLong(reinterpret_cast<uint64_t>(lent_event));
+      if (with_event)
+        return PyLong_FromUnsignedLongLong(reinterpret_cast<uint64_t>(new sycl::event(event)));
+
       // return None
       Py_INCREF(Py_None);
       return Py_None;
     }}
 
+    static PyObject* launch(PyObject* self, PyObject* args) {{
+      return launch_kernel(args, false);
+    }}
+
+    static PyObject* launch_with_event(PyObject* self, PyObject* args) {{
+      return launch_kernel(args, true);
+    }}
+
     static PyMethodDef ModuleMethods[] = {{
       {{"launch", launch, METH_VARARGS, "Entry point for all kernels with this signature"}},
+      {{"launch_with_event", launch_with_event, METH_VARARGS, "Launch a kernel with this signature and return its event"}},
+      {{"set_trace_hooks", set_trace_hooks, METH_VARARGS, "Record the launches through the tracing hooks of the driver"}},
+      {{"release_event", release_event, METH_VARARGS, "Destroy an event returned by a launch"}},
       {{NULL, NULL, 0, NULL}} // sentinel
     }};
 
@@ -354,6 +815,56 @@ def make_launcher(constants, signature, ids):
     return src
 
 
+@functools.lru_cache()
+def make_launcher_signature(constant_ids, signature, packed_ids=()):
+    """
+    The descriptor of the arguments of the kernels of `signature`, the items
+    of their signature, the launcher of the kernels of any signature decodes
+    their arguments with, see `launcher.cpp`. The arguments `constant_ids` are
+    not passed to the kernels, the arguments `packed_ids` are packed in the
+    buffer of their first argument.
+    """
+    formats = {'i1': 'i', 'i32': 'i', 'i64': 'L', 'u32': 'I', 'u64': 'K', 'fp16': 'f', 'bf16': 'f', 'fp32': 'f',
+               'f32': 'f', 'fp64': 'd'}
+
+    def format_of(i, ty):
+        if i in constant_ids:
+            return ord('-')
+        if ty[0] == '*':
+            return ord('O')
+        return ord(formats[ty]) | (0x80 if i in packed_ids else 0)
+
+    return bytes(format_of(i, ty) for i, ty in signature)
+
+
+@functools.lru_cache()
+def get_generic_launcher():
+    """
+    The launcher of the kernels of any signature: the one built with the
+    package, or else one compiled once for all the kernels.
+    """
+    mod = load_prebuilt_module("xpu_launcher")
+    if mod is None:
+        dirname = os.path.dirname(os.path.realpath(__file__))
+        src = Path(os.path.join(dirname, "launcher.cpp")).read_text()
+        mod = compile_module_from_src(src.replace('#include "launcher.h"', _launcher_header()), "xpu_launcher")
+    mod.set_trace_hooks(*XPUUtils().get_trace_hooks())
+    return mod
+
+
+def _in_itt_task(launch, task_name, itt):
+    # the launch arguments start with the grid
+
+    def launch_in_task(*args, **kwargs):
+        itt.range_push(f"{task_name} grid={args[0]}x{args[1]}x{args[2]}")
+        try:
+            return launch(*args, **kwargs)
+        finally:
+            itt.range_pop()
+
+    return launch_in_task
+
+
 class XPULauncher(object):
 
     def __init__(self, src, metadata):
@@ -363,14 +874,282 @@ class XPULauncher(object):
             "ids_of_const_exprs": src.fn.constexprs if hasattr(src, "fn") else tuple()
         }
         constants = src.constants if hasattr(src, "constants") else dict()
+        arg_names = src.fn.arg_names if hasattr(src, "fn") else []
+        constants = {arg_names.index(k) if isinstance(k, str) else k: v for k, v in constants.items()}
+        signature, constants = expand_descriptors(dict(src.signature), constants)
         enable_warp_specialization = False
-        src = make_launcher(constants, src.signature, ids)
-        mod = compile_module_from_src(src, "__triton_launcher")
-        self.launch = mod.launch
+        # Opt-in launch through Level Zero, for kernels short enough for the
+        # SYCL submission overhead to matter. Their events, when returned, are
+        # Level Zero events recycled from a pool.
+        native_launch = os.environ.get("TRITON_XPU_NATIVE_LAUNCH", "0") == "1"
+        persistent = getattr(metadata, "persistent", False)
+        partition_grid = getattr(metadata, "partition_grid", False)
+        # The regions timed by the kernel when it is instrumented, see
+        # `region_cycles`.
+        self.profile_regions = tuple(getattr(metadata, "profile_regions", ()))
+        self.profile_buffer = None
+        # The records of the prints and the assertions of the kernel when they
+        # are buffered, see `flush_prints`. The buffer is an argument of the
+        # kernel, after its own ones.
+        self.buffered_prints = tuple(json.loads(desc) for desc in getattr(metadata, "buffered_prints", ()))
+        self.print_buffer_size = getattr(metadata, "print_buffer_size", 0)
+        self.print_buffer = None
+        if self.buffered_prints:
+            signature[max([*signature, *constants], default=-1) + 1] = "*i64"
+            atexit.register(_flush_prints_at_exit, weakref.ref(self))
+        # The counters of the grid barriers of the kernel, launched
+        # cooperatively, are its argument after the buffer of the prints.
+        # They are back to zero after each barrier, allocated once.
+        cooperative = getattr(metadata, "cooperative", False)
+        self.cooperative = cooperative
+        self.barrier_counters = None
+        if cooperative:
+            if persistent or partition_grid:
+                raise RuntimeError("kernels with grid barriers can't be persistent or partitioned across the tiles")
+            signature[max([*signature, *constants], default=-1) + 1] = "*i32"
+        # The kernels are launched by the launcher of the kernels of any
+        # signature, `TRITON_XPU_SPECIALIZED_LAUNCHER=1` compiles a launcher
+        # for the signature of the kernel instead, which doesn't decode the
+        # signature on each launch.
+        specialized = os.environ.get("TRITON_XPU_SPECIALIZED_LAUNCHER", "0") == "1"
+        # The scalar arguments packed by the compiler, only decoded by the
+        # launcher of the kernels of any signature, indexed among the ones
+        # passed to the kernel.
+        kernel_args = [i for i in signature if i not in constants]
+        packed_ids = tuple(kernel_args[i] for i in getattr(metadata, "packed_args", ()))
+        if packed_ids or (not specialized and not ids["ids_of_tensormaps"]):
+            mod = get_generic_launcher()
+            signature = make_launcher_signature(tuple(constants), tuple(signature.items()), packed_ids)
+            if packed_ids and cooperative:
+                raise RuntimeError("kernels with grid barriers can't have packed arguments")
+            flags = native_launch | persistent << 1 | partition_grid << 2 | bool(self.profile_regions) << 3 | bool(
+                packed_ids) << 4 | cooperative << 5
+            self.launch = functools.partial(mod.launch, signature, flags)
+            self._launch_with_event = functools.partial(mod.launch_with_event, signature, flags)
+            self._release_event = mod.release_event
+        else:
+            src = make_launcher(constants, signature, ids, native_launch, persistent, partition_grid,
+                                bool(self.profile_regions), cooperative)
+            mod = compile_module_from_src(src, "__triton_launcher")
+            mod.set_trace_hooks(*XPUUtils().get_trace_hooks())
+            self.launch = mod.launch
+            self._launch_with_event = mod.launch_with_event
+            self._release_event = mod.release_event
+        # `TRITON_XPU_ITT=1` wraps the launches in ITT tasks, e.g. for VTune,
+        # named after the kernel, its constexprs and options, its hash and the
+        # grid of the launch. The launches are left as they are otherwise.
+        if os.environ.get("TRITON_XPU_ITT", "0") == "1":
+            from torch.profiler import itt
+            if itt.is_available():
+                arg_names = src.fn.arg_names if hasattr(src, "fn") else []
+                config = [f"{arg_names[i]}={constants[i]}" for i in ids["ids_of_const_exprs"] if i in constants]
+                config += [f"{name}={getattr(metadata, name)}" for name in ("num_warps", "num_stages", "threads_per_warp")
+                           if hasattr(metadata, name)]
+                task_name = f"triton:{metadata.name} [{', '.join(config)}] #{metadata.hash[:8]}"
+                self.launch = _in_itt_task(self.launch, task_name, itt)
+                self._launch_with_event = _in_itt_task(self._launch_with_event, task_name, itt)
+
+    def _with_profile_buffer(self, args):
+        if self.profile_buffer is None:
+            import torch
+            # the cycles and the number of runs of each region
+            self.profile_buffer = torch.zeros(2 * len(self.profile_regions), dtype=torch.int64, device="xpu")
+        return args + (self.profile_buffer, )
+
+    def _with_print_buffer(self, args):
+        if self.print_buffer is None:
+            import torch
+            # the cursor and the capacity of the buffer, then the records
+            self.print_buffer = torch.zeros(2 + self.print_buffer_size, dtype=torch.int64, device="xpu")
+            self.print_buffer[1] = self.print_buffer_size
+        return args + (self.print_buffer, )
+
+    def _with_barrier_counters(self, args):
+        if self.barrier_counters is None:
+            import torch
+            # the arrivals at the barrier and its generation
+            self.barrier_counters = torch.zeros(2, dtype=torch.int32, device="xpu")
+        return args + (self.barrier_counters, )
 
     def __call__(self, *args, **kwargs):
+        if self.buffered_prints:
+            args = self._with_print_buffer(args)
+        if self.cooperative:
+            args = self._with_barrier_counters(args)
+        if self.profile_regions:
+            args = self._with_profile_buffer(args)
         self.launch(*args, **kwargs)
 
+    def launch_with_event(self, *args):
+        """
+        Launch the kernel like `__call__` and return the `XPUEvent` of the
+        launch.
+        """
+        if self.buffered_prints:
+            args = self._with_print_buffer(args)
+        if self.cooperative:
+            args = self._with_barrier_counters(args)
+        if self.profile_regions:
+            args = self._with_profile_buffer(args)
+        return XPUEvent(XPUUtils(), self._launch_with_event(*args), self._release_event)
+
+    def region_cycles(self):
+        """
+        The cycles spent in the regions timed by an instrumented kernel, e.g.
+        compiled with `TRITON_INTEL_PROFILE_REGIONS=loop,dot,load`, since its
+        first launch or the last `reset_region_cycles`. Maps the name of each
+        region, its kind and location, to its total cycles in the first
+        sub-group of the work-groups, the number of times it ran and the mean
+        cycles of a run. Waits for the launched kernels.
+        """
+        if self.profile_buffer is None:
+            return {}
+        values = self.profile_buffer.cpu().tolist()
+        breakdown = {}
+        for i, name in enumerate(self.profile_regions):
+            cycles, count = values[2 * i], values[2 * i + 1]
+            breakdown[name] = {"cycles": cycles, "count": count, "mean_cycles": cycles / count if count else 0.0}
+        return breakdown
+
+    def reset_region_cycles(self):
+        if self.profile_buffer is not None:
+            self.profile_buffer.zero_()
+
+    def flush_prints(self, file=None):
+        """
+        Write the records of the prints and the failed assertions of a kernel
+        compiled with `TRITON_INTEL_PRINT_BUFFER=<slots>`, since its first
+        launch or the last flush, to `file`, stdout by default, and return
+        their lines. Each element of a tensor is printed on a line, e.g.
+        "pid (0, 0, 0) idx (3) x: 1.5". The kernel isn't stopped by its failed
+        assertions, the records that didn't fit in the buffer are counted.
+        Waits for the launched kernels, and runs at exit.
+        """
+        if self.print_buffer is None:
+            return []
+        values = self.print_buffer.cpu().tolist()
+        cursor, capacity = values[0], values[1]
+        end = 2 + min(cursor, capacity)
+        lines = []
+        pos = 2
+        while pos < end:
+            desc = self.buffered_prints[values[pos]]
+            size = _record_size(desc)
+            if pos + size > end:
+                break
+            lines += _decode_record(desc, values[pos:pos + size])
+            pos += size
+        if pos - 2 < cursor:
+            lines.append(f"{cursor - pos + 2} slots of records dropped, "
+                         f"the buffer of the prints holds {capacity} slots")
+        self.print_buffer.zero_()
+        self.print_buffer[1] = capacity
+        if lines:
+            print("\n".join(lines), file=file or sys.stdout, flush=True)
+        return lines
+
+
+def _flush_prints_at_exit(launcher):
+    launcher = launcher()
+    if launcher is not None:
+        launcher.flush_prints()
+
+
+def _num_elements(shape):
+    n = 1
+    for dim in shape:
+        n *= dim
+    return n
+
+
+def _record_size(desc):
+    """The number of i64 slots of a record, its id and program id included."""
+    if desc["kind"] == "assert":
+        return 5
+    return 4 + sum(_num_elements(arg["shape"]) for arg in desc["args"])
+
+
+def _unravel(index, shape):
+    idx = []
+    for dim in reversed(shape):
+        idx.append(index % dim)
+        index //= dim
+    return ", ".join(str(i) for i in reversed(idx))
+
+
+def _decode_value(ty, value):
+    if ty.startswith(("f", "bf")):
+        return repr(struct.unpack("<d", struct.pack("<q", value))[0])
+    if ty.startswith("!tt.ptr"):
+        return hex(value & ((1 << 64) - 1))
+    return str(value)
+
+
+def _decode_record(desc, record):
+    """The lines printed for a record of the buffer of the prints."""
+    pid = f"pid ({record[1]}, {record[2]}, {record[3]})"
+    if desc["kind"] == "assert":
+        idx = f" idx ({_unravel(record[4], desc['shape'])})" if desc["shape"] else ""
+        return [f"{pid}{idx} {desc['file']}:{desc['line']}: {desc['func']}: "
+                f"Assertion `{desc['message']}` failed."]
+    lines = []
+    pos = 4
+    args = desc["args"]
+    for i, arg in enumerate(args):
+        operand = f" (operand {i})" if len(args) > 1 else ""
+        n = _num_elements(arg["shape"])
+        for j in range(n):
+            idx = f" idx ({_unravel(j, arg['shape'])})" if arg["shape"] else ""
+            lines.append(f"{pid}{idx}{desc['prefix']}{_decode_value(arg['type'], record[pos + j])}{operand}")
+        pos += n
+    return lines
+
+
+class XPUEvent(object):
+    """
+    The completion of a launched kernel, usable where a `torch.xpu.Event`
+    recorded after the launch would be.
+
+    `elapsed_time` needs the kernels to be launched through SYCL on a queue
+    created with profiling enabled.
+    """
+
+    def __init__(self, utils, handle, release=None):
+        self.utils = utils
+        self.handle = handle
+        # how the handle is destroyed, the events of the kernels launched
+        # through Level Zero being returned to their pool
+        self.release = release if release is not None else utils.destroy_event
+
+    def synchronize(self):
+        """Block until the kernel completes."""
+        self.utils.synchronize_event(self.handle)
+
+    def wait(self, stream=None):
+        """Make the work submitted to `stream`, by default the current one, wait for the kernel."""
+        if stream is None:
+            stream = self.utils.get_sycl_queue()
+        self.utils.wait_event(self.handle, stream)
+
+    def query(self):
+        """Return whether the kernel has completed."""
+        return self.utils.query_event(self.handle)
+
+    def elapsed_time(self, end_event=None):
+        """
+        Return the time in milliseconds from the start of this kernel to the
+        end of the kernel of `end_event`, by default to the end of this kernel.
+        """
+        end = self if end_event is None else end_event
+        return self.utils.event_elapsed_time(self.handle, end.handle)
+
+    def __del__(self):
+        try:
+            self.release(self.handle)
+        except Exception:
+            # the driver may already be torn down at interpreter exit
+            pass
+
 
 class XPUDriver(DriverBase):
 
@@ -380,15 +1159,19 @@ class XPUDriver(DriverBase):
         self.launcher_cls = XPULauncher
         self.get_current_stream = self.get_current_stream
         self.get_current_device = self.utils.get_current_device
+        # the targets of the devices, queried on every launch
+        self.targets = {}
 
-    def get_current_stream(self, device):
-        import torch
-        return torch.xpu.current_stream().sycl_queue
+    def get_current_stream(self, device=None):
+        return self.utils.get_sycl_queue(device)
 
     def get_current_target(self):
         device = self.get_current_device()
-        device_arch = self.utils.get_device_properties(device)['device_arch']
-        return ("xpu", device_arch)
+        target = self.targets.get(device)
+        if target is None:
+            device_arch = self.utils.get_device_properties(device)['device_arch']
+            target = self.targets[device] = ("xpu", device_arch)
+        return target
 
     @staticmethod
     def is_active():
@@ -396,5 +1179,12 @@ class XPUDriver(DriverBase):
         return torch.xpu.is_available()
 
     def assemble_tensormap_to_arg(self, tensormaps_info, args):
-        args_ptr = tuple([arg.data_ptr() if hasattr(arg, 'data_ptr') else arg for arg in args])
-        return args_ptr
+        # The tensor descriptors are passed to the kernels as their base
+        # pointer, rows, columns and pitch, see `expand_descriptors`.
+        args_ptr = []
+        for arg in args:
+            if isinstance(arg, TensorDescriptor):
+                args_ptr += arg.launch_args()
+            else:
+                args_ptr.append(arg.data_ptr() if hasattr(arg, 'data_ptr') else arg)
+        return tuple(args_ptr)
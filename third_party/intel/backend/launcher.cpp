@@ -0,0 +1,348 @@
+//===- launcher.cpp -------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The launcher of the kernels of any signature, built with the package or
+// compiled once for all the kernels, so that no launcher is compiled for the
+// signature of each kernel, see `XPULauncher`. The arguments of the kernel are
+// decoded on each launch from the descriptor of its signature it is given
+// first, one character per argument:
+//
+//   'O' a pointer, 'i' / 'I' a 32-bit signed / unsigned integer, 'L' / 'K' a
+//   64-bit one, 'f' a float, 'd' a double, '-' a constant, not passed.
+//
+//===----------------------------------------------------------------------===//
+
+#include "launcher.h"
+
+// The ways the kernels are launched, given with their signature.
+enum LaunchFlags {
+  // through Level Zero when possible, see `ze_kernel_launch`
+  NATIVE_LAUNCH = 1,
+  // with the grid as their last arguments, see `get_persistent_grid`
+  PERSISTENT = 2,
+  // across the tiles of the device, see `tile_kernel_launch`
+  PARTITION_GRID = 4,
+  // with the buffer of the cycles of their regions as their last argument
+  PROFILE_REGIONS = 8,
+  // with the buffer of their packed scalar arguments as their first argument,
+  // through SYCL, see `acquire_packed_args_slot`
+  PACKED_ARGS = 16,
+  // cooperatively through Level Zero, with the counters of their grid
+  // barriers in their signature, see `cooperative_kernel_launch`
+  COOPERATIVE = 32,
+};
+
+// The bit of the characters of the signature of the packed arguments.
+constexpr unsigned char packed_arg_bit = 0x80;
+
+// The launch arguments preceding those of the kernel.
+constexpr Py_ssize_t num_launch_args = 16;
+
+// Convert the argument of the kernel `obj` of type `ty` to the value of its
+// parameter, return false with a Python error set if it can't be.
+static bool get_param(char ty, PyObject *obj, int idx, uint64_t *value,
+                      size_t *size) {
+  switch (ty) {
+  case 'O': {
+    DevicePtrInfo ptr_info = getPointer(obj, idx);
+    if (!ptr_info.valid)
+      return false;
+    *reinterpret_cast<void **>(value) = ptr_info.dev_ptr;
+    *size = sizeof(void *);
+    return true;
+  }
+  case 'i': {
+    long v = PyLong_AsLong(obj);
+    if (v == -1 && PyErr_Occurred())
+      return false;
+    if (v < INT32_MIN || v > INT32_MAX) {
+      PyErr_SetString(PyExc_OverflowError,
+                      "signed integer is greater than maximum");
+      return false;
+    }
+    *reinterpret_cast<int32_t *>(value) = int32_t(v);
+    *size = sizeof(int32_t);
+    return true;
+  }
+  case 'I':
+    *reinterpret_cast<uint32_t *>(value) =
+        uint32_t(PyLong_AsUnsignedLongMask(obj));
+    *size = sizeof(uint32_t);
+    return !PyErr_Occurred();
+  case 'L':
+    *reinterpret_cast<int64_t *>(value) = PyLong_AsLongLong(obj);
+    *size = sizeof(int64_t);
+    return !PyErr_Occurred();
+  case 'K':
+    *reinterpret_cast<uint64_t *>(value) = PyLong_AsUnsignedLongLongMask(obj);
+    *size = sizeof(uint64_t);
+    return !PyErr_Occurred();
+  case 'f':
+    *reinterpret_cast<float *>(value) = float(PyFloat_AsDouble(obj));
+    *size = sizeof(float);
+    return !PyErr_Occurred();
+  case 'd':
+    *reinterpret_cast<double *>(value) = PyFloat_AsDouble(obj);
+    *size = sizeof(double);
+    return !PyErr_Occurred();
+  default:
+    PyErr_Format(PyExc_ValueError, "unknown type '%c' in the signature", ty);
+    return false;
+  }
+}
+
+// Launch the kernel, and return a handle to a heap allocated copy of its
+// event if `with_event`. The arguments are the signature of the kernel and its
+// launch flags, then those of the launchers generated for a signature.
+static PyObject *launch_kernel(PyObject *args, bool with_event) {
+  Py_ssize_t num_args = PyTuple_GET_SIZE(args);
+  if (num_args < 2 + num_launch_args) {
+    PyErr_SetString(PyExc_TypeError, "missing launch arguments");
+    return NULL;
+  }
+  PyObject *launch_args = PyTuple_GetSlice(args, 2, num_args);
+  if (launch_args == NULL)
+    return NULL;
+  PyObject *result = NULL;
+  PyObject *header;
+  int parsed;
+
+  const char *signature;
+  Py_ssize_t signature_size;
+  int flags;
+  int gridX, gridY, gridZ;
+  int num_warps;
+  int num_ctas;
+  int clusterDimX;
+  int clusterDimY;
+  int clusterDimZ;
+  int shared_memory;
+  PyObject *launch_enter_hook = NULL;
+  PyObject *launch_exit_hook = NULL;
+  PyObject *compiled_kernel = NULL;
+  PyObject *py_obj_stream;
+  void *pKrnl;
+  void *pStream;
+  std::vector<uint64_t> values;
+  std::vector<void *> params;
+  std::vector<size_t> param_sizes;
+  std::vector<uint64_t> packed;
+  PackedArgsSlot *packed_slot = nullptr;
+  uint32_t num_params;
+  int32_t *tile_offset = nullptr, *tile_grid = nullptr;
+  uint32_t launchX, launchY, launchZ;
+  sycl::event event;
+  bool has_event = false;
+  ze_event_handle_t ze_event = nullptr;
+  sycl::event *lent_event = nullptr;
+
+  if (PyBytes_AsStringAndSize(PyTuple_GET_ITEM(args, 0),
+                              const_cast<char **>(&signature),
+                              &signature_size) < 0)
+    goto done;
+  flags = PyLong_AsLong(PyTuple_GET_ITEM(args, 1));
+  if (flags == -1 && PyErr_Occurred())
+    goto done;
+  if (num_args != 2 + num_launch_args + signature_size +
+                      ((flags & PROFILE_REGIONS) ? 1 : 0)) {
+    PyErr_Format(PyExc_TypeError,
+                 "%zd arguments given for a signature of %zd arguments",
+                 num_args - 2 - num_launch_args, signature_size);
+    goto done;
+  }
+  header = PyTuple_GetSlice(launch_args, 0, num_launch_args);
+  if (header == NULL)
+    goto done;
+  parsed = PyArg_ParseTuple(header, "iiiiiiiiiOKOOO", &gridX, &gridY, &gridZ,
+                            &num_warps, &num_ctas, &clusterDimX, &clusterDimY,
+                            &clusterDimZ, &shared_memory, &py_obj_stream,
+                            &pKrnl, &launch_enter_hook, &launch_exit_hook,
+                            &compiled_kernel);
+  Py_DECREF(header);
+  if (!parsed)
+    goto done;
+
+  if (launch_enter_hook != Py_None) {
+    PyObject_CallObject(launch_enter_hook, launch_args);
+  }
+
+  pStream = PyCapsule_GetPointer(py_obj_stream,
+                                 PyCapsule_GetName(py_obj_stream));
+  if (pStream == nullptr || pKrnl == nullptr)
+    goto done;
+
+  {
+    sycl::queue stream = *(static_cast<sycl::queue *>(pStream));
+    sycl::kernel *kernel_ptr = static_cast<sycl::kernel *>(pKrnl);
+    int threads_per_warp = get_threads_per_warp(compiled_kernel);
+
+    // The values of the parameters in 64-bit slots, allocated once for the
+    // buffer of the packed arguments, the arguments, the grid and the profile
+    // buffer, so that their addresses don't move.
+    values.resize(signature_size + 7);
+    param_sizes.reserve(signature_size + 7);
+    if (flags & PACKED_ARGS) {
+      params.push_back(&values[0]);
+      param_sizes.push_back(sizeof(void *));
+    }
+    for (Py_ssize_t i = 0; i < signature_size; ++i) {
+      unsigned char ty = signature[i];
+      if (ty == '-')
+        continue;
+      size_t size;
+      PyObject *arg = PyTuple_GET_ITEM(launch_args, num_launch_args + i);
+      if (ty & packed_arg_bit) {
+        packed.emplace_back();
+        if (!get_param(ty & ~packed_arg_bit, arg, i, &packed.back(), &size))
+          goto done;
+        continue;
+      }
+      if (!get_param(ty, arg, i, &values[params.size()], &size))
+        goto done;
+      params.push_back(&values[params.size()]);
+      param_sizes.push_back(size);
+    }
+    if (flags & PACKED_ARGS) {
+      // A single copy, instead of an argument to set per scalar.
+      size_t size = packed.size() * sizeof(uint64_t);
+      packed_slot = acquire_packed_args_slot(stream, size);
+      if (!packed_slot)
+        goto done;
+      std::memcpy(packed_slot->ptr, packed.data(), size);
+      *reinterpret_cast<void **>(&values[0]) = packed_slot->ptr;
+    }
+    auto add_grid_param = [&](int32_t value) {
+      int32_t *param = reinterpret_cast<int32_t *>(&values[params.size()]);
+      *param = value;
+      params.push_back(param);
+      param_sizes.push_back(sizeof(int32_t));
+      return param;
+    };
+    if (flags & PERSISTENT) {
+      add_grid_param(gridX);
+      add_grid_param(gridY);
+      add_grid_param(gridZ);
+    }
+    if (flags & PARTITION_GRID) {
+      tile_offset = add_grid_param(0);
+      tile_grid = add_grid_param(gridX);
+    }
+    if (flags & PROFILE_REGIONS) {
+      size_t size;
+      if (!get_param('O', PyTuple_GET_ITEM(args, num_args - 1), -1,
+                     &values[params.size()], &size))
+        goto done;
+      params.push_back(&values[params.size()]);
+      param_sizes.push_back(size);
+    }
+    num_params = params.size();
+
+    launchX = gridX, launchY = gridY, launchZ = gridZ;
+    if (flags & PERSISTENT) {
+      if (!get_persistent_grid(gridX, gridY, gridZ, num_warps, shared_memory,
+                               compiled_kernel, stream, &launchX))
+        goto done;
+      launchY = launchZ = 1;
+    }
+    if (!check_launch(launchX, launchY, launchZ, num_warps, threads_per_warp,
+                      num_ctas, clusterDimX, clusterDimY, clusterDimZ,
+                      shared_memory, stream, *kernel_ptr, num_params))
+      goto done;
+    if ((flags & COOPERATIVE) &&
+        !cooperative_kernel_launch(launchX, launchY, launchZ, num_warps,
+                                   threads_per_warp, shared_memory, stream,
+                                   *kernel_ptr, params.data(),
+                                   param_sizes.data(), num_params,
+                                   with_event ? &ze_event : nullptr))
+      goto done;
+    // The launches through Level Zero have no SYCL event, those whose event
+    // is returned signal an event of the pool of their context. The slot of
+    // the packed arguments is reused after the SYCL event of their launch.
+    has_event = !(flags & COOPERATIVE) &&
+                (!(flags & NATIVE_LAUNCH) || (flags & PARTITION_GRID) ||
+                 (flags & PACKED_ARGS) ||
+                 !ze_kernel_launch(launchX, launchY, launchZ, num_warps,
+                                   threads_per_warp, shared_memory, stream,
+                                   *kernel_ptr, params.data(),
+                                   param_sizes.data(), num_params,
+                                   with_event ? &ze_event : nullptr));
+    if (has_event)
+      event = (flags & PARTITION_GRID)
+                  ? tile_kernel_launch(launchX, launchY, launchZ, num_warps,
+                                       threads_per_warp, shared_memory, stream,
+                                       *kernel_ptr, params.data(),
+                                       param_sizes.data(), num_params,
+                                       tile_offset, tile_grid)
+                  : sycl_kernel_launch(launchX, launchY, launchZ, num_warps,
+                                       threads_per_warp, shared_memory, stream,
+                                       *kernel_ptr, params.data(),
+                                       param_sizes.data(), num_params);
+    if (ze_event) {
+      lent_event = lend_ze_event(stream, ze_event);
+      event = *lent_event;
+    }
+    if (packed_slot)
+      packed_slot->event = event;
+  }
+  if (trace_enabled && trace_enabled->load(std::memory_order_relaxed))
+    trace_launch(pKrnl, gridX, gridY, gridZ,
+                 has_event || lent_event ? &event : nullptr);
+
+  if (launch_exit_hook != Py_None) {
+    PyObject_CallObject(launch_exit_hook, launch_args);
+  }
+  if (PyErr_Occurred())
+    goto done;
+
+  if (with_event) {
+    result = PyLong_FromUnsignedLongLong(reinterpret_cast<uint64_t>(
+        lent_event ? lent_event : new sycl::event(event)));
+  } else {
+    Py_INCREF(Py_None);
+    result = Py_None;
+  }
+
+done:
+  Py_DECREF(launch_args);
+  return result;
+}
+
+static PyObject *launch(PyObject *self, PyObject *args) {
+  return launch_kernel(args, false);
+}
+
+static PyObject *launch_with_event(PyObject *self, PyObject *args) {
+  return launch_kernel(args, true);
+}
+
+static PyMethodDef ModuleMethods[] = {
+    {"launch", launch, METH_VARARGS,
+     "Launch a kernel of the signature given as first argument"},
+    {"launch_with_event", launch_with_event, METH_VARARGS,
+     "Launch a kernel of the signature given as first argument and return "
+     "its event"},
+    {"set_trace_hooks", set_trace_hooks, METH_VARARGS,
+     "Record the launches through the tracing hooks of the driver"},
+    {"release_event", release_event, METH_VARARGS,
+     "Destroy an event returned by a launch"},
+    {NULL, NULL, 0, NULL} // sentinel
+};
+
+static struct PyModuleDef ModuleDef = {PyModuleDef_HEAD_INIT, "xpu_launcher",
+                                       NULL, // documentation
+                                       -1,   // size
+                                       ModuleMethods};
+
+PyMODINIT_FUNC PyInit_xpu_launcher(void) {
+  PyObject *m = PyModule_Create(&ModuleDef);
+  if (m == NULL) {
+    return NULL;
+  }
+  PyModule_AddFunctions(m, ModuleMethods);
+  return m;
+}
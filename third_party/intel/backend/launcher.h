@@ -0,0 +1,746 @@
+//===- launcher.h ---------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The launch of the kernels, shared by the launchers generated for the
+// signature of a kernel, see `make_launcher` in `driver.py`, and the launcher
+// of the kernels of any signature, see `launcher.cpp`. The parameters of the
+// kernels are passed as arrays of pointers to their values and of their sizes.
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <level_zero/ze_api.h>
+#include <mutex>
+#include <string>
+#include <sycl/sycl.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <Python.h>
+#include <numpy/arrayobject.h>
+#include <stdio.h>
+
+static inline void gpuAssert(ze_result_t code, const char *file, int line) {
+  if (code != ZE_RESULT_SUCCESS) {
+    const char *prefix = "Triton Error [ZE]: ";
+    std::string str = std::to_string(code);
+    char err[1024] = {0};
+    strcat(err, prefix);
+    strcat(err, str.c_str());
+    PyErr_SetString(PyExc_RuntimeError, err);
+  }
+}
+
+#define ZE_CHECK(ans)                                                          \
+  { gpuAssert((ans), __FILE__, __LINE__); }
+
+typedef struct _DevicePtrInfo {
+  void *dev_ptr;
+  bool valid;
+} DevicePtrInfo;
+
+static inline DevicePtrInfo getPointer(PyObject *obj, int idx) {
+  DevicePtrInfo ptr_info;
+  ptr_info.dev_ptr = 0;
+  ptr_info.valid = true;
+  if (PyLong_Check(obj)) {
+    ptr_info.dev_ptr = (void *)PyLong_AsLongLong(obj);
+    return ptr_info;
+  }
+  if (obj == Py_None) {
+    // valid nullptr
+    return ptr_info;
+  }
+  // Call `data_ptr` through the vectorcall protocol with an interned name:
+  // this doesn't create a bound method nor an argument tuple per launch.
+  static PyObject *data_ptr_name = PyUnicode_InternFromString("data_ptr");
+#if PY_VERSION_HEX >= 0x03090000
+  PyObject *ret = PyObject_CallMethodNoArgs(obj, data_ptr_name);
+#else
+  PyObject *ret = PyObject_CallMethodObjArgs(obj, data_ptr_name, NULL);
+#endif
+  if (!ret) {
+    if (PyErr_ExceptionMatches(PyExc_AttributeError)) {
+      PyErr_Clear();
+      PyErr_SetString(PyExc_TypeError,
+                      "Pointer argument must be either uint64 or have "
+                      "data_ptr method");
+    }
+    ptr_info.valid = false;
+    return ptr_info;
+  }
+  if (!PyLong_Check(ret)) {
+    Py_DECREF(ret);
+    PyErr_SetString(PyExc_TypeError,
+                    "data_ptr method of Pointer object must return 64-bit int");
+    ptr_info.valid = false;
+    return ptr_info;
+  }
+  ptr_info.dev_ptr = (void *)PyLong_AsLongLong(ret);
+  Py_DECREF(ret);
+  return ptr_info;
+}
+
+static void set_scalar_arg(sycl::handler &cgh, int index, size_t size,
+                           const void *value) {
+  switch (size) {
+  case sizeof(uint8_t):
+    cgh.set_arg(index, *static_cast<const uint8_t *>(value));
+    break;
+  case sizeof(uint16_t):
+    cgh.set_arg(index, *static_cast<const uint16_t *>(value));
+    break;
+  case sizeof(uint32_t):
+    cgh.set_arg(index, *static_cast<const uint32_t *>(value));
+    break;
+  case sizeof(uint64_t):
+    cgh.set_arg(index, *static_cast<const uint64_t *>(value));
+    break;
+  default:
+    assert(false && "wrong scalar size in sycl gen.");
+  }
+}
+
+// Kernels whose number of parameters has been checked, so that the
+// information is not queried again on every launch.
+static std::unordered_set<const sycl::kernel *> checked_kernels;
+
+static bool check_num_params(const sycl::kernel &kernel_ptr,
+                             uint32_t num_params, int shared_memory) {
+  if (checked_kernels.count(&kernel_ptr))
+    return true;
+  uint32_t expected_num_params =
+      kernel_ptr.get_info<sycl::info::kernel::num_args>();
+  if (shared_memory) {
+    expected_num_params -= 1;
+  }
+  if (num_params != expected_num_params) {
+    PyErr_Format(PyExc_RuntimeError,
+                 "number of kernel params not matched: %u vs %u", num_params,
+                 expected_num_params);
+    return false;
+  }
+  checked_kernels.insert(&kernel_ptr);
+  return true;
+}
+
+// The largest work-group, the largest number of work-groups in each
+// dimension, the number of hardware threads, each running a sub-group, the
+// number of Xe-cores and the shared local memory of an Xe-core of the devices,
+// queried on their first launch.
+struct DeviceLimits {
+  size_t max_work_group_size;
+  uint32_t max_group_count[3];
+  uint32_t num_hw_threads;
+  uint32_t num_xe_cores;
+  uint32_t shared_per_xe_core;
+};
+static std::unordered_map<ze_device_handle_t, DeviceLimits> device_limits;
+
+static const DeviceLimits *get_device_limits(const sycl::device &device) {
+  if (device.get_backend() != sycl::backend::ext_oneapi_level_zero) {
+    // Only the work-group size and the number of compute units are known by
+    // SYCL itself.
+    static thread_local DeviceLimits limits;
+    uint32_t num_compute_units =
+        device.get_info<sycl::info::device::max_compute_units>();
+    limits = {device.get_info<sycl::info::device::max_work_group_size>(),
+              {UINT32_MAX, UINT32_MAX, UINT32_MAX},
+              num_compute_units,
+              num_compute_units,
+              uint32_t(device.get_info<sycl::info::device::local_mem_size>())};
+    return &limits;
+  }
+  auto ze_device =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(device);
+  auto it = device_limits.find(ze_device);
+  if (it == device_limits.end()) {
+    ze_device_compute_properties_t props = {
+        ZE_STRUCTURE_TYPE_DEVICE_COMPUTE_PROPERTIES};
+    ze_result_t result = zeDeviceGetComputeProperties(ze_device, &props);
+    if (result != ZE_RESULT_SUCCESS) {
+      ZE_CHECK(result);
+      return nullptr;
+    }
+    ze_device_properties_t device_props = {
+        ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES};
+    result = zeDeviceGetProperties(ze_device, &device_props);
+    if (result != ZE_RESULT_SUCCESS) {
+      ZE_CHECK(result);
+      return nullptr;
+    }
+    uint32_t num_hw_threads =
+        device_props.numSlices * device_props.numSubslicesPerSlice *
+        device_props.numEUsPerSubslice * device_props.numThreadsPerEU;
+    // The shared local memory of a work-group is the one of an Xe-core.
+    DeviceLimits limits = {
+        props.maxTotalGroupSize,
+        {props.maxGroupCountX, props.maxGroupCountY, props.maxGroupCountZ},
+        num_hw_threads,
+        device_props.numSlices * device_props.numSubslicesPerSlice,
+        props.maxSharedLocalMemory};
+    it = device_limits.emplace(ze_device, limits).first;
+  }
+  return &it->second;
+}
+
+// The number of work-groups of `num_warps` sub-groups using `shared_memory`
+// bytes of shared local memory each Xe-core of the device keeps resident: the
+// hardware threads of the Xe-core, halved for the kernels with 256 registers
+// per thread, and its shared local memory are split among them, see
+// `XPUUtils.get_occupancy`.
+static uint64_t get_resident_work_groups(const DeviceLimits &limits,
+                                         int num_warps, int shared_memory,
+                                         int num_grf) {
+  uint64_t threads_per_xe_core =
+      limits.num_hw_threads / std::max<uint32_t>(1, limits.num_xe_cores);
+  if (num_grf > 128)
+    threads_per_xe_core /= 2;
+  uint64_t work_groups = threads_per_xe_core / num_warps;
+  if (shared_memory > 0)
+    work_groups = std::min<uint64_t>(work_groups, limits.shared_per_xe_core /
+                                                      uint64_t(shared_memory));
+  return std::max<uint64_t>(1, work_groups);
+}
+
+// The number of registers per thread of the kernel, recorded in its metadata
+// once it is loaded.
+static int get_num_grf(PyObject *compiled_kernel) {
+  int num_grf = 128;
+  PyObject *n_regs_attr = PyObject_GetAttrString(compiled_kernel, "n_regs");
+  if (n_regs_attr) {
+    if (PyLong_Check(n_regs_attr))
+      num_grf = PyLong_AsLong(n_regs_attr);
+    Py_DECREF(n_regs_attr);
+  } else {
+    PyErr_Clear();
+  }
+  return num_grf;
+}
+
+// The number of work-groups persistent kernels are launched with: as many as
+// the Xe-cores of the device keep resident, given the sub-groups, registers
+// and shared local memory of the work-groups, at most one per tile of the
+// grid.
+static bool get_persistent_grid(uint32_t gridX, uint32_t gridY, uint32_t gridZ,
+                                int num_warps, int shared_memory,
+                                PyObject *compiled_kernel, sycl::queue &stream,
+                                uint32_t *launchX) {
+  uint64_t num_tiles = uint64_t(gridX) * gridY * gridZ;
+  if (num_tiles > INT32_MAX) {
+    PyErr_Format(PyExc_RuntimeError,
+                 "grid of %llu work-groups is too large for a persistent "
+                 "kernel",
+                 (unsigned long long)num_tiles);
+    return false;
+  }
+  const DeviceLimits *limits = get_device_limits(stream.get_device());
+  if (!limits)
+    return false;
+  uint64_t resident =
+      uint64_t(std::max<uint32_t>(1, limits->num_xe_cores)) *
+      get_resident_work_groups(*limits, num_warps, shared_memory,
+                               get_num_grf(compiled_kernel));
+  *launchX = uint32_t(std::min(num_tiles, resident));
+  return true;
+}
+
+// Check that the launch fits in the limits of the device, set a Python error
+// and return false otherwise.
+static bool check_launch(uint32_t gridX, uint32_t gridY, uint32_t gridZ,
+                         int num_warps, int threads_per_warp, int num_ctas,
+                         int clusterDimX, int clusterDimY, int clusterDimZ,
+                         int shared_memory, sycl::queue &stream,
+                         sycl::kernel &kernel_ptr, uint32_t num_params) {
+  if (!check_num_params(kernel_ptr, num_params, shared_memory))
+    return false;
+  if (num_ctas != 1 || clusterDimX * clusterDimY * clusterDimZ != 1) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "CTA clusters are not supported on XPU");
+    return false;
+  }
+  const DeviceLimits *limits = get_device_limits(stream.get_device());
+  if (!limits)
+    return false;
+  size_t work_group_size = size_t(num_warps) * threads_per_warp;
+  if (work_group_size > limits->max_work_group_size) {
+    PyErr_Format(PyExc_RuntimeError,
+                 "work-group of %zu work-items exceeds the limit of the "
+                 "device (%zu)",
+                 work_group_size, limits->max_work_group_size);
+    return false;
+  }
+  uint32_t grid[3] = {gridX, gridY, gridZ};
+  for (int d = 0; d < 3; ++d) {
+    if (grid[d] > limits->max_group_count[d]) {
+      PyErr_Format(PyExc_RuntimeError,
+                   "grid of %u work-groups in dimension %d exceeds the limit "
+                   "of the device (%u)",
+                   grid[d], d, limits->max_group_count[d]);
+      return false;
+    }
+  }
+  return true;
+}
+
+// The events signaled by the kernels launched with Level Zero whose event is
+// returned, created in pools of `events_per_pool` per context and recycled
+// once their kernel has completed and their `sycl::event` has been released,
+// so that no event is created per launch.
+constexpr uint32_t events_per_pool = 256;
+
+struct ZeEventPool {
+  std::vector<ze_event_pool_handle_t> pools;
+  std::vector<ze_event_handle_t> free;
+  // released, but maybe signaled by a kernel yet to complete
+  std::vector<ze_event_handle_t> released;
+};
+static std::unordered_map<ze_context_handle_t, ZeEventPool> ze_event_pools;
+
+// The Level Zero events of the `sycl::event`s handed to Python, and their
+// context.
+static std::unordered_map<const sycl::event *,
+                          std::pair<ze_context_handle_t, ze_event_handle_t>>
+    lent_ze_events;
+
+static ze_event_handle_t acquire_ze_event(sycl::queue &stream) {
+  auto context =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(stream.get_context());
+  ZeEventPool &pool = ze_event_pools[context];
+  if (pool.free.empty()) {
+    // Recycle the released events whose kernel has completed.
+    auto completed =
+        std::partition(pool.released.begin(), pool.released.end(),
+                       [](ze_event_handle_t event) {
+                         return zeEventQueryStatus(event) != ZE_RESULT_SUCCESS;
+                       });
+    for (auto it = completed; it != pool.released.end(); ++it) {
+      ZE_CHECK(zeEventHostReset(*it));
+      pool.free.push_back(*it);
+    }
+    pool.released.erase(completed, pool.released.end());
+  }
+  if (pool.free.empty()) {
+    auto device =
+        sycl::get_native<sycl::backend::ext_oneapi_level_zero>(stream.get_device());
+    ze_event_pool_desc_t pool_desc = {ZE_STRUCTURE_TYPE_EVENT_POOL_DESC,
+                                      nullptr, ZE_EVENT_POOL_FLAG_HOST_VISIBLE,
+                                      events_per_pool};
+    ze_event_pool_handle_t event_pool;
+    ze_result_t result =
+        zeEventPoolCreate(context, &pool_desc, 1, &device, &event_pool);
+    if (result != ZE_RESULT_SUCCESS) {
+      ZE_CHECK(result);
+      return nullptr;
+    }
+    pool.pools.push_back(event_pool);
+    for (uint32_t i = 0; i < events_per_pool; ++i) {
+      ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                    ZE_EVENT_SCOPE_FLAG_HOST,
+                                    ZE_EVENT_SCOPE_FLAG_HOST};
+      ze_event_handle_t event;
+      result = zeEventCreate(event_pool, &event_desc, &event);
+      if (result != ZE_RESULT_SUCCESS) {
+        ZE_CHECK(result);
+        return nullptr;
+      }
+      pool.free.push_back(event);
+    }
+  }
+  ze_event_handle_t event = pool.free.back();
+  pool.free.pop_back();
+  return event;
+}
+
+// Hand the Level Zero event signaled by a kernel to Python as a heap
+// allocated `sycl::event`, see `release_event`.
+static sycl::event *lend_ze_event(sycl::queue &stream, ze_event_handle_t event) {
+  auto sycl_event = new sycl::event(
+      sycl::make_event<sycl::backend::ext_oneapi_level_zero>(
+          {event, sycl::ext::oneapi::level_zero::ownership::keep},
+          stream.get_context()));
+  lent_ze_events[sycl_event] = {
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(stream.get_context()),
+      event};
+  return sycl_event;
+}
+
+// Destroy an event returned by a launch, and recycle its Level Zero event if
+// it has one.
+static PyObject *release_event(PyObject *self, PyObject *args) {
+  uint64_t handle;
+  if (!PyArg_ParseTuple(args, "K", &handle))
+    return NULL;
+  auto sycl_event = reinterpret_cast<sycl::event *>(handle);
+  auto it = lent_ze_events.find(sycl_event);
+  if (it != lent_ze_events.end()) {
+    ze_event_pools[it->second.first].released.push_back(it->second.second);
+    lent_ze_events.erase(it);
+  }
+  delete sycl_event;
+  Py_RETURN_NONE;
+}
+
+// The host USM memory the packed scalar arguments of the kernels are copied
+// to, read by the kernels through their first argument, see the
+// `tritonintelgpu-pack-scalar-args` pass. The slots of a context are reused in
+// the order of the launches, once the kernel reading a slot has completed,
+// and at most `max_packed_args_slots` are allocated.
+constexpr size_t max_packed_args_slots = 64;
+constexpr size_t min_packed_args_slot_size = 512;
+
+struct PackedArgsSlot {
+  void *ptr;
+  size_t size;
+  // the launch of the kernel reading the slot
+  sycl::event event;
+};
+static std::unordered_map<sycl::context, std::deque<PackedArgsSlot>>
+    packed_args_slots;
+
+// The slot the `size` bytes of the packed arguments of a launch on `stream`
+// are copied to, to be given the event of the launch. Null with a Python error
+// set if it can't be allocated.
+static PackedArgsSlot *acquire_packed_args_slot(sycl::queue &stream,
+                                                size_t size) {
+  std::deque<PackedArgsSlot> &slots = packed_args_slots[stream.get_context()];
+  auto completed = [](const PackedArgsSlot &slot) {
+    return slot.event.get_info<sycl::info::event::command_execution_status>() ==
+           sycl::info::event_command_status::complete;
+  };
+  if (!slots.empty() &&
+      (slots.size() >= max_packed_args_slots || completed(slots.front()))) {
+    // the oldest slot, waited for when all the slots are in use
+    PackedArgsSlot slot = slots.front();
+    slots.pop_front();
+    slot.event.wait();
+    if (slot.size < size) {
+      sycl::free(slot.ptr, stream);
+      slot.ptr = nullptr;
+    }
+    if (slot.ptr) {
+      slots.push_back(slot);
+      return &slots.back();
+    }
+  }
+  size = std::max(size, min_packed_args_slot_size);
+  void *ptr = sycl::malloc_host(size, stream);
+  if (!ptr) {
+    PyErr_Format(PyExc_MemoryError,
+                 "failed to allocate %zu bytes for the packed arguments", size);
+    return nullptr;
+  }
+  slots.push_back({ptr, size, sycl::event()});
+  return &slots.back();
+}
+
+// The launches submit the kernels without the GIL, so that the threads
+// launching on their own queues don't wait for each other. The registries of
+// the launchers, e.g. the checked kernels and the pools of events, are only
+// accessed with the GIL held, before the submission. The arguments of a Level
+// Zero kernel are part of its state: they are set and the kernel appended
+// under the lock of the kernel, one of `num_kernel_locks` picked by its
+// handle, so that no registry of locks is looked up.
+constexpr size_t num_kernel_locks = 64;
+static std::mutex kernel_locks[num_kernel_locks];
+
+static std::mutex &get_kernel_lock(const void *kernel) {
+  return kernel_locks[(reinterpret_cast<uintptr_t>(kernel) >> 4) %
+                      num_kernel_locks];
+}
+
+// Launch the kernel with Level Zero directly, without building a command
+// group. Only possible when the queue is backed by an immediate command
+// list and is not being recorded, return false otherwise. The kernel signals
+// an event of the pool of its context, written to `signal_event`, if given.
+static bool ze_kernel_launch(uint32_t gridX, uint32_t gridY, uint32_t gridZ,
+                             int num_warps, int threads_per_warp,
+                             int shared_memory, sycl::queue &stream,
+                             sycl::kernel &kernel_ptr, void **params,
+                             const size_t *param_sizes, uint32_t num_params,
+                             ze_event_handle_t *signal_event) {
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+  // Launches on a recording queue must go through SYCL to be captured.
+  if (stream.ext_oneapi_get_state() ==
+      sycl::ext::oneapi::experimental::queue_state::recording)
+    return false;
+#endif
+  auto queue_var = sycl::get_native<sycl::backend::ext_oneapi_level_zero>(stream);
+  auto cmd_list = std::get_if<ze_command_list_handle_t>(&queue_var);
+  if (cmd_list == nullptr)
+    return false;
+  ze_event_handle_t event = nullptr;
+  if (signal_event) {
+    // launched through SYCL when no event can be created
+    event = acquire_ze_event(stream);
+    if (!event) {
+      PyErr_Clear();
+      return false;
+    }
+    *signal_event = event;
+  }
+
+  ze_kernel_handle_t ze_kernel =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(kernel_ptr);
+  ze_group_count_t group_count = {gridX, gridY, gridZ};
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  Py_BEGIN_ALLOW_THREADS;
+  {
+    std::lock_guard<std::mutex> lock(get_kernel_lock(ze_kernel));
+    for (uint32_t i = 0; i < num_params && result == ZE_RESULT_SUCCESS; ++i)
+      result =
+          zeKernelSetArgumentValue(ze_kernel, i, param_sizes[i], params[i]);
+    if (shared_memory && result == ZE_RESULT_SUCCESS)
+      result = zeKernelSetArgumentValue(ze_kernel, num_params, shared_memory,
+                                        nullptr);
+    if (result == ZE_RESULT_SUCCESS)
+      result =
+          zeKernelSetGroupSize(ze_kernel, num_warps * threads_per_warp, 1, 1);
+    if (result == ZE_RESULT_SUCCESS)
+      result = zeCommandListAppendLaunchKernel(*cmd_list, ze_kernel,
+                                               &group_count, event, 0, nullptr);
+  }
+  Py_END_ALLOW_THREADS;
+  ZE_CHECK(result);
+  return true;
+}
+
+// Launch the kernel cooperatively with Level Zero, all its work-groups
+// resident at once so that they can synchronize with its grid barriers. Set a
+// Python error and return false when the queue isn't backed by an immediate
+// command list or the grid doesn't fit in the device. The kernel signals an
+// event of the pool of its context, written to `signal_event`, if given.
+static bool cooperative_kernel_launch(
+    uint32_t gridX, uint32_t gridY, uint32_t gridZ, int num_warps,
+    int threads_per_warp, int shared_memory, sycl::queue &stream,
+    sycl::kernel &kernel_ptr, void **params, const size_t *param_sizes,
+    uint32_t num_params, ze_event_handle_t *signal_event) {
+  if (stream.get_backend() != sycl::backend::ext_oneapi_level_zero) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "kernels with grid barriers need a Level Zero queue");
+    return false;
+  }
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+  if (stream.ext_oneapi_get_state() ==
+      sycl::ext::oneapi::experimental::queue_state::recording) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "kernels with grid barriers can't be recorded in a graph");
+    return false;
+  }
+#endif
+  auto queue_var = sycl::get_native<sycl::backend::ext_oneapi_level_zero>(stream);
+  auto cmd_list = std::get_if<ze_command_list_handle_t>(&queue_var);
+  if (cmd_list == nullptr) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "kernels with grid barriers need a queue backed by an "
+                    "immediate command list");
+    return false;
+  }
+  ze_event_handle_t event = nullptr;
+  if (signal_event) {
+    event = acquire_ze_event(stream);
+    if (!event)
+      return false;
+    *signal_event = event;
+  }
+
+  ze_kernel_handle_t ze_kernel =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(kernel_ptr);
+  ze_group_count_t group_count = {gridX, gridY, gridZ};
+  uint64_t num_groups = uint64_t(gridX) * gridY * gridZ;
+  // the resident work-groups depend on the group size and the shared local
+  // memory, set first
+  uint32_t max_groups = 0;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  Py_BEGIN_ALLOW_THREADS;
+  {
+    std::lock_guard<std::mutex> lock(get_kernel_lock(ze_kernel));
+    for (uint32_t i = 0; i < num_params && result == ZE_RESULT_SUCCESS; ++i)
+      result =
+          zeKernelSetArgumentValue(ze_kernel, i, param_sizes[i], params[i]);
+    if (shared_memory && result == ZE_RESULT_SUCCESS)
+      result = zeKernelSetArgumentValue(ze_kernel, num_params, shared_memory,
+                                        nullptr);
+    if (result == ZE_RESULT_SUCCESS)
+      result =
+          zeKernelSetGroupSize(ze_kernel, num_warps * threads_per_warp, 1, 1);
+    if (result == ZE_RESULT_SUCCESS)
+      result = zeKernelSuggestMaxCooperativeGroupCount(ze_kernel, &max_groups);
+    if (result == ZE_RESULT_SUCCESS && num_groups <= max_groups)
+      result = zeCommandListAppendLaunchCooperativeKernel(
+          *cmd_list, ze_kernel, &group_count, event, 0, nullptr);
+  }
+  Py_END_ALLOW_THREADS;
+  if (result != ZE_RESULT_SUCCESS) {
+    ZE_CHECK(result);
+    return false;
+  }
+  if (num_groups > max_groups) {
+    PyErr_Format(PyExc_RuntimeError,
+                 "grid of %llu work-groups exceeds the %u work-groups the "
+                 "device keeps resident for a kernel with grid barriers",
+                 (unsigned long long)num_groups, max_groups);
+    return false;
+  }
+  return true;
+}
+
+static sycl::event sycl_kernel_launch(uint32_t gridX, uint32_t gridY,
+                                      uint32_t gridZ, int num_warps,
+                                      int threads_per_warp, int shared_memory,
+                                      sycl::queue &stream,
+                                      sycl::kernel &kernel_ptr, void **params,
+                                      const size_t *param_sizes,
+                                      uint32_t num_params) {
+  // The work-items are counted in 64 bits: large grids overflow 32 bits.
+  size_t global_range_x = size_t(gridX) * threads_per_warp * num_warps;
+  size_t global_range_y = gridY;
+  size_t global_range_z = gridZ;
+  size_t local_range_x = num_warps * threads_per_warp;
+  size_t local_range_y = 1;
+  size_t local_range_z = 1;
+  sycl::range<3> global_range(global_range_z, global_range_y, global_range_x);
+  sycl::range<3> local_range(local_range_z, local_range_y, local_range_x);
+  sycl::nd_range<3> parallel_work_size(global_range, local_range);
+  // Submit the imported kernel. The values of the parameters are copied when
+  // the command group is submitted.
+  auto cgf = [&](sycl::handler &cgh) {
+    for (uint32_t i = 0; i < num_params; ++i)
+      set_scalar_arg(cgh, i, param_sizes[i], params[i]);
+    if (shared_memory) {
+      using share_mem_t = sycl::local_accessor<int8_t, 1>;
+      share_mem_t local_buffer = share_mem_t(shared_memory, cgh);
+      cgh.set_arg(num_params, local_buffer);
+    }
+    cgh.parallel_for(parallel_work_size, kernel_ptr);
+  };
+  sycl::event event;
+  std::exception_ptr error;
+  Py_BEGIN_ALLOW_THREADS;
+  try {
+    event = stream.submit(cgf);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  Py_END_ALLOW_THREADS;
+  if (error)
+    std::rethrow_exception(error);
+  return event;
+}
+
+// The in-order queues of the tiles, i.e. the sub-devices, of the devices,
+// created in the context of the queue of their first launch. Empty for the
+// devices without tiles.
+static std::unordered_map<sycl::device, std::vector<sycl::queue>> tile_queues;
+
+static std::vector<sycl::queue> &get_tile_queues(sycl::queue &stream) {
+  sycl::device device = stream.get_device();
+  auto it = tile_queues.find(device);
+  if (it == tile_queues.end()) {
+    std::vector<sycl::queue> queues;
+    if (device.get_info<sycl::info::device::partition_max_sub_devices>() > 1) {
+      try {
+        auto tiles = device.create_sub_devices<
+            sycl::info::partition_property::partition_by_affinity_domain>(
+            sycl::info::partition_affinity_domain::next_partitionable);
+        for (auto &tile : tiles)
+          queues.emplace_back(stream.get_context(), tile,
+                              sycl::property::queue::in_order());
+      } catch (const sycl::exception &) {
+        // not partitionable by affinity domain, launched on the device
+        queues.clear();
+      }
+    }
+    it = tile_queues.emplace(device, std::move(queues)).first;
+  }
+  return it->second;
+}
+
+// Launch the work-groups along x in as many contiguous ranges as the device
+// has tiles, each range on the queue of its tile, so that the tiles don't
+// share the work-groups of a range. The ranges start once the work submitted
+// to `stream` before completes, the work submitted to `stream` afterwards
+// waits for all of them. The first program id and the number of programs
+// along x of a range are written to `tile_offset` and `tile_grid`, which
+// point to parameters of the kernel.
+static sycl::event
+tile_kernel_launch(uint32_t gridX, uint32_t gridY, uint32_t gridZ,
+                   int num_warps, int threads_per_warp, int shared_memory,
+                   sycl::queue &stream, sycl::kernel &kernel_ptr,
+                   void **params, const size_t *param_sizes,
+                   uint32_t num_params, int32_t *tile_offset,
+                   int32_t *tile_grid) {
+  std::vector<sycl::queue> &queues = get_tile_queues(stream);
+  bool recording = false;
+#ifdef SYCL_EXT_ONEAPI_GRAPH
+  // The queues of the tiles are not recorded with `stream`.
+  recording = stream.ext_oneapi_get_state() ==
+              sycl::ext::oneapi::experimental::queue_state::recording;
+#endif
+  *tile_grid = int32_t(gridX);
+  if (queues.size() < 2 || gridX < 2 || recording) {
+    *tile_offset = 0;
+    return sycl_kernel_launch(gridX, gridY, gridZ, num_warps, threads_per_warp,
+                              shared_memory, stream, kernel_ptr, params,
+                              param_sizes, num_params);
+  }
+  sycl::event ready = stream.ext_oneapi_submit_barrier();
+  std::vector<sycl::event> done;
+  uint32_t range = (gridX + queues.size() - 1) / queues.size();
+  for (size_t i = 0; i < queues.size() && i * range < gridX; ++i) {
+    uint32_t offset = i * range;
+    queues[i].ext_oneapi_submit_barrier({ready});
+    *tile_offset = int32_t(offset);
+    done.push_back(sycl_kernel_launch(
+        std::min(range, gridX - offset), gridY, gridZ, num_warps,
+        threads_per_warp, shared_memory, queues[i], kernel_ptr, params,
+        param_sizes, num_params));
+  }
+  return stream.ext_oneapi_submit_barrier(done);
+}
+
+// The sub-group size the kernel has been compiled for, recorded in its
+// metadata.
+static int get_threads_per_warp(PyObject *compiled_kernel) {
+  int threads_per_warp = 32;
+  PyObject *threads_per_warp_attr =
+      PyObject_GetAttrString(compiled_kernel, "threads_per_warp");
+  if (threads_per_warp_attr) {
+    threads_per_warp = PyLong_AsLong(threads_per_warp_attr);
+    Py_DECREF(threads_per_warp_attr);
+  } else {
+    PyErr_Clear();
+  }
+  return threads_per_warp;
+}
+
+// The tracing state and function of the driver, see `get_trace_hooks`.
+static std::atomic<bool> *trace_enabled = nullptr;
+static void (*trace_launch)(const void *, uint32_t, uint32_t, uint32_t,
+                            const sycl::event *) = nullptr;
+
+static PyObject *set_trace_hooks(PyObject *self, PyObject *args) {
+  uint64_t enabled, function;
+  if (!PyArg_ParseTuple(args, "KK", &enabled, &function))
+    return NULL;
+  trace_enabled = reinterpret_cast<std::atomic<bool> *>(enabled);
+  trace_launch =
+      reinterpret_cast<void (*)(const void *, uint32_t, uint32_t, uint32_t,
+                                const sycl::event *)>(function);
+  Py_RETURN_NONE;
+}
@@ -6,103 +6,103 @@
 #include "triton/Conversion/NVGPUToLLVM/Passes.h"
 #include "triton/Conversion/TritonGPUToLLVM/Passes.h"
 #include "triton/Dialect/NVGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
 #include "triton/Dialect/TritonNvidiaGPU/IR/Dialect.h"
-#include "triton/Dialect/TritonNvidiaGPU/Transforms/Passes.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Module.h"
 #include "llvm/Support/TargetSelect.h"
+#include <map>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
-#include <pybind11/stl_bind.h>
 
 namespace py = pybind11;
 
-PYBIND11_MAKE_OPAQUE(mlir::triton::gpu::TMAMetadataTy);
-
 void init_triton_intel_passes_ttgpuir(py::module &&m) {
   using namespace mlir::triton::gpu;
   ADD_PASS_WRAPPER_1("add_rewrite_tensor_pointer",
                      mlir::createTritonGPURewriteTensorPointerPass, int);
-  // TODO: it is weird to pass mlir::triton::NVVM here since the conversion is
-  // nvidia-specificontext
-  m.def("add_to_llvmir", [](mlir::PassManager &pm, int32_t capability,
-                            mlir::triton::gpu::TMAMetadataTy *tmaMetadata) {
+  m.def("add_coalesce", [](mlir::PassManager &pm, int32_t arch) {
+    // The sub-groups of PVC gather up to 8 dwords per work-item in a single
+    // message, the other devices are limited to 4 dwords.
+    auto deviceArch = static_cast<mlir::triton::gpu::intel::DeviceArch>(arch);
+    unsigned maxVectorBits =
+        deviceArch == mlir::triton::gpu::intel::DeviceArch::PVC ? 256 : 128;
+    pm.addPass(mlir::triton::gpu::createCoalescePass(maxVectorBits));
+  });
+  m.def("add_accelerate_matmul", [](mlir::PassManager &pm, int32_t arch) {
+    pm.addPass(mlir::triton::gpu::intel::createAccelerateMatmulPass(
+        static_cast<mlir::triton::gpu::intel::DeviceArch>(arch)));
+  });
+  m.def("add_materialize_block_pointer", [](mlir::PassManager &pm,
+                                            int32_t arch) {
+    pm.addPass(mlir::triton::gpu::intel::createMaterializeBlockPointerPass(
+        static_cast<mlir::triton::gpu::intel::DeviceArch>(arch)));
+  });
+  m.def("add_pipeline", [](mlir::PassManager &pm, int32_t numStages) {
+    pm.addPass(mlir::triton::gpu::intel::createPipelinePass(numStages));
+  });
+  m.def("add_prefetch_block", [](mlir::PassManager &pm, int32_t numStages) {
+    pm.addPass(mlir::triton::gpu::intel::createPrefetchBlockPass(numStages));
+  });
+  m.def("add_persistent", [](mlir::PassManager &pm, uint32_t swizzleGroup) {
+    pm.addPass(mlir::triton::gpu::intel::createPersistentPass(swizzleGroup));
+  });
+  ADD_PASS_WRAPPER_0("add_partition_grid", intel::createPartitionGridPass);
+  ADD_PASS_WRAPPER_0("add_distribute_reductions",
+                     intel::createDistributeReductionsPass);
+  m.def("add_instrument_regions",
+        [](mlir::PassManager &pm, const std::string &regions) {
+          pm.addPass(
+              mlir::triton::gpu::intel::createInstrumentRegionsPass(regions));
+        });
+  ADD_PASS_WRAPPER_0("add_buffer_prints", intel::createBufferPrintsPass);
+  ADD_PASS_WRAPPER_0("add_grid_barriers", intel::createGridBarriersPass);
+  m.def("add_pack_scalar_args", [](mlir::PassManager &pm, unsigned minNumArgs) {
+    pm.addPass(mlir::triton::gpu::intel::createPackScalarArgsPass(minNumArgs));
+  });
+  m.def("add_estimate_resources",
+        [](mlir::PassManager &pm, unsigned grfSize, unsigned threadsPerXeCore,
+           unsigned sharedPerXeCore) {
+          pm.addPass(mlir::triton::gpu::intel::createEstimateResourcesPass(
+              grfSize, threadsPerXeCore, sharedPerXeCore));
+        });
+  ADD_PASS_WRAPPER_0("add_estimate_traffic", intel::createEstimateTrafficPass);
+  ADD_PASS_WRAPPER_0("add_strength_reduce_pointers",
+                     intel::createStrengthReducePointersPass);
+  ADD_PASS_WRAPPER_0("add_narrow_pointer_offsets",
+                     intel::createNarrowPointerOffsetsPass);
+  ADD_PASS_WRAPPER_0("add_loop_unroll", intel::createLoopUnrollPass);
+  m.def("add_select_num_warps", [](mlir::PassManager &pm,
+                                   unsigned threadsPerWarp,
+                                   unsigned threadsPerXeCore) {
+    pm.addPass(mlir::triton::gpu::intel::createSelectNumWarpsPass(
+        threadsPerWarp, threadsPerXeCore));
+  });
+  m.def("add_allocate_shared_memory", [](mlir::PassManager &pm,
+                                         int32_t maxSharedMem) {
+    mlir::triton::AllocateSharedMemoryOptions options;
+    options.maxSharedMem = maxSharedMem;
+    pm.addPass(mlir::triton::gpu::createAllocateSharedMemoryPass(options));
+  });
+  m.def("add_schedule_dpas", [](mlir::PassManager &pm, unsigned numGRF) {
+    mlir::triton::ScheduleDPASOptions options;
+    options.numGRF = numGRF;
+    pm.addPass(mlir::triton::gpu::createScheduleDPASPass(options));
+  });
+  m.def("add_to_llvmir", [](mlir::PassManager &pm, int32_t capability) {
+    // No TMA op reaches the GENX lowering, there is no TMA metadata to
+    // collect.
     pm.addPass(createConvertTritonGPUToLLVMPass(capability, mlir::triton::GENX,
-                                                tmaMetadata));
+                                                /*tmaMetadata=*/nullptr));
   });
-}
-
-void init_triton_intel_passes_ttnvgpuir(py::module &&m) {
-  ADD_PASS_WRAPPER_1("add_plan_cta", mlir::createTritonNvidiaGPUPlanCTAPass,
-                     mlir::triton::nvidia_gpu::ClusterInfo *);
-  ADD_PASS_WRAPPER_1("add_wsfeasibility_checking",
-                     mlir::createTritonNvidiaGPUWSFeasibilityCheckingPass, int);
-  ADD_PASS_WRAPPER_1("add_wsdecomposing",
-                     mlir::createTritonNvidiaGPUWSDecomposingPass, int);
-  ADD_PASS_WRAPPER_1("add_wsmutex", mlir::createTritonNvidiaGPUWSMutexPass,
-                     int);
-  ADD_PASS_WRAPPER_1("add_wsmaterialization",
-                     mlir::createTritonNvidiaGPUWSMaterializationPass, int);
-  ADD_PASS_WRAPPER_0("add_wsfixup_missing_attrs",
-                     mlir::createTritonNvidiaGPUWSFixupMissingAttrs);
-  ADD_PASS_WRAPPER_2("add_materialize_load_store",
-                     mlir::createTritonNvidiaGPUMaterializeLoadStorePass, int,
-                     int);
-  ADD_PASS_WRAPPER_0("add_fence_insertion",
-                     mlir::createTritonNvidiaGPUFenceInsertionPass);
   ADD_PASS_WRAPPER_0("add_nvgpu_to_llvm",
                      mlir::triton::createConvertNVGPUToLLVMPass);
-  ADD_PASS_WRAPPER_3("add_wspipeline",
-                     mlir::createTritonNvidiaGPUWSPipelinePass, int, int, int);
-
-  m.def("is_ws_supported", [](mlir::ModuleOp &mod) -> bool {
-    return mlir::triton::nvidia_gpu::TritonNvidiaGPUDialect::getWSSupportedAttr(
-        mod);
-  });
 }
 
 void init_triton_intel(py::module &&m){
   auto passes = m.def_submodule("passes");
   init_triton_intel_passes_ttgpuir(passes.def_submodule("ttgpuir"));
-  init_triton_intel_passes_ttnvgpuir(passes.def_submodule("ttnvgpuir"));
-
-  // cluster info
-  py::class_<mlir::triton::nvidia_gpu::ClusterInfo>(m, "ClusterInfo")
-      .def(py::init<>())
-      .def_readwrite("clusterDimX",
-                     &mlir::triton::nvidia_gpu::ClusterInfo::clusterDimX)
-      .def_readwrite("clusterDimY",
-                     &mlir::triton::nvidia_gpu::ClusterInfo::clusterDimY)
-      .def_readwrite("clusterDimZ",
-                     &mlir::triton::nvidia_gpu::ClusterInfo::clusterDimZ)
-      .def("__repr__", [](mlir::triton::nvidia_gpu::ClusterInfo &self) {
-        std::ostringstream oss;
-        oss << "(" << self.clusterDimX << ", " << self.clusterDimY << ", "
-            << self.clusterDimZ << ")";
-        return oss.str();
-      });
-
-  // tma info
-  py::class_<mlir::triton::gpu::TMAInfo>(m, "TMAInfo")
-      .def(py::init<>())
-      .def_readwrite("tensorDataType",
-                     &mlir::triton::gpu::TMAInfo::tensorDataType)
-      .def_readwrite("tensorRank", &mlir::triton::gpu::TMAInfo::tensorRank)
-      .def_readwrite("globalAddressArgIdx",
-                     &mlir::triton::gpu::TMAInfo::globalAddressArgIdx)
-      .def_readwrite("globalStridesArgIdx",
-                     &mlir::triton::gpu::TMAInfo::globalStridesArgIdx)
-      .def_readwrite("globalDimsArgIdx",
-                     &mlir::triton::gpu::TMAInfo::globalDimsArgIdx)
-      .def_readwrite("boxDims", &mlir::triton::gpu::TMAInfo::boxDims)
-      .def_readwrite("elementStrides",
-                     &mlir::triton::gpu::TMAInfo::elementStrides)
-      .def_readwrite("interleave", &mlir::triton::gpu::TMAInfo::interleave)
-      .def_readwrite("swizzle", &mlir::triton::gpu::TMAInfo::swizzle)
-      .def_readwrite("l2Promotion", &mlir::triton::gpu::TMAInfo::l2Promotion)
-      .def_readwrite("oobFill", &mlir::triton::gpu::TMAInfo::oobFill)
-      .def_readwrite("TMADescArgIdx",
-                     &mlir::triton::gpu::TMAInfo::TMADescArgIdx);
-  py::bind_vector<std::vector<mlir::triton::gpu::TMAInfo>>(m, "TMAInfos");
 
   // load dialects
   m.def("load_dialects", [](mlir::MLIRContext &context) {
@@ -130,4 +130,148 @@ void init_triton_intel(py::module &&m){
     auto *reflect = MDNode::get(ctx, {mdFour, mdName, mdOne});
     mod->addModuleFlag(reflect);
   });
+
+  // Replace the calls of the fast-math mode to the precise libdevice
+  // functions, and to the OpenCL builtins of float scalars and vectors they
+  // are lowered to, by the native approximations of the device.
+  m.def("replace_with_native_math", [](llvm::Module *mod) {
+    using namespace llvm;
+    Type *f32 = Type::getFloatTy(mod->getContext());
+    // The mangled name of the OpenCL builtin `name` of float `type`, a float
+    // or a vector of floats.
+    auto getBuiltinName = [](StringRef name, Type *type) {
+      std::string builtin = ("__spirv_ocl_" + name).str();
+      std::string typeCode = "f";
+      if (auto *vecTy = dyn_cast<FixedVectorType>(type))
+        typeCode = "Dv" + std::to_string(vecTy->getNumElements()) + "_f";
+      return "_Z" + std::to_string(builtin.size()) + builtin + typeCode;
+    };
+    auto getNativeFunc = [&](StringRef name, Type *type) {
+      FunctionCallee callee = mod->getOrInsertFunction(
+          getBuiltinName(("native_" + name).str(), type),
+          FunctionType::get(type, {type}, /*isVarArg=*/false));
+      auto *func = cast<Function>(callee.getCallee());
+      func->setCallingConv(CallingConv::SPIR_FUNC);
+      func->setDoesNotAccessMemory();
+      func->setDoesNotThrow();
+      return callee;
+    };
+    auto createNativeCall = [&](IRBuilder<> &builder, StringRef name,
+                                Value *arg) {
+      CallInst *call =
+          builder.CreateCall(getNativeFunc(name, arg->getType()), {arg});
+      call->setCallingConv(CallingConv::SPIR_FUNC);
+      return call;
+    };
+
+    // The precise functions, by their native approximation, none for tanh.
+    static const std::pair<StringRef, StringRef> nativeFuncs[] = {
+        {"exp", "exp"},   {"exp2", "exp2"},   {"log", "log"},
+        {"log2", "log2"}, {"sqrt", "sqrt"},   {"rsqrt", "rsqrt"},
+        {"sin", "sin"},   {"cos", "cos"},     {"tanh", ""}};
+    SmallVector<Type *> types = {f32};
+    for (unsigned numElements : {2, 4, 8, 16})
+      types.push_back(FixedVectorType::get(f32, numElements));
+    SmallVector<std::pair<Function *, StringRef>> funcs;
+    for (auto [name, nativeName] : nativeFuncs) {
+      if (Function *func = mod->getFunction(("__imf_" + name + "f").str()))
+        funcs.push_back({func, nativeName});
+      for (Type *type : types)
+        if (Function *func = mod->getFunction(getBuiltinName(name, type)))
+          funcs.push_back({func, nativeName});
+    }
+
+    for (auto [func, nativeName] : funcs) {
+      for (User *user : make_early_inc_range(func->users())) {
+        auto *call = dyn_cast<CallInst>(user);
+        if (!call)
+          continue;
+        IRBuilder<> builder(call);
+        FastMathFlags fmf;
+        fmf.setApproxFunc();
+        builder.setFastMathFlags(fmf);
+        Value *arg = call->getArgOperand(0);
+        Type *type = arg->getType();
+        Value *result;
+        if (!nativeName.empty()) {
+          result = createNativeCall(builder, nativeName, arg);
+        } else {
+          // There is no native tanh, it is computed from the native exp2:
+          // tanh(x) = sign(x) * (1 - 2 / (exp(2 * |x|) + 1)).
+          Value *absArg = builder.CreateUnaryIntrinsic(Intrinsic::fabs, arg);
+          Value *exp = createNativeCall(
+              builder, "exp2",
+              builder.CreateFMul(
+                  absArg, ConstantFP::get(type, 2 * 1.4426950408889634)));
+          Value *frac = builder.CreateFDiv(
+              ConstantFP::get(type, 2.0),
+              builder.CreateFAdd(exp, ConstantFP::get(type, 1.0)));
+          result = builder.CreateBinaryIntrinsic(
+              Intrinsic::copysign,
+              builder.CreateFSub(ConstantFP::get(type, 1.0), frac), arg);
+        }
+        call->replaceAllUsesWith(result);
+        call->eraseFromParent();
+      }
+      if (func->use_empty())
+        func->eraseFromParent();
+    }
+  });
+
+  // Force the inlining of the functions linked from the extern libraries, the
+  // internal functions which aren't kernels, for them to be specialized for
+  // the constant arguments of their calls and vectorized with the kernel's
+  // code by the optimizer. The OpenCL math builtins, only declared, don't
+  // access memory.
+  m.def("inline_extern_lib_calls", [](llvm::Module *mod) {
+    using namespace llvm;
+    for (Function &func : *mod) {
+      if (func.isDeclaration()) {
+        if (func.getName().contains("__spirv_ocl_") &&
+            !func.getName().contains("printf")) {
+          func.setDoesNotAccessMemory();
+          func.setDoesNotThrow();
+          func.setWillReturn();
+        }
+        continue;
+      }
+      if (!func.hasLocalLinkage() ||
+          func.getCallingConv() == CallingConv::SPIR_KERNEL ||
+          func.hasFnAttribute(Attribute::NoInline) ||
+          func.hasFnAttribute(Attribute::OptimizeNone))
+        continue;
+      func.addFnAttr(Attribute::AlwaysInline);
+    }
+  });
+
+  // Return the ids and the types of the SPIR-V specialization constants of the
+  // module, of the calls of the __spirv_SpecConstant builtins the SPIR-V
+  // translator lowers to OpSpecConstant, e.g. (0, "fp32").
+  m.def("get_spec_constants", [](llvm::Module *mod) {
+    using namespace llvm;
+    std::map<uint64_t, std::string> constants;
+    for (Function &func : *mod) {
+      if (!func.isDeclaration() ||
+          !func.getName().contains("__spirv_SpecConstanti"))
+        continue;
+      for (User *user : func.users()) {
+        auto *call = dyn_cast<CallInst>(user);
+        auto *id =
+            call ? dyn_cast<ConstantInt>(call->getArgOperand(0)) : nullptr;
+        if (!id)
+          continue;
+        Type *type = call->getType();
+        std::string name;
+        if (type->isFloatTy())
+          name = "fp32";
+        else if (type->isDoubleTy())
+          name = "fp64";
+        else
+          name = "i" + std::to_string(type->getIntegerBitWidth());
+        constants[id->getZExtValue()] = name;
+      }
+    }
+    return std::vector<std::pair<uint64_t, std::string>>(constants.begin(),
+                                                         constants.end());
+  });
 }
@@ -356,16 +356,19 @@ class TensorMapManager:
         self.utils = utils
 
     def __getitem__(self, key: tuple):
-        if key in self.tensormaps_device:
-            return int(self.tensormaps_device[key])
-        else:
-            (e, args) = key
+        (e, args) = key
+        # A descriptor only depends on its static info and on the address, the shape and the strides of the tensor,
+        # so only those are part of the cache key: the other arguments of the kernel can change between launches
+        # without encoding a new descriptor.
+        cache_key = (e, e.getGlobalAddress(args), tuple(e.getGlobalDims(args)), tuple(e.getGlobalStrides(args)))
+        tensormap_device = self.tensormaps_device.get(cache_key)
+        if tensormap_device is None:
             t_tensormap = e.tensormap(args)
             TENSORMAP_SIZE_IN_BYTES = 128
-            t_tensormap_device = self.utils.cuMemAlloc(TENSORMAP_SIZE_IN_BYTES)
-            self.utils.cuMemcpyHtoD(t_tensormap_device, t_tensormap, TENSORMAP_SIZE_IN_BYTES)
-            self.tensormaps_device[key] = t_tensormap_device
-            return int(self.tensormaps_device[key])
+            tensormap_device = self.utils.cuMemAlloc(TENSORMAP_SIZE_IN_BYTES)
+            self.utils.cuMemcpyHtoD(tensormap_device, t_tensormap, TENSORMAP_SIZE_IN_BYTES)
+            self.tensormaps_device[cache_key] = tensormap_device
+        return int(tensormap_device)
 
     def __del__(self):
         for _, v in self.tensormaps_device.items():